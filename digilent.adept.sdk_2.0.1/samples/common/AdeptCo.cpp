@@ -0,0 +1,845 @@
+/************************************************************************/
+/*																		*/
+/*  AdeptCo.cpp  --  Adept Coroutine Transfers							*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the CoLoop, CoHif and CoTask classes.	*/
+/*		See AdeptCo.h for how they are used.							*/
+/*																		*/
+/*		The reactor thread of a CoHif takes one operation at a time		*/
+/*		from the queue of the handle, issues it and waits for it with	*/
+/*		DmgrGetTransResult in slices of at most tmsCoSlice, so that		*/
+/*		it can cancel the transfer between slices. A failed wait with	*/
+/*		ercTransferPending is a slice that expired; any other error		*/
+/*		completes the operation. If the handle already has an			*/
+/*		overlapped transfer that was not started by the reactor, the	*/
+/*		issue fails with ercTransferPending and is retried after a		*/
+/*		slice.															*/
+/*																		*/
+/*		DmgrGetLastError is per process, so the error reported for a	*/
+/*		failed transfer can come from another thread that failed at		*/
+/*		the same time.													*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "AdeptCo.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Initial size of the ready ring of a loop.
+*/
+const DWORD		cpvReadyInit	= 64;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static double	DblCoTimeSec();
+static DWORD	TmsWait(double dblDeadline);
+static void		CoSleepMs(DWORD tms);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	CoTask::FinalAwait::await_suspend
+**
+**	Parameters:
+**		h			- handle of the returning coroutine
+**
+**	Return Value:
+**		coroutine to run next
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called when a task returns. A spawned task frees its frame and
+**		tells its loop. An awaited task transfers control back to the
+**		awaiting coroutine, which frees the frame when it destroys its
+**		CoTask.
+*/
+
+std::coroutine_handle<> CoTask::FinalAwait::await_suspend(HCO h) noexcept {
+
+	promise_type &	prom = h.promise();
+	CoLoop *		ploop;
+
+	if (prom.ploop != NULL) {
+		ploop = prom.ploop;
+		h.destroy();
+		ploop->TaskDone();
+		return std::noop_coroutine();
+	}
+
+	if (prom.hContinue) {
+		return prom.hContinue;
+	}
+
+	return std::noop_coroutine();
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::CoLoop
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The loop must be initialized with FInit before
+**		it is used.
+*/
+
+CoLoop::CoLoop() {
+
+	rgpvReady = NULL;
+	cpvReadyMax = 0;
+	ipvReadyHead = 0;
+	cpvReady = 0;
+	ctask = 0;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::FInit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates the ready ring.
+*/
+
+BOOL CoLoop::FInit() {
+
+	if (fInit) {
+		return fFalse;
+	}
+
+	rgpvReady = (void **) malloc(cpvReadyInit * sizeof(void *));
+	if (rgpvReady == NULL) {
+		return fFalse;
+	}
+
+	cpvReadyMax = cpvReadyInit;
+	ipvReadyHead = 0;
+	cpvReady = 0;
+	ctask = 0;
+
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&cvReady, NULL);
+	fInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Frees the loop. The CoHif objects that post to it must have
+**		been freed first.
+*/
+
+void CoLoop::Free() {
+
+	if (!fInit) {
+		return;
+	}
+
+	pthread_cond_destroy(&cvReady);
+	pthread_mutex_destroy(&mtx);
+	free(rgpvReady);
+	rgpvReady = NULL;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::FSpawn
+**
+**	Parameters:
+**		task		- task to start
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the task is not valid
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Takes ownership of a task and starts it the next time Run
+**		resumes coroutines. Its frame is freed when it returns.
+*/
+
+BOOL CoLoop::FSpawn(CoTask && task) {
+
+	CoTask::HCO	h = task.h;
+
+	if (!fInit || !h) {
+		return fFalse;
+	}
+
+	task.h = NULL;
+	h.promise().ploop = this;
+
+	pthread_mutex_lock(&mtx);
+	ctask++;
+	pthread_mutex_unlock(&mtx);
+
+	Post(h);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::Post
+**
+**	Parameters:
+**		h			- coroutine to resume
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Aborts if the ready ring cannot be grown.
+**
+**	Description:
+**		Queues a coroutine to be resumed by Run. May be called from
+**		any thread.
+*/
+
+void CoLoop::Post(std::coroutine_handle<> h) {
+
+	pthread_mutex_lock(&mtx);
+
+	if ((cpvReady == cpvReadyMax) && !FGrow()) {
+		abort();
+	}
+
+	rgpvReady[(ipvReadyHead + cpvReady) % cpvReadyMax] = h.address();
+	cpvReady++;
+
+	pthread_cond_signal(&cvReady);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::TaskDone
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called when a spawned task returns.
+*/
+
+void CoLoop::TaskDone() {
+
+	pthread_mutex_lock(&mtx);
+	ctask--;
+	pthread_cond_signal(&cvReady);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::Run
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Resumes queued coroutines on the calling thread, waiting for
+**		transfers to complete when none are queued, until all spawned
+**		tasks have returned.
+*/
+
+void CoLoop::Run() {
+
+	void *	pv;
+
+	for (;;) {
+		pthread_mutex_lock(&mtx);
+
+		while ((cpvReady == 0) && (ctask > 0)) {
+			pthread_cond_wait(&cvReady, &mtx);
+		}
+
+		if (cpvReady == 0) {
+			pthread_mutex_unlock(&mtx);
+			break;
+		}
+
+		pv = rgpvReady[ipvReadyHead];
+		ipvReadyHead = (ipvReadyHead + 1) % cpvReadyMax;
+		cpvReady--;
+
+		pthread_mutex_unlock(&mtx);
+
+		std::coroutine_handle<>::from_address(pv).resume();
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	CoLoop::FGrow
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Doubles the size of the full ready ring. Called with the
+**		mutex held.
+*/
+
+BOOL CoLoop::FGrow() {
+
+	void **	rgpvNew;
+	DWORD	ipv;
+
+	rgpvNew = (void **) malloc(2 * cpvReadyMax * sizeof(void *));
+	if (rgpvNew == NULL) {
+		return fFalse;
+	}
+
+	for (ipv = 0; ipv < cpvReady; ipv++) {
+		rgpvNew[ipv] = rgpvReady[(ipvReadyHead + ipv) % cpvReadyMax];
+	}
+
+	free(rgpvReady);
+	rgpvReady = rgpvNew;
+	cpvReadyMax *= 2;
+	ipvReadyHead = 0;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoXfer::await_suspend
+**
+**	Parameters:
+**		h			- awaiting coroutine
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Queues the transfer on the reactor of the handle. The
+**		coroutine is resumed by the loop when the transfer completes.
+*/
+
+void CoXfer::await_suspend(std::coroutine_handle<> h) noexcept {
+
+	op.h = h;
+	pcoh->Submit(&op);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::CoHif
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The object must be initialized with FInit before
+**		it is used.
+*/
+
+CoHif::CoHif() {
+
+	hif = hifInvalid;
+	ploop = NULL;
+	fThread = fFalse;
+	popHead = NULL;
+	popTail = NULL;
+	seqNext = 0;
+	seqCancel = 0;
+	fQuit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::FInit
+**
+**	Parameters:
+**		hifInit		- open interface handle
+**		ploopInit	- loop that resumes the awaiting coroutines
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts the reactor thread of the handle. The module used by
+**		the transfers (DEPP, DSTM, ...) must be enabled by the caller.
+*/
+
+BOOL CoHif::FInit(HIF hifInit, CoLoop * ploopInit) {
+
+	if ((hifInit == hifInvalid) || (ploopInit == NULL) || fThread) {
+		return fFalse;
+	}
+
+	hif = hifInit;
+	ploop = ploopInit;
+	popHead = NULL;
+	popTail = NULL;
+	seqNext = 0;
+	seqCancel = 0;
+	fQuit = fFalse;
+
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&cvQueue, NULL);
+
+	if (pthread_create(&thrd, NULL, ReactorThread, this) != 0) {
+		pthread_cond_destroy(&cvQueue);
+		pthread_mutex_destroy(&mtx);
+		return fFalse;
+	}
+
+	fThread = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Cancels the transfers of the handle and stops the reactor
+**		thread. Cancelled transfers still post their coroutines to the
+**		loop, so the loop should be run until its tasks have returned
+**		before the handle is freed. The interface handle is not closed.
+*/
+
+void CoHif::Free() {
+
+	if (!fThread) {
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	fQuit = fTrue;
+	seqCancel = seqNext;
+	pthread_cond_signal(&cvQueue);
+	pthread_mutex_unlock(&mtx);
+
+	pthread_join(thrd, NULL);
+	fThread = fFalse;
+
+	pthread_cond_destroy(&cvQueue);
+	pthread_mutex_destroy(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::Submit
+**
+**	Parameters:
+**		pop			- operation to queue
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		The operation completes with ercInvalidHif if the reactor is
+**		not running.
+**
+**	Description:
+**		Appends an operation to the queue of the handle.
+*/
+
+void CoHif::Submit(COOP * pop) {
+
+	if (!fThread) {
+		Complete(pop, fFalse, ercInvalidHif, 0, 0);
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+
+	if (fQuit) {
+		pthread_mutex_unlock(&mtx);
+		Complete(pop, fFalse, ercInvalidHif, 0, 0);
+		return;
+	}
+
+	pop->seq = seqNext++;
+	pop->popNext = NULL;
+	if (popTail != NULL) {
+		popTail->popNext = pop;
+	}
+	else {
+		popHead = pop;
+	}
+	popTail = pop;
+
+	pthread_cond_signal(&cvQueue);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::Cancel
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Cancels the transfer in flight and all queued transfers.
+**		Transfers submitted afterwards are not affected. The reactor
+**		calls DmgrCancelTrans within one slice.
+*/
+
+void CoHif::Cancel() {
+
+	if (!fThread) {
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	seqCancel = seqNext;
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::FCancelled
+**
+**	Parameters:
+**		pop			- operation
+**
+**	Return Value:
+**		fTrue if the operation has been cancelled
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sequence numbers wrap, so they are compared by difference.
+*/
+
+BOOL CoHif::FCancelled(COOP * pop) {
+
+	BOOL	fCancelled;
+
+	pthread_mutex_lock(&mtx);
+	fCancelled = ((int) (pop->seq - seqCancel) < 0);
+	pthread_mutex_unlock(&mtx);
+
+	return fCancelled;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::Complete
+**
+**	Parameters:
+**		pop			- completed operation
+**		fOk			- fTrue if the transfer succeeded
+**		erc			- error code if it did not
+**		cbOut		- bytes sent
+**		cbIn		- bytes received
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stores the result and posts the awaiting coroutine to the
+**		loop. The operation must not be used afterwards, since the
+**		coroutine frame holding it may be freed.
+*/
+
+void CoHif::Complete(COOP * pop, BOOL fOk, ERC erc, DWORD cbOut, DWORD cbIn) {
+
+	pop->res.fOk = fOk;
+	pop->res.erc = fOk ? ercNoErc : erc;
+	pop->res.cbOut = cbOut;
+	pop->res.cbIn = cbIn;
+
+	ploop->Post(pop->h);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::RunOp
+**
+**	Parameters:
+**		pop			- operation to run
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Issues one transfer and waits for it to complete, cancelling
+**		it if it is cancelled or its time limit expires.
+*/
+
+void CoHif::RunOp(COOP * pop) {
+
+	DWORD	cbOut = 0;
+	DWORD	cbIn = 0;
+	ERC		erc;
+	double	dblDeadline = 0;
+	BOOL	fCancelSent = fFalse;
+
+	if (pop->tmsTimeout != 0) {
+		dblDeadline = DblCoTimeSec() + pop->tmsTimeout / 1000.0;
+	}
+
+	while (!pop->pfnIssue(hif, pop)) {
+		erc = DmgrGetLastError();
+		if (erc != ercTransferPending) {
+			Complete(pop, fFalse, erc, 0, 0);
+			return;
+		}
+
+		if (FCancelled(pop) || ((dblDeadline != 0) && (DblCoTimeSec() >= dblDeadline))) {
+			Complete(pop, fFalse, ercTransferCancelled, 0, 0);
+			return;
+		}
+
+		CoSleepMs(tmsCoSlice);
+	}
+
+	// DMGR API Call: DmgrGetTransResult
+	while (!DmgrGetTransResult(hif, &cbOut, &cbIn, fCancelSent ? tmsCoSlice : TmsWait(dblDeadline))) {
+		erc = DmgrGetLastError();
+		if (erc != ercTransferPending) {
+			Complete(pop, fFalse, erc, cbOut, cbIn);
+			return;
+		}
+
+		if (!fCancelSent &&
+			(FCancelled(pop) || ((dblDeadline != 0) && (DblCoTimeSec() >= dblDeadline)))) {
+			// DMGR API Call: DmgrCancelTrans
+			DmgrCancelTrans(hif);
+			fCancelSent = fTrue;
+		}
+	}
+
+	Complete(pop, fTrue, ercNoErc, cbOut, cbIn);
+}
+
+/* ------------------------------------------------------------ */
+/***	CoHif::ReactorThread
+**
+**	Parameters:
+**		pvHif		- CoHif object
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Body of the reactor thread. Runs the queued operations in
+**		order until Free is called and the queue is empty.
+*/
+
+void * CoHif::ReactorThread(void * pvHif) {
+
+	CoHif *	pcoh = (CoHif *) pvHif;
+	COOP *	pop;
+
+	for (;;) {
+		pthread_mutex_lock(&pcoh->mtx);
+
+		while ((pcoh->popHead == NULL) && !pcoh->fQuit) {
+			pthread_cond_wait(&pcoh->cvQueue, &pcoh->mtx);
+		}
+
+		pop = pcoh->popHead;
+		if (pop == NULL) {
+			pthread_mutex_unlock(&pcoh->mtx);
+			break;
+		}
+
+		pcoh->popHead = pop->popNext;
+		if (pcoh->popHead == NULL) {
+			pcoh->popTail = NULL;
+		}
+
+		pthread_mutex_unlock(&pcoh->mtx);
+
+		if (pcoh->FCancelled(pop)) {
+			pcoh->Complete(pop, fFalse, ercTransferCancelled, 0, 0);
+		}
+		else {
+			pcoh->RunOp(pop);
+		}
+	}
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblCoTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used for transfer time limits.
+*/
+
+static double DblCoTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	TmsWait
+**
+**	Parameters:
+**		dblDeadline	- time limit of the transfer, 0 for none
+**
+**	Return Value:
+**		milliseconds to wait for the transfer before checking again
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		One slice, or less if the time limit expires sooner, but at
+**		least one millisecond.
+*/
+
+static DWORD TmsWait(double dblDeadline) {
+
+	double	dblLeft;
+
+	if (dblDeadline == 0) {
+		return tmsCoSlice;
+	}
+
+	dblLeft = (dblDeadline - DblCoTimeSec()) * 1000.0;
+	if (dblLeft >= tmsCoSlice) {
+		return tmsCoSlice;
+	}
+
+	return (dblLeft < 1) ? 1 : (DWORD) dblLeft;
+}
+
+/* ------------------------------------------------------------ */
+/***	CoSleepMs
+**
+**	Parameters:
+**		tms			- milliseconds to sleep
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sleeps the calling thread.
+*/
+
+static void CoSleepMs(DWORD tms) {
+
+	struct timespec	ts;
+
+	ts.tv_sec = tms / 1000;
+	ts.tv_nsec = (long) (tms % 1000) * 1000000L;
+
+	nanosleep(&ts, NULL);
+}
+
+/************************************************************************/
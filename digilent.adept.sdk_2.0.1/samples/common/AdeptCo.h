@@ -0,0 +1,421 @@
+/************************************************************************/
+/*																		*/
+/*  AdeptCo.h  --  Adept Coroutine Transfer Declarations				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Awaitable wrappers for the overlapped Adept data calls, for		*/
+/*		use from C++20 coroutines:										*/
+/*																		*/
+/*			XFERRES	res = co_await depp.GetRegRepeat(bReg, rgb, cb);	*/
+/*																		*/
+/*		A CoHif owns a reactor thread for one interface handle. The		*/
+/*		thread issues the queued transfers of the handle one at a time	*/
+/*		with fOverlap set, waits for each with DmgrGetTransResult and	*/
+/*		hands the waiting coroutine back to a CoLoop. CoLoop::Run		*/
+/*		resumes the coroutines on the calling thread, so one host		*/
+/*		thread can keep transfers in flight on many devices while the	*/
+/*		coroutines themselves never run concurrently.					*/
+/*																		*/
+/*		Transfers on one handle complete in the order they were			*/
+/*		awaited. CoHif::Cancel cancels the transfer in flight with		*/
+/*		DmgrCancelTrans together with all transfers queued behind it,	*/
+/*		and a transfer given a time limit with WithTimeout is			*/
+/*		cancelled when the limit expires. A cancelled transfer			*/
+/*		completes with ercTransferCancelled.							*/
+/*																		*/
+/*		Coroutines return CoTask, which yields a BOOL. A CoTask can be	*/
+/*		awaited by another coroutine or started with CoLoop::FSpawn.	*/
+/*		Coroutine frames are allocated with malloc and exceptions are	*/
+/*		not used, so programs build with -std=c++20 -fno-exceptions		*/
+/*		and link without the C++ runtime library like the other			*/
+/*		samples.														*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(ADEPTCO_INCLUDED)
+#define      ADEPTCO_INCLUDED
+
+#include <coroutine>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "depp.h"
+#include "dstm.h"
+#include "dspi.h"
+#include "djtg.h"
+#include "daio.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Time the reactor waits in DmgrGetTransResult before it checks for
+** cancellation.
+*/
+const DWORD		tmsCoSlice		= 10;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+class CoLoop;
+class CoHif;
+
+/* Result of an awaited transfer. cbOut and cbIn are the counts
+** returned by DmgrGetTransResult.
+*/
+typedef struct tagXFERRES {
+	BOOL	fOk;
+	ERC		erc;
+	DWORD	cbOut;
+	DWORD	cbIn;
+} XFERRES;
+
+/* A queued transfer. The issue function makes the overlapped call
+** with the arguments stored in the operation.
+*/
+typedef struct tagCOOP COOP;
+typedef BOOL (*PFNCOISSUE)(HIF hif, COOP * pop);
+
+struct tagCOOP {
+	PFNCOISSUE	pfnIssue;
+	BYTE		b;
+	BOOL		f1;
+	BOOL		f2;
+	INT32		chn;
+	BYTE *		pb1;
+	BYTE *		pb2;
+	DWORD		c1;
+	DWORD		c2;
+	DWORD		tmsTimeout;			// 0 for no limit
+
+	/* Filled in by CoHif
+	*/
+	DWORD		seq;
+	COOP *		popNext;
+	XFERRES		res;
+	std::coroutine_handle<>	h;
+};
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class CoTask {
+
+public:
+	struct promise_type;
+	typedef std::coroutine_handle<promise_type>	HCO;
+
+	struct FinalAwait {
+		bool	await_ready() noexcept			{ return false; }
+		std::coroutine_handle<>	await_suspend(HCO h) noexcept;
+		void	await_resume() noexcept			{ }
+	};
+
+	struct promise_type {
+		BOOL					fResult;
+		std::coroutine_handle<>	hContinue;		// coroutine awaiting this one
+		CoLoop *				ploop;			// loop that owns a spawned task
+
+		promise_type() : fResult(fFalse), ploop(NULL) { }
+
+		static void *	operator new(size_t cb) noexcept	{ return malloc(cb); }
+		static void		operator delete(void * pv) noexcept	{ free(pv); }
+		static CoTask	get_return_object_on_allocation_failure() noexcept	{ return CoTask(); }
+
+		CoTask	get_return_object() noexcept	{ return CoTask(HCO::from_promise(*this)); }
+		std::suspend_always	initial_suspend() noexcept	{ return std::suspend_always(); }
+		FinalAwait	final_suspend() noexcept	{ return FinalAwait(); }
+		void	return_value(BOOL f) noexcept	{ fResult = f; }
+		void	unhandled_exception() noexcept	{ abort(); }
+	};
+
+private:
+	HCO		h;
+
+	explicit CoTask(HCO hInit) : h(hInit) { }
+
+	friend class CoLoop;
+
+public:
+	CoTask() : h(NULL) { }
+	CoTask(CoTask && task) : h(task.h)	{ task.h = NULL; }
+	CoTask(const CoTask &) = delete;
+	CoTask &	operator=(const CoTask &) = delete;
+	~CoTask()							{ if (h) h.destroy(); }
+
+	BOOL	FValid()					{ return h != NULL; }
+
+	/* Awaiting a task starts it and resumes the caller when it
+	** returns. A task whose frame could not be allocated yields fFalse.
+	*/
+	bool	await_ready() noexcept		{ return !h || h.done(); }
+	std::coroutine_handle<>	await_suspend(std::coroutine_handle<> hCaller) noexcept {
+				h.promise().hContinue = hCaller;
+				return h;
+			}
+	BOOL	await_resume() noexcept		{ return h ? h.promise().fResult : fFalse; }
+};
+
+class CoLoop {
+
+private:
+	pthread_mutex_t	mtx;
+	pthread_cond_t	cvReady;
+	void **			rgpvReady;			// ring of coroutines to resume
+	DWORD			cpvReadyMax;
+	DWORD			ipvReadyHead;
+	DWORD			cpvReady;
+	DWORD			ctask;				// spawned tasks not yet returned
+	BOOL			fInit;
+
+	BOOL	FGrow();
+
+public:
+	CoLoop();
+
+	BOOL	FInit();
+	void	Free();
+	BOOL	FSpawn(CoTask && task);
+	void	Post(std::coroutine_handle<> h);
+	void	TaskDone();
+	void	Run();
+};
+
+class CoXfer {
+
+private:
+	CoHif *	pcoh;
+	COOP	op;
+
+public:
+	CoXfer(CoHif * pcohInit, const COOP & opInit) : pcoh(pcohInit), op(opInit) { }
+
+	CoXfer &	WithTimeout(DWORD tms)	{ op.tmsTimeout = tms; return *this; }
+
+	bool	await_ready() noexcept		{ return false; }
+	void	await_suspend(std::coroutine_handle<> h) noexcept;
+	XFERRES	await_resume() noexcept		{ return op.res; }
+};
+
+class CoHif {
+
+private:
+	HIF				hif;
+	CoLoop *		ploop;
+	pthread_t		thrd;
+	BOOL			fThread;
+	pthread_mutex_t	mtx;
+	pthread_cond_t	cvQueue;
+	COOP *			popHead;			// queued, not yet issued
+	COOP *			popTail;
+	DWORD			seqNext;
+	DWORD			seqCancel;			// operations before this are cancelled
+	BOOL			fQuit;
+
+	static void *	ReactorThread(void * pvHif);
+	void	Complete(COOP * pop, BOOL fOk, ERC erc, DWORD cbOut, DWORD cbIn);
+	BOOL	FCancelled(COOP * pop);
+	void	RunOp(COOP * pop);
+
+public:
+	CoHif();
+
+	BOOL	FInit(HIF hifInit, CoLoop * ploopInit);
+	void	Free();
+	HIF		Hif()						{ return hif; }
+	void	Submit(COOP * pop);
+	void	Cancel();
+};
+
+/* ------------------------------------------------------------ */
+/*					Transfer Wrappers							*/
+/* ------------------------------------------------------------ */
+
+/* Each wrapper stores its arguments in a COOP and returns a CoXfer to
+** be awaited. Buffers must stay valid until the transfer completes.
+*/
+
+inline COOP CoOpInit(PFNCOISSUE pfnIssue) {
+
+	COOP	op = {};
+
+	op.pfnIssue = pfnIssue;
+
+	return op;
+}
+
+class CoDepp {
+
+private:
+	CoHif *		pcoh;
+
+	static BOOL	FIssuePutReg(HIF hif, COOP * pop)	{ return DeppPutReg(hif, pop->b, (BYTE) pop->c1, fTrue); }
+	static BOOL	FIssueGetReg(HIF hif, COOP * pop)	{ return DeppGetReg(hif, pop->b, pop->pb1, fTrue); }
+	static BOOL	FIssuePutRegSet(HIF hif, COOP * pop)	{ return DeppPutRegSet(hif, pop->pb1, pop->c1, fTrue); }
+	static BOOL	FIssueGetRegSet(HIF hif, COOP * pop)	{ return DeppGetRegSet(hif, pop->pb1, pop->pb2, pop->c1, fTrue); }
+	static BOOL	FIssuePutRegRepeat(HIF hif, COOP * pop)	{ return DeppPutRegRepeat(hif, pop->b, pop->pb1, pop->c1, fTrue); }
+	static BOOL	FIssueGetRegRepeat(HIF hif, COOP * pop)	{ return DeppGetRegRepeat(hif, pop->b, pop->pb1, pop->c1, fTrue); }
+
+public:
+	CoDepp(CoHif & coh) : pcoh(&coh) { }
+
+	CoXfer	PutReg(BYTE bAddr, BYTE bData) {
+				COOP op = CoOpInit(FIssuePutReg);
+				op.b = bAddr; op.c1 = bData;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	GetReg(BYTE bAddr, BYTE * pbData) {
+				COOP op = CoOpInit(FIssueGetReg);
+				op.b = bAddr; op.pb1 = pbData;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	PutRegSet(BYTE * pbAddrData, DWORD nAddrDataPairs) {
+				COOP op = CoOpInit(FIssuePutRegSet);
+				op.pb1 = pbAddrData; op.c1 = nAddrDataPairs;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	GetRegSet(BYTE * pbAddr, BYTE * pbData, DWORD cbData) {
+				COOP op = CoOpInit(FIssueGetRegSet);
+				op.pb1 = pbAddr; op.pb2 = pbData; op.c1 = cbData;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	PutRegRepeat(BYTE bAddr, BYTE * pbData, DWORD cbData) {
+				COOP op = CoOpInit(FIssuePutRegRepeat);
+				op.b = bAddr; op.pb1 = pbData; op.c1 = cbData;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	GetRegRepeat(BYTE bAddr, BYTE * pbData, DWORD cbData) {
+				COOP op = CoOpInit(FIssueGetRegRepeat);
+				op.b = bAddr; op.pb1 = pbData; op.c1 = cbData;
+				return CoXfer(pcoh, op);
+			}
+};
+
+class CoDstm {
+
+private:
+	CoHif *		pcoh;
+
+	static BOOL	FIssueIO(HIF hif, COOP * pop)	{ return DstmIO(hif, pop->pb1, pop->c1, pop->pb2, pop->c2, fTrue); }
+	static BOOL	FIssueIOEx(HIF hif, COOP * pop)	{ return DstmIOEx(hif, pop->pb1, pop->c1, pop->pb2, pop->c2, fTrue); }
+
+public:
+	CoDstm(CoHif & coh) : pcoh(&coh) { }
+
+	CoXfer	IO(BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn) {
+				COOP op = CoOpInit(FIssueIO);
+				op.pb1 = rgbOut; op.c1 = cbOut; op.pb2 = rgbIn; op.c2 = cbIn;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	IOEx(BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn) {
+				COOP op = CoOpInit(FIssueIOEx);
+				op.pb1 = rgbOut; op.c1 = cbOut; op.pb2 = rgbIn; op.c2 = cbIn;
+				return CoXfer(pcoh, op);
+			}
+};
+
+class CoDspi {
+
+private:
+	CoHif *		pcoh;
+
+	static BOOL	FIssuePut(HIF hif, COOP * pop)	{ return DspiPut(hif, pop->f1, pop->f2, pop->pb1, pop->pb2, pop->c1, fTrue); }
+	static BOOL	FIssueGet(HIF hif, COOP * pop)	{ return DspiGet(hif, pop->f1, pop->f2, pop->b, pop->pb2, pop->c1, fTrue); }
+
+public:
+	CoDspi(CoHif & coh) : pcoh(&coh) { }
+
+	CoXfer	Put(BOOL fSelStart, BOOL fSelEnd, BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbSnd) {
+				COOP op = CoOpInit(FIssuePut);
+				op.f1 = fSelStart; op.f2 = fSelEnd; op.pb1 = rgbSnd; op.pb2 = rgbRcv; op.c1 = cbSnd;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	Get(BOOL fSelStart, BOOL fSelEnd, BYTE bFill, BYTE * rgbRcv, DWORD cbRcv) {
+				COOP op = CoOpInit(FIssueGet);
+				op.f1 = fSelStart; op.f2 = fSelEnd; op.b = bFill; op.pb2 = rgbRcv; op.c1 = cbRcv;
+				return CoXfer(pcoh, op);
+			}
+};
+
+class CoDjtg {
+
+private:
+	CoHif *		pcoh;
+
+	static BOOL	FIssuePutTdiBits(HIF hif, COOP * pop)	{ return DjtgPutTdiBits(hif, pop->f1, pop->pb1, pop->pb2, pop->c1, fTrue); }
+	static BOOL	FIssuePutTmsBits(HIF hif, COOP * pop)	{ return DjtgPutTmsBits(hif, pop->f1, pop->pb1, pop->pb2, pop->c1, fTrue); }
+	static BOOL	FIssuePutTmsTdiBits(HIF hif, COOP * pop)	{ return DjtgPutTmsTdiBits(hif, pop->pb1, pop->pb2, pop->c1, fTrue); }
+	static BOOL	FIssueGetTdoBits(HIF hif, COOP * pop)	{ return DjtgGetTdoBits(hif, pop->f1, pop->f2, pop->pb2, pop->c1, fTrue); }
+	static BOOL	FIssueClockTck(HIF hif, COOP * pop)		{ return DjtgClockTck(hif, pop->f1, pop->f2, pop->c1, fTrue); }
+
+public:
+	CoDjtg(CoHif & coh) : pcoh(&coh) { }
+
+	CoXfer	PutTdiBits(BOOL fTms, BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbits) {
+				COOP op = CoOpInit(FIssuePutTdiBits);
+				op.f1 = fTms; op.pb1 = rgbSnd; op.pb2 = rgbRcv; op.c1 = cbits;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	PutTmsBits(BOOL fTdi, BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbits) {
+				COOP op = CoOpInit(FIssuePutTmsBits);
+				op.f1 = fTdi; op.pb1 = rgbSnd; op.pb2 = rgbRcv; op.c1 = cbits;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	PutTmsTdiBits(BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbitpairs) {
+				COOP op = CoOpInit(FIssuePutTmsTdiBits);
+				op.pb1 = rgbSnd; op.pb2 = rgbRcv; op.c1 = cbitpairs;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	GetTdoBits(BOOL fTdi, BOOL fTms, BYTE * rgbRcv, DWORD cbits) {
+				COOP op = CoOpInit(FIssueGetTdoBits);
+				op.f1 = fTdi; op.f2 = fTms; op.pb2 = rgbRcv; op.c1 = cbits;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	ClockTck(BOOL fTms, BOOL fTdi, DWORD cclk) {
+				COOP op = CoOpInit(FIssueClockTck);
+				op.f1 = fTms; op.f2 = fTdi; op.c1 = cclk;
+				return CoXfer(pcoh, op);
+			}
+};
+
+class CoDaio {
+
+private:
+	CoHif *		pcoh;
+
+	static BOOL	FIssueGetBuffer(HIF hif, COOP * pop)	{ return DaioGetBuffer(hif, pop->chn, pop->c1, pop->pb2, fTrue); }
+	static BOOL	FIssuePutBuffer(HIF hif, COOP * pop)	{ return DaioPutBuffer(hif, pop->chn, pop->c1, pop->pb1, fTrue); }
+
+public:
+	CoDaio(CoHif & coh) : pcoh(&coh) { }
+
+	CoXfer	GetBuffer(INT32 chn, DWORD cbRcv, void * rgbRcv) {
+				COOP op = CoOpInit(FIssueGetBuffer);
+				op.chn = chn; op.c1 = cbRcv; op.pb2 = (BYTE *) rgbRcv;
+				return CoXfer(pcoh, op);
+			}
+	CoXfer	PutBuffer(INT32 chn, DWORD cbSnd, void * rgbSnd) {
+				COOP op = CoOpInit(FIssuePutBuffer);
+				op.chn = chn; op.c1 = cbSnd; op.pb1 = (BYTE *) rgbSnd;
+				return CoXfer(pcoh, op);
+			}
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// ADEPTCO_INCLUDED
+
+/************************************************************************/
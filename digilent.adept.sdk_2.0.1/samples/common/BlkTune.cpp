@@ -0,0 +1,536 @@
+/************************************************************************/
+/*																		*/
+/*  BlkTune.cpp  --  Transfer Block Size Autotuner						*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module sweeps a caller supplied bulk transfer over block	*/
+/*		sizes in powers of two and records the throughput and time per	*/
+/*		call of each size. The best size is stored in a per-user cache	*/
+/*		file keyed by APT name, transport and device serial number, so	*/
+/*		that later transfers to the same device can use it without		*/
+/*		measuring again. Callers that tune each direction separately	*/
+/*		add it to the APT name, such as "depp-put".						*/
+/*																		*/
+/*		The cache file is a text file with one							*/
+/*		"<apt> <transport> <sn> <bytes>" line per tuned device. Lines	*/
+/*		of any other form are dropped when the file is rewritten. It	*/
+/*		is located at $ADEPT_TUNE_CACHE if set, else					*/
+/*		$XDG_CACHE_HOME/digilent-adept-tune, else						*/
+/*		$HOME/.cache/digilent-adept-tune.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: cache keyed by transport as well						*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "BlkTune.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+const int	cchTunePathMax	= 1024;
+const int	cchTuneLineMax	= 128;
+const int	cchTuneAptMax	= 16;
+const int	cchTuneDtpMax	= cchDtpStringMax;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static BOOL		FTuneCachePath(char * szPath, BOOL fCreateDir);
+static double	DblTuneTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	FTuneGetDvc
+**
+**	Parameters:
+**		hif		- open interface handle
+**		szSn	- buffer of at least cchSnMax+1 characters to receive
+**				  the serial number
+**		szDtp	- buffer of at least cchDtpStringMax+1 characters to
+**				  receive the name of the transport
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the serial number of the device open on hif and the
+**		transport it is reached through, such as "USB". The same board
+**		reached through another transport is tuned separately.
+*/
+
+BOOL FTuneGetDvc(HIF hif, char * szSn, char * szDtp) {
+
+	DVC		dvc;
+	char *	pch;
+
+	// DMGR API Call: DmgrGetDvcFromHif
+	if (!DmgrGetDvcFromHif(hif, &dvc)) {
+		return fFalse;
+	}
+
+	// DMGR API Call: DmgrGetInfo
+	if (!DmgrGetInfo(&dvc, dinfoSN, szSn)) {
+		return fFalse;
+	}
+
+	szSn[cchSnMax] = '\0';
+
+	/* The cache file separates fields with spaces.
+	*/
+	// DMGR API Call: DmgrGetDtpString
+	if (!DmgrGetDtpString(dvc.dtp, szDtp) || (szDtp[0] == '\0')) {
+		snprintf(szDtp, cchTuneDtpMax + 1, "%08lX", (unsigned long) dvc.dtp);
+	}
+	szDtp[cchTuneDtpMax] = '\0';
+	for (pch = szDtp; *pch != '\0'; pch++) {
+		if (*pch == ' ') {
+			*pch = '_';
+		}
+	}
+
+	return szSn[0] != '\0';
+}
+
+/* ------------------------------------------------------------ */
+/***	FTuneLookup
+**
+**	Parameters:
+**		szApt		- APT name, such as "depp-get"
+**		szDtp		- transport name, from FTuneGetDvc
+**		szSn		- device serial number
+**		pcbBlock	- variable to receive the tuned block size
+**
+**	Return Value:
+**		fTrue if the device has been tuned, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks up the tuned block size for a device in the cache file.
+*/
+
+BOOL FTuneLookup(const char * szApt, const char * szDtp, const char * szSn, DWORD * pcbBlock) {
+
+	char			szPath[cchTunePathMax];
+	char			szLine[cchTuneLineMax];
+	char			szAptLine[cchTuneAptMax + 1];
+	char			szDtpLine[cchTuneDtpMax + 1];
+	char			szSnLine[cchSnMax + 1];
+	unsigned long	cb;
+	FILE *			fh;
+	BOOL			fFound;
+
+	if (!FTuneCachePath(szPath, fFalse)) {
+		return fFalse;
+	}
+
+	fh = fopen(szPath, "r");
+	if (fh == NULL) {
+		return fFalse;
+	}
+
+	fFound = fFalse;
+	while (!fFound && (fgets(szLine, sizeof(szLine), fh) != NULL)) {
+		if ((sscanf(szLine, "%16s %16s %15s %lu", szAptLine, szDtpLine, szSnLine, &cb) == 4) &&
+			(strcmp(szAptLine, szApt) == 0) && (strcmp(szDtpLine, szDtp) == 0) &&
+			(strcmp(szSnLine, szSn) == 0) && (cb > 0)) {
+			*pcbBlock = (DWORD) cb;
+			fFound = fTrue;
+		}
+	}
+
+	fclose(fh);
+
+	return fFound;
+}
+
+/* ------------------------------------------------------------ */
+/***	FTuneStore
+**
+**	Parameters:
+**		szApt		- APT name, such as "depp-get"
+**		szDtp		- transport name, from FTuneGetDvc
+**		szSn		- device serial number
+**		cbBlock		- tuned block size
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the tuned block size for a device in the cache file,
+**		replacing any previous entry. The file is rewritten through a
+**		temporary file so that concurrent readers never see a partial
+**		file.
+*/
+
+BOOL FTuneStore(const char * szApt, const char * szDtp, const char * szSn, DWORD cbBlock) {
+
+	char			szPath[cchTunePathMax];
+	char			szTmp[cchTunePathMax + 16];
+	char			szLine[cchTuneLineMax];
+	char			szAptLine[cchTuneAptMax + 1];
+	char			szDtpLine[cchTuneDtpMax + 1];
+	char			szSnLine[cchSnMax + 1];
+	unsigned long	cb;
+	FILE *			fhIn;
+	FILE *			fhOut;
+	BOOL			fOk;
+
+	if (!FTuneCachePath(szPath, fTrue)) {
+		return fFalse;
+	}
+
+	snprintf(szTmp, sizeof(szTmp), "%s.%ld", szPath, (long) getpid());
+
+	fhOut = fopen(szTmp, "w");
+	if (fhOut == NULL) {
+		return fFalse;
+	}
+
+	/* Copy the entries for other devices, transports and APTs.
+	*/
+	fhIn = fopen(szPath, "r");
+	if (fhIn != NULL) {
+		while (fgets(szLine, sizeof(szLine), fhIn) != NULL) {
+			if ((sscanf(szLine, "%16s %16s %15s %lu", szAptLine, szDtpLine, szSnLine, &cb) == 4) &&
+				((strcmp(szAptLine, szApt) != 0) || (strcmp(szDtpLine, szDtp) != 0) ||
+				(strcmp(szSnLine, szSn) != 0))) {
+				fprintf(fhOut, "%s %s %s %lu\n", szAptLine, szDtpLine, szSnLine, cb);
+			}
+		}
+		fclose(fhIn);
+	}
+
+	fprintf(fhOut, "%s %s %s %lu\n", szApt, szDtp, szSn, (unsigned long) cbBlock);
+
+	fOk = (fclose(fhOut) == 0);
+	if (fOk) {
+		fOk = (rename(szTmp, szPath) == 0);
+	}
+	if (!fOk) {
+		remove(szTmp);
+	}
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	FTuneSweep
+**
+**	Parameters:
+**		pfnXfer		- transfer function to measure
+**		pvCtx		- context passed to pfnXfer
+**		cbMin		- smallest block size to measure
+**		cbMax		- largest block size to measure
+**		ptuncrv		- variable to receive the measured curve
+**
+**	Return Value:
+**		fTrue if successful, fFalse if a transfer failed
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Measures the throughput of pfnXfer for each power of two
+**		block size from cbMin to cbMax. Each size is measured for at
+**		least dblTunePointSec and two calls. The chosen block size is
+**		the smallest one within dblTuneSlack of the best throughput.
+*/
+
+BOOL FTuneSweep(PFNTUNEXFER pfnXfer, void * pvCtx, DWORD cbMin, DWORD cbMax, TUNCRV * ptuncrv) {
+
+	BYTE *		rgb;
+	DWORD		cbBlock;
+	TUNPT *		ptunpt;
+	double		dblStart;
+	double		dblSec;
+	double		dblBest;
+	int			itunpt;
+	BOOL		fOk;
+
+	memset(ptuncrv, 0, sizeof(TUNCRV));
+
+	if ((cbMin == 0) || (cbMin > cbMax)) {
+		return fFalse;
+	}
+
+	rgb = (BYTE *) malloc(cbMax);
+	if (rgb == NULL) {
+		return fFalse;
+	}
+	memset(rgb, 0, cbMax);
+
+	fOk = fTrue;
+	cbBlock = cbMin;
+	while (fOk && (ptuncrv->ctunpt < ctunptMax)) {
+
+		ptunpt = &ptuncrv->rgtunpt[ptuncrv->ctunpt];
+		ptunpt->cbBlock = cbBlock;
+
+		dblStart = DblTuneTimeSec();
+		do {
+			fOk = pfnXfer(pvCtx, rgb, cbBlock);
+			ptunpt->ccall += 1;
+			dblSec = DblTuneTimeSec() - dblStart;
+		} while (fOk && ((dblSec < dblTunePointSec) || (ptunpt->ccall < 2)));
+
+		if (dblSec > 0) {
+			ptunpt->dblMBps = ((double) cbBlock * ptunpt->ccall / 1e6) / dblSec;
+		}
+		ptunpt->dblUsPerCall = dblSec * 1e6 / ptunpt->ccall;
+		ptuncrv->ctunpt += 1;
+
+		if ((cbBlock >= cbMax) || (cbBlock > cbMax / 2)) {
+			break;
+		}
+		cbBlock *= 2;
+	}
+
+	free(rgb);
+
+	if (!fOk) {
+		return fFalse;
+	}
+
+	dblBest = 0;
+	for (itunpt = 0; itunpt < ptuncrv->ctunpt; itunpt++) {
+		if (ptuncrv->rgtunpt[itunpt].dblMBps > dblBest) {
+			dblBest = ptuncrv->rgtunpt[itunpt].dblMBps;
+		}
+	}
+
+	for (itunpt = 0; itunpt < ptuncrv->ctunpt; itunpt++) {
+		if (ptuncrv->rgtunpt[itunpt].dblMBps >= dblBest * (1.0 - dblTuneSlack)) {
+			ptuncrv->cbBest = ptuncrv->rgtunpt[itunpt].cbBlock;
+			break;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	TunePrintCurve
+**
+**	Parameters:
+**		ptuncrv		- curve measured by FTuneSweep
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Prints the measured throughput curve and the chosen size.
+*/
+
+void TunePrintCurve(const TUNCRV * ptuncrv) {
+
+	int		itunpt;
+
+	printf("%10s %8s %10s %12s\n", "block", "calls", "MB/s", "us/call");
+
+	for (itunpt = 0; itunpt < ptuncrv->ctunpt; itunpt++) {
+		printf("%10lu %8lu %10.3f %12.1f%s\n",
+				(unsigned long) ptuncrv->rgtunpt[itunpt].cbBlock,
+				(unsigned long) ptuncrv->rgtunpt[itunpt].ccall,
+				ptuncrv->rgtunpt[itunpt].dblMBps,
+				ptuncrv->rgtunpt[itunpt].dblUsPerCall,
+				(ptuncrv->rgtunpt[itunpt].cbBlock == ptuncrv->cbBest) ? "  <- chosen" : "");
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FTuneGetBlock
+**
+**	Parameters:
+**		hif			- open interface handle
+**		szApt		- APT name, such as "depp-get"
+**		pcbBlock	- variable to receive the tuned block size
+**
+**	Return Value:
+**		fTrue if the device has been tuned, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks up the tuned block size for the device open on hif
+**		without measuring it. Used by callers whose transfers must not
+**		be repeated on the device, such as writes to a FIFO.
+*/
+
+BOOL FTuneGetBlock(HIF hif, const char * szApt, DWORD * pcbBlock) {
+
+	char	szSn[cchSnMax + 1];
+	char	szDtp[cchTuneDtpMax + 1];
+
+	if (!FTuneGetDvc(hif, szSn, szDtp)) {
+		return fFalse;
+	}
+
+	return FTuneLookup(szApt, szDtp, szSn, pcbBlock);
+}
+
+/* ------------------------------------------------------------ */
+/***	CbTuneBlock
+**
+**	Parameters:
+**		hif			- open interface handle
+**		szApt		- APT name, such as "depp-get"
+**		pfnXfer		- transfer function used if a sweep is needed
+**		pvCtx		- context passed to pfnXfer
+**		cbMin		- smallest block size to measure
+**		cbMax		- largest block size to measure
+**		cbDefault	- block size used if tuning fails
+**
+**	Return Value:
+**		block size to use for bulk transfers
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the cached block size for the device open on hif. On
+**		first use of a device a sweep is run and its result is stored
+**		in the cache.
+*/
+
+DWORD CbTuneBlock(HIF hif, const char * szApt, PFNTUNEXFER pfnXfer, void * pvCtx,
+				DWORD cbMin, DWORD cbMax, DWORD cbDefault) {
+
+	char	szSn[cchSnMax + 1];
+	char	szDtp[cchTuneDtpMax + 1];
+	DWORD	cbBlock;
+	TUNCRV	tuncrv;
+
+	if (!FTuneGetDvc(hif, szSn, szDtp)) {
+		return cbDefault;
+	}
+
+	if (FTuneLookup(szApt, szDtp, szSn, &cbBlock)) {
+		return cbBlock;
+	}
+
+	printf("Tuning %s block size for %s device %s\n", szApt, szDtp, szSn);
+
+	if (!FTuneSweep(pfnXfer, pvCtx, cbMin, cbMax, &tuncrv)) {
+		return cbDefault;
+	}
+
+	TunePrintCurve(&tuncrv);
+	FTuneStore(szApt, szDtp, szSn, tuncrv.cbBest);
+
+	return tuncrv.cbBest;
+}
+
+/* ------------------------------------------------------------ */
+/***	FTuneCachePath
+**
+**	Parameters:
+**		szPath		- buffer of cchTunePathMax characters to receive
+**					  the cache file path
+**		fCreateDir	- fTrue to create the cache directory if needed
+**
+**	Return Value:
+**		fTrue if successful, fFalse if no location is available
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Determines the location of the per-user cache file.
+*/
+
+static BOOL FTuneCachePath(char * szPath, BOOL fCreateDir) {
+
+	const char *	szEnv;
+	char			szDir[cchTunePathMax - sizeof("/digilent-adept-tune")];
+
+	szEnv = getenv("ADEPT_TUNE_CACHE");
+	if ((szEnv != NULL) && (szEnv[0] != '\0')) {
+		snprintf(szPath, cchTunePathMax, "%s", szEnv);
+		return fTrue;
+	}
+
+	szEnv = getenv("XDG_CACHE_HOME");
+	if ((szEnv != NULL) && (szEnv[0] != '\0')) {
+		snprintf(szDir, sizeof(szDir), "%s", szEnv);
+	}
+	else {
+		szEnv = getenv("HOME");
+		if ((szEnv == NULL) || (szEnv[0] == '\0')) {
+			return fFalse;
+		}
+		snprintf(szDir, sizeof(szDir), "%s/.cache", szEnv);
+	}
+
+	if (fCreateDir) {
+		mkdir(szDir, 0700);
+	}
+
+	snprintf(szPath, cchTunePathMax, "%s/digilent-adept-tune", szDir);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTuneTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the transfers being measured.
+*/
+
+static double DblTuneTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+
+/************************************************************************/
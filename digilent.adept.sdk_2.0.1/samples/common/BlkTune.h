@@ -0,0 +1,92 @@
+/************************************************************************/
+/*																		*/
+/*  BlkTune.h  --  Transfer Block Size Autotuner Declarations			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		The block size autotuner measures the throughput of a bulk		*/
+/*		transfer function over a range of block sizes and remembers		*/
+/*		the best size for each device serial number and transport in	*/
+/*		a per-user cache file. The transfer itself is supplied by the	*/
+/*		caller so that the tuner can be used with any APT (DEPP, DSTM,	*/
+/*		...).															*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: cache keyed by transport as well						*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(BLKTUNE_INCLUDED)
+#define      BLKTUNE_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Maximum number of points measured by a sweep. Block sizes are
+** swept in powers of two, so this covers any DWORD range.
+*/
+const int		ctunptMax		= 32;
+
+/* Minimum time spent measuring each block size.
+*/
+const double	dblTunePointSec	= 0.05;
+
+/* A block size is considered as good as the best one if its
+** throughput is within this fraction of the best throughput. The
+** smallest such size is chosen, as it has the lowest latency.
+*/
+const double	dblTuneSlack	= 0.05;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Transfer function supplied by the caller. It must move cb bytes
+** to or from rgb and return fTrue if successful.
+*/
+typedef BOOL (* PFNTUNEXFER)(void * pvCtx, BYTE * rgb, DWORD cb);
+
+/* One measured point of the throughput curve.
+*/
+typedef struct tagTUNPT {
+	DWORD	cbBlock;
+	DWORD	ccall;				// number of calls made
+	double	dblMBps;			// throughput in MB/s
+	double	dblUsPerCall;		// mean time per call in microseconds
+} TUNPT;
+
+/* Result of a sweep.
+*/
+typedef struct tagTUNCRV {
+	int		ctunpt;
+	TUNPT	rgtunpt[ctunptMax];
+	DWORD	cbBest;
+} TUNCRV;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FTuneGetDvc(HIF hif, char * szSn, char * szDtp);
+BOOL	FTuneLookup(const char * szApt, const char * szDtp, const char * szSn, DWORD * pcbBlock);
+BOOL	FTuneStore(const char * szApt, const char * szDtp, const char * szSn, DWORD cbBlock);
+BOOL	FTuneGetBlock(HIF hif, const char * szApt, DWORD * pcbBlock);
+BOOL	FTuneSweep(PFNTUNEXFER pfnXfer, void * pvCtx, DWORD cbMin, DWORD cbMax, TUNCRV * ptuncrv);
+void	TunePrintCurve(const TUNCRV * ptuncrv);
+DWORD	CbTuneBlock(HIF hif, const char * szApt, PFNTUNEXFER pfnXfer, void * pvCtx,
+					DWORD cbMin, DWORD cbMax, DWORD cbDefault);
+
+/* ------------------------------------------------------------ */
+
+#endif					// BLKTUNE_INCLUDED
+
+/************************************************************************/
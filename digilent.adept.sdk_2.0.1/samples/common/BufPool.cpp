@@ -0,0 +1,801 @@
+/************************************************************************/
+/*																		*/
+/*  BufPool.cpp  --  Transfer Buffer Pool								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the BufPool class and the shared pool.	*/
+/*		See BufPool.h.													*/
+/*																		*/
+/*		The region is mapped anonymously, so it is page aligned, and	*/
+/*		every page is written once when the pool is initialized so		*/
+/*		that the memory is committed before the first transfer. For		*/
+/*		transparent huge pages the region is aligned to a huge page		*/
+/*		so that the kernel can back all of it with them.				*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: lock free free list, huge pages, mlock, shared pool		*/
+/*	10/17/2026: PbBufPoolAlloc applies the shared pool options			*/
+/*	10/17/2026: FpoolHugeFit, huge pages for large pools only			*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "dpcdecl.h"
+#include "BufPool.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+/* The shared pool. It is created and freed by the main thread
+** while no other thread uses it.
+*/
+static BufPool	poolShared;
+static BOOL		fSharedInit = fFalse;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	BufPool::BufPool
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The pool must be initialized with FInit before
+**		it is used.
+*/
+
+BufPool::BufPool() {
+
+	pbBase = NULL;
+	cbRegion = 0;
+	rgpbBorrow = NULL;
+	cbBuf = 0;
+	cbuf = 0;
+	fpool = 0;
+	rgibufNext = NULL;
+	qwFreeHead = 0;
+	cbufFree = 0;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::FInit
+**
+**	Parameters:
+**		cbBufMin	- minimum size of each buffer in bytes
+**		cbufInit	- number of buffers
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates and commits the buffers, from the shared pool if it
+**		can supply them and otherwise with the huge page and locking
+**		options of the shared pool. The buffer size is rounded up to
+**		a multiple of the page size, or is the size of the shared
+**		buffers if they are used.
+*/
+
+BOOL BufPool::FInit(DWORD cbBufMin, DWORD cbufInit) {
+
+	DWORD	fpoolInit = fpoolShared;
+
+	if (fSharedInit) {
+		fpoolInit |= poolShared.Fpool() & (fpoolHuge | fpoolLock);
+	}
+
+	return FInitEx(cbBufMin, cbufInit, fpoolInit);
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::FInitEx
+**
+**	Parameters:
+**		cbBufMin	- minimum size of each buffer in bytes
+**		cbufInit	- number of buffers
+**		fpoolInit	- options, see BufPool.h
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates and commits the buffers with the given options.
+*/
+
+BOOL BufPool::FInitEx(DWORD cbBufMin, DWORD cbufInit, DWORD fpoolInit) {
+
+	DWORD	ibuf;
+
+	if (fInit || (cbBufMin == 0) || (cbufInit == 0)) {
+		return fFalse;
+	}
+
+	cbuf = cbufInit;
+	fpool = 0;
+	rgibufNext = (DWORD *) malloc(cbuf * sizeof(DWORD));
+	if (rgibufNext == NULL) {
+		return fFalse;
+	}
+
+	if (((fpoolInit & fpoolShared) == 0) || !FBorrow(cbBufMin, cbufInit)) {
+		if (!FMapRegion(cbBufMin, fpoolInit)) {
+			free(rgibufNext);
+			rgibufNext = NULL;
+			return fFalse;
+		}
+	}
+	fpool |= fpoolInit & fpoolZero;
+
+	/* Hand out the lowest buffers first.
+	*/
+	qwFreeHead = 0;
+	cbufFree = 0;
+	for (ibuf = cbuf; ibuf > 0; ibuf--) {
+		Push(ibuf - 1);
+	}
+
+	fInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::FMapRegion
+**
+**	Parameters:
+**		cbBufMin	- minimum size of each buffer in bytes
+**		fpoolInit	- options
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Maps and commits a region of its own for the pool, and sets
+**		the huge page and locking options that took effect.
+*/
+
+BOOL BufPool::FMapRegion(DWORD cbBufMin, DWORD fpoolInit) {
+
+	size_t	cbPage;
+	size_t	ib;
+	BYTE *	pbMap;
+	BYTE *	pbAlign;
+	void *	pv = MAP_FAILED;
+
+	cbPage = (size_t) sysconf(_SC_PAGESIZE);
+	cbBuf = (DWORD) (((cbBufMin + cbPage - 1) / cbPage) * cbPage);
+	cbRegion = (size_t) cbBuf * cbuf;
+	fpool = 0;
+
+	if (fpoolInit & fpoolHuge) {
+		cbRegion = ((cbRegion + cbPoolHugePage - 1) / cbPoolHugePage) * cbPoolHugePage;
+
+#if defined(MAP_HUGETLB)
+		pv = mmap(NULL, cbRegion, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (pv != MAP_FAILED) {
+			fpool |= fpoolHuge | fpoolHugeTlb;
+		}
+#endif
+
+		/* No hugetlbfs pages. Map a region aligned to a huge page and
+		** ask for transparent huge pages.
+		*/
+		if (pv == MAP_FAILED) {
+			pv = mmap(NULL, cbRegion + cbPoolHugePage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (pv != MAP_FAILED) {
+				pbMap = (BYTE *) pv;
+				pbAlign = (BYTE *) ((((uintptr_t) pbMap) + cbPoolHugePage - 1) & ~((uintptr_t) cbPoolHugePage - 1));
+				if (pbAlign > pbMap) {
+					munmap(pbMap, pbAlign - pbMap);
+				}
+				munmap(pbAlign + cbRegion, (pbMap + cbPoolHugePage) - pbAlign);
+				pv = pbAlign;
+
+#if defined(MADV_HUGEPAGE)
+				if (madvise(pv, cbRegion, MADV_HUGEPAGE) == 0) {
+					fpool |= fpoolHuge;
+				}
+#endif
+			}
+		}
+	}
+	else {
+		pv = mmap(NULL, cbRegion, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+
+	if (pv == MAP_FAILED) {
+		return fFalse;
+	}
+	pbBase = (BYTE *) pv;
+
+	/* Locking fails if it would exceed RLIMIT_MEMLOCK. The pool is
+	** still usable, only not pinned.
+	*/
+	if ((fpoolInit & fpoolLock) && (mlock(pbBase, cbRegion) == 0)) {
+		fpool |= fpoolLock;
+	}
+
+	/* Commit the memory now rather than on the first transfer.
+	*/
+	for (ib = 0; ib < cbRegion; ib += cbPage) {
+		pbBase[ib] = 0;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::FBorrow
+**
+**	Parameters:
+**		cbBufMin	- minimum size of each buffer in bytes
+**		cbufInit	- number of buffers
+**
+**	Return Value:
+**		fTrue if the buffers were taken from the shared pool, fFalse
+**		if it cannot supply them
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Takes all the buffers of the pool from the shared pool. The
+**		buffers are returned to it by Free.
+*/
+
+BOOL BufPool::FBorrow(DWORD cbBufMin, DWORD cbufInit) {
+
+	DWORD	ibuf;
+
+	if (!fSharedInit || (this == &poolShared) || (poolShared.CbBuf() < cbBufMin) ||
+		(poolShared.CbufFree() < cbufInit)) {
+		return fFalse;
+	}
+
+	rgpbBorrow = (BYTE **) malloc(cbufInit * sizeof(BYTE *));
+	if (rgpbBorrow == NULL) {
+		return fFalse;
+	}
+
+	/* Another thread may take shared buffers at the same time, so
+	** the count checked above is not a promise.
+	*/
+	for (ibuf = 0; ibuf < cbufInit; ibuf++) {
+		rgpbBorrow[ibuf] = poolShared.PbAlloc();
+		if (rgpbBorrow[ibuf] == NULL) {
+			while (ibuf > 0) {
+				poolShared.Release(rgpbBorrow[--ibuf]);
+			}
+			free(rgpbBorrow);
+			rgpbBorrow = NULL;
+			return fFalse;
+		}
+	}
+
+	cbBuf = poolShared.CbBuf();
+	fpool = fpoolShared | (poolShared.Fpool() & (fpoolHuge | fpoolHugeTlb | fpoolLock));
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Frees the pool, or returns its buffers to the shared pool. No
+**		buffer may be in use.
+*/
+
+void BufPool::Free() {
+
+	DWORD	ibuf;
+
+	if (!fInit) {
+		return;
+	}
+
+	if (rgpbBorrow != NULL) {
+		for (ibuf = 0; ibuf < cbuf; ibuf++) {
+			poolShared.Release(rgpbBorrow[ibuf]);
+		}
+		free(rgpbBorrow);
+		rgpbBorrow = NULL;
+	}
+	else {
+		munmap(pbBase, cbRegion);
+		pbBase = NULL;
+	}
+
+	free(rgibufNext);
+	rgibufNext = NULL;
+	qwFreeHead = 0;
+	cbufFree = 0;
+	fpool = 0;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::PbAlloc
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		pointer to a buffer of CbBuf() bytes, NULL if none is free
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Takes a buffer from the pool, zeroed if the pool was created
+**		with fpoolZero.
+*/
+
+BYTE * BufPool::PbAlloc() {
+
+	unsigned long long	qwHead;
+	unsigned long long	qwNew;
+	DWORD				ibuf;
+	BYTE *				pb;
+
+	if (!fInit) {
+		return NULL;
+	}
+
+	qwHead = __atomic_load_n(&qwFreeHead, __ATOMIC_ACQUIRE);
+	do {
+		if ((DWORD) qwHead == 0) {
+			return NULL;
+		}
+		ibuf = (DWORD) qwHead - 1;
+
+		/* If another thread takes this buffer first, the value read
+		** here may be stale, but then the tag has moved on and the
+		** swap fails.
+		*/
+		qwNew = (((qwHead >> 32) + 1) << 32) | __atomic_load_n(&rgibufNext[ibuf], __ATOMIC_RELAXED);
+	} while (!__atomic_compare_exchange_n(&qwFreeHead, &qwHead, qwNew, fTrue, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+	__atomic_sub_fetch(&cbufFree, 1, __ATOMIC_RELAXED);
+
+	pb = PbBuf(ibuf);
+	if (fpool & fpoolZero) {
+		memset(pb, 0, cbBuf);
+	}
+
+	return pb;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::Release
+**
+**	Parameters:
+**		pb			- buffer returned by PbAlloc
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns a buffer to the pool. Pointers that are not buffers of
+**		the pool are ignored. A buffer must be released only once.
+*/
+
+void BufPool::Release(BYTE * pb) {
+
+	DWORD	ibuf;
+
+	if (!fInit || !FIbuf(pb, &ibuf)) {
+		return;
+	}
+
+	Push(ibuf);
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::FOwns
+**
+**	Parameters:
+**		pb			- pointer to check
+**
+**	Return Value:
+**		fTrue if pb is a buffer of the pool, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to tell pool buffers from other allocations.
+*/
+
+BOOL BufPool::FOwns(const BYTE * pb) {
+
+	DWORD	ibuf;
+
+	return fInit && FIbuf(pb, &ibuf);
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::CbufFree
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		number of buffers not in use
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to check that all buffers were released.
+*/
+
+DWORD BufPool::CbufFree() {
+
+	if (!fInit) {
+		return 0;
+	}
+
+	return __atomic_load_n(&cbufFree, __ATOMIC_RELAXED);
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::PbBuf
+**
+**	Parameters:
+**		ibuf		- buffer index
+**
+**	Return Value:
+**		pointer to the buffer
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Maps a buffer index to its address.
+*/
+
+BYTE * BufPool::PbBuf(DWORD ibuf) {
+
+	if (rgpbBorrow != NULL) {
+		return rgpbBorrow[ibuf];
+	}
+
+	return pbBase + (size_t) ibuf * cbBuf;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::FIbuf
+**
+**	Parameters:
+**		pb			- pointer to a buffer
+**		pibuf		- receives the index of the buffer
+**
+**	Return Value:
+**		fTrue if pb is a buffer of the pool, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Maps a buffer address to its index. Borrowed buffers are
+**		searched for; pools that borrow are the rings of the stream
+**		classes, which are small and release only when they are freed.
+*/
+
+BOOL BufPool::FIbuf(const BYTE * pb, DWORD * pibuf) {
+
+	DWORD	ibuf;
+
+	if (rgpbBorrow != NULL) {
+		for (ibuf = 0; ibuf < cbuf; ibuf++) {
+			if (rgpbBorrow[ibuf] == pb) {
+				*pibuf = ibuf;
+				return fTrue;
+			}
+		}
+		return fFalse;
+	}
+
+	if ((pb < pbBase) || (pb >= pbBase + (size_t) cbBuf * cbuf) ||
+		(((size_t) (pb - pbBase)) % cbBuf != 0)) {
+		return fFalse;
+	}
+
+	*pibuf = (DWORD) ((size_t) (pb - pbBase) / cbBuf);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPool::Push
+**
+**	Parameters:
+**		ibuf		- index of the buffer
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Puts a buffer on top of the free list.
+*/
+
+void BufPool::Push(DWORD ibuf) {
+
+	unsigned long long	qwHead;
+	unsigned long long	qwNew;
+
+	qwHead = __atomic_load_n(&qwFreeHead, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n(&rgibufNext[ibuf], (DWORD) qwHead, __ATOMIC_RELAXED);
+		qwNew = (((qwHead >> 32) + 1) << 32) | (ibuf + 1);
+	} while (!__atomic_compare_exchange_n(&qwFreeHead, &qwHead, qwNew, fTrue, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	__atomic_add_fetch(&cbufFree, 1, __ATOMIC_RELAXED);
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPoolInitShared
+**
+**	Parameters:
+**		cbBufMin	- minimum size of each buffer in bytes
+**		cbuf		- number of buffers
+**		fpool		- options, see BufPool.h
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Creates the shared pool. Call it once at the start of the
+**		program, before any thread uses a BufPool; the pools of the
+**		stream classes created after it borrow from it.
+*/
+
+BOOL BufPoolInitShared(DWORD cbBufMin, DWORD cbuf, DWORD fpool) {
+
+	if (fSharedInit) {
+		return fFalse;
+	}
+
+	if (!poolShared.FInitEx(cbBufMin, cbuf, fpool & ~fpoolShared)) {
+		return fFalse;
+	}
+
+	fSharedInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPoolFreeShared
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Frees the shared pool. The pools that borrowed from it must
+**		have been freed.
+*/
+
+void BufPoolFreeShared() {
+
+	if (!fSharedInit) {
+		return;
+	}
+
+	fSharedInit = fFalse;
+	poolShared.Free();
+}
+
+/* ------------------------------------------------------------ */
+/***	PpoolShared
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		the shared pool, NULL if it has not been created
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to query the shared pool.
+*/
+
+BufPool * PpoolShared() {
+
+	return fSharedInit ? &poolShared : NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	FpoolHugeFit
+**
+**	Parameters:
+**		cbBufMin	- minimum size of each buffer in bytes
+**		cbuf		- number of buffers
+**
+**	Return Value:
+**		fpoolHuge if the buffers fill at least half a huge page, 0 if
+**		not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to ask for huge pages only when a pool is large enough to
+**		use them. A huge page is mapped and, with fpoolLock, locked as
+**		a whole, so a pool of a few small buffers would pin 2 MB.
+*/
+
+DWORD FpoolHugeFit(DWORD cbBufMin, DWORD cbuf) {
+
+	return (((size_t) cbBufMin * cbuf) >= cbPoolHugePage / 2) ? fpoolHuge : 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	PbBufPoolAlloc
+**
+**	Parameters:
+**		cb			- size of the buffer in bytes
+**
+**	Return Value:
+**		pointer to a page aligned buffer, NULL if out of memory
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Takes a buffer from the shared pool, or allocates one if there
+**		is no shared pool, its buffers are too small or none is free.
+**		An allocated buffer gets the options in effect in the shared
+**		pool: it is zeroed, locked, and, if it spans a huge page,
+**		backed by transparent huge pages. Give the buffer back with
+**		BufPoolRelease.
+*/
+
+BYTE * PbBufPoolAlloc(DWORD cb) {
+
+	BYTE *	pb;
+	void *	pv;
+	size_t	cbPage;
+	size_t	cbAlign;
+	size_t	cbAlloc;
+	DWORD	fpoolAlloc;
+
+	if (fSharedInit && (cb <= poolShared.CbBuf())) {
+		pb = poolShared.PbAlloc();
+		if (pb != NULL) {
+			return pb;
+		}
+	}
+
+	fpoolAlloc = fSharedInit ? poolShared.Fpool() : 0;
+
+	cbPage = (size_t) sysconf(_SC_PAGESIZE);
+	cbAlign = cbPage;
+	cbAlloc = ((((size_t) cb) + cbPage - 1) / cbPage) * cbPage;
+	if (cbAlloc == 0) {
+		cbAlloc = cbPage;
+	}
+	if ((fpoolAlloc & fpoolHuge) && (cbAlloc >= cbPoolHugePage)) {
+		cbAlign = cbPoolHugePage;
+		cbAlloc = ((cbAlloc + cbPoolHugePage - 1) / cbPoolHugePage) * cbPoolHugePage;
+	}
+
+	/* The buffer is preceded by cbAlign bytes that record its size,
+	** so that BufPoolRelease can unlock it.
+	*/
+	if (posix_memalign(&pv, cbAlign, cbAlign + cbAlloc) != 0) {
+		return NULL;
+	}
+	pb = (BYTE *) pv + cbAlign;
+	((size_t *) pb)[-1] = cbAlloc;
+	((size_t *) pb)[-2] = cbAlign;
+
+#if defined(MADV_HUGEPAGE)
+	if (cbAlign == cbPoolHugePage) {
+		madvise(pb, cbAlloc, MADV_HUGEPAGE);
+	}
+#endif
+
+	if (fpoolAlloc & fpoolLock) {
+		mlock(pb, cbAlloc);
+	}
+
+	if (fpoolAlloc & fpoolZero) {
+		memset(pb, 0, cbAlloc);
+	}
+
+	return pb;
+}
+
+/* ------------------------------------------------------------ */
+/***	BufPoolRelease
+**
+**	Parameters:
+**		pb			- buffer returned by PbBufPoolAlloc, or NULL
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Gives back a buffer taken with PbBufPoolAlloc.
+*/
+
+void BufPoolRelease(BYTE * pb) {
+
+	if (pb == NULL) {
+		return;
+	}
+
+	if (fSharedInit && poolShared.FOwns(pb)) {
+		poolShared.Release(pb);
+	}
+	else {
+		munlock(pb, ((size_t *) pb)[-1]);
+		free(pb - ((size_t *) pb)[-2]);
+	}
+}
+
+/************************************************************************/
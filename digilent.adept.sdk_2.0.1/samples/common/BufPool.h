@@ -0,0 +1,144 @@
+/************************************************************************/
+/*																		*/
+/*  BufPool.h  --  Transfer Buffer Pool Declarations					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A BufPool allocates all the transfer buffers of a program in	*/
+/*		one page aligned region when it is initialized, and touches		*/
+/*		every page so that no page faults or allocations happen once	*/
+/*		the transfers have started. Each buffer starts on a page		*/
+/*		boundary. Buffers are taken with PbAlloc and given back with	*/
+/*		Release, from any thread. The free list is a lock free stack,	*/
+/*		so threads streaming from several boards never wait on each		*/
+/*		other to take or return a buffer.								*/
+/*																		*/
+/*		FInitEx options:												*/
+/*																		*/
+/*			fpoolHuge	- back the region with 2 MB huge pages: from	*/
+/*						  the hugetlbfs pool if the system has one,		*/
+/*						  otherwise transparent huge pages				*/
+/*			fpoolLock	- mlock the region so that it is never paged	*/
+/*						  out											*/
+/*			fpoolZero	- zero each buffer when it is taken				*/
+/*			fpoolShared	- take the buffers from the shared pool if it	*/
+/*						  can supply them								*/
+/*																		*/
+/*		Huge pages and locking are best effort: if the system refuses	*/
+/*		them the pool is made of ordinary pages, and Fpool reports the	*/
+/*		options that took effect. FpoolHugeFit gives fpoolHuge only		*/
+/*		for pools of at least half a huge page, so that a small pool	*/
+/*		does not map and lock a whole one.								*/
+/*																		*/
+/*		The shared pool is one pool for the whole process, created		*/
+/*		with BufPoolInitShared at the start of the program. A pool		*/
+/*		initialized with FInit, as the stream classes in this			*/
+/*		directory do, borrows its buffers from the shared pool when		*/
+/*		the shared buffers are large enough and enough of them are		*/
+/*		free, and otherwise allocates its own region with the huge		*/
+/*		page and locking options of the shared pool. PbBufPoolAlloc		*/
+/*		and BufPoolRelease take single buffers for one-off transfers;	*/
+/*		a buffer PbBufPoolAlloc allocates itself is locked and zeroed	*/
+/*		as the shared pool is, and uses huge pages if it spans one.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: lock free free list, huge pages, mlock, shared pool		*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(BUFPOOL_INCLUDED)
+#define      BUFPOOL_INCLUDED
+
+#include <stddef.h>
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Options of FInitEx and BufPoolInitShared.
+*/
+const DWORD		fpoolHuge		= 0x0001;
+const DWORD		fpoolLock		= 0x0002;
+const DWORD		fpoolZero		= 0x0004;
+const DWORD		fpoolShared		= 0x0008;
+
+/* Set by Fpool when the huge pages come from the hugetlbfs pool
+** rather than from transparent huge pages.
+*/
+const DWORD		fpoolHugeTlb	= 0x0100;
+
+const size_t	cbPoolHugePage	= 2 * 1024 * 1024;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class BufPool {
+
+private:
+	BYTE *			pbBase;				// region, NULL when borrowed
+	size_t			cbRegion;
+	BYTE **			rgpbBorrow;			// buffers borrowed from the shared pool
+	DWORD			cbBuf;				// size of each buffer, page multiple
+	DWORD			cbuf;
+	DWORD			fpool;				// options in effect
+	BOOL			fInit;
+
+	/* Free list. Buffer ibuf is on the list when it is free, and
+	** rgibufNext[ibuf] is the next one down. qwFreeHead holds one
+	** more than the index of the top buffer, 0 if the list is empty,
+	** in its low 32 bits, and a tag in its high 32 bits that is
+	** advanced on every change so that a stale compare and swap
+	** fails.
+	*/
+	DWORD *			rgibufNext;
+	unsigned long long	qwFreeHead;
+	DWORD			cbufFree;
+
+	BOOL	FMapRegion(DWORD cbBufMin, DWORD fpoolInit);
+	BOOL	FBorrow(DWORD cbBufMin, DWORD cbufInit);
+	BYTE *	PbBuf(DWORD ibuf);
+	BOOL	FIbuf(const BYTE * pb, DWORD * pibuf);
+	void	Push(DWORD ibuf);
+
+public:
+	BufPool();
+
+	BOOL	FInit(DWORD cbBufMin, DWORD cbufInit);
+	BOOL	FInitEx(DWORD cbBufMin, DWORD cbufInit, DWORD fpoolInit);
+	void	Free();
+	BYTE *	PbAlloc();
+	void	Release(BYTE * pb);
+	BOOL	FOwns(const BYTE * pb);
+
+	DWORD	CbBuf()				{ return cbBuf; }
+	DWORD	Cbuf()				{ return cbuf; }
+	DWORD	Fpool()				{ return fpool; }
+	BOOL	FBorrowed()			{ return rgpbBorrow != NULL; }
+	DWORD	CbufFree();
+};
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL		BufPoolInitShared(DWORD cbBufMin, DWORD cbuf, DWORD fpool);
+void		BufPoolFreeShared();
+BufPool *	PpoolShared();
+DWORD		FpoolHugeFit(DWORD cbBufMin, DWORD cbuf);
+BYTE *		PbBufPoolAlloc(DWORD cb);
+void		BufPoolRelease(BYTE * pb);
+
+/* ------------------------------------------------------------ */
+
+#endif					// BUFPOOL_INCLUDED
+
+/************************************************************************/
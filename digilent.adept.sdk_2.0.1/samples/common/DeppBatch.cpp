@@ -0,0 +1,313 @@
+/************************************************************************/
+/*																		*/
+/*  DeppBatch.cpp  --  DEPP Register Access Batching					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DeppBatch class, which combines		*/
+/*		single register puts and gets into DeppPutRegSet and			*/
+/*		DeppGetRegSet calls. See DeppBatch.h for the ordering rules.	*/
+/*																		*/
+/*		Hazards are detected with one bit per register address for		*/
+/*		the queued puts and one for the queued gets. Addresses are		*/
+/*		masked to the bits the device decodes before they are			*/
+/*		compared, so that aliases of a register are detected as the		*/
+/*		same register.													*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "DeppBatch.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+#define	FTestBit(rgf, ib)	(((rgf)[(ib) >> 5] >> ((ib) & 31)) & 1)
+#define	SetBit(rgf, ib)		((rgf)[(ib) >> 5] |= (DWORD) 1 << ((ib) & 31))
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DeppBatch::DeppBatch
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The batch must be initialized with FInit before
+**		it is used.
+*/
+
+DeppBatch::DeppBatch() {
+
+	hif = hifInvalid;
+	cregLimit = cregBatchMax;
+	bAddrMask = 0xFF;
+	cput = 0;
+	cget = 0;
+	memset(rgfPut, 0, sizeof(rgfPut));
+	memset(rgfGet, 0, sizeof(rgfGet));
+	ResetStats();
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppBatch::FInit
+**
+**	Parameters:
+**		hifInit			- interface handle with DEPP enabled
+**		cregLimitInit	- number of puts or gets at which the batch is
+**						  issued, 0 for cregBatchMax
+**		bAddrMaskInit	- register address bits decoded by the device,
+**						  0x0F for the DpimRef design
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Binds the batch to an interface handle. Any queued accesses
+**		are discarded.
+*/
+
+BOOL DeppBatch::FInit(HIF hifInit, DWORD cregLimitInit, BYTE bAddrMaskInit) {
+
+	if (cregLimitInit == 0) {
+		cregLimitInit = cregBatchMax;
+	}
+
+	if ((hifInit == hifInvalid) || (cregLimitInit > cregBatchMax)) {
+		return fFalse;
+	}
+
+	hif = hifInit;
+	cregLimit = cregLimitInit;
+	bAddrMask = bAddrMaskInit;
+	cput = 0;
+	cget = 0;
+	memset(rgfPut, 0, sizeof(rgfPut));
+	memset(rgfGet, 0, sizeof(rgfGet));
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppBatch::FPutReg
+**
+**	Parameters:
+**		bAddr		- register address
+**		bData		- value to write
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		DEPP errors of the issued batch are available from
+**		DmgrGetLastError.
+**
+**	Description:
+**		Queues a write of bData to register bAddr. Puts to the same
+**		register are issued in the order they were queued.
+*/
+
+BOOL DeppBatch::FPutReg(BYTE bAddr, BYTE bData) {
+
+	BYTE	ib = bAddr & bAddrMask;
+
+	/* A put must not overtake a queued get of the same register.
+	*/
+	if (FTestBit(rgfGet, ib)) {
+		cflushHazard++;
+		if (!FIssue()) {
+			return fFalse;
+		}
+	}
+
+	rgbPut[2*cput] = bAddr;
+	rgbPut[2*cput+1] = bData;
+	cput++;
+	SetBit(rgfPut, ib);
+
+	if (cput >= cregLimit) {
+		cflushFull++;
+		return FIssue();
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppBatch::FGetReg
+**
+**	Parameters:
+**		bAddr		- register address
+**		pbData		- variable to receive the register value
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		DEPP errors of the issued batch are available from
+**		DmgrGetLastError.
+**
+**	Description:
+**		Queues a read of register bAddr. *pbData is written when the
+**		batch is issued, so it must remain valid until then.
+*/
+
+BOOL DeppBatch::FGetReg(BYTE bAddr, BYTE * pbData) {
+
+	BYTE	ib = bAddr & bAddrMask;
+
+	if (pbData == NULL) {
+		return fFalse;
+	}
+
+	/* A get must see the value of a queued put of the same register.
+	*/
+	if (FTestBit(rgfPut, ib)) {
+		cflushHazard++;
+		if (!FIssue()) {
+			return fFalse;
+		}
+	}
+
+	rgbGetAddr[cget] = bAddr;
+	rgpbGet[cget] = pbData;
+	cget++;
+	SetBit(rgfGet, ib);
+
+	if (cget >= cregLimit) {
+		cflushFull++;
+		return FIssue();
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppBatch::FFence
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		DEPP errors of the issued batch are available from
+**		DmgrGetLastError.
+**
+**	Description:
+**		Issues all queued accesses. When it returns, every queued put
+**		has been written and every queued get has stored its data.
+*/
+
+BOOL DeppBatch::FFence() {
+
+	if ((cput == 0) && (cget == 0)) {
+		return fTrue;
+	}
+
+	cflushFence++;
+
+	return FIssue();
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppBatch::ResetStats
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Clears the call and flush counters.
+*/
+
+void DeppBatch::ResetStats() {
+
+	ctrans = 0;
+	cflushFence = 0;
+	cflushHazard = 0;
+	cflushFull = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppBatch::FIssue
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Issues the queued puts with one DeppPutRegSet call and then
+**		the queued gets with one DeppGetRegSet call. The batch is
+**		emptied whether or not the calls succeed.
+*/
+
+BOOL DeppBatch::FIssue() {
+
+	DWORD	iget;
+	BOOL	fOk = fTrue;
+
+	if (cput > 0) {
+		// DEPP API Call: DeppPutRegSet
+		fOk = DeppPutRegSet(hif, rgbPut, cput, fFalse);
+		ctrans++;
+	}
+
+	if (fOk && (cget > 0)) {
+		// DEPP API Call: DeppGetRegSet
+		fOk = DeppGetRegSet(hif, rgbGetAddr, rgbGetData, cget, fFalse);
+		ctrans++;
+
+		if (fOk) {
+			for (iget = 0; iget < cget; iget++) {
+				*rgpbGet[iget] = rgbGetData[iget];
+			}
+		}
+	}
+
+	cput = 0;
+	cget = 0;
+	memset(rgfPut, 0, sizeof(rgfPut));
+	memset(rgfGet, 0, sizeof(rgfGet));
+
+	return fOk;
+}
+
+/************************************************************************/
@@ -0,0 +1,95 @@
+/************************************************************************/
+/*																		*/
+/*  DeppBatch.h  --  DEPP Register Access Batching Declarations			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DeppBatch object queues single register puts and gets and		*/
+/*		issues them as one DeppPutRegSet and one DeppGetRegSet call,	*/
+/*		so that a sequence of register accesses costs two USB round		*/
+/*		trips instead of one per register.								*/
+/*																		*/
+/*		Queued accesses are issued when FFence is called, when a get	*/
+/*		reads a register with a queued put or a put writes a register	*/
+/*		with a queued get, and when the batch is full. The data of a	*/
+/*		queued get is not valid until the batch has been issued.		*/
+/*																		*/
+/*		Within a batch all puts are issued before all gets. Accesses	*/
+/*		to different registers are assumed to be independent; if		*/
+/*		writing one register changes the value read from another,		*/
+/*		call FFence between them.										*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DEPPBATCH_INCLUDED)
+#define      DEPPBATCH_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Maximum number of puts and of gets held by a batch.
+*/
+const DWORD		cregBatchMax	= 256;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DeppBatch {
+
+private:
+	HIF		hif;
+	DWORD	cregLimit;				// puts or gets that fill the batch
+	BYTE	bAddrMask;				// address bits decoded by the device
+
+	DWORD	cput;
+	BYTE	rgbPut[2*cregBatchMax];	// address/data pairs
+	DWORD	cget;
+	BYTE	rgbGetAddr[cregBatchMax];
+	BYTE	rgbGetData[cregBatchMax];
+	BYTE *	rgpbGet[cregBatchMax];	// where to store each get
+
+	DWORD	rgfPut[256/32];			// bit set of addresses with a queued put
+	DWORD	rgfGet[256/32];			// bit set of addresses with a queued get
+
+	/* Statistics
+	*/
+	DWORD	ctrans;					// DEPP calls made
+	DWORD	cflushFence;
+	DWORD	cflushHazard;
+	DWORD	cflushFull;
+
+	BOOL	FIssue();
+
+public:
+	DeppBatch();
+
+	BOOL	FInit(HIF hifInit, DWORD cregLimitInit, BYTE bAddrMaskInit);
+	BOOL	FPutReg(BYTE bAddr, BYTE bData);
+	BOOL	FGetReg(BYTE bAddr, BYTE * pbData);
+	BOOL	FFence();
+
+	DWORD	CregPending() { return cput + cget; }
+	DWORD	CtransIssued() { return ctrans; }
+	DWORD	CflushFence() { return cflushFence; }
+	DWORD	CflushHazard() { return cflushHazard; }
+	DWORD	CflushFull() { return cflushFull; }
+	void	ResetStats();
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// DEPPBATCH_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,605 @@
+/************************************************************************/
+/*																		*/
+/*  DeppScan.cpp  --  DEPP Register Scan								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the ScanRing and DeppScan classes. See	*/
+/*		DeppScan.h for how they are used.								*/
+/*																		*/
+/*		The ring holds a power of two number of snapshots. The			*/
+/*		producer stores a snapshot and then publishes it by advancing	*/
+/*		ipush with release ordering; the consumer reads ipush with		*/
+/*		acquire ordering before it copies the snapshot out, and frees	*/
+/*		the slot by advancing ipop the same way. The indices wrap		*/
+/*		modulo 2^32, so their difference is the number of queued		*/
+/*		snapshots.														*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "DeppScan.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Largest number of snapshots held by a ring.
+*/
+const DWORD		csnapRingMax	= 1024 * 1024;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static double	DblScanTimeSec();
+static void		ScanSleepUntil(double dblTime);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	ScanRing::ScanRing
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The ring must be initialized with FInit before
+**		it is used.
+*/
+
+ScanRing::ScanRing() {
+
+	rgsnap = NULL;
+	csnapMask = 0;
+	ipush = 0;
+	ipop = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	ScanRing::FInit
+**
+**	Parameters:
+**		csnap		- minimum number of snapshots the ring holds
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates the ring, rounding its size up to a power of two.
+**		Must not be called while a producer or consumer uses the ring.
+*/
+
+BOOL ScanRing::FInit(DWORD csnap) {
+
+	DWORD	csnapRing;
+
+	if ((csnap == 0) || (csnap > csnapRingMax)) {
+		return fFalse;
+	}
+
+	for (csnapRing = 1; csnapRing < csnap; csnapRing *= 2);
+
+	Free();
+
+	rgsnap = (SCANSNAP *) malloc(csnapRing * sizeof(SCANSNAP));
+	if (rgsnap == NULL) {
+		return fFalse;
+	}
+
+	csnapMask = csnapRing - 1;
+	ipush = 0;
+	ipop = 0;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	ScanRing::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Frees the ring.
+*/
+
+void ScanRing::Free() {
+
+	if (rgsnap != NULL) {
+		free(rgsnap);
+		rgsnap = NULL;
+	}
+
+	csnapMask = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	ScanRing::FPush
+**
+**	Parameters:
+**		psnap		- snapshot to add
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the ring is full
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Adds a snapshot. Called only by the producer thread.
+*/
+
+BOOL ScanRing::FPush(const SCANSNAP * psnap) {
+
+	DWORD	ipushCur = ipush;
+	DWORD	ipopCur;
+
+	if (rgsnap == NULL) {
+		return fFalse;
+	}
+
+	ipopCur = __atomic_load_n(&ipop, __ATOMIC_ACQUIRE);
+	if (ipushCur - ipopCur > csnapMask) {
+		return fFalse;
+	}
+
+	memcpy(&rgsnap[ipushCur & csnapMask], psnap, sizeof(SCANSNAP));
+	__atomic_store_n(&ipush, ipushCur + 1, __ATOMIC_RELEASE);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	ScanRing::FPop
+**
+**	Parameters:
+**		psnap		- variable to receive the oldest snapshot
+**
+**	Return Value:
+**		fTrue if a snapshot was returned, fFalse if the ring is empty
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Removes the oldest snapshot. Called only by the consumer
+**		thread.
+*/
+
+BOOL ScanRing::FPop(SCANSNAP * psnap) {
+
+	DWORD	ipopCur = ipop;
+	DWORD	ipushCur;
+
+	if (rgsnap == NULL) {
+		return fFalse;
+	}
+
+	ipushCur = __atomic_load_n(&ipush, __ATOMIC_ACQUIRE);
+	if (ipushCur == ipopCur) {
+		return fFalse;
+	}
+
+	memcpy(psnap, &rgsnap[ipopCur & csnapMask], sizeof(SCANSNAP));
+	__atomic_store_n(&ipop, ipopCur + 1, __ATOMIC_RELEASE);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	ScanRing::CsnapQueued
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		number of snapshots in the ring
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The count may be out of date as soon as it is returned if the
+**		other thread is using the ring.
+*/
+
+DWORD ScanRing::CsnapQueued() {
+
+	return __atomic_load_n(&ipush, __ATOMIC_ACQUIRE) - __atomic_load_n(&ipop, __ATOMIC_ACQUIRE);
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::DeppScan
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The scan must be initialized with FInit before
+**		it is used.
+*/
+
+DeppScan::DeppScan() {
+
+	hif = hifInvalid;
+	creg = 0;
+	fDelta = fFalse;
+	fThread = fFalse;
+	fStop = fFalse;
+	fError = fFalse;
+	dblPeriod = 0;
+	cscanLimit = 0;
+	cscan = 0;
+	cpublish = 0;
+	cdrop = 0;
+	dblFirst = 0;
+	dblLatest = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::FInit
+**
+**	Parameters:
+**		hifInit		- interface handle with DEPP enabled
+**		rgbAddrInit	- addresses of the registers to scan
+**		cregInit	- number of registers, 1 to cregScanMax
+**		csnapRing	- number of snapshots the ring must hold
+**		fDeltaInit	- fTrue to publish only scans that changed
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Builds the address vector and allocates the ring. The
+**		statistics are cleared. Must not be called while the scan
+**		thread is running.
+*/
+
+BOOL DeppScan::FInit(HIF hifInit, const BYTE * rgbAddrInit, DWORD cregInit,
+					DWORD csnapRing, BOOL fDeltaInit) {
+
+	if ((hifInit == hifInvalid) || (rgbAddrInit == NULL) || (cregInit == 0) ||
+		(cregInit > cregScanMax) || fThread) {
+		return fFalse;
+	}
+
+	if (!ring.FInit(csnapRing)) {
+		return fFalse;
+	}
+
+	hif = hifInit;
+	creg = cregInit;
+	memcpy(rgbAddr, rgbAddrInit, creg);
+	memset(rgbLast, 0, sizeof(rgbLast));
+	fDelta = fDeltaInit;
+	fError = fFalse;
+	cscan = 0;
+	cpublish = 0;
+	cdrop = 0;
+	dblFirst = 0;
+	dblLatest = 0;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::FScan
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the DEPP call failed
+**
+**	Errors:
+**		The DEPP error is available from DmgrGetLastError.
+**
+**	Description:
+**		Reads all registers with one DeppGetRegSet call and publishes
+**		the snapshot, unless in delta mode nothing changed since the
+**		previous scan. A snapshot that does not fit in the ring is
+**		dropped. Must not be called while the scan thread is running.
+*/
+
+BOOL DeppScan::FScan() {
+
+	SCANSNAP	snap;
+
+	// DEPP API Call: DeppGetRegSet
+	if (!DeppGetRegSet(hif, rgbAddr, snap.rgbData, creg, fFalse)) {
+		fError = fTrue;
+		return fFalse;
+	}
+
+	snap.dblTime = DblScanTimeSec();
+	snap.iscan = cscan;
+	snap.creg = creg;
+
+	if (cscan == 0) {
+		dblFirst = snap.dblTime;
+	}
+	dblLatest = snap.dblTime;
+
+	if (!fDelta || (cscan == 0) || (memcmp(snap.rgbData, rgbLast, creg) != 0)) {
+		if (ring.FPush(&snap)) {
+			cpublish++;
+		}
+		else {
+			cdrop++;
+		}
+		memcpy(rgbLast, snap.rgbData, creg);
+	}
+
+	cscan++;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::FStart
+**
+**	Parameters:
+**		dblRateHz	- scans per second, 0 to scan as fast as possible
+**		cscanMax	- number of scans to make, 0 for no limit
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts a thread that scans at the given rate until Stop is
+**		called, cscanMax scans have been made or a DEPP call fails.
+**		Scans are timed from a fixed start, so a late scan does not
+**		delay the following ones; if the thread falls more than one
+**		period behind, the schedule restarts from the current time.
+*/
+
+BOOL DeppScan::FStart(double dblRateHz, DWORD cscanMax) {
+
+	if ((creg == 0) || fThread || (dblRateHz < 0)) {
+		return fFalse;
+	}
+
+	dblPeriod = (dblRateHz > 0) ? 1.0 / dblRateHz : 0;
+	cscanLimit = cscanMax;
+	fStop = fFalse;
+
+	if (pthread_create(&thrd, NULL, ScanThread, this) != 0) {
+		return fFalse;
+	}
+
+	fThread = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::Stop
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stops the scan thread and waits for it to exit. Snapshots in
+**		the ring can still be taken afterwards.
+*/
+
+void DeppScan::Stop() {
+
+	if (!fThread) {
+		return;
+	}
+
+	fStop = fTrue;
+	pthread_join(thrd, NULL);
+	fThread = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stops the scan thread if it is running and frees the ring.
+**		The scan must be initialized again before it is reused.
+*/
+
+void DeppScan::Free() {
+
+	Stop();
+	ring.Free();
+	creg = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::DblScanRate
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		scans per second, 0 if fewer than two scans have been made
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Rate measured between the completion of the first and the
+**		latest scan.
+*/
+
+double DeppScan::DblScanRate() {
+
+	if ((cscan < 2) || (dblLatest <= dblFirst)) {
+		return 0;
+	}
+
+	return (cscan - 1) / (dblLatest - dblFirst);
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppScan::ScanThread
+**
+**	Parameters:
+**		pvScan		- DeppScan object
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Body of the scan thread started by FStart.
+*/
+
+void * DeppScan::ScanThread(void * pvScan) {
+
+	DeppScan *	pscan = (DeppScan *) pvScan;
+	double		dblNext;
+	double		dblNow;
+
+	dblNext = DblScanTimeSec();
+
+	while (!pscan->fStop) {
+		if ((pscan->cscanLimit != 0) && (pscan->cscan >= pscan->cscanLimit)) {
+			break;
+		}
+
+		if (pscan->dblPeriod > 0) {
+			ScanSleepUntil(dblNext);
+			dblNow = DblScanTimeSec();
+			dblNext += pscan->dblPeriod;
+			if (dblNext < dblNow - pscan->dblPeriod) {
+				dblNext = dblNow + pscan->dblPeriod;
+			}
+		}
+
+		if (!pscan->FScan()) {
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblScanTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to timestamp and pace the scans.
+*/
+
+static double DblScanTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ScanSleepUntil
+**
+**	Parameters:
+**		dblTime		- monotonic time in seconds
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sleeps until the given time. Returns at once if it has passed.
+*/
+
+static void ScanSleepUntil(double dblTime) {
+
+	struct timespec	ts;
+
+	if (dblTime <= DblScanTimeSec()) {
+		return;
+	}
+
+	ts.tv_sec = (time_t) dblTime;
+	ts.tv_nsec = (long) ((dblTime - ts.tv_sec) * 1e9);
+	if (ts.tv_nsec >= 1000000000L) {
+		ts.tv_sec += 1;
+		ts.tv_nsec -= 1000000000L;
+	}
+
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+/************************************************************************/
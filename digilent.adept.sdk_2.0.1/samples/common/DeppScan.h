@@ -0,0 +1,148 @@
+/************************************************************************/
+/*																		*/
+/*  DeppScan.h  --  DEPP Register Scan Declarations						*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DeppScan object polls a fixed set of registers with one		*/
+/*		DeppGetRegSet call per scan instead of one DeppGetReg call		*/
+/*		per register. Each scan is timestamped and published as a		*/
+/*		snapshot into a ScanRing, a single producer single consumer		*/
+/*		ring that needs no lock, from which another thread takes the	*/
+/*		snapshots. In delta mode a snapshot is published only when a	*/
+/*		register differs from the previous scan.						*/
+/*																		*/
+/*		The scan runs either on the caller's thread (FScan) or on a		*/
+/*		thread of its own (FStart/Stop). Only one thread may take		*/
+/*		snapshots from the ring. The ring never blocks the scan: when	*/
+/*		it is full the new snapshot is dropped and counted. Call Free	*/
+/*		when done to stop the thread and release the ring.				*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DEPPSCAN_INCLUDED)
+#define      DEPPSCAN_INCLUDED
+
+#include <pthread.h>
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Maximum number of registers in a scan.
+*/
+const DWORD		cregScanMax		= 64;
+
+/* Assumed cache line size, used to keep the producer and consumer
+** indices of a ring from sharing a line.
+*/
+const int		cbCacheLine		= 64;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* One scan of the register set.
+*/
+typedef struct tagSCANSNAP {
+	double	dblTime;				// monotonic seconds at completion
+	DWORD	iscan;					// number of the scan, from 0
+	DWORD	creg;
+	BYTE	rgbData[cregScanMax];	// in the order of the address vector
+} SCANSNAP;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class ScanRing {
+
+private:
+	SCANSNAP *	rgsnap;
+	DWORD		csnapMask;			// capacity - 1, capacity a power of 2
+
+	/* ipush is only written by the producer and ipop only by the
+	** consumer. Both count snapshots since the ring was created.
+	*/
+	char		rgbPad0[cbCacheLine];
+	DWORD		ipush;
+	char		rgbPad1[cbCacheLine - sizeof(DWORD)];
+	DWORD		ipop;
+	char		rgbPad2[cbCacheLine - sizeof(DWORD)];
+
+public:
+	ScanRing();
+
+	BOOL	FInit(DWORD csnap);
+	void	Free();
+	BOOL	FPush(const SCANSNAP * psnap);
+	BOOL	FPop(SCANSNAP * psnap);
+	DWORD	CsnapQueued();
+};
+
+class DeppScan {
+
+private:
+	HIF			hif;
+	DWORD		creg;
+	BYTE		rgbAddr[cregScanMax];
+	BYTE		rgbLast[cregScanMax];
+	BOOL		fDelta;
+
+	ScanRing	ring;
+
+	/* Scan thread
+	*/
+	pthread_t	thrd;
+	BOOL		fThread;
+	volatile BOOL	fStop;
+	volatile BOOL	fError;
+	double		dblPeriod;			// seconds between scans, 0 for no wait
+	DWORD		cscanLimit;			// scans made by the thread, 0 for no limit
+
+	/* Statistics, written only by the scanning thread
+	*/
+	volatile DWORD	cscan;
+	volatile DWORD	cpublish;
+	volatile DWORD	cdrop;
+	double		dblFirst;
+	double		dblLatest;
+
+	static void *	ScanThread(void * pvScan);
+
+public:
+	DeppScan();
+
+	BOOL	FInit(HIF hifInit, const BYTE * rgbAddrInit, DWORD cregInit,
+				DWORD csnapRing, BOOL fDeltaInit);
+	BOOL	FScan();
+	BOOL	FStart(double dblRateHz, DWORD cscanMax);
+	void	Stop();
+	void	Free();
+	BOOL	FRunning()		{ return fThread && !fStop && !fError &&
+								((cscanLimit == 0) || (cscan < cscanLimit)); }
+
+	BOOL	FPop(SCANSNAP * psnap)	{ return ring.FPop(psnap); }
+
+	BOOL	FError()		{ return fError; }
+	DWORD	Cscan()			{ return cscan; }
+	DWORD	Cpublish()		{ return cpublish; }
+	DWORD	Cdrop()			{ return cdrop; }
+	double	DblScanRate();
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// DEPPSCAN_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,657 @@
+/************************************************************************/
+/*																		*/
+/*  DeppShadow.cpp  --  DEPP Shadow Register Cache						*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the shadow register cache declared in	*/
+/*		DeppShadow.h. The cache of each interface handle holds one		*/
+/*		entry per register address after masking with the address		*/
+/*		bits decoded by the device, so that aliases of a register		*/
+/*		share an entry.													*/
+/*																		*/
+/*		The table of caches is protected by a mutex, which is not		*/
+/*		held during DEPP calls so that transfers to different devices	*/
+/*		are not serialized.												*/
+/*																		*/
+/*		Overlapped transfers complete after the call returns, so an		*/
+/*		overlapped read always goes to the device and an overlapped		*/
+/*		write invalidates the entry instead of updating it. A failed	*/
+/*		write also invalidates the entry, as the register may or may	*/
+/*		not have been written.											*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "DeppShadow.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+const int	cshregMax	= 256;
+
+/* DpimRef design registers.
+*/
+const BYTE	cregDpimRefData	= 8;		// registers 0-7 are read/write
+const BYTE	bAddrMaskDpimRef = 0x0F;
+
+typedef struct tagSHREG {
+	BYTE	shpol;
+	BYTE	fValid;
+	BYTE	bData;
+} SHREG;
+
+typedef struct tagSHDVC {
+	HIF		hif;					// hifInvalid if the slot is free
+	BYTE	bAddrMask;
+	SHSTATS	shstats;
+	SHREG	rgshreg[cshregMax];
+} SHDVC;
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_mutex_t	mtxShadow = PTHREAD_MUTEX_INITIALIZER;
+static SHDVC			rgshdvc[cshdvcMax];
+static BOOL				fShadowInit = fFalse;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static SHDVC *	PshdvcFind(HIF hif);
+static void		ShadowUpdate(HIF hif, BYTE bAddr, BYTE bData, BOOL fValid);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DeppShadowEnable
+**
+**	Parameters:
+**		hif			- interface handle with DEPP enabled
+**		bAddrMask	- register address bits decoded by the device,
+**					  0x0F for the DpimRef design
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Enables the shadow cache for an interface handle. All
+**		registers are volatile and the statistics are cleared. If
+**		the cache is already enabled it is reset.
+*/
+
+BOOL DeppShadowEnable(HIF hif, BYTE bAddrMask) {
+
+	SHDVC *	pshdvc;
+	int		ishdvc;
+
+	if (hif == hifInvalid) {
+		return fFalse;
+	}
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	for (ishdvc = 0; (pshdvc == NULL) && (ishdvc < cshdvcMax); ishdvc++) {
+		if (rgshdvc[ishdvc].hif == hifInvalid) {
+			pshdvc = &rgshdvc[ishdvc];
+		}
+	}
+
+	if (pshdvc != NULL) {
+		memset(pshdvc, 0, sizeof(SHDVC));
+		pshdvc->hif = hif;
+		pshdvc->bAddrMask = bAddrMask;
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	return pshdvc != NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowDisable
+**
+**	Parameters:
+**		hif			- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the cache was not enabled
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables the shadow cache for an interface handle. This must
+**		be called before the handle is closed.
+*/
+
+BOOL DeppShadowDisable(HIF hif) {
+
+	SHDVC *	pshdvc;
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		pshdvc->hif = hifInvalid;
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	return pshdvc != NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowSetPolicy
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		shpol		- cache policy of the register
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the cache policy of a register and invalidates its entry.
+*/
+
+BOOL DeppShadowSetPolicy(HIF hif, BYTE bAddr, SHPOL shpol) {
+
+	SHDVC *	pshdvc;
+	SHREG *	pshreg;
+
+	if ((shpol != shpolVolatile) && (shpol != shpolWriteThrough)) {
+		return fFalse;
+	}
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		pshreg = &pshdvc->rgshreg[bAddr & pshdvc->bAddrMask];
+		pshreg->shpol = (BYTE) shpol;
+		pshreg->fValid = fFalse;
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	return pshdvc != NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowSetDpimRef
+**
+**	Parameters:
+**		hif			- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Enables the cache with the register policies of the DpimRef
+**		design: data registers 0-7 are write-through, the switch and
+**		button registers are volatile, and the LED register is
+**		volatile because it reads back as 0 rather than the value
+**		written.
+*/
+
+BOOL DeppShadowSetDpimRef(HIF hif) {
+
+	BYTE	bAddr;
+
+	if (!DeppShadowEnable(hif, bAddrMaskDpimRef)) {
+		return fFalse;
+	}
+
+	for (bAddr = 0; bAddr < cregDpimRefData; bAddr++) {
+		DeppShadowSetPolicy(hif, bAddr, shpolWriteThrough);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowInvalidate
+**
+**	Parameters:
+**		hif			- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the cache is not enabled
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Discards all cached values, for example after the device has
+**		been reconfigured. Policies are kept.
+*/
+
+BOOL DeppShadowInvalidate(HIF hif) {
+
+	SHDVC *	pshdvc;
+	int		ishreg;
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		for (ishreg = 0; ishreg < cshregMax; ishreg++) {
+			pshdvc->rgshreg[ishreg].fValid = fFalse;
+		}
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	return pshdvc != NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowPutReg
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		bData		- value to write
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Same as DeppPutReg
+**
+**	Description:
+**		Writes a register with DeppPutReg and records the value in
+**		the cache. Works like DeppPutReg if the cache is not enabled.
+*/
+
+BOOL DeppShadowPutReg(HIF hif, BYTE bAddr, BYTE bData, BOOL fOverlap) {
+
+	BOOL	fOk;
+
+	// DEPP API Call: DeppPutReg
+	fOk = DeppPutReg(hif, bAddr, bData, fOverlap);
+
+	ShadowUpdate(hif, bAddr, bData, fOk && !fOverlap);
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowGetReg
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		pbData		- variable to receive the register value
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Same as DeppGetReg
+**
+**	Description:
+**		Returns the cached value of a write-through register, or
+**		reads the register with DeppGetReg. Works like DeppGetReg if
+**		the cache is not enabled.
+*/
+
+BOOL DeppShadowGetReg(HIF hif, BYTE bAddr, BYTE * pbData, BOOL fOverlap) {
+
+	SHDVC *	pshdvc;
+	SHREG *	pshreg;
+	BOOL	fFill;
+	BOOL	fOk;
+
+	fFill = fFalse;
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		pshreg = &pshdvc->rgshreg[bAddr & pshdvc->bAddrMask];
+
+		if ((pshreg->shpol == shpolVolatile) || fOverlap) {
+			pshdvc->shstats.cbypass++;
+		}
+		else if (pshreg->fValid && (pbData != NULL)) {
+			pshdvc->shstats.chit++;
+			*pbData = pshreg->bData;
+			pthread_mutex_unlock(&mtxShadow);
+			return fTrue;
+		}
+		else {
+			pshdvc->shstats.cmiss++;
+			fFill = fTrue;
+		}
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	// DEPP API Call: DeppGetReg
+	fOk = DeppGetReg(hif, bAddr, pbData, fOverlap);
+
+	if (fOk && fFill) {
+		ShadowUpdate(hif, bAddr, *pbData, fTrue);
+	}
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowPutRegSet
+**
+**	Parameters:
+**		hif				- interface handle
+**		pbAddrData		- buffer of register address/data pairs
+**		nAddrDataPairs	- number of pairs in pbAddrData
+**		fOverlap		- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Same as DeppPutRegSet
+**
+**	Description:
+**		Writes a set of registers with DeppPutRegSet and records the
+**		values in the cache.
+*/
+
+BOOL DeppShadowPutRegSet(HIF hif, BYTE * pbAddrData, DWORD nAddrDataPairs, BOOL fOverlap) {
+
+	DWORD	ipair;
+	BOOL	fOk;
+
+	// DEPP API Call: DeppPutRegSet
+	fOk = DeppPutRegSet(hif, pbAddrData, nAddrDataPairs, fOverlap);
+
+	if (pbAddrData != NULL) {
+		for (ipair = 0; ipair < nAddrDataPairs; ipair++) {
+			ShadowUpdate(hif, pbAddrData[2*ipair], pbAddrData[2*ipair+1], fOk && !fOverlap);
+		}
+	}
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowGetRegSet
+**
+**	Parameters:
+**		hif			- interface handle
+**		pbAddr		- buffer of register addresses
+**		pbData		- buffer to receive the data bytes
+**		cbData		- number of registers to read
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Same as DeppGetRegSet
+**
+**	Description:
+**		If every register in the set is cached the set is served from
+**		the cache. Otherwise the whole set is read with one
+**		DeppGetRegSet call, since reading the cached registers as well
+**		costs no extra round trip, and the write-through registers
+**		are counted as misses.
+*/
+
+BOOL DeppShadowGetRegSet(HIF hif, BYTE * pbAddr, BYTE * pbData, DWORD cbData, BOOL fOverlap) {
+
+	SHDVC *	pshdvc;
+	SHREG *	pshreg;
+	DWORD	ib;
+	DWORD	cwt;
+	BOOL	fHit;
+	BOOL	fOk;
+
+	cwt = 0;
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if ((pshdvc != NULL) && (pbAddr != NULL) && (pbData != NULL)) {
+		fHit = !fOverlap;
+		for (ib = 0; ib < cbData; ib++) {
+			pshreg = &pshdvc->rgshreg[pbAddr[ib] & pshdvc->bAddrMask];
+			if (pshreg->shpol == shpolWriteThrough) {
+				cwt++;
+			}
+			if ((pshreg->shpol == shpolVolatile) || !pshreg->fValid) {
+				fHit = fFalse;
+			}
+		}
+
+		if (fHit) {
+			for (ib = 0; ib < cbData; ib++) {
+				pbData[ib] = pshdvc->rgshreg[pbAddr[ib] & pshdvc->bAddrMask].bData;
+			}
+			pshdvc->shstats.chit += cbData;
+			pthread_mutex_unlock(&mtxShadow);
+			return fTrue;
+		}
+
+		if (fOverlap) {
+			pshdvc->shstats.cbypass += cbData;
+			cwt = 0;
+		}
+		else {
+			pshdvc->shstats.cmiss += cwt;
+			pshdvc->shstats.cbypass += cbData - cwt;
+		}
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	// DEPP API Call: DeppGetRegSet
+	fOk = DeppGetRegSet(hif, pbAddr, pbData, cbData, fOverlap);
+
+	if (fOk && (cwt > 0)) {
+		pthread_mutex_lock(&mtxShadow);
+
+		pshdvc = PshdvcFind(hif);
+		if (pshdvc != NULL) {
+			for (ib = 0; ib < cbData; ib++) {
+				pshreg = &pshdvc->rgshreg[pbAddr[ib] & pshdvc->bAddrMask];
+				if (pshreg->shpol == shpolWriteThrough) {
+					pshreg->bData = pbData[ib];
+					pshreg->fValid = fTrue;
+				}
+			}
+		}
+
+		pthread_mutex_unlock(&mtxShadow);
+	}
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowGetStats
+**
+**	Parameters:
+**		hif			- interface handle
+**		pshstats	- variable to receive the statistics
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the cache is not enabled
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the cache statistics of an interface handle.
+*/
+
+BOOL DeppShadowGetStats(HIF hif, SHSTATS * pshstats) {
+
+	SHDVC *	pshdvc;
+
+	if (pshstats == NULL) {
+		return fFalse;
+	}
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		*pshstats = pshdvc->shstats;
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	return pshdvc != NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppShadowResetStats
+**
+**	Parameters:
+**		hif			- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the cache is not enabled
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Clears the cache statistics of an interface handle.
+*/
+
+BOOL DeppShadowResetStats(HIF hif) {
+
+	SHDVC *	pshdvc;
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		memset(&pshdvc->shstats, 0, sizeof(SHSTATS));
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+
+	return pshdvc != NULL;
+}
+
+/* ------------------------------------------------------------ */
+/*					Local Procedure Definitions					*/
+/* ------------------------------------------------------------ */
+/***	PshdvcFind
+**
+**	Parameters:
+**		hif			- interface handle
+**
+**	Return Value:
+**		pointer to the cache of the interface handle, NULL if the
+**		cache is not enabled
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Must be called with mtxShadow held.
+*/
+
+static SHDVC * PshdvcFind(HIF hif) {
+
+	int		ishdvc;
+
+	if (!fShadowInit) {
+		for (ishdvc = 0; ishdvc < cshdvcMax; ishdvc++) {
+			rgshdvc[ishdvc].hif = hifInvalid;
+		}
+		fShadowInit = fTrue;
+	}
+
+	if (hif == hifInvalid) {
+		return NULL;
+	}
+
+	for (ishdvc = 0; ishdvc < cshdvcMax; ishdvc++) {
+		if (rgshdvc[ishdvc].hif == hif) {
+			return &rgshdvc[ishdvc];
+		}
+	}
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShadowUpdate
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		bData		- value written to the register
+**		fValid		- fTrue if the register is known to hold bData
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records a register write. The write is counted and, for a
+**		write-through register, the entry is updated or invalidated.
+*/
+
+static void ShadowUpdate(HIF hif, BYTE bAddr, BYTE bData, BOOL fValid) {
+
+	SHDVC *	pshdvc;
+	SHREG *	pshreg;
+
+	pthread_mutex_lock(&mtxShadow);
+
+	pshdvc = PshdvcFind(hif);
+	if (pshdvc != NULL) {
+		pshdvc->shstats.cput++;
+		pshreg = &pshdvc->rgshreg[bAddr & pshdvc->bAddrMask];
+		if (pshreg->shpol == shpolWriteThrough) {
+			pshreg->bData = bData;
+			pshreg->fValid = (BYTE) fValid;
+		}
+	}
+
+	pthread_mutex_unlock(&mtxShadow);
+}
+
+/************************************************************************/
@@ -0,0 +1,87 @@
+/************************************************************************/
+/*																		*/
+/*  DeppShadow.h  --  DEPP Shadow Register Cache Declarations			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		The shadow register cache keeps a host copy of the registers	*/
+/*		of a DEPP interface so that reads of values the host wrote		*/
+/*		itself do not cost a USB round trip. It is enabled per			*/
+/*		interface handle, and each register address has a policy:		*/
+/*																		*/
+/*			shpolVolatile		- the register can change on its own	*/
+/*								  (switches, status); every read goes	*/
+/*								  to the device							*/
+/*			shpolWriteThrough	- the register only changes when the	*/
+/*								  host writes it; writes go to the		*/
+/*								  device and update the cache, reads	*/
+/*								  are served from the cache once it		*/
+/*								  holds the value						*/
+/*																		*/
+/*		All registers are volatile until a policy is set, so enabling	*/
+/*		the cache alone does not change what the host reads.			*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DEPPSHADOW_INCLUDED)
+#define      DEPPSHADOW_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Maximum number of interface handles with the cache enabled.
+*/
+const int	cshdvcMax	= 16;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+typedef enum {
+	shpolVolatile = 0,
+	shpolWriteThrough
+} SHPOL;
+
+/* Cache statistics for one interface handle.
+*/
+typedef struct tagSHSTATS {
+	DWORD	chit;			// reads served from the cache
+	DWORD	cmiss;			// reads of write-through registers not cached
+	DWORD	cbypass;		// reads of volatile registers or overlapped reads
+	DWORD	cput;			// registers written
+} SHSTATS;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	DeppShadowEnable(HIF hif, BYTE bAddrMask);
+BOOL	DeppShadowDisable(HIF hif);
+BOOL	DeppShadowSetPolicy(HIF hif, BYTE bAddr, SHPOL shpol);
+BOOL	DeppShadowSetDpimRef(HIF hif);
+BOOL	DeppShadowInvalidate(HIF hif);
+
+BOOL	DeppShadowPutReg(HIF hif, BYTE bAddr, BYTE bData, BOOL fOverlap);
+BOOL	DeppShadowGetReg(HIF hif, BYTE bAddr, BYTE * pbData, BOOL fOverlap);
+BOOL	DeppShadowPutRegSet(HIF hif, BYTE * pbAddrData, DWORD nAddrDataPairs, BOOL fOverlap);
+BOOL	DeppShadowGetRegSet(HIF hif, BYTE * pbAddr, BYTE * pbData, DWORD cbData, BOOL fOverlap);
+
+BOOL	DeppShadowGetStats(HIF hif, SHSTATS * pshstats);
+BOOL	DeppShadowResetStats(HIF hif);
+
+/* ------------------------------------------------------------ */
+
+#endif					// DEPPSHADOW_INCLUDED
+
+/************************************************************************/
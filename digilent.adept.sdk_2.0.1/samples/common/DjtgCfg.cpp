@@ -0,0 +1,899 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgCfg.cpp  --  Xilinx FPGA Configuration Engine					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Configures a Xilinx FPGA from a .bit file, streaming the		*/
+/*		bitstream with overlapped DjtgPutTdiBits calls. See				*/
+/*		DjtgCfg.h.														*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: bits reversed with JtgBits								*/
+/*	10/17/2026: part checked up to the package							*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "djtg.h"
+#include "DjtgCfg.h"
+#include "JtgBits.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* A .bit file starts with a field of 9 bytes, then the length of the
+** key of the first text field, 1.
+*/
+static const BYTE	rgbBitMagic[] = {
+	0x00, 0x09, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01
+};
+
+/* Bytes of the file read to find the header.
+*/
+const DWORD		cbBitHdrMax		= 4096;
+
+static const char *	rgszErrCfg[cerrCfg] = {
+	"no error",
+	"the file cannot be opened",
+	"the file is not a .bit file",
+	"the file is shorter than its header says",
+	"the device is not a known FPGA",
+	"the family of the device has no CFG_IN or JSTART command",
+	"the instruction register length differs from the chain",
+	"the file is for another part",
+	"a DJTG call failed",
+	"out of memory",
+	"not initialized or no file open"
+};
+
+/* Package codes of Xilinx parts, as the part name of a .bit file
+** gives them after the device: 3s500e and fg320. A g after the code
+** marks a lead free package.
+*/
+static const char *	rgszCfgPkg[] = {
+	"bf", "bg", "cb", "cl", "cp", "cs", "fb", "ff", "fg", "fh", "fl", "fs",
+	"ft", "fv", "hq", "pc", "pq", "rb", "rf", "rs", "sb", "sf", "tq", "vq"
+};
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static BOOL		FCfgPartRest(const char * szRest);
+static double	DblCfgTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::DjtgCfg
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The engine must be initialized with FInit before
+**		it is used.
+*/
+
+DjtgCfg::DjtgCfg() {
+
+	hif = hifInvalid;
+	pseq = NULL;
+	fInit = fFalse;
+	fcfg = 0;
+	cbChunk = 0;
+	rgpbBuf[0] = NULL;
+	rgpbBuf[1] = NULL;
+	cbBufAlloc = 0;
+	fpBit = NULL;
+	memset(&hdr, 0, sizeof(hdr));
+	errLast = errCfgNone;
+	memset(&stat, 0, sizeof(stat));
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FInit
+**
+**	Parameters:
+**		hifInit		- open interface handle with DJTG enabled
+**		pseqInit	- sequence of the same handle, used for the
+**					  instruction scans
+**		cbChunkInit	- bytes of bitstream per DjtgPutTdiBits call, 0
+**					  for cbCfgChunkDefault
+**		fcfgInit	- options, fcfgNoOverlap and fcfgNoPartCheck
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		errCfgMem
+**
+**	Description:
+**		Allocates the two chunk buffers.
+*/
+
+BOOL DjtgCfg::FInit(HIF hifInit, DjtgSeq * pseqInit, DWORD cbChunkInit, DWORD fcfgInit) {
+
+	if (fInit || (pseqInit == NULL)) {
+		return FFail(errCfgState);
+	}
+
+	if (cbChunkInit == 0) {
+		cbChunkInit = cbCfgChunkDefault;
+	}
+	if (cbChunkInit < cbCfgChunkMin) {
+		cbChunkInit = cbCfgChunkMin;
+	}
+	if (cbChunkInit > cbCfgChunkMax) {
+		cbChunkInit = cbCfgChunkMax;
+	}
+
+	hif = hifInit;
+	pseq = pseqInit;
+	fcfg = fcfgInit;
+	cbChunk = cbChunkInit;
+	errLast = errCfgNone;
+
+	fInit = fTrue;
+
+	if (!FAllocBuf(0)) {
+		Free();
+		return FFail(errCfgMem);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FOpen
+**
+**	Parameters:
+**		szBit		- path of the .bit file
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		errCfgState, errCfgOpen, errCfgHeader
+**
+**	Description:
+**		Opens a .bit file and reads its header. A file already open
+**		is closed.
+*/
+
+BOOL DjtgCfg::FOpen(const char * szBit) {
+
+	BYTE	rgbHdr[cbBitHdrMax];
+	DWORD	cbHdr;
+
+	if (!fInit) {
+		return FFail(errCfgState);
+	}
+
+	Close();
+
+	fpBit = fopen(szBit, "rb");
+	if (fpBit == NULL) {
+		return FFail(errCfgOpen);
+	}
+
+	cbHdr = (DWORD) fread(rgbHdr, 1, sizeof(rgbHdr), fpBit);
+	if (!FBitParseHeader(rgbHdr, cbHdr, &hdr)) {
+		Close();
+		return FFail(errCfgHeader);
+	}
+
+	errLast = errCfgNone;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FProgram
+**
+**	Parameters:
+**		pchain		- chain found by FDjtgChainScan
+**		idvc		- device to configure, 0 next to TDI
+**		pjsc		- index of the device list
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		errCfgState, errCfgDevice, errCfgCommand, errCfgIrLen,
+**		errCfgPart, errCfgRead, errCfgJtag, errCfgMem
+**
+**	Description:
+**		Configures the device with the bitstream of the open file.
+**		The other devices of the chain are put in BYPASS. The
+**		bitstream is followed by a zero for each device between TDI
+**		and the device, which pushes its last bits through their
+**		BYPASS registers. The chain is left in Test-Logic-Reset.
+*/
+
+BOOL DjtgCfg::FProgram(const JTGCHAIN * pchain, DWORD idvc, JtscIndex * pjsc) {
+
+	SEQSTAT	statStart;
+	SEQSTAT	statEnd;
+	DWORD	ifam;
+	DWORD	cbitIr;
+	DWORD	cclkClear;
+	DWORD	dwOpcode;
+	double	dblStart;
+	BOOL	fOk;
+
+	if (!fInit || (fpBit == NULL)) {
+		return FFail(errCfgState);
+	}
+
+	memset(&stat, 0, sizeof(stat));
+	stat.erc = ercNoErc;
+	errLast = errCfgNone;
+
+	if (!FCheckDevice(pchain, idvc, pjsc, &ifam, &cbitIr)) {
+		return fFalse;
+	}
+
+	if (!FDjtgChainSetPad(pseq, pchain, idvc)) {
+		return FFail(errCfgIrLen);
+	}
+
+	if (!FAllocBuf(idvc)) {
+		return FFail(errCfgMem);
+	}
+
+	if (fseek(fpBit, hdr.ibData, SEEK_SET) != 0) {
+		return FFail(errCfgRead);
+	}
+
+	// DJTG API Call: DjtgGetSpeed
+	if (!DjtgGetSpeed(hif, &stat.frqTck) || (stat.frqTck == 0)) {
+		stat.erc = DmgrGetLastError();
+		return FFail(errCfgJtag);
+	}
+
+	cclkClear = (DWORD) (stat.frqTck * dblCfgClearSec);
+	if (cclkClear < cclkCfgClearMin) {
+		cclkClear = cclkCfgClearMin;
+	}
+
+	pseq->GetStat(&statStart);
+	dblStart = DblCfgTimeSec();
+
+	/* Clear the configuration if the family can, select the
+	** configuration register and stop in Shift-DR.
+	*/
+	fOk = pseq->FReset();
+	if (fOk && pjsc->FGetCommand(ifam, "JPROGRAM", &dwOpcode)) {
+		fOk = FScanCommand(pjsc, ifam, cbitIr, "JPROGRAM") &&
+			pseq->FIdle(cclkClear);
+	}
+	fOk = fOk && FScanCommand(pjsc, ifam, cbitIr, "CFG_IN") &&
+		pseq->FMove(stJtgShfDr) && pseq->FExecute();
+
+	/* The bitstream leaves the chain in Exit1-DR. JSTART then runs
+	** the start-up sequence on the clocks given in Run-Test/Idle.
+	*/
+	if (fOk) {
+		if (!FStream(idvc)) {
+			pseq->FSetState(stJtgUnknown);
+			return fFalse;
+		}
+		fOk = pseq->FSetState(stJtgEx1Dr) &&
+			FScanCommand(pjsc, ifam, cbitIr, "JSTART") &&
+			pseq->FIdle(cclkCfgStartup) && pseq->FReset() && pseq->FExecute();
+	}
+
+	stat.dblSec = DblCfgTimeSec() - dblStart;
+	pseq->GetStat(&statEnd);
+	stat.ccall += statEnd.ccall - statStart.ccall;
+
+	if (!fOk) {
+		stat.erc = DmgrGetLastError();
+		return FFail(errCfgJtag);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::Close
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Closes the open .bit file, if any.
+*/
+
+void DjtgCfg::Close() {
+
+	if (fpBit != NULL) {
+		fclose(fpBit);
+		fpBit = NULL;
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Closes the file and frees the buffers.
+*/
+
+void DjtgCfg::Free() {
+
+	Close();
+
+	free(rgpbBuf[0]);
+	free(rgpbBuf[1]);
+	rgpbBuf[0] = NULL;
+	rgpbBuf[1] = NULL;
+	cbBufAlloc = 0;
+
+	pseq = NULL;
+	hif = hifInvalid;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::GetStat
+**
+**	Parameters:
+**		pstat		- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the statistics of the last FProgram, as far as it
+**		went if it failed.
+*/
+
+void DjtgCfg::GetStat(CFGSTAT * pstat) {
+
+	*pstat = stat;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::SzErr
+**
+**	Parameters:
+**		err			- value returned by ErrLast
+**
+**	Return Value:
+**		description of the error
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to report why a configuration failed.
+*/
+
+const char * DjtgCfg::SzErr(int err) {
+
+	if ((err < 0) || (err >= cerrCfg)) {
+		return "unknown error";
+	}
+
+	return rgszErrCfg[err];
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FFail
+**
+**	Parameters:
+**		err			- reason of the failure
+**
+**	Return Value:
+**		fFalse
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the reason returned by ErrLast.
+*/
+
+BOOL DjtgCfg::FFail(int err) {
+
+	errLast = err;
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FCheckDevice
+**
+**	Parameters:
+**		pchain		- chain found by FDjtgChainScan
+**		idvc		- device to configure
+**		pjsc		- index of the device list
+**		pifam		- variable to receive the family of the device
+**		pcbitIr		- variable to receive its instruction length
+**
+**	Return Value:
+**		fTrue if the device can be configured, fFalse if not
+**
+**	Errors:
+**		errCfgDevice, errCfgCommand, errCfgIrLen, errCfgPart
+**
+**	Description:
+**		Identifies the device and checks that its family is an FPGA
+**		family with the commands needed, that its instruction
+**		register length agrees with the chain, and unless
+**		fcfgNoPartCheck was given, that the part of the file is the
+**		device: XC3S500E matches the part 3s500efg320, but XC3S500
+**		does not, as the device must be followed by the package or
+**		the end of the part. When only the family of the device is
+**		known the part is not checked.
+*/
+
+BOOL DjtgCfg::FCheckDevice(const JTGCHAIN * pchain, DWORD idvc, JtscIndex * pjsc,
+				DWORD * pifam, DWORD * pcbitIr) {
+
+	JSCID			id;
+	const char *	szDvc;
+	DWORD			dwOpcode;
+
+	if ((idvc >= pchain->cdvc) || (pchain->rgdvc[idvc].idcode == 0)) {
+		return FFail(errCfgDevice);
+	}
+
+	if (!pjsc->FIdentify(pchain->rgdvc[idvc].idcode, &id) || (id.ifam == ijscNone) ||
+		(id.szType == NULL) || (strcmp(id.szType, "FPGA") != 0) ||
+		(id.cbitIr == 0) || (id.cbitIr > 32)) {
+		return FFail(errCfgDevice);
+	}
+
+	if (!pjsc->FGetCommand(id.ifam, "CFG_IN", &dwOpcode) ||
+		!pjsc->FGetCommand(id.ifam, "JSTART", &dwOpcode)) {
+		return FFail(errCfgCommand);
+	}
+
+	if (!pchain->fIrKnown || (pchain->rgdvc[idvc].cbitIr != id.cbitIr)) {
+		return FFail(errCfgIrLen);
+	}
+
+	if (((fcfg & fcfgNoPartCheck) == 0) && (id.szDevice != NULL)) {
+		szDvc = id.szDevice;
+		if (strncasecmp(szDvc, "XC", 2) == 0) {
+			szDvc += 2;
+		}
+		if ((strncasecmp(szDvc, hdr.szPart, strlen(szDvc)) != 0) ||
+			!FCfgPartRest(hdr.szPart + strlen(szDvc))) {
+			return FFail(errCfgPart);
+		}
+	}
+
+	*pifam = id.ifam;
+	*pcbitIr = id.cbitIr;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FScanCommand
+**
+**	Parameters:
+**		pjsc		- index of the device list
+**		ifam		- family of the device
+**		cbitIr		- its instruction register length
+**		szCmd		- command of the family to load
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		errCfgCommand
+**
+**	Description:
+**		Records an instruction scan of the command.
+*/
+
+BOOL DjtgCfg::FScanCommand(JtscIndex * pjsc, DWORD ifam, DWORD cbitIr, const char * szCmd) {
+
+	BYTE	rgbOpcode[4];
+	DWORD	dwOpcode;
+
+	if (!pjsc->FGetCommand(ifam, szCmd, &dwOpcode)) {
+		return FFail(errCfgCommand);
+	}
+
+	rgbOpcode[0] = (BYTE) dwOpcode;
+	rgbOpcode[1] = (BYTE) (dwOpcode >> 8);
+	rgbOpcode[2] = (BYTE) (dwOpcode >> 16);
+	rgbOpcode[3] = (BYTE) (dwOpcode >> 24);
+
+	return pseq->FScanIr(rgbOpcode, cbitIr, NULL);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FAllocBuf
+**
+**	Parameters:
+**		cbitPad		- bits that may follow the last chunk
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the chunk buffers large enough for a chunk and the pad
+**		of the chain.
+*/
+
+BOOL DjtgCfg::FAllocBuf(DWORD cbitPad) {
+
+	BYTE *	rgbNew;
+	DWORD	cbNeed;
+	int		ibuf;
+
+	cbNeed = cbChunk + (cbitPad + 7) / 8;
+	if (cbNeed <= cbBufAlloc) {
+		return fTrue;
+	}
+
+	for (ibuf = 0; ibuf < 2; ibuf++) {
+		rgbNew = (BYTE *) realloc(rgpbBuf[ibuf], cbNeed);
+		if (rgbNew == NULL) {
+			return fFalse;
+		}
+		rgpbBuf[ibuf] = rgbNew;
+	}
+
+	cbBufAlloc = cbNeed;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::CbitPrepare
+**
+**	Parameters:
+**		rgb			- buffer to fill
+**		pcbRemain	- bitstream bytes not yet read; updated
+**		cbitPad		- zeros to add after the last byte
+**
+**	Return Value:
+**		number of bits to shift from rgb, 0 if the file could not
+**		be read
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the next chunk of the bitstream and reverses the bits
+**		of each byte. The last chunk is followed by the pad.
+*/
+
+DWORD DjtgCfg::CbitPrepare(BYTE * rgb, DWORD * pcbRemain, DWORD cbitPad) {
+
+	DWORD	cb;
+
+	cb = (*pcbRemain < cbChunk) ? *pcbRemain : cbChunk;
+	if (fread(rgb, 1, cb, fpBit) != cb) {
+		return 0;
+	}
+
+	JtgBitsReverse(rgb, rgb, cb);
+
+	*pcbRemain -= cb;
+	if (*pcbRemain > 0) {
+		return 8 * cb;
+	}
+
+	memset(rgb + cb, 0, (cbitPad + 7) / 8);
+
+	return 8 * cb + cbitPad;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgCfg::FStream
+**
+**	Parameters:
+**		cbitPad		- zeros to shift after the bitstream
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		errCfgRead, errCfgJtag
+**
+**	Description:
+**		Shifts the bitstream from Shift-DR. Each chunk is issued as
+**		an overlapped DjtgPutTdiBits call; the next chunk is prepared
+**		in the other buffer while it is sent, and only then does the
+**		engine wait for it. The last bit is shifted with TMS high,
+**		which leaves the chain in Exit1-DR.
+*/
+
+BOOL DjtgCfg::FStream(DWORD cbitPad) {
+
+	BYTE *	rgbCur;
+	BYTE	bLast;
+	DWORD	cbRemain;
+	DWORD	cbitCur;
+	DWORD	cbitNext;
+	DWORD	cbitSend;
+	DWORD	cbOut;
+	DWORD	cbIn;
+	DWORD	ibuf;
+	BOOL	fOverlap;
+	BOOL	fLast;
+	double	dblStart;
+	double	dblMark;
+
+	fOverlap = ((fcfg & fcfgNoOverlap) == 0);
+	cbRemain = hdr.cbData;
+	ibuf = 0;
+
+	dblStart = DblCfgTimeSec();
+
+	cbitCur = CbitPrepare(rgpbBuf[0], &cbRemain, cbitPad);
+	stat.dblPrepSec += DblCfgTimeSec() - dblStart;
+
+	while (cbitCur > 0) {
+		rgbCur = rgpbBuf[ibuf];
+		fLast = (cbRemain == 0);
+		cbitSend = fLast ? cbitCur - 1 : cbitCur;
+
+		if (cbitSend > 0) {
+			// DJTG API Call: DjtgPutTdiBits
+			if (!DjtgPutTdiBits(hif, fFalse, rgbCur, NULL, cbitSend, fOverlap)) {
+				stat.erc = DmgrGetLastError();
+				return FFail(errCfgJtag);
+			}
+			stat.ccall++;
+		}
+		stat.cchunk++;
+
+		/* Prepare the next chunk while this one is on its way.
+		*/
+		cbitNext = 0;
+		if (!fLast) {
+			dblMark = DblCfgTimeSec();
+			cbitNext = CbitPrepare(rgpbBuf[ibuf ^ 1], &cbRemain, cbitPad);
+			stat.dblPrepSec += DblCfgTimeSec() - dblMark;
+		}
+
+		if (fOverlap && (cbitSend > 0)) {
+			dblMark = DblCfgTimeSec();
+
+			// DMGR API Call: DmgrGetTransResult
+			if (!DmgrGetTransResult(hif, &cbOut, &cbIn, tmsWaitInfinite)) {
+				stat.erc = DmgrGetLastError();
+				return FFail(errCfgJtag);
+			}
+			stat.dblWaitSec += DblCfgTimeSec() - dblMark;
+		}
+
+		if (fLast) {
+			bLast = (BYTE) ((rgbCur[cbitSend / 8] >> (cbitSend % 8)) & 1);
+
+			// DJTG API Call: DjtgPutTdiBits
+			if (!DjtgPutTdiBits(hif, fTrue, &bLast, NULL, 1, fFalse)) {
+				stat.erc = DmgrGetLastError();
+				return FFail(errCfgJtag);
+			}
+			stat.ccall++;
+			break;
+		}
+
+		if (cbitNext == 0) {
+			return FFail(errCfgRead);
+		}
+
+		cbitCur = cbitNext;
+		ibuf ^= 1;
+	}
+
+	if (cbitCur == 0) {
+		return FFail(errCfgRead);
+	}
+
+	stat.dblStreamSec = DblCfgTimeSec() - dblStart;
+	stat.cbData = hdr.cbData;
+	stat.cbitPad = cbitPad;
+	stat.dblWireSec = (8.0 * hdr.cbData + cbitPad) / stat.frqTck;
+	if (stat.dblStreamSec > 0) {
+		stat.dblMBps = hdr.cbData / stat.dblStreamSec / 1e6;
+		stat.dblTckUse = stat.dblWireSec / stat.dblStreamSec;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FBitParseHeader
+**
+**	Parameters:
+**		rgb			- first bytes of a .bit file
+**		cb			- number of bytes
+**		phdr		- variable to receive the header
+**
+**	Return Value:
+**		fTrue if rgb starts with a .bit header, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		After the fixed first field come keyed fields: a design
+**		name, b part, c date and d time, each a 16-bit big endian
+**		length and a NUL terminated string, then e, a 32-bit big
+**		endian length followed by the bitstream. Text fields longer
+**		than cchBitFieldMax are cut short.
+*/
+
+BOOL FBitParseHeader(const BYTE * rgb, DWORD cb, BITHDR * phdr) {
+
+	char *	szField;
+	DWORD	ib;
+	DWORD	cbField;
+	DWORD	cchCopy;
+	BYTE	bKey;
+
+	memset(phdr, 0, sizeof(BITHDR));
+
+	if ((cb < sizeof(rgbBitMagic)) || (memcmp(rgb, rgbBitMagic, sizeof(rgbBitMagic)) != 0)) {
+		return fFalse;
+	}
+
+	ib = sizeof(rgbBitMagic);
+	while (ib < cb) {
+		bKey = rgb[ib++];
+
+		if (bKey == 'e') {
+			if (cb - ib < 4) {
+				return fFalse;
+			}
+			phdr->cbData = ((DWORD) rgb[ib] << 24) | ((DWORD) rgb[ib + 1] << 16) |
+				((DWORD) rgb[ib + 2] << 8) | rgb[ib + 3];
+			phdr->ibData = ib + 4;
+			return (phdr->cbData > 0) && (phdr->szPart[0] != '\0');
+		}
+
+		if ((bKey < 'a') || (bKey > 'd') || (cb - ib < 2)) {
+			return fFalse;
+		}
+		cbField = ((DWORD) rgb[ib] << 8) | rgb[ib + 1];
+		ib += 2;
+		if (cb - ib < cbField) {
+			return fFalse;
+		}
+
+		switch (bKey) {
+			case 'a':	szField = phdr->szDesign;	break;
+			case 'b':	szField = phdr->szPart;		break;
+			case 'c':	szField = phdr->szDate;		break;
+			default:	szField = phdr->szTime;		break;
+		}
+
+		cchCopy = (cbField < cchBitFieldMax) ? cbField : cchBitFieldMax - 1;
+		memcpy(szField, rgb + ib, cchCopy);
+		szField[cchCopy] = '\0';
+
+		ib += cbField;
+	}
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	FCfgPartRest
+**
+**	Parameters:
+**		szRest		- part name of the file after the device name
+**
+**	Return Value:
+**		fTrue if the device name is the whole device, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Checks that the rest of a part name is empty, a speed grade
+**		or a package, so that a device name is not taken for the
+**		start of a longer one: after 3s200, "ft256" is a package but
+**		"aft256" makes the device 3s200a, and after 3s50, "0efg320"
+**		makes it 3s500e.
+*/
+
+static BOOL FCfgPartRest(const char * szRest) {
+
+	DWORD	ipkg;
+
+	if ((szRest[0] == '\0') || (szRest[0] == '-')) {
+		return fTrue;
+	}
+
+	for (ipkg = 0; ipkg < sizeof(rgszCfgPkg) / sizeof(rgszCfgPkg[0]); ipkg++) {
+		if (strncasecmp(szRest, rgszCfgPkg[ipkg], 2) == 0) {
+			szRest += 2;
+			if ((szRest[0] == 'g') || (szRest[0] == 'G')) {
+				szRest++;
+			}
+			return (szRest[0] >= '0') && (szRest[0] <= '9');
+		}
+	}
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblCfgTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		monotonic time in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the time used to measure the configuration.
+*/
+
+static double DblCfgTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/************************************************************************/
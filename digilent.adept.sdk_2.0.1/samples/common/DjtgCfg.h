@@ -0,0 +1,196 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgCfg.h  --  Xilinx FPGA Configuration Engine Declarations		*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DjtgCfg configures a Xilinx FPGA of a JTAG scan chain from	*/
+/*		a .bit file, using the instructions its family lists in the		*/
+/*		COMMANDS block of jtscdvclist.txt, found with a JtscIndex:		*/
+/*																		*/
+/*			JPROGRAM	- clears the configuration, if the family has	*/
+/*						  it; followed by a wait in Run-Test/Idle		*/
+/*			CFG_IN		- selects the configuration register, which		*/
+/*						  is then shifted with the bitstream			*/
+/*			JSTART		- runs the start-up sequence, clocked in		*/
+/*						  Run-Test/Idle									*/
+/*																		*/
+/*		The instruction scans and waits are recorded and sent by a		*/
+/*		DjtgSeq. The bitstream is streamed from the file in chunks		*/
+/*		through two buffers with overlapped DjtgPutTdiBits calls:		*/
+/*		while one chunk is being sent, the next is read and each of		*/
+/*		its bytes is bit reversed, as a bitstream is shifted most		*/
+/*		significant bit first and DJTG shifts the least significant		*/
+/*		first. Adept allows one overlapped transaction per interface	*/
+/*		handle, so the engine waits for a chunk only when the next		*/
+/*		one is ready to go. The link then stays busy unless preparing	*/
+/*		a chunk takes longer than sending one.							*/
+/*																		*/
+/*		FOpen reads the header of the .bit file: the design name,		*/
+/*		the part, the date and time it was made and the length of		*/
+/*		the bitstream. FProgram checks that the part is the device		*/
+/*		found in the chain, configures it, and GetStat returns the		*/
+/*		configuration time, the bitstream throughput and how close		*/
+/*		it came to the TCK frequency set with DjtgSetSpeed.				*/
+/*																		*/
+/*			DjtgCfg		cfg;											*/
+/*																		*/
+/*			cfg.FInit(hif, &seq, 0, 0);									*/
+/*			cfg.FOpen("top.bit");										*/
+/*			cfg.FProgram(&chain, idvc, &jsc);							*/
+/*			cfg.GetStat(&stat);											*/
+/*			cfg.Free();													*/
+/*																		*/
+/*		The DONE pin is not read back: the instruction capture bits		*/
+/*		that report it differ between families and are not in the		*/
+/*		device list.													*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DJTGCFG_INCLUDED)
+#define      DJTGCFG_INCLUDED
+
+#include <stdio.h>
+
+#include "dpcdecl.h"
+#include "DjtgSeq.h"
+#include "DjtgChain.h"
+#include "JtscIndex.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Options of FInit.
+*/
+const DWORD		fcfgNoOverlap	= 0x0001;	// send each chunk with a blocking call
+const DWORD		fcfgNoPartCheck	= 0x0002;	// configure whatever the part of the file
+
+/* Default chunk size, and the limits of the chunk size.
+*/
+const DWORD		cbCfgChunkDefault	= 262144;
+const DWORD		cbCfgChunkMin		= 512;
+const DWORD		cbCfgChunkMax		= 16777216;
+
+/* Waits in Run-Test/Idle: after JPROGRAM, in seconds of TCK, and
+** after JSTART, in clocks.
+*/
+const double	dblCfgClearSec		= 0.01;
+const DWORD		cclkCfgClearMin		= 10000;
+const DWORD		cclkCfgStartup		= 2000;
+
+/* Longest text field of a .bit header kept.
+*/
+const DWORD		cchBitFieldMax		= 128;
+
+/* Reasons a configuration failed.
+*/
+const int		errCfgNone		= 0;
+const int		errCfgOpen		= 1;	// the file cannot be opened
+const int		errCfgHeader	= 2;	// the file is not a .bit file
+const int		errCfgRead		= 3;	// the file is shorter than its header says
+const int		errCfgDevice	= 4;	// the device is not a known FPGA
+const int		errCfgCommand	= 5;	// its family lacks CFG_IN or JSTART
+const int		errCfgIrLen		= 6;	// its IRLEN differs from the chain
+const int		errCfgPart		= 7;	// the file is for another part
+const int		errCfgJtag		= 8;	// a DJTG call failed
+const int		errCfgMem		= 9;
+const int		errCfgState		= 10;	// not initialized or no file open
+const int		cerrCfg			= 11;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Header of a .bit file. The bitstream is the cbData bytes at ibData.
+*/
+typedef struct tagBITHDR {
+	char		szDesign[cchBitFieldMax];	// field a
+	char		szPart[cchBitFieldMax];		// field b, such as 3s500efg320
+	char		szDate[cchBitFieldMax];		// field c
+	char		szTime[cchBitFieldMax];		// field d
+	DWORD		ibData;
+	DWORD		cbData;						// field e
+} BITHDR;
+
+/* Statistics of the last FProgram.
+*/
+typedef struct tagCFGSTAT {
+	DWORD		frqTck;				// TCK frequency, Hz
+	DWORD		cbData;				// bitstream bytes sent
+	DWORD		cbitPad;			// bits shifted after them for the chain
+	DWORD		cchunk;
+	DWORD		ccall;				// DJTG calls, sequences included
+	double		dblSec;				// whole configuration
+	double		dblStreamSec;		// first chunk issued to last completed
+	double		dblPrepSec;			// reading and reversing chunks
+	double		dblWaitSec;			// waiting for chunks to complete
+	double		dblWireSec;			// the bitstream at frqTck
+	double		dblMBps;			// bitstream throughput, 1e6 bytes/s
+	double		dblTckUse;			// dblWireSec / dblStreamSec
+	ERC			erc;				// error of the failed DJTG call
+} CFGSTAT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DjtgCfg {
+
+private:
+	HIF			hif;
+	DjtgSeq *	pseq;
+	BOOL		fInit;
+	DWORD		fcfg;
+	DWORD		cbChunk;
+	BYTE *		rgpbBuf[2];
+	DWORD		cbBufAlloc;			// cbChunk and room for the chain pad
+
+	FILE *		fpBit;
+	BITHDR		hdr;
+	int			errLast;
+	CFGSTAT		stat;
+
+	BOOL	FFail(int err);
+	BOOL	FCheckDevice(const JTGCHAIN * pchain, DWORD idvc, JtscIndex * pjsc,
+				DWORD * pifam, DWORD * pcbitIr);
+	BOOL	FScanCommand(JtscIndex * pjsc, DWORD ifam, DWORD cbitIr, const char * szCmd);
+	BOOL	FAllocBuf(DWORD cbitPad);
+	DWORD	CbitPrepare(BYTE * rgb, DWORD * pcbRemain, DWORD cbitPad);
+	BOOL	FStream(DWORD cbitPad);
+
+public:
+	DjtgCfg();
+
+	BOOL	FInit(HIF hifInit, DjtgSeq * pseqInit, DWORD cbChunkInit, DWORD fcfgInit);
+	BOOL	FOpen(const char * szBit);
+	BOOL	FProgram(const JTGCHAIN * pchain, DWORD idvc, JtscIndex * pjsc);
+	void	Close();
+	void	Free();
+
+	const BITHDR *	PhdrGet()	{ return (fpBit != NULL) ? &hdr : NULL; }
+	int		ErrLast()			{ return errLast; }
+	void	GetStat(CFGSTAT * pstat);
+
+	static const char *	SzErr(int err);
+};
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FBitParseHeader(const BYTE * rgb, DWORD cb, BITHDR * phdr);
+
+/* ------------------------------------------------------------ */
+
+#endif					// DJTGCFG_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,432 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgChain.cpp  --  JTAG Scan Chain Discovery						*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Finds the devices of a JTAG scan chain and the lengths of		*/
+/*		their instruction registers in one sequence. See DjtgChain.h.	*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "DjtgSeq.h"
+#include "DjtgChain.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Counts of the ways to cut the captured instruction registers stop
+** at this value: only whether there is one way matters.
+*/
+const BYTE		cwayChainMany	= 2;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static BOOL		FChainBit(const BYTE * rgb, DWORD ibit);
+static BOOL		FChainParseDr(const BYTE * rgbDr, DWORD cbitScan, JTGCHAIN * pchain);
+static BOOL		FChainParseIr(const BYTE * rgbIr, DWORD cbitScan, JTGCHAIN * pchain);
+static void		ChainCutIr(const BYTE * rgbIr, JTGCHAIN * pchain);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	FDjtgChainScan
+**
+**	Parameters:
+**		pseq		- initialized sequence of the JTAG port
+**		pchain		- variable to receive the chain
+**
+**	Return Value:
+**		fTrue if the chain was found, fFalse if not
+**
+**	Errors:
+**		Leaves the error of a failed DJTG call for DmgrGetLastError.
+**
+**	Description:
+**		Sends the discovery sequence described in DjtgChain.h, as
+**		one DJTG call, and reads the chain from its TDO. If the end of
+**		the chain is not seen, the scans are made longer and the
+**		sequence is sent again. Fails if the end is not seen in
+**		scans of cbitChainScanMax bits, which happens when TDO is
+**		held low. Any sequence recorded before is sent with the
+**		first pass. The chain must be freed with DjtgChainFree.
+*/
+
+BOOL FDjtgChainScan(DjtgSeq * pseq, JTGCHAIN * pchain) {
+
+	BYTE *	rgbTdi;
+	BYTE *	rgbDr;
+	BYTE *	rgbIr;
+	DWORD	cbitScan;
+	DWORD	ibitDr;
+	DWORD	ibitIr;
+	BOOL	fEnd;
+	BOOL	fOk;
+
+	memset(pchain, 0, sizeof(JTGCHAIN));
+
+	rgbTdi = (BYTE *) malloc(cbitChainScanMax / 8);
+	rgbDr = (BYTE *) malloc(cbitChainScanMax / 8);
+	rgbIr = (BYTE *) malloc(cbitChainScanMax / 8);
+
+	fOk = (rgbTdi != NULL) && (rgbDr != NULL) && (rgbIr != NULL);
+	fEnd = fFalse;
+
+	for (cbitScan = cbitChainScanFirst; fOk && !fEnd && (cbitScan <= cbitChainScanMax); cbitScan *= 2) {
+
+		/* Ones through the IDCODE and BYPASS registers selected by
+		** the reset, then a 0 and ones through the instruction
+		** registers, which leaves BYPASS in all of them.
+		*/
+		memset(rgbTdi, 0xFF, cbitScan / 8);
+		fOk = pseq->FReset() && pseq->FScanDr(rgbTdi, cbitScan, &ibitDr);
+
+		rgbTdi[0] = 0xFE;
+		fOk = fOk && pseq->FScanIr(rgbTdi, cbitScan, &ibitIr) && pseq->FReset();
+
+		fOk = fOk && pseq->FExecute();
+		fOk = fOk && pseq->FGetTdo(ibitDr, cbitScan, rgbDr) && pseq->FGetTdo(ibitIr, cbitScan, rgbIr);
+
+		if (fOk) {
+			pchain->cpass++;
+			pchain->cbitScan = cbitScan;
+			fEnd = FChainParseDr(rgbDr, cbitScan, pchain) && FChainParseIr(rgbIr, cbitScan, pchain);
+		}
+	}
+
+	if (fOk && fEnd) {
+		ChainCutIr(rgbIr, pchain);
+	}
+
+	free(rgbTdi);
+	free(rgbDr);
+	free(rgbIr);
+
+	if (!fOk || !fEnd) {
+		DjtgChainFree(pchain);
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FDjtgChainSetPad
+**
+**	Parameters:
+**		pseq		- sequence of the JTAG port
+**		pchain		- chain found by FDjtgChainScan
+**		idvc		- device to address, 0 next to TDI
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Pads the scans recorded from now on with BYPASS for every
+**		device but idvc. Fails if the instruction register lengths
+**		are not known.
+*/
+
+BOOL FDjtgChainSetPad(DjtgSeq * pseq, const JTGCHAIN * pchain, DWORD idvc) {
+
+	DWORD	cbitIrPre;
+	DWORD	cbitIrPost;
+	DWORD	jdvc;
+
+	if (!pchain->fIrKnown || (idvc >= pchain->cdvc)) {
+		return fFalse;
+	}
+
+	cbitIrPre = 0;
+	cbitIrPost = 0;
+	for (jdvc = 0; jdvc < pchain->cdvc; jdvc++) {
+		if (jdvc < idvc) {
+			cbitIrPre += pchain->rgdvc[jdvc].cbitIr;
+		}
+		else if (jdvc > idvc) {
+			cbitIrPost += pchain->rgdvc[jdvc].cbitIr;
+		}
+	}
+
+	pseq->SetPad(cbitIrPre, cbitIrPost, idvc, pchain->cdvc - 1 - idvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgChainFree
+**
+**	Parameters:
+**		pchain		- chain found by FDjtgChainScan
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Frees the device list of a chain.
+*/
+
+void DjtgChainFree(JTGCHAIN * pchain) {
+
+	free(pchain->rgdvc);
+
+	pchain->rgdvc = NULL;
+	pchain->cdvc = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	FChainBit
+**
+**	Parameters:
+**		rgb		- bits, LSB of the first byte first
+**		ibit	- bit number
+**
+**	Return Value:
+**		the bit
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns one bit of a TDO buffer.
+*/
+
+static BOOL FChainBit(const BYTE * rgb, DWORD ibit) {
+
+	return (rgb[ibit / 8] >> (ibit % 8)) & 1;
+}
+
+/* ------------------------------------------------------------ */
+/***	FChainParseDr
+**
+**	Parameters:
+**		rgbDr		- TDO of the data scan
+**		cbitScan	- length of the scan
+**		pchain		- chain to receive the devices
+**
+**	Return Value:
+**		fTrue if the end of the chain was seen, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the devices from the TDO end of the chain: a 0 is a
+**		BYPASS register, a 1 starts an IDCODE, and 32 ones are the
+**		ones shifted in. The devices are stored from TDI to TDO.
+*/
+
+static BOOL FChainParseDr(const BYTE * rgbDr, DWORD cbitScan, JTGCHAIN * pchain) {
+
+	DWORD	ibit;
+	DWORD	ibitId;
+	DWORD	cdvc;
+	DWORD	idvc;
+	DWORD	idcode;
+	int		ipass;
+
+	DjtgChainFree(pchain);
+
+	/* Count the devices, then store them.
+	*/
+	cdvc = 0;
+	for (ipass = 0; ipass < 2; ipass++) {
+		idvc = 0;
+		ibit = 0;
+		while (fTrue) {
+			if (ibit >= cbitScan) {
+				return fFalse;
+			}
+
+			if (!FChainBit(rgbDr, ibit)) {
+				idcode = 0;
+				ibit++;
+			}
+			else {
+				if (cbitScan - ibit < 32) {
+					return fFalse;
+				}
+				idcode = 0;
+				for (ibitId = 0; ibitId < 32; ibitId++) {
+					idcode |= (DWORD) FChainBit(rgbDr, ibit + ibitId) << ibitId;
+				}
+				if (idcode == 0xFFFFFFFF) {
+					break;
+				}
+				ibit += 32;
+			}
+
+			if (ipass == 1) {
+				pchain->rgdvc[cdvc - 1 - idvc].idcode = idcode;
+				pchain->rgdvc[cdvc - 1 - idvc].cbitIr = 0;
+			}
+			idvc++;
+		}
+
+		if (ipass == 0) {
+			cdvc = idvc;
+			pchain->rgdvc = (JTGDVC *) calloc((cdvc > 0) ? cdvc : 1, sizeof(JTGDVC));
+			if (pchain->rgdvc == NULL) {
+				return fFalse;
+			}
+		}
+	}
+
+	pchain->cdvc = cdvc;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FChainParseIr
+**
+**	Parameters:
+**		rgbIr		- TDO of the instruction scan
+**		cbitScan	- length of the scan
+**		pchain		- chain to receive the total length
+**
+**	Return Value:
+**		fTrue if the 0 shifted in was seen, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Finds the last 0 of the TDO, which is the 0 shifted in if at
+**		least half of the scan follows it. Every device captures a 0
+**		in bit 1 of its instruction register, so the captured
+**		registers hold no such run of ones.
+*/
+
+static BOOL FChainParseIr(const BYTE * rgbIr, DWORD cbitScan, JTGCHAIN * pchain) {
+
+	DWORD	ibit;
+
+	for (ibit = cbitScan; ibit > 0; ibit--) {
+		if (!FChainBit(rgbIr, ibit - 1)) {
+			break;
+		}
+	}
+
+	if ((ibit == 0) || (cbitScan - ibit < cbitScan / 2)) {
+		return fFalse;
+	}
+
+	pchain->cbitIrTotal = ibit - 1;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	ChainCutIr
+**
+**	Parameters:
+**		rgbIr		- TDO of the instruction scan
+**		pchain		- chain to receive the instruction lengths
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Counts the ways to cut the captured instruction registers
+**		into one register per device, each at least two bits long and
+**		starting with 1, 0. rgway[k][i] is the number of ways to cut
+**		the first i bits into k registers. If there is exactly one
+**		way, it is traced back to give the length of each register.
+*/
+
+static void ChainCutIr(const BYTE * rgbIr, JTGCHAIN * pchain) {
+
+	BYTE *	rgway;
+	DWORD	cbit;
+	DWORD	cdvc;
+	DWORD	kdvc;
+	DWORD	ibit;
+	DWORD	ibitStart;
+	DWORD	cway;
+
+	pchain->fIrKnown = fFalse;
+
+	cbit = pchain->cbitIrTotal;
+	cdvc = pchain->cdvc;
+
+	if (cdvc == 0) {
+		pchain->fIrKnown = (cbit == 0);
+		return;
+	}
+
+	rgway = (BYTE *) calloc((size_t) (cdvc + 1) * (cbit + 1), 1);
+	if (rgway == NULL) {
+		return;
+	}
+
+	/* A register can end at bit i if it can start at some bit s <=
+	** i - 2 that holds 1, 0 and the first s bits hold one fewer
+	** register. cway is the running count of such starts.
+	*/
+	rgway[0] = 1;
+	for (kdvc = 1; kdvc <= cdvc; kdvc++) {
+		cway = 0;
+		for (ibit = 2; ibit <= cbit; ibit++) {
+			ibitStart = ibit - 2;
+			if (FChainBit(rgbIr, ibitStart) && !FChainBit(rgbIr, ibitStart + 1)) {
+				cway += rgway[(kdvc - 1) * (cbit + 1) + ibitStart];
+				if (cway > cwayChainMany) {
+					cway = cwayChainMany;
+				}
+			}
+			rgway[kdvc * (cbit + 1) + ibit] = (BYTE) cway;
+		}
+	}
+
+	if (rgway[cdvc * (cbit + 1) + cbit] == 1) {
+
+		/* The first register read is that of the device next to TDO.
+		*/
+		ibit = cbit;
+		for (kdvc = cdvc; kdvc > 0; kdvc--) {
+			for (ibitStart = ibit - 2; ; ibitStart--) {
+				if (FChainBit(rgbIr, ibitStart) && !FChainBit(rgbIr, ibitStart + 1) &&
+					(rgway[(kdvc - 1) * (cbit + 1) + ibitStart] != 0)) {
+					break;
+				}
+			}
+			pchain->rgdvc[cdvc - kdvc].cbitIr = ibit - ibitStart;
+			ibit = ibitStart;
+		}
+
+		pchain->fIrKnown = fTrue;
+	}
+
+	free(rgway);
+}
+
+/************************************************************************/
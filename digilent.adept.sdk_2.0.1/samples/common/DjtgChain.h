@@ -0,0 +1,96 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgChain.h  --  JTAG Scan Chain Discovery Declarations				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		FDjtgChainScan finds the devices of a JTAG scan chain, their	*/
+/*		IDCODEs and their instruction register lengths with a single	*/
+/*		DJTG call, using a DjtgSeq:										*/
+/*																		*/
+/*		After Test-Logic-Reset every device has its IDCODE register,	*/
+/*		whose bit 0 is 1, or its BYPASS register, which captures 0,		*/
+/*		between TDI and TDO. A data scan of ones reads the chain from	*/
+/*		the TDO end: a 0 is a device with BYPASS only, a 1 starts a		*/
+/*		32-bit IDCODE, and 32 ones are the ones shifted in, so the		*/
+/*		chain has ended.												*/
+/*																		*/
+/*		In the same sequence an instruction scan shifts a 0 and then	*/
+/*		ones. The last 0 read from TDO is the 0 shifted in, so its		*/
+/*		offset is the total instruction register length. The bits		*/
+/*		before it are the captured instruction registers, each of		*/
+/*		which starts with 1, 0 from the TDO end. When those bits can	*/
+/*		be cut into one such register per device in only one way,		*/
+/*		the length of each register is known. Devices that capture		*/
+/*		more 1, 0 pairs can make the cut ambiguous; the lengths are		*/
+/*		then left 0 and only the total is known. The scan loads			*/
+/*		BYPASS into every device and ends with a reset.					*/
+/*																		*/
+/*		The scans are 1024 bits long, enough for 31 devices with		*/
+/*		IDCODEs. If the end of the chain is not seen they are made		*/
+/*		twice as long and the sequence is sent again, so a chain of		*/
+/*		any length is found.											*/
+/*																		*/
+/*		The devices are listed from TDI to TDO. DjtgChainSetPad makes	*/
+/*		the scans of a DjtgSeq address one of them.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DJTGCHAIN_INCLUDED)
+#define      DJTGCHAIN_INCLUDED
+
+#include "dpcdecl.h"
+#include "DjtgSeq.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Length of the first scans, and the longest scans tried.
+*/
+const DWORD		cbitChainScanFirst	= 1024;
+const DWORD		cbitChainScanMax	= 1048576;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* A device of the chain.
+*/
+typedef struct tagJTGDVC {
+	DWORD		idcode;				// 0 for a device with BYPASS only
+	DWORD		cbitIr;				// instruction register length, 0 unknown
+} JTGDVC;
+
+/* A scan chain, from TDI to TDO.
+*/
+typedef struct tagJTGCHAIN {
+	DWORD		cdvc;
+	JTGDVC *	rgdvc;
+	DWORD		cbitIrTotal;
+	BOOL		fIrKnown;			// every cbitIr is known
+	DWORD		cpass;				// sequences sent to find the chain
+	DWORD		cbitScan;			// length of the scans of the last pass
+} JTGCHAIN;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FDjtgChainScan(DjtgSeq * pseq, JTGCHAIN * pchain);
+BOOL	FDjtgChainSetPad(DjtgSeq * pseq, const JTGCHAIN * pchain, DWORD idvc);
+void	DjtgChainFree(JTGCHAIN * pchain);
+
+/* ------------------------------------------------------------ */
+
+#endif					// DJTGCHAIN_INCLUDED
+
+/************************************************************************/
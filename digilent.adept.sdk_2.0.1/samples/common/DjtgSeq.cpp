@@ -0,0 +1,975 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgSeq.cpp  --  JTAG Sequence Compiler								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Records JTAG operations as TMS/TDI bit pairs and sends them		*/
+/*		with DjtgPutTmsTdiBits. See DjtgSeq.h.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: added FSetState											*/
+/*	10/17/2026: byte aligned TDI interleaved with JtgBits				*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "djtg.h"
+#include "DjtgSeq.h"
+#include "JtgBits.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Next state of the TAP controller for TMS low and TMS high.
+*/
+static const int	rgstJtgNext[cstJtg][2] = {
+	{ stJtgIdle,	stJtgReset },	// stJtgReset
+	{ stJtgIdle,	stJtgSelDr },	// stJtgIdle
+	{ stJtgCapDr,	stJtgSelIr },	// stJtgSelDr
+	{ stJtgShfDr,	stJtgEx1Dr },	// stJtgCapDr
+	{ stJtgShfDr,	stJtgEx1Dr },	// stJtgShfDr
+	{ stJtgPauDr,	stJtgUpdDr },	// stJtgEx1Dr
+	{ stJtgPauDr,	stJtgEx2Dr },	// stJtgPauDr
+	{ stJtgShfDr,	stJtgUpdDr },	// stJtgEx2Dr
+	{ stJtgIdle,	stJtgSelDr },	// stJtgUpdDr
+	{ stJtgCapIr,	stJtgReset },	// stJtgSelIr
+	{ stJtgShfIr,	stJtgEx1Ir },	// stJtgCapIr
+	{ stJtgShfIr,	stJtgEx1Ir },	// stJtgShfIr
+	{ stJtgPauIr,	stJtgUpdIr },	// stJtgEx1Ir
+	{ stJtgPauIr,	stJtgEx2Ir },	// stJtgPauIr
+	{ stJtgShfIr,	stJtgUpdIr },	// stJtgEx2Ir
+	{ stJtgIdle,	stJtgSelDr },	// stJtgUpdIr
+};
+
+/* TMS high for this many clocks reaches Test-Logic-Reset from any
+** state.
+*/
+const DWORD		cclkJtgReset	= 5;
+
+/* The recorded pairs grow by at least this many clocks at a time.
+*/
+const DWORD		cclkSeqGrow		= 65536;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static WORD		WSeqSpread(BYTE b);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::DjtgSeq
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The sequence must be initialized with FInit
+**		before it is used.
+*/
+
+DjtgSeq::DjtgSeq() {
+
+	hif = hifInvalid;
+	fInit = fFalse;
+	cclkCallMax = 0;
+	stCur = stJtgUnknown;
+	stEndIr = stJtgIdle;
+	stEndDr = stJtgIdle;
+	cbitIrPre = 0;
+	cbitIrPost = 0;
+	cbitDrPre = 0;
+	cbitDrPost = 0;
+	rgbPair = NULL;
+	cclk = 0;
+	cclkAlloc = 0;
+	fTdo = fFalse;
+	rgbTdo = NULL;
+	cclkTdo = 0;
+	cbTdoAlloc = 0;
+	memset(&stat, 0, sizeof(stat));
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FInit
+**
+**	Parameters:
+**		hifInit			- open interface handle with DJTG enabled
+**		cclkCallMaxInit	- longest DjtgPutTmsTdiBits call in clocks,
+**						  0 for cclkSeqCallDefault
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the device the sequence is sent to. The state of its
+**		chain is unknown until the first reset. A call is made a
+**		multiple of 8 clocks long, so that every call starts on a
+**		byte of the pair and TDO buffers.
+*/
+
+BOOL DjtgSeq::FInit(HIF hifInit, DWORD cclkCallMaxInit) {
+
+	if (fInit) {
+		return fFalse;
+	}
+
+	if (cclkCallMaxInit == 0) {
+		cclkCallMaxInit = cclkSeqCallDefault;
+	}
+	cclkCallMaxInit &= ~7;
+	if (cclkCallMaxInit == 0) {
+		return fFalse;
+	}
+
+	hif = hifInit;
+	cclkCallMax = cclkCallMaxInit;
+	stCur = stJtgUnknown;
+	cclk = 0;
+	fTdo = fFalse;
+	cclkTdo = 0;
+	memset(&stat, 0, sizeof(stat));
+	fInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FSetEndState
+**
+**	Parameters:
+**		stEndIrSet	- state instruction register scans end in
+**		stEndDrSet	- state data register scans end in
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the end states of the scans recorded from now on. They
+**		must be states the TAP controller stays in with TMS held:
+**		stJtgReset, stJtgIdle, stJtgPauDr or stJtgPauIr.
+*/
+
+BOOL DjtgSeq::FSetEndState(int stEndIrSet, int stEndDrSet) {
+
+	int		ist;
+	int		st;
+
+	for (ist = 0; ist < 2; ist++) {
+		st = (ist == 0) ? stEndIrSet : stEndDrSet;
+		if ((st != stJtgReset) && (st != stJtgIdle) && (st != stJtgPauDr) && (st != stJtgPauIr)) {
+			return fFalse;
+		}
+	}
+
+	stEndIr = stEndIrSet;
+	stEndDr = stEndDrSet;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::SetPad
+**
+**	Parameters:
+**		cbitIrPreSet	- instruction bits between TDI and the device
+**		cbitIrPostSet	- instruction bits between the device and TDO
+**		cbitDrPreSet	- devices between TDI and the device
+**		cbitDrPostSet	- devices between the device and TDO
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the scans recorded from now on address one device of
+**		the chain. The instructions of the other devices are padded
+**		with ones, BYPASS, and their BYPASS registers with zeros. The
+**		pad between the device and TDO is shifted first, so the
+**		offset of the TDO of a scan is that of the device's own bits.
+**		All zero addresses the whole chain.
+*/
+
+void DjtgSeq::SetPad(DWORD cbitIrPreSet, DWORD cbitIrPostSet, DWORD cbitDrPreSet, DWORD cbitDrPostSet) {
+
+	cbitIrPre = cbitIrPreSet;
+	cbitIrPost = cbitIrPostSet;
+	cbitDrPre = cbitDrPreSet;
+	cbitDrPost = cbitDrPostSet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FReset
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records five clocks with TMS high, which put the chain in
+**		Test-Logic-Reset from any state.
+*/
+
+BOOL DjtgSeq::FReset() {
+
+	DWORD	iclk;
+
+	if (!fInit || !FReserve(cclkJtgReset)) {
+		return fFalse;
+	}
+
+	for (iclk = 0; iclk < cclkJtgReset; iclk++) {
+		PutClock(fTrue, fFalse);
+	}
+
+	stCur = stJtgReset;
+	stat.cmove++;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FMove
+**
+**	Parameters:
+**		st		- state to move to
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the shortest TMS path from the current state to st.
+**		If the state is unknown, the chain is reset first.
+*/
+
+BOOL DjtgSeq::FMove(int st) {
+
+	if (!fInit || (st < 0) || (st >= cstJtg)) {
+		return fFalse;
+	}
+
+	if ((stCur == stJtgUnknown) && !FReset()) {
+		return fFalse;
+	}
+
+	if (!FReserve(cstJtg)) {
+		return fFalse;
+	}
+
+	PutPath(st);
+	stat.cmove++;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FSetState
+**
+**	Parameters:
+**		st		- state the chain is in
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the current state to the one the chain was left in by
+**		DJTG calls made outside the sequence. Fails if operations
+**		are recorded and not yet executed, since the chain is not
+**		in the state they end in.
+*/
+
+BOOL DjtgSeq::FSetState(int st) {
+
+	if (!fInit || (st < stJtgUnknown) || (st >= cstJtg) || (cclk != 0)) {
+		return fFalse;
+	}
+
+	stCur = st;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FIdle
+**
+**	Parameters:
+**		cclkIdle	- clocks to spend in Run-Test/Idle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Moves to Run-Test/Idle and clocks TCK there, as the wait of
+**		a programming algorithm.
+*/
+
+BOOL DjtgSeq::FIdle(DWORD cclkIdle) {
+
+	if (!FMove(stJtgIdle) || !FReserve(cclkIdle)) {
+		return fFalse;
+	}
+
+	PutShift(NULL, cclkIdle, fFalse, fFalse);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FScanIr
+**
+**	Parameters:
+**		rgbTdi		- instruction, LSB of the first byte shifted first,
+**					  or NULL for all ones
+**		cbit		- instruction length
+**		pibitTdo	- variable to receive the TDO offset of the
+**					  captured instruction register, or NULL
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records an instruction register scan. See FScan.
+*/
+
+BOOL DjtgSeq::FScanIr(const BYTE * rgbTdi, DWORD cbit, DWORD * pibitTdo) {
+
+	return FScan(fTrue, rgbTdi, cbit, pibitTdo);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FScanDr
+**
+**	Parameters:
+**		rgbTdi		- data, LSB of the first byte shifted first, or
+**					  NULL for all zeros
+**		cbit		- data length
+**		pibitTdo	- variable to receive the TDO offset of the
+**					  captured data register, or NULL
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records a data register scan. See FScan.
+*/
+
+BOOL DjtgSeq::FScanDr(const BYTE * rgbTdi, DWORD cbit, DWORD * pibitTdo) {
+
+	return FScan(fFalse, rgbTdi, cbit, pibitTdo);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FExecute
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Leaves the error of a failed DJTG call for DmgrGetLastError.
+**
+**	Description:
+**		Sends the recorded sequence in calls of at most cclkCallMax
+**		clocks, reading TDO if a scan asked for it, and starts a new
+**		sequence. If a call fails the state of the chain is unknown
+**		and the next sequence starts with a reset.
+*/
+
+BOOL DjtgSeq::FExecute() {
+
+	DWORD	iclk;
+	DWORD	cclkCall;
+	DWORD	cbTdo;
+	BYTE *	rgbNew;
+	BOOL	fOk;
+
+	if (!fInit) {
+		return fFalse;
+	}
+
+	cclkTdo = 0;
+	if (cclk == 0) {
+		return fTrue;
+	}
+
+	if (fTdo) {
+		cbTdo = (cclk + 7) / 8;
+		if (cbTdo > cbTdoAlloc) {
+			rgbNew = (BYTE *) realloc(rgbTdo, cbTdo);
+			if (rgbNew == NULL) {
+				return fFalse;
+			}
+			rgbTdo = rgbNew;
+			cbTdoAlloc = cbTdo;
+		}
+	}
+
+	fOk = fTrue;
+	for (iclk = 0; fOk && (iclk < cclk); iclk += cclkCall) {
+		cclkCall = (cclk - iclk < cclkCallMax) ? cclk - iclk : cclkCallMax;
+
+		// DJTG API Call: DjtgPutTmsTdiBits
+		fOk = DjtgPutTmsTdiBits(hif, rgbPair + iclk / 4, fTdo ? rgbTdo + iclk / 8 : NULL,
+				cclkCall, fFalse);
+		stat.ccall++;
+	}
+
+	if (fOk) {
+		cclkTdo = fTdo ? cclk : 0;
+		stat.cprog++;
+		stat.cclk += cclk;
+	}
+	else {
+		stCur = stJtgUnknown;
+	}
+
+	memset(rgbPair, 0, (cclk + 3) / 4);
+	cclk = 0;
+	fTdo = fFalse;
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FGetTdo
+**
+**	Parameters:
+**		ibit	- TDO offset returned by a scan
+**		cbit	- number of bits
+**		rgb		- buffer to receive the bits, LSB of the first byte
+**				  first
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Copies bits of the TDO of the last sequence executed. The
+**		unused high bits of the last byte are cleared.
+*/
+
+BOOL DjtgSeq::FGetTdo(DWORD ibit, DWORD cbit, BYTE * rgb) {
+
+	DWORD	ib;
+	DWORD	cb;
+	DWORD	ibSrc;
+	DWORD	cbitShift;
+	WORD	w;
+
+	if ((ibit > cclkTdo) || (cbit > cclkTdo - ibit)) {
+		return fFalse;
+	}
+
+	cb = (cbit + 7) / 8;
+	ibSrc = ibit / 8;
+	cbitShift = ibit % 8;
+
+	for (ib = 0; ib < cb; ib++) {
+		w = rgbTdo[ibSrc + ib];
+		if ((cbitShift != 0) && (ibSrc + ib + 1 < (cclkTdo + 7) / 8)) {
+			w |= rgbTdo[ibSrc + ib + 1] << 8;
+		}
+		rgb[ib] = (BYTE) (w >> cbitShift);
+	}
+
+	if ((cbit % 8) != 0) {
+		rgb[cb - 1] &= (BYTE) ((1 << (cbit % 8)) - 1);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::DwGetTdo
+**
+**	Parameters:
+**		ibit	- TDO offset returned by a scan
+**		cbit	- number of bits, at most 32
+**
+**	Return Value:
+**		the bits, first bit in bit 0, or 0 if they were not read
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns up to 32 bits of the TDO of the last sequence
+**		executed, such as an IDCODE.
+*/
+
+DWORD DjtgSeq::DwGetTdo(DWORD ibit, DWORD cbit) {
+
+	BYTE	rgb[4];
+
+	if ((cbit > 32) || !FGetTdo(ibit, cbit, rgb)) {
+		return 0;
+	}
+
+	memset(rgb + (cbit + 7) / 8, 0, 4 - (cbit + 7) / 8);
+
+	return rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | ((DWORD) rgb[3] << 24);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::CclkPending
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		clocks recorded and not yet sent
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the length of the sequence being recorded.
+*/
+
+DWORD DjtgSeq::CclkPending() {
+
+	return cclk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::StCur
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		TAP controller state at the end of the sequence
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the state the chain will be in when the recorded
+**		sequence has been sent, or stJtgUnknown.
+*/
+
+int DjtgSeq::StCur() {
+
+	return stCur;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::GetStat
+**
+**	Parameters:
+**		pstat	- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the statistics since FInit.
+*/
+
+void DjtgSeq::GetStat(SEQSTAT * pstat) {
+
+	*pstat = stat;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Drops the recorded sequence and frees the buffers.
+*/
+
+void DjtgSeq::Free() {
+
+	free(rgbPair);
+	free(rgbTdo);
+
+	rgbPair = NULL;
+	cclk = 0;
+	cclkAlloc = 0;
+	rgbTdo = NULL;
+	cclkTdo = 0;
+	cbTdoAlloc = 0;
+	fTdo = fFalse;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FScan
+**
+**	Parameters:
+**		fIr			- fTrue for the instruction register, fFalse for
+**					  the data register
+**		rgbTdi		- bits to shift in, or NULL for the pad value
+**		cbit		- number of bits
+**		pibitTdo	- variable to receive the TDO offset of the
+**					  captured bits, or NULL
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records a scan: the move to the Capture state of the register
+**		and one clock into its Shift state, then the pad between the
+**		device and TDO, the bits and the pad between TDI and the
+**		device, with TMS high on the last bit, and the move from the
+**		Exit1 state to the end state. Going through Capture starts a
+**		new scan even from a Pause state.
+*/
+
+BOOL DjtgSeq::FScan(BOOL fIr, const BYTE * rgbTdi, DWORD cbit, DWORD * pibitTdo) {
+
+	DWORD	cbitPre;
+	DWORD	cbitPost;
+
+	cbitPre = fIr ? cbitIrPre : cbitDrPre;
+	cbitPost = fIr ? cbitIrPost : cbitDrPost;
+
+	if (!fInit || (cbit == 0)) {
+		return fFalse;
+	}
+
+	if ((stCur == stJtgUnknown) && !FReset()) {
+		return fFalse;
+	}
+
+	if (!FReserve(cstJtg + 1 + cbitPost + cbit + cbitPre + cstJtg)) {
+		return fFalse;
+	}
+
+	PutPath(fIr ? stJtgCapIr : stJtgCapDr);
+	PutClock(fFalse, fFalse);
+	PutShift(NULL, cbitPost, fIr, fFalse);
+
+	if (pibitTdo != NULL) {
+		*pibitTdo = cclk;
+		fTdo = fTrue;
+		stat.cscanTdo++;
+	}
+
+	if (rgbTdi != NULL) {
+		PutShift(rgbTdi, cbit, fFalse, cbitPre == 0);
+	}
+	else {
+		PutShift(NULL, cbit, fIr, cbitPre == 0);
+	}
+	PutShift(NULL, cbitPre, fIr, fTrue);
+
+	stCur = fIr ? stJtgEx1Ir : stJtgEx1Dr;
+	PutPath(fIr ? stEndIr : stEndDr);
+	stat.cscan++;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::FReserve
+**
+**	Parameters:
+**		cclkAdd		- clocks about to be recorded
+**
+**	Return Value:
+**		fTrue if successful, fFalse if out of memory
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Grows the pair buffer to hold cclkAdd more clocks. New space
+**		is cleared, as the pairs are recorded by setting bits.
+*/
+
+BOOL DjtgSeq::FReserve(DWORD cclkAdd) {
+
+	DWORD	cclkNew;
+	BYTE *	rgbNew;
+
+	if (cclkAdd > 0xFFFFFFF0 - cclk) {
+		return fFalse;
+	}
+
+	if (cclk + cclkAdd <= cclkAlloc) {
+		return fTrue;
+	}
+
+	cclkNew = cclkAlloc + ((cclkAlloc > cclkSeqGrow) ? cclkAlloc : cclkSeqGrow);
+	if ((cclkNew < cclkAlloc) || (cclkNew < cclk + cclkAdd)) {
+		cclkNew = cclk + cclkAdd;
+	}
+	cclkNew = (cclkNew + 15) & ~15;
+
+	rgbNew = (BYTE *) realloc(rgbPair, cclkNew / 4);
+	if (rgbNew == NULL) {
+		return fFalse;
+	}
+
+	memset(rgbNew + cclkAlloc / 4, 0, (cclkNew - cclkAlloc) / 4);
+	rgbPair = rgbNew;
+	cclkAlloc = cclkNew;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::PutClock
+**
+**	Parameters:
+**		fTms	- TMS for the clock
+**		fTdi	- TDI for the clock
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records one bit pair. Space must have been reserved.
+*/
+
+void DjtgSeq::PutClock(BOOL fTms, BOOL fTdi) {
+
+	rgbPair[cclk / 4] |= (BYTE) (((fTms ? 2 : 0) | (fTdi ? 1 : 0)) << (2 * (cclk % 4)));
+	cclk++;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::PutPath
+**
+**	Parameters:
+**		st		- state to move to
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the shortest TMS path from the current state, which
+**		must be known, to st with a breadth first search of the TAP
+**		controller. Space for cstJtg clocks must have been reserved.
+*/
+
+void DjtgSeq::PutPath(int st) {
+
+	int		rgstPrev[cstJtg];
+	int		rgstQueue[cstJtg];
+	BOOL	rgfTms[cstJtg];
+	BOOL	rgfPath[cstJtg];
+	int		istHead;
+	int		istTail;
+	int		stFrom;
+	int		stTo;
+	int		cst;
+	int		itms;
+
+	for (stTo = 0; stTo < cstJtg; stTo++) {
+		rgstPrev[stTo] = stJtgUnknown;
+	}
+
+	rgstPrev[stCur] = stCur;
+	rgstQueue[0] = stCur;
+	istHead = 0;
+	istTail = 1;
+
+	while ((istHead < istTail) && (rgstPrev[st] == stJtgUnknown)) {
+		stFrom = rgstQueue[istHead++];
+		for (itms = 0; itms < 2; itms++) {
+			stTo = rgstJtgNext[stFrom][itms];
+			if (rgstPrev[stTo] == stJtgUnknown) {
+				rgstPrev[stTo] = stFrom;
+				rgfTms[stTo] = (itms != 0);
+				rgstQueue[istTail++] = stTo;
+			}
+		}
+	}
+
+	cst = 0;
+	for (stTo = st; stTo != stCur; stTo = rgstPrev[stTo]) {
+		rgfPath[cst++] = rgfTms[stTo];
+	}
+	while (cst > 0) {
+		PutClock(rgfPath[--cst], fFalse);
+	}
+
+	stCur = st;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSeq::PutShift
+**
+**	Parameters:
+**		rgbTdi		- TDI bits, LSB of the first byte first, or NULL
+**		cbit		- number of clocks
+**		fFill		- TDI when rgbTdi is NULL
+**		fLast		- fTrue to raise TMS on the last clock
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records clocks with TMS low. Once the pairs are on a byte
+**		boundary, TDI bits that are also on a byte boundary are
+**		interleaved by JtgBitsInterleave; otherwise eight TDI bits at
+**		a time are spread into the low bits of four pairs. Space must
+**		have been reserved.
+*/
+
+void DjtgSeq::PutShift(const BYTE * rgbTdi, DWORD cbit, BOOL fFill, BOOL fLast) {
+
+	DWORD	ibit;
+	DWORD	cbitBody;
+	DWORD	ib;
+	DWORD	cb;
+	DWORD	cbitShift;
+	WORD	w;
+	WORD	wFill;
+
+	if (cbit == 0) {
+		return;
+	}
+
+	cbitBody = cbit - (fLast ? 1 : 0);
+	wFill = fFill ? 0x5555 : 0x0000;
+	ibit = 0;
+
+	while ((ibit < cbitBody) && ((cclk % 4) != 0)) {
+		PutClock(fFalse, (rgbTdi != NULL) ? (rgbTdi[ibit / 8] >> (ibit % 8)) & 1 : fFill);
+		ibit++;
+	}
+
+	if ((rgbTdi != NULL) && ((ibit % 8) == 0) && (cbitBody - ibit >= 8)) {
+		cb = (cbitBody - ibit) / 8;
+		JtgBitsInterleave(&rgbPair[cclk / 4], NULL, &rgbTdi[ibit / 8], cb);
+		cclk += 8 * cb;
+		ibit += 8 * cb;
+	}
+
+	while (cbitBody - ibit >= 8) {
+		if (rgbTdi == NULL) {
+			w = wFill;
+		}
+		else {
+			ib = ibit / 8;
+			cbitShift = ibit % 8;
+			w = rgbTdi[ib];
+			if (cbitShift != 0) {
+				w = (w >> cbitShift) | (rgbTdi[ib + 1] << (8 - cbitShift));
+			}
+			w = WSeqSpread((BYTE) w);
+		}
+		rgbPair[cclk / 4] = (BYTE) w;
+		rgbPair[cclk / 4 + 1] = (BYTE) (w >> 8);
+		cclk += 8;
+		ibit += 8;
+	}
+
+	while (ibit < cbit) {
+		PutClock(fLast && (ibit == cbit - 1),
+			(rgbTdi != NULL) ? (rgbTdi[ibit / 8] >> (ibit % 8)) & 1 : fFill);
+		ibit++;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	WSeqSpread
+**
+**	Parameters:
+**		b		- eight TDI bits
+**
+**	Return Value:
+**		the bits spread to the even bits of a word
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes four bytes of bit pairs, TMS low, from eight TDI bits.
+*/
+
+static WORD WSeqSpread(BYTE b) {
+
+	DWORD	dw;
+
+	dw = b;
+	dw = (dw | (dw << 4)) & 0x0F0F;
+	dw = (dw | (dw << 2)) & 0x3333;
+	dw = (dw | (dw << 1)) & 0x5555;
+
+	return (WORD) dw;
+}
+
+/************************************************************************/
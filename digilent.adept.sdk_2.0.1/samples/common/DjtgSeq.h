@@ -0,0 +1,177 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgSeq.h  --  JTAG Sequence Compiler Declarations					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DjtgSeq records JTAG operations, instruction and data			*/
+/*		register scans, TAP state moves and idle clocks, and compiles	*/
+/*		them into one buffer of TMS/TDI bit pairs. FExecute sends the	*/
+/*		buffer with as few DjtgPutTmsTdiBits calls as the call size		*/
+/*		allows, usually one, instead of the several tiny				*/
+/*		DjtgPutTmsBits, DjtgPutTdiBits and DjtgClockTck calls each		*/
+/*		operation would otherwise take. Each call is a USB round trip,	*/
+/*		so a sequence of hundreds of operations runs in the time of a	*/
+/*		few.															*/
+/*																		*/
+/*		The sequence tracks the TAP controller state as it records,		*/
+/*		so state moves take the fewest TMS clocks. A scan goes			*/
+/*		through its Capture state, shifts its bits with TMS high on		*/
+/*		the last one, and ends in the end state set for its register,	*/
+/*		Run-Test/Idle by default. Scans of one device of a chain are	*/
+/*		padded with the bits of the others, set by SetPad: ones for		*/
+/*		instruction registers, which selects BYPASS, and zeros for		*/
+/*		the BYPASS registers.											*/
+/*																		*/
+/*		A scan can ask for its TDO bits. It is then given their			*/
+/*		offset in the TDO of the sequence, and after FExecute			*/
+/*		FGetTdo or DwGetTdo slice them out. TDO is only read back		*/
+/*		when some scan asked for it.									*/
+/*																		*/
+/*			DjtgSeq		seq;											*/
+/*			DWORD		ibitId;											*/
+/*																		*/
+/*			seq.FInit(hif, 0);											*/
+/*			seq.FReset();												*/
+/*			seq.FScanIr(rgbInstr, 14, NULL);							*/
+/*			seq.FScanDr(rgbData, 64, &ibitId);							*/
+/*			seq.FIdle(100);												*/
+/*			seq.FExecute();					// one round trip			*/
+/*			idcode = seq.DwGetTdo(ibitId, 32);							*/
+/*			seq.Free();													*/
+/*																		*/
+/*		FExecute starts a new sequence; the TDO of the last one stays	*/
+/*		readable until the next FExecute. A sequence is used from one	*/
+/*		thread.															*/
+/*																		*/
+/*		A flow that shifts a long register with DJTG calls of its own,	*/
+/*		such as a bitstream, calls FSetState afterwards with the state	*/
+/*		it left the chain in and goes on recording from there.			*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: added FSetState											*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DJTGSEQ_INCLUDED)
+#define      DJTGSEQ_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* TAP controller states. stJtgUnknown is the state of the chain before
+** the first reset and after a failed FExecute.
+*/
+const int		stJtgUnknown	= -1;
+const int		stJtgReset		= 0;	// Test-Logic-Reset
+const int		stJtgIdle		= 1;	// Run-Test/Idle
+const int		stJtgSelDr		= 2;
+const int		stJtgCapDr		= 3;
+const int		stJtgShfDr		= 4;
+const int		stJtgEx1Dr		= 5;
+const int		stJtgPauDr		= 6;
+const int		stJtgEx2Dr		= 7;
+const int		stJtgUpdDr		= 8;
+const int		stJtgSelIr		= 9;
+const int		stJtgCapIr		= 10;
+const int		stJtgShfIr		= 11;
+const int		stJtgEx1Ir		= 12;
+const int		stJtgPauIr		= 13;
+const int		stJtgEx2Ir		= 14;
+const int		stJtgUpdIr		= 15;
+const int		cstJtg			= 16;
+
+/* Default longest DjtgPutTmsTdiBits call, in clocks: 256 KB of bit
+** pairs.
+*/
+const DWORD		cclkSeqCallDefault	= 1048576;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Statistics of a sequence.
+*/
+typedef struct tagSEQSTAT {
+	DWORD		cprog;				// sequences executed
+	DWORD		ccall;				// DjtgPutTmsTdiBits calls
+	unsigned long long	cclk;		// clocks sent
+	DWORD		cscan;				// scans recorded
+	DWORD		cmove;				// resets, state moves and idle runs
+	DWORD		cscanTdo;			// scans that read TDO
+} SEQSTAT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DjtgSeq {
+
+private:
+	HIF			hif;
+	BOOL		fInit;
+	DWORD		cclkCallMax;
+
+	int			stCur;				// state at the end of the sequence
+	int			stEndIr;
+	int			stEndDr;
+	DWORD		cbitIrPre;			// pad bits between TDI and the device
+	DWORD		cbitIrPost;			// pad bits between the device and TDO
+	DWORD		cbitDrPre;
+	DWORD		cbitDrPost;
+
+	BYTE *		rgbPair;			// TMS/TDI bit pairs recorded
+	DWORD		cclk;
+	DWORD		cclkAlloc;
+	BOOL		fTdo;				// a scan asked for TDO
+
+	BYTE *		rgbTdo;				// TDO of the last sequence executed
+	DWORD		cclkTdo;
+	DWORD		cbTdoAlloc;
+
+	SEQSTAT		stat;
+
+	BOOL	FReserve(DWORD cclkAdd);
+	void	PutClock(BOOL fTms, BOOL fTdi);
+	void	PutPath(int st);
+	void	PutShift(const BYTE * rgbTdi, DWORD cbit, BOOL fFill, BOOL fLast);
+	BOOL	FScan(BOOL fIr, const BYTE * rgbTdi, DWORD cbit, DWORD * pibitTdo);
+
+public:
+	DjtgSeq();
+
+	BOOL	FInit(HIF hifInit, DWORD cclkCallMaxInit);
+	BOOL	FSetEndState(int stEndIrSet, int stEndDrSet);
+	void	SetPad(DWORD cbitIrPreSet, DWORD cbitIrPostSet, DWORD cbitDrPreSet, DWORD cbitDrPostSet);
+
+	BOOL	FReset();
+	BOOL	FMove(int st);
+	BOOL	FSetState(int st);
+	BOOL	FIdle(DWORD cclkIdle);
+	BOOL	FScanIr(const BYTE * rgbTdi, DWORD cbit, DWORD * pibitTdo);
+	BOOL	FScanDr(const BYTE * rgbTdi, DWORD cbit, DWORD * pibitTdo);
+
+	BOOL	FExecute();
+	BOOL	FGetTdo(DWORD ibit, DWORD cbit, BYTE * rgb);
+	DWORD	DwGetTdo(DWORD ibit, DWORD cbit);
+
+	DWORD	CclkPending();
+	int		StCur();
+	void	GetStat(SEQSTAT * pstat);
+	void	Free();
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// DJTGSEQ_INCLUDED
+
+/************************************************************************/
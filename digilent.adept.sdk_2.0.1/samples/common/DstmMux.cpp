@@ -0,0 +1,1006 @@
+/************************************************************************/
+/*																		*/
+/*  DstmMux.cpp  --  DSTM Channel Multiplexer							*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DstmMux class. See DstmMux.h.		*/
+/*																		*/
+/*		The producer callback of the stream packs the download			*/
+/*		buffers: credit frames first, then one data frame for each		*/
+/*		channel with queued data and credit, taking all it can, in		*/
+/*		round robin order from buffer to buffer. It blocks until there	*/
+/*		is something to send. The consumer callback parses the upload	*/
+/*		buffers a byte at a time only between frames; payload is		*/
+/*		copied to the receive queues in runs.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "DstmMux.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Limits of the queue size, and the smallest buffer that holds a
+** frame header and some payload.
+*/
+const DWORD		cbMuxQueueMin	= 256;
+const DWORD		cbMuxQueueMax	= 16 * 1024 * 1024;
+const DWORD		cbMuxBufMin		= 64;
+
+/* The producer rechecks the stream this often while it waits, so
+** that it ends when the stream ends on an error.
+*/
+const long		tnsMuxPoll		= 10 * 1000 * 1000;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static DWORD	CbQueued(MUXQ * pq);
+static DWORD	CbQueueFree(MUXQ * pq);
+static void		QueuePut(MUXQ * pq, const BYTE * rgb, DWORD cb);
+static void		QueueGet(MUXQ * pq, BYTE * rgb, DWORD cb);
+static void		DeadlineAfter(struct timespec * pts, long long tns);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DstmMux::DstmMux
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The multiplexer must be initialized with FInit
+**		before it is used.
+*/
+
+DstmMux::DstmMux() {
+
+	cchan = 0;
+	fInit = fFalse;
+	fStop = fFalse;
+	memset(rgqTx, 0, sizeof(rgqTx));
+	memset(rgqRx, 0, sizeof(rgqRx));
+	memset(&stat, 0, sizeof(stat));
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FInit
+**
+**	Parameters:
+**		hif			- open interface handle with DSTM enabled
+**		cchanInit	- number of channels, 1 to cchanMuxMax
+**		cbQueue		- size of each channel queue, rounded up to a
+**					  power of 2
+**		cbBuf		- bytes per read and largest download buffer
+**		cbuf		- buffers in each ring of the stream
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates the stream and the channel queues. The receive
+**		queues are granted to the design in the first transfer.
+*/
+
+BOOL DstmMux::FInit(HIF hif, DWORD cchanInit, DWORD cbQueue, DWORD cbBuf, DWORD cbuf) {
+
+	DWORD	cbQ;
+	DWORD	ichan;
+
+	if (fInit || (cchanInit == 0) || (cchanInit > cchanMuxMax) ||
+		(cbQueue > cbMuxQueueMax) || (cbBuf < cbMuxBufMin)) {
+		return fFalse;
+	}
+
+	for (cbQ = cbMuxQueueMin; cbQ < cbQueue; cbQ *= 2);
+
+	if (!stm.FInit(hif, cbBuf, cbuf)) {
+		return fFalse;
+	}
+
+	stm.SetConsumer(FConsume, this);
+	if (!stm.FSetProducer(CbProduce, this, fFalse)) {
+		stm.Free();
+		return fFalse;
+	}
+
+	cchan = cchanInit;
+	for (ichan = 0; ichan < cchan; ichan++) {
+		rgqTx[ichan].rgb = (BYTE *) malloc(cbQ);
+		rgqTx[ichan].cb = cbQ;
+		rgqTx[ichan].ibHead = 0;
+		rgqTx[ichan].ibTail = 0;
+		rgqRx[ichan].rgb = (BYTE *) malloc(cbQ);
+		rgqRx[ichan].cb = cbQ;
+		rgqRx[ichan].ibHead = 0;
+		rgqRx[ichan].ibTail = 0;
+
+		rgcbCreditTx[ichan] = 0;
+		rgcbGrant[ichan] = cbQ;
+		rgseqTx[ichan] = 0;
+		rgseqRx[ichan] = 0;
+	}
+
+	/* Credit is returned in pieces of a quarter queue, so that
+	** reading a few bytes does not cost a frame.
+	*/
+	cbGrantMin = cbQ / 4;
+
+	ichanNext = 0;
+	cbHdr = 0;
+	cbPayload = 0;
+	ichanPayload = 0;
+	fDropPayload = fFalse;
+	genApp = 0;
+	fStop = fFalse;
+	memset(&stat, 0, sizeof(stat));
+
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&condWork, NULL);
+	pthread_cond_init(&condApp, NULL);
+
+	fInit = fTrue;
+
+	for (ichan = 0; ichan < cchan; ichan++) {
+		if ((rgqTx[ichan].rgb == NULL) || (rgqRx[ichan].rgb == NULL)) {
+			Free();
+			return fFalse;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FStart
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the stream was started, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts the stream. It runs until Stop is called.
+*/
+
+BOOL DstmMux::FStart() {
+
+	if (!fInit) {
+		return fFalse;
+	}
+
+	return stm.FStart(0);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::Stop
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Ends the stream. Data still queued is not sent. Call FWait
+**		to wait for the stream threads.
+*/
+
+void DstmMux::Stop() {
+
+	if (!fInit) {
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	fStop = fTrue;
+	pthread_cond_broadcast(&condWork);
+	pthread_cond_broadcast(&condApp);
+	pthread_mutex_unlock(&mtx);
+
+	stm.Stop();
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FWait
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the stream ended without a transfer error
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits for the stream threads to end.
+*/
+
+BOOL DstmMux::FWait() {
+
+	if (!fInit) {
+		return fFalse;
+	}
+
+	return stm.FWait();
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stops the stream and frees the queues.
+*/
+
+void DstmMux::Free() {
+
+	DWORD	ichan;
+
+	if (!fInit) {
+		return;
+	}
+
+	Stop();
+	stm.FWait();
+	stm.Free();
+
+	for (ichan = 0; ichan < cchan; ichan++) {
+		free(rgqTx[ichan].rgb);
+		free(rgqRx[ichan].rgb);
+		rgqTx[ichan].rgb = NULL;
+		rgqRx[ichan].rgb = NULL;
+	}
+
+	pthread_cond_destroy(&condApp);
+	pthread_cond_destroy(&condWork);
+	pthread_mutex_destroy(&mtx);
+
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::CbWrite
+**
+**	Parameters:
+**		ichan		- channel
+**		rgb			- data to send
+**		cb			- number of bytes
+**
+**	Return Value:
+**		number of bytes queued
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Queues as much of the data as the transmit queue of the
+**		channel has room for, and returns without waiting. Writes
+**		made before the producer next runs go out in the same
+**		transfer.
+*/
+
+DWORD DstmMux::CbWrite(DWORD ichan, const BYTE * rgb, DWORD cb) {
+
+	MUXQ *	pq;
+
+	if (!fInit || (ichan >= cchan)) {
+		return 0;
+	}
+
+	pq = &rgqTx[ichan];
+	if (cb > CbQueueFree(pq)) {
+		cb = CbQueueFree(pq);
+	}
+	if (cb == 0) {
+		return 0;
+	}
+
+	QueuePut(pq, rgb, cb);
+
+	pthread_mutex_lock(&mtx);
+	pthread_cond_signal(&condWork);
+	pthread_mutex_unlock(&mtx);
+
+	return cb;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::CbRead
+**
+**	Parameters:
+**		ichan		- channel
+**		rgb			- buffer to receive the data
+**		cbMax		- size of the buffer
+**
+**	Return Value:
+**		number of bytes read
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Takes the data received on a channel, up to cbMax bytes,
+**		without waiting. The room freed is granted back to the design
+**		once a quarter of the queue is free.
+*/
+
+DWORD DstmMux::CbRead(DWORD ichan, BYTE * rgb, DWORD cbMax) {
+
+	MUXQ *	pq;
+	DWORD	cb;
+	DWORD	cbGrant;
+
+	if (!fInit || (ichan >= cchan)) {
+		return 0;
+	}
+
+	pq = &rgqRx[ichan];
+	cb = CbQueued(pq);
+	if (cb > cbMax) {
+		cb = cbMax;
+	}
+	if (cb == 0) {
+		return 0;
+	}
+
+	QueueGet(pq, rgb, cb);
+
+	cbGrant = __atomic_add_fetch(&rgcbGrant[ichan], cb, __ATOMIC_ACQ_REL);
+	if ((cbGrant >= cbGrantMin) && (cbGrant - cb < cbGrantMin)) {
+		pthread_mutex_lock(&mtx);
+		pthread_cond_signal(&condWork);
+		pthread_mutex_unlock(&mtx);
+	}
+
+	return cb;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::CbWritable, DstmMux::CbReadable
+**
+**	Parameters:
+**		ichan		- channel
+**
+**	Return Value:
+**		free bytes of the transmit queue, or bytes waiting in the
+**		receive queue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Return the state of the queues of a channel.
+*/
+
+DWORD DstmMux::CbWritable(DWORD ichan) {
+
+	if (!fInit || (ichan >= cchan)) {
+		return 0;
+	}
+
+	return CbQueueFree(&rgqTx[ichan]);
+}
+
+DWORD DstmMux::CbReadable(DWORD ichan) {
+
+	if (!fInit || (ichan >= cchan)) {
+		return 0;
+	}
+
+	return CbQueued(&rgqRx[ichan]);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FWaitApp
+**
+**	Parameters:
+**		pgenApp		- generation seen by the caller, updated
+**		tms			- longest wait in ms
+**
+**	Return Value:
+**		fTrue if the queues have changed, fFalse on timeout or if
+**		the multiplexer was stopped
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the stream threads have moved data through any
+**		queue since the generation *pgenApp. A caller that starts
+**		with *pgenApp at 0 and passes the same variable each time
+**		does not miss a change made between its checks of the
+**		queues and the wait.
+*/
+
+BOOL DstmMux::FWaitApp(DWORD * pgenApp, DWORD tms) {
+
+	struct timespec	ts;
+	BOOL	fChanged;
+
+	if (!fInit) {
+		return fFalse;
+	}
+
+	DeadlineAfter(&ts, tms * 1000000LL);
+
+	pthread_mutex_lock(&mtx);
+	while ((genApp == *pgenApp) && !fStop) {
+		if (pthread_cond_timedwait(&condApp, &mtx, &ts) == ETIMEDOUT) {
+			break;
+		}
+	}
+	fChanged = (genApp != *pgenApp);
+	*pgenApp = genApp;
+	pthread_mutex_unlock(&mtx);
+
+	return fChanged && !fStop;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FRunning
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue while the stream runs
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The stream ends when Stop is called or a transfer fails.
+*/
+
+BOOL DstmMux::FRunning() {
+
+	return fInit && !fStop && !stm.FStopped();
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::GetStat
+**
+**	Parameters:
+**		pstat		- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the frame statistics. The stream statistics are
+**		returned by GetStreamStat.
+*/
+
+void DstmMux::GetStat(MUXSTAT * pstat) {
+
+	if (!fInit) {
+		memset(pstat, 0, sizeof(*pstat));
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	*pstat = stat;
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::CbProduce
+**
+**	Parameters:
+**		pvMux		- the DstmMux
+**		rgb			- download buffer to fill
+**		cbMax		- size of the buffer
+**		ibStream	- download stream offset of rgb[0]
+**
+**	Return Value:
+**		number of bytes placed in rgb, 0 to end the download stream
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Producer callback of the stream. Waits until there is data
+**		that the design has credit for, or room to grant, then packs
+**		a buffer.
+*/
+
+DWORD DstmMux::CbProduce(void * pvMux, BYTE * rgb, DWORD cbMax, long long ibStream) {
+
+	DstmMux *	pmux = (DstmMux *) pvMux;
+	struct timespec	ts;
+
+	(void) ibStream;
+
+	pthread_mutex_lock(&pmux->mtx);
+	while (!pmux->fStop && !pmux->stm.FStopped() && !pmux->FWork()) {
+		DeadlineAfter(&ts, tnsMuxPoll);
+		pthread_cond_timedwait(&pmux->condWork, &pmux->mtx, &ts);
+	}
+	pthread_mutex_unlock(&pmux->mtx);
+
+	if (pmux->fStop || pmux->stm.FStopped()) {
+		return 0;
+	}
+
+	return pmux->CbPack(rgb, cbMax);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FWork
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the producer has something to send
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called with mtx held, which orders it with the signals of
+**		the writers, readers and consumer thread.
+*/
+
+BOOL DstmMux::FWork() {
+
+	DWORD	ichan;
+
+	for (ichan = 0; ichan < cchan; ichan++) {
+		if (__atomic_load_n(&rgcbGrant[ichan], __ATOMIC_ACQUIRE) >= cbGrantMin) {
+			return fTrue;
+		}
+		if ((CbQueued(&rgqTx[ichan]) > 0) &&
+			(__atomic_load_n(&rgcbCreditTx[ichan], __ATOMIC_ACQUIRE) > 0)) {
+			return fTrue;
+		}
+	}
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::CbPack
+**
+**	Parameters:
+**		rgb			- download buffer to fill
+**		cbMax		- size of the buffer
+**
+**	Return Value:
+**		number of bytes placed in rgb
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Packs credit frames for the room freed in the receive queues,
+**		then a data frame for each channel, as large as its queue,
+**		its credit and the buffer allow.
+*/
+
+DWORD DstmMux::CbPack(BYTE * rgb, DWORD cbMax) {
+
+	MUXSTAT	statPack;
+	DWORD	ib;
+	DWORD	ichan;
+	DWORD	ichanRR;
+	DWORD	cbGrant;
+	DWORD	cb;
+	DWORD	cbCredit;
+
+	memset(&statPack, 0, sizeof(statPack));
+	ib = 0;
+
+	for (ichan = 0; ichan < cchan; ichan++) {
+		cbGrant = __atomic_load_n(&rgcbGrant[ichan], __ATOMIC_ACQUIRE);
+		if (cbGrant < cbGrantMin) {
+			continue;
+		}
+
+		while ((cbGrant > 0) && (ib + cbMuxHdr <= cbMax)) {
+			cb = (cbGrant < cbMuxLenMax) ? cbGrant : cbMuxLenMax;
+			rgb[ib] = tmuxCredit | (BYTE) ichan;
+			rgb[ib + 1] = 0;
+			rgb[ib + 2] = (BYTE) cb;
+			rgb[ib + 3] = (BYTE) (cb >> 8);
+			ib += cbMuxHdr;
+			cbGrant -= cb;
+			__atomic_sub_fetch(&rgcbGrant[ichan], cb, __ATOMIC_ACQ_REL);
+			statPack.ccreditOut++;
+		}
+	}
+
+	for (ichanRR = 0; ichanRR < cchan; ichanRR++) {
+		if (ib + cbMuxHdr >= cbMax) {
+			break;
+		}
+
+		ichan = (ichanNext + ichanRR) % cchan;
+
+		cb = CbQueued(&rgqTx[ichan]);
+		cbCredit = __atomic_load_n(&rgcbCreditTx[ichan], __ATOMIC_ACQUIRE);
+		if (cb > cbCredit) {
+			cb = cbCredit;
+		}
+		if (cb > cbMuxLenMax) {
+			cb = cbMuxLenMax;
+		}
+		if (cb > cbMax - ib - cbMuxHdr) {
+			cb = cbMax - ib - cbMuxHdr;
+		}
+		if (cb == 0) {
+			continue;
+		}
+
+		rgb[ib] = tmuxData | (BYTE) ichan;
+		rgb[ib + 1] = rgseqTx[ichan]++;
+		rgb[ib + 2] = (BYTE) cb;
+		rgb[ib + 3] = (BYTE) (cb >> 8);
+		ib += cbMuxHdr;
+
+		QueueGet(&rgqTx[ichan], &rgb[ib], cb);
+		ib += cb;
+
+		__atomic_sub_fetch(&rgcbCreditTx[ichan], cb, __ATOMIC_ACQ_REL);
+		statPack.cframeOut++;
+		statPack.cbOut += cb;
+	}
+
+	ichanNext = (ichanNext + 1) % cchan;
+	statPack.cbufOut = 1;
+
+	Notify(fFalse, &statPack);
+
+	return ib;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::FConsume
+**
+**	Parameters:
+**		pvMux		- the DstmMux
+**		rgb			- upload data
+**		cb			- number of bytes
+**		ibStream	- upload stream offset of rgb[0]
+**
+**	Return Value:
+**		fTrue to continue the stream
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Consumer callback of the stream. Splits the upload data into
+**		frames, skipping idle bytes, and delivers the payload of data
+**		frames to the receive queues. Headers and payload may be split
+**		across buffers.
+*/
+
+BOOL DstmMux::FConsume(void * pvMux, const BYTE * rgb, DWORD cb, long long ibStream) {
+
+	DstmMux *	pmux = (DstmMux *) pvMux;
+	MUXSTAT		statParse;
+	DWORD		ib;
+	DWORD		cbRun;
+	DWORD		ccreditIn;
+
+	(void) ibStream;
+
+	memset(&statParse, 0, sizeof(statParse));
+	ib = 0;
+
+	while (ib < cb) {
+		if (pmux->cbPayload > 0) {
+			cbRun = (pmux->cbPayload < cb - ib) ? pmux->cbPayload : cb - ib;
+			if (!pmux->fDropPayload) {
+				QueuePut(&pmux->rgqRx[pmux->ichanPayload], &rgb[ib], cbRun);
+			}
+			ib += cbRun;
+			pmux->cbPayload -= cbRun;
+			continue;
+		}
+
+		if ((pmux->cbHdr == 0) && (rgb[ib] == bMuxIdle)) {
+			ib++;
+			statParse.cbIdleIn++;
+			continue;
+		}
+
+		pmux->rgbHdr[pmux->cbHdr++] = rgb[ib++];
+		if (pmux->cbHdr == cbMuxHdr) {
+			pmux->cbHdr = 0;
+			pmux->Frame(&statParse);
+		}
+	}
+
+	ccreditIn = statParse.ccreditIn;
+	if ((statParse.cbIn > 0) || (ccreditIn > 0) || (statParse.cerrProto > 0) || (statParse.cbIdleIn > 0)) {
+		pmux->Notify(ccreditIn > 0, &statParse);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::Frame
+**
+**	Parameters:
+**		pstat		- statistics of the buffer being parsed
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Counts malformed frames, sequence errors and payload beyond
+**		the credit granted as protocol errors.
+**
+**	Description:
+**		Acts on a complete frame header in rgbHdr. Payload that has
+**		nowhere to go is skipped so that the framing is kept.
+*/
+
+void DstmMux::Frame(MUXSTAT * pstat) {
+
+	BYTE	tmux;
+	DWORD	ichan;
+	DWORD	cb;
+
+	tmux = rgbHdr[0] & 0xF0;
+	ichan = rgbHdr[0] & 0x0F;
+	cb = rgbHdr[2] | ((DWORD) rgbHdr[3] << 8);
+
+	if (tmux == tmuxData) {
+		cbPayload = cb;
+		ichanPayload = ichan;
+		fDropPayload = fTrue;
+
+		if ((ichan >= cchan) || (cb > CbQueueFree(&rgqRx[ichan]))) {
+			pstat->cerrProto++;
+			return;
+		}
+
+		if (rgbHdr[1] != rgseqRx[ichan]) {
+			pstat->cerrProto++;
+		}
+		rgseqRx[ichan] = rgbHdr[1] + 1;
+
+		fDropPayload = fFalse;
+		pstat->cframeIn++;
+		pstat->cbIn += cb;
+	}
+	else if (tmux == tmuxCredit) {
+		/* The design may have more channels than are in use; their
+		** credit is not needed.
+		*/
+		if (ichan < cchan) {
+			__atomic_add_fetch(&rgcbCreditTx[ichan], cb, __ATOMIC_ACQ_REL);
+		}
+		pstat->ccreditIn++;
+	}
+	else {
+		pstat->cerrProto++;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmMux::Notify
+**
+**	Parameters:
+**		fWork		- fTrue to wake the producer
+**		pstat		- counts to add to the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called by the stream threads after each buffer. Adds to the
+**		statistics and wakes the application, and the producer when
+**		credit has arrived.
+*/
+
+void DstmMux::Notify(BOOL fWork, const MUXSTAT * pstat) {
+
+	pthread_mutex_lock(&mtx);
+
+	stat.cbOut += pstat->cbOut;
+	stat.cbIn += pstat->cbIn;
+	stat.cframeOut += pstat->cframeOut;
+	stat.cframeIn += pstat->cframeIn;
+	stat.ccreditOut += pstat->ccreditOut;
+	stat.ccreditIn += pstat->ccreditIn;
+	stat.cbufOut += pstat->cbufOut;
+	stat.cbIdleIn += pstat->cbIdleIn;
+	stat.cerrProto += pstat->cerrProto;
+
+	if ((pstat->cbOut > 0) || (pstat->cbIn > 0)) {
+		genApp++;
+		pthread_cond_broadcast(&condApp);
+	}
+	if (fWork) {
+		pthread_cond_signal(&condWork);
+	}
+
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	CbQueued, CbQueueFree
+**
+**	Parameters:
+**		pq			- queue
+**
+**	Return Value:
+**		bytes in the queue, or room left in it
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Either side of a queue may call these. The value may grow,
+**		for CbQueued on the consumer side and for CbQueueFree on the
+**		producer side, but never shrinks under the caller.
+*/
+
+static DWORD CbQueued(MUXQ * pq) {
+
+	return __atomic_load_n(&pq->ibTail, __ATOMIC_ACQUIRE) - __atomic_load_n(&pq->ibHead, __ATOMIC_ACQUIRE);
+}
+
+static DWORD CbQueueFree(MUXQ * pq) {
+
+	return pq->cb - CbQueued(pq);
+}
+
+/* ------------------------------------------------------------ */
+/***	QueuePut
+**
+**	Parameters:
+**		pq			- queue
+**		rgb			- data
+**		cb			- number of bytes, at most CbQueueFree
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Adds data to a queue. Called by the producer side only. The
+**		data is copied before the tail is published.
+*/
+
+static void QueuePut(MUXQ * pq, const BYTE * rgb, DWORD cb) {
+
+	DWORD	ibTail;
+	DWORD	ibQ;
+	DWORD	cbRun;
+
+	ibTail = pq->ibTail;
+	ibQ = ibTail & (pq->cb - 1);
+	cbRun = (cb < pq->cb - ibQ) ? cb : pq->cb - ibQ;
+
+	memcpy(&pq->rgb[ibQ], rgb, cbRun);
+	memcpy(&pq->rgb[0], rgb + cbRun, cb - cbRun);
+
+	__atomic_store_n(&pq->ibTail, ibTail + cb, __ATOMIC_RELEASE);
+}
+
+/* ------------------------------------------------------------ */
+/***	QueueGet
+**
+**	Parameters:
+**		pq			- queue
+**		rgb			- buffer to receive the data
+**		cb			- number of bytes, at most CbQueued
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Takes data from a queue. Called by the consumer side only.
+**		The data is copied before the room is released.
+*/
+
+static void QueueGet(MUXQ * pq, BYTE * rgb, DWORD cb) {
+
+	DWORD	ibHead;
+	DWORD	ibQ;
+	DWORD	cbRun;
+
+	ibHead = pq->ibHead;
+	ibQ = ibHead & (pq->cb - 1);
+	cbRun = (cb < pq->cb - ibQ) ? cb : pq->cb - ibQ;
+
+	memcpy(rgb, &pq->rgb[ibQ], cbRun);
+	memcpy(rgb + cbRun, &pq->rgb[0], cb - cbRun);
+
+	__atomic_store_n(&pq->ibHead, ibHead + cb, __ATOMIC_RELEASE);
+}
+
+/* ------------------------------------------------------------ */
+/***	DeadlineAfter
+**
+**	Parameters:
+**		pts			- variable to receive the deadline
+**		tns			- nanoseconds from now
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Computes a deadline for pthread_cond_timedwait, which uses
+**		CLOCK_REALTIME.
+*/
+
+static void DeadlineAfter(struct timespec * pts, long long tns) {
+
+	clock_gettime(CLOCK_REALTIME, pts);
+
+	tns += pts->tv_nsec;
+	pts->tv_sec += (time_t) (tns / 1000000000LL);
+	pts->tv_nsec = (long) (tns % 1000000000LL);
+}
+
+/************************************************************************/
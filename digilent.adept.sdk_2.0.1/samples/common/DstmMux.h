@@ -0,0 +1,190 @@
+/************************************************************************/
+/*																		*/
+/*  DstmMux.h  --  DSTM Channel Multiplexer Declarations				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DstmMux carries up to cchanMuxMax independent byte streams	*/
+/*		in each direction over the single DSTM port of a device. Only	*/
+/*		one protocol port can be enabled per interface handle, so the	*/
+/*		channels share one full duplex DstmStream: each download		*/
+/*		buffer is packed with frames from every channel that has data,	*/
+/*		and each upload buffer is split back into frames and their		*/
+/*		payload delivered to the channels. Many small writes on many	*/
+/*		channels therefore cost one USB transfer between them.			*/
+/*																		*/
+/*		A frame is a 4 byte header followed by its payload:				*/
+/*																		*/
+/*			byte 0	- frame type (high nibble) and channel (low nibble)	*/
+/*			byte 1	- sequence number of data frames on the channel		*/
+/*			byte 2	- length, low byte									*/
+/*			byte 3	- length, high byte									*/
+/*																		*/
+/*		A data frame carries length bytes of payload. A credit frame	*/
+/*		has no payload: it allows the other side to send length more	*/
+/*		bytes of payload on the channel. A 0x00 byte between frames is	*/
+/*		an idle byte and is skipped; the design sends idle bytes when	*/
+/*		it has nothing to send, since every upload byte the host asks	*/
+/*		for must be supplied.											*/
+/*																		*/
+/*		Flow control is by credit, per channel and per direction.		*/
+/*		Neither side sends more payload than the other has room for,	*/
+/*		so a channel whose reader falls behind holds up only its own	*/
+/*		data, never the link or the other channels. The design grants	*/
+/*		the size of its channel buffers when it is reset; the host		*/
+/*		grants the size of its receive queues in its first transfer.	*/
+/*																		*/
+/*		Each channel has a transmit and a receive queue. Each queue is	*/
+/*		lock free with a single producer and a single consumer: one		*/
+/*		application thread may write a channel and one may read it,		*/
+/*		while the stream threads take the other ends.					*/
+/*																		*/
+/*		The reference design is samples/dstm/DstmDemo/logic/Mux.vhd,	*/
+/*		which loops each channel back, and the Adept simulator models	*/
+/*		it (ADEPT_SIM_STM_DESIGN=mux).									*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DSTMMUX_INCLUDED)
+#define      DSTMMUX_INCLUDED
+
+#include <pthread.h>
+
+#include "dpcdecl.h"
+#include "DstmStream.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Frame format.
+*/
+const DWORD		cchanMuxMax		= 16;		// channel is 4 bits
+const DWORD		cbMuxHdr		= 4;
+const DWORD		cbMuxLenMax		= 0xFFFF;
+const BYTE		bMuxIdle		= 0x00;
+const BYTE		tmuxData		= 0x10;		// frame types, byte 0 & 0xF0
+const BYTE		tmuxCredit		= 0x20;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* A single producer, single consumer byte queue. ibHead counts the
+** bytes taken and ibTail the bytes added; each is written by one
+** side only. cb is a power of 2.
+*/
+typedef struct tagMUXQ {
+	BYTE *		rgb;
+	DWORD		cb;
+	DWORD		ibHead;
+	DWORD		ibTail;
+} MUXQ;
+
+/* Statistics of the multiplexer.
+*/
+typedef struct tagMUXSTAT {
+	long long	cbOut;				// payload bytes sent
+	long long	cbIn;				// payload bytes received
+	DWORD		cframeOut;			// data frames sent
+	DWORD		cframeIn;			// data frames received
+	DWORD		ccreditOut;			// credit frames sent
+	DWORD		ccreditIn;			// credit frames received
+	DWORD		cbufOut;			// download buffers filled
+	long long	cbIdleIn;			// idle bytes received
+	DWORD		cerrProto;			// malformed frames, sequence errors
+									// and credit violations
+} MUXSTAT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DstmMux {
+
+private:
+	DstmStream	stm;
+	DWORD		cchan;
+	BOOL		fInit;
+
+	MUXQ		rgqTx[cchanMuxMax];
+	MUXQ		rgqRx[cchanMuxMax];
+
+	/* Credits. rgcbCreditTx is what the design can still take on
+	** each channel; it is raised by the consumer thread and lowered
+	** by the producer thread. rgcbGrant is room freed in the receive
+	** queue and not yet granted; it is raised by the readers and
+	** lowered by the producer thread.
+	*/
+	DWORD		rgcbCreditTx[cchanMuxMax];
+	DWORD		rgcbGrant[cchanMuxMax];
+	DWORD		cbGrantMin;
+
+	BYTE		rgseqTx[cchanMuxMax];
+	BYTE		rgseqRx[cchanMuxMax];
+	DWORD		ichanNext;			// round robin start of the producer
+
+	/* Frame being parsed by the consumer thread. Frames may span
+	** upload buffers.
+	*/
+	BYTE		rgbHdr[cbMuxHdr];
+	DWORD		cbHdr;				// header bytes received
+	DWORD		cbPayload;			// payload bytes still to come
+	DWORD		ichanPayload;
+	BOOL		fDropPayload;
+
+	/* The producer thread waits on condWork for data or room to
+	** grant. The application waits on condApp for genApp, which the
+	** stream threads advance whenever they move data through the
+	** queues.
+	*/
+	pthread_mutex_t	mtx;
+	pthread_cond_t	condWork;
+	pthread_cond_t	condApp;
+	DWORD		genApp;
+	volatile BOOL	fStop;
+
+	MUXSTAT		stat;
+
+	static BOOL		FConsume(void * pvMux, const BYTE * rgb, DWORD cb, long long ibStream);
+	static DWORD	CbProduce(void * pvMux, BYTE * rgb, DWORD cbMax, long long ibStream);
+
+	BOOL	FWork();
+	DWORD	CbPack(BYTE * rgb, DWORD cbMax);
+	void	Frame(MUXSTAT * pstat);
+	void	Notify(BOOL fWork, const MUXSTAT * pstat);
+
+public:
+	DstmMux();
+
+	BOOL	FInit(HIF hif, DWORD cchanInit, DWORD cbQueue, DWORD cbBuf, DWORD cbuf);
+	BOOL	FStart();
+	void	Stop();
+	BOOL	FWait();
+	void	Free();
+
+	DWORD	CbWrite(DWORD ichan, const BYTE * rgb, DWORD cb);
+	DWORD	CbRead(DWORD ichan, BYTE * rgb, DWORD cbMax);
+	DWORD	CbWritable(DWORD ichan);
+	DWORD	CbReadable(DWORD ichan);
+	BOOL	FWaitApp(DWORD * pgenApp, DWORD tms);
+	BOOL	FRunning();
+
+	void	GetStat(MUXSTAT * pstat);
+	void	GetStreamStat(STMSTAT * pstat)	{ stm.GetStat(pstat); }
+	DWORD	Cchan()			{ return cchan; }
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// DSTMMUX_INCLUDED
+
+/************************************************************************/
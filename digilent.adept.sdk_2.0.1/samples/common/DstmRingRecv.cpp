@@ -0,0 +1,500 @@
+/************************************************************************/
+/*																		*/
+/*  DstmRingRecv.cpp  --  Zero Copy DSTM Receiver						*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Reads the DSTM port into the slots of a stream ring. See		*/
+/*		DstmRingRecv.h.													*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "dstm.h"
+#include "DstmRingRecv.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Longest wait for a free slot before fStop is checked again.
+*/
+const DWORD		tmsRingPoll		= 100;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static double	DblRingTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::DstmRingRecv
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The receiver must be initialized with FInit
+**		before it is used.
+*/
+
+DstmRingRecv::DstmRingRecv() {
+
+	hif = hifInvalid;
+	pring = NULL;
+	fInit = fFalse;
+	fThread = fFalse;
+	fStop = fFalse;
+	cbStream = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::FInit
+**
+**	Parameters:
+**		hifInit		- open interface handle with DSTM enabled
+**		pringInit	- ring formatted with PringStmRingFormat
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the device and the ring the stream is read into. Each
+**		read fills one slot.
+*/
+
+BOOL DstmRingRecv::FInit(HIF hifInit, STMRING * pringInit) {
+
+	if (fInit || (pringInit == NULL)) {
+		return fFalse;
+	}
+
+	pthread_mutex_init(&mtx, NULL);
+
+	hif = hifInit;
+	pring = pringInit;
+	fInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::FStart
+**
+**	Parameters:
+**		cbStreamInit	- bytes to read, 0 to read until Stop
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts the I/O thread. The ring must be empty.
+*/
+
+BOOL DstmRingRecv::FStart(long long cbStreamInit) {
+
+	if (!fInit || fThread || (cbStreamInit < 0)) {
+		return fFalse;
+	}
+
+	cbStream = cbStreamInit;
+	fStop = fFalse;
+	memset(&stat, 0, sizeof(stat));
+	stat.erc = ercNoErc;
+
+	if (pthread_create(&thrIo, NULL, IoThread, this) != 0) {
+		return fFalse;
+	}
+
+	fThread = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::Stop
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Asks the I/O thread to end the stream. The read in flight is
+**		completed and committed.
+*/
+
+void DstmRingRecv::Stop() {
+
+	fStop = fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::FWait
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the stream ended without error, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the stream has been read into the ring, or has
+**		been stopped. The consumer may still be reading it.
+*/
+
+BOOL DstmRingRecv::FWait() {
+
+	if (fThread) {
+		pthread_join(thrIo, NULL);
+		fThread = fFalse;
+	}
+
+	return stat.erc == ercNoErc;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::GetStat
+**
+**	Parameters:
+**		pstat	- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the statistics of the stream. They are complete after
+**		FWait returns.
+*/
+
+void DstmRingRecv::GetStat(RINGSTAT * pstat) {
+
+	pthread_mutex_lock(&mtx);
+	*pstat = stat;
+	pthread_mutex_unlock(&mtx);
+
+	pstat->dblMBps = (pstat->dblSec > 0) ? (pstat->cbDone / 1e6) / pstat->dblSec : 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stops the stream. The ring is left to the caller.
+*/
+
+void DstmRingRecv::Free() {
+
+	if (!fInit) {
+		return;
+	}
+
+	Stop();
+	FWait();
+
+	pthread_mutex_destroy(&mtx);
+
+	pring = NULL;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::IoThread
+**
+**	Parameters:
+**		pvRecv		- the DstmRingRecv
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Entry point of the I/O thread.
+*/
+
+void * DstmRingRecv::IoThread(void * pvRecv) {
+
+	((DstmRingRecv *) pvRecv)->RunIo();
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::RunIo
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the stream into the ring slot by slot. When a read
+**		completes, the read of the next slot is issued at once if the
+**		slot is free, and then the completed slot is committed. If
+**		the next slot is not free, the completed slot is committed
+**		first, since the consumer may be waiting for it, and the
+**		thread waits for the slot. Ends the stream in the ring when
+**		done.
+*/
+
+void DstmRingRecv::RunIo() {
+
+	long long	cbRemain;
+	DWORD		ixfer;
+	DWORD		cbCur;
+	DWORD		cbNext;
+	DWORD		cbLast;
+	DWORD		cbIn;
+	DWORD		cbOut;
+	double		dblStart;
+	double		dblPrev;
+	double		dblNow;
+	BOOL		fIssued;
+
+	cbRemain = cbStream;
+	ixfer = 0;
+	cbLast = 0;
+
+	cbCur = ((cbStream == 0) || (cbRemain > pring->cbSlot)) ? pring->cbSlot : (DWORD) cbRemain;
+	cbRemain -= cbCur;
+
+	dblStart = DblRingTimeSec();
+	dblPrev = dblStart;
+
+	if (!FWaitSlot(0) || !FIssue(0, cbCur)) {
+		cbCur = 0;
+	}
+
+	while (cbCur > 0) {
+
+		// DMGR API Call: DmgrGetTransResult
+		if (!DmgrGetTransResult(hif, &cbOut, &cbIn, tmsWaitInfinite)) {
+			SetError(DmgrGetLastError());
+			break;
+		}
+		if (cbIn != cbCur) {
+			SetError(ercDataRcvLess);
+			break;
+		}
+
+		dblNow = DblRingTimeSec();
+
+		pthread_mutex_lock(&mtx);
+		if (dblNow - dblPrev > stat.dblGapMax) {
+			stat.dblGapMax = dblNow - dblPrev;
+		}
+		stat.dblSec = dblNow - dblStart;
+		stat.cxfer++;
+		stat.cbDone += cbCur;
+		pthread_mutex_unlock(&mtx);
+
+		dblPrev = dblNow;
+		cbLast = cbCur;
+		ixfer++;
+
+		if (fStop || ((cbStream != 0) && (cbRemain == 0))) {
+			cbNext = 0;
+		}
+		else {
+			cbNext = ((cbStream == 0) || (cbRemain > pring->cbSlot)) ? pring->cbSlot : (DWORD) cbRemain;
+		}
+		cbRemain -= cbNext;
+
+		fIssued = fFalse;
+		if ((cbNext > 0) && FStmRingWaitFree(pring, ixfer, 0)) {
+			if (!FIssue(ixfer, cbNext)) {
+				cbNext = 0;
+			}
+			fIssued = fTrue;
+		}
+
+		StmRingCommit(pring, ixfer);
+
+		if ((cbNext > 0) && !fIssued) {
+			if (!FWaitSlot(ixfer) || !FIssue(ixfer, cbNext)) {
+				cbNext = 0;
+			}
+		}
+
+		cbCur = cbNext;
+	}
+
+	StmRingEnd(pring, cbLast, stat.erc);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::FWaitSlot
+**
+**	Parameters:
+**		ixfer		- slot count of the next read
+**
+**	Return Value:
+**		fTrue if the slot is free, fFalse if the stream was stopped
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the consumer releases the slot of the next read,
+**		counting the wait as a stall.
+*/
+
+BOOL DstmRingRecv::FWaitSlot(DWORD ixfer) {
+
+	double	dblStart;
+	BOOL	fFree;
+
+	if (FStmRingWaitFree(pring, ixfer, 0)) {
+		return fTrue;
+	}
+
+	dblStart = DblRingTimeSec();
+
+	fFree = fFalse;
+	while (!fStop && !fFree) {
+		fFree = FStmRingWaitFree(pring, ixfer, tmsRingPoll);
+	}
+
+	pthread_mutex_lock(&mtx);
+	stat.cstall++;
+	stat.dblStallSec += DblRingTimeSec() - dblStart;
+	pthread_mutex_unlock(&mtx);
+
+	return fFree;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::FIssue
+**
+**	Parameters:
+**		ixfer		- slot count of the read
+**		cb			- bytes to read
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Records the error of a failed call.
+**
+**	Description:
+**		Issues an overlapped read into a slot of the ring.
+*/
+
+BOOL DstmRingRecv::FIssue(DWORD ixfer, DWORD cb) {
+
+	// DSTM API Call: DstmIOEx
+	if (!DstmIOEx(hif, NULL, 0, PbStmRingSlot(pring, ixfer), cb, fTrue)) {
+		SetError(DmgrGetLastError());
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmRingRecv::SetError
+**
+**	Parameters:
+**		erc		- error code
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the first transfer error of the stream.
+*/
+
+void DstmRingRecv::SetError(ERC erc) {
+
+	pthread_mutex_lock(&mtx);
+	if (stat.erc == ercNoErc) {
+		stat.erc = (erc != ercNoErc) ? erc : ercInternalError;
+	}
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DblRingTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		monotonic time in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the time used to measure the stream.
+*/
+
+static double DblRingTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/************************************************************************/
@@ -0,0 +1,101 @@
+/************************************************************************/
+/*																		*/
+/*  DstmRingRecv.h  --  Zero Copy DSTM Receiver Declarations			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DstmRingRecv reads a continuous stream from the DSTM port		*/
+/*		of a device directly into the slots of a stream ring			*/
+/*		(StmRing.h) in memory owned by the caller, and commits each		*/
+/*		slot as its read completes. The consumer reads the data in		*/
+/*		place through FStmRingPeek, in the same process or, with the	*/
+/*		ring in POSIX shared memory, in another one.					*/
+/*																		*/
+/*		As in DstmStream, an I/O thread keeps one overlapped DstmIOEx	*/
+/*		read in flight: the read of the next slot is issued before		*/
+/*		the completed slot is committed. When the consumer has not		*/
+/*		released the next slot the link waits, and the wait is			*/
+/*		counted as a stall.												*/
+/*																		*/
+/*		Call FInit with a formatted ring, then FStart. FWait waits		*/
+/*		until the stream has been read, which is before the consumer	*/
+/*		has finished with it. Call Free when done; the ring itself		*/
+/*		belongs to the caller.											*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DSTMRINGRECV_INCLUDED)
+#define      DSTMRINGRECV_INCLUDED
+
+#include <pthread.h>
+
+#include "dpcdecl.h"
+#include "StmRing.h"
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Statistics of a receiver.
+*/
+typedef struct tagRINGSTAT {
+	long long	cbDone;				// bytes committed to the ring
+	DWORD		cxfer;				// completed reads
+	double		dblSec;				// first issue to last completion
+	double		dblMBps;			// sustained throughput, 1e6 bytes/s
+	DWORD		cstall;				// waits for the consumer to release a slot
+	double		dblStallSec;		// total time of those waits
+	double		dblGapMax;			// longest time between completions
+	ERC			erc;				// first transfer error, ercNoErc if none
+} RINGSTAT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DstmRingRecv {
+
+private:
+	HIF			hif;
+	STMRING *	pring;
+	BOOL		fInit;
+
+	pthread_mutex_t	mtx;
+	pthread_t	thrIo;
+	BOOL		fThread;
+	volatile BOOL	fStop;
+	long long	cbStream;			// bytes to read, 0 until stopped
+
+	RINGSTAT	stat;
+
+	static void *	IoThread(void * pvRecv);
+
+	void	RunIo();
+	BOOL	FWaitSlot(DWORD ixfer);
+	BOOL	FIssue(DWORD ixfer, DWORD cb);
+	void	SetError(ERC erc);
+
+public:
+	DstmRingRecv();
+
+	BOOL	FInit(HIF hifInit, STMRING * pringInit);
+	BOOL	FStart(long long cbStreamInit);
+	void	Stop();
+	BOOL	FWait();
+	void	GetStat(RINGSTAT * pstat);
+	void	Free();
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// DSTMRINGRECV_INCLUDED
+
+/************************************************************************/
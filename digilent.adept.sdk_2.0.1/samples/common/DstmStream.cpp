@@ -0,0 +1,957 @@
+/************************************************************************/
+/*																		*/
+/*  DstmStream.cpp  --  Continuous DSTM Stream Engine					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DstmStream class. See DstmStream.h.	*/
+/*																		*/
+/*		The I/O thread fills buffer ixfer % cbuf with read ixfer, and	*/
+/*		the consumer thread consumes the buffers in the same order,		*/
+/*		so the ring needs no free list: read ixfer may start once		*/
+/*		ixfer - ixferConsume < cbuf. The download ring works the same	*/
+/*		way between the producer thread and the I/O thread. As only		*/
+/*		one transfer is in flight, at most one download buffer is		*/
+/*		attached to it: buffer ioutSent % cbuf.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: added full duplex streaming								*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "dstm.h"
+#include "DstmStream.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static double	DblStmTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DstmStream::DstmStream
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The stream must be initialized with FInit before
+**		it is used.
+*/
+
+DstmStream::DstmStream() {
+
+	hif = hifInvalid;
+	cbBuf = 0;
+	cbuf = 0;
+	fInit = fFalse;
+	pfnConsume = NULL;
+	pvConsume = NULL;
+	fdOut = -1;
+	pfnProduce = NULL;
+	pvProduce = NULL;
+	fSplit = fFalse;
+	fThread = fFalse;
+	fStop = fFalse;
+	memset(&stat, 0, sizeof(stat));
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::FInit
+**
+**	Parameters:
+**		hifInit		- open interface handle with DSTM enabled
+**		cbBufInit	- bytes read by each DstmIOEx call
+**		cbufInit	- number of buffers in the ring, at least 2
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates the ring. All buffers are taken from a BufPool, so
+**		they are page aligned and committed before the stream starts.
+*/
+
+BOOL DstmStream::FInit(HIF hifInit, DWORD cbBufInit, DWORD cbufInit) {
+
+	DWORD	ibuf;
+
+	if (fInit || (cbBufInit == 0) || (cbufInit < 2) || (cbufInit > cbufStmMax)) {
+		return fFalse;
+	}
+
+	if (!pool.FInit(cbBufInit, cbufInit)) {
+		return fFalse;
+	}
+
+	for (ibuf = 0; ibuf < cbufInit; ibuf++) {
+		rgpbBuf[ibuf] = pool.PbAlloc();
+		rgcbBuf[ibuf] = 0;
+	}
+
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&condFilled, NULL);
+	pthread_cond_init(&condFree, NULL);
+	pthread_cond_init(&condOutFree, NULL);
+
+	hif = hifInit;
+	cbBuf = cbBufInit;
+	cbuf = cbufInit;
+	fInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::SetConsumer
+**
+**	Parameters:
+**		pfn			- consumer callback
+**		pvCtx		- context passed to the callback
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the callback that receives the filled buffers. Must be
+**		called before FStart.
+*/
+
+void DstmStream::SetConsumer(PFNSTMCONSUME pfn, void * pvCtx) {
+
+	pfnConsume = pfn;
+	pvConsume = pvCtx;
+	fdOut = -1;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::SetFile
+**
+**	Parameters:
+**		fd		- file descriptor open for writing
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes the stream to a file instead of calling a consumer.
+**		Must be called before FStart. The file is not closed.
+*/
+
+void DstmStream::SetFile(int fd) {
+
+	pfnConsume = NULL;
+	pvConsume = NULL;
+	fdOut = fd;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::FSetProducer
+**
+**	Parameters:
+**		pfn			- producer callback
+**		pvCtx		- context passed to the callback
+**		fSplitInit	- fTrue to send the download data in DstmIOEx
+**					  calls of its own rather than with the reads
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the stream full duplex. Allocates a download ring with
+**		as many buffers as the upload ring. Must be called after FInit
+**		and before FStart. fSplitInit gives the half duplex behavior,
+**		a write followed by a read, for comparison.
+*/
+
+BOOL DstmStream::FSetProducer(PFNSTMPRODUCE pfn, void * pvCtx, BOOL fSplitInit) {
+
+	DWORD	ibuf;
+
+	if (!fInit || fThread || (pfn == NULL)) {
+		return fFalse;
+	}
+
+	if (pfnProduce == NULL) {
+		if (!poolOut.FInit(cbBuf, cbuf)) {
+			return fFalse;
+		}
+
+		for (ibuf = 0; ibuf < cbuf; ibuf++) {
+			rgpbOut[ibuf] = poolOut.PbAlloc();
+			rgcbOut[ibuf] = 0;
+		}
+	}
+
+	pfnProduce = pfn;
+	pvProduce = pvCtx;
+	fSplit = fSplitInit;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::FStart
+**
+**	Parameters:
+**		cbStreamInit	- bytes to read, 0 to read until Stop is called
+**
+**	Return Value:
+**		fTrue if the stream was started, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts the I/O, consumer and producer threads.
+*/
+
+BOOL DstmStream::FStart(long long cbStreamInit) {
+
+	if (!fInit || fThread || (cbStreamInit < 0) || ((pfnConsume == NULL) && (fdOut < 0))) {
+		return fFalse;
+	}
+
+	cbStream = cbStreamInit;
+	ixferFill = 0;
+	ixferConsume = 0;
+	ioutFill = 0;
+	ioutSent = 0;
+	fIoDone = fFalse;
+	fStop = fFalse;
+	memset(&stat, 0, sizeof(stat));
+	stat.erc = ercNoErc;
+
+	if (pthread_create(&thrIo, NULL, IoThread, this) != 0) {
+		return fFalse;
+	}
+
+	if (pthread_create(&thrConsume, NULL, ConsumeThread, this) != 0) {
+		Stop();
+		pthread_join(thrIo, NULL);
+		return fFalse;
+	}
+
+	if ((pfnProduce != NULL) && (pthread_create(&thrProduce, NULL, ProduceThread, this) != 0)) {
+		Stop();
+		pthread_join(thrIo, NULL);
+		pthread_join(thrConsume, NULL);
+		return fFalse;
+	}
+
+	fThread = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::Stop
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Asks the stream to end. The read in progress completes and is
+**		consumed; no further read is issued. Call FWait to wait for
+**		the threads.
+*/
+
+void DstmStream::Stop() {
+
+	fStop = fTrue;
+	Wake();
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::FWait
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the stream ended without error, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the stream has been read and consumed, or has
+**		been stopped.
+*/
+
+BOOL DstmStream::FWait() {
+
+	if (fThread) {
+		pthread_join(thrIo, NULL);
+		pthread_join(thrConsume, NULL);
+		if (pfnProduce != NULL) {
+			pthread_join(thrProduce, NULL);
+		}
+		fThread = fFalse;
+	}
+
+	return (stat.erc == ercNoErc) && !stat.fWriteError;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::GetStat
+**
+**	Parameters:
+**		pstat	- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the statistics of the stream. They are complete after
+**		FWait returns.
+*/
+
+void DstmStream::GetStat(STMSTAT * pstat) {
+
+	pthread_mutex_lock(&mtx);
+	*pstat = stat;
+	pthread_mutex_unlock(&mtx);
+
+	pstat->dblMBps = (pstat->dblSec > 0) ? (pstat->cbDone / 1e6) / pstat->dblSec : 0;
+	pstat->dblMBpsTotal = (pstat->dblSec > 0) ?
+		((pstat->cbDone + pstat->cbOutDone) / 1e6) / pstat->dblSec : 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stops the stream and frees the rings.
+*/
+
+void DstmStream::Free() {
+
+	if (!fInit) {
+		return;
+	}
+
+	Stop();
+	FWait();
+
+	pthread_cond_destroy(&condOutFree);
+	pthread_cond_destroy(&condFree);
+	pthread_cond_destroy(&condFilled);
+	pthread_mutex_destroy(&mtx);
+	pool.Free();
+
+	if (pfnProduce != NULL) {
+		poolOut.Free();
+		pfnProduce = NULL;
+	}
+
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::IoThread
+**
+**	Parameters:
+**		pvStm		- the DstmStream
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Entry point of the I/O thread.
+*/
+
+void * DstmStream::IoThread(void * pvStm) {
+
+	((DstmStream *) pvStm)->RunIo();
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::ConsumeThread
+**
+**	Parameters:
+**		pvStm		- the DstmStream
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Entry point of the consumer thread.
+*/
+
+void * DstmStream::ConsumeThread(void * pvStm) {
+
+	((DstmStream *) pvStm)->RunConsume();
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::ProduceThread
+**
+**	Parameters:
+**		pvStm		- the DstmStream
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Entry point of the producer thread.
+*/
+
+void * DstmStream::ProduceThread(void * pvStm) {
+
+	((DstmStream *) pvStm)->RunProduce();
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::RunIo
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Records the error of a failed read in the statistics.
+**
+**	Description:
+**		Reads the stream. When a read completes the next one is
+**		issued into the next free buffer before the completed buffer
+**		is published to the consumer, so the link is idle only while
+**		the thread turns around. If the ring is full the completed
+**		buffer is published first and the thread waits for the
+**		consumer. A download buffer is released when the transfer
+**		that carried it completes.
+*/
+
+void DstmStream::RunIo() {
+
+	long long	cbRemain;
+	DWORD		ixfer;
+	DWORD		cbCur;
+	DWORD		cbNext;
+	DWORD		cbIn;
+	DWORD		cbOut;
+	DWORD		cbOutCur;
+	DWORD		cbufQueued;
+	double		dblStart;
+	double		dblPrev;
+	double		dblNow;
+	BOOL		fFree;
+
+	cbRemain = cbStream;
+	ixfer = 0;
+
+	cbCur = ((cbStream == 0) || (cbRemain > cbBuf)) ? cbBuf : (DWORD) cbRemain;
+	cbRemain -= cbCur;
+
+	dblStart = DblStmTimeSec();
+	dblPrev = dblStart;
+
+	cbOutCur = 0;
+	if (!fStop && (cbCur > 0) && !FIssue(rgpbBuf[0], cbCur, &cbOutCur)) {
+		cbCur = 0;
+	}
+
+	/* A read that is in flight is always collected, even after Stop,
+	** as its buffer belongs to the transfer until it completes.
+	*/
+	while (cbCur > 0) {
+
+		// DMGR API Call: DmgrGetTransResult
+		if (!DmgrGetTransResult(hif, &cbOut, &cbIn, tmsWaitInfinite)) {
+			SetError(DmgrGetLastError());
+			break;
+		}
+		if (cbOut != cbOutCur) {
+			SetError(ercDataSndLess);
+			break;
+		}
+		if (cbIn != cbCur) {
+			SetError(ercDataRcvLess);
+			break;
+		}
+
+		if (cbOutCur > 0) {
+			OutDone(cbOutCur);
+		}
+
+		dblNow = DblStmTimeSec();
+
+		pthread_mutex_lock(&mtx);
+		if (dblNow - dblPrev > stat.dblGapMax) {
+			stat.dblGapMax = dblNow - dblPrev;
+		}
+		stat.dblSec = dblNow - dblStart;
+		stat.cxfer++;
+		if (cbOutCur > 0) {
+			stat.cxferOut++;
+		}
+		pthread_mutex_unlock(&mtx);
+
+		dblPrev = dblNow;
+		rgcbBuf[ixfer % cbuf] = cbCur;
+		ixfer++;
+
+		if (fStop || ((cbStream != 0) && (cbRemain == 0))) {
+			break;
+		}
+
+		cbNext = ((cbStream == 0) || (cbRemain > cbBuf)) ? cbBuf : (DWORD) cbRemain;
+
+		/* Publish the completed buffer now if the next read has to
+		** wait for the consumer, otherwise after the next read has
+		** been issued.
+		*/
+		pthread_mutex_lock(&mtx);
+		fFree = (ixfer - ixferConsume < cbuf);
+		if (!fFree) {
+			ixferFill = ixfer;
+			pthread_cond_signal(&condFilled);
+		}
+		pthread_mutex_unlock(&mtx);
+
+		if (!fFree && !FWaitFree(ixfer)) {
+			break;
+		}
+
+		if (!FIssue(rgpbBuf[ixfer % cbuf], cbNext, &cbOutCur)) {
+			break;
+		}
+
+		cbRemain -= cbNext;
+		cbCur = cbNext;
+
+		pthread_mutex_lock(&mtx);
+		ixferFill = ixfer;
+		cbufQueued = ixferFill - ixferConsume;
+		if (cbufQueued > stat.cbufQueuedMax) {
+			stat.cbufQueuedMax = cbufQueued;
+		}
+		pthread_cond_signal(&condFilled);
+		pthread_mutex_unlock(&mtx);
+	}
+
+	/* The end of the upload stream ends the download stream too.
+	*/
+	pthread_mutex_lock(&mtx);
+	ixferFill = ixfer;
+	fIoDone = fTrue;
+	fStop = fTrue;
+	pthread_cond_signal(&condFilled);
+	pthread_cond_broadcast(&condOutFree);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::RunConsume
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Records a failed file write in the statistics.
+**
+**	Description:
+**		Hands the filled buffers to the consumer in order until the
+**		I/O thread is done and every filled buffer is consumed. If
+**		the consumer ends the stream, the stream is stopped.
+*/
+
+void DstmStream::RunConsume() {
+
+	long long	ibStream;
+	ssize_t		cbWritten;
+	DWORD		ixfer;
+	DWORD		cb;
+	DWORD		ib;
+	BYTE *		pb;
+	BOOL		fOk;
+
+	ixfer = 0;
+	ibStream = 0;
+
+	while (fTrue) {
+		pthread_mutex_lock(&mtx);
+		while ((ixferFill == ixfer) && !fIoDone) {
+			pthread_cond_wait(&condFilled, &mtx);
+		}
+		if (ixferFill == ixfer) {
+			pthread_mutex_unlock(&mtx);
+			break;
+		}
+		pthread_mutex_unlock(&mtx);
+
+		pb = rgpbBuf[ixfer % cbuf];
+		cb = rgcbBuf[ixfer % cbuf];
+
+		fOk = fTrue;
+		if (pfnConsume != NULL) {
+			fOk = pfnConsume(pvConsume, pb, cb, ibStream);
+		}
+		else {
+			for (ib = 0; ib < cb; ib += (DWORD) cbWritten) {
+				cbWritten = write(fdOut, pb + ib, cb - ib);
+				if (cbWritten <= 0) {
+					fOk = fFalse;
+					break;
+				}
+			}
+		}
+
+		pthread_mutex_lock(&mtx);
+		if (fOk || (pfnConsume != NULL)) {
+			stat.cbDone += cb;
+		}
+		if (!fOk && (pfnConsume == NULL)) {
+			stat.fWriteError = fTrue;
+		}
+		ixfer++;
+		ixferConsume = ixfer;
+		pthread_cond_signal(&condFree);
+		pthread_mutex_unlock(&mtx);
+
+		ibStream += cb;
+
+		if (!fOk) {
+			Stop();
+			break;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::RunProduce
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills the download ring from the producer until the producer
+**		ends the download stream or the stream is stopped.
+*/
+
+void DstmStream::RunProduce() {
+
+	long long	ibStream;
+	DWORD		iout;
+	DWORD		cb;
+
+	iout = 0;
+	ibStream = 0;
+
+	while (!fStop) {
+		pthread_mutex_lock(&mtx);
+		while ((iout - ioutSent >= cbuf) && !fStop) {
+			pthread_cond_wait(&condOutFree, &mtx);
+		}
+		pthread_mutex_unlock(&mtx);
+
+		if (fStop) {
+			break;
+		}
+
+		cb = pfnProduce(pvProduce, rgpbOut[iout % cbuf], cbBuf, ibStream);
+		if ((cb == 0) || (cb > cbBuf)) {
+			break;
+		}
+
+		rgcbOut[iout % cbuf] = cb;
+		ibStream += cb;
+		iout++;
+
+		pthread_mutex_lock(&mtx);
+		ioutFill = iout;
+		pthread_mutex_unlock(&mtx);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::FIssue
+**
+**	Parameters:
+**		pbIn		- buffer to receive the read
+**		cbIn		- number of bytes to read
+**		pcbOut		- variable to receive the number of bytes sent
+**					  by the transfer
+**
+**	Return Value:
+**		fTrue if the transfer was issued, fFalse if not
+**
+**	Errors:
+**		Records the error of a failed call in the statistics.
+**
+**	Description:
+**		Issues an overlapped read. If the producer has filled a
+**		download buffer, its data is sent by the same DstmIOEx call,
+**		or by a synchronous call of its own first in split mode. The
+**		download buffer stays in use until the transfer completes.
+*/
+
+BOOL DstmStream::FIssue(BYTE * pbIn, DWORD cbIn, DWORD * pcbOut) {
+
+	BYTE *	pbOut;
+	DWORD	cbOut;
+
+	pbOut = NULL;
+	cbOut = 0;
+
+	if (pfnProduce != NULL) {
+		pthread_mutex_lock(&mtx);
+		if (ioutFill != ioutSent) {
+			pbOut = rgpbOut[ioutSent % cbuf];
+			cbOut = rgcbOut[ioutSent % cbuf];
+		}
+		pthread_mutex_unlock(&mtx);
+	}
+
+	if ((cbOut > 0) && fSplit) {
+		// DSTM API Call: DstmIOEx
+		if (!DstmIOEx(hif, pbOut, cbOut, NULL, 0, fFalse)) {
+			SetError(DmgrGetLastError());
+			return fFalse;
+		}
+
+		OutDone(cbOut);
+		pbOut = NULL;
+		cbOut = 0;
+	}
+
+	*pcbOut = cbOut;
+
+	// DSTM API Call: DstmIOEx
+	if (!DstmIOEx(hif, pbOut, cbOut, pbIn, cbIn, fTrue)) {
+		SetError(DmgrGetLastError());
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::OutDone
+**
+**	Parameters:
+**		cbOut		- number of bytes sent
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the download buffer of a completed transfer to the
+**		producer.
+*/
+
+void DstmStream::OutDone(DWORD cbOut) {
+
+	pthread_mutex_lock(&mtx);
+	ioutSent++;
+	stat.cbOutDone += cbOut;
+	pthread_cond_signal(&condOutFree);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::FWaitFree
+**
+**	Parameters:
+**		ixfer		- number of the read about to be issued
+**
+**	Return Value:
+**		fTrue when the buffer of the read is free, fFalse if the
+**		stream was stopped while waiting
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits for the consumer to free the buffer of read ixfer.
+**		Counts the wait as a stall of the link.
+*/
+
+BOOL DstmStream::FWaitFree(DWORD ixfer) {
+
+	double	dblStart;
+	BOOL	fFree;
+
+	dblStart = DblStmTimeSec();
+
+	pthread_mutex_lock(&mtx);
+	while ((ixfer - ixferConsume >= cbuf) && !fStop) {
+		pthread_cond_wait(&condFree, &mtx);
+	}
+	fFree = (ixfer - ixferConsume < cbuf);
+
+	stat.cstall++;
+	stat.dblStallSec += DblStmTimeSec() - dblStart;
+	pthread_mutex_unlock(&mtx);
+
+	return fFree && !fStop;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::SetError
+**
+**	Parameters:
+**		erc		- error code
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the first transfer error of the stream.
+*/
+
+void DstmStream::SetError(ERC erc) {
+
+	pthread_mutex_lock(&mtx);
+	if (stat.erc == ercNoErc) {
+		stat.erc = (erc != ercNoErc) ? erc : ercInternalError;
+	}
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmStream::Wake
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Wakes the threads so that they see a change of fStop.
+*/
+
+void DstmStream::Wake() {
+
+	if (!fInit) {
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	pthread_cond_broadcast(&condFree);
+	pthread_cond_broadcast(&condFilled);
+	pthread_cond_broadcast(&condOutFree);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DblStmTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		monotonic time in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the time used to measure the stream.
+*/
+
+static double DblStmTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/************************************************************************/
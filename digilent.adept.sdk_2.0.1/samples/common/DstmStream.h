@@ -0,0 +1,186 @@
+/************************************************************************/
+/*																		*/
+/*  DstmStream.h  --  Continuous DSTM Stream Engine Declarations		*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DstmStream reads a continuous stream of data from the DSTM	*/
+/*		port of a device into a ring of page aligned buffers, and		*/
+/*		hands each filled buffer to a consumer callback or writes it	*/
+/*		to a file.														*/
+/*																		*/
+/*		An I/O thread reads the buffers in turn with overlapped			*/
+/*		DstmIOEx calls. Adept allows one overlapped transaction per		*/
+/*		interface handle, so the thread issues the read of the next		*/
+/*		buffer as soon as a read completes, before the completed		*/
+/*		buffer is handed on. A consumer thread takes the filled			*/
+/*		buffers in order. The other buffers of the ring absorb the		*/
+/*		time the consumer takes, so the link only waits when the		*/
+/*		consumer falls a whole ring behind. Such waits are counted as	*/
+/*		stalls.															*/
+/*																		*/
+/*		With a producer (FSetProducer) the stream is full duplex: a		*/
+/*		producer thread fills a second ring of buffers, and each read	*/
+/*		carries the next filled buffer, if there is one, as the			*/
+/*		download data of the same DstmIOEx call. Downloads then ride	*/
+/*		along with the upload stream instead of taking turns with it.	*/
+/*																		*/
+/*		Call FInit, then SetConsumer or SetFile, then FStart. FWait		*/
+/*		waits until the stream ends and GetStat returns the sustained	*/
+/*		throughput, the stalls and the longest gap between completed	*/
+/*		reads. Call Free when done.										*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: added full duplex streaming								*/
+/*	10/17/2026: added FStopped											*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DSTMSTREAM_INCLUDED)
+#define      DSTMSTREAM_INCLUDED
+
+#include <pthread.h>
+
+#include "dpcdecl.h"
+#include "BufPool.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Maximum number of buffers in the ring.
+*/
+const DWORD		cbufStmMax		= 256;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Consumer callback. Called on the consumer thread with each filled
+** buffer in stream order; ibStream is the stream offset of rgb[0].
+** The buffer is reused when the callback returns. Returning fFalse
+** ends the stream.
+*/
+typedef BOOL (* PFNSTMCONSUME)(void * pvCtx, const BYTE * rgb, DWORD cb, long long ibStream);
+
+/* Producer callback. Called on the producer thread to fill the next
+** buffer to send; ibStream is the offset of rgb[0] in the download
+** stream. Returns the number of bytes placed in rgb, at most cbMax,
+** or 0 to end the download stream. The callback may block until it
+** has data, but should return promptly once the stream is stopped.
+*/
+typedef DWORD (* PFNSTMPRODUCE)(void * pvCtx, BYTE * rgb, DWORD cbMax, long long ibStream);
+
+/* Statistics of a stream.
+*/
+typedef struct tagSTMSTAT {
+	long long	cbDone;				// bytes handed to the consumer
+	long long	cbOutDone;			// bytes sent from the producer
+	DWORD		cxferOut;			// reads that carried download data
+	DWORD		cxfer;				// completed reads
+	double		dblSec;				// first issue to last completion
+	double		dblMBps;			// sustained throughput, 1e6 bytes/s
+	double		dblMBpsTotal;		// both directions, 1e6 bytes/s
+	DWORD		cstall;				// waits of the link for a free buffer
+	double		dblStallSec;		// total time of those waits
+	double		dblGapMax;			// longest time between completions
+	DWORD		cbufQueuedMax;		// deepest backlog of the consumer
+	ERC			erc;				// first transfer error, ercNoErc if none
+	BOOL		fWriteError;		// the output file could not be written
+} STMSTAT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DstmStream {
+
+private:
+	HIF			hif;
+	BufPool		pool;
+	BYTE *		rgpbBuf[cbufStmMax];
+	DWORD		rgcbBuf[cbufStmMax];	// bytes read into each buffer
+	DWORD		cbBuf;
+	DWORD		cbuf;
+	BOOL		fInit;
+
+	PFNSTMCONSUME	pfnConsume;
+	void *		pvConsume;
+	int			fdOut;
+
+	/* Download ring, used when there is a producer. ioutFill counts
+	** the buffers filled by the producer and ioutSent the buffers
+	** whose transfer has completed; both are protected by mtx.
+	*/
+	PFNSTMPRODUCE	pfnProduce;
+	void *		pvProduce;
+	BufPool		poolOut;
+	BYTE *		rgpbOut[cbufStmMax];
+	DWORD		rgcbOut[cbufStmMax];
+	pthread_cond_t	condOutFree;
+	DWORD		ioutFill;
+	DWORD		ioutSent;
+	BOOL		fSplit;				// send downloads in calls of their own
+
+	/* Buffers are filled and consumed in ring order. ixferFill counts
+	** the buffers filled and ixferConsume the buffers consumed since
+	** the stream started; both are protected by mtx.
+	*/
+	pthread_mutex_t	mtx;
+	pthread_cond_t	condFilled;
+	pthread_cond_t	condFree;
+	DWORD		ixferFill;
+	DWORD		ixferConsume;
+	BOOL		fIoDone;
+
+	pthread_t	thrIo;
+	pthread_t	thrConsume;
+	pthread_t	thrProduce;
+	BOOL		fThread;
+	volatile BOOL	fStop;
+	long long	cbStream;			// bytes to read, 0 until stopped
+
+	STMSTAT		stat;
+
+	static void *	IoThread(void * pvStm);
+	static void *	ConsumeThread(void * pvStm);
+	static void *	ProduceThread(void * pvStm);
+
+	void	RunIo();
+	void	RunConsume();
+	void	RunProduce();
+	BOOL	FWaitFree(DWORD ixfer);
+	BOOL	FIssue(BYTE * pbIn, DWORD cbIn, DWORD * pcbOut);
+	void	OutDone(DWORD cbOut);
+	void	SetError(ERC erc);
+	void	Wake();
+
+public:
+	DstmStream();
+
+	BOOL	FInit(HIF hifInit, DWORD cbBufInit, DWORD cbufInit);
+	void	SetConsumer(PFNSTMCONSUME pfn, void * pvCtx);
+	void	SetFile(int fd);
+	BOOL	FSetProducer(PFNSTMPRODUCE pfn, void * pvCtx, BOOL fSplitInit);
+	BOOL	FStart(long long cbStreamInit);
+	void	Stop();
+	BOOL	FWait();
+	void	GetStat(STMSTAT * pstat);
+	void	Free();
+
+	BOOL	FStopped()		{ return fStop; }
+	DWORD	CbBuf()			{ return cbBuf; }
+	DWORD	Cbuf()			{ return cbuf; }
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// DSTMSTREAM_INCLUDED
+
+/************************************************************************/
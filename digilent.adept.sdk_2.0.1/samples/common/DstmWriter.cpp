@@ -0,0 +1,782 @@
+/************************************************************************/
+/*																		*/
+/*  DstmWriter.cpp  --  DSTM Message Writer								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Sends messages to the DSTM port one per transfer or coalesced	*/
+/*		into larger transfers. See DstmWriter.h.						*/
+/*																		*/
+/*		A closed coalescing buffer is only sent by the I/O thread, and	*/
+/*		a direct message is only sent once every closed buffer has		*/
+/*		been sent, so the interface handle is never used by both		*/
+/*		threads at once and the messages keep their order.				*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: FWrite waits for a fill buffer before filling it		*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "dstm.h"
+#include "DstmWriter.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static double	DblWrTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DstmWriter::DstmWriter
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The writer must be initialized with FInit before
+**		it is used.
+*/
+
+DstmWriter::DstmWriter() {
+
+	hif = hifInvalid;
+	wpol = wpolLatency;
+	cbBudget = 0;
+	tusBudget = 0;
+	cbBypass = 0;
+	fInit = fFalse;
+	fThread = fFalse;
+	fStop = fFalse;
+	memset(rgdblMsg, 0, sizeof(rgdblMsg));
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FInit
+**
+**	Parameters:
+**		hifInit			- open interface handle with DSTM enabled
+**		wpolInit		- initial policy
+**		cbBudgetInit	- bytes a coalescing buffer holds
+**		tusBudgetInit	- longest time, in microseconds, a message
+**						  waits in a coalescing buffer
+**		cbBypassInit	- smallest message sent directly under the
+**						  throughput policy, 0 for the byte budget
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates the coalescing ring and starts the I/O thread.
+**		A bypass size above the byte budget is lowered to it, since a
+**		message larger than a buffer cannot be coalesced.
+*/
+
+BOOL DstmWriter::FInit(HIF hifInit, WPOL wpolInit, DWORD cbBudgetInit, DWORD tusBudgetInit, DWORD cbBypassInit) {
+
+	pthread_condattr_t	attr;
+	DWORD	ibuf;
+
+	if (fInit || (cbBudgetInit == 0)) {
+		return fFalse;
+	}
+
+	if (!pool.FInit(cbBudgetInit, cbufWrRing)) {
+		return fFalse;
+	}
+
+	for (ibuf = 0; ibuf < cbufWrRing; ibuf++) {
+		rgpbBuf[ibuf] = pool.PbAlloc();
+		rgcbBuf[ibuf] = 0;
+		rgcmsgBuf[ibuf] = 0;
+		rgdblMsg[ibuf] = (double *) malloc(cmsgWrBufMax * sizeof(double));
+		if (rgdblMsg[ibuf] == NULL) {
+			Free();
+			return fFalse;
+		}
+	}
+
+	/* The time budget is measured on the monotonic clock.
+	*/
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&condIo, &attr);
+	pthread_cond_init(&condSent, NULL);
+	pthread_condattr_destroy(&attr);
+
+	hif = hifInit;
+	wpol = wpolInit;
+	cbBudget = cbBudgetInit;
+	tusBudget = tusBudgetInit;
+	cbBypass = ((cbBypassInit == 0) || (cbBypassInit > cbBudgetInit)) ? cbBudgetInit : cbBypassInit;
+	ibufFill = 0;
+	ibufSent = 0;
+	dblFirst = 0;
+	fStop = fFalse;
+	memset(&stat, 0, sizeof(stat));
+	stat.erc = ercNoErc;
+	fInit = fTrue;
+
+	if (pthread_create(&thrIo, NULL, IoThread, this) != 0) {
+		Free();
+		return fFalse;
+	}
+	fThread = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FWrite
+**
+**	Parameters:
+**		rgb		- message to send
+**		cb		- number of bytes in the message
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Returns fFalse once a transfer has failed.
+**
+**	Description:
+**		Sends a message. Under the latency policy, and for a message
+**		of the bypass size or more, the coalesced messages written
+**		before it are sent and then the message is sent from rgb, and
+**		FWrite returns when its transfer has completed. Otherwise the
+**		message is copied into the coalescing buffer and FWrite
+**		returns at once, unless every buffer of the ring is waiting
+**		to be sent.
+*/
+
+BOOL DstmWriter::FWrite(const BYTE * rgb, DWORD cb) {
+
+	double	dblStart;
+	DWORD	ibuf;
+	BOOL	fOk;
+
+	if (!fInit || ((rgb == NULL) && (cb != 0))) {
+		return fFalse;
+	}
+
+	if (cb == 0) {
+		return fTrue;
+	}
+
+	dblStart = DblWrTimeSec();
+
+	pthread_mutex_lock(&mtx);
+
+	stat.cmsg++;
+	stat.cbMsg += cb;
+
+	if ((wpol == wpolLatency) || (cb >= cbBypass)) {
+		CloseFill(&stat.cflushBypass);
+		fOk = FWaitSent(ibufFill);
+		pthread_mutex_unlock(&mtx);
+
+		if (fOk) {
+			/* The I/O thread is idle: the ring is empty and this is
+			** the only thread that fills it.
+			*/
+			fOk = FSend((BYTE *) rgb, cb);
+		}
+
+		pthread_mutex_lock(&mtx);
+		if (fOk) {
+			stat.cxfer++;
+			stat.cxferDirect++;
+			AddLatency(cb, DblWrTimeSec() - dblStart);
+		}
+		pthread_mutex_unlock(&mtx);
+
+		return fOk;
+	}
+
+	/* Messages are not split: a message that does not fit in the
+	** fill buffer starts the next one. The previous message may have
+	** closed the last free buffer, so the ring is checked both before
+	** and after the fill buffer is closed.
+	*/
+	FWaitFill();
+	ibuf = ibufFill % cbufWrRing;
+	if ((rgcbBuf[ibuf] + cb > cbBudget) || (rgcmsgBuf[ibuf] == cmsgWrBufMax)) {
+		CloseFill(&stat.cflushFull);
+		FWaitFill();
+	}
+
+	if (stat.erc != ercNoErc) {
+		pthread_mutex_unlock(&mtx);
+		return fFalse;
+	}
+
+	ibuf = ibufFill % cbufWrRing;
+	if (rgcbBuf[ibuf] == 0) {
+		dblFirst = dblStart;
+		pthread_cond_signal(&condIo);
+	}
+
+	memcpy(rgpbBuf[ibuf] + rgcbBuf[ibuf], rgb, cb);
+	rgcbBuf[ibuf] += cb;
+	rgdblMsg[ibuf][rgcmsgBuf[ibuf]++] = dblStart;
+
+	if ((rgcbBuf[ibuf] == cbBudget) || (rgcmsgBuf[ibuf] == cmsgWrBufMax)) {
+		CloseFill(&stat.cflushFull);
+	}
+
+	pthread_mutex_unlock(&mtx);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FFlush
+**
+**	Parameters:
+**		fWait	- fTrue to wait until the messages have been sent
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Returns fFalse once a transfer has failed.
+**
+**	Description:
+**		Sends the coalesced messages without waiting for the byte or
+**		time budget.
+*/
+
+BOOL DstmWriter::FFlush(BOOL fWait) {
+
+	BOOL	fOk;
+
+	if (!fInit) {
+		return fFalse;
+	}
+
+	pthread_mutex_lock(&mtx);
+	CloseFill(&stat.cflushExplicit);
+	if (fWait) {
+		FWaitSent(ibufFill);
+	}
+	fOk = (stat.erc == ercNoErc);
+	pthread_mutex_unlock(&mtx);
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FSetPolicy
+**
+**	Parameters:
+**		wpolNew		- policy for the messages written from now on
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Returns fFalse once a transfer has failed.
+**
+**	Description:
+**		Sends the coalesced messages and changes the policy.
+*/
+
+BOOL DstmWriter::FSetPolicy(WPOL wpolNew) {
+
+	BOOL	fOk;
+
+	fOk = FFlush(fTrue);
+	wpol = wpolNew;
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::GetStat
+**
+**	Parameters:
+**		pstat		- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the statistics of the writer. Messages still in a
+**		coalescing buffer are counted as written but have no latency
+**		yet.
+*/
+
+void DstmWriter::GetStat(WRSTAT * pstat) {
+
+	if (!fInit) {
+		memset(pstat, 0, sizeof(WRSTAT));
+		pstat->erc = ercNoErc;
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	*pstat = stat;
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sends the coalesced messages, stops the I/O thread and frees
+**		the ring. The statistics are lost.
+*/
+
+void DstmWriter::Free() {
+
+	DWORD	ibuf;
+
+	if (fThread) {
+		pthread_mutex_lock(&mtx);
+		CloseFill(&stat.cflushExplicit);
+		fStop = fTrue;
+		pthread_cond_signal(&condIo);
+		pthread_mutex_unlock(&mtx);
+
+		pthread_join(thrIo, NULL);
+		fThread = fFalse;
+	}
+
+	if (fInit) {
+		pthread_cond_destroy(&condIo);
+		pthread_cond_destroy(&condSent);
+		pthread_mutex_destroy(&mtx);
+	}
+
+	for (ibuf = 0; ibuf < cbufWrRing; ibuf++) {
+		free(rgdblMsg[ibuf]);
+		rgdblMsg[ibuf] = NULL;
+	}
+
+	pool.Free();
+
+	hif = hifInvalid;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::IoThread
+**
+**	Parameters:
+**		pvWr		- the writer
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Entry point of the I/O thread.
+*/
+
+void * DstmWriter::IoThread(void * pvWr) {
+
+	((DstmWriter *) pvWr)->RunIo();
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::RunIo
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sends the closed buffers in order, and closes the fill buffer
+**		when its first message has waited for the time budget. After
+**		a transfer error the buffers are dropped instead of sent, so
+**		that the writer can still be freed. Returns when the writer is
+**		stopped and every closed buffer has been handled.
+*/
+
+void DstmWriter::RunIo() {
+
+	struct timespec	ts;
+	double	dblNow;
+	double	dblDeadline;
+	DWORD	ibuf;
+	DWORD	imsg;
+	BOOL	fOk;
+
+	pthread_mutex_lock(&mtx);
+
+	while (fTrue) {
+		if (ibufSent != ibufFill) {
+			ibuf = ibufSent % cbufWrRing;
+			fOk = (stat.erc == ercNoErc);
+			pthread_mutex_unlock(&mtx);
+
+			if (fOk) {
+				fOk = FSend(rgpbBuf[ibuf], rgcbBuf[ibuf]);
+			}
+			dblNow = DblWrTimeSec();
+
+			pthread_mutex_lock(&mtx);
+			if (fOk) {
+				stat.cxfer++;
+				for (imsg = 0; imsg < rgcmsgBuf[ibuf]; imsg++) {
+					AddLatency(0, dblNow - rgdblMsg[ibuf][imsg]);
+				}
+			}
+			rgcbBuf[ibuf] = 0;
+			rgcmsgBuf[ibuf] = 0;
+			ibufSent++;
+			pthread_cond_broadcast(&condSent);
+			continue;
+		}
+
+		if (fStop) {
+			break;
+		}
+
+		if (rgcbBuf[ibufFill % cbufWrRing] == 0) {
+			pthread_cond_wait(&condIo, &mtx);
+			continue;
+		}
+
+		dblDeadline = dblFirst + tusBudget * 1e-6;
+		if (DblWrTimeSec() >= dblDeadline) {
+			CloseFill(&stat.cflushTimer);
+			continue;
+		}
+
+		ts.tv_sec = (time_t) dblDeadline;
+		ts.tv_nsec = (long) ((dblDeadline - ts.tv_sec) * 1e9);
+		pthread_cond_timedwait(&condIo, &mtx, &ts);
+	}
+
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FSend
+**
+**	Parameters:
+**		rgb		- data to send
+**		cb		- number of bytes to send
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Records the error of a failed transfer.
+**
+**	Description:
+**		Sends one transfer and waits for it to complete. Called
+**		without the mutex held.
+*/
+
+BOOL DstmWriter::FSend(BYTE * rgb, DWORD cb) {
+
+	// DSTM API Call: DstmIOEx
+	if (!DstmIOEx(hif, rgb, cb, NULL, 0, fFalse)) {
+		SetError(DmgrGetLastError());
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FWaitSent
+**
+**	Parameters:
+**		ibuf		- count of closed buffers to wait for
+**
+**	Return Value:
+**		fTrue if the buffers were sent, fFalse after a transfer error
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the first ibuf closed buffers have been handled
+**		by the I/O thread. Called with the mutex held.
+*/
+
+BOOL DstmWriter::FWaitSent(DWORD ibuf) {
+
+	while (((int) (ibufSent - ibuf) < 0) && (stat.erc == ercNoErc)) {
+		pthread_cond_wait(&condSent, &mtx);
+	}
+
+	return stat.erc == ercNoErc;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::FWaitFill
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Returns fFalse once a transfer has failed.
+**
+**	Description:
+**		Waits until the ring has a fill buffer, that is until fewer
+**		than cbufWrRing buffers are closed and not yet sent. Called
+**		with the mutex held.
+*/
+
+BOOL DstmWriter::FWaitFill() {
+
+	if (ibufFill - ibufSent < cbufWrRing) {
+		return stat.erc == ercNoErc;
+	}
+
+	stat.cwaitRing++;
+
+	return FWaitSent(ibufFill - cbufWrRing + 1);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::CloseFill
+**
+**	Parameters:
+**		pcflush		- flush counter to advance
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Hands the fill buffer, if it holds any messages, to the I/O
+**		thread. While the ring is full there is no fill buffer: the
+**		buffer at ibufFill is the oldest closed one. Called with the
+**		mutex held.
+*/
+
+void DstmWriter::CloseFill(DWORD * pcflush) {
+
+	if ((ibufFill - ibufSent >= cbufWrRing) || (rgcbBuf[ibufFill % cbufWrRing] == 0)) {
+		return;
+	}
+
+	ibufFill++;
+	(*pcflush)++;
+	pthread_cond_signal(&condIo);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::AddLatency
+**
+**	Parameters:
+**		cb			- size of the message
+**		dblSec		- time from FWrite to the end of its transfer
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Adds a message to the latency histogram of its class. Called
+**		with the mutex held.
+*/
+
+void DstmWriter::AddLatency(DWORD cb, double dblSec) {
+
+	WRLAT *	plat;
+	double	dblUs;
+	double	dblFrac;
+	int		oct;
+	DWORD	ibkt;
+
+	plat = (cb < cbBypass) ? &stat.latSmall : &stat.latBulk;
+
+	/* Bucket 0 is below 1 us. Above that, a latency of f * 2^oct us,
+	** with f in [1, 2), falls in sub-bucket (f - 1) * cbktWrOct of
+	** octave oct.
+	*/
+	dblUs = dblSec * 1e6;
+	if (dblUs < 1) {
+		ibkt = 0;
+	}
+	else {
+		dblFrac = frexp(dblUs, &oct);
+		ibkt = 1 + (oct - 1) * cbktWrOct + (DWORD) ((2 * dblFrac - 1) * cbktWrOct);
+		if (ibkt >= cbktWrLat) {
+			ibkt = cbktWrLat - 1;
+		}
+	}
+
+	plat->rgcmsg[ibkt]++;
+	plat->cmsg++;
+	plat->dblSumSec += dblSec;
+	if (dblSec > plat->dblMaxSec) {
+		plat->dblMaxSec = dblSec;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmWriter::SetError
+**
+**	Parameters:
+**		erc		- error code
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the first transfer error and wakes a writer waiting
+**		for the ring.
+*/
+
+void DstmWriter::SetError(ERC erc) {
+
+	pthread_mutex_lock(&mtx);
+	if (stat.erc == ercNoErc) {
+		stat.erc = (erc != ercNoErc) ? erc : ercInternalError;
+	}
+	pthread_cond_broadcast(&condSent);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	DblWrLatPct
+**
+**	Parameters:
+**		plat		- latency histogram
+**		dblPct		- percentile, 0 to 100
+**
+**	Return Value:
+**		latency in seconds below which dblPct percent of the messages
+**		completed, 0 if there are none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the upper edge of the histogram bucket holding the
+**		percentile, which is within 1/cbktWrOct of the true value,
+**		and never more than the longest latency seen.
+*/
+
+double DblWrLatPct(const WRLAT * plat, double dblPct) {
+
+	long long	cmsgTarget;
+	long long	cmsgSum;
+	double		dblUs;
+	DWORD		ibkt;
+
+	if (plat->cmsg == 0) {
+		return 0;
+	}
+
+	cmsgTarget = (long long) ceil(dblPct / 100 * plat->cmsg);
+	if (cmsgTarget < 1) {
+		cmsgTarget = 1;
+	}
+
+	cmsgSum = 0;
+	for (ibkt = 0; ibkt < cbktWrLat - 1; ibkt++) {
+		cmsgSum += plat->rgcmsg[ibkt];
+		if (cmsgSum >= cmsgTarget) {
+			break;
+		}
+	}
+
+	if (ibkt == 0) {
+		dblUs = 1;
+	}
+	else {
+		dblUs = ldexp(1 + (double) ((ibkt - 1) % cbktWrOct + 1) / cbktWrOct,
+				(ibkt - 1) / cbktWrOct);
+	}
+
+	return (dblUs * 1e-6 < plat->dblMaxSec) ? dblUs * 1e-6 : plat->dblMaxSec;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblWrTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		monotonic time in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the time used for the time budget and the latencies.
+*/
+
+static double DblWrTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/************************************************************************/
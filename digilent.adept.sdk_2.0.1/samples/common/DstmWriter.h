@@ -0,0 +1,179 @@
+/************************************************************************/
+/*																		*/
+/*  DstmWriter.h  --  DSTM Message Writer Declarations					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A DstmWriter sends a sequence of messages of any size to the	*/
+/*		DSTM port of a device, under one of two policies that can be	*/
+/*		changed while the writer is in use:								*/
+/*																		*/
+/*			wpolLatency		- every message is sent at once, in a		*/
+/*							  DstmIOEx call of its own					*/
+/*			wpolThroughput	- small messages are copied into a			*/
+/*							  coalescing buffer, which is sent when it	*/
+/*							  holds the byte budget, when the time		*/
+/*							  budget has passed since its first			*/
+/*							  message was written, or when FFlush is	*/
+/*							  called									*/
+/*																		*/
+/*		Under either policy a message of the bypass size or more is		*/
+/*		sent directly from the caller's buffer, after the coalesced		*/
+/*		messages written before it, so bulk data is never copied.		*/
+/*		Messages are never split between transfers and always			*/
+/*		reach the device in the order they were written.				*/
+/*																		*/
+/*		The coalescing buffers are a small ring taken from a BufPool.	*/
+/*		An I/O thread sends the filled buffers and enforces the time	*/
+/*		budget, so FWrite only blocks when the whole ring is waiting	*/
+/*		to be sent. A DstmWriter is written to from one thread.			*/
+/*																		*/
+/*		GetStat returns the number of messages and transfers, why		*/
+/*		each coalescing buffer was sent, and the latency of small and	*/
+/*		bulk messages, from the FWrite call until the transfer that		*/
+/*		carried the message completed, as log-linear histograms.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(DSTMWRITER_INCLUDED)
+#define      DSTMWRITER_INCLUDED
+
+#include <pthread.h>
+
+#include "dpcdecl.h"
+#include "BufPool.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Coalescing buffers in the ring, and messages a buffer can hold.
+*/
+const DWORD		cbufWrRing		= 4;
+const DWORD		cmsgWrBufMax	= 4096;
+
+/* Latency histograms have cbktWrOct buckets per octave from 1 us up,
+** plus one bucket for shorter latencies; the last bucket also counts
+** everything longer than its range.
+*/
+const DWORD		cbktWrOct		= 8;
+const DWORD		coctWrLat		= 24;
+const DWORD		cbktWrLat		= cbktWrOct * coctWrLat + 1;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+typedef enum {
+	wpolLatency = 0,
+	wpolThroughput
+} WPOL;
+
+/* Latency of one class of messages.
+*/
+typedef struct tagWRLAT {
+	long long	cmsg;
+	double		dblSumSec;
+	double		dblMaxSec;
+	long long	rgcmsg[cbktWrLat];
+} WRLAT;
+
+/* Statistics of a writer.
+*/
+typedef struct tagWRSTAT {
+	long long	cmsg;				// messages written
+	long long	cbMsg;				// bytes written
+	DWORD		cxfer;				// DstmIOEx calls
+	DWORD		cxferDirect;		// of those, single messages
+	DWORD		cflushFull;			// buffers sent at the byte budget
+	DWORD		cflushTimer;		// buffers sent at the time budget
+	DWORD		cflushExplicit;		// buffers sent by FFlush or SetPolicy
+	DWORD		cflushBypass;		// buffers sent ahead of a bulk message
+	DWORD		cwaitRing;			// writes that waited for a free buffer
+	WRLAT		latSmall;			// messages below the bypass size
+	WRLAT		latBulk;			// messages of the bypass size or more
+	ERC			erc;				// first transfer error, ercNoErc if none
+} WRSTAT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class DstmWriter {
+
+private:
+	HIF			hif;
+	WPOL		wpol;
+	DWORD		cbBudget;
+	DWORD		tusBudget;
+	DWORD		cbBypass;
+	BOOL		fInit;
+
+	/* Coalescing ring. ibufFill counts the buffers closed for sending
+	** and ibufSent the buffers whose transfer has completed; the buffer
+	** being filled is ibufFill modulo the ring size. rgdblMsg holds
+	** the time each message of a buffer was written.
+	*/
+	BufPool		pool;
+	BYTE *		rgpbBuf[cbufWrRing];
+	DWORD		rgcbBuf[cbufWrRing];
+	DWORD		rgcmsgBuf[cbufWrRing];
+	double *	rgdblMsg[cbufWrRing];
+	DWORD		ibufFill;
+	DWORD		ibufSent;
+	double		dblFirst;			// time of the first message filled
+
+	pthread_mutex_t	mtx;
+	pthread_cond_t	condIo;
+	pthread_cond_t	condSent;
+	pthread_t	thrIo;
+	BOOL		fThread;
+	BOOL		fStop;
+
+	WRSTAT		stat;
+
+	static void *	IoThread(void * pvWr);
+
+	void	RunIo();
+	BOOL	FSend(BYTE * rgb, DWORD cb);
+	BOOL	FWaitSent(DWORD ibuf);
+	BOOL	FWaitFill();
+	void	CloseFill(DWORD * pcflush);
+	void	AddLatency(DWORD cb, double dblSec);
+	void	SetError(ERC erc);
+
+public:
+	DstmWriter();
+
+	BOOL	FInit(HIF hifInit, WPOL wpolInit, DWORD cbBudgetInit, DWORD tusBudgetInit, DWORD cbBypassInit);
+	BOOL	FWrite(const BYTE * rgb, DWORD cb);
+	BOOL	FFlush(BOOL fWait);
+	BOOL	FSetPolicy(WPOL wpolNew);
+	void	GetStat(WRSTAT * pstat);
+	void	Free();
+
+	WPOL	Wpol()			{ return wpol; }
+	DWORD	CbBudget()		{ return cbBudget; }
+	DWORD	TusBudget()		{ return tusBudget; }
+	DWORD	CbBypass()		{ return cbBypass; }
+};
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+double	DblWrLatPct(const WRLAT * plat, double dblPct);
+
+/* ------------------------------------------------------------ */
+
+#endif					// DSTMWRITER_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,642 @@
+/************************************************************************/
+/*																		*/
+/*  JtgBits.cpp  --  JTAG Buffer Preparation Kernels					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Bit reversal and TMS/TDI pair kernels. See JtgBits.h.			*/
+/*																		*/
+/*		The vector kernels split each byte into nibbles and look		*/
+/*		them up with pshufb in 16 entry tables: the reversed nibble,	*/
+/*		the nibble spread to every other bit, or the TDI and TMS		*/
+/*		bits of two pairs. Reversal puts the reversed low nibble in		*/
+/*		the high half. Interleaving spreads the nibbles of TDI to the	*/
+/*		even bits and those of TMS to the odd bits, then unpacks the	*/
+/*		low and high nibble bytes into pairs of bytes. Deinterleaving	*/
+/*		gathers four TDI bits and four TMS bits from each byte of		*/
+/*		pairs into one byte and joins the bytes of neighboring pairs	*/
+/*		with 16-bit shifts and a pack. AVX2 unpacks and packs within	*/
+/*		each 128-bit lane, so the results are put back in order with	*/
+/*		a cross lane permute.											*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define JTGBITS_X86
+#endif
+
+#include "dpcdecl.h"
+#include "JtgBits.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Bytes handled per kernel call when the caller leaves TMS or TDI out.
+*/
+const DWORD		cbJbBlock		= 4096;
+
+const DWORD		cjbkrnMax		= 4;
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_once_t	onceJb = PTHREAD_ONCE_INIT;
+static JBKRN			jbkrnCur;
+static JBKRN			rgjbkrn[cjbkrnMax];		// supported, slowest first
+static DWORD			cjbkrn;
+
+/* Tables of the portable kernels: each byte spread to the even bits
+** of a word, and the bits 0, 2, 4 and 6 of each byte gathered into a
+** nibble.
+*/
+static WORD			rgwJbSpread[256];
+static BYTE			rgbJbGather[256];
+
+static const BYTE	rgbJbZero[cbJbBlock] = { 0 };
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static void		JbSelectKernels();
+static void		JbReverseScalar(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb);
+static void		JbInterleaveScalar(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+static void		JbDeinterleaveScalar(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb);
+
+#if defined(JTGBITS_X86)
+static void		JbInterleaveBmi2(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+static void		JbDeinterleaveBmi2(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb);
+static void		JbReverseSsse3(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb);
+static void		JbInterleaveSsse3(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+static void		JbDeinterleaveSsse3(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb);
+static void		JbReverseAvx2(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb);
+static void		JbInterleaveAvx2(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+static void		JbDeinterleaveAvx2(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb);
+#endif
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	JtgBitsReverse
+**
+**	Parameters:
+**		rgbDst		- buffer to receive the reversed bytes
+**		rgbSrc		- bytes to reverse, may be rgbDst
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reverses the order of the bits of each byte: bit 0 becomes
+**		bit 7.
+*/
+
+void JtgBitsReverse(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb) {
+
+	pthread_once(&onceJb, JbSelectKernels);
+
+	jbkrnCur.pfnReverse(rgbDst, rgbSrc, cb);
+}
+
+/* ------------------------------------------------------------ */
+/***	JtgBitsInterleave
+**
+**	Parameters:
+**		rgbPair		- buffer to receive 2 * cb bytes of bit pairs
+**		rgbTms		- cb bytes of TMS bits, or NULL for TMS low
+**		rgbTdi		- cb bytes of TDI bits, or NULL for TDI low
+**		cb			- number of bytes of TMS and of TDI
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the bit pairs of DjtgPutTmsTdiBits: bit i of TDI goes
+**		to bit 2i of the pairs and bit i of TMS to bit 2i + 1.
+*/
+
+void JtgBitsInterleave(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb) {
+
+	DWORD	ib;
+	DWORD	cbBlock;
+
+	pthread_once(&onceJb, JbSelectKernels);
+
+	if ((rgbTms != NULL) && (rgbTdi != NULL)) {
+		jbkrnCur.pfnInterleave(rgbPair, rgbTms, rgbTdi, cb);
+		return;
+	}
+
+	for (ib = 0; ib < cb; ib += cbBlock) {
+		cbBlock = (cb - ib < cbJbBlock) ? cb - ib : cbJbBlock;
+		jbkrnCur.pfnInterleave(rgbPair + 2 * ib,
+			(rgbTms != NULL) ? rgbTms + ib : rgbJbZero,
+			(rgbTdi != NULL) ? rgbTdi + ib : rgbJbZero, cbBlock);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	JtgBitsDeinterleave
+**
+**	Parameters:
+**		rgbTms		- buffer to receive cb bytes of TMS bits, or NULL
+**		rgbTdi		- buffer to receive cb bytes of TDI bits, or NULL
+**		rgbPair		- 2 * cb bytes of bit pairs
+**		cb			- number of bytes of TMS and of TDI
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Splits bit pairs into TMS and TDI bits, the reverse of
+**		JtgBitsInterleave. A NULL buffer leaves out its bits.
+*/
+
+void JtgBitsDeinterleave(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb) {
+
+	BYTE	rgbDiscard[cbJbBlock];
+	DWORD	ib;
+	DWORD	cbBlock;
+
+	pthread_once(&onceJb, JbSelectKernels);
+
+	if ((rgbTms != NULL) && (rgbTdi != NULL)) {
+		jbkrnCur.pfnDeinterleave(rgbTms, rgbTdi, rgbPair, cb);
+		return;
+	}
+
+	for (ib = 0; ib < cb; ib += cbBlock) {
+		cbBlock = (cb - ib < cbJbBlock) ? cb - ib : cbJbBlock;
+		jbkrnCur.pfnDeinterleave((rgbTms != NULL) ? rgbTms + ib : rgbDiscard,
+			(rgbTdi != NULL) ? rgbTdi + ib : rgbDiscard, rgbPair + 2 * ib, cbBlock);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	JtgBitsSzKernel
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		name of the kernels in use
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns "avx2", "ssse3", "bmi2" or "scalar".
+*/
+
+const char * JtgBitsSzKernel() {
+
+	pthread_once(&onceJb, JbSelectKernels);
+
+	return jbkrnCur.szName;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJtgBitsGetKernel
+**
+**	Parameters:
+**		ikrn		- kernel set number, from 0
+**		pkrn		- variable to receive the kernel set
+**
+**	Return Value:
+**		fTrue if there is such a kernel set, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Lists the kernel sets the processor supports, slowest first,
+**		so each can be checked and timed. The last one is the set in
+**		use.
+*/
+
+BOOL FJtgBitsGetKernel(DWORD ikrn, JBKRN * pkrn) {
+
+	pthread_once(&onceJb, JbSelectKernels);
+
+	if (ikrn >= cjbkrn) {
+		return fFalse;
+	}
+
+	*pkrn = rgjbkrn[ikrn];
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JbSelectKernels
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Builds the tables of the portable kernels, lists the kernel
+**		sets the processor supports and chooses the fastest. Called
+**		once through pthread_once.
+*/
+
+static void JbSelectKernels() {
+
+	DWORD	b;
+	DWORD	ibit;
+	WORD	w;
+	BYTE	bGather;
+
+	for (b = 0; b < 256; b++) {
+		w = 0;
+		bGather = 0;
+		for (ibit = 0; ibit < 8; ibit++) {
+			if (b & (1 << ibit)) {
+				w |= (WORD) (1 << (2 * ibit));
+				if ((ibit % 2) == 0) {
+					bGather |= (BYTE) (1 << (ibit / 2));
+				}
+			}
+		}
+		rgwJbSpread[b] = w;
+		rgbJbGather[b] = bGather;
+	}
+
+	cjbkrn = 0;
+	rgjbkrn[cjbkrn].szName = "scalar";
+	rgjbkrn[cjbkrn].pfnReverse = JbReverseScalar;
+	rgjbkrn[cjbkrn].pfnInterleave = JbInterleaveScalar;
+	rgjbkrn[cjbkrn].pfnDeinterleave = JbDeinterleaveScalar;
+	cjbkrn++;
+
+#if defined(JTGBITS_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("bmi2")) {
+		rgjbkrn[cjbkrn].szName = "bmi2";
+		rgjbkrn[cjbkrn].pfnReverse = JbReverseScalar;
+		rgjbkrn[cjbkrn].pfnInterleave = JbInterleaveBmi2;
+		rgjbkrn[cjbkrn].pfnDeinterleave = JbDeinterleaveBmi2;
+		cjbkrn++;
+	}
+	if (__builtin_cpu_supports("ssse3")) {
+		rgjbkrn[cjbkrn].szName = "ssse3";
+		rgjbkrn[cjbkrn].pfnReverse = JbReverseSsse3;
+		rgjbkrn[cjbkrn].pfnInterleave = JbInterleaveSsse3;
+		rgjbkrn[cjbkrn].pfnDeinterleave = JbDeinterleaveSsse3;
+		cjbkrn++;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		rgjbkrn[cjbkrn].szName = "avx2";
+		rgjbkrn[cjbkrn].pfnReverse = JbReverseAvx2;
+		rgjbkrn[cjbkrn].pfnInterleave = JbInterleaveAvx2;
+		rgjbkrn[cjbkrn].pfnDeinterleave = JbDeinterleaveAvx2;
+		cjbkrn++;
+	}
+#endif
+
+	jbkrnCur = rgjbkrn[cjbkrn - 1];
+}
+
+/* ------------------------------------------------------------ */
+/*					Scalar Kernels								*/
+/* ------------------------------------------------------------ */
+
+static void JbReverseScalar(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb) {
+
+	uint64_t	qw;
+	DWORD		ib;
+	DWORD		b;
+
+	/* Swap neighboring bits, then pairs, then nibbles; the masks keep
+	** each byte to itself.
+	*/
+	for (ib = 0; ib + 8 <= cb; ib += 8) {
+		memcpy(&qw, rgbSrc + ib, 8);
+		qw = ((qw >> 1) & 0x5555555555555555ULL) | ((qw & 0x5555555555555555ULL) << 1);
+		qw = ((qw >> 2) & 0x3333333333333333ULL) | ((qw & 0x3333333333333333ULL) << 2);
+		qw = ((qw >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((qw & 0x0F0F0F0F0F0F0F0FULL) << 4);
+		memcpy(rgbDst + ib, &qw, 8);
+	}
+	for ( ; ib < cb; ib++) {
+		b = rgbSrc[ib];
+		b = ((b >> 1) & 0x55) | ((b & 0x55) << 1);
+		b = ((b >> 2) & 0x33) | ((b & 0x33) << 2);
+		b = ((b >> 4) & 0x0F) | ((b & 0x0F) << 4);
+		rgbDst[ib] = (BYTE) b;
+	}
+}
+
+/* ------------------------------------------------------------ */
+
+static void JbInterleaveScalar(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb) {
+
+	DWORD	ib;
+	WORD	w;
+
+	for (ib = 0; ib < cb; ib++) {
+		w = rgwJbSpread[rgbTdi[ib]] | (WORD) (rgwJbSpread[rgbTms[ib]] << 1);
+		rgbPair[2 * ib] = (BYTE) w;
+		rgbPair[2 * ib + 1] = (BYTE) (w >> 8);
+	}
+}
+
+/* ------------------------------------------------------------ */
+
+static void JbDeinterleaveScalar(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb) {
+
+	DWORD	ib;
+	BYTE	bLo;
+	BYTE	bHi;
+
+	for (ib = 0; ib < cb; ib++) {
+		bLo = rgbPair[2 * ib];
+		bHi = rgbPair[2 * ib + 1];
+		rgbTdi[ib] = rgbJbGather[bLo & 0x55] | (BYTE) (rgbJbGather[bHi & 0x55] << 4);
+		rgbTms[ib] = rgbJbGather[(bLo >> 1) & 0x55] | (BYTE) (rgbJbGather[(bHi >> 1) & 0x55] << 4);
+	}
+}
+
+#if defined(JTGBITS_X86)
+
+/* ------------------------------------------------------------ */
+/*					BMI2 Kernels								*/
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("bmi2")))
+static void JbInterleaveBmi2(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb) {
+
+	uint64_t	qwTms;
+	uint64_t	qwTdi;
+	uint64_t	qwPair;
+	DWORD		ib;
+
+	for (ib = 0; ib + 8 <= cb; ib += 8) {
+		memcpy(&qwTms, rgbTms + ib, 8);
+		memcpy(&qwTdi, rgbTdi + ib, 8);
+		qwPair = _pdep_u64(qwTdi, 0x5555555555555555ULL) | _pdep_u64(qwTms, 0xAAAAAAAAAAAAAAAAULL);
+		memcpy(rgbPair + 2 * ib, &qwPair, 8);
+		qwPair = _pdep_u64(qwTdi >> 32, 0x5555555555555555ULL) |
+			_pdep_u64(qwTms >> 32, 0xAAAAAAAAAAAAAAAAULL);
+		memcpy(rgbPair + 2 * ib + 8, &qwPair, 8);
+	}
+	JbInterleaveScalar(rgbPair + 2 * ib, rgbTms + ib, rgbTdi + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("bmi2")))
+static void JbDeinterleaveBmi2(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb) {
+
+	uint64_t	qwLo;
+	uint64_t	qwHi;
+	uint64_t	qw;
+	DWORD		ib;
+
+	for (ib = 0; ib + 8 <= cb; ib += 8) {
+		memcpy(&qwLo, rgbPair + 2 * ib, 8);
+		memcpy(&qwHi, rgbPair + 2 * ib + 8, 8);
+		qw = _pext_u64(qwLo, 0x5555555555555555ULL) | (_pext_u64(qwHi, 0x5555555555555555ULL) << 32);
+		memcpy(rgbTdi + ib, &qw, 8);
+		qw = _pext_u64(qwLo, 0xAAAAAAAAAAAAAAAAULL) | (_pext_u64(qwHi, 0xAAAAAAAAAAAAAAAAULL) << 32);
+		memcpy(rgbTms + ib, &qw, 8);
+	}
+	JbDeinterleaveScalar(rgbTms + ib, rgbTdi + ib, rgbPair + 2 * ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+/*					SSSE3 Kernels								*/
+/* ------------------------------------------------------------ */
+
+/* Nibble tables: the reversed nibble in the high and in the low half,
+** the nibble spread to the even and to the odd bits, and the TDI bits
+** of a nibble of pairs in bits 0-3 with its TMS bits in bits 4-7, for
+** the low and for the high nibble of a byte of pairs.
+*/
+#define	JB_REV_HI	0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, \
+					0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0
+#define	JB_REV_LO	0x00, 0x08, 0x04, 0x0C, 0x02, 0x0A, 0x06, 0x0E, \
+					0x01, 0x09, 0x05, 0x0D, 0x03, 0x0B, 0x07, 0x0F
+#define	JB_SPREAD	0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15, \
+					0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+#define	JB_SPREAD1	0x00, 0x02, 0x08, 0x0A, 0x20, 0x22, 0x28, 0x2A, \
+					0x80, 0x82, 0x88, 0x8A, 0xA0, 0xA2, 0xA8, 0xAA
+#define	JB_GATHER_LO	0x00, 0x01, 0x10, 0x11, 0x02, 0x03, 0x12, 0x13, \
+						0x20, 0x21, 0x30, 0x31, 0x22, 0x23, 0x32, 0x33
+#define	JB_GATHER_HI	0x00, 0x04, 0x40, 0x44, 0x08, 0x0C, 0x48, 0x4C, \
+						0x80, 0x84, 0xC0, 0xC4, 0x88, 0x8C, 0xC8, 0xCC
+
+__attribute__ ((target("ssse3")))
+static void JbReverseSsse3(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb) {
+
+	const __m128i	xmmRevHi = _mm_setr_epi8(JB_REV_HI);
+	const __m128i	xmmRevLo = _mm_setr_epi8(JB_REV_LO);
+	const __m128i	xmmNib = _mm_set1_epi8(0x0F);
+	__m128i			xmm;
+	DWORD			ib;
+
+	for (ib = 0; ib + 16 <= cb; ib += 16) {
+		xmm = _mm_loadu_si128((const __m128i *) (rgbSrc + ib));
+		xmm = _mm_or_si128(_mm_shuffle_epi8(xmmRevHi, _mm_and_si128(xmm, xmmNib)),
+			_mm_shuffle_epi8(xmmRevLo, _mm_and_si128(_mm_srli_epi16(xmm, 4), xmmNib)));
+		_mm_storeu_si128((__m128i *) (rgbDst + ib), xmm);
+	}
+	JbReverseScalar(rgbDst + ib, rgbSrc + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("ssse3")))
+static void JbInterleaveSsse3(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb) {
+
+	const __m128i	xmmSpread = _mm_setr_epi8(JB_SPREAD);
+	const __m128i	xmmSpread1 = _mm_setr_epi8(JB_SPREAD1);
+	const __m128i	xmmNib = _mm_set1_epi8(0x0F);
+	__m128i			xmmTms;
+	__m128i			xmmTdi;
+	__m128i			xmmLo;
+	__m128i			xmmHi;
+	DWORD			ib;
+
+	for (ib = 0; ib + 16 <= cb; ib += 16) {
+		xmmTms = _mm_loadu_si128((const __m128i *) (rgbTms + ib));
+		xmmTdi = _mm_loadu_si128((const __m128i *) (rgbTdi + ib));
+		xmmLo = _mm_or_si128(_mm_shuffle_epi8(xmmSpread, _mm_and_si128(xmmTdi, xmmNib)),
+			_mm_shuffle_epi8(xmmSpread1, _mm_and_si128(xmmTms, xmmNib)));
+		xmmHi = _mm_or_si128(
+			_mm_shuffle_epi8(xmmSpread, _mm_and_si128(_mm_srli_epi16(xmmTdi, 4), xmmNib)),
+			_mm_shuffle_epi8(xmmSpread1, _mm_and_si128(_mm_srli_epi16(xmmTms, 4), xmmNib)));
+		_mm_storeu_si128((__m128i *) (rgbPair + 2 * ib), _mm_unpacklo_epi8(xmmLo, xmmHi));
+		_mm_storeu_si128((__m128i *) (rgbPair + 2 * ib + 16), _mm_unpackhi_epi8(xmmLo, xmmHi));
+	}
+	JbInterleaveScalar(rgbPair + 2 * ib, rgbTms + ib, rgbTdi + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("ssse3")))
+static void JbDeinterleaveSsse3(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb) {
+
+	const __m128i	xmmGatherLo = _mm_setr_epi8(JB_GATHER_LO);
+	const __m128i	xmmGatherHi = _mm_setr_epi8(JB_GATHER_HI);
+	const __m128i	xmmNib = _mm_set1_epi8(0x0F);
+	const __m128i	xmmLoNib = _mm_set1_epi16(0x000F);
+	const __m128i	xmmHiNib = _mm_set1_epi16(0x00F0);
+	__m128i			rgxmm[2];
+	__m128i			rgxmmTms[2];
+	__m128i			rgxmmTdi[2];
+	DWORD			ib;
+	int				ixmm;
+
+	for (ib = 0; ib + 16 <= cb; ib += 16) {
+		for (ixmm = 0; ixmm < 2; ixmm++) {
+			rgxmm[ixmm] = _mm_loadu_si128((const __m128i *) (rgbPair + 2 * ib + 16 * ixmm));
+
+			/* Each byte: four TDI bits in bits 0-3, four TMS bits in
+			** bits 4-7. Then join the bytes of each word.
+			*/
+			rgxmm[ixmm] = _mm_or_si128(
+				_mm_shuffle_epi8(xmmGatherLo, _mm_and_si128(rgxmm[ixmm], xmmNib)),
+				_mm_shuffle_epi8(xmmGatherHi, _mm_and_si128(_mm_srli_epi16(rgxmm[ixmm], 4), xmmNib)));
+			rgxmmTdi[ixmm] = _mm_or_si128(_mm_and_si128(rgxmm[ixmm], xmmLoNib),
+				_mm_and_si128(_mm_srli_epi16(rgxmm[ixmm], 4), xmmHiNib));
+			rgxmmTms[ixmm] = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(rgxmm[ixmm], 4), xmmLoNib),
+				_mm_and_si128(_mm_srli_epi16(rgxmm[ixmm], 8), xmmHiNib));
+		}
+		_mm_storeu_si128((__m128i *) (rgbTdi + ib), _mm_packus_epi16(rgxmmTdi[0], rgxmmTdi[1]));
+		_mm_storeu_si128((__m128i *) (rgbTms + ib), _mm_packus_epi16(rgxmmTms[0], rgxmmTms[1]));
+	}
+	JbDeinterleaveScalar(rgbTms + ib, rgbTdi + ib, rgbPair + 2 * ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+/*					AVX2 Kernels								*/
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static void JbReverseAvx2(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb) {
+
+	const __m256i	ymmRevHi = _mm256_setr_epi8(JB_REV_HI, JB_REV_HI);
+	const __m256i	ymmRevLo = _mm256_setr_epi8(JB_REV_LO, JB_REV_LO);
+	const __m256i	ymmNib = _mm256_set1_epi8(0x0F);
+	__m256i			ymm;
+	DWORD			ib;
+
+	for (ib = 0; ib + 32 <= cb; ib += 32) {
+		ymm = _mm256_loadu_si256((const __m256i *) (rgbSrc + ib));
+		ymm = _mm256_or_si256(_mm256_shuffle_epi8(ymmRevHi, _mm256_and_si256(ymm, ymmNib)),
+			_mm256_shuffle_epi8(ymmRevLo, _mm256_and_si256(_mm256_srli_epi16(ymm, 4), ymmNib)));
+		_mm256_storeu_si256((__m256i *) (rgbDst + ib), ymm);
+	}
+	JbReverseSsse3(rgbDst + ib, rgbSrc + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static void JbInterleaveAvx2(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb) {
+
+	const __m256i	ymmSpread = _mm256_setr_epi8(JB_SPREAD, JB_SPREAD);
+	const __m256i	ymmSpread1 = _mm256_setr_epi8(JB_SPREAD1, JB_SPREAD1);
+	const __m256i	ymmNib = _mm256_set1_epi8(0x0F);
+	__m256i			ymmTms;
+	__m256i			ymmTdi;
+	__m256i			ymmLo;
+	__m256i			ymmHi;
+	__m256i			ymmA;
+	__m256i			ymmB;
+	DWORD			ib;
+
+	for (ib = 0; ib + 32 <= cb; ib += 32) {
+		ymmTms = _mm256_loadu_si256((const __m256i *) (rgbTms + ib));
+		ymmTdi = _mm256_loadu_si256((const __m256i *) (rgbTdi + ib));
+		ymmLo = _mm256_or_si256(_mm256_shuffle_epi8(ymmSpread, _mm256_and_si256(ymmTdi, ymmNib)),
+			_mm256_shuffle_epi8(ymmSpread1, _mm256_and_si256(ymmTms, ymmNib)));
+		ymmHi = _mm256_or_si256(
+			_mm256_shuffle_epi8(ymmSpread, _mm256_and_si256(_mm256_srli_epi16(ymmTdi, 4), ymmNib)),
+			_mm256_shuffle_epi8(ymmSpread1, _mm256_and_si256(_mm256_srli_epi16(ymmTms, 4), ymmNib)));
+
+		/* The unpacks hold bytes 0-7 and 16-23, and 8-15 and 24-31.
+		*/
+		ymmA = _mm256_unpacklo_epi8(ymmLo, ymmHi);
+		ymmB = _mm256_unpackhi_epi8(ymmLo, ymmHi);
+		_mm256_storeu_si256((__m256i *) (rgbPair + 2 * ib), _mm256_permute2x128_si256(ymmA, ymmB, 0x20));
+		_mm256_storeu_si256((__m256i *) (rgbPair + 2 * ib + 32), _mm256_permute2x128_si256(ymmA, ymmB, 0x31));
+	}
+	JbInterleaveSsse3(rgbPair + 2 * ib, rgbTms + ib, rgbTdi + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static void JbDeinterleaveAvx2(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb) {
+
+	const __m256i	ymmGatherLo = _mm256_setr_epi8(JB_GATHER_LO, JB_GATHER_LO);
+	const __m256i	ymmGatherHi = _mm256_setr_epi8(JB_GATHER_HI, JB_GATHER_HI);
+	const __m256i	ymmNib = _mm256_set1_epi8(0x0F);
+	const __m256i	ymmLoNib = _mm256_set1_epi16(0x000F);
+	const __m256i	ymmHiNib = _mm256_set1_epi16(0x00F0);
+	__m256i			rgymm[2];
+	__m256i			rgymmTms[2];
+	__m256i			rgymmTdi[2];
+	DWORD			ib;
+	int				iymm;
+
+	for (ib = 0; ib + 32 <= cb; ib += 32) {
+		for (iymm = 0; iymm < 2; iymm++) {
+			rgymm[iymm] = _mm256_loadu_si256((const __m256i *) (rgbPair + 2 * ib + 32 * iymm));
+			rgymm[iymm] = _mm256_or_si256(
+				_mm256_shuffle_epi8(ymmGatherLo, _mm256_and_si256(rgymm[iymm], ymmNib)),
+				_mm256_shuffle_epi8(ymmGatherHi, _mm256_and_si256(_mm256_srli_epi16(rgymm[iymm], 4), ymmNib)));
+			rgymmTdi[iymm] = _mm256_or_si256(_mm256_and_si256(rgymm[iymm], ymmLoNib),
+				_mm256_and_si256(_mm256_srli_epi16(rgymm[iymm], 4), ymmHiNib));
+			rgymmTms[iymm] = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi16(rgymm[iymm], 4), ymmLoNib),
+				_mm256_and_si256(_mm256_srli_epi16(rgymm[iymm], 8), ymmHiNib));
+		}
+
+		/* The packs hold the quarters in the order 0, 2, 1, 3.
+		*/
+		_mm256_storeu_si256((__m256i *) (rgbTdi + ib),
+			_mm256_permute4x64_epi64(_mm256_packus_epi16(rgymmTdi[0], rgymmTdi[1]), 0xD8));
+		_mm256_storeu_si256((__m256i *) (rgbTms + ib),
+			_mm256_permute4x64_epi64(_mm256_packus_epi16(rgymmTms[0], rgymmTms[1]), 0xD8));
+	}
+	JbDeinterleaveSsse3(rgbTms + ib, rgbTdi + ib, rgbPair + 2 * ib, cb - ib);
+}
+
+#endif
+
+/************************************************************************/
@@ -0,0 +1,86 @@
+/************************************************************************/
+/*																		*/
+/*  JtgBits.h  --  JTAG Buffer Preparation Kernel Declarations			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Kernels that prepare the buffers of DJTG calls:					*/
+/*																		*/
+/*			JtgBitsReverse		- reverses the bits of each byte, as	*/
+/*								  a Xilinx bitstream is shifted most	*/
+/*								  significant bit first and DJTG		*/
+/*								  shifts the least significant first	*/
+/*			JtgBitsInterleave	- makes the TMS/TDI bit pairs of		*/
+/*								  DjtgPutTmsTdiBits from separate TMS	*/
+/*								  and TDI bits							*/
+/*			JtgBitsDeinterleave	- splits bit pairs back into TMS and	*/
+/*								  TDI bits								*/
+/*																		*/
+/*		Bits are packed least significant bit first. A byte of TMS		*/
+/*		and a byte of TDI make two bytes of pairs, TDI in the even		*/
+/*		bits and TMS in the odd bits, first clock in bits 0 and 1.		*/
+/*																		*/
+/*		Each has an AVX2 and an SSSE3 kernel, which look nibbles up		*/
+/*		in 16 entry tables with pshufb, a BMI2 kernel, which moves		*/
+/*		bits with pdep and pext, and a portable one. The fastest		*/
+/*		kernel the processor supports is chosen when the program		*/
+/*		runs; FJtgBitsGetKernel lists all of them for tests and			*/
+/*		benchmarks. The BMI2 kernels are chosen only when the vector	*/
+/*		ones are not available, as pdep and pext are microcoded on		*/
+/*		some processors.												*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(JTGBITS_INCLUDED)
+#define      JTGBITS_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Kernels. cb is the number of bytes of bits, TMS and TDI each for the
+** pair kernels, which read or write 2 * cb bytes of pairs. The buffers
+** must not overlap, except that JtgBitsReverse may reverse in place.
+*/
+typedef void	(* PFNJBREVERSE)(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb);
+typedef void	(* PFNJBINTERLEAVE)(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+typedef void	(* PFNJBDEINTERLEAVE)(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb);
+
+/* A set of kernels.
+*/
+typedef struct tagJBKRN {
+	const char *		szName;
+	PFNJBREVERSE		pfnReverse;
+	PFNJBINTERLEAVE		pfnInterleave;
+	PFNJBDEINTERLEAVE	pfnDeinterleave;
+} JBKRN;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+/* Unlike the kernels, JtgBitsInterleave takes NULL for TMS or TDI held
+** low and JtgBitsDeinterleave NULL for bits that are not wanted.
+*/
+void	JtgBitsReverse(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb);
+void	JtgBitsInterleave(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+void	JtgBitsDeinterleave(BYTE * rgbTms, BYTE * rgbTdi, const BYTE * rgbPair, DWORD cb);
+
+const char *	JtgBitsSzKernel();
+BOOL	FJtgBitsGetKernel(DWORD ikrn, JBKRN * pkrn);
+
+/* ------------------------------------------------------------ */
+
+#endif					// JTGBITS_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,1993 @@
+/************************************************************************/
+/*																		*/
+/*  JtscIndex.cpp  --  JTAG Device List Index							*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Compiles jtscdvclist.txt into a binary index, caches the index	*/
+/*		next to the list and identifies IDCODEs with it. See			*/
+/*		JtscIndex.h.													*/
+/*																		*/
+/*		The list is made of blocks, name{ ... }, and lines of			*/
+/*		entries; ; starts a comment. The top level holds the VENDOR		*/
+/*		block and a block per vendor. A vendor block holds its FAMILY	*/
+/*		block and a block per family, which holds TYPE, IRLEN and ALG	*/
+/*		settings and its COMMANDS and DEVICES blocks. The compiler		*/
+/*		reads the entries a line at a time, so a malformed line does	*/
+/*		not affect the lines after it.									*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "dpcdecl.h"
+#include "JtscIndex.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Kinds of entry block.
+*/
+typedef enum {
+	kindVid = 0,
+	kindFid,
+	kindCmd,
+	kindDev,
+	kindSkip
+} KIND;
+
+/* A token of the list: a word, or one of { } =.
+*/
+typedef struct tagJSCTOK {
+	const char *	pch;
+	DWORD			cch;
+	DWORD			iline;
+} JSCTOK;
+
+/* An entry being compiled, with the line it came from. ichName and
+** ivnd of a FAMILY entry name its family until the families are
+** resolved.
+*/
+typedef struct tagJSCENT {
+	DWORD		dwValue;
+	DWORD		dwMask;
+	DWORD		ichName;
+	DWORD		ivnd;
+	DWORD		ifam;
+	DWORD		iline;
+} JSCENT;
+
+/* Entries of the hash tables of one kind.
+*/
+typedef struct tagJSCKEY {
+	DWORD		dwValue;
+	DWORD		dwMask;
+	DWORD		ivnd;
+	DWORD		iline;
+} JSCKEY;
+
+/* State of the compiler. Each array has its count and the count
+** allocated.
+*/
+typedef struct tagJSCBLD {
+	char *		rgchList;
+	DWORD		cchList;
+	JSCTOK *	rgtok;
+	DWORD		ctok;
+	DWORD		ctokMax;
+	DWORD		itok;
+
+	JSCENT *	rgvid;
+	DWORD		cvid;
+	DWORD		cvidMax;
+	JSCENT *	rgfid;
+	DWORD		cfid;
+	DWORD		cfidMax;
+	JSCENT *	rgdev;
+	DWORD		cdev;
+	DWORD		cdevMax;
+	JSCFAM *	rgfam;
+	DWORD		cfam;
+	DWORD		cfamMax;
+	DWORD *		rgilineFam;
+	DWORD		cilineFamMax;
+	JSCCMD *	rgcmd;
+	DWORD		ccmd;
+	DWORD		ccmdMax;
+	DWORD *		rgichVnd;			// vendor block names
+	DWORD		cvnd;
+	DWORD		cvndMax;
+	JSCGRP *	rggrp;
+	DWORD		cgrp;
+	DWORD		cgrpMax;
+	JSCSLOT *	rgslot;
+	DWORD		cslot;
+	DWORD		cslotMax;
+	JSCMSG *	rgmsg;
+	DWORD		cmsg;
+	DWORD		cmsgMax;
+	char *		rgchStr;
+	DWORD		cbStr;
+	DWORD		cbStrMax;
+
+	BOOL		fNoMem;
+} JSCBLD;
+
+/* Longest token read as a number, and longest message.
+*/
+const DWORD		cchJscNumMax	= 32;
+const DWORD		cchJscMsgMax	= 256;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static DWORD	IslotJscHash(DWORD dwKey, DWORD ivnd, DWORD cbitSlot);
+static BOOL		FJscGrow(JSCBLD * pbld, void ** ppv, DWORD * pcMax, DWORD c, size_t cb);
+static DWORD	IchJscAdd(JSCBLD * pbld, const char * pch, DWORD cch);
+static void		JscMsg(JSCBLD * pbld, DWORD iline, BOOL fError, const char * szFmt, ...);
+static BOOL		FJscTokenize(JSCBLD * pbld);
+static BOOL		FJscTokIs(const JSCTOK * ptok, const char * sz);
+static BOOL		FJscWord(JSCBLD * pbld, DWORD itok);
+static BOOL		FJscHex(JSCBLD * pbld, const JSCTOK * ptok, const char * szWhat, DWORD * pdw);
+static BOOL		FJscDec(JSCBLD * pbld, const JSCTOK * ptok, const char * szWhat, DWORD * pdw);
+static void		JscParseTop(JSCBLD * pbld);
+static void		JscParseVendor(JSCBLD * pbld, const JSCTOK * ptokName);
+static void		JscParseFamily(JSCBLD * pbld, DWORD ivnd, const JSCTOK * ptokName);
+static void		JscParseEntries(JSCBLD * pbld, KIND kind, DWORD ivnd, DWORD ifam, const JSCTOK * ptokName, const JSCTOK * ptokBlock);
+static void		JscAddEntry(JSCBLD * pbld, KIND kind, DWORD ivnd, DWORD ifam, const JSCTOK * rgtok, DWORD ctok);
+static void		JscResolve(JSCBLD * pbld);
+static BOOL		FJscBuildTable(JSCBLD * pbld, const JSCKEY * rgkey, DWORD ckey, const char * szKind, DWORD * pigrp, DWORD * pcgrp);
+static DWORD	CbitJscMask(DWORD dwMask);
+static BOOL		FJscWriteIndex(JSCBLD * pbld, const struct stat * pstList, BYTE ** ppbIndex, size_t * pcbIndex);
+static void		JscFreeBld(JSCBLD * pbld);
+static BOOL		FJscIndexPath(const char * szList, char * szIndex, DWORD cchIndex);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	JtscIndex::JtscIndex
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The index is empty until FInit.
+*/
+
+JtscIndex::JtscIndex() {
+
+	pbIndex = NULL;
+	cbIndex = 0;
+	fMapped = fFalse;
+	fCompiled = fFalse;
+	fWritten = fFalse;
+	szIndex[0] = '\0';
+
+	phdr = NULL;
+	rgvid = NULL;
+	rgfam = NULL;
+	rgfid = NULL;
+	rgdev = NULL;
+	rgcmd = NULL;
+	rggrp = NULL;
+	rgslot = NULL;
+	rgmsg = NULL;
+	rgchStr = NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::FInit
+**
+**	Parameters:
+**		szList		- path of the device list, NULL for the list of
+**					  the Runtime data directory
+**		fjsc		- options, fjscXxx
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Fails if the list cannot be read.
+**
+**	Description:
+**		Maps the index next to the list if it was compiled from the
+**		list as it is now. Otherwise compiles the list and writes the
+**		index, unless fjscNoWrite is given; if the index cannot be
+**		written it is kept in memory.
+*/
+
+BOOL JtscIndex::FInit(const char * szList, DWORD fjsc) {
+
+	char		szDefault[cchJscPathMax];
+	char		szTmp[cchJscPathMax + 32];
+	struct stat	stList;
+	BYTE *		pb;
+	size_t		cb;
+	FILE *		fp;
+	BOOL		fOk;
+
+	Free();
+
+	if (szList == NULL) {
+		if (!FJscDataPath(szDefault, cchJscPathMax - sizeof(szJscList) - 1)) {
+			return fFalse;
+		}
+		strcat(szDefault, "/" szJscList);
+		szList = szDefault;
+	}
+
+	if ((stat(szList, &stList) != 0) || !FJscIndexPath(szList, szIndex, cchJscPathMax)) {
+		return fFalse;
+	}
+
+	if (((fjsc & fjscRebuild) == 0) && FMap(szIndex, &stList)) {
+		return fTrue;
+	}
+
+	if (!FJscCompile(szList, &pb, &cb)) {
+		return fFalse;
+	}
+	fCompiled = fTrue;
+
+	/* Write the index under a temporary name and rename it, so that
+	** another process never maps a partly written index.
+	*/
+	if ((fjsc & fjscNoWrite) == 0) {
+		snprintf(szTmp, sizeof(szTmp), "%s.%ld", szIndex, (long) getpid());
+		fp = fopen(szTmp, "wb");
+		if (fp != NULL) {
+			fOk = (fwrite(pb, 1, cb, fp) == cb);
+			fOk = (fclose(fp) == 0) && fOk;
+			fOk = fOk && (rename(szTmp, szIndex) == 0);
+			if (!fOk) {
+				unlink(szTmp);
+			}
+			else if (FMap(szIndex, &stList)) {
+				fWritten = fTrue;
+				free(pb);
+				return fTrue;
+			}
+		}
+	}
+
+	if (!FAttach(pb, cb)) {
+		free(pb);
+		return fFalse;
+	}
+	fMapped = fFalse;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Unmaps or frees the index. The strings returned by FIdentify
+**		and FGetMsg are no longer valid.
+*/
+
+void JtscIndex::Free() {
+
+	if (pbIndex != NULL) {
+		if (fMapped) {
+			munmap(pbIndex, cbIndex);
+		}
+		else {
+			free(pbIndex);
+		}
+	}
+
+	pbIndex = NULL;
+	cbIndex = 0;
+	fMapped = fFalse;
+	fCompiled = fFalse;
+	fWritten = fFalse;
+	phdr = NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::FIdentify
+**
+**	Parameters:
+**		idcode		- IDCODE read from the device
+**		pid			- variable to receive the identification
+**
+**	Return Value:
+**		fTrue if the family is known, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks the IDCODE up in the DEVICES entries, and if it is not
+**		there, in the FAMILY entries of its vendor. The list gives
+**		IDCODEs of known vendors that are not otherwise known to an
+**		UNKNOWN family with no instruction register length.
+*/
+
+BOOL JtscIndex::FIdentify(DWORD idcode, JSCID * pid) {
+
+	const JSCFAM *	pfam;
+	DWORD			ient;
+	DWORD			ivnd;
+
+	memset(pid, 0, sizeof(JSCID));
+	pid->idcode = idcode;
+	pid->ifam = ijscNone;
+
+	if (phdr == NULL) {
+		return fFalse;
+	}
+
+	ient = IentLookup(phdr->igrpDev, phdr->cgrpDev, idcode, 0);
+	if (ient != ijscNone) {
+		pid->ifam = rgdev[ient].ifam;
+		pid->szDevice = rgchStr + rgdev[ient].ichName;
+	}
+
+	ient = IentLookup(phdr->igrpVid, phdr->cgrpVid, idcode, 0);
+	if (ient != ijscNone) {
+		pid->szVendor = rgchStr + rgvid[ient].ichName;
+		ivnd = rgvid[ient].ivnd;
+
+		if ((pid->ifam == ijscNone) && (ivnd != ijscNone)) {
+			ient = IentLookup(phdr->igrpFid, phdr->cgrpFid, idcode, ivnd);
+			if (ient != ijscNone) {
+				pid->ifam = rgfid[ient].ifam;
+			}
+		}
+	}
+
+	if (pid->ifam == ijscNone) {
+		return fFalse;
+	}
+
+	pfam = &rgfam[pid->ifam];
+	pid->szVendor = rgchStr + pfam->ichVendor;
+	pid->szFamily = rgchStr + pfam->ichName;
+	pid->szType = rgchStr + pfam->ichType;
+	pid->cbitIr = pfam->cbitIr;
+	pid->alg = pfam->alg;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::FGetCommand
+**
+**	Parameters:
+**		ifam		- family returned by FIdentify
+**		szName		- name of the command, such as CFG_IN
+**		pdwOpcode	- variable to receive the instruction
+**
+**	Return Value:
+**		fTrue if the family has the command, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks up an entry of the COMMANDS block of a family.
+*/
+
+BOOL JtscIndex::FGetCommand(DWORD ifam, const char * szName, DWORD * pdwOpcode) {
+
+	DWORD	icmd;
+
+	if ((phdr == NULL) || (ifam >= phdr->cfam)) {
+		return fFalse;
+	}
+
+	for (icmd = rgfam[ifam].icmd; icmd < rgfam[ifam].icmd + rgfam[ifam].ccmd; icmd++) {
+		if (strcmp(rgchStr + rgcmd[icmd].ichName, szName) == 0) {
+			*pdwOpcode = rgcmd[icmd].dwOpcode;
+			return fTrue;
+		}
+	}
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::FGetMsg
+**
+**	Parameters:
+**		imsg		- message number, less than Cmsg
+**		piline		- variable to receive the line of the list
+**		pfError		- variable set if the entry was left out
+**		pszText		- variable to receive the message
+**
+**	Return Value:
+**		fTrue if successful, fFalse if there is no such message
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns a message about a malformed entry of the list.
+*/
+
+BOOL JtscIndex::FGetMsg(DWORD imsg, DWORD * piline, BOOL * pfError, const char ** pszText) {
+
+	if ((phdr == NULL) || (imsg >= phdr->cmsg)) {
+		return fFalse;
+	}
+
+	*piline = rgmsg[imsg].iline;
+	*pfError = rgmsg[imsg].fError ? fTrue : fFalse;
+	*pszText = rgchStr + rgmsg[imsg].ichText;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::FMap
+**
+**	Parameters:
+**		szIndexFile		- path of the index
+**		pstList			- status of the list
+**
+**	Return Value:
+**		fTrue if the index was mapped, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Maps the index if it exists, is valid and was compiled from a
+**		list of the size and modification time of the list.
+*/
+
+BOOL JtscIndex::FMap(const char * szIndexFile, const struct stat * pstList) {
+
+	struct stat		st;
+	const JSCHDR *	phdrFile;
+	void *			pv;
+	int				fd;
+
+	fd = open(szIndexFile, O_RDONLY);
+	if (fd < 0) {
+		return fFalse;
+	}
+
+	if ((fstat(fd, &st) != 0) || ((size_t) st.st_size < sizeof(JSCHDR))) {
+		close(fd);
+		return fFalse;
+	}
+
+	pv = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+	close(fd);
+	if (pv == MAP_FAILED) {
+		return fFalse;
+	}
+
+	phdrFile = (const JSCHDR *) pv;
+	if ((phdrFile->dwMagic != dwJscMagic) || (phdrFile->ver != verJscIndex) ||
+		(phdrFile->cbFile != (DWORD) st.st_size) ||
+		(phdrFile->cbList != (DWORD) pstList->st_size) ||
+		(phdrFile->tsList != (long long) pstList->st_mtim.tv_sec) ||
+		(phdrFile->tnsList != (long long) pstList->st_mtim.tv_nsec) ||
+		!FAttach((BYTE *) pv, (size_t) st.st_size)) {
+
+		munmap(pv, (size_t) st.st_size);
+		return fFalse;
+	}
+
+	fMapped = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::FAttach
+**
+**	Parameters:
+**		pb		- index
+**		cb		- its length
+**
+**	Return Value:
+**		fTrue if the index is valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Checks that the sections and hash tables of an index lie
+**		within it and makes it the index of the object.
+*/
+
+BOOL JtscIndex::FAttach(BYTE * pb, size_t cb) {
+
+	const JSCHDR *	phdrNew;
+	const JSCGRP *	rggrpNew;
+	DWORD			igrp;
+
+	phdrNew = (const JSCHDR *) pb;
+
+	if ((cb < sizeof(JSCHDR)) || (phdrNew->cbFile != cb) ||
+		(phdrNew->ibVid + (size_t) phdrNew->cvid * sizeof(JSCVID) > cb) ||
+		(phdrNew->ibFam + (size_t) phdrNew->cfam * sizeof(JSCFAM) > cb) ||
+		(phdrNew->ibFid + (size_t) phdrNew->cfid * sizeof(JSCFID) > cb) ||
+		(phdrNew->ibDev + (size_t) phdrNew->cdev * sizeof(JSCDEV) > cb) ||
+		(phdrNew->ibCmd + (size_t) phdrNew->ccmd * sizeof(JSCCMD) > cb) ||
+		(phdrNew->ibGrp + (size_t) phdrNew->cgrp * sizeof(JSCGRP) > cb) ||
+		(phdrNew->ibSlot + (size_t) phdrNew->cslot * sizeof(JSCSLOT) > cb) ||
+		(phdrNew->ibMsg + (size_t) phdrNew->cmsg * sizeof(JSCMSG) > cb) ||
+		(phdrNew->ibStr + (size_t) phdrNew->cbStr > cb) ||
+		(phdrNew->cbStr == 0) || (pb[phdrNew->ibStr + phdrNew->cbStr - 1] != '\0') ||
+		(phdrNew->igrpDev + phdrNew->cgrpDev > phdrNew->cgrp) ||
+		(phdrNew->igrpFid + phdrNew->cgrpFid > phdrNew->cgrp) ||
+		(phdrNew->igrpVid + phdrNew->cgrpVid > phdrNew->cgrp)) {
+
+		return fFalse;
+	}
+
+	rggrpNew = (const JSCGRP *) (pb + phdrNew->ibGrp);
+	for (igrp = 0; igrp < phdrNew->cgrp; igrp++) {
+		if ((rggrpNew[igrp].cbitSlot == 0) || (rggrpNew[igrp].cbitSlot > 31) ||
+			(rggrpNew[igrp].islot + ((size_t) 1 << rggrpNew[igrp].cbitSlot) > phdrNew->cslot)) {
+			return fFalse;
+		}
+	}
+
+	pbIndex = pb;
+	cbIndex = cb;
+	phdr = phdrNew;
+	rgvid = (const JSCVID *) (pb + phdr->ibVid);
+	rgfam = (const JSCFAM *) (pb + phdr->ibFam);
+	rgfid = (const JSCFID *) (pb + phdr->ibFid);
+	rgdev = (const JSCDEV *) (pb + phdr->ibDev);
+	rgcmd = (const JSCCMD *) (pb + phdr->ibCmd);
+	rggrp = rggrpNew;
+	rgslot = (const JSCSLOT *) (pb + phdr->ibSlot);
+	rgmsg = (const JSCMSG *) (pb + phdr->ibMsg);
+	rgchStr = (const char *) (pb + phdr->ibStr);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtscIndex::IentLookup
+**
+**	Parameters:
+**		igrpFirst	- first hash table of the kind of entry
+**		cgrp		- number of tables
+**		idcode		- IDCODE to look up
+**		ivnd		- vendor of a FAMILY entry, 0 for the others
+**
+**	Return Value:
+**		index of the entry, ijscNone if not found
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Probes the table of each mask, most specific mask first,
+**		and returns the first entry that matches.
+*/
+
+DWORD JtscIndex::IentLookup(DWORD igrpFirst, DWORD cgrp, DWORD idcode, DWORD ivnd) {
+
+	const JSCGRP *	pgrp;
+	const JSCSLOT *	pslot;
+	DWORD			dwKey;
+	DWORD			islot;
+	DWORD			islotMask;
+	DWORD			igrp;
+
+	for (igrp = igrpFirst; igrp < igrpFirst + cgrp; igrp++) {
+		pgrp = &rggrp[igrp];
+		dwKey = idcode & pgrp->dwMask;
+		islotMask = (1 << pgrp->cbitSlot) - 1;
+
+		for (islot = IslotJscHash(dwKey, ivnd, pgrp->cbitSlot); ; islot = (islot + 1) & islotMask) {
+			pslot = &rgslot[pgrp->islot + islot];
+			if (pslot->ient == 0) {
+				break;
+			}
+			if ((pslot->dwKey == dwKey) && (pslot->ivnd == ivnd)) {
+				return pslot->ient - 1;
+			}
+		}
+	}
+
+	return ijscNone;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscDataPath
+**
+**	Parameters:
+**		szPath		- buffer to receive the path
+**		cchPath		- size of the buffer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the path does not fit
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the data directory of the Runtime: DigilentDataPath
+**		of the Runtime configuration file, or the default directory
+**		if the file does not set it.
+*/
+
+BOOL FJscDataPath(char * szPath, DWORD cchPath) {
+
+	char	szLine[cchJscPathMax + 32];
+	FILE *	fp;
+	size_t	cch;
+	BOOL	fFound;
+
+	fFound = fFalse;
+
+	fp = fopen(szJscConf, "r");
+	if (fp != NULL) {
+		while (!fFound && (fgets(szLine, sizeof(szLine), fp) != NULL)) {
+			if (strncmp(szLine, "DigilentDataPath=", 17) == 0) {
+				cch = strlen(szLine);
+				while ((cch > 17) && ((szLine[cch - 1] == '\n') || (szLine[cch - 1] == '\r'))) {
+					szLine[--cch] = '\0';
+				}
+				if ((cch > 17) && (cch - 17 < cchPath)) {
+					strcpy(szPath, szLine + 17);
+					fFound = fTrue;
+				}
+			}
+		}
+		fclose(fp);
+	}
+
+	if (!fFound) {
+		if (sizeof(szJscDataDefault) > cchPath) {
+			return fFalse;
+		}
+		strcpy(szPath, szJscDataDefault);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscCompile
+**
+**	Parameters:
+**		szList		- path of the device list
+**		ppbIndex	- variable to receive the index
+**		pcbIndex	- variable to receive its length
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Fails if the list cannot be read or memory runs out.
+**		Malformed entries do not make it fail; they are reported by
+**		the messages of the index.
+**
+**	Description:
+**		Compiles the list into an index allocated with malloc.
+*/
+
+BOOL FJscCompile(const char * szList, BYTE ** ppbIndex, size_t * pcbIndex) {
+
+	JSCBLD		bld;
+	struct stat	stList;
+	FILE *		fp;
+	BOOL		fOk;
+
+	memset(&bld, 0, sizeof(bld));
+
+	fp = fopen(szList, "rb");
+	if (fp == NULL) {
+		return fFalse;
+	}
+
+	fOk = (fstat(fileno(fp), &stList) == 0);
+	if (fOk) {
+		bld.cchList = (DWORD) stList.st_size;
+		bld.rgchList = (char *) malloc(bld.cchList + 1);
+		fOk = (bld.rgchList != NULL) && (fread(bld.rgchList, 1, bld.cchList, fp) == bld.cchList);
+	}
+	fclose(fp);
+
+	/* The string section starts with the empty string, the value of
+	** missing names.
+	*/
+	fOk = fOk && (IchJscAdd(&bld, "", 0) == 0);
+	fOk = fOk && FJscTokenize(&bld);
+
+	if (fOk) {
+		JscParseTop(&bld);
+		JscResolve(&bld);
+		fOk = !bld.fNoMem && FJscWriteIndex(&bld, &stList, ppbIndex, pcbIndex);
+	}
+
+	JscFreeBld(&bld);
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	IslotJscHash
+**
+**	Parameters:
+**		dwKey		- masked IDCODE
+**		ivnd		- vendor of a FAMILY entry, 0 for the others
+**		cbitSlot	- log2 of the number of slots
+**
+**	Return Value:
+**		first slot to probe
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Multiplicative hash of the key and the vendor.
+*/
+
+static DWORD IslotJscHash(DWORD dwKey, DWORD ivnd, DWORD cbitSlot) {
+
+	return (DWORD) (((dwKey ^ (ivnd * 0x85EBCA6BU)) * 0x9E3779B1U) >> (32 - cbitSlot));
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscGrow
+**
+**	Parameters:
+**		pbld		- compiler state
+**		ppv			- array
+**		pcMax		- elements allocated
+**		c			- elements needed
+**		cb			- size of an element
+**
+**	Return Value:
+**		fTrue if the array holds c elements, fFalse if not
+**
+**	Errors:
+**		Sets fNoMem if memory runs out.
+**
+**	Description:
+**		Doubles an array until it holds c elements.
+*/
+
+static BOOL FJscGrow(JSCBLD * pbld, void ** ppv, DWORD * pcMax, DWORD c, size_t cb) {
+
+	DWORD	cMax;
+	void *	pv;
+
+	if (c <= *pcMax) {
+		return fTrue;
+	}
+
+	cMax = (*pcMax == 0) ? 64 : *pcMax;
+	while (cMax < c) {
+		cMax *= 2;
+	}
+
+	pv = realloc(*ppv, (size_t) cMax * cb);
+	if (pv == NULL) {
+		pbld->fNoMem = fTrue;
+		return fFalse;
+	}
+
+	*ppv = pv;
+	*pcMax = cMax;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	IchJscAdd
+**
+**	Parameters:
+**		pbld		- compiler state
+**		pch			- characters of the string
+**		cch			- their number
+**
+**	Return Value:
+**		offset of the string in the string section
+**
+**	Errors:
+**		Returns 0, the empty string, if memory runs out.
+**
+**	Description:
+**		Adds a string to the string section.
+*/
+
+static DWORD IchJscAdd(JSCBLD * pbld, const char * pch, DWORD cch) {
+
+	DWORD	ich;
+
+	if (!FJscGrow(pbld, (void **) &pbld->rgchStr, &pbld->cbStrMax, pbld->cbStr + cch + 1, 1)) {
+		return 0;
+	}
+
+	ich = pbld->cbStr;
+	memcpy(pbld->rgchStr + ich, pch, cch);
+	pbld->rgchStr[ich + cch] = '\0';
+	pbld->cbStr += cch + 1;
+
+	return ich;
+}
+
+/* ------------------------------------------------------------ */
+/***	JscMsg
+**
+**	Parameters:
+**		pbld		- compiler state
+**		iline		- line of the list
+**		fError		- fTrue if the entry is left out
+**		szFmt		- printf format of the message
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Adds a message about an entry of the list.
+*/
+
+static void JscMsg(JSCBLD * pbld, DWORD iline, BOOL fError, const char * szFmt, ...) {
+
+	char	szText[cchJscMsgMax];
+	va_list	va;
+	DWORD	ichText;
+
+	va_start(va, szFmt);
+	vsnprintf(szText, sizeof(szText), szFmt, va);
+	va_end(va);
+
+	ichText = IchJscAdd(pbld, szText, (DWORD) strlen(szText));
+
+	if (FJscGrow(pbld, (void **) &pbld->rgmsg, &pbld->cmsgMax, pbld->cmsg + 1, sizeof(JSCMSG))) {
+		pbld->rgmsg[pbld->cmsg].iline = iline;
+		pbld->rgmsg[pbld->cmsg].fError = fError ? 1 : 0;
+		pbld->rgmsg[pbld->cmsg].ichText = ichText;
+		pbld->cmsg++;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscTokenize
+**
+**	Parameters:
+**		pbld		- compiler state
+**
+**	Return Value:
+**		fTrue if successful, fFalse if memory runs out
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Splits the list into words and the characters { } =, each
+**		with its line number, leaving out comments.
+*/
+
+static BOOL FJscTokenize(JSCBLD * pbld) {
+
+	const char *	pch;
+	const char *	pchEnd;
+	const char *	pchWord;
+	DWORD			iline;
+
+	pch = pbld->rgchList;
+	pchEnd = pch + pbld->cchList;
+	iline = 1;
+
+	while (pch < pchEnd) {
+		if (*pch == '\n') {
+			iline++;
+			pch++;
+		}
+		else if ((*pch == ' ') || (*pch == '\t') || (*pch == '\r') || (*pch == '\0')) {
+			pch++;
+		}
+		else if (*pch == ';') {
+			while ((pch < pchEnd) && (*pch != '\n')) {
+				pch++;
+			}
+		}
+		else {
+			pchWord = pch;
+			if ((*pch == '{') || (*pch == '}') || (*pch == '=')) {
+				pch++;
+			}
+			else {
+				while ((pch < pchEnd) && (strchr(" \t\r\n;{}=", *pch) == NULL)) {
+					pch++;
+				}
+			}
+
+			if (!FJscGrow(pbld, (void **) &pbld->rgtok, &pbld->ctokMax, pbld->ctok + 1, sizeof(JSCTOK))) {
+				return fFalse;
+			}
+			pbld->rgtok[pbld->ctok].pch = pchWord;
+			pbld->rgtok[pbld->ctok].cch = (DWORD) (pch - pchWord);
+			pbld->rgtok[pbld->ctok].iline = iline;
+			pbld->ctok++;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscTokIs
+**
+**	Parameters:
+**		ptok		- token
+**		sz			- string
+**
+**	Return Value:
+**		fTrue if the token is the string, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Compares a token with a string.
+*/
+
+static BOOL FJscTokIs(const JSCTOK * ptok, const char * sz) {
+
+	return (strlen(sz) == ptok->cch) && (memcmp(ptok->pch, sz, ptok->cch) == 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscWord
+**
+**	Parameters:
+**		pbld		- compiler state
+**		itok		- token number
+**
+**	Return Value:
+**		fTrue if there is such a token and it is a word
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Tells words apart from { } = and the end of the list.
+*/
+
+static BOOL FJscWord(JSCBLD * pbld, DWORD itok) {
+
+	return (itok < pbld->ctok) && !FJscTokIs(&pbld->rgtok[itok], "{") &&
+		!FJscTokIs(&pbld->rgtok[itok], "}") && !FJscTokIs(&pbld->rgtok[itok], "=");
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscHex
+**
+**	Parameters:
+**		pbld		- compiler state
+**		ptok		- token
+**		szWhat		- entry and field, for messages
+**		pdw			- variable to receive the value
+**
+**	Return Value:
+**		fTrue if the token was read, fFalse if not
+**
+**	Errors:
+**		Adds an error if the token is not a hexadecimal value, and a
+**		warning if it is not written as 8 digits and an h, or has the
+**		letter O in place of a 0.
+**
+**	Description:
+**		Reads a value written as 0000002Ah.
+*/
+
+static BOOL FJscHex(JSCBLD * pbld, const JSCTOK * ptok, const char * szWhat, DWORD * pdw) {
+
+	char	szTok[cchJscNumMax];
+	char	szFix[cchJscNumMax];
+	DWORD	cch;
+	DWORD	ich;
+	BOOL	fSuffix;
+	BOOL	fLetterO;
+	DWORD	dw;
+	char	ch;
+
+	if (ptok->cch >= cchJscNumMax) {
+		JscMsg(pbld, ptok->iline, fTrue, "%s: '%.*s' is too long for a value", szWhat, (int) ptok->cch, ptok->pch);
+		return fFalse;
+	}
+	memcpy(szTok, ptok->pch, ptok->cch);
+	szTok[ptok->cch] = '\0';
+
+	cch = ptok->cch;
+	fSuffix = (cch > 0) && ((szTok[cch - 1] == 'h') || (szTok[cch - 1] == 'H'));
+	if (fSuffix) {
+		cch--;
+	}
+
+	fLetterO = fFalse;
+	dw = 0;
+	for (ich = 0; ich < cch; ich++) {
+		ch = szTok[ich];
+		if ((ch == 'O') || (ch == 'o')) {
+			ch = '0';
+			fLetterO = fTrue;
+		}
+		szFix[ich] = ch;
+
+		if ((ch >= '0') && (ch <= '9')) {
+			dw = (dw << 4) | (ch - '0');
+		}
+		else if ((ch >= 'a') && (ch <= 'f')) {
+			dw = (dw << 4) | (ch - 'a' + 10);
+		}
+		else if ((ch >= 'A') && (ch <= 'F')) {
+			dw = (dw << 4) | (ch - 'A' + 10);
+		}
+		else {
+			JscMsg(pbld, ptok->iline, fTrue, "%s: '%s' is not a hexadecimal value", szWhat, szTok);
+			return fFalse;
+		}
+	}
+	szFix[cch] = '\0';
+
+	if ((cch == 0) || (cch > 8)) {
+		JscMsg(pbld, ptok->iline, fTrue, "%s: '%s' does not have 1 to 8 digits", szWhat, szTok);
+		return fFalse;
+	}
+
+	if (fLetterO) {
+		JscMsg(pbld, ptok->iline, fFalse, "%s: '%s' has the letter O in place of 0, read as %sh", szWhat, szTok, szFix);
+	}
+	if (!fSuffix) {
+		JscMsg(pbld, ptok->iline, fFalse, "%s: '%s' has no h suffix, read as hexadecimal", szWhat, szTok);
+	}
+	if (cch != 8) {
+		JscMsg(pbld, ptok->iline, fFalse, "%s: '%s' has %d digits, not 8, read as %08Xh", szWhat, szTok, (int) cch, (unsigned int) dw);
+	}
+
+	*pdw = dw;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscDec
+**
+**	Parameters:
+**		pbld		- compiler state
+**		ptok		- token
+**		szWhat		- entry and field, for messages
+**		pdw			- variable to receive the value
+**
+**	Return Value:
+**		fTrue if the token was read, fFalse if not
+**
+**	Errors:
+**		Adds an error if the token is not a decimal number.
+**
+**	Description:
+**		Reads the value of a setting such as IRLEN = 6.
+*/
+
+static BOOL FJscDec(JSCBLD * pbld, const JSCTOK * ptok, const char * szWhat, DWORD * pdw) {
+
+	DWORD	ich;
+	DWORD	dw;
+
+	dw = 0;
+	for (ich = 0; ich < ptok->cch; ich++) {
+		if ((ptok->pch[ich] < '0') || (ptok->pch[ich] > '9') || (ich >= 9)) {
+			JscMsg(pbld, ptok->iline, fTrue, "%s: '%.*s' is not a number", szWhat, (int) ptok->cch, ptok->pch);
+			return fFalse;
+		}
+		dw = dw * 10 + (ptok->pch[ich] - '0');
+	}
+
+	*pdw = dw;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JscParseTop
+**
+**	Parameters:
+**		pbld		- compiler state
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Adds an error for each token that is not the start of a block.
+**
+**	Description:
+**		Parses the VENDOR block and the vendor blocks.
+*/
+
+static void JscParseTop(JSCBLD * pbld) {
+
+	const JSCTOK *	ptok;
+
+	while (pbld->itok < pbld->ctok) {
+		ptok = &pbld->rgtok[pbld->itok];
+
+		if (FJscWord(pbld, pbld->itok) && (pbld->itok + 1 < pbld->ctok) &&
+			FJscTokIs(&pbld->rgtok[pbld->itok + 1], "{")) {
+
+			pbld->itok += 2;
+			if (FJscTokIs(ptok, "VENDOR")) {
+				JscParseEntries(pbld, kindVid, 0, ijscNone, ptok, ptok);
+			}
+			else {
+				JscParseVendor(pbld, ptok);
+			}
+		}
+		else {
+			JscMsg(pbld, ptok->iline, fTrue, "unexpected '%.*s'", (int) ptok->cch, ptok->pch);
+			pbld->itok++;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	JscParseVendor
+**
+**	Parameters:
+**		pbld		- compiler state
+**		ptokName	- name of the vendor
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Adds an error for each token that is not the start of a block,
+**		and if the block is not closed.
+**
+**	Description:
+**		Parses a vendor block: its FAMILY block and its family blocks.
+*/
+
+static void JscParseVendor(JSCBLD * pbld, const JSCTOK * ptokName) {
+
+	const JSCTOK *	ptok;
+	DWORD			ivnd;
+
+	if (!FJscGrow(pbld, (void **) &pbld->rgichVnd, &pbld->cvndMax, pbld->cvnd + 1, sizeof(DWORD))) {
+		return;
+	}
+	ivnd = pbld->cvnd++;
+	pbld->rgichVnd[ivnd] = IchJscAdd(pbld, ptokName->pch, ptokName->cch);
+
+	while (pbld->itok < pbld->ctok) {
+		ptok = &pbld->rgtok[pbld->itok];
+
+		if (FJscTokIs(ptok, "}")) {
+			pbld->itok++;
+			return;
+		}
+
+		if (FJscWord(pbld, pbld->itok) && (pbld->itok + 1 < pbld->ctok) &&
+			FJscTokIs(&pbld->rgtok[pbld->itok + 1], "{")) {
+
+			pbld->itok += 2;
+			if (FJscTokIs(ptok, "FAMILY")) {
+				JscParseEntries(pbld, kindFid, ivnd, ijscNone, ptok, ptok);
+			}
+			else {
+				JscParseFamily(pbld, ivnd, ptok);
+			}
+		}
+		else {
+			JscMsg(pbld, ptok->iline, fTrue, "%.*s: unexpected '%.*s'",
+				(int) ptokName->cch, ptokName->pch, (int) ptok->cch, ptok->pch);
+			pbld->itok++;
+		}
+	}
+
+	JscMsg(pbld, ptokName->iline, fTrue, "%.*s: block not closed", (int) ptokName->cch, ptokName->pch);
+}
+
+/* ------------------------------------------------------------ */
+/***	JscParseFamily
+**
+**	Parameters:
+**		pbld		- compiler state
+**		ivnd		- vendor block
+**		ptokName	- name of the family
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Adds messages for settings that cannot be read, unknown
+**		blocks and a missing IRLEN.
+**
+**	Description:
+**		Parses a family block: its settings and its COMMANDS and
+**		DEVICES blocks.
+*/
+
+static void JscParseFamily(JSCBLD * pbld, DWORD ivnd, const JSCTOK * ptokName) {
+
+	char			szWhat[cchJscMsgMax];
+	const JSCTOK *	ptok;
+	const JSCTOK *	ptokValue;
+	JSCFAM *		pfam;
+	DWORD			ifam;
+	DWORD			dw;
+	BOOL			fIrlen;
+
+	if (!FJscGrow(pbld, (void **) &pbld->rgfam, &pbld->cfamMax, pbld->cfam + 1, sizeof(JSCFAM)) ||
+		!FJscGrow(pbld, (void **) &pbld->rgilineFam, &pbld->cilineFamMax, pbld->cfam + 1, sizeof(DWORD))) {
+		return;
+	}
+	ifam = pbld->cfam++;
+	pbld->rgilineFam[ifam] = ptokName->iline;
+	pfam = &pbld->rgfam[ifam];
+	pfam->ichName = IchJscAdd(pbld, ptokName->pch, ptokName->cch);
+	pfam->ichVendor = pbld->rgichVnd[ivnd];
+	pfam->ivnd = ivnd;
+	pfam->ichType = 0;
+	pfam->cbitIr = 0;
+	pfam->alg = 0;
+	pfam->icmd = pbld->ccmd;
+	pfam->ccmd = 0;
+	fIrlen = fFalse;
+
+	while (pbld->itok < pbld->ctok) {
+		ptok = &pbld->rgtok[pbld->itok];
+		snprintf(szWhat, sizeof(szWhat), "%.*s %.*s", (int) ptokName->cch, ptokName->pch, (int) ptok->cch, ptok->pch);
+
+		if (FJscTokIs(ptok, "}")) {
+			pbld->itok++;
+			if (!fIrlen) {
+				JscMsg(pbld, ptokName->iline, fFalse, "%.*s: no IRLEN", (int) ptokName->cch, ptokName->pch);
+			}
+			return;
+		}
+
+		if (FJscWord(pbld, pbld->itok) && (pbld->itok + 2 < pbld->ctok) &&
+			FJscTokIs(&pbld->rgtok[pbld->itok + 1], "=") && FJscWord(pbld, pbld->itok + 2)) {
+
+			ptokValue = &pbld->rgtok[pbld->itok + 2];
+			pbld->itok += 3;
+
+			if (FJscTokIs(ptok, "TYPE")) {
+				dw = IchJscAdd(pbld, ptokValue->pch, ptokValue->cch);
+				pbld->rgfam[ifam].ichType = dw;
+			}
+			else if (FJscTokIs(ptok, "IRLEN")) {
+				if (FJscDec(pbld, ptokValue, szWhat, &dw)) {
+					pbld->rgfam[ifam].cbitIr = dw;
+					fIrlen = fTrue;
+				}
+			}
+			else if (FJscTokIs(ptok, "ALG")) {
+				if (FJscDec(pbld, ptokValue, szWhat, &dw)) {
+					pbld->rgfam[ifam].alg = dw;
+				}
+			}
+			else {
+				JscMsg(pbld, ptok->iline, fFalse, "%s: unknown setting, ignored", szWhat);
+			}
+		}
+		else if (FJscWord(pbld, pbld->itok) && (pbld->itok + 1 < pbld->ctok) &&
+			FJscTokIs(&pbld->rgtok[pbld->itok + 1], "{")) {
+
+			pbld->itok += 2;
+			if (FJscTokIs(ptok, "COMMANDS")) {
+				JscParseEntries(pbld, kindCmd, ivnd, ifam, ptokName, ptok);
+			}
+			else if (FJscTokIs(ptok, "DEVICES")) {
+				JscParseEntries(pbld, kindDev, ivnd, ifam, ptokName, ptok);
+			}
+			else {
+				JscMsg(pbld, ptok->iline, fFalse, "%s: unknown block, ignored", szWhat);
+				JscParseEntries(pbld, kindSkip, ivnd, ifam, ptokName, ptok);
+			}
+		}
+		else {
+			JscMsg(pbld, ptok->iline, fTrue, "%.*s: unexpected '%.*s'",
+				(int) ptokName->cch, ptokName->pch, (int) ptok->cch, ptok->pch);
+			pbld->itok++;
+		}
+	}
+
+	JscMsg(pbld, ptokName->iline, fTrue, "%.*s: block not closed", (int) ptokName->cch, ptokName->pch);
+}
+
+/* ------------------------------------------------------------ */
+/***	JscParseEntries
+**
+**	Parameters:
+**		pbld		- compiler state
+**		kind		- kind of entry in the block
+**		ivnd		- vendor block
+**		ifam		- family block of COMMANDS and DEVICES
+**		ptokName	- name of the enclosing block, for messages
+**		ptokBlock	- name of the block
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Adds an error if the block is not closed.
+**
+**	Description:
+**		Parses a block of entries, one per line, up to its }.
+*/
+
+static void JscParseEntries(JSCBLD * pbld, KIND kind, DWORD ivnd, DWORD ifam, const JSCTOK * ptokName, const JSCTOK * ptokBlock) {
+
+	const JSCTOK *	ptok;
+	DWORD			itokFirst;
+	DWORD			iline;
+
+	while (pbld->itok < pbld->ctok) {
+		ptok = &pbld->rgtok[pbld->itok];
+
+		if (FJscTokIs(ptok, "}")) {
+			pbld->itok++;
+			return;
+		}
+
+		if (!FJscWord(pbld, pbld->itok)) {
+			JscMsg(pbld, ptok->iline, fTrue, "%.*s: unexpected '%.*s'",
+				(int) ptokName->cch, ptokName->pch, (int) ptok->cch, ptok->pch);
+			pbld->itok++;
+			continue;
+		}
+
+		itokFirst = pbld->itok;
+		iline = ptok->iline;
+		while (FJscWord(pbld, pbld->itok) && (pbld->rgtok[pbld->itok].iline == iline)) {
+			pbld->itok++;
+		}
+
+		if (kind != kindSkip) {
+			JscAddEntry(pbld, kind, ivnd, ifam, &pbld->rgtok[itokFirst], pbld->itok - itokFirst);
+		}
+	}
+
+	if (ptokBlock != ptokName) {
+		JscMsg(pbld, ptokBlock->iline, fTrue, "%.*s %.*s: block not closed",
+			(int) ptokName->cch, ptokName->pch, (int) ptokBlock->cch, ptokBlock->pch);
+	}
+	else {
+		JscMsg(pbld, ptokBlock->iline, fTrue, "%.*s: block not closed", (int) ptokBlock->cch, ptokBlock->pch);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	JscAddEntry
+**
+**	Parameters:
+**		pbld		- compiler state
+**		kind		- kind of entry
+**		ivnd		- vendor block
+**		ifam		- family block of COMMANDS and DEVICES
+**		rgtok		- tokens of the line
+**		ctok		- their number
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Adds an error and leaves the entry out if it cannot be read.
+**
+**	Description:
+**		Adds an entry: name, value and mask, or name and opcode for
+**		COMMANDS. A DEVICES entry gets the full device name.
+*/
+
+static void JscAddEntry(JSCBLD * pbld, KIND kind, DWORD ivnd, DWORD ifam, const JSCTOK * rgtok, DWORD ctok) {
+
+	char			szWhat[cchJscMsgMax];
+	char			szName[cchJscMsgMax];
+	const char *	szFam;
+	const char *	pchDollar;
+	JSCENT			ent;
+	DWORD			ctokEnt;
+	int				cchFam;
+
+	ctokEnt = (kind == kindCmd) ? 2 : 3;
+
+	if (ifam != ijscNone) {
+		szFam = pbld->rgchStr + pbld->rgfam[ifam].ichName;
+		snprintf(szWhat, sizeof(szWhat), "%s %.*s", szFam, (int) rgtok[0].cch, rgtok[0].pch);
+	}
+	else {
+		szFam = NULL;
+		snprintf(szWhat, sizeof(szWhat), "%s %.*s", (kind == kindVid) ? "VENDOR" : "FAMILY",
+			(int) rgtok[0].cch, rgtok[0].pch);
+	}
+
+	if (ctok != ctokEnt) {
+		JscMsg(pbld, rgtok[0].iline, fTrue, "%s: expected %s, found %d fields", szWhat,
+			(kind == kindCmd) ? "a name and an opcode" : "a name, a value and a mask", (int) ctok);
+		return;
+	}
+
+	memset(&ent, 0, sizeof(ent));
+	ent.ivnd = ivnd;
+	ent.ifam = ifam;
+	ent.iline = rgtok[0].iline;
+
+	if (kind == kindCmd) {
+		if (!FJscHex(pbld, &rgtok[1], szWhat, &ent.dwValue) ||
+			!FJscGrow(pbld, (void **) &pbld->rgcmd, &pbld->ccmdMax, pbld->ccmd + 1, sizeof(JSCCMD))) {
+			return;
+		}
+		pbld->rgcmd[pbld->ccmd].ichName = IchJscAdd(pbld, rgtok[0].pch, rgtok[0].cch);
+		pbld->rgcmd[pbld->ccmd].dwOpcode = ent.dwValue;
+		pbld->ccmd++;
+		pbld->rgfam[ifam].ccmd++;
+		return;
+	}
+
+	if (!FJscHex(pbld, &rgtok[1], szWhat, &ent.dwValue) || !FJscHex(pbld, &rgtok[2], szWhat, &ent.dwMask)) {
+		return;
+	}
+
+	if ((ent.dwValue & ~ent.dwMask) != 0) {
+		JscMsg(pbld, ent.iline, fFalse, "%s: value %08Xh has bits outside its mask %08Xh",
+			szWhat, (unsigned int) ent.dwValue, (unsigned int) ent.dwMask);
+	}
+
+	if (kind == kindDev) {
+
+		/* The device name is the family name with the $ replaced by
+		** the name of the entry. The messages above may have moved the
+		** string section.
+		*/
+		szFam = pbld->rgchStr + pbld->rgfam[ifam].ichName;
+		pchDollar = strchr(szFam, '$');
+		if (pchDollar != NULL) {
+			cchFam = (int) (pchDollar - szFam);
+			snprintf(szName, sizeof(szName), "%.*s%.*s%s", cchFam, szFam,
+				(int) rgtok[0].cch, rgtok[0].pch, pchDollar + 1);
+		}
+		else {
+			snprintf(szName, sizeof(szName), "%s", szFam);
+		}
+		ent.ichName = IchJscAdd(pbld, szName, (DWORD) strlen(szName));
+
+		if (FJscGrow(pbld, (void **) &pbld->rgdev, &pbld->cdevMax, pbld->cdev + 1, sizeof(JSCENT))) {
+			pbld->rgdev[pbld->cdev++] = ent;
+		}
+	}
+	else {
+		ent.ichName = IchJscAdd(pbld, rgtok[0].pch, rgtok[0].cch);
+
+		if (kind == kindVid) {
+			if (FJscGrow(pbld, (void **) &pbld->rgvid, &pbld->cvidMax, pbld->cvid + 1, sizeof(JSCENT))) {
+				pbld->rgvid[pbld->cvid++] = ent;
+			}
+		}
+		else if (FJscGrow(pbld, (void **) &pbld->rgfid, &pbld->cfidMax, pbld->cfid + 1, sizeof(JSCENT))) {
+			pbld->rgfid[pbld->cfid++] = ent;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	JscResolve
+**
+**	Parameters:
+**		pbld		- compiler state
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Adds an error for a FAMILY entry without a family block and
+**		warnings for vendors without a block, families without a
+**		FAMILY entry and family blocks given twice.
+**
+**	Description:
+**		Links the VENDOR entries to their vendor blocks and the
+**		FAMILY entries to their family blocks, by name.
+*/
+
+static void JscResolve(JSCBLD * pbld) {
+
+	char			szName[cchJscMsgMax];
+	JSCENT *		pent;
+	DWORD			ient;
+	DWORD			ientOut;
+	DWORD			ifam;
+	DWORD			jfam;
+	DWORD			ivnd;
+	BOOL			fFound;
+
+	for (ient = 0; ient < pbld->cvid; ient++) {
+		pent = &pbld->rgvid[ient];
+		pent->ivnd = ijscNone;
+		for (ivnd = 0; ivnd < pbld->cvnd; ivnd++) {
+			if (strcmp(pbld->rgchStr + pbld->rgichVnd[ivnd], pbld->rgchStr + pent->ichName) == 0) {
+				pent->ivnd = ivnd;
+				break;
+			}
+		}
+		if (pent->ivnd == ijscNone) {
+			JscMsg(pbld, pent->iline, fFalse, "VENDOR %s: no vendor block", pbld->rgchStr + pent->ichName);
+		}
+	}
+
+	ientOut = 0;
+	for (ient = 0; ient < pbld->cfid; ient++) {
+		pent = &pbld->rgfid[ient];
+		pent->ifam = ijscNone;
+		for (ifam = 0; ifam < pbld->cfam; ifam++) {
+			if ((pbld->rgfam[ifam].ivnd == pent->ivnd) &&
+				(strcmp(pbld->rgchStr + pbld->rgfam[ifam].ichName, pbld->rgchStr + pent->ichName) == 0)) {
+				pent->ifam = ifam;
+				break;
+			}
+		}
+		if (pent->ifam == ijscNone) {
+			JscMsg(pbld, pent->iline, fTrue, "FAMILY %s: no family block", pbld->rgchStr + pent->ichName);
+		}
+		else {
+			pbld->rgfid[ientOut++] = *pent;
+		}
+	}
+	pbld->cfid = ientOut;
+
+	for (ifam = 0; ifam < pbld->cfam; ifam++) {
+		snprintf(szName, sizeof(szName), "%s", pbld->rgchStr + pbld->rgfam[ifam].ichName);
+
+		for (jfam = 0; jfam < ifam; jfam++) {
+			if ((pbld->rgfam[jfam].ivnd == pbld->rgfam[ifam].ivnd) &&
+				(strcmp(pbld->rgchStr + pbld->rgfam[jfam].ichName, szName) == 0)) {
+				JscMsg(pbld, pbld->rgilineFam[ifam], fFalse, "%s: second family block of the same name, not used for FAMILY entries", szName);
+				break;
+			}
+		}
+
+		fFound = fFalse;
+		for (ient = 0; (ient < pbld->cfid) && !fFound; ient++) {
+			fFound = (pbld->rgfid[ient].ifam == ifam);
+		}
+		if (!fFound) {
+			JscMsg(pbld, pbld->rgilineFam[ifam], fFalse, "%s: no FAMILY entry, found by its DEVICES only", szName);
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscBuildTable
+**
+**	Parameters:
+**		pbld		- compiler state
+**		rgkey		- entries of one kind
+**		ckey		- their number
+**		szKind		- kind of entry, for messages
+**		pigrp		- variable to receive the first hash table
+**		pcgrp		- variable to receive the number of tables
+**
+**	Return Value:
+**		fTrue if successful, fFalse if memory runs out
+**
+**	Errors:
+**		Adds a warning for an entry with the key of an earlier one,
+**		which is never found.
+**
+**	Description:
+**		Builds a hash table for each mask of the entries, ordered
+**		from the mask with the most bits set to the one with the
+**		fewest, and entries of the same mask by their order in the
+**		list. Each table has at least twice as many slots as entries
+**		and is probed linearly.
+*/
+
+static BOOL FJscBuildTable(JSCBLD * pbld, const JSCKEY * rgkey, DWORD ckey, const char * szKind, DWORD * pigrp, DWORD * pcgrp) {
+
+	JSCGRP		grp;
+	JSCSLOT *	pslot;
+	DWORD		igrpFirst;
+	DWORD		igrp;
+	DWORD		jgrp;
+	DWORD		ikey;
+	DWORD		ckeyGrp;
+	DWORD		cbitSlot;
+	DWORD		islot;
+	DWORD		dwKey;
+
+	igrpFirst = pbld->cgrp;
+
+	/* One group per mask, in order of first use, then sorted by the
+	** number of mask bits. The sort is stable.
+	*/
+	for (ikey = 0; ikey < ckey; ikey++) {
+		for (igrp = igrpFirst; igrp < pbld->cgrp; igrp++) {
+			if (pbld->rggrp[igrp].dwMask == rgkey[ikey].dwMask) {
+				break;
+			}
+		}
+		if (igrp == pbld->cgrp) {
+			if (!FJscGrow(pbld, (void **) &pbld->rggrp, &pbld->cgrpMax, pbld->cgrp + 1, sizeof(JSCGRP))) {
+				return fFalse;
+			}
+			pbld->rggrp[pbld->cgrp].dwMask = rgkey[ikey].dwMask;
+			pbld->cgrp++;
+		}
+	}
+
+	for (igrp = igrpFirst + 1; igrp < pbld->cgrp; igrp++) {
+		grp = pbld->rggrp[igrp];
+		for (jgrp = igrp; (jgrp > igrpFirst) &&
+			(CbitJscMask(pbld->rggrp[jgrp - 1].dwMask) < CbitJscMask(grp.dwMask)); jgrp--) {
+			pbld->rggrp[jgrp] = pbld->rggrp[jgrp - 1];
+		}
+		pbld->rggrp[jgrp] = grp;
+	}
+
+	for (igrp = igrpFirst; igrp < pbld->cgrp; igrp++) {
+		ckeyGrp = 0;
+		for (ikey = 0; ikey < ckey; ikey++) {
+			if (rgkey[ikey].dwMask == pbld->rggrp[igrp].dwMask) {
+				ckeyGrp++;
+			}
+		}
+
+		for (cbitSlot = 1; ((DWORD) 1 << cbitSlot) < 2 * ckeyGrp; cbitSlot++) {
+		}
+
+		if (!FJscGrow(pbld, (void **) &pbld->rgslot, &pbld->cslotMax,
+			pbld->cslot + (1 << cbitSlot), sizeof(JSCSLOT))) {
+			return fFalse;
+		}
+		memset(&pbld->rgslot[pbld->cslot], 0, ((size_t) 1 << cbitSlot) * sizeof(JSCSLOT));
+		pbld->rggrp[igrp].islot = pbld->cslot;
+		pbld->rggrp[igrp].cbitSlot = cbitSlot;
+		pbld->cslot += 1 << cbitSlot;
+
+		for (ikey = 0; ikey < ckey; ikey++) {
+			if (rgkey[ikey].dwMask != pbld->rggrp[igrp].dwMask) {
+				continue;
+			}
+			dwKey = rgkey[ikey].dwValue & rgkey[ikey].dwMask;
+
+			for (islot = IslotJscHash(dwKey, rgkey[ikey].ivnd, cbitSlot); ; islot = (islot + 1) & ((1 << cbitSlot) - 1)) {
+				pslot = &pbld->rgslot[pbld->rggrp[igrp].islot + islot];
+				if (pslot->ient == 0) {
+					pslot->dwKey = dwKey;
+					pslot->ivnd = rgkey[ikey].ivnd;
+					pslot->ient = ikey + 1;
+					break;
+				}
+				if ((pslot->dwKey == dwKey) && (pslot->ivnd == rgkey[ikey].ivnd)) {
+					JscMsg(pbld, rgkey[ikey].iline, fFalse, "%s %08Xh: same IDCODE as line %d, never found",
+						szKind, (unsigned int) rgkey[ikey].dwValue, (int) rgkey[pslot->ient - 1].iline);
+					break;
+				}
+			}
+		}
+	}
+
+	*pigrp = igrpFirst;
+	*pcgrp = pbld->cgrp - igrpFirst;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CbitJscMask
+**
+**	Parameters:
+**		dwMask		- mask
+**
+**	Return Value:
+**		number of bits set
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Orders the hash tables from the most specific mask.
+*/
+
+static DWORD CbitJscMask(DWORD dwMask) {
+
+	DWORD	cbit;
+
+	for (cbit = 0; dwMask != 0; dwMask &= dwMask - 1) {
+		cbit++;
+	}
+
+	return cbit;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscWriteIndex
+**
+**	Parameters:
+**		pbld		- compiler state
+**		pstList		- status of the list
+**		ppbIndex	- variable to receive the index
+**		pcbIndex	- variable to receive its length
+**
+**	Return Value:
+**		fTrue if successful, fFalse if memory runs out
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Builds the hash tables and lays out the index: the header,
+**		the records, the tables, the messages and the strings.
+*/
+
+static BOOL FJscWriteIndex(JSCBLD * pbld, const struct stat * pstList, BYTE ** ppbIndex, size_t * pcbIndex) {
+
+	JSCHDR		hdr;
+	JSCMSG		msg;
+	JSCKEY *	rgkey;
+	JSCVID *	rgvid;
+	JSCFID *	rgfid;
+	JSCDEV *	rgdev;
+	BYTE *		pb;
+	DWORD		ckeyMax;
+	DWORD		ient;
+	DWORD		imsg;
+	DWORD		ib;
+	BOOL		fOk;
+
+	memset(&hdr, 0, sizeof(hdr));
+
+	ckeyMax = pbld->cvid;
+	if (pbld->cfid > ckeyMax) {
+		ckeyMax = pbld->cfid;
+	}
+	if (pbld->cdev > ckeyMax) {
+		ckeyMax = pbld->cdev;
+	}
+	rgkey = (JSCKEY *) malloc(((size_t) ckeyMax + 1) * sizeof(JSCKEY));
+	if (rgkey == NULL) {
+		return fFalse;
+	}
+
+	for (ient = 0; ient < pbld->cdev; ient++) {
+		rgkey[ient].dwValue = pbld->rgdev[ient].dwValue;
+		rgkey[ient].dwMask = pbld->rgdev[ient].dwMask;
+		rgkey[ient].ivnd = 0;
+		rgkey[ient].iline = pbld->rgdev[ient].iline;
+	}
+	fOk = FJscBuildTable(pbld, rgkey, pbld->cdev, "DEVICES", &hdr.igrpDev, &hdr.cgrpDev);
+
+	for (ient = 0; ient < pbld->cfid; ient++) {
+		rgkey[ient].dwValue = pbld->rgfid[ient].dwValue;
+		rgkey[ient].dwMask = pbld->rgfid[ient].dwMask;
+		rgkey[ient].ivnd = pbld->rgfid[ient].ivnd;
+		rgkey[ient].iline = pbld->rgfid[ient].iline;
+	}
+	fOk = fOk && FJscBuildTable(pbld, rgkey, pbld->cfid, "FAMILY", &hdr.igrpFid, &hdr.cgrpFid);
+
+	for (ient = 0; ient < pbld->cvid; ient++) {
+		rgkey[ient].dwValue = pbld->rgvid[ient].dwValue;
+		rgkey[ient].dwMask = pbld->rgvid[ient].dwMask;
+		rgkey[ient].ivnd = 0;
+		rgkey[ient].iline = pbld->rgvid[ient].iline;
+	}
+	fOk = fOk && FJscBuildTable(pbld, rgkey, pbld->cvid, "VENDOR", &hdr.igrpVid, &hdr.cgrpVid);
+
+	free(rgkey);
+	if (!fOk || pbld->fNoMem) {
+		return fFalse;
+	}
+
+	/* Messages in the order of the lines of the list. The sort is
+	** stable, so messages about the same line keep their order.
+	*/
+	for (ient = 1; ient < pbld->cmsg; ient++) {
+		msg = pbld->rgmsg[ient];
+		for (imsg = ient; (imsg > 0) && (pbld->rgmsg[imsg - 1].iline > msg.iline); imsg--) {
+			pbld->rgmsg[imsg] = pbld->rgmsg[imsg - 1];
+		}
+		pbld->rgmsg[imsg] = msg;
+	}
+
+	hdr.dwMagic = dwJscMagic;
+	hdr.ver = verJscIndex;
+	hdr.cbList = (DWORD) pstList->st_size;
+	hdr.tsList = (long long) pstList->st_mtim.tv_sec;
+	hdr.tnsList = (long long) pstList->st_mtim.tv_nsec;
+	hdr.cvid = pbld->cvid;
+	hdr.cfam = pbld->cfam;
+	hdr.cfid = pbld->cfid;
+	hdr.cdev = pbld->cdev;
+	hdr.ccmd = pbld->ccmd;
+	hdr.cgrp = pbld->cgrp;
+	hdr.cslot = pbld->cslot;
+	hdr.cmsg = pbld->cmsg;
+	hdr.cbStr = pbld->cbStr;
+
+	/* Every record is made of DWORDs, so only the header, which holds
+	** long longs, needs more than DWORD alignment.
+	*/
+	ib = sizeof(JSCHDR);
+	hdr.ibVid = ib;
+	ib += hdr.cvid * sizeof(JSCVID);
+	hdr.ibFam = ib;
+	ib += hdr.cfam * sizeof(JSCFAM);
+	hdr.ibFid = ib;
+	ib += hdr.cfid * sizeof(JSCFID);
+	hdr.ibDev = ib;
+	ib += hdr.cdev * sizeof(JSCDEV);
+	hdr.ibCmd = ib;
+	ib += hdr.ccmd * sizeof(JSCCMD);
+	hdr.ibGrp = ib;
+	ib += hdr.cgrp * sizeof(JSCGRP);
+	hdr.ibSlot = ib;
+	ib += hdr.cslot * sizeof(JSCSLOT);
+	hdr.ibMsg = ib;
+	ib += hdr.cmsg * sizeof(JSCMSG);
+	hdr.ibStr = ib;
+	ib += hdr.cbStr;
+	hdr.cbFile = ib;
+
+	pb = (BYTE *) calloc(hdr.cbFile, 1);
+	if (pb == NULL) {
+		return fFalse;
+	}
+
+	memcpy(pb, &hdr, sizeof(hdr));
+
+	rgvid = (JSCVID *) (pb + hdr.ibVid);
+	for (ient = 0; ient < hdr.cvid; ient++) {
+		rgvid[ient].dwValue = pbld->rgvid[ient].dwValue;
+		rgvid[ient].dwMask = pbld->rgvid[ient].dwMask;
+		rgvid[ient].ichName = pbld->rgvid[ient].ichName;
+		rgvid[ient].ivnd = pbld->rgvid[ient].ivnd;
+	}
+
+	rgfid = (JSCFID *) (pb + hdr.ibFid);
+	for (ient = 0; ient < hdr.cfid; ient++) {
+		rgfid[ient].dwValue = pbld->rgfid[ient].dwValue;
+		rgfid[ient].dwMask = pbld->rgfid[ient].dwMask;
+		rgfid[ient].ifam = pbld->rgfid[ient].ifam;
+	}
+
+	rgdev = (JSCDEV *) (pb + hdr.ibDev);
+	for (ient = 0; ient < hdr.cdev; ient++) {
+		rgdev[ient].dwValue = pbld->rgdev[ient].dwValue;
+		rgdev[ient].dwMask = pbld->rgdev[ient].dwMask;
+		rgdev[ient].ifam = pbld->rgdev[ient].ifam;
+		rgdev[ient].ichName = pbld->rgdev[ient].ichName;
+	}
+
+	if (hdr.cfam != 0) {
+		memcpy(pb + hdr.ibFam, pbld->rgfam, hdr.cfam * sizeof(JSCFAM));
+	}
+	if (hdr.ccmd != 0) {
+		memcpy(pb + hdr.ibCmd, pbld->rgcmd, hdr.ccmd * sizeof(JSCCMD));
+	}
+	if (hdr.cgrp != 0) {
+		memcpy(pb + hdr.ibGrp, pbld->rggrp, hdr.cgrp * sizeof(JSCGRP));
+	}
+	if (hdr.cslot != 0) {
+		memcpy(pb + hdr.ibSlot, pbld->rgslot, hdr.cslot * sizeof(JSCSLOT));
+	}
+	if (hdr.cmsg != 0) {
+		memcpy(pb + hdr.ibMsg, pbld->rgmsg, hdr.cmsg * sizeof(JSCMSG));
+	}
+	memcpy(pb + hdr.ibStr, pbld->rgchStr, hdr.cbStr);
+
+	*ppbIndex = pb;
+	*pcbIndex = hdr.cbFile;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	JscFreeBld
+**
+**	Parameters:
+**		pbld		- compiler state
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Frees the arrays of the compiler.
+*/
+
+static void JscFreeBld(JSCBLD * pbld) {
+
+	free(pbld->rgchList);
+	free(pbld->rgtok);
+	free(pbld->rgvid);
+	free(pbld->rgfid);
+	free(pbld->rgdev);
+	free(pbld->rgfam);
+	free(pbld->rgilineFam);
+	free(pbld->rgcmd);
+	free(pbld->rgichVnd);
+	free(pbld->rggrp);
+	free(pbld->rgslot);
+	free(pbld->rgmsg);
+	free(pbld->rgchStr);
+}
+
+/* ------------------------------------------------------------ */
+/***	FJscIndexPath
+**
+**	Parameters:
+**		szList		- path of the list
+**		szIndex		- buffer to receive the path of its index
+**		cchIndex	- size of the buffer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the path does not fit
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The index of a list is in the same directory, with the
+**		extension of the list replaced by .idx.
+*/
+
+static BOOL FJscIndexPath(const char * szList, char * szIndex, DWORD cchIndex) {
+
+	const char *	pchSlash;
+	const char *	pchDot;
+	size_t			cchStem;
+
+	pchSlash = strrchr(szList, '/');
+	pchDot = strrchr((pchSlash != NULL) ? pchSlash : szList, '.');
+	cchStem = (pchDot != NULL) ? (size_t) (pchDot - szList) : strlen(szList);
+
+	if (cchStem + sizeof(".idx") > cchIndex) {
+		return fFalse;
+	}
+
+	memcpy(szIndex, szList, cchStem);
+	strcpy(szIndex + cchStem, ".idx");
+
+	return fTrue;
+}
+
+/************************************************************************/
@@ -0,0 +1,270 @@
+/************************************************************************/
+/*																		*/
+/*  JtscIndex.h  --  JTAG Device List Index Declarations				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A JtscIndex identifies JTAG devices from their IDCODEs using	*/
+/*		the device list of the Adept Runtime, jtscdvclist.txt, without	*/
+/*		parsing or searching the text file each time.					*/
+/*																		*/
+/*		FInit compiles the list into a binary index and writes it		*/
+/*		next to the list, as jtscdvclist.idx. The index records the		*/
+/*		size and modification time of the list it was compiled from;	*/
+/*		while they match, later calls to FInit map the index with		*/
+/*		mmap instead of compiling the list again. If the index cannot	*/
+/*		be written, the compiled index is kept in memory.				*/
+/*																		*/
+/*		The index holds:												*/
+/*																		*/
+/*			- the DEVICES entries of every family, the FAMILY entries	*/
+/*			  of every vendor and the VENDOR entries, each kind in		*/
+/*			  hash tables grouped by mask: an IDCODE is looked up by	*/
+/*			  hashing idcode & mask in the table of each mask, most		*/
+/*			  specific mask first										*/
+/*			- a record per family with its TYPE, IRLEN and ALG and		*/
+/*			  its COMMANDS												*/
+/*			- the messages for the malformed entries of the list,		*/
+/*			  so they are reported whether the index was compiled		*/
+/*			  or mapped													*/
+/*																		*/
+/*		FIdentify looks up the device first, then the family of the		*/
+/*		vendor of the IDCODE, as the Runtime does. A device name is		*/
+/*		its family name with the $ replaced by the name in DEVICES:		*/
+/*		XC3S$E and 500 give XC3S500E.									*/
+/*																		*/
+/*		Entries that cannot be read are left out of the index with an	*/
+/*		error message. Entries that can be read but are not written		*/
+/*		as the list intends, such as a value with the letter O in		*/
+/*		place of a 0, without its h suffix or with fewer than 8			*/
+/*		digits, are kept with a warning.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(JTSCINDEX_INCLUDED)
+#define      JTSCINDEX_INCLUDED
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Options of FInit.
+*/
+const DWORD		fjscRebuild		= 0x0001;	// compile the list even if the index is current
+const DWORD		fjscNoWrite		= 0x0002;	// do not write the index file
+
+/* Data directory used when FInit is not given a list, and the
+** configuration file of the Runtime that can name another one.
+*/
+#define	szJscDataDefault	"/usr/local/share/digilent/data"
+#define	szJscConf			"/etc/digilent-adept.conf"
+#define	szJscList			"jtscdvclist.txt"
+#define	szJscIndex			"jtscdvclist.idx"
+
+const DWORD		cchJscPathMax	= 1024;
+
+/* Index file identification.
+*/
+const DWORD		dwJscMagic		= 0x5843534A;	// "JSCX"
+const DWORD		verJscIndex		= 1;
+
+const DWORD		ijscNone		= 0xFFFFFFFF;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Records of the index file. ich values are offsets in the string
+** section; ib values are offsets in the file.
+*/
+typedef struct tagJSCHDR {
+	DWORD		dwMagic;
+	DWORD		ver;
+	DWORD		cbFile;
+	DWORD		cbList;				// size of the list compiled
+	long long	tsList;				// modification time of the list, s
+	long long	tnsList;			// and ns
+	DWORD		cvid;
+	DWORD		cfam;
+	DWORD		cfid;
+	DWORD		cdev;
+	DWORD		ccmd;
+	DWORD		cgrp;
+	DWORD		cslot;
+	DWORD		cmsg;
+	DWORD		cbStr;
+	DWORD		ibVid;
+	DWORD		ibFam;
+	DWORD		ibFid;
+	DWORD		ibDev;
+	DWORD		ibCmd;
+	DWORD		ibGrp;
+	DWORD		ibSlot;
+	DWORD		ibMsg;
+	DWORD		ibStr;
+	DWORD		igrpDev;			// groups of each table
+	DWORD		cgrpDev;
+	DWORD		igrpFid;
+	DWORD		cgrpFid;
+	DWORD		igrpVid;
+	DWORD		cgrpVid;
+} JSCHDR;
+
+/* An entry of VENDOR. ivnd is the vendor block of that name, which
+** holds the families of the vendor.
+*/
+typedef struct tagJSCVID {
+	DWORD		dwValue;
+	DWORD		dwMask;
+	DWORD		ichName;
+	DWORD		ivnd;				// ijscNone if there is no block
+} JSCVID;
+
+/* A family block.
+*/
+typedef struct tagJSCFAM {
+	DWORD		ichName;
+	DWORD		ichVendor;
+	DWORD		ivnd;
+	DWORD		ichType;
+	DWORD		cbitIr;
+	DWORD		alg;
+	DWORD		icmd;				// first of its COMMANDS
+	DWORD		ccmd;
+} JSCFAM;
+
+/* An entry of FAMILY, and an entry of DEVICES.
+*/
+typedef struct tagJSCFID {
+	DWORD		dwValue;
+	DWORD		dwMask;
+	DWORD		ifam;
+} JSCFID;
+
+typedef struct tagJSCDEV {
+	DWORD		dwValue;
+	DWORD		dwMask;
+	DWORD		ifam;
+	DWORD		ichName;			// full device name
+} JSCDEV;
+
+/* An entry of COMMANDS.
+*/
+typedef struct tagJSCCMD {
+	DWORD		ichName;
+	DWORD		dwOpcode;
+} JSCCMD;
+
+/* A hash table of one mask. Its 2^cbitSlot slots start at islot.
+*/
+typedef struct tagJSCGRP {
+	DWORD		dwMask;
+	DWORD		islot;
+	DWORD		cbitSlot;
+} JSCGRP;
+
+/* A slot holds one more than the index of its entry, 0 if empty.
+** FAMILY entries are looked up within the block of their vendor, so
+** their slots also hold the vendor; the others hold 0.
+*/
+typedef struct tagJSCSLOT {
+	DWORD		dwKey;
+	DWORD		ivnd;
+	DWORD		ient;
+} JSCSLOT;
+
+/* A message about an entry of the list.
+*/
+typedef struct tagJSCMSG {
+	DWORD		iline;
+	DWORD		fError;				// entry left out
+	DWORD		ichText;
+} JSCMSG;
+
+/* Result of FIdentify. The strings are in the index and remain valid
+** until Free.
+*/
+typedef struct tagJSCID {
+	DWORD			idcode;
+	const char *	szVendor;		// NULL if not known
+	const char *	szFamily;		// NULL if not known
+	const char *	szDevice;		// NULL if only the family is known
+	const char *	szType;
+	DWORD			ifam;			// ijscNone if not known
+	DWORD			cbitIr;
+	DWORD			alg;
+} JSCID;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class JtscIndex {
+
+private:
+	BYTE *			pbIndex;
+	size_t			cbIndex;
+	BOOL			fMapped;			// pbIndex is mapped, not allocated
+	BOOL			fCompiled;
+	BOOL			fWritten;
+	char			szIndex[cchJscPathMax];
+
+	const JSCHDR *	phdr;
+	const JSCVID *	rgvid;
+	const JSCFAM *	rgfam;
+	const JSCFID *	rgfid;
+	const JSCDEV *	rgdev;
+	const JSCCMD *	rgcmd;
+	const JSCGRP *	rggrp;
+	const JSCSLOT *	rgslot;
+	const JSCMSG *	rgmsg;
+	const char *	rgchStr;
+
+	BOOL	FMap(const char * szIndexFile, const struct stat * pstList);
+	BOOL	FAttach(BYTE * pb, size_t cb);
+	DWORD	IentLookup(DWORD igrpFirst, DWORD cgrp, DWORD idcode, DWORD ivnd);
+
+public:
+	JtscIndex();
+
+	BOOL	FInit(const char * szList, DWORD fjsc);
+	void	Free();
+	BOOL	FIdentify(DWORD idcode, JSCID * pid);
+	BOOL	FGetCommand(DWORD ifam, const char * szName, DWORD * pdwOpcode);
+	BOOL	FGetMsg(DWORD imsg, DWORD * piline, BOOL * pfError, const char ** pszText);
+
+	DWORD	Cmsg()				{ return (phdr != NULL) ? phdr->cmsg : 0; }
+	DWORD	Cfam()				{ return (phdr != NULL) ? phdr->cfam : 0; }
+	DWORD	Cdev()				{ return (phdr != NULL) ? phdr->cdev : 0; }
+	DWORD	Cgrp()				{ return (phdr != NULL) ? phdr->cgrp : 0; }
+	size_t	CbIndex()			{ return cbIndex; }
+	BOOL	FCompiled()			{ return fCompiled; }
+	BOOL	FWritten()			{ return fWritten; }
+	const char *	SzIndex()	{ return szIndex; }
+};
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FJscDataPath(char * szPath, DWORD cchPath);
+BOOL	FJscCompile(const char * szList, BYTE ** ppbIndex, size_t * pcbIndex);
+
+/* ------------------------------------------------------------ */
+
+#endif					// JTSCINDEX_INCLUDED
+
+/************************************************************************/
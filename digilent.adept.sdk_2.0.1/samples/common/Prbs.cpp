@@ -0,0 +1,542 @@
+/************************************************************************/
+/*																		*/
+/*  Prbs.cpp  --  PRBS Generator and Checker							*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the Prbs class. See Prbs.h.				*/
+/*																		*/
+/*		A sequence with the recurrence b[i] = b[i-n] ^ b[i-k] also		*/
+/*		satisfies b[i] = b[i-n*2^j] ^ b[i-k*2^j] for any j, since		*/
+/*		squaring 1 + x^k + x^n over GF(2) gives 1 + x^2k + x^2n. With	*/
+/*		j >= 3 both lags are whole bytes, so every byte is the XOR of	*/
+/*		two earlier bytes:												*/
+/*																		*/
+/*			byte[i] = byte[i - n*2^m] ^ byte[i - k*2^m],  m = j - 3		*/
+/*																		*/
+/*		m is chosen so that the shorter lag is at least 384 bytes.		*/
+/*		The bytes a vector reads were then written several vectors		*/
+/*		earlier, so generating a buffer is a single pass of unaligned	*/
+/*		loads, an XOR and a store. The first bytes of the sequence are	*/
+/*		produced bit by bit from the seed when the object is			*/
+/*		initialized.													*/
+/*																		*/
+/*		Check generates the expected data a block at a time into		*/
+/*		rgbRef, which stays in the L1 cache, and compares it with the	*/
+/*		received data a vector at a time; bits are only counted in a	*/
+/*		vector that differs.											*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define PRBS_X86
+#endif
+
+#include "dpcdecl.h"
+#include "Prbs.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Kernels. PFNPRBSXOR stores pbA[i] ^ pbB[i] in pbDst[i], going
+** forward; a source may be the destination 384 or more bytes back.
+** PFNPRBSDIFF returns the index of the first byte that differs, or
+** cb if none does.
+*/
+typedef void	(* PFNPRBSXOR)(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb);
+typedef DWORD	(* PFNPRBSDIFF)(const BYTE * pbA, const BYTE * pbB, DWORD cb);
+
+/* Recurrence of each sequence: x^n + x^k + 1, and the lags in bytes.
+*/
+typedef struct tagPRBSPOLY {
+	int		nOrder;
+	int		kTap;
+	DWORD	cbLagA;					// n * 2^m
+	DWORD	cbLagB;					// k * 2^m
+} PRBSPOLY;
+
+static const PRBSPOLY	rgprbspoly[] = {
+	{  7,  6, 7 * 64, 6 * 64 },
+	{ 15, 14, 15 * 32, 14 * 32 },
+	{ 31, 28, 31 * 16, 28 * 16 },
+};
+
+const DWORD		cprbspoly	= sizeof(rgprbspoly) / sizeof(rgprbspoly[0]);
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_once_t	oncePrbs = PTHREAD_ONCE_INIT;
+static PFNPRBSXOR		pfnPrbsXor;
+static PFNPRBSDIFF		pfnPrbsDiff;
+static const char *		szPrbsKernel;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static void		PrbsSelectKernels();
+static void		PrbsXorScalar(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb);
+static DWORD	PrbsDiffScalar(const BYTE * pbA, const BYTE * pbB, DWORD cb);
+
+#if defined(PRBS_X86)
+static void		PrbsXorSse2(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb);
+static DWORD	PrbsDiffSse2(const BYTE * pbA, const BYTE * pbB, DWORD cb);
+static void		PrbsXorAvx2(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb);
+static DWORD	PrbsDiffAvx2(const BYTE * pbA, const BYTE * pbB, DWORD cb);
+#endif
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	Prbs::Prbs
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The object must be initialized with FInit before
+**		it is used.
+*/
+
+Prbs::Prbs() {
+
+	nOrder = 0;
+	cbLagA = 0;
+	cbLagB = 0;
+	ibStream = 0;
+	fInit = fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	Prbs::FInit
+**
+**	Parameters:
+**		nOrderInit	- 7, 15 or 31
+**		dwSeed		- initial state of the shift register
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the order is not supported
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts the sequence. Its first nOrderInit bits are the low
+**		bits of dwSeed, bit 0 first; a seed of 0, which would give a
+**		sequence of zeros, is replaced by all ones. The object may be
+**		initialized again to restart the sequence.
+**
+**		rgbHist must hold the cbLagA bytes that precede the sequence.
+**		They are produced by running the recurrence backwards from
+**		the seed: b[i] = b[i+n] ^ b[i+n-k].
+*/
+
+BOOL Prbs::FInit(int nOrderInit, DWORD dwSeed) {
+
+	BYTE		rgbit[8*cbPrbsLagMax + 32];
+	const PRBSPOLY *	ppoly;
+	DWORD		ipoly;
+	DWORD		cbit;
+	DWORD		ibit;
+	DWORD		ib;
+	DWORD		dwMask;
+	BYTE		b;
+
+	pthread_once(&oncePrbs, PrbsSelectKernels);
+
+	ppoly = NULL;
+	for (ipoly = 0; ipoly < cprbspoly; ipoly++) {
+		if (rgprbspoly[ipoly].nOrder == nOrderInit) {
+			ppoly = &rgprbspoly[ipoly];
+		}
+	}
+	if (ppoly == NULL) {
+		return fFalse;
+	}
+
+	dwMask = (DWORD) ((1ULL << ppoly->nOrder) - 1);
+	dwSeed &= dwMask;
+	if (dwSeed == 0) {
+		dwSeed = dwMask;
+	}
+
+	/* rgbit[cbit + i] is bit i of the sequence.
+	*/
+	cbit = 8 * ppoly->cbLagA;
+	for (ibit = 0; ibit < (DWORD) ppoly->nOrder; ibit++) {
+		rgbit[cbit + ibit] = (BYTE) ((dwSeed >> ibit) & 1);
+	}
+	for (ibit = cbit; ibit-- > 0; ) {
+		rgbit[ibit] = rgbit[ibit + ppoly->nOrder] ^ rgbit[ibit + ppoly->nOrder - ppoly->kTap];
+	}
+
+	for (ib = 0; ib < ppoly->cbLagA; ib++) {
+		b = 0;
+		for (ibit = 0; ibit < 8; ibit++) {
+			b = (BYTE) ((b << 1) | rgbit[8*ib + ibit]);
+		}
+		rgbHist[ib] = b;
+	}
+
+	nOrder = ppoly->nOrder;
+	cbLagA = ppoly->cbLagA;
+	cbLagB = ppoly->cbLagB;
+	ibStream = 0;
+	fInit = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	Prbs::Fill
+**
+**	Parameters:
+**		rgb			- buffer to fill
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stores the next cb bytes of the sequence in rgb.
+**
+**		rgbHist holds the bytes at offsets -cbLagA to -1 relative to
+**		rgb[0]. The first cbLagB bytes take both taps from it, the
+**		bytes up to cbLagA take one tap from it and one from rgb, and
+**		the rest take both from rgb.
+*/
+
+void Prbs::Fill(BYTE * rgb, DWORD cb) {
+
+	DWORD	cbPart;
+
+	if (!fInit || (cb == 0)) {
+		return;
+	}
+
+	cbPart = (cb < cbLagB) ? cb : cbLagB;
+	pfnPrbsXor(rgb, rgbHist, rgbHist + cbLagA - cbLagB, cbPart);
+
+	if (cb > cbLagB) {
+		cbPart = ((cb < cbLagA) ? cb : cbLagA) - cbLagB;
+		pfnPrbsXor(rgb + cbLagB, rgbHist + cbLagB, rgb, cbPart);
+	}
+
+	if (cb > cbLagA) {
+		pfnPrbsXor(rgb + cbLagA, rgb, rgb + cbLagA - cbLagB, cb - cbLagA);
+	}
+
+	if (cb >= cbLagA) {
+		memcpy(rgbHist, rgb + cb - cbLagA, cbLagA);
+	}
+	else {
+		memmove(rgbHist, rgbHist + cb, cbLagA - cb);
+		memcpy(rgbHist + cbLagA - cb, rgb, cb);
+	}
+
+	ibStream += cb;
+}
+
+/* ------------------------------------------------------------ */
+/***	Prbs::Check
+**
+**	Parameters:
+**		rgb			- received data
+**		cb			- number of bytes
+**		pchk		- counts to add the result to
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Compares rgb with the next cb bytes of the sequence. A lost
+**		or repeated byte shifts the rest of the data against the
+**		sequence, so a slip shows up as a bit error rate near one
+**		half from the first byte in error on.
+*/
+
+void Prbs::Check(const BYTE * rgb, DWORD cb, PRBSCHK * pchk) {
+
+	DWORD	cbRef;
+	DWORD	ib;
+	BYTE	bDiff;
+
+	if (!fInit) {
+		return;
+	}
+
+	while (cb > 0) {
+		cbRef = (cb < cbPrbsRef) ? cb : cbPrbsRef;
+		Fill(rgbRef, cbRef);
+
+		ib = 0;
+		while (ib < cbRef) {
+			ib += pfnPrbsDiff(rgb + ib, rgbRef + ib, cbRef - ib);
+			if (ib >= cbRef) {
+				break;
+			}
+
+			bDiff = rgb[ib] ^ rgbRef[ib];
+			if (pchk->ibErrFirst < 0) {
+				pchk->ibErrFirst = ibStream - cbRef + ib;
+			}
+			pchk->cbErr++;
+			pchk->cbitErr += __builtin_popcount(bDiff);
+			ib++;
+		}
+
+		pchk->cbChecked += cbRef;
+		rgb += cbRef;
+		cb -= cbRef;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	Prbs::InitChk
+**
+**	Parameters:
+**		pchk		- counts to clear
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Clears a PRBSCHK before a test.
+*/
+
+void Prbs::InitChk(PRBSCHK * pchk) {
+
+	pchk->cbChecked = 0;
+	pchk->cbErr = 0;
+	pchk->cbitErr = 0;
+	pchk->ibErrFirst = -1;
+}
+
+/* ------------------------------------------------------------ */
+/***	Prbs::SzKernel
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		name of the instruction set used: "avx2", "sse2" or "scalar"
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reports which kernels were chosen for this processor.
+*/
+
+const char * Prbs::SzKernel() {
+
+	pthread_once(&oncePrbs, PrbsSelectKernels);
+
+	return szPrbsKernel;
+}
+
+/* ------------------------------------------------------------ */
+/***	PrbsSelectKernels
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Chooses the widest kernels the processor supports. Called
+**		once through pthread_once.
+*/
+
+static void PrbsSelectKernels() {
+
+	pfnPrbsXor = PrbsXorScalar;
+	pfnPrbsDiff = PrbsDiffScalar;
+	szPrbsKernel = "scalar";
+
+#if defined(PRBS_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		pfnPrbsXor = PrbsXorAvx2;
+		pfnPrbsDiff = PrbsDiffAvx2;
+		szPrbsKernel = "avx2";
+	}
+	else if (__builtin_cpu_supports("sse2")) {
+		pfnPrbsXor = PrbsXorSse2;
+		pfnPrbsDiff = PrbsDiffSse2;
+		szPrbsKernel = "sse2";
+	}
+#endif
+}
+
+/* ------------------------------------------------------------ */
+/*					Scalar Kernels								*/
+/* ------------------------------------------------------------ */
+
+static void PrbsXorScalar(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb) {
+
+	uint64_t	qwA;
+	uint64_t	qwB;
+	DWORD		ib;
+
+	for (ib = 0; ib + 8 <= cb; ib += 8) {
+		memcpy(&qwA, pbA + ib, 8);
+		memcpy(&qwB, pbB + ib, 8);
+		qwA ^= qwB;
+		memcpy(pbDst + ib, &qwA, 8);
+	}
+	for ( ; ib < cb; ib++) {
+		pbDst[ib] = pbA[ib] ^ pbB[ib];
+	}
+}
+
+/* ------------------------------------------------------------ */
+
+static DWORD PrbsDiffScalar(const BYTE * pbA, const BYTE * pbB, DWORD cb) {
+
+	uint64_t	qwA;
+	uint64_t	qwB;
+	DWORD		ib;
+
+	for (ib = 0; ib + 8 <= cb; ib += 8) {
+		memcpy(&qwA, pbA + ib, 8);
+		memcpy(&qwB, pbB + ib, 8);
+		if (qwA != qwB) {
+			break;
+		}
+	}
+	for ( ; ib < cb; ib++) {
+		if (pbA[ib] != pbB[ib]) {
+			return ib;
+		}
+	}
+
+	return cb;
+}
+
+#if defined(PRBS_X86)
+
+/* ------------------------------------------------------------ */
+/*					SSE2 Kernels								*/
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("sse2")))
+static void PrbsXorSse2(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb) {
+
+	__m128i	xmmA;
+	__m128i	xmmB;
+	DWORD	ib;
+
+	for (ib = 0; ib + 16 <= cb; ib += 16) {
+		xmmA = _mm_loadu_si128((const __m128i *) (pbA + ib));
+		xmmB = _mm_loadu_si128((const __m128i *) (pbB + ib));
+		_mm_storeu_si128((__m128i *) (pbDst + ib), _mm_xor_si128(xmmA, xmmB));
+	}
+	PrbsXorScalar(pbDst + ib, pbA + ib, pbB + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("sse2")))
+static DWORD PrbsDiffSse2(const BYTE * pbA, const BYTE * pbB, DWORD cb) {
+
+	__m128i	xmmA;
+	__m128i	xmmB;
+	DWORD	fNe;
+	DWORD	ib;
+
+	for (ib = 0; ib + 16 <= cb; ib += 16) {
+		xmmA = _mm_loadu_si128((const __m128i *) (pbA + ib));
+		xmmB = _mm_loadu_si128((const __m128i *) (pbB + ib));
+		fNe = ~((DWORD) _mm_movemask_epi8(_mm_cmpeq_epi8(xmmA, xmmB))) & 0xFFFF;
+		if (fNe != 0) {
+			return ib + __builtin_ctz(fNe);
+		}
+	}
+
+	return ib + PrbsDiffScalar(pbA + ib, pbB + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+/*					AVX2 Kernels								*/
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static void PrbsXorAvx2(BYTE * pbDst, const BYTE * pbA, const BYTE * pbB, DWORD cb) {
+
+	__m256i	ymmA;
+	__m256i	ymmB;
+	DWORD	ib;
+
+	for (ib = 0; ib + 32 <= cb; ib += 32) {
+		ymmA = _mm256_loadu_si256((const __m256i *) (pbA + ib));
+		ymmB = _mm256_loadu_si256((const __m256i *) (pbB + ib));
+		_mm256_storeu_si256((__m256i *) (pbDst + ib), _mm256_xor_si256(ymmA, ymmB));
+	}
+	PrbsXorScalar(pbDst + ib, pbA + ib, pbB + ib, cb - ib);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static DWORD PrbsDiffAvx2(const BYTE * pbA, const BYTE * pbB, DWORD cb) {
+
+	__m256i	ymmA;
+	__m256i	ymmB;
+	DWORD	fNe;
+	DWORD	ib;
+
+	for (ib = 0; ib + 32 <= cb; ib += 32) {
+		ymmA = _mm256_loadu_si256((const __m256i *) (pbA + ib));
+		ymmB = _mm256_loadu_si256((const __m256i *) (pbB + ib));
+		fNe = ~((DWORD) _mm256_movemask_epi8(_mm256_cmpeq_epi8(ymmA, ymmB)));
+		if (fNe != 0) {
+			return ib + __builtin_ctz(fNe);
+		}
+	}
+
+	return ib + PrbsDiffScalar(pbA + ib, pbB + ib, cb - ib);
+}
+
+#endif
+
+/************************************************************************/
@@ -0,0 +1,93 @@
+/************************************************************************/
+/*																		*/
+/*  Prbs.h  --  PRBS Generator and Checker Declarations					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A Prbs object generates the PRBS-7, PRBS-15 or PRBS-31			*/
+/*		pseudo random bit sequence, packed most significant bit first	*/
+/*		into bytes, and checks received data against it. The sender	*/
+/*		and the receiver of a link integrity test each initialize one	*/
+/*		with the same order and seed; the sender fills its transmit		*/
+/*		buffers with Fill and the receiver passes each received buffer	*/
+/*		to Check, which counts the bit errors and records the stream	*/
+/*		offset of the first byte in error.								*/
+/*																		*/
+/*		The sequences are those of the polynomials x^7 + x^6 + 1,		*/
+/*		x^15 + x^14 + 1 and x^31 + x^28 + 1 (ITU-T O.150). Fill and		*/
+/*		Check run at several GB/s using SSE2 or AVX2, chosen when the	*/
+/*		program runs, with a portable fallback.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(PRBS_INCLUDED)
+#define      PRBS_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Longest byte lag of the recurrences used to generate the
+** sequences, and the size of the reference blocks of Check.
+*/
+const DWORD		cbPrbsLagMax	= 512;
+const DWORD		cbPrbsRef		= 4096;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Result of checking received data. Check adds to the counts, so
+** one PRBSCHK can collect a whole test.
+*/
+typedef struct tagPRBSCHK {
+	long long	cbChecked;			// bytes checked
+	long long	cbErr;				// bytes with at least one bit error
+	long long	cbitErr;			// bits in error
+	long long	ibErrFirst;			// stream offset of the first, -1 if none
+} PRBSCHK;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class Prbs {
+
+private:
+	int			nOrder;
+	DWORD		cbLagA;				// byte[i] = byte[i-cbLagA] ^ byte[i-cbLagB]
+	DWORD		cbLagB;
+	BYTE		rgbHist[cbPrbsLagMax];	// last cbLagA bytes generated
+	BYTE		rgbRef[cbPrbsRef];		// expected data, used by Check
+	long long	ibStream;
+	BOOL		fInit;
+
+public:
+	Prbs();
+
+	BOOL	FInit(int nOrderInit, DWORD dwSeed);
+	void	Fill(BYTE * rgb, DWORD cb);
+	void	Check(const BYTE * rgb, DWORD cb, PRBSCHK * pchk);
+
+	int			Order()			{ return nOrder; }
+	long long	IbStream()		{ return ibStream; }
+
+	static void			InitChk(PRBSCHK * pchk);
+	static const char *	SzKernel();
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// PRBS_INCLUDED
+
+/************************************************************************/
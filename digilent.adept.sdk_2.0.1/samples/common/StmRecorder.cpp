@@ -0,0 +1,1084 @@
+/************************************************************************/
+/*																		*/
+/*  StmRecorder.cpp  --  Stream Disk Recorder							*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the StmRecorder class. See				*/
+/*		StmRecorder.h.													*/
+/*																		*/
+/*		Slot n of the recording holds bytes n * cbSlot to (n + 1) *		*/
+/*		cbSlot - 1 of the file data; only the last slot may be short.	*/
+/*		Segments are a whole number of slots, so slot n is written at	*/
+/*		a fixed offset of segment n / cslotSeg and every write is page	*/
+/*		aligned, as O_DIRECT requires. The last slot is padded to a		*/
+/*		whole page and the segment is truncated to the real length		*/
+/*		when the recording is closed.									*/
+/*																		*/
+/*		Writes may complete out of order, but slots are retired in		*/
+/*		order. Retiring a slot makes it free for the producer again,	*/
+/*		closes a segment once its last slot is retired, and writes		*/
+/*		the index records whose data has been written. io_uring is		*/
+/*		used through its system calls, so the samples do not depend		*/
+/*		on liburing; it needs IORING_OP_WRITE (Linux 5.6), which is		*/
+/*		checked with IORING_REGISTER_PROBE.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: unsegmented recordings keep the given file name			*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dpcdecl.h"
+#include "StmRecorder.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* O_DIRECT transfers are padded to this size.
+*/
+const DWORD		cbRecAlign		= 4096;
+
+/* Index records held per slot of the queue.
+*/
+const DWORD		cidxRecPerSlot	= 512;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static double	DblRecTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	StmRecorder::StmRecorder
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The recorder must be initialized with FInit
+**		before it is used.
+*/
+
+StmRecorder::StmRecorder() {
+
+	cslot = 0;
+	cbSlot = 0;
+	cslotSeg = 0;
+	cbSeg = 0;
+	frec = 0;
+	fInit = fFalse;
+	fpIdx = NULL;
+	rgidx = NULL;
+	rgislotLast = NULL;
+	fdRing = -1;
+	cthr = 0;
+	memset(&stat, 0, sizeof(stat));
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::FInit
+**
+**	Parameters:
+**		szFile		- base name of the segment files
+**		cbSlotInit	- bytes per slot, rounded up to whole pages
+**		cslotInit	- number of slots, 2 to cslotRecMax
+**		cbSegInit	- segment size, rounded up to whole slots; 0 to
+**					  record to szFile itself
+**		frecInit	- frecPwrite, frecBuffered or 0
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Allocates the queue, creates the index file and starts the
+**		writer threads. The segment files are created as the
+**		recording reaches them.
+*/
+
+BOOL StmRecorder::FInit(const char * szFile, DWORD cbSlotInit, DWORD cslotInit, long long cbSegInit, DWORD frecInit) {
+
+	char		szIdx[cchRecFileMax];
+	const char *	szDot;
+	const char *	szSlash;
+	DWORD		islot;
+	DWORD		ithr;
+	DWORD		ifd;
+
+	if (fInit || (cbSlotInit == 0) || (cslotInit < 2) || (cslotInit > cslotRecMax) ||
+		(cbSegInit < 0) || (strlen(szFile) + 16 >= cchRecFileMax)) {
+		return fFalse;
+	}
+
+	/* Split the name at the extension of the last path component.
+	*/
+	szDot = strrchr(szFile, '.');
+	szSlash = strrchr(szFile, '/');
+	if ((szDot == NULL) || ((szSlash != NULL) && (szDot < szSlash))) {
+		szDot = szFile + strlen(szFile);
+	}
+	snprintf(szStem, cchRecFileMax, "%.*s", (int) (szDot - szFile), szFile);
+	snprintf(szExt, cchRecFileMax, "%s", szDot);
+
+	/* Unsegmented, the recording takes the name of the index file.
+	*/
+	if ((cbSegInit == 0) && (strcmp(szExt, ".idx") == 0)) {
+		return fFalse;
+	}
+
+	if (!pool.FInit(cbSlotInit, cslotInit)) {
+		return fFalse;
+	}
+
+	cbSlot = pool.CbBuf();
+	cslot = cslotInit;
+	for (islot = 0; islot < cslot; islot++) {
+		rgslot[islot].pb = pool.PbAlloc();
+		rgslot[islot].cb = 0;
+		rgslot[islot].fDone = fFalse;
+	}
+
+	cslotSeg = 0;
+	cbSeg = 0;
+	if (cbSegInit > 0) {
+		cslotSeg = (DWORD) ((cbSegInit + cbSlot - 1) / cbSlot);
+		cbSeg = (long long) cslotSeg * cbSlot;
+	}
+
+	cidxRing = cslot * cidxRecPerSlot;
+	rgidx = (RECIDX *) malloc(cidxRing * sizeof(RECIDX));
+	rgislotLast = (long long *) malloc(cidxRing * sizeof(long long));
+
+	fpIdx = NULL;
+	if (snprintf(szIdx, cchRecFileMax, "%s.idx", szStem) < (int) cchRecFileMax) {
+		fpIdx = fopen(szIdx, "wb");
+	}
+
+	if ((rgidx == NULL) || (rgislotLast == NULL) || (fpIdx == NULL)) {
+		if (fpIdx != NULL) {
+			fclose(fpIdx);
+			fpIdx = NULL;
+		}
+		free(rgidx);
+		free(rgislotLast);
+		rgidx = NULL;
+		rgislotLast = NULL;
+		pool.Free();
+		return fFalse;
+	}
+
+	for (ifd = 0; ifd <= cslot; ifd++) {
+		rgfdSeg[ifd] = -1;
+	}
+
+	memset(&stat, 0, sizeof(stat));
+	stat.cslot = cslot;
+	stat.cbSlot = cbSlot;
+	stat.fDirect = ((frecInit & frecBuffered) == 0);
+
+	frec = frecInit;
+	ridx = 0;
+	ridxWritten = 0;
+	islotFill = 0;
+	islotIssue = 0;
+	islotRetire = 0;
+	cbFill = 0;
+	fClosing = fFalse;
+	cinflight = 0;
+	csqPending = 0;
+
+	pthread_mutex_init(&mtx, NULL);
+	pthread_cond_init(&condFull, NULL);
+
+	cthr = 0;
+	if (((frec & frecPwrite) == 0) && FUringSetup(cslot)) {
+		stat.fUring = fTrue;
+		if (pthread_create(&rgthr[0], NULL, UringThread, this) == 0) {
+			cthr = 1;
+		}
+	}
+	else {
+		for (ithr = 0; ithr < cthrRecPwrite; ithr++) {
+			if (pthread_create(&rgthr[cthr], NULL, PwriteThread, this) == 0) {
+				cthr++;
+			}
+		}
+	}
+
+	fInit = fTrue;
+
+	if (cthr == 0) {
+		FClose();
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::FRecord
+**
+**	Parameters:
+**		rgb			- completed stream buffer
+**		cb			- number of bytes
+**		ibStream	- stream offset of rgb[0], for the index
+**
+**	Return Value:
+**		fTrue if the buffer was queued, fFalse if it was dropped
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Copies a buffer into the queue and returns without waiting
+**		for any I/O. If the queue has no room for the whole buffer,
+**		or its index record, the buffer is dropped and counted. The
+**		buffer may be reused as soon as FRecord returns. FRecord must
+**		always be called from the same thread.
+*/
+
+BOOL StmRecorder::FRecord(const BYTE * rgb, DWORD cb, long long ibStream) {
+
+	RECIDX *	pidx;
+	struct timespec	ts;
+	long long	cbFree;
+	long long	ibRec;
+	DWORD		cbCopy;
+	DWORD		cslotBacklog;
+
+	if (!fInit || (cb == 0)) {
+		return fInit;
+	}
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+
+	pthread_mutex_lock(&mtx);
+
+	cbFree = (long long) (cslot - (islotFill - islotRetire)) * cbSlot - cbFill;
+	if (fClosing || (cb > cbFree) || (ridx - ridxWritten >= cidxRing)) {
+		stat.cbDropped += cb;
+		stat.cbufDropped++;
+		pthread_mutex_unlock(&mtx);
+		return fFalse;
+	}
+
+	ibRec = stat.cbRecorded;
+
+	pidx = &rgidx[ridx % cidxRing];
+	pidx->ibStream = ibStream;
+	pidx->tnsRecord = (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	pidx->iseg = (cslotSeg != 0) ? (DWORD) (ibRec / cbSeg) : 0;
+	pidx->ibSeg = (cslotSeg != 0) ? ibRec % cbSeg : ibRec;
+	pidx->cb = cb;
+	rgislotLast[ridx % cidxRing] = (ibRec + cb - 1) / cbSlot;
+	ridx++;
+
+	stat.cbRecorded += cb;
+
+	pthread_mutex_unlock(&mtx);
+
+	/* The slot being filled and the free slots after it belong to
+	** this thread, so the copy needs no lock.
+	*/
+	while (cb > 0) {
+		cbCopy = (cb < cbSlot - cbFill) ? cb : cbSlot - cbFill;
+		memcpy(rgslot[islotFill % cslot].pb + cbFill, rgb, cbCopy);
+		rgb += cbCopy;
+		cb -= cbCopy;
+		cbFill += cbCopy;
+
+		if (cbFill == cbSlot) {
+			pthread_mutex_lock(&mtx);
+			rgslot[islotFill % cslot].cb = cbSlot;
+			islotFill++;
+			cbFill = 0;
+			cslotBacklog = (DWORD) (islotFill - islotRetire);
+			if (cslotBacklog > stat.cslotBacklogMax) {
+				stat.cslotBacklogMax = cslotBacklog;
+			}
+			pthread_cond_broadcast(&condFull);
+			pthread_mutex_unlock(&mtx);
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::FClose
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if every write succeeded, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes the partly filled slot, waits for all writes, truncates
+**		the last segment to its length and closes the files.
+*/
+
+BOOL StmRecorder::FClose() {
+
+	DWORD		ithr;
+	DWORD		ifd;
+	long long	cbLast;
+
+	if (!fInit) {
+		return fFalse;
+	}
+
+	pthread_mutex_lock(&mtx);
+	if (cbFill > 0) {
+		rgslot[islotFill % cslot].cb = cbFill;
+		islotFill++;
+		cbFill = 0;
+	}
+	fClosing = fTrue;
+	pthread_cond_broadcast(&condFull);
+	pthread_mutex_unlock(&mtx);
+
+	for (ithr = 0; ithr < cthr; ithr++) {
+		pthread_join(rgthr[ithr], NULL);
+	}
+	cthr = 0;
+
+	/* Only the segment holding the end of the recording is still
+	** open, unless a write failed.
+	*/
+	cbLast = stat.cbRecorded;
+	if (cslotSeg != 0) {
+		cbLast = stat.cbRecorded - (stat.cbRecorded / cbSeg) * cbSeg;
+		if ((cbLast == 0) && (stat.cbRecorded > 0)) {
+			cbLast = cbSeg;
+		}
+	}
+
+	for (ifd = 0; ifd <= cslot; ifd++) {
+		if (rgfdSeg[ifd] >= 0) {
+			if (ftruncate(rgfdSeg[ifd], cbLast) != 0) {
+				SetError(errno);
+			}
+			close(rgfdSeg[ifd]);
+			rgfdSeg[ifd] = -1;
+		}
+	}
+
+	if (fpIdx != NULL) {
+		if (fclose(fpIdx) != 0) {
+			SetError(errno);
+		}
+		fpIdx = NULL;
+	}
+
+	UringFree();
+
+	pthread_cond_destroy(&condFull);
+	pthread_mutex_destroy(&mtx);
+
+	free(rgidx);
+	free(rgislotLast);
+	rgidx = NULL;
+	rgislotLast = NULL;
+
+	pool.Free();
+	fInit = fFalse;
+
+	return !stat.fError;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::GetStat
+**
+**	Parameters:
+**		pstat		- variable to receive the statistics
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the statistics of the recording. May be called while
+**		recording to watch the backlog, and after FClose.
+*/
+
+void StmRecorder::GetStat(RECSTAT * pstat) {
+
+	if (!fInit) {
+		*pstat = stat;
+		return;
+	}
+
+	pthread_mutex_lock(&mtx);
+	*pstat = stat;
+	pstat->cslotBacklog = (DWORD) (islotFill - islotRetire);
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::UringThread, StmRecorder::PwriteThread
+**
+**	Parameters:
+**		pvRec		- the StmRecorder
+**
+**	Return Value:
+**		NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Thread entry points.
+*/
+
+void * StmRecorder::UringThread(void * pvRec) {
+
+	((StmRecorder *) pvRec)->RunUring();
+
+	return NULL;
+}
+
+void * StmRecorder::PwriteThread(void * pvRec) {
+
+	((StmRecorder *) pvRec)->RunPwrite();
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::FUringSetup
+**
+**	Parameters:
+**		cent		- number of submission queue entries
+**
+**	Return Value:
+**		fTrue if io_uring can be used, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Creates the ring and maps its queues. Fails, leaving nothing
+**		allocated, if the kernel does not support io_uring or
+**		IORING_OP_WRITE, or if it is not permitted.
+*/
+
+BOOL StmRecorder::FUringSetup(DWORD cent) {
+
+	struct io_uring_params	params;
+	struct io_uring_probe *	pprobe;
+	size_t	cbProbe;
+	BOOL	fWrite;
+	BYTE *	pbSq;
+	BYTE *	pbCq;
+
+	memset(&params, 0, sizeof(params));
+	fdRing = (int) syscall(__NR_io_uring_setup, cent, &params);
+	if (fdRing < 0) {
+		fdRing = -1;
+		return fFalse;
+	}
+
+	cbProbe = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+	pprobe = (struct io_uring_probe *) calloc(1, cbProbe);
+	fWrite = (pprobe != NULL) &&
+			(syscall(__NR_io_uring_register, fdRing, IORING_REGISTER_PROBE, pprobe, 256) >= 0) &&
+			(pprobe->last_op >= IORING_OP_WRITE) &&
+			((pprobe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) != 0);
+	free(pprobe);
+	if (!fWrite) {
+		close(fdRing);
+		fdRing = -1;
+		return fFalse;
+	}
+
+	cbSqRing = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	cbCqRing = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (cbCqRing > cbSqRing) {
+			cbSqRing = cbCqRing;
+		}
+		cbCqRing = cbSqRing;
+	}
+
+	pvSqRing = mmap(NULL, cbSqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fdRing, IORING_OFF_SQ_RING);
+	if (pvSqRing == MAP_FAILED) {
+		close(fdRing);
+		fdRing = -1;
+		return fFalse;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		pvCqRing = pvSqRing;
+	}
+	else {
+		pvCqRing = mmap(NULL, cbCqRing, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fdRing, IORING_OFF_CQ_RING);
+		if (pvCqRing == MAP_FAILED) {
+			munmap(pvSqRing, cbSqRing);
+			close(fdRing);
+			fdRing = -1;
+			return fFalse;
+		}
+	}
+
+	cbSqes = params.sq_entries * sizeof(struct io_uring_sqe);
+	pvSqes = mmap(NULL, cbSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fdRing, IORING_OFF_SQES);
+	if (pvSqes == MAP_FAILED) {
+		if (pvCqRing != pvSqRing) {
+			munmap(pvCqRing, cbCqRing);
+		}
+		munmap(pvSqRing, cbSqRing);
+		close(fdRing);
+		fdRing = -1;
+		return fFalse;
+	}
+
+	pbSq = (BYTE *) pvSqRing;
+	pwSqHead = (unsigned *) (pbSq + params.sq_off.head);
+	pwSqTail = (unsigned *) (pbSq + params.sq_off.tail);
+	wSqMask = *(unsigned *) (pbSq + params.sq_off.ring_mask);
+	rgwSqArray = (unsigned *) (pbSq + params.sq_off.array);
+
+	pbCq = (BYTE *) pvCqRing;
+	pwCqHead = (unsigned *) (pbCq + params.cq_off.head);
+	pwCqTail = (unsigned *) (pbCq + params.cq_off.tail);
+	wCqMask = *(unsigned *) (pbCq + params.cq_off.ring_mask);
+	pvCqes = pbCq + params.cq_off.cqes;
+
+	csqe = params.sq_entries;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::UringFree
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Unmaps the queues and closes the ring, if there is one.
+*/
+
+void StmRecorder::UringFree() {
+
+	if (fdRing < 0) {
+		return;
+	}
+
+	munmap(pvSqes, cbSqes);
+	if (pvCqRing != pvSqRing) {
+		munmap(pvCqRing, cbCqRing);
+	}
+	munmap(pvSqRing, cbSqRing);
+	close(fdRing);
+	fdRing = -1;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::RunUring
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writer thread when io_uring is used. Queues a write for every
+**		full slot, up to the size of the submission queue, then
+**		submits them and waits for at least one completion in the
+**		same system call. Each completion is passed to SlotDone.
+*/
+
+void StmRecorder::RunUring() {
+
+	struct io_uring_sqe *	psqe;
+	struct io_uring_cqe *	pcqe;
+	RECSLOT *	pslot;
+	unsigned	wTail;
+	unsigned	wHead;
+	long long	islot;
+	long		cbResult;
+	int			fd;
+	int			cent;
+	BOOL		fFail;
+
+	fFail = fFalse;
+
+	pthread_mutex_lock(&mtx);
+
+	for (;;) {
+		while ((islotIssue < islotFill) && (cinflight + csqPending < csqe)) {
+			islot = islotIssue++;
+			pslot = &rgslot[islot % cslot];
+			pslot->dblIssue = DblRecTimeSec();
+
+			fd = FdSegment(islot);
+			if ((fd < 0) || fFail) {
+				SlotDone(islot, -EIO);
+				continue;
+			}
+
+			wTail = *pwSqTail;
+			psqe = &((struct io_uring_sqe *) pvSqes)[wTail & wSqMask];
+			memset(psqe, 0, sizeof(*psqe));
+			psqe->opcode = IORING_OP_WRITE;
+			psqe->fd = fd;
+			psqe->addr = (unsigned long long) (size_t) pslot->pb;
+			psqe->len = CbSlotWrite(pslot->cb);
+			psqe->off = (cslotSeg != 0) ? (unsigned long long) (islot % cslotSeg) * cbSlot :
+										  (unsigned long long) islot * cbSlot;
+			psqe->user_data = (unsigned long long) islot;
+			rgwSqArray[wTail & wSqMask] = wTail & wSqMask;
+			__atomic_store_n(pwSqTail, wTail + 1, __ATOMIC_RELEASE);
+			csqPending++;
+		}
+
+		if ((cinflight == 0) && (csqPending == 0)) {
+			if (fClosing && (islotIssue == islotFill)) {
+				break;
+			}
+			pthread_cond_wait(&condFull, &mtx);
+			continue;
+		}
+
+		pthread_mutex_unlock(&mtx);
+
+		cent = (int) syscall(__NR_io_uring_enter, fdRing, csqPending, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+
+		pthread_mutex_lock(&mtx);
+
+		if (cent < 0) {
+			if ((errno == EINTR) || (errno == EAGAIN) || (errno == EBUSY)) {
+				continue;
+			}
+
+			/* The ring is unusable. The writes queued but not taken
+			** by the kernel are not going to complete, and nothing
+			** more is written.
+			*/
+			SetError(errno);
+			fFail = fTrue;
+			if (cinflight == 0) {
+				while (csqPending > 0) {
+					SlotDone(islotIssue - csqPending, -EIO);
+					csqPending--;
+				}
+				continue;
+			}
+			cent = 0;
+		}
+
+		cinflight += cent;
+		csqPending -= cent;
+
+		wHead = *pwCqHead;
+		while (wHead != __atomic_load_n(pwCqTail, __ATOMIC_ACQUIRE)) {
+			pcqe = &((struct io_uring_cqe *) pvCqes)[wHead & wCqMask];
+			islot = (long long) pcqe->user_data;
+			cbResult = pcqe->res;
+			wHead++;
+			__atomic_store_n(pwCqHead, wHead, __ATOMIC_RELEASE);
+
+			cinflight--;
+			SlotDone(islot, cbResult);
+		}
+	}
+
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::RunPwrite
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writer thread when io_uring is not used. Each of the threads
+**		takes the next full slot and writes it with pwrite, so up to
+**		cthrRecPwrite writes are in flight.
+*/
+
+void StmRecorder::RunPwrite() {
+
+	RECSLOT *	pslot;
+	long long	islot;
+	long long	ib;
+	long		cbResult;
+	ssize_t		cbDone;
+	DWORD		cbWrite;
+	int			fd;
+
+	pthread_mutex_lock(&mtx);
+
+	for (;;) {
+		while ((islotIssue == islotFill) && !fClosing) {
+			pthread_cond_wait(&condFull, &mtx);
+		}
+		if (islotIssue == islotFill) {
+			break;
+		}
+
+		islot = islotIssue++;
+		pslot = &rgslot[islot % cslot];
+		pslot->dblIssue = DblRecTimeSec();
+
+		fd = FdSegment(islot);
+		if (fd < 0) {
+			SlotDone(islot, -EIO);
+			continue;
+		}
+
+		ib = (cslotSeg != 0) ? (long long) (islot % cslotSeg) * cbSlot : islot * cbSlot;
+		cbWrite = CbSlotWrite(pslot->cb);
+
+		pthread_mutex_unlock(&mtx);
+
+		cbResult = 0;
+		while ((DWORD) cbResult < cbWrite) {
+			cbDone = pwrite(fd, pslot->pb + cbResult, cbWrite - cbResult, ib + cbResult);
+			if (cbDone < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				cbResult = -errno;
+				break;
+			}
+			if (cbDone == 0) {
+				cbResult = -EIO;
+				break;
+			}
+			cbResult += (long) cbDone;
+		}
+
+		pthread_mutex_lock(&mtx);
+		SlotDone(islot, cbResult);
+	}
+
+	pthread_mutex_unlock(&mtx);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::FdSegment
+**
+**	Parameters:
+**		islot		- slot to be written
+**
+**	Return Value:
+**		file descriptor of the segment holding the slot, -1 if it
+**		cannot be opened
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called with mtx held. Opens the segment on its first slot,
+**		with O_DIRECT unless the file system refuses it, and
+**		preallocates it. Slots of a segment are issued in order, so
+**		the first slot issued is slot 0 of the segment.
+*/
+
+int StmRecorder::FdSegment(long long islot) {
+
+	char	szName[cchRecFileMax];
+	DWORD	iseg;
+	DWORD	ifd;
+	int		fd;
+
+	iseg = (cslotSeg != 0) ? (DWORD) (islot / cslotSeg) : 0;
+	ifd = iseg % (cslot + 1);
+
+	if (rgfdSeg[ifd] >= 0) {
+		return rgfdSeg[ifd];
+	}
+
+	SegmentName(iseg, szName);
+
+	fd = -1;
+	if (stat.fDirect) {
+		fd = open(szName, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+		if ((fd < 0) && (errno == EINVAL)) {
+			stat.fDirect = fFalse;
+		}
+	}
+	if (!stat.fDirect) {
+		fd = open(szName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+	if (fd < 0) {
+		SetError(errno);
+		return -1;
+	}
+
+	/* Not every file system can preallocate; the segment then grows
+	** as it is written.
+	*/
+	if (cbSeg > 0) {
+		(void) fallocate(fd, 0, 0, cbSeg);
+	}
+
+	rgfdSeg[ifd] = fd;
+	stat.cseg++;
+
+	return fd;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::CbSlotWrite
+**
+**	Parameters:
+**		cb			- bytes of data in a slot
+**
+**	Return Value:
+**		bytes to write
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		O_DIRECT writes must be whole blocks, so a short last slot is
+**		padded. The padding is truncated away by FClose.
+*/
+
+DWORD StmRecorder::CbSlotWrite(DWORD cb) {
+
+	if (!stat.fDirect) {
+		return cb;
+	}
+
+	return ((cb + cbRecAlign - 1) / cbRecAlign) * cbRecAlign;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::SlotDone
+**
+**	Parameters:
+**		islot		- slot whose write completed
+**		cbResult	- bytes written, or a negative errno
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called with mtx held. Records the result and retires the
+**		slots that are complete.
+*/
+
+void StmRecorder::SlotDone(long long islot, long cbResult) {
+
+	RECSLOT *	pslot;
+	double		dblWrite;
+
+	pslot = &rgslot[islot % cslot];
+
+	if (cbResult < 0) {
+		SetError((int) -cbResult);
+	}
+	else if ((DWORD) cbResult < pslot->cb) {
+		SetError(EIO);
+	}
+
+	dblWrite = DblRecTimeSec() - pslot->dblIssue;
+	if (dblWrite > stat.dblWriteMax) {
+		stat.dblWriteMax = dblWrite;
+	}
+
+	pslot->fDone = fTrue;
+	Retire();
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::Retire
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called with mtx held. Retires the completed slots in order,
+**		closes each segment after its last full slot and writes the
+**		index records whose data is now written.
+*/
+
+void StmRecorder::Retire() {
+
+	RECSLOT *	pslot;
+	DWORD		ifd;
+
+	while ((islotRetire < islotIssue) && rgslot[islotRetire % cslot].fDone) {
+		pslot = &rgslot[islotRetire % cslot];
+		if (!stat.fError) {
+			stat.cbWritten += pslot->cb;
+		}
+
+		if ((cslotSeg != 0) && (pslot->cb == cbSlot) && ((islotRetire + 1) % cslotSeg == 0)) {
+			ifd = (DWORD) ((islotRetire / cslotSeg) % (cslot + 1));
+			if (rgfdSeg[ifd] >= 0) {
+				close(rgfdSeg[ifd]);
+				rgfdSeg[ifd] = -1;
+			}
+		}
+
+		pslot->fDone = fFalse;
+		pslot->cb = 0;
+		islotRetire++;
+	}
+
+	while ((ridxWritten != ridx) && (rgislotLast[ridxWritten % cidxRing] < islotRetire)) {
+		if (fwrite(&rgidx[ridxWritten % cidxRing], sizeof(RECIDX), 1, fpIdx) != 1) {
+			SetError(errno);
+		}
+		ridxWritten++;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::SetError
+**
+**	Parameters:
+**		err			- errno of the failure
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called with mtx held, or after the threads have ended.
+**		Records the first failure.
+*/
+
+void StmRecorder::SetError(int err) {
+
+	if (!stat.fError) {
+		stat.fError = fTrue;
+		stat.errnoFirst = err;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRecorder::SegmentName
+**
+**	Parameters:
+**		iseg		- segment number
+**		szName		- buffer of cchRecFileMax characters
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Builds the file name of a segment: the base name with the
+**		segment number inserted before the extension, or the base
+**		name itself if the recording is not segmented.
+*/
+
+void StmRecorder::SegmentName(DWORD iseg, char * szName) {
+
+	int		cch;
+
+	/* FInit limits the length of the base name, so the name fits.
+	** An unsegmented recording keeps the name it was given.
+	*/
+	if (cslotSeg == 0) {
+		cch = snprintf(szName, cchRecFileMax, "%s%s", szStem, szExt);
+	}
+	else {
+		cch = snprintf(szName, cchRecFileMax, "%s.%04lu%s", szStem, (unsigned long) iseg, szExt);
+	}
+	if (cch >= (int) cchRecFileMax) {
+		szName[0] = '\0';
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DblRecTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the writes.
+*/
+
+static double DblRecTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/************************************************************************/
@@ -0,0 +1,209 @@
+/************************************************************************/
+/*																		*/
+/*  StmRecorder.h  --  Stream Disk Recorder Declarations				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A StmRecorder writes a long stream to disk without going		*/
+/*		through the page cache and without ever blocking the thread		*/
+/*		that hands it data. FRecord copies each completed stream		*/
+/*		buffer into the current slot of a queue of large page aligned	*/
+/*		slots and returns; full slots are written by a writer thread	*/
+/*		with io_uring, or by a pool of threads calling pwrite if		*/
+/*		io_uring is not available. Files are opened with O_DIRECT		*/
+/*		where the file system allows it.								*/
+/*																		*/
+/*		The stream is split into segment files of a fixed size, named	*/
+/*		after the base file name with the segment number inserted		*/
+/*		before the extension: capture.bin is recorded as				*/
+/*		capture.0000.bin, capture.0001.bin and so on. Each segment is	*/
+/*		preallocated when it is opened and is truncated to its length	*/
+/*		when it is complete. Without segments the stream is recorded	*/
+/*		to capture.bin itself. An index file, capture.idx, receives one	*/
+/*		RECIDX record for each buffer passed to FRecord; a record is	*/
+/*		written once the buffer's data has been written.				*/
+/*																		*/
+/*		If the queue is full FRecord drops the buffer rather than		*/
+/*		wait, and counts it; the backlog of the queue and the drops		*/
+/*		are reported by GetStat.										*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(STMRECORDER_INCLUDED)
+#define      STMRECORDER_INCLUDED
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "dpcdecl.h"
+#include "BufPool.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Options of FInit.
+*/
+const DWORD		frecPwrite		= 0x0001;	// do not use io_uring
+const DWORD		frecBuffered	= 0x0002;	// do not use O_DIRECT
+
+/* Limits of the queue, and the number of pwrite threads.
+*/
+const DWORD		cslotRecMax		= 1024;
+const DWORD		cthrRecPwrite	= 4;
+
+/* Length of a segment file name.
+*/
+const DWORD		cchRecFileMax	= 1024;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Record of the index file, one per buffer passed to FRecord. The
+** buffer is at offset ibSeg of segment iseg, and is continued at the
+** start of the next segment if it does not fit.
+*/
+typedef struct tagRECIDX {
+	long long	ibStream;			// offset in the whole stream
+	long long	tnsRecord;			// CLOCK_REALTIME when recorded, ns
+	long long	ibSeg;				// offset in the segment
+	DWORD		iseg;				// segment number
+	DWORD		cb;					// length of the buffer
+} RECIDX;
+
+/* Statistics of a recording.
+*/
+typedef struct tagRECSTAT {
+	long long	cbRecorded;			// bytes accepted by FRecord
+	long long	cbWritten;			// bytes on disk
+	long long	cbDropped;			// bytes dropped because the queue was full
+	DWORD		cbufDropped;		// buffers dropped
+	DWORD		cslotBacklog;		// full slots not yet written
+	DWORD		cslotBacklogMax;
+	DWORD		cslot;				// slots in the queue
+	DWORD		cbSlot;				// bytes per slot
+	DWORD		cseg;				// segments opened
+	double		dblWriteMax;		// longest write of a slot, seconds
+	BOOL		fUring;				// written with io_uring
+	BOOL		fDirect;			// written with O_DIRECT
+	BOOL		fError;				// a write or open failed
+	int			errnoFirst;			// errno of the first failure
+} RECSTAT;
+
+/* A slot of the queue.
+*/
+typedef struct tagRECSLOT {
+	BYTE *		pb;
+	DWORD		cb;					// bytes of stream data
+	BOOL		fDone;				// write completed
+	double		dblIssue;			// time the write was issued
+} RECSLOT;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class StmRecorder {
+
+private:
+	BufPool		pool;
+	RECSLOT		rgslot[cslotRecMax];
+	DWORD		cslot;
+	DWORD		cbSlot;
+	DWORD		cslotSeg;			// slots per segment
+	long long	cbSeg;
+	DWORD		frec;
+	BOOL		fInit;
+
+	char		szStem[cchRecFileMax];
+	char		szExt[cchRecFileMax];
+	int			rgfdSeg[cslotRecMax + 1];	// open segments, by iseg % (cslot + 1)
+	FILE *		fpIdx;
+
+	/* Index records waiting for their data to be written. The ring
+	** holds at most cidxRing records; ridx counts the records added
+	** and ridxWritten the records written to the index file.
+	*/
+	RECIDX *	rgidx;
+	long long *	rgislotLast;		// slot holding the last byte of each
+	DWORD		cidxRing;
+	DWORD		ridx;
+	DWORD		ridxWritten;
+
+	/* Slots are filled, issued and retired in sequence order. The
+	** producer owns slot islotFill % cslot until it is full; the
+	** slots from islotRetire up to islotFill belong to the writers.
+	** All three counters and the index ring are protected by mtx.
+	*/
+	pthread_mutex_t	mtx;
+	pthread_cond_t	condFull;
+	long long	islotFill;
+	long long	islotIssue;
+	long long	islotRetire;
+	DWORD		cbFill;				// bytes in the slot being filled
+	BOOL		fClosing;
+
+	/* io_uring, driven with the raw system calls. The ring pointers
+	** point into the memory shared with the kernel.
+	*/
+	int			fdRing;
+	void *		pvSqRing;
+	size_t		cbSqRing;
+	void *		pvCqRing;
+	size_t		cbCqRing;
+	void *		pvSqes;
+	size_t		cbSqes;
+	unsigned *	pwSqHead;
+	unsigned *	pwSqTail;
+	unsigned *	rgwSqArray;
+	unsigned	wSqMask;
+	unsigned *	pwCqHead;
+	unsigned *	pwCqTail;
+	unsigned	wCqMask;
+	void *		pvCqes;
+	DWORD		csqe;
+	DWORD		cinflight;			// writes submitted and not completed
+	DWORD		csqPending;			// entries queued and not yet submitted
+
+	pthread_t	rgthr[cthrRecPwrite];
+	DWORD		cthr;
+
+	RECSTAT		stat;
+
+	static void *	UringThread(void * pvRec);
+	static void *	PwriteThread(void * pvRec);
+
+	BOOL	FUringSetup(DWORD cent);
+	void	UringFree();
+	void	RunUring();
+	void	RunPwrite();
+	int		FdSegment(long long islot);
+	DWORD	CbSlotWrite(DWORD cb);
+	void	SlotDone(long long islot, long cbResult);
+	void	Retire();
+	void	SetError(int err);
+	void	SegmentName(DWORD iseg, char * szName);
+
+public:
+	StmRecorder();
+
+	BOOL	FInit(const char * szFile, DWORD cbSlotInit, DWORD cslotInit, long long cbSegInit, DWORD frecInit);
+	BOOL	FRecord(const BYTE * rgb, DWORD cb, long long ibStream);
+	BOOL	FClose();
+	void	GetStat(RECSTAT * pstat);
+};
+
+/* ------------------------------------------------------------ */
+
+#endif					// STMRECORDER_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,650 @@
+/************************************************************************/
+/*																		*/
+/*  StmRing.cpp  --  Shared Stream Receive Ring							*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Layout, counters and shared memory mapping of a stream ring.	*/
+/*		See StmRing.h.													*/
+/*																		*/
+/*		The producer stores ixferCommit with release ordering after		*/
+/*		the data of the slots, and the consumer loads it with acquire	*/
+/*		ordering before reading them; ixferRelease works the same way	*/
+/*		in the other direction. Each store is followed by a futex		*/
+/*		wake on the counter, and a side that finds no slot waits on		*/
+/*		the value of the counter it last saw, so a store between the	*/
+/*		check and the wait is never missed.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "StmRing.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static BOOL		FStmRingWait(DWORD * pdw, DWORD dwSeen, const struct timespec * ptsEnd);
+static void		StmRingWake(DWORD * pdw);
+static void		StmRingDeadline(DWORD tmsWait, struct timespec * pts);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	CbStmRingRegion
+**
+**	Parameters:
+**		cbSlot		- bytes per slot
+**		cslot		- number of slots
+**
+**	Return Value:
+**		size of a region holding the ring
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the size of region to allocate for a ring. The slot
+**		size is rounded up to whole pages.
+*/
+
+size_t CbStmRingRegion(DWORD cbSlot, DWORD cslot) {
+
+	size_t	cbPage;
+
+	cbPage = (size_t) sysconf(_SC_PAGESIZE);
+	cbSlot = (DWORD) (((cbSlot + cbPage - 1) / cbPage) * cbPage);
+
+	return cbStmRingHdr + (size_t) cbSlot * cslot;
+}
+
+/* ------------------------------------------------------------ */
+/***	PringStmRingFormat
+**
+**	Parameters:
+**		pv			- page aligned region
+**		cb			- size of the region
+**		cbSlot		- bytes per slot, rounded up to whole pages
+**
+**	Return Value:
+**		the ring, NULL if the region cannot hold two slots
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the region an empty ring with as many slots as fit.
+**		Called by the producer before the stream starts.
+*/
+
+STMRING * PringStmRingFormat(void * pv, size_t cb, DWORD cbSlot) {
+
+	STMRING *	pring = (STMRING *) pv;
+	size_t		cbPage;
+
+	cbPage = (size_t) sysconf(_SC_PAGESIZE);
+	if ((pv == NULL) || (cbSlot == 0) || ((size_t) pv % cbPage != 0)) {
+		return NULL;
+	}
+
+	cbSlot = (DWORD) (((cbSlot + cbPage - 1) / cbPage) * cbPage);
+	if (cb < cbStmRingHdr + 2 * (size_t) cbSlot) {
+		return NULL;
+	}
+
+	memset(pring, 0, sizeof(STMRING));
+	pring->dwVersion = dwStmRingVersion;
+	pring->cbSlot = cbSlot;
+	pring->cslot = (DWORD) ((cb - cbStmRingHdr) / cbSlot);
+	pring->ibData = cbStmRingHdr;
+	pring->erc = ercNoErc;
+
+	/* The magic number goes in last, so a consumer that attaches to
+	** a region being formatted does not take it for a ring.
+	*/
+	__atomic_store_n(&pring->dwMagic, dwStmRingMagic, __ATOMIC_RELEASE);
+
+	return pring;
+}
+
+/* ------------------------------------------------------------ */
+/***	PringStmRingAttach
+**
+**	Parameters:
+**		pv			- region holding a ring
+**		cb			- size of the region
+**
+**	Return Value:
+**		the ring, NULL if the region does not hold a valid ring
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Checks the header of a ring formatted by the producer, which
+**		may be in another process.
+*/
+
+STMRING * PringStmRingAttach(void * pv, size_t cb) {
+
+	STMRING *	pring = (STMRING *) pv;
+
+	if ((pv == NULL) || (cb < cbStmRingHdr)) {
+		return NULL;
+	}
+
+	if ((__atomic_load_n(&pring->dwMagic, __ATOMIC_ACQUIRE) != dwStmRingMagic) ||
+		(pring->dwVersion != dwStmRingVersion) || (pring->cbSlot == 0) ||
+		(pring->cslot < 2) || (pring->ibData < sizeof(STMRING)) ||
+		(pring->ibData + (size_t) pring->cbSlot * pring->cslot > cb)) {
+		return NULL;
+	}
+
+	return pring;
+}
+
+/* ------------------------------------------------------------ */
+/***	PbStmRingSlot
+**
+**	Parameters:
+**		pring		- ring
+**		ixfer		- slot count
+**
+**	Return Value:
+**		start of the slot
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the slot that the ixfer'th transfer of the stream
+**		goes into.
+*/
+
+BYTE * PbStmRingSlot(STMRING * pring, DWORD ixfer) {
+
+	return (BYTE *) pring + pring->ibData + (size_t) (ixfer % pring->cslot) * pring->cbSlot;
+}
+
+/* ------------------------------------------------------------ */
+/***	FStmRingWaitFree
+**
+**	Parameters:
+**		pring		- ring
+**		ixfer		- slot count of the slot to fill
+**		tmsWait		- longest wait, tmsWaitInfinite for no limit
+**
+**	Return Value:
+**		fTrue if the slot is free, fFalse if the wait timed out
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called by the producer to wait until the consumer has
+**		released the slot that the ixfer'th transfer goes into.
+*/
+
+BOOL FStmRingWaitFree(STMRING * pring, DWORD ixfer, DWORD tmsWait) {
+
+	struct timespec	tsEnd;
+	DWORD	ixferRelease;
+
+	StmRingDeadline(tmsWait, &tsEnd);
+
+	while (fTrue) {
+		ixferRelease = __atomic_load_n(&pring->ixferRelease, __ATOMIC_ACQUIRE);
+		if (ixfer - ixferRelease < pring->cslot) {
+			return fTrue;
+		}
+
+		if (!FStmRingWait(&pring->ixferRelease, ixferRelease,
+				(tmsWait == tmsWaitInfinite) ? NULL : &tsEnd)) {
+			return fFalse;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingCommit
+**
+**	Parameters:
+**		pring			- ring
+**		ixferCommit		- number of slots filled since the start
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Publishes the filled slots to the consumer.
+*/
+
+void StmRingCommit(STMRING * pring, DWORD ixferCommit) {
+
+	__atomic_store_n(&pring->ixferCommit, ixferCommit, __ATOMIC_RELEASE);
+	StmRingWake(&pring->ixferCommit);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingEnd
+**
+**	Parameters:
+**		pring		- ring
+**		cbLast		- bytes in the last committed slot
+**		erc			- error that ended the stream, ercNoErc if none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Marks the end of the stream, after the last StmRingCommit.
+*/
+
+void StmRingEnd(STMRING * pring, DWORD cbLast, ERC erc) {
+
+	pring->cbLast = cbLast;
+	pring->erc = erc;
+	__atomic_store_n(&pring->fEnd, fTrue, __ATOMIC_RELEASE);
+	StmRingWake(&pring->ixferCommit);
+}
+
+/* ------------------------------------------------------------ */
+/***	FStmRingPeek
+**
+**	Parameters:
+**		pring		- ring
+**		pspan		- variable to receive the committed data
+**		tmsWait		- longest wait, tmsWaitInfinite for no limit
+**
+**	Return Value:
+**		fTrue if there is data, fFalse if the wait timed out or the
+**		stream has ended
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the committed slots from the first one not released
+**		up to the newest, or the end of the ring if they wrap around,
+**		waiting for one to be committed. The data stays valid until
+**		it is released with StmRingRelease. Calling FStmRingPeek
+**		again before that returns the same data and any committed
+**		since.
+*/
+
+BOOL FStmRingPeek(STMRING * pring, STMSPAN * pspan, DWORD tmsWait) {
+
+	struct timespec	tsEnd;
+	DWORD	ixferRelease;
+	DWORD	ixferCommit;
+	DWORD	islot;
+	DWORD	cslot;
+	BOOL	fEnd;
+
+	memset(pspan, 0, sizeof(STMSPAN));
+	StmRingDeadline(tmsWait, &tsEnd);
+
+	ixferRelease = pring->ixferRelease;
+
+	while (fTrue) {
+		/* fEnd is loaded first: once it is set, ixferCommit is final.
+		*/
+		fEnd = __atomic_load_n(&pring->fEnd, __ATOMIC_ACQUIRE);
+		ixferCommit = __atomic_load_n(&pring->ixferCommit, __ATOMIC_ACQUIRE);
+
+		if (ixferCommit != ixferRelease) {
+			break;
+		}
+
+		if (fEnd) {
+			return fFalse;
+		}
+
+		if (!FStmRingWait(&pring->ixferCommit, ixferCommit,
+				(tmsWait == tmsWaitInfinite) ? NULL : &tsEnd)) {
+			return fFalse;
+		}
+	}
+
+	islot = ixferRelease % pring->cslot;
+	cslot = ixferCommit - ixferRelease;
+	if (cslot > pring->cslot - islot) {
+		cslot = pring->cslot - islot;
+	}
+
+	pspan->pb = PbStmRingSlot(pring, ixferRelease);
+	pspan->cslot = cslot;
+	pspan->cb = cslot * pring->cbSlot;
+	pspan->ibStream = pring->ibRelease;
+
+	if (fEnd && (ixferRelease + cslot == ixferCommit)) {
+		pspan->cb -= pring->cbSlot - pring->cbLast;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingRelease
+**
+**	Parameters:
+**		pring		- ring
+**		pspan		- data returned by FStmRingPeek
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Gives the slots of a span back to the producer. The data must
+**		not be used afterwards.
+*/
+
+void StmRingRelease(STMRING * pring, const STMSPAN * pspan) {
+
+	pring->ibRelease += pspan->cb;
+	__atomic_store_n(&pring->ixferRelease, pring->ixferRelease + pspan->cslot, __ATOMIC_RELEASE);
+	StmRingWake(&pring->ixferRelease);
+}
+
+/* ------------------------------------------------------------ */
+/***	FStmRingEnded
+**
+**	Parameters:
+**		pring		- ring
+**
+**	Return Value:
+**		fTrue if the stream has ended and every slot was released
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Tells the end of the stream from a timed out FStmRingPeek.
+**		pring->erc then gives the error that ended it, if any.
+*/
+
+BOOL FStmRingEnded(STMRING * pring) {
+
+	return __atomic_load_n(&pring->fEnd, __ATOMIC_ACQUIRE) &&
+		(__atomic_load_n(&pring->ixferCommit, __ATOMIC_ACQUIRE) == pring->ixferRelease);
+}
+
+/* ------------------------------------------------------------ */
+/***	PvStmRingCreateShm
+**
+**	Parameters:
+**		szName		- name of the shared memory object, "/name"
+**		cb			- size of the region
+**
+**	Return Value:
+**		the mapped region, NULL if it cannot be created
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Creates a shared memory object for a ring and maps it. An
+**		object left by an earlier run is replaced. The region is
+**		touched so that no page faults happen during the stream.
+*/
+
+void * PvStmRingCreateShm(const char * szName, size_t cb) {
+
+	void *	pv;
+	int		fd;
+
+	shm_unlink(szName);
+
+	fd = shm_open(szName, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	if (ftruncate(fd, (off_t) cb) != 0) {
+		close(fd);
+		shm_unlink(szName);
+		return NULL;
+	}
+
+	pv = mmap(NULL, cb, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+	close(fd);
+
+	if (pv == MAP_FAILED) {
+		shm_unlink(szName);
+		return NULL;
+	}
+
+	return pv;
+}
+
+/* ------------------------------------------------------------ */
+/***	PvStmRingOpenShm
+**
+**	Parameters:
+**		szName		- name of the shared memory object
+**		pcb			- variable to receive the size of the region
+**
+**	Return Value:
+**		the mapped region, NULL if it cannot be opened
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Maps a ring created by another process. The consumer writes
+**		its counters in the header, so the region is mapped read and
+**		write.
+*/
+
+void * PvStmRingOpenShm(const char * szName, size_t * pcb) {
+
+	struct stat	st;
+	void *	pv;
+	int		fd;
+
+	fd = shm_open(szName, O_RDWR, 0);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	if ((fstat(fd, &st) != 0) || (st.st_size < (off_t) cbStmRingHdr)) {
+		close(fd);
+		return NULL;
+	}
+
+	pv = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (pv == MAP_FAILED) {
+		return NULL;
+	}
+
+	*pcb = (size_t) st.st_size;
+
+	return pv;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingUnmap
+**
+**	Parameters:
+**		pv			- region mapped by PvStmRingCreateShm or
+**					  PvStmRingOpenShm
+**		cb			- size of the region
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Unmaps a shared ring region.
+*/
+
+void StmRingUnmap(void * pv, size_t cb) {
+
+	if (pv != NULL) {
+		munmap(pv, cb);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingUnlinkShm
+**
+**	Parameters:
+**		szName		- name of the shared memory object
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Removes the name of a shared ring. Processes that have it
+**		mapped keep their mapping.
+*/
+
+void StmRingUnlinkShm(const char * szName) {
+
+	shm_unlink(szName);
+}
+
+/* ------------------------------------------------------------ */
+/***	FStmRingWait
+**
+**	Parameters:
+**		pdw			- counter to wait on
+**		dwSeen		- value of the counter last seen
+**		ptsEnd		- time to give up, on the monotonic clock, or
+**					  NULL to wait without limit
+**
+**	Return Value:
+**		fTrue if the counter may have changed, fFalse if the time
+**		is up
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the counter no longer holds dwSeen. The futex is
+**		not private, so the wake may come from another process.
+*/
+
+static BOOL FStmRingWait(DWORD * pdw, DWORD dwSeen, const struct timespec * ptsEnd) {
+
+	struct timespec	tsNow;
+	struct timespec	tsRel;
+
+	if (ptsEnd == NULL) {
+		syscall(SYS_futex, pdw, FUTEX_WAIT, dwSeen, NULL, NULL, 0);
+		return fTrue;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tsNow);
+	tsRel.tv_sec = ptsEnd->tv_sec - tsNow.tv_sec;
+	tsRel.tv_nsec = ptsEnd->tv_nsec - tsNow.tv_nsec;
+	if (tsRel.tv_nsec < 0) {
+		tsRel.tv_sec--;
+		tsRel.tv_nsec += 1000000000;
+	}
+	if (tsRel.tv_sec < 0) {
+		return fFalse;
+	}
+
+	syscall(SYS_futex, pdw, FUTEX_WAIT, dwSeen, &tsRel, NULL, 0);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingWake
+**
+**	Parameters:
+**		pdw			- counter that changed
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Wakes the other side if it is waiting on the counter.
+*/
+
+static void StmRingWake(DWORD * pdw) {
+
+	syscall(SYS_futex, pdw, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmRingDeadline
+**
+**	Parameters:
+**		tmsWait		- time to wait in milliseconds
+**		pts			- variable to receive the time to give up
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the monotonic time tmsWait from now.
+*/
+
+static void StmRingDeadline(DWORD tmsWait, struct timespec * pts) {
+
+	clock_gettime(CLOCK_MONOTONIC, pts);
+
+	if (tmsWait == tmsWaitInfinite) {
+		return;
+	}
+
+	pts->tv_sec += tmsWait / 1000;
+	pts->tv_nsec += (long) (tmsWait % 1000) * 1000000;
+	if (pts->tv_nsec >= 1000000000) {
+		pts->tv_sec++;
+		pts->tv_nsec -= 1000000000;
+	}
+}
+
+/************************************************************************/
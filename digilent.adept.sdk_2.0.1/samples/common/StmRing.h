@@ -0,0 +1,130 @@
+/************************************************************************/
+/*																		*/
+/*  StmRing.h  --  Shared Stream Receive Ring Declarations				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		A stream ring is a region of memory owned by the caller that	*/
+/*		a producer fills with a stream, one slot at a time, and a		*/
+/*		consumer reads in place. The region starts with a header		*/
+/*		page holding the layout of the ring and two counters: the		*/
+/*		slots committed by the producer and the slots released by		*/
+/*		the consumer. The slots follow, each starting on a page			*/
+/*		boundary. A slot is written only while it is free and read		*/
+/*		only while it is committed, so no data is ever copied and no	*/
+/*		lock is needed.													*/
+/*																		*/
+/*		The header holds no pointers, only offsets, so the region can	*/
+/*		be mapped at different addresses in different processes.		*/
+/*		PvStmRingCreateShm creates a ring region in POSIX shared		*/
+/*		memory, and PvStmRingOpenShm maps it into another process.		*/
+/*		Waits on the counters are futex waits, which work across		*/
+/*		processes.														*/
+/*																		*/
+/*		Producer: PringStmRingFormat, then for each slot				*/
+/*		FStmRingWaitFree, fill PbStmRingSlot, StmRingCommit, and		*/
+/*		StmRingEnd at the end of the stream. DstmRingRecv is a			*/
+/*		producer that reads the DSTM port straight into the slots.		*/
+/*																		*/
+/*		Consumer: PringStmRingAttach, then FStmRingPeek to get a		*/
+/*		span of committed data and StmRingRelease when done with it,	*/
+/*		until FStmRingEnded. There is one consumer at a time; a new		*/
+/*		consumer continues where the last one stopped.					*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(STMRING_INCLUDED)
+#define      STMRING_INCLUDED
+
+#include <stddef.h>
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+const DWORD		dwStmRingMagic		= 0x47525341;	// "ASRG"
+const DWORD		dwStmRingVersion	= 1;
+
+/* Size of the header page; slot 0 starts at this offset.
+*/
+const DWORD		cbStmRingHdr		= 4096;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Header of a ring region. The producer and consumer counters are
+** on cache lines of their own. The counters count slots and wrap
+** at 2^32; only their differences are used.
+*/
+typedef struct tagSTMRING {
+	DWORD		dwMagic;
+	DWORD		dwVersion;
+	DWORD		cbSlot;
+	DWORD		cslot;
+	DWORD		ibData;				// offset of slot 0
+	BYTE		rgbPad0[44];
+
+	/* Written by the producer.
+	*/
+	DWORD		ixferCommit;		// slots committed
+	DWORD		fEnd;				// no more slots will be committed
+	DWORD		cbLast;				// bytes in the last slot, when fEnd
+	DWORD		erc;				// error that ended the stream
+	BYTE		rgbPad1[48];
+
+	/* Written by the consumer.
+	*/
+	DWORD		ixferRelease;		// slots released
+	DWORD		dwPad2;
+	long long	ibRelease;			// stream offset of the next slot
+	BYTE		rgbPad2[48];
+} STMRING;
+
+/* Committed data returned by FStmRingPeek: cslot slots holding cb
+** bytes at pb, which is stream offset ibStream.
+*/
+typedef struct tagSTMSPAN {
+	const BYTE *	pb;
+	DWORD		cb;
+	DWORD		cslot;
+	long long	ibStream;
+} STMSPAN;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+size_t		CbStmRingRegion(DWORD cbSlot, DWORD cslot);
+STMRING *	PringStmRingFormat(void * pv, size_t cb, DWORD cbSlot);
+STMRING *	PringStmRingAttach(void * pv, size_t cb);
+
+BYTE *		PbStmRingSlot(STMRING * pring, DWORD ixfer);
+BOOL		FStmRingWaitFree(STMRING * pring, DWORD ixfer, DWORD tmsWait);
+void		StmRingCommit(STMRING * pring, DWORD ixferCommit);
+void		StmRingEnd(STMRING * pring, DWORD cbLast, ERC erc);
+
+BOOL		FStmRingPeek(STMRING * pring, STMSPAN * pspan, DWORD tmsWait);
+void		StmRingRelease(STMRING * pring, const STMSPAN * pspan);
+BOOL		FStmRingEnded(STMRING * pring);
+
+void *		PvStmRingCreateShm(const char * szName, size_t cb);
+void *		PvStmRingOpenShm(const char * szName, size_t * pcb);
+void		StmRingUnmap(void * pv, size_t cb);
+void		StmRingUnlinkShm(const char * szName);
+
+/* ------------------------------------------------------------ */
+
+#endif					// STMRING_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,1101 @@
+/************************************************************************/
+/*																		*/
+/*  XbrMap.cpp  --  CoolRunner-II Fuse Map								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		Compiles CoolRunner-II fuse maps into binary tables, caches		*/
+/*		the tables next to the maps and makes programming rows with		*/
+/*		them. See XbrMap.h.												*/
+/*																		*/
+/*		The AVX2 kernel widens eight entries to 32 bits, gathers the	*/
+/*		DWORD of the fuse vector that holds each fuse and shifts the	*/
+/*		fuse down to bit 0. Markers are given the index 0 for that		*/
+/*		gather; if there are any, a second gather, masked to them,		*/
+/*		takes their values from the marker table. movemask then packs	*/
+/*		the eight bits into a byte of the row.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define XBRMAP_X86
+#endif
+
+#include "dpcdecl.h"
+#include "XbrMap.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Highest fuse number a map may hold, and highest held by 16-bit
+** entries.
+*/
+const DWORD		ifuseXbrMax		= dwXbrMarker - 1;
+const DWORD		ifuseXbrMax16	= wXbrMarker - 1;
+
+const DWORD		cxbrkrnMax		= 2;
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_once_t	onceXbr = PTHREAD_ONCE_INIT;
+static XBRKRN			xbrkrnCur;
+static XBRKRN			rgxbrkrn[cxbrkrnMax];	// supported, slowest first
+static DWORD			cxbrkrn;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static BOOL		FXbrParseCell(const char * pch, DWORD cch, DWORD * pdwEntry);
+static BOOL		FXbrParseNum(const char * pch, DWORD cch, DWORD dwMax, DWORD * pdw);
+static BOOL		FXbrTablePath(const char * szMap, char * szTable, DWORD cchTable);
+static void		XbrBuildValues(const XBRFILL * pfill, DWORD * rgdwValue);
+static void		XbrSelectKernels();
+static void		XbrGatherScalar16(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue);
+static void		XbrGatherScalar32(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue);
+
+#if defined(XBRMAP_X86)
+static void		XbrGatherAvx2_16(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue);
+static void		XbrGatherAvx2_32(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue);
+#endif
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	XbrMap::XbrMap
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Constructor. The map is empty until FInit.
+*/
+
+XbrMap::XbrMap() {
+
+	pbTable = NULL;
+	cbTable = 0;
+	fMapped = fFalse;
+	fCompiled = fFalse;
+	fWritten = fFalse;
+	ilineErr = 0;
+	szTable[0] = '\0';
+
+	phdr = NULL;
+	pbEntry = NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrMap::FInit
+**
+**	Parameters:
+**		szMap		- path of the fuse map
+**		fxbr		- options, fxbrXxx
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Fails if the map cannot be read or a cell of the map is not
+**		a fuse number or a marker; IlineErr then gives its line.
+**
+**	Description:
+**		Maps the table next to the map if it was compiled from the
+**		map as it is now. Otherwise compiles the map and writes the
+**		table, unless fxbrNoWrite is given; if the table cannot be
+**		written it is kept in memory.
+*/
+
+BOOL XbrMap::FInit(const char * szMap, DWORD fxbr) {
+
+	char		szTmp[cchXbrPathMax + 32];
+	struct stat	stMap;
+	BYTE *		pb;
+	size_t		cb;
+	FILE *		fp;
+	BOOL		fOk;
+
+	Free();
+
+	if ((stat(szMap, &stMap) != 0) || !FXbrTablePath(szMap, szTable, cchXbrPathMax)) {
+		return fFalse;
+	}
+
+	if (((fxbr & fxbrRebuild) == 0) && FMap(szTable, &stMap)) {
+		return fTrue;
+	}
+
+	if (!FXbrCompile(szMap, &pb, &cb, &ilineErr)) {
+		return fFalse;
+	}
+	fCompiled = fTrue;
+
+	/* Write the table under a temporary name and rename it, so that
+	** another process never maps a partly written table.
+	*/
+	if ((fxbr & fxbrNoWrite) == 0) {
+		snprintf(szTmp, sizeof(szTmp), "%s.%ld", szTable, (long) getpid());
+		fp = fopen(szTmp, "wb");
+		if (fp != NULL) {
+			fOk = (fwrite(pb, 1, cb, fp) == cb);
+			fOk = (fclose(fp) == 0) && fOk;
+			fOk = fOk && (rename(szTmp, szTable) == 0);
+			if (!fOk) {
+				unlink(szTmp);
+			}
+			else if (FMap(szTable, &stMap)) {
+				fWritten = fTrue;
+				free(pb);
+				return fTrue;
+			}
+		}
+	}
+
+	if (!FAttach(pb, cb)) {
+		free(pb);
+		return fFalse;
+	}
+	fMapped = fFalse;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrMap::Free
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Unmaps or frees the table.
+*/
+
+void XbrMap::Free() {
+
+	if (pbTable != NULL) {
+		if (fMapped) {
+			munmap(pbTable, cbTable);
+		}
+		else {
+			free(pbTable);
+		}
+	}
+
+	pbTable = NULL;
+	cbTable = 0;
+	fMapped = fFalse;
+	fCompiled = fFalse;
+	fWritten = fFalse;
+	ilineErr = 0;
+	phdr = NULL;
+	pbEntry = NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrMap::FGatherRows
+**
+**	Parameters:
+**		irowFirst	- first row to make
+**		crowGather	- number of rows
+**		rgbFuse		- JEDEC fuse vector, CbXbrFuse(cfuse) bytes
+**		cfuse		- number of fuses in the vector
+**		pfill		- values of the markers, NULL for the erased
+**					  state
+**		rgbRows		- buffer to receive crowGather * CbRow() bytes
+**		pkrn		- kernel set to use, NULL for the fastest
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Fails if there is no table, the rows are not in the map or
+**		the vector is shorter than the fuses of the map.
+**
+**	Description:
+**		Makes each row, bit i in bit i % 8 of byte i / 8 of the row.
+**		Each row starts on a byte; the bits after its last are 0.
+*/
+
+BOOL XbrMap::FGatherRows(DWORD irowFirst, DWORD crowGather, const BYTE * rgbFuse, DWORD cfuse,
+	const XBRFILL * pfill, BYTE * rgbRows, const XBRKRN * pkrn) {
+
+	DWORD			rgdwValue[256];
+	XBRFILL			fill;
+	PFNXBRGATHER	pfnGather;
+	DWORD			irow;
+
+	if ((phdr == NULL) || (irowFirst > phdr->crow) || (crowGather > phdr->crow - irowFirst) ||
+		(cfuse < phdr->cfuse)) {
+		return fFalse;
+	}
+
+	pthread_once(&onceXbr, XbrSelectKernels);
+
+	if (pkrn == NULL) {
+		pkrn = &xbrkrnCur;
+	}
+	pfnGather = (phdr->cbEntry == 2) ? pkrn->pfnGather16 : pkrn->pfnGather32;
+
+	if (pfill == NULL) {
+		XbrFillErased(&fill);
+		pfill = &fill;
+	}
+	XbrBuildValues(pfill, rgdwValue);
+
+	for (irow = 0; irow < crowGather; irow++) {
+		pfnGather(rgbRows + (size_t) irow * CbRow(),
+			pbEntry + (size_t) (irowFirst + irow) * phdr->cbitRow * phdr->cbEntry,
+			phdr->cbitRow, rgbFuse, rgdwValue);
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrMap::DwEntry
+**
+**	Parameters:
+**		irow		- row
+**		ibit		- bit of the row
+**
+**	Return Value:
+**		the entry of the bit, widened to 32 bits
+**
+**	Errors:
+**		Returns a marker of no fuse for a bit outside the map.
+**
+**	Description:
+**		Returns the fuse number of a bit, or its marker.
+*/
+
+DWORD XbrMap::DwEntry(DWORD irow, DWORD ibit) {
+
+	size_t	ientry;
+	WORD	w;
+
+	if ((phdr == NULL) || (irow >= phdr->crow) || (ibit >= phdr->cbitRow)) {
+		return DwXbrMarker(xbrkNone, 0);
+	}
+
+	ientry = (size_t) irow * phdr->cbitRow + ibit;
+	if (phdr->cbEntry == 2) {
+		w = ((const WORD *) pbEntry)[ientry];
+		return (w >= wXbrMarker) ? (dwXbrMarker | (w & 0xFF)) : w;
+	}
+
+	return ((const DWORD *) pbEntry)[ientry];
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrMap::FMap
+**
+**	Parameters:
+**		szTableFile	- path of the table
+**		pstMap		- status of the map
+**
+**	Return Value:
+**		fTrue if the table was mapped, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Maps the table if it exists, is valid and was compiled from a
+**		map of the size and modification time of the map.
+*/
+
+BOOL XbrMap::FMap(const char * szTableFile, const struct stat * pstMap) {
+
+	struct stat		st;
+	const XBRHDR *	phdrFile;
+	void *			pv;
+	int				fd;
+
+	fd = open(szTableFile, O_RDONLY);
+	if (fd < 0) {
+		return fFalse;
+	}
+
+	if ((fstat(fd, &st) != 0) || ((size_t) st.st_size < sizeof(XBRHDR))) {
+		close(fd);
+		return fFalse;
+	}
+
+	pv = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+	close(fd);
+	if (pv == MAP_FAILED) {
+		return fFalse;
+	}
+
+	phdrFile = (const XBRHDR *) pv;
+	if ((phdrFile->dwMagic != dwXbrMagic) || (phdrFile->ver != verXbrTable) ||
+		(phdrFile->cbFile != (DWORD) st.st_size) ||
+		(phdrFile->cbMap != (DWORD) pstMap->st_size) ||
+		(phdrFile->tsMap != (long long) pstMap->st_mtim.tv_sec) ||
+		(phdrFile->tnsMap != (long long) pstMap->st_mtim.tv_nsec) ||
+		!FAttach((BYTE *) pv, (size_t) st.st_size)) {
+
+		munmap(pv, (size_t) st.st_size);
+		return fFalse;
+	}
+
+	fMapped = fTrue;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrMap::FAttach
+**
+**	Parameters:
+**		pb		- table
+**		cb		- its length
+**
+**	Return Value:
+**		fTrue if the table is valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Checks that the entries lie within the table, that every
+**		fuse number is below the fuse count and every marker of a
+**		known kind, and makes it the table of the object. The
+**		kernels index the fuse vector with the entries, so they are
+**		checked here once rather than on each gather.
+*/
+
+BOOL XbrMap::FAttach(BYTE * pb, size_t cb) {
+
+	const XBRHDR *	phdrNew;
+	size_t			centry;
+	size_t			ientry;
+	DWORD			dw;
+	DWORD			cmarker;
+
+	phdrNew = (const XBRHDR *) pb;
+
+	if ((cb < sizeof(XBRHDR)) || (phdrNew->cbFile != cb) ||
+		((phdrNew->cbEntry != 2) && (phdrNew->cbEntry != 4)) ||
+		(phdrNew->ibEntry < sizeof(XBRHDR)) || ((phdrNew->ibEntry % phdrNew->cbEntry) != 0) ||
+		(phdrNew->cbitRow == 0) || (phdrNew->crow == 0)) {
+
+		return fFalse;
+	}
+
+	centry = (size_t) phdrNew->crow * phdrNew->cbitRow;
+	if (phdrNew->ibEntry + centry * phdrNew->cbEntry > cb) {
+		return fFalse;
+	}
+
+	cmarker = 0;
+	for (ientry = 0; ientry < centry; ientry++) {
+		if (phdrNew->cbEntry == 2) {
+			dw = ((const WORD *) (pb + phdrNew->ibEntry))[ientry];
+			if (dw >= wXbrMarker) {
+				dw |= dwXbrMarker;
+			}
+		}
+		else {
+			dw = ((const DWORD *) (pb + phdrNew->ibEntry))[ientry];
+		}
+
+		if (dw >= dwXbrMarker) {
+			if (((dw & 0xFF) >> 5) > xbrkUser) {
+				return fFalse;
+			}
+			cmarker++;
+		}
+		else if (dw >= phdrNew->cfuse) {
+			return fFalse;
+		}
+	}
+
+	if (cmarker != phdrNew->cmarker) {
+		return fFalse;
+	}
+
+	pbTable = pb;
+	cbTable = cb;
+	phdr = phdrNew;
+	pbEntry = pb + phdr->ibEntry;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FXbrCompile
+**
+**	Parameters:
+**		szMap		- path of the fuse map
+**		ppbTable	- variable to receive the table
+**		pcbTable	- variable to receive its length
+**		pilineErr	- variable to receive the line of the first cell
+**					  that cannot be read, 0 if the map could not
+**					  be read at all
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Fails if the map cannot be read, a cell is not a fuse number
+**		or a marker, or memory runs out.
+**
+**	Description:
+**		Compiles the map into a table allocated with malloc. The map
+**		is read twice: once to find its size and its highest fuse
+**		number, which decides the size of the entries, and once to
+**		fill the entries. A line with fewer cells than the widest
+**		line has no fuses in the columns it leaves out.
+*/
+
+BOOL FXbrCompile(const char * szMap, BYTE ** ppbTable, size_t * pcbTable, DWORD * pilineErr) {
+
+	XBRHDR		hdr;
+	struct stat	stMap;
+	FILE *		fp;
+	char *		rgchMap;
+	DWORD *		rgdwEntry;
+	BYTE *		pb;
+	DWORD		cchMap;
+	DWORD		ich;
+	DWORD		ichCell;
+	DWORD		cch;
+	DWORD		iline;
+	DWORD		icol;
+	DWORD		dwEntry;
+	DWORD		ifuseMax;
+	size_t		centry;
+	size_t		ientry;
+	BOOL		fOk;
+	int			ipass;
+
+	*pilineErr = 0;
+
+	fp = fopen(szMap, "rb");
+	if (fp == NULL) {
+		return fFalse;
+	}
+
+	rgchMap = NULL;
+	fOk = (fstat(fileno(fp), &stMap) == 0);
+	if (fOk) {
+		cchMap = (DWORD) stMap.st_size;
+		rgchMap = (char *) malloc(cchMap + 1);
+		fOk = (rgchMap != NULL) && (fread(rgchMap, 1, cchMap, fp) == cchMap);
+	}
+	fclose(fp);
+	if (!fOk) {
+		free(rgchMap);
+		return fFalse;
+	}
+
+	/* A last line without its newline is still a line.
+	*/
+	if ((cchMap > 0) && (rgchMap[cchMap - 1] != '\n')) {
+		rgchMap[cchMap++] = '\n';
+	}
+
+	memset(&hdr, 0, sizeof(hdr));
+	rgdwEntry = NULL;
+	ifuseMax = 0;
+
+	for (ipass = 0; fOk && (ipass < 2); ipass++) {
+		iline = 0;
+		icol = 0;
+		ichCell = 0;
+
+		for (ich = 0; fOk && (ich < cchMap); ich++) {
+			if ((rgchMap[ich] != '\t') && (rgchMap[ich] != '\n')) {
+				continue;
+			}
+
+			cch = ich - ichCell;
+			if ((cch > 0) && (rgchMap[ichCell + cch - 1] == '\r')) {
+				cch--;
+			}
+
+			if (!FXbrParseCell(rgchMap + ichCell, cch, &dwEntry)) {
+				*pilineErr = iline + 1;
+				fOk = fFalse;
+				break;
+			}
+
+			if (ipass == 0) {
+				if ((dwEntry < dwXbrMarker) && (dwEntry > ifuseMax)) {
+					ifuseMax = dwEntry;
+				}
+			}
+			else {
+				rgdwEntry[(size_t) icol * hdr.cbitRow + iline] = dwEntry;
+			}
+
+			icol++;
+			ichCell = ich + 1;
+
+			if (rgchMap[ich] == '\n') {
+				if ((ipass == 0) && (icol > hdr.crow)) {
+					hdr.crow = icol;
+				}
+				iline++;
+				icol = 0;
+			}
+		}
+
+		if (fOk && (ipass == 0)) {
+			hdr.cbitRow = iline;
+			centry = (size_t) hdr.crow * hdr.cbitRow;
+			fOk = (centry > 0) && (centry <= 0x10000000);
+			if (fOk) {
+				rgdwEntry = (DWORD *) malloc(centry * sizeof(DWORD));
+				fOk = (rgdwEntry != NULL);
+			}
+
+			/* The cells a short line leaves out are bits with no fuse.
+			*/
+			for (ientry = 0; fOk && (ientry < centry); ientry++) {
+				rgdwEntry[ientry] = DwXbrMarker(xbrkNone, 0);
+			}
+		}
+	}
+
+	free(rgchMap);
+
+	if (!fOk) {
+		free(rgdwEntry);
+		return fFalse;
+	}
+
+	centry = (size_t) hdr.crow * hdr.cbitRow;
+	hdr.cmarker = 0;
+	for (ientry = 0; ientry < centry; ientry++) {
+		if (rgdwEntry[ientry] >= dwXbrMarker) {
+			hdr.cmarker++;
+		}
+	}
+
+	hdr.dwMagic = dwXbrMagic;
+	hdr.ver = verXbrTable;
+	hdr.cbMap = (DWORD) stMap.st_size;
+	hdr.tsMap = (long long) stMap.st_mtim.tv_sec;
+	hdr.tnsMap = (long long) stMap.st_mtim.tv_nsec;
+	hdr.cfuse = (hdr.cmarker < centry) ? ifuseMax + 1 : 0;
+	hdr.cbEntry = (ifuseMax <= ifuseXbrMax16) ? 2 : 4;
+	hdr.ibEntry = sizeof(XBRHDR);
+	hdr.cbFile = hdr.ibEntry + (DWORD) (centry * hdr.cbEntry);
+
+	pb = (BYTE *) malloc(hdr.cbFile);
+	if (pb == NULL) {
+		free(rgdwEntry);
+		return fFalse;
+	}
+
+	memcpy(pb, &hdr, sizeof(hdr));
+	for (ientry = 0; ientry < centry; ientry++) {
+		if (hdr.cbEntry == 2) {
+			((WORD *) (pb + hdr.ibEntry))[ientry] = (WORD) rgdwEntry[ientry];
+		}
+		else {
+			((DWORD *) (pb + hdr.ibEntry))[ientry] = rgdwEntry[ientry];
+		}
+	}
+
+	free(rgdwEntry);
+
+	*ppbTable = pb;
+	*pcbTable = hdr.cbFile;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CbXbrFuse
+**
+**	Parameters:
+**		cfuse		- number of fuses
+**
+**	Return Value:
+**		bytes of a fuse vector of cfuse fuses
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The fuses rounded up to a whole DWORD, as the AVX2 kernel
+**		reads the vector a DWORD at a time.
+*/
+
+DWORD CbXbrFuse(DWORD cfuse) {
+
+	return ((cfuse + 31) / 32) * 4;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrFillErased
+**
+**	Parameters:
+**		pfill		- variable to receive the marker values
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Gives every marker the value of an erased bit, 1: the device
+**		is not secured, the DONE bits are left erased and the user
+**		code is FFFFFFFF. A programmer sets the bits it programs.
+*/
+
+void XbrFillErased(XBRFILL * pfill) {
+
+	pfill->fNone = fTrue;
+	pfill->fSpare = fTrue;
+	pfill->dwSec = 0xFFFFFFFF;
+	pfill->dwDone = 0xFFFFFFFF;
+	pfill->dwUser = 0xFFFFFFFF;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrSzKernel
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		name of the kernel in use
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns "avx2" or "scalar".
+*/
+
+const char * XbrSzKernel() {
+
+	pthread_once(&onceXbr, XbrSelectKernels);
+
+	return xbrkrnCur.szName;
+}
+
+/* ------------------------------------------------------------ */
+/***	FXbrGetKernel
+**
+**	Parameters:
+**		ikrn		- kernel set number, from 0
+**		pkrn		- variable to receive the kernel set
+**
+**	Return Value:
+**		fTrue if there is such a kernel set, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Lists the kernel sets the processor supports, slowest first.
+**		The last one is the set in use.
+*/
+
+BOOL FXbrGetKernel(DWORD ikrn, XBRKRN * pkrn) {
+
+	pthread_once(&onceXbr, XbrSelectKernels);
+
+	if (ikrn >= cxbrkrn) {
+		return fFalse;
+	}
+
+	*pkrn = rgxbrkrn[ikrn];
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FXbrParseCell
+**
+**	Parameters:
+**		pch			- text of the cell
+**		cch			- its length
+**		pdwEntry	- variable to receive the entry
+**
+**	Return Value:
+**		fTrue if the cell is a fuse number or a marker, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads a cell. The maps write the markers of the DONE and user
+**		code bits in more than one way: done_0 and done<0>, user_0
+**		and "user 0". A lone "user" labels the user code column.
+*/
+
+static BOOL FXbrParseCell(const char * pch, DWORD cch, DWORD * pdwEntry) {
+
+	DWORD	n;
+
+	if ((cch == 0) || ((cch == 4) && (memcmp(pch, "user", 4) == 0))) {
+		*pdwEntry = DwXbrMarker(xbrkNone, 0);
+		return fTrue;
+	}
+
+	if ((pch[0] >= '0') && (pch[0] <= '9')) {
+		return FXbrParseNum(pch, cch, ifuseXbrMax, pdwEntry);
+	}
+
+	if ((cch == 5) && (memcmp(pch, "spare", 5) == 0)) {
+		*pdwEntry = DwXbrMarker(xbrkSpare, 0);
+		return fTrue;
+	}
+
+	if ((cch > 4) && (memcmp(pch, "sec_", 4) == 0) &&
+		FXbrParseNum(pch + 4, cch - 4, cxbrMarkerNum - 1, &n)) {
+
+		*pdwEntry = DwXbrMarker(xbrkSec, n);
+		return fTrue;
+	}
+
+	if ((cch > 5) && (memcmp(pch, "done_", 5) == 0) &&
+		FXbrParseNum(pch + 5, cch - 5, cxbrMarkerNum - 1, &n)) {
+
+		*pdwEntry = DwXbrMarker(xbrkDone, n);
+		return fTrue;
+	}
+
+	if ((cch > 6) && (memcmp(pch, "done<", 5) == 0) && (pch[cch - 1] == '>') &&
+		FXbrParseNum(pch + 5, cch - 6, cxbrMarkerNum - 1, &n)) {
+
+		*pdwEntry = DwXbrMarker(xbrkDone, n);
+		return fTrue;
+	}
+
+	if ((cch > 5) && ((memcmp(pch, "user_", 5) == 0) || (memcmp(pch, "user ", 5) == 0)) &&
+		FXbrParseNum(pch + 5, cch - 5, cxbrMarkerNum - 1, &n)) {
+
+		*pdwEntry = DwXbrMarker(xbrkUser, n);
+		return fTrue;
+	}
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	FXbrParseNum
+**
+**	Parameters:
+**		pch			- digits
+**		cch			- number of digits
+**		dwMax		- highest value allowed
+**		pdw			- variable to receive the value
+**
+**	Return Value:
+**		fTrue if the digits are a decimal number up to dwMax
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads a decimal number.
+*/
+
+static BOOL FXbrParseNum(const char * pch, DWORD cch, DWORD dwMax, DWORD * pdw) {
+
+	unsigned long long	qw;
+	DWORD				ich;
+
+	if ((cch == 0) || (cch > 10)) {
+		return fFalse;
+	}
+
+	qw = 0;
+	for (ich = 0; ich < cch; ich++) {
+		if ((pch[ich] < '0') || (pch[ich] > '9')) {
+			return fFalse;
+		}
+		qw = 10 * qw + (pch[ich] - '0');
+	}
+
+	if (qw > dwMax) {
+		return fFalse;
+	}
+
+	*pdw = (DWORD) qw;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FXbrTablePath
+**
+**	Parameters:
+**		szMap		- path of the map
+**		szTable		- buffer to receive the path of its table
+**		cchTable	- size of the buffer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if the path does not fit
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The table of a map is in the same directory, with the
+**		extension of the map replaced by .xbm.
+*/
+
+static BOOL FXbrTablePath(const char * szMap, char * szTable, DWORD cchTable) {
+
+	const char *	pchSlash;
+	const char *	pchDot;
+	size_t			cchStem;
+
+	pchSlash = strrchr(szMap, '/');
+	pchDot = strrchr((pchSlash != NULL) ? pchSlash : szMap, '.');
+	cchStem = (pchDot != NULL) ? (size_t) (pchDot - szMap) : strlen(szMap);
+
+	if (cchStem + sizeof(".xbm") > cchTable) {
+		return fFalse;
+	}
+
+	memcpy(szTable, szMap, cchStem);
+	strcpy(szTable + cchStem, ".xbm");
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrBuildValues
+**
+**	Parameters:
+**		pfill		- values of the markers
+**		rgdwValue	- table to receive the value of each marker by
+**					  its low 8 bits
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills the marker table of the kernels.
+*/
+
+static void XbrBuildValues(const XBRFILL * pfill, DWORD * rgdwValue) {
+
+	DWORD	b;
+	DWORD	n;
+
+	for (b = 0; b < 256; b++) {
+		n = b & (cxbrMarkerNum - 1);
+		switch (b >> 5) {
+			case xbrkNone:	rgdwValue[b] = pfill->fNone ? 1 : 0;		break;
+			case xbrkSpare:	rgdwValue[b] = pfill->fSpare ? 1 : 0;		break;
+			case xbrkSec:	rgdwValue[b] = (pfill->dwSec >> n) & 1;		break;
+			case xbrkDone:	rgdwValue[b] = (pfill->dwDone >> n) & 1;	break;
+			case xbrkUser:	rgdwValue[b] = (pfill->dwUser >> n) & 1;	break;
+			default:		rgdwValue[b] = 0;							break;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	XbrSelectKernels
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Lists the kernel sets the processor supports and chooses the
+**		fastest. Called once through pthread_once.
+*/
+
+static void XbrSelectKernels() {
+
+	cxbrkrn = 0;
+	rgxbrkrn[cxbrkrn].szName = "scalar";
+	rgxbrkrn[cxbrkrn].pfnGather16 = XbrGatherScalar16;
+	rgxbrkrn[cxbrkrn].pfnGather32 = XbrGatherScalar32;
+	cxbrkrn++;
+
+#if defined(XBRMAP_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		rgxbrkrn[cxbrkrn].szName = "avx2";
+		rgxbrkrn[cxbrkrn].pfnGather16 = XbrGatherAvx2_16;
+		rgxbrkrn[cxbrkrn].pfnGather32 = XbrGatherAvx2_32;
+		cxbrkrn++;
+	}
+#endif
+
+	xbrkrnCur = rgxbrkrn[cxbrkrn - 1];
+}
+
+/* ------------------------------------------------------------ */
+/*					Scalar Kernels								*/
+/* ------------------------------------------------------------ */
+
+static void XbrGatherScalar16(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue) {
+
+	const WORD *	rgw = (const WORD *) rgEntry;
+	DWORD			ibit;
+	DWORD			w;
+	DWORD			b;
+
+	b = 0;
+	for (ibit = 0; ibit < cbit; ibit++) {
+		w = rgw[ibit];
+		if (w >= wXbrMarker) {
+			b |= rgdwValue[w & 0xFF] << (ibit % 8);
+		}
+		else {
+			b |= ((rgbFuse[w / 8] >> (w % 8)) & 1) << (ibit % 8);
+		}
+		if ((ibit % 8) == 7) {
+			rgbRow[ibit / 8] = (BYTE) b;
+			b = 0;
+		}
+	}
+	if ((cbit % 8) != 0) {
+		rgbRow[cbit / 8] = (BYTE) b;
+	}
+}
+
+/* ------------------------------------------------------------ */
+
+static void XbrGatherScalar32(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue) {
+
+	const DWORD *	rgdw = (const DWORD *) rgEntry;
+	DWORD			ibit;
+	DWORD			dw;
+	DWORD			b;
+
+	b = 0;
+	for (ibit = 0; ibit < cbit; ibit++) {
+		dw = rgdw[ibit];
+		if (dw >= dwXbrMarker) {
+			b |= rgdwValue[dw & 0xFF] << (ibit % 8);
+		}
+		else {
+			b |= ((rgbFuse[dw / 8] >> (dw % 8)) & 1) << (ibit % 8);
+		}
+		if ((ibit % 8) == 7) {
+			rgbRow[ibit / 8] = (BYTE) b;
+			b = 0;
+		}
+	}
+	if ((cbit % 8) != 0) {
+		rgbRow[cbit / 8] = (BYTE) b;
+	}
+}
+
+#if defined(XBRMAP_X86)
+
+/* ------------------------------------------------------------ */
+/*					AVX2 Kernels								*/
+/* ------------------------------------------------------------ */
+
+/* Eight bits of a row from eight entries widened to 32 bits. The high
+** 24 bits of a marker are ymmMarkerHi: 0x00FFFFFF for 32-bit entries
+** and 0x000000FF for 16-bit ones.
+*/
+__attribute__ ((target("avx2")))
+static inline BYTE BXbrGatherAvx2(__m256i ymmEntry, __m256i ymmMarkerHi, const BYTE * rgbFuse,
+	const DWORD * rgdwValue) {
+
+	__m256i		ymmMarker;
+	__m256i		ymmBit;
+
+	ymmMarker = _mm256_cmpeq_epi32(_mm256_srli_epi32(ymmEntry, 8), ymmMarkerHi);
+	ymmBit = _mm256_i32gather_epi32((const int *) rgbFuse,
+		_mm256_andnot_si256(ymmMarker, _mm256_srli_epi32(ymmEntry, 5)), 4);
+	ymmBit = _mm256_srlv_epi32(ymmBit, _mm256_and_si256(ymmEntry, _mm256_set1_epi32(31)));
+
+	if (!_mm256_testz_si256(ymmMarker, ymmMarker)) {
+		ymmBit = _mm256_mask_i32gather_epi32(ymmBit, (const int *) rgdwValue,
+			_mm256_and_si256(ymmEntry, _mm256_set1_epi32(0xFF)), ymmMarker, 4);
+	}
+
+	return (BYTE) _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(ymmBit, 31)));
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static void XbrGatherAvx2_16(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue) {
+
+	const WORD *	rgw = (const WORD *) rgEntry;
+	const __m256i	ymmMarkerHi = _mm256_set1_epi32(0x000000FF);
+	DWORD			ibit;
+
+	for (ibit = 0; ibit + 8 <= cbit; ibit += 8) {
+		rgbRow[ibit / 8] = BXbrGatherAvx2(
+			_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (rgw + ibit))),
+			ymmMarkerHi, rgbFuse, rgdwValue);
+	}
+	XbrGatherScalar16(rgbRow + ibit / 8, rgw + ibit, cbit - ibit, rgbFuse, rgdwValue);
+}
+
+/* ------------------------------------------------------------ */
+
+__attribute__ ((target("avx2")))
+static void XbrGatherAvx2_32(BYTE * rgbRow, const void * rgEntry, DWORD cbit, const BYTE * rgbFuse, const DWORD * rgdwValue) {
+
+	const DWORD *	rgdw = (const DWORD *) rgEntry;
+	const __m256i	ymmMarkerHi = _mm256_set1_epi32(0x00FFFFFF);
+	DWORD			ibit;
+
+	for (ibit = 0; ibit + 8 <= cbit; ibit += 8) {
+		rgbRow[ibit / 8] = BXbrGatherAvx2(_mm256_loadu_si256((const __m256i *) (rgdw + ibit)),
+			ymmMarkerHi, rgbFuse, rgdwValue);
+	}
+	XbrGatherScalar32(rgbRow + ibit / 8, rgdw + ibit, cbit - ibit, rgbFuse, rgdwValue);
+}
+
+#endif
+
+/************************************************************************/
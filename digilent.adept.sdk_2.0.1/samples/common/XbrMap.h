@@ -0,0 +1,190 @@
+/************************************************************************/
+/*																		*/
+/*  XbrMap.h  --  CoolRunner-II Fuse Map Declarations					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		An XbrMap turns the fuses of a CoolRunner-II JEDEC file into	*/
+/*		the rows shifted into the device when it is programmed, using	*/
+/*		the fuse map of the device from the xbr directory of the		*/
+/*		Adept Runtime data, such as xc2c256.map.						*/
+/*																		*/
+/*		A map is a tab separated text grid. Each column is a row of		*/
+/*		the device, in the order of the columns, and line i of the		*/
+/*		map is bit i of each row. A cell holds the JEDEC				*/
+/*		fuse number of the bit, or a marker for a bit that is not a		*/
+/*		fuse: spare, sec_N for a security bit, done_N or done<N> for	*/
+/*		a DONE bit and user_N or "user N" for a bit of the user code.	*/
+/*		An empty cell, or the user column label, is a bit with no		*/
+/*		fuse.															*/
+/*																		*/
+/*		FInit compiles the map into a binary table and writes it next	*/
+/*		to the map, as xc2c256.xbm. The table holds the cells row by	*/
+/*		row, as 16-bit entries if every fuse number fits and as 32-bit	*/
+/*		entries otherwise, and records the size and modification time	*/
+/*		of the map it was compiled from; while they match, later calls	*/
+/*		to FInit map the table with mmap instead of parsing the map		*/
+/*		again. If the table cannot be written, the compiled table is	*/
+/*		kept in memory.													*/
+/*																		*/
+/*		FGatherRows makes rows from a JEDEC fuse vector, fuse n in bit	*/
+/*		n % 8 of byte n / 8, with the bits of the markers given by an	*/
+/*		XBRFILL. The AVX2 kernel gathers the fuses of eight bits of a	*/
+/*		row at a time; a portable kernel is used on other processors.	*/
+/*		The vector is read a DWORD at a time, so it must be				*/
+/*		CbXbrFuse(cfuse) bytes long.									*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(XBRMAP_INCLUDED)
+#define      XBRMAP_INCLUDED
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Options of FInit.
+*/
+const DWORD		fxbrRebuild		= 0x0001;	// compile the map even if the table is current
+const DWORD		fxbrNoWrite		= 0x0002;	// do not write the table file
+
+const DWORD		cchXbrPathMax	= 1024;
+
+/* Table file identification.
+*/
+const DWORD		dwXbrMagic		= 0x4D524258;	// "XBRM"
+const DWORD		verXbrTable		= 1;
+
+/* An entry is a fuse number or a marker. A marker has all bits set
+** but the low 8, which hold its kind in bits 5-7 and its number in
+** bits 0-4. 16-bit entries are widened to 32 bits by setting the
+** high 16 bits of markers.
+*/
+const DWORD		xbrkNone		= 0;		// no fuse
+const DWORD		xbrkSpare		= 1;
+const DWORD		xbrkSec			= 2;
+const DWORD		xbrkDone		= 3;
+const DWORD		xbrkUser		= 4;
+
+const DWORD		dwXbrMarker		= 0xFFFFFF00;
+const WORD		wXbrMarker		= 0xFF00;
+const DWORD		cxbrMarkerNum	= 32;
+
+#define	DwXbrMarker(xbrk, n)	(dwXbrMarker | ((xbrk) << 5) | (n))
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* Header of the table file. The entries of row i start at entry
+** i * cbitRow.
+*/
+typedef struct tagXBRHDR {
+	DWORD		dwMagic;
+	DWORD		ver;
+	DWORD		cbFile;
+	DWORD		cbMap;				// size of the map compiled
+	long long	tsMap;				// modification time of the map, s
+	long long	tnsMap;				// and ns
+	DWORD		cbitRow;			// lines of the map
+	DWORD		crow;				// columns of the map
+	DWORD		cfuse;				// highest fuse number + 1
+	DWORD		cbEntry;			// 2 or 4
+	DWORD		ibEntry;
+	DWORD		cmarker;			// entries that are markers
+} XBRHDR;
+
+/* Values of the bits that are not fuses. Bit n of dwSec, dwDone and
+** dwUser is the value of sec_n, done_n and user_n.
+*/
+typedef struct tagXBRFILL {
+	BOOL		fNone;
+	BOOL		fSpare;
+	DWORD		dwSec;
+	DWORD		dwDone;
+	DWORD		dwUser;
+} XBRFILL;
+
+/* A row kernel: makes cbit bits of a row from its entries. rgdwValue
+** holds the value, 0 or 1, of each marker by its low 8 bits.
+*/
+typedef void	(* PFNXBRGATHER)(BYTE * rgbRow, const void * rgEntry, DWORD cbit,
+					const BYTE * rgbFuse, const DWORD * rgdwValue);
+
+typedef struct tagXBRKRN {
+	const char *	szName;
+	PFNXBRGATHER	pfnGather16;
+	PFNXBRGATHER	pfnGather32;
+} XBRKRN;
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+
+class XbrMap {
+
+private:
+	BYTE *			pbTable;
+	size_t			cbTable;
+	BOOL			fMapped;			// pbTable is mapped, not allocated
+	BOOL			fCompiled;
+	BOOL			fWritten;
+	DWORD			ilineErr;			// line of the cell FInit could not read
+	char			szTable[cchXbrPathMax];
+
+	const XBRHDR *	phdr;
+	const BYTE *	pbEntry;
+
+	BOOL	FMap(const char * szTableFile, const struct stat * pstMap);
+	BOOL	FAttach(BYTE * pb, size_t cb);
+
+public:
+	XbrMap();
+
+	BOOL	FInit(const char * szMap, DWORD fxbr);
+	void	Free();
+	BOOL	FGatherRows(DWORD irowFirst, DWORD crowGather, const BYTE * rgbFuse, DWORD cfuse,
+				const XBRFILL * pfill, BYTE * rgbRows, const XBRKRN * pkrn = NULL);
+	DWORD	DwEntry(DWORD irow, DWORD ibit);
+
+	DWORD	CbitRow()			{ return (phdr != NULL) ? phdr->cbitRow : 0; }
+	DWORD	CbRow()				{ return (CbitRow() + 7) / 8; }
+	DWORD	Crow()				{ return (phdr != NULL) ? phdr->crow : 0; }
+	DWORD	Cfuse()				{ return (phdr != NULL) ? phdr->cfuse : 0; }
+	DWORD	CbEntry()			{ return (phdr != NULL) ? phdr->cbEntry : 0; }
+	DWORD	Cmarker()			{ return (phdr != NULL) ? phdr->cmarker : 0; }
+	size_t	CbTable()			{ return cbTable; }
+	BOOL	FCompiled()			{ return fCompiled; }
+	BOOL	FWritten()			{ return fWritten; }
+	DWORD	IlineErr()			{ return ilineErr; }
+	const char *	SzTable()	{ return szTable; }
+};
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FXbrCompile(const char * szMap, BYTE ** ppbTable, size_t * pcbTable, DWORD * pilineErr);
+DWORD	CbXbrFuse(DWORD cfuse);
+void	XbrFillErased(XBRFILL * pfill);
+const char *	XbrSzKernel();
+BOOL	FXbrGetKernel(DWORD ikrn, XBRKRN * pkrn);
+
+/* ------------------------------------------------------------ */
+
+#endif					// XBRMAP_INCLUDED
+
+/************************************************************************/
@@ -0,0 +1,626 @@
+/************************************************************************/
+/*																		*/
+/*  DeppBatchBench.cpp  --  DEPP Register Batching Benchmark			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		DeppBatchBench measures the rate of single register accesses	*/
+/*		to the DpimRef design made with one DeppPutReg or DeppGetReg	*/
+/*		call per access, with the same accesses combined by a			*/
+/*		DeppBatch object, and with reads served by the shadow			*/
+/*		register cache. Each workload is run for a fixed time in		*/
+/*		each mode and the register values are checked afterwards.		*/
+/*																		*/
+/*		Workloads:														*/
+/*			ctl	- control loop: write registers 0-7 and the LEDs,		*/
+/*				  then read the switches and buttons					*/
+/*			wr	- write registers 0-7 continuously; the batch is		*/
+/*				  issued only when it is full							*/
+/*			rmw	- read, increment and write back register 0; every		*/
+/*				  access is a hazard, so batching cannot help			*/
+/*			rdbk	- write a data register, read it back and read		*/
+/*				  the switches; half the reads are of values the		*/
+/*				  host wrote											*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: added shadow register cache mode and rdbk workload		*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "dmgr.h"
+#include "DeppBatch.h"
+#include "DeppShadow.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Registers of the DpimRef design.
+*/
+const BYTE	cregData	= 8;		// registers 0-7 are read/write
+const BYTE	regSwt		= 8;
+const BYTE	regBtn		= 9;
+const BYTE	regLed		= 10;
+const BYTE	bAddrMaskRef = 0x0F;	// the design decodes 4 address bits
+
+/* Iterations between checks of the elapsed time.
+*/
+const DWORD	citerCheck	= 64;
+
+typedef enum {
+	wklCtl = 0,
+	wklWr,
+	wklRmw,
+	wklRdbk,
+	wklMax
+} WKL;
+
+typedef enum {
+	modeDirect = 0,
+	modeBatch,
+	modeShadow,
+	modeMax
+} MODE;
+
+/* Result of one workload run.
+*/
+typedef struct tagBENCHRES {
+	DWORD	citer;
+	DWORD	creg;			// register accesses made
+	DWORD	ctrans;			// DEPP calls made
+	double	dblSec;
+} BENCHRES;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+char		szDvc[cchDvcNameMax];
+double		dblRunSec = 1.0;
+DWORD		cregLimit = cregBatchMax;
+
+HIF			hif = hifInvalid;
+DeppBatch	dbat;
+
+const char *	rgszWkl[wklMax] = { "ctl", "wr", "rmw", "rdbk" };
+const char *	rgszMode[modeMax] = { "direct", "batch", "shadow" };
+
+/* Values last written to registers 0-7, used to check each run.
+*/
+BYTE		rgbExpect[cregData];
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+void	RunWorkload(WKL wkl, MODE mode, BENCHRES * pres);
+BOOL	FPut(MODE mode, BYTE bAddr, BYTE bData);
+BOOL	FGet(MODE mode, BYTE bAddr, BYTE * pbData);
+DWORD	CtransShadow();
+void	CheckRegs(WKL wkl, MODE mode);
+double	DblTimeSec();
+void	ErrorExit();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		DeppBatchBench main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	BENCHRES	res;
+	double		dblDirect;
+	double		dblIter;
+	int			wkl;
+	int			mode;
+	SHSTATS		shstats;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	// DMGR API Call: DmgrOpen
+	if (!DmgrOpen(&hif, szDvc)) {
+		printf("DmgrOpen failed (check the device name you provided)\n");
+		return 1;
+	}
+
+	// DEPP API Call: DeppEnable
+	if (!DeppEnable(hif)) {
+		printf("DeppEnable failed\n");
+		ErrorExit();
+	}
+
+	if (!dbat.FInit(hif, cregLimit, bAddrMaskRef)) {
+		printf("Invalid batch size %lu\n", (unsigned long) cregLimit);
+		ErrorExit();
+	}
+
+	if (!DeppShadowSetDpimRef(hif)) {
+		printf("Cannot enable the shadow register cache\n");
+		ErrorExit();
+	}
+
+	printf("%-4s %-7s %12s %12s %12s %10s %8s\n",
+		"wkl", "mode", "iter/s", "reg ops/s", "calls/s", "calls/iter", "speedup");
+
+	for (wkl = 0; wkl < wklMax; wkl++) {
+		dblDirect = 0;
+		for (mode = 0; mode < modeMax; mode++) {
+			RunWorkload((WKL) wkl, (MODE) mode, &res);
+
+			dblIter = res.citer / res.dblSec;
+			if (mode == modeDirect) {
+				dblDirect = dblIter;
+			}
+
+			printf("%-4s %-7s %12.0f %12.0f %12.0f %10.3f %7.2fx\n",
+				rgszWkl[wkl], rgszMode[mode], dblIter, res.creg / res.dblSec,
+				res.ctrans / res.dblSec, (double) res.ctrans / res.citer,
+				dblIter / dblDirect);
+		}
+	}
+
+	DeppShadowGetStats(hif, &shstats);
+
+	printf("\nbatch flushes: %lu fence, %lu hazard, %lu full\n",
+		(unsigned long) dbat.CflushFence(), (unsigned long) dbat.CflushHazard(),
+		(unsigned long) dbat.CflushFull());
+	printf("shadow reads: %lu hit, %lu miss, %lu bypass\n",
+		(unsigned long) shstats.chit, (unsigned long) shstats.cmiss,
+		(unsigned long) shstats.cbypass);
+
+	DeppShadowDisable(hif);
+
+	// DEPP API Call: DeppDisable
+	DeppDisable(hif);
+
+	// DMGR API Call: DmgrClose
+	DmgrClose(hif);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	RunWorkload
+**
+**	Parameters:
+**		wkl			- workload to run
+**		mode		- how the register accesses are made
+**		pres		- variable to receive the result
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if a DEPP call fails or a register has the wrong value.
+**
+**	Description:
+**		Runs a workload for dblRunSec seconds.
+*/
+
+void RunWorkload(WKL wkl, MODE mode, BENCHRES * pres) {
+
+	BYTE	bSwt;
+	BYTE	bBtn;
+	BYTE	bVal;
+	BYTE	bRdbk;
+	BYTE	ireg;
+	DWORD	iiter;
+	DWORD	ctransStart;
+	double	dblStart;
+	double	dblNow;
+	BOOL	fOk = fTrue;
+
+	memset(pres, 0, sizeof(BENCHRES));
+
+	/* Start from a known value for the read-modify-write workload.
+	*/
+	bVal = 0;
+	if (!FPut(modeDirect, 0, bVal)) {
+		ErrorExit();
+	}
+
+	/* Direct writes made since the last shadow run are not in the
+	** cache.
+	*/
+	DeppShadowInvalidate(hif);
+
+	ctransStart = (mode == modeBatch) ? dbat.CtransIssued() : CtransShadow();
+	dblStart = DblTimeSec();
+
+	iiter = 0;
+	do {
+		switch (wkl) {
+
+			case wklCtl:
+				for (ireg = 0; ireg < cregData; ireg++) {
+					rgbExpect[ireg] = (BYTE) (iiter + ireg);
+					fOk = fOk && FPut(mode, ireg, rgbExpect[ireg]);
+				}
+				fOk = fOk && FPut(mode, regLed, (BYTE) iiter);
+				fOk = fOk && FGet(mode, regSwt, &bSwt);
+				fOk = fOk && FGet(mode, regBtn, &bBtn);
+				if (mode == modeBatch) {
+					fOk = fOk && dbat.FFence();
+				}
+				pres->creg += cregData + 3;
+				break;
+
+			case wklWr:
+				for (ireg = 0; ireg < cregData; ireg++) {
+					rgbExpect[ireg] = (BYTE) (iiter ^ ireg);
+					fOk = fOk && FPut(mode, ireg, rgbExpect[ireg]);
+				}
+				pres->creg += cregData;
+				break;
+
+			case wklRmw:
+				fOk = fOk && FGet(mode, 0, &bVal);
+				if (mode == modeBatch) {
+					fOk = fOk && dbat.FFence();
+				}
+				bVal++;
+				fOk = fOk && FPut(mode, 0, bVal);
+				pres->creg += 2;
+				break;
+
+			case wklRdbk:
+				ireg = (BYTE) (iiter % cregData);
+				rgbExpect[ireg] = (BYTE) (iiter >> 3);
+				fOk = fOk && FPut(mode, ireg, rgbExpect[ireg]);
+				fOk = fOk && FGet(mode, ireg, &bRdbk);
+				fOk = fOk && FGet(mode, regSwt, &bSwt);
+				if (mode == modeBatch) {
+					fOk = fOk && dbat.FFence();
+				}
+				if (fOk && (bRdbk != rgbExpect[ireg])) {
+					printf("Error: rdbk %s: register %d read back %d, expected %d\n",
+						rgszMode[mode], ireg, bRdbk, rgbExpect[ireg]);
+					ErrorExit();
+				}
+				pres->creg += 3;
+				break;
+
+			default:
+				break;
+		}
+
+		if (!fOk) {
+			printf("Error: register access failed\n");
+			ErrorExit();
+		}
+
+		iiter++;
+		dblNow = (iiter % citerCheck == 0) ? DblTimeSec() : dblStart;
+
+	} while (dblNow - dblStart < dblRunSec);
+
+	if ((mode == modeBatch) && !dbat.FFence()) {
+		printf("Error: register access failed\n");
+		ErrorExit();
+	}
+
+	pres->dblSec = DblTimeSec() - dblStart;
+	pres->citer = iiter;
+
+	if (mode == modeBatch) {
+		pres->ctrans = dbat.CtransIssued() - ctransStart;
+	}
+	else if (mode == modeShadow) {
+		pres->ctrans = CtransShadow() - ctransStart;
+	}
+	else {
+		pres->ctrans = pres->creg;
+	}
+
+	if (wkl == wklRmw) {
+		if (!FGet(modeDirect, 0, &bVal) || (bVal != (BYTE) iiter)) {
+			printf("Error: %s %s: register 0 is %d, expected %d\n", rgszWkl[wkl],
+				rgszMode[mode], bVal, (BYTE) iiter);
+			ErrorExit();
+		}
+	}
+	else {
+		CheckRegs(wkl, mode);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FPut
+**
+**	Parameters:
+**		mode		- how the register is written
+**		bAddr		- register address
+**		bData		- value to write
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes a register directly, through the batch or through the
+**		shadow register cache.
+*/
+
+BOOL FPut(MODE mode, BYTE bAddr, BYTE bData) {
+
+	if (mode == modeBatch) {
+		return dbat.FPutReg(bAddr, bData);
+	}
+
+	if (mode == modeShadow) {
+		return DeppShadowPutReg(hif, bAddr, bData, fFalse);
+	}
+
+	// DEPP API Call: DeppPutReg
+	return DeppPutReg(hif, bAddr, bData, fFalse);
+}
+
+/* ------------------------------------------------------------ */
+/***	FGet
+**
+**	Parameters:
+**		mode		- how the register is read
+**		bAddr		- register address
+**		pbData		- variable to receive the register value
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads a register directly, through the batch or through the
+**		shadow register cache.
+*/
+
+BOOL FGet(MODE mode, BYTE bAddr, BYTE * pbData) {
+
+	if (mode == modeBatch) {
+		return dbat.FGetReg(bAddr, pbData);
+	}
+
+	if (mode == modeShadow) {
+		return DeppShadowGetReg(hif, bAddr, pbData, fFalse);
+	}
+
+	// DEPP API Call: DeppGetReg
+	return DeppGetReg(hif, bAddr, pbData, fFalse);
+}
+
+/* ------------------------------------------------------------ */
+/***	CtransShadow
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		number of DEPP calls made by the shadow register cache
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Every write and every read that is not a hit is one DEPP call.
+*/
+
+DWORD CtransShadow() {
+
+	SHSTATS	shstats;
+
+	if (!DeppShadowGetStats(hif, &shstats)) {
+		return 0;
+	}
+
+	return shstats.cput + shstats.cmiss + shstats.cbypass;
+}
+
+/* ------------------------------------------------------------ */
+/***	CheckRegs
+**
+**	Parameters:
+**		wkl			- workload that was run
+**		mode		- how the workload made its accesses
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if a register does not hold the value last written.
+**
+**	Description:
+**		Reads back data registers 0-7.
+*/
+
+void CheckRegs(WKL wkl, MODE mode) {
+
+	BYTE	rgbAddr[cregData];
+	BYTE	rgbData[cregData];
+	BYTE	ireg;
+
+	for (ireg = 0; ireg < cregData; ireg++) {
+		rgbAddr[ireg] = ireg;
+	}
+
+	// DEPP API Call: DeppGetRegSet
+	if (!DeppGetRegSet(hif, rgbAddr, rgbData, cregData, fFalse)) {
+		printf("Error: DeppGetRegSet failed\n");
+		ErrorExit();
+	}
+
+	for (ireg = 0; ireg < cregData; ireg++) {
+		if (rgbData[ireg] != rgbExpect[ireg]) {
+			printf("Error: %s %s: register %d is %d, expected %d\n", rgszWkl[wkl],
+				rgszMode[mode], ireg, rgbData[ireg], rgbExpect[ireg]);
+			ErrorExit();
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the arguments are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	BOOL	fDvc = fFalse;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-t") == 0) && (iszArg + 1 < cszArg)) {
+			dblRunSec = atof(rgszArg[++iszArg]);
+			if (dblRunSec <= 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-c") == 0) && (iszArg + 1 < cszArg)) {
+			cregLimit = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cregLimit == 0) || (cregLimit > cregBatchMax)) {
+				return fFalse;
+			}
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return fDvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper paramater usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s -d <device name> [-t <seconds>] [-c <batch size>]\n\n", szProgName);
+	printf("\t-d <device name>\tDevice with the DpimRef design loaded\n");
+	printf("\t-t <seconds>\t\tTime to run each workload (default 1)\n");
+	printf("\t-c <batch size>\t\tPuts or gets per batch, 1 to %lu (default %lu)\n\n",
+		(unsigned long) cregBatchMax, (unsigned long) cregBatchMax);
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the workloads.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ErrorExit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DEPP, closes the device and exits the program
+*/
+
+void ErrorExit() {
+
+	if (hif != hifInvalid) {
+		// DEPP API Call: DeppDisable
+		DeppDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	exit(1);
+}
+
+/************************************************************************/
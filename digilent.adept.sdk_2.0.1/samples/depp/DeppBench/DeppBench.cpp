@@ -0,0 +1,865 @@
+/************************************************************************/
+/*																		*/
+/*  DeppBench.cpp  --  DEPP Latency and Throughput Benchmark			*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		DeppBench measures the time taken by each DEPP register call	*/
+/*		(DeppGetReg/PutReg, DeppGetRegSet/PutRegSet and					*/
+/*		DeppGetRegRepeat/PutRegRepeat) over a sweep of payload sizes,	*/
+/*		in synchronous and overlapped mode. For each point it reports	*/
+/*		the 50th, 99th and 99.9th percentile latency and the			*/
+/*		throughput, on the console and optionally as a CSV or JSON		*/
+/*		file that records the runtime versions so that results can be	*/
+/*		compared between Adept Runtime releases.						*/
+/*																		*/
+/*		The latency of an overlapped call is measured from the call		*/
+/*		until DmgrGetTransResult returns.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#if !defined(WIN32)
+
+	/* Include Unix specific headers here.
+	*/
+	#if !defined(_GNU_SOURCE)
+		#define _GNU_SOURCE
+	#endif
+	#include <dlfcn.h>
+	#include <limits.h>
+	#include <time.h>
+
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "dmgr.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+const int		cchSzLen		= 1024;
+
+/* Default sweep, time spent on each point, and limits on the number
+** of calls measured at each point.
+*/
+const DWORD		cbSweepMinDef	= 1;
+const DWORD		cbSweepMaxDef	= 16 * 1024 * 1024;
+const double	dblPointSecDef	= 0.25;
+const DWORD		csmpMin			= 5;
+const DWORD		csmpMax			= 200000;
+
+/* The Set calls address registers 0-7 of the DpimRef design in turn.
+*/
+const BYTE		cregSet			= 8;
+
+typedef enum {
+	opGetReg = 0,
+	opPutReg,
+	opGetRegSet,
+	opPutRegSet,
+	opGetRegRepeat,
+	opPutRegRepeat,
+	opMax
+} OP;
+
+typedef enum {
+	fmtNone = 0,
+	fmtCsv,
+	fmtJson
+} FMT;
+
+/* Result of one point of the sweep.
+*/
+typedef struct tagBENCHPT {
+	OP		op;
+	BOOL	fOverlap;
+	DWORD	cb;
+	DWORD	csmp;
+	double	dblP50;					// latencies in seconds
+	double	dblP99;
+	double	dblP999;
+	double	dblMean;
+	double	dblMin;
+	double	dblMax;
+	double	dblMBps;
+} BENCHPT;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+const char *	rgszOp[opMax] = {
+	"getreg", "putreg", "getregset", "putregset", "getregrepeat", "putregrepeat"
+};
+
+char		szDvc[cchSzLen];
+char		szFile[cchSzLen];
+char		szDmgrVersion[cchVersionMax];
+char		szDeppVersion[cchVersionMax];
+char		szDeppLib[cchSzLen];
+
+BOOL		rgfOp[opMax];
+BOOL		fSync = fTrue;
+BOOL		fOvl = fTrue;
+BYTE		bReg = 0;
+DWORD		cbSweepMin = cbSweepMinDef;
+DWORD		cbSweepMax = cbSweepMaxDef;
+double		dblPointSec = dblPointSecDef;
+FMT			fmt = fmtNone;
+
+HIF			hif = hifInvalid;
+FILE *		fhout = NULL;
+
+BYTE *		rgbBuf = NULL;			// data for Repeat, data and pairs for Set
+BYTE *		rgbAddr = NULL;			// addresses for GetRegSet
+double *	rgdblSmp = NULL;			// latency samples of the current point
+
+int			cptOut = 0;				// points written to the output file
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+BOOL	FParseOps(char * szOps);
+void	ShowUsage(char * szProgName);
+void	GetRuntimeInfo();
+void	RunPoint(OP op, BOOL fOverlap, DWORD cb, BENCHPT * ppt);
+BOOL	FCall(OP op, BOOL fOverlap, DWORD cb);
+void	PrintPoint(const BENCHPT * ppt);
+void	BeginOutput();
+void	WritePoint(const BENCHPT * ppt);
+void	EndOutput();
+int		CmpDbl(const void * pv1, const void * pv2);
+double	DblPercentile(const double * rgdbl, DWORD cdbl, double dblPct);
+double	DblTimeSec();
+void	ErrorExit();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		DeppBench main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	BENCHPT	pt;
+	DWORD	cb;
+	int		op;
+	int		imode;
+	BOOL	fOverlap;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	// DMGR API Call: DmgrOpen
+	if (!DmgrOpen(&hif, szDvc)) {
+		printf("DmgrOpen failed (check the device name you provided)\n");
+		return 1;
+	}
+
+	// DEPP API Call: DeppEnable
+	if (!DeppEnable(hif)) {
+		printf("DeppEnable failed\n");
+		ErrorExit();
+	}
+
+	/* The Set calls use two bytes per register for PutRegSet, and
+	** GetRegSet needs a separate address buffer.
+	*/
+	rgbBuf = (BYTE *) malloc(2 * (size_t) cbSweepMax);
+	rgbAddr = (BYTE *) malloc(cbSweepMax);
+	rgdblSmp = (double *) malloc(csmpMax * sizeof(double));
+	if ((rgbBuf == NULL) || (rgbAddr == NULL) || (rgdblSmp == NULL)) {
+		printf("Cannot allocate buffers for %lu bytes\n", (unsigned long) cbSweepMax);
+		ErrorExit();
+	}
+
+	for (cb = 0; cb < cbSweepMax; cb++) {
+		rgbAddr[cb] = (BYTE) (cb % cregSet);
+		rgbBuf[2*cb] = (BYTE) (cb % cregSet);
+		rgbBuf[2*cb+1] = (BYTE) cb;
+	}
+
+	GetRuntimeInfo();
+	BeginOutput();
+
+	printf("dmgr %s, depp %s (%s), device %s\n\n", szDmgrVersion, szDeppVersion, szDeppLib, szDvc);
+	printf("%-13s %-4s %9s %7s %11s %11s %11s %10s\n",
+		"op", "mode", "bytes", "calls", "p50 us", "p99 us", "p99.9 us", "MB/s");
+
+	for (op = 0; op < opMax; op++) {
+		if (!rgfOp[op]) {
+			continue;
+		}
+
+		for (imode = 0; imode < 2; imode++) {
+			fOverlap = (imode == 1);
+			if ((fOverlap && !fOvl) || (!fOverlap && !fSync)) {
+				continue;
+			}
+
+			/* The single register calls always move one byte.
+			*/
+			for (cb = cbSweepMin; cb <= cbSweepMax; cb *= 2) {
+				RunPoint((OP) op, fOverlap, cb, &pt);
+				PrintPoint(&pt);
+				WritePoint(&pt);
+
+				if ((op == opGetReg) || (op == opPutReg) || (cb > cbSweepMax / 2)) {
+					break;
+				}
+			}
+		}
+	}
+
+	EndOutput();
+
+	free(rgdblSmp);
+	free(rgbAddr);
+	free(rgbBuf);
+
+	// DEPP API Call: DeppDisable
+	DeppDisable(hif);
+
+	// DMGR API Call: DmgrClose
+	DmgrClose(hif);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	RunPoint
+**
+**	Parameters:
+**		op			- call to measure
+**		fOverlap	- fTrue to make overlapped calls
+**		cb			- payload size in bytes (registers for the Set calls)
+**		ppt			- variable to receive the result
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if a call fails.
+**
+**	Description:
+**		Calls the function repeatedly for dblPointSec seconds, but at
+**		least csmpMin and at most csmpMax times, and computes the
+**		latency percentiles and throughput.
+*/
+
+void RunPoint(OP op, BOOL fOverlap, DWORD cb, BENCHPT * ppt) {
+
+	DWORD	csmp;
+	DWORD	ismp;
+	double	dblStart;
+	double	dblCall;
+	double	dblEnd;
+	double	dblSum;
+
+	if ((op == opGetReg) || (op == opPutReg)) {
+		cb = 1;
+	}
+
+	/* One untimed call so that first use costs are not measured.
+	*/
+	if (!FCall(op, fOverlap, cb)) {
+		printf("Error: %s failed\n", rgszOp[op]);
+		ErrorExit();
+	}
+
+	csmp = 0;
+	dblStart = DblTimeSec();
+	dblEnd = dblStart;
+
+	while ((csmp < csmpMin) || ((dblEnd - dblStart < dblPointSec) && (csmp < csmpMax))) {
+		dblCall = DblTimeSec();
+		if (!FCall(op, fOverlap, cb)) {
+			printf("Error: %s failed\n", rgszOp[op]);
+			ErrorExit();
+		}
+		dblEnd = DblTimeSec();
+		rgdblSmp[csmp++] = dblEnd - dblCall;
+	}
+
+	qsort(rgdblSmp, csmp, sizeof(double), CmpDbl);
+
+	dblSum = 0;
+	for (ismp = 0; ismp < csmp; ismp++) {
+		dblSum += rgdblSmp[ismp];
+	}
+
+	memset(ppt, 0, sizeof(BENCHPT));
+	ppt->op = op;
+	ppt->fOverlap = fOverlap;
+	ppt->cb = cb;
+	ppt->csmp = csmp;
+	ppt->dblP50 = DblPercentile(rgdblSmp, csmp, 50.0);
+	ppt->dblP99 = DblPercentile(rgdblSmp, csmp, 99.0);
+	ppt->dblP999 = DblPercentile(rgdblSmp, csmp, 99.9);
+	ppt->dblMean = dblSum / csmp;
+	ppt->dblMin = rgdblSmp[0];
+	ppt->dblMax = rgdblSmp[csmp - 1];
+	ppt->dblMBps = (ppt->dblMean > 0) ? cb / ppt->dblMean / 1e6 : 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	FCall
+**
+**	Parameters:
+**		op			- call to make
+**		fOverlap	- fTrue to make an overlapped call
+**		cb			- payload size in bytes
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes one call. An overlapped call is waited for with
+**		DmgrGetTransResult before returning.
+*/
+
+BOOL FCall(OP op, BOOL fOverlap, DWORD cb) {
+
+	BOOL	fOk;
+
+	switch (op) {
+		case opGetReg:
+			// DEPP API Call: DeppGetReg
+			fOk = DeppGetReg(hif, bReg, rgbBuf, fOverlap);
+			break;
+
+		case opPutReg:
+			// DEPP API Call: DeppPutReg
+			fOk = DeppPutReg(hif, bReg, rgbBuf[1], fOverlap);
+			break;
+
+		case opGetRegSet:
+			// DEPP API Call: DeppGetRegSet
+			fOk = DeppGetRegSet(hif, rgbAddr, rgbBuf, cb, fOverlap);
+			break;
+
+		case opPutRegSet:
+			// DEPP API Call: DeppPutRegSet
+			fOk = DeppPutRegSet(hif, rgbBuf, cb, fOverlap);
+			break;
+
+		case opGetRegRepeat:
+			// DEPP API Call: DeppGetRegRepeat
+			fOk = DeppGetRegRepeat(hif, bReg, rgbBuf, cb, fOverlap);
+			break;
+
+		case opPutRegRepeat:
+			// DEPP API Call: DeppPutRegRepeat
+			fOk = DeppPutRegRepeat(hif, bReg, rgbBuf, cb, fOverlap);
+			break;
+
+		default:
+			fOk = fFalse;
+			break;
+	}
+
+	if (fOk && fOverlap) {
+		// DMGR API Call: DmgrGetTransResult
+		fOk = DmgrGetTransResult(hif, NULL, NULL, tmsWaitInfinite);
+	}
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	GetRuntimeInfo
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the versions of the DMGR and DEPP libraries, and the
+**		file the DEPP library was loaded from with symbolic links
+**		resolved (for example libdepp.so.2.7.1), so that results from
+**		different runtime releases can be told apart.
+*/
+
+void GetRuntimeInfo() {
+
+	strcpy(szDmgrVersion, "unknown");
+	strcpy(szDeppVersion, "unknown");
+	strcpy(szDeppLib, "unknown");
+
+	// DMGR API Call: DmgrGetVersion
+	DmgrGetVersion(szDmgrVersion);
+
+	// DEPP API Call: DeppGetVersion
+	DeppGetVersion(szDeppVersion);
+
+#if !defined(WIN32)
+	{
+		Dl_info	dli;
+		char	szPath[PATH_MAX];
+
+		if ((dladdr((void *) DeppGetVersion, &dli) != 0) && (dli.dli_fname != NULL)) {
+			if (realpath(dli.dli_fname, szPath) != NULL) {
+				snprintf(szDeppLib, sizeof(szDeppLib), "%.*s", (int) sizeof(szDeppLib) - 1, szPath);
+			}
+			else {
+				snprintf(szDeppLib, sizeof(szDeppLib), "%s", dli.dli_fname);
+			}
+		}
+	}
+#endif
+}
+
+/* ------------------------------------------------------------ */
+/***	PrintPoint
+**
+**	Parameters:
+**		ppt			- result to print
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Prints one line of the console table.
+*/
+
+void PrintPoint(const BENCHPT * ppt) {
+
+	printf("%-13s %-4s %9lu %7lu %11.1f %11.1f %11.1f %10.3f\n",
+		rgszOp[ppt->op], ppt->fOverlap ? "ovl" : "sync", (unsigned long) ppt->cb,
+		(unsigned long) ppt->csmp, ppt->dblP50 * 1e6, ppt->dblP99 * 1e6,
+		ppt->dblP999 * 1e6, ppt->dblMBps);
+	fflush(stdout);
+}
+
+/* ------------------------------------------------------------ */
+/***	BeginOutput
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if the output file cannot be created.
+**
+**	Description:
+**		Creates the output file and writes the CSV header line or the
+**		opening of the JSON document.
+*/
+
+void BeginOutput() {
+
+	if (fmt == fmtNone) {
+		return;
+	}
+
+	fhout = fopen(szFile, "w");
+	if (fhout == NULL) {
+		printf("Cannot open output file %s\n", szFile);
+		ErrorExit();
+	}
+
+	if (fmt == fmtCsv) {
+		fprintf(fhout, "dmgr_version,depp_version,depp_library,device,op,mode,bytes,calls,"
+			"p50_us,p99_us,p999_us,mean_us,min_us,max_us,mbps\n");
+	}
+	else {
+		fprintf(fhout, "{\n");
+		fprintf(fhout, "  \"dmgr_version\": \"%s\",\n", szDmgrVersion);
+		fprintf(fhout, "  \"depp_version\": \"%s\",\n", szDeppVersion);
+		fprintf(fhout, "  \"depp_library\": \"%s\",\n", szDeppLib);
+		fprintf(fhout, "  \"device\": \"%s\",\n", szDvc);
+		fprintf(fhout, "  \"results\": [");
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	WritePoint
+**
+**	Parameters:
+**		ppt			- result to write
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes one result to the output file. Latencies are written in
+**		microseconds.
+*/
+
+void WritePoint(const BENCHPT * ppt) {
+
+	const char *	szMode = ppt->fOverlap ? "ovl" : "sync";
+
+	if (fhout == NULL) {
+		return;
+	}
+
+	if (fmt == fmtCsv) {
+		fprintf(fhout, "\"%s\",\"%s\",\"%s\",\"%s\",%s,%s,%lu,%lu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.6f\n",
+			szDmgrVersion, szDeppVersion, szDeppLib, szDvc, rgszOp[ppt->op], szMode,
+			(unsigned long) ppt->cb, (unsigned long) ppt->csmp,
+			ppt->dblP50 * 1e6, ppt->dblP99 * 1e6, ppt->dblP999 * 1e6,
+			ppt->dblMean * 1e6, ppt->dblMin * 1e6, ppt->dblMax * 1e6, ppt->dblMBps);
+	}
+	else {
+		fprintf(fhout, "%s\n    { \"op\": \"%s\", \"mode\": \"%s\", \"bytes\": %lu, \"calls\": %lu, "
+			"\"p50_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, \"mean_us\": %.3f, "
+			"\"min_us\": %.3f, \"max_us\": %.3f, \"mbps\": %.6f }",
+			(cptOut > 0) ? "," : "", rgszOp[ppt->op], szMode,
+			(unsigned long) ppt->cb, (unsigned long) ppt->csmp,
+			ppt->dblP50 * 1e6, ppt->dblP99 * 1e6, ppt->dblP999 * 1e6,
+			ppt->dblMean * 1e6, ppt->dblMin * 1e6, ppt->dblMax * 1e6, ppt->dblMBps);
+	}
+
+	cptOut++;
+}
+
+/* ------------------------------------------------------------ */
+/***	EndOutput
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Completes and closes the output file.
+*/
+
+void EndOutput() {
+
+	if (fhout == NULL) {
+		return;
+	}
+
+	if (fmt == fmtJson) {
+		fprintf(fhout, "\n  ]\n}\n");
+	}
+
+	fclose(fhout);
+	fhout = NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	CmpDbl
+**
+**	Parameters:
+**		pv1, pv2	- pointers to the values to compare
+**
+**	Return Value:
+**		<0, 0 or >0 as *pv1 is less than, equal to or greater than *pv2
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Comparison function for qsort.
+*/
+
+int CmpDbl(const void * pv1, const void * pv2) {
+
+	double	dbl1 = *((const double *) pv1);
+	double	dbl2 = *((const double *) pv2);
+
+	return (dbl1 > dbl2) - (dbl1 < dbl2);
+}
+
+/* ------------------------------------------------------------ */
+/***	DblPercentile
+**
+**	Parameters:
+**		rgdbl		- sorted samples
+**		cdbl		- number of samples
+**		dblPct		- percentile, 0 to 100
+**
+**	Return Value:
+**		value of the percentile
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Nearest rank percentile. With fewer than 1000 samples the
+**		99.9th percentile is the largest sample.
+*/
+
+double DblPercentile(const double * rgdbl, DWORD cdbl, double dblPct) {
+
+	double	dblRank;
+	DWORD	idbl;
+
+	dblRank = ceil(dblPct / 100.0 * cdbl);
+	idbl = (dblRank < 1) ? 0 : (DWORD) dblRank - 1;
+	if (idbl >= cdbl) {
+		idbl = cdbl - 1;
+	}
+
+	return rgdbl[idbl];
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the arguments are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	int		op;
+	size_t	cch;
+	BOOL	fDvc = fFalse;
+	BOOL	fOps = fFalse;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-f") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szFile, sizeof(szFile), "%s", rgszArg[++iszArg]);
+			cch = strlen(szFile);
+			fmt = ((cch > 5) && (strcmp(szFile + cch - 5, ".json") == 0)) ? fmtJson : fmtCsv;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-ops") == 0) && (iszArg + 1 < cszArg)) {
+			if (!FParseOps(rgszArg[++iszArg])) {
+				return fFalse;
+			}
+			fOps = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-min") == 0) && (iszArg + 1 < cszArg)) {
+			cbSweepMin = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-max") == 0) && (iszArg + 1 < cszArg)) {
+			cbSweepMax = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-t") == 0) && (iszArg + 1 < cszArg)) {
+			dblPointSec = atof(rgszArg[++iszArg]);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-r") == 0) && (iszArg + 1 < cszArg)) {
+			bReg = (BYTE) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if (strcmp(rgszArg[iszArg], "-sync") == 0) {
+			fOvl = fFalse;
+		}
+		else if (strcmp(rgszArg[iszArg], "-ovl") == 0) {
+			fSync = fFalse;
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	if (!fOps) {
+		for (op = 0; op < opMax; op++) {
+			rgfOp[op] = fTrue;
+		}
+	}
+
+	if ((cbSweepMin == 0) || (cbSweepMax < cbSweepMin) || (cbSweepMax > cbSweepMaxDef) ||
+		(dblPointSec < 0) || (!fSync && !fOvl)) {
+		return fFalse;
+	}
+
+	return fDvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseOps
+**
+**	Parameters:
+**		szOps		- comma separated list of call names
+**
+**	Return Value:
+**		fTrue if all names are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Selects the calls to measure.
+*/
+
+BOOL FParseOps(char * szOps) {
+
+	char *	szTok;
+	int		op;
+
+	for (szTok = strtok(szOps, ","); szTok != NULL; szTok = strtok(NULL, ",")) {
+		for (op = 0; op < opMax; op++) {
+			if (strcmp(szTok, rgszOp[op]) == 0) {
+				rgfOp[op] = fTrue;
+				break;
+			}
+		}
+
+		if (op == opMax) {
+			return fFalse;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper paramater usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s -d <device name> [options]\n\n", szProgName);
+	printf("\tOptions:\n");
+	printf("\t-f <file>\t\tWrite results to a CSV file, or JSON if the\n");
+	printf("\t\t\t\tname ends in .json\n");
+	printf("\t-ops <op,...>\t\tCalls to measure (default all): getreg, putreg,\n");
+	printf("\t\t\t\tgetregset, putregset, getregrepeat, putregrepeat\n");
+	printf("\t-min <# bytes>\t\tSmallest payload (default 1)\n");
+	printf("\t-max <# bytes>\t\tLargest payload (default and limit 16777216)\n");
+	printf("\t-t <seconds>\t\tTime spent on each point (default 0.25)\n");
+	printf("\t-r <register>\t\tRegister used by the single and Repeat calls\n");
+	printf("\t\t\t\t(default 0)\n");
+	printf("\t-sync\t\t\tMeasure synchronous calls only\n");
+	printf("\t-ovl\t\t\tMeasure overlapped calls only\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the calls.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ErrorExit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DEPP, closes the device and the output file, and
+**		exits the program
+*/
+
+void ErrorExit() {
+
+	if (hif != hifInvalid) {
+		// DEPP API Call: DeppDisable
+		DeppDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	if (fhout != NULL) {
+		fclose(fhout);
+	}
+
+	exit(1);
+}
+
+/************************************************************************/
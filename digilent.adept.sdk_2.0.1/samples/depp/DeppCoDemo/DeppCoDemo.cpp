@@ -0,0 +1,580 @@
+/************************************************************************/
+/*																		*/
+/*  DeppCoDemo.cpp  --  DEPP Coroutine Demo Main Program				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		DEPP Coroutine Demo demonstrates the awaitable transfer			*/
+/*		wrappers in samples/common/AdeptCo.h. One coroutine per			*/
+/*		device writes and reads back a data register and then			*/
+/*		captures a register with overlapped DeppGetRegRepeat calls.		*/
+/*		All coroutines run on the main thread, which keeps a transfer	*/
+/*		in flight on every device at once. With -seq the same work is	*/
+/*		done with synchronous calls, one device after another, for		*/
+/*		comparison.														*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: block buffers come from the shared buffer pool			*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "dmgr.h"
+#include "AdeptCo.h"
+#include "BufPool.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+const int		cchSzLen		= 1024;
+const int		cdvcMax			= 16;
+
+const DWORD		cbCaptureDef	= 1000000;
+const DWORD		ccaptureDef		= 4;
+const DWORD		cbBlockDef		= 65536;
+const BYTE		idRegDef		= 15;
+
+/* Register used for the write and read back check.
+*/
+const BYTE		idRegCheck		= 0;
+
+/* State of one device.
+*/
+typedef struct tagDVCCTX {
+	char	szDvc[cchSzLen];
+	HIF		hif;
+	CoHif	coh;
+	BYTE *	rgbBuf;
+	BOOL	fOk;
+	DWORD	cbDone;
+	DWORD	ccancel;			// transfers cancelled by the time limit
+	double	dblStart;
+	double	dblEnd;
+} DVCCTX;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+DVCCTX		rgdvcctx[cdvcMax];
+int			cdvc = 0;
+
+DWORD		cbCapture = cbCaptureDef;
+DWORD		ccapture = ccaptureDef;
+DWORD		cbBlock = cbBlockDef;
+BYTE		idReg = idRegDef;
+DWORD		tmsTimeout = 0;
+BOOL		fSeq = fFalse;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL		FParseParam(int cszArg, char * rgszArg[]);
+BOOL		FParseDvcList(char * szList);
+void		ShowUsage(char * szProgName);
+CoTask		DeviceTask(DVCCTX * pctx);
+CoTask		CheckRegTask(CoDepp & depp, DVCCTX * pctx);
+void		RunSequential(DVCCTX * pctx);
+void		CloseAll();
+double		DblTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if all devices succeeded, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		DeppCoDemo main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	CoLoop		loop;
+	DVCCTX *	pctx;
+	double		dblStart;
+	double		dblSec;
+	DWORD		cbTotal;
+	BOOL		fOk;
+	int			idvc;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	/* One block buffer per device, all from the shared pool.
+	*/
+	BufPoolInitShared(cbBlock, cdvc, FpoolHugeFit(cbBlock, cdvc) | fpoolLock);
+
+	for (idvc = 0; idvc < cdvc; idvc++) {
+		pctx = &rgdvcctx[idvc];
+
+		// DMGR API Call: DmgrOpen
+		if (!DmgrOpen(&pctx->hif, pctx->szDvc)) {
+			printf("DmgrOpen failed for %s (check the device name you provided)\n", pctx->szDvc);
+			CloseAll();
+			return 1;
+		}
+
+		// DEPP API Call: DeppEnable
+		if (!DeppEnable(pctx->hif)) {
+			printf("DeppEnable failed for %s\n", pctx->szDvc);
+			CloseAll();
+			return 1;
+		}
+
+		pctx->rgbBuf = PbBufPoolAlloc(cbBlock);
+		if (pctx->rgbBuf == NULL) {
+			printf("Cannot allocate a block of %lu bytes\n", (unsigned long) cbBlock);
+			CloseAll();
+			return 1;
+		}
+	}
+
+	dblStart = DblTimeSec();
+
+	if (fSeq) {
+		for (idvc = 0; idvc < cdvc; idvc++) {
+			RunSequential(&rgdvcctx[idvc]);
+		}
+	}
+	else {
+		if (!loop.FInit()) {
+			printf("Cannot initialize the coroutine loop\n");
+			CloseAll();
+			return 1;
+		}
+
+		for (idvc = 0; idvc < cdvc; idvc++) {
+			pctx = &rgdvcctx[idvc];
+
+			if (!pctx->coh.FInit(pctx->hif, &loop) || !loop.FSpawn(DeviceTask(pctx))) {
+				printf("Cannot start the transfers of %s\n", pctx->szDvc);
+				loop.Run();
+				CloseAll();
+				loop.Free();
+				return 1;
+			}
+		}
+
+		/* Run every device's coroutine on this thread until all of
+		** them have returned.
+		*/
+		loop.Run();
+
+		for (idvc = 0; idvc < cdvc; idvc++) {
+			rgdvcctx[idvc].coh.Free();
+		}
+		loop.Free();
+	}
+
+	dblSec = DblTimeSec() - dblStart;
+
+	/* Report the results.
+	*/
+	fOk = fTrue;
+	cbTotal = 0;
+
+	printf("%-20s %12s %10s %10s\n", "device", "bytes", "seconds", "MB/s");
+	for (idvc = 0; idvc < cdvc; idvc++) {
+		pctx = &rgdvcctx[idvc];
+		printf("%-20s %12lu %10.3f %10.3f%s",
+			pctx->szDvc, (unsigned long) pctx->cbDone, pctx->dblEnd - pctx->dblStart,
+			(pctx->dblEnd > pctx->dblStart) ? pctx->cbDone / (pctx->dblEnd - pctx->dblStart) / 1e6 : 0,
+			pctx->fOk ? "" : "  FAILED");
+		if (pctx->ccancel > 0) {
+			printf("  (%lu cancelled)", (unsigned long) pctx->ccancel);
+		}
+		printf("\n");
+
+		fOk = fOk && pctx->fOk;
+		cbTotal += pctx->cbDone;
+	}
+
+	printf("%-20s %12lu %10.3f %10.3f\n", fSeq ? "total (sequential)" : "total (coroutines)",
+		(unsigned long) cbTotal, dblSec, (dblSec > 0) ? cbTotal / dblSec / 1e6 : 0);
+
+	CloseAll();
+
+	return fOk ? 0 : 1;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeviceTask
+**
+**	Parameters:
+**		pctx		- device to use
+**
+**	Return Value:
+**		coroutine yielding fTrue if all transfers succeeded
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Checks the data register and then captures the register in
+**		blocks. A block that is cancelled by the time limit is counted
+**		and the capture continues with the next block.
+*/
+
+CoTask DeviceTask(DVCCTX * pctx) {
+
+	CoDepp		depp(pctx->coh);
+	XFERRES		res;
+	DWORD		icapture;
+	DWORD		cbLeft;
+	DWORD		cb;
+
+	pctx->dblStart = DblTimeSec();
+	pctx->fOk = co_await CheckRegTask(depp, pctx);
+
+	for (icapture = 0; pctx->fOk && (icapture < ccapture); icapture++) {
+		for (cbLeft = cbCapture; cbLeft > 0; cbLeft -= cb) {
+			cb = (cbLeft < cbBlock) ? cbLeft : cbBlock;
+
+			if (tmsTimeout != 0) {
+				res = co_await depp.GetRegRepeat(idReg, pctx->rgbBuf, cb).WithTimeout(tmsTimeout);
+			}
+			else {
+				res = co_await depp.GetRegRepeat(idReg, pctx->rgbBuf, cb);
+			}
+
+			if (res.fOk) {
+				pctx->cbDone += cb;
+			}
+			else if (res.erc == ercTransferCancelled) {
+				pctx->ccancel++;
+			}
+			else {
+				printf("%s: DeppGetRegRepeat failed, error %d\n", pctx->szDvc, res.erc);
+				pctx->fOk = fFalse;
+				break;
+			}
+		}
+	}
+
+	pctx->dblEnd = DblTimeSec();
+
+	co_return pctx->fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	CheckRegTask
+**
+**	Parameters:
+**		depp		- transfer wrappers of the device
+**		pctx		- device to use
+**
+**	Return Value:
+**		coroutine yielding fTrue if the check passed
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes a value to the check register and reads it back.
+*/
+
+CoTask CheckRegTask(CoDepp & depp, DVCCTX * pctx) {
+
+	XFERRES		res;
+	BYTE		bPut = (BYTE) (0xA5 ^ (pctx - rgdvcctx));
+	BYTE		bGet = 0;
+
+	res = co_await depp.PutReg(idRegCheck, bPut);
+	if (res.fOk) {
+		res = co_await depp.GetReg(idRegCheck, &bGet);
+	}
+
+	if (!res.fOk) {
+		printf("%s: register check failed, error %d\n", pctx->szDvc, res.erc);
+		co_return fFalse;
+	}
+
+	if (bGet != bPut) {
+		printf("%s: register %d read back %d, expected %d\n", pctx->szDvc, idRegCheck, bGet, bPut);
+		co_return fFalse;
+	}
+
+	co_return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	RunSequential
+**
+**	Parameters:
+**		pctx		- device to use
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Does the work of DeviceTask with synchronous calls.
+*/
+
+void RunSequential(DVCCTX * pctx) {
+
+	BYTE	bPut = (BYTE) (0xA5 ^ (pctx - rgdvcctx));
+	BYTE	bGet = 0;
+	DWORD	icapture;
+	DWORD	cbLeft;
+	DWORD	cb;
+
+	pctx->dblStart = DblTimeSec();
+	pctx->fOk = fTrue;
+
+	// DEPP API Call: DeppPutReg, DeppGetReg
+	if (!DeppPutReg(pctx->hif, idRegCheck, bPut, fFalse) ||
+		!DeppGetReg(pctx->hif, idRegCheck, &bGet, fFalse) || (bGet != bPut)) {
+		printf("%s: register check failed\n", pctx->szDvc);
+		pctx->fOk = fFalse;
+	}
+
+	for (icapture = 0; pctx->fOk && (icapture < ccapture); icapture++) {
+		for (cbLeft = cbCapture; cbLeft > 0; cbLeft -= cb) {
+			cb = (cbLeft < cbBlock) ? cbLeft : cbBlock;
+
+			// DEPP API Call: DeppGetRegRepeat
+			if (!DeppGetRegRepeat(pctx->hif, idReg, pctx->rgbBuf, cb, fFalse)) {
+				printf("%s: DeppGetRegRepeat failed\n", pctx->szDvc);
+				pctx->fOk = fFalse;
+				break;
+			}
+			pctx->cbDone += cb;
+		}
+	}
+
+	pctx->dblEnd = DblTimeSec();
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the arguments are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	BOOL	fDvc = fFalse;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			if (!FParseDvcList(rgszArg[++iszArg])) {
+				return fFalse;
+			}
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-c") == 0) && (iszArg + 1 < cszArg)) {
+			cbCapture = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-n") == 0) && (iszArg + 1 < cszArg)) {
+			ccapture = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-k") == 0) && (iszArg + 1 < cszArg)) {
+			cbBlock = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-r") == 0) && (iszArg + 1 < cszArg)) {
+			idReg = (BYTE) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-t") == 0) && (iszArg + 1 < cszArg)) {
+			tmsTimeout = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if (strcmp(rgszArg[iszArg], "-seq") == 0) {
+			fSeq = fTrue;
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	if ((cbCapture == 0) || (cbBlock == 0)) {
+		return fFalse;
+	}
+
+	return fDvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseDvcList
+**
+**	Parameters:
+**		szList		- comma separated list of device names
+**
+**	Return Value:
+**		fTrue if the list is valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Adds the devices of the list to rgdvcctx.
+*/
+
+BOOL FParseDvcList(char * szList) {
+
+	char *	szDvc;
+	DVCCTX *	pctx;
+
+	for (szDvc = strtok(szList, ","); szDvc != NULL; szDvc = strtok(NULL, ",")) {
+		if (cdvc >= cdvcMax) {
+			printf("Error: at most %d devices\n", cdvcMax);
+			return fFalse;
+		}
+
+		pctx = &rgdvcctx[cdvc++];
+		snprintf(pctx->szDvc, sizeof(pctx->szDvc), "%s", szDvc);
+		pctx->hif = hifInvalid;
+		pctx->rgbBuf = NULL;
+		pctx->fOk = fFalse;
+		pctx->cbDone = 0;
+		pctx->ccancel = 0;
+		pctx->dblStart = 0;
+		pctx->dblEnd = 0;
+	}
+
+	return (cdvc > 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper paramater usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s -d <device name>[,<device name>...] [options]\n\n", szProgName);
+	printf("\tOptions:\n");
+	printf("\t-c <# bytes>\t\tBytes per capture (default 1000000)\n");
+	printf("\t-n <# captures>\t\tCaptures per device (default 4)\n");
+	printf("\t-k <# bytes>\t\tBytes per transfer (default 65536)\n");
+	printf("\t-r <register>\t\tRegister to capture (default 15)\n");
+	printf("\t-t <ms>\t\t\tCancel transfers that take longer\n");
+	printf("\t-seq\t\t\tUse synchronous calls, one device at a time\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	CloseAll
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DEPP, closes the devices and frees the buffers.
+*/
+
+void CloseAll() {
+
+	DVCCTX *	pctx;
+	int			idvc;
+
+	for (idvc = 0; idvc < cdvc; idvc++) {
+		pctx = &rgdvcctx[idvc];
+
+		pctx->coh.Free();
+
+		if (pctx->hif != hifInvalid) {
+			// DEPP API Call: DeppDisable
+			DeppDisable(pctx->hif);
+
+			// DMGR API Call: DmgrClose
+			DmgrClose(pctx->hif);
+			pctx->hif = hifInvalid;
+		}
+
+		if (pctx->rgbBuf != NULL) {
+			BufPoolRelease(pctx->rgbBuf);
+			pctx->rgbBuf = NULL;
+		}
+	}
+
+	BufPoolFreeShared();
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the transfers.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/************************************************************************/
@@ -15,6 +15,15 @@
 /*  Revision History:													*/
 /*																		*/
 /*	03/02/2010(AaronO): created											*/
+/*	10/17/2026: added overlapped streaming capture (-s with -o)			*/
+/*	10/17/2026: added memory mapped file transfers (-m)					*/
+/*	10/17/2026: added block size autotuning (--tune, -k)				*/
+/*	10/17/2026: added register scan (-scan)								*/
+/*	10/17/2026: added multi-device streaming (-s with a device list)	*/
+/*	10/17/2026: added PRBS link soak test (--soak)						*/
+/*	10/17/2026: transfer buffers come from the shared buffer pool		*/
+/*	10/17/2026: -s -m allocates the file before mapping it				*/
+/*	10/17/2026: block sizes measured only by --tune or on -tr			*/
 /*																		*/
 /************************************************************************/
 
@@ -34,6 +43,14 @@
 
 	/* Include Unix specific headers here.
 	*/
+	#include <fcntl.h>
+	#include <pthread.h>
+	#include <sched.h>
+	#include <strings.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <time.h>
+	#include <unistd.h>
 
 #endif
 
@@ -44,6 +61,10 @@
 #include "dpcdecl.h" 
 #include "depp.h"
 #include "dmgr.h"
+#include "BlkTune.h"
+#include "BufPool.h"
+#include "DeppScan.h"
+#include "Prbs.h"
 
 /* ------------------------------------------------------------ */
 /*					Local Type and Constant Definitions			*/
@@ -52,6 +73,83 @@
 const int cchSzLen = 1024;
 const int cbBlockSize = 1000;
 
+/* Range of block sizes measured by the autotuner.
+*/
+const DWORD cbTuneMin = 64;
+const DWORD cbTuneMax = 1024 * 1024;
+
+/* Limits on the number of buffers used by the overlapped streaming
+** capture (-o option).
+*/
+const int cbufStreamMin = 2;
+const int cbufStreamMax = 64;
+
+/* Default number of scans made by the -scan action, and the number of
+** snapshots held by the scan ring.
+*/
+const DWORD cscanDef = 1000;
+const DWORD csnapScanRing = 4096;
+
+/* Maximum number of devices streamed at once (-d with a list).
+*/
+const int cdvcMultiMax = 32;
+
+/* Defaults of the --soak action: bytes sent, PRBS order and seed.
+** Each round trip writes one byte to every register of the list and
+** reads them back; the PRBS is generated and checked for this many
+** round trips at a time.
+*/
+const DWORD cbSoakDef = 65536;
+const int nPrbsDef = 31;
+const DWORD dwPrbsSeed = 0x1A2B3C4D;
+const DWORD cgrpSoakChunk = 512;
+
+/* Ring of buffers shared by the transfer thread and the file writer
+** thread during an overlapped streaming capture. Buffers are filled
+** and written in ring order. The transfer thread owns buffers from
+** ibufWritten + cbuf up to ibufFilled; the writer thread owns the
+** buffers between ibufWritten and ibufFilled.
+*/
+typedef struct tagSTMRING {
+	BYTE *			rgpbBuf[cbufStreamMax];	// cbuf buffers of cbBuf bytes each
+	DWORD *			rgcbBuf;		// count of valid bytes in each buffer
+	int				cbuf;
+	DWORD			cbBuf;
+	long			ibufFilled;		// count of buffers handed to the writer
+	long			ibufWritten;	// count of buffers written to the file
+	BOOL			fDone;			// no more buffers will be filled
+	BOOL			fWriteErr;
+	pthread_mutex_t	mtx;
+	pthread_cond_t	cvFilled;
+	pthread_cond_t	cvWritten;
+} STMRING;
+
+/* State of one device of a multi-device stream. Each device is read
+** by its own I/O thread into two buffers from the shared pool.
+*/
+typedef struct tagDVCSTM {
+	char		szDvc[cchSzLen];	// name or serial number as given
+	char		szConn[cchSzLen];	// string passed to DmgrOpen
+	char		szFileOut[cchSzLen];
+	HIF			hif;
+	int			fd;
+	int			icpu;
+	DWORD		cbBlk;
+	BYTE *		rgpbBuf[2];
+	pthread_t	thr;
+	BOOL		fPinned;
+	BOOL		fOk;
+	long		cbDone;
+	double		dblSec;
+} DVCSTM;
+
+/* Context passed to the autotuner transfer function.
+*/
+typedef struct tagDEPPTUNE {
+	BYTE	idReg;
+	BOOL	fPut;
+} DEPPTUNE;
+
 /* ------------------------------------------------------------ */
 /*					Global Variables							*/
 /* ------------------------------------------------------------ */
@@ -64,6 +162,18 @@ BOOL			fDvc;
 BOOL			fFile;
 BOOL			fCount;
 BOOL			fByte;
+BOOL			fStream;
+BOOL			fTune;
+BOOL			fBlock;
+BOOL			fMap;
+BOOL			fScan;
+BOOL			fDelta;
+BOOL			fRate;
+BOOL			fMulti;
+BOOL			fSoak;
+BOOL			fPrbs;
+BOOL			fTunePut;
+BOOL			fTuneReg;
 
 char			szAction[cchSzLen];
 char			szRegister[cchSzLen];
@@ -71,12 +181,24 @@ char			szDvc[cchSzLen];
 char			szFile[cchSzLen];
 char			szCount[cchSzLen];
 char			szByte[cchSzLen];
+char			szStream[cchSzLen];
+char			szBlock[cchSzLen];
+char			szRate[cchSzLen];
+char			szPrbs[cchSzLen];
+char			szTuneReg[cchSzLen];
 
 HIF				hif = hifInvalid;
 
+DWORD			cbBlock = cbBlockSize;
+
 FILE *			fhin = NULL;
 FILE *			fhout = NULL;
 
+DVCSTM			rgdvcstm[cdvcMultiMax];
+int				cdvcMulti = 0;
+BYTE			idRegMulti;
+long			cbMulti;
+
 
 /* ------------------------------------------------------------ */
 /*				Local Variables									*/
@@ -97,6 +219,25 @@ void		DoPutReg();
 void		DoGetReg();
 void		DoPutRegRepeat();
 void		DoGetRegRepeat();
+void		DoGetRegStream();
+void		DoPutRegRepeatMap();
+void		DoGetRegRepeatMap();
+void		DoTune();
+void		DoScan();
+void		DoSoak();
+void		DoGetRegMulti();
+void *		MultiStreamThread(void * pvDvcStm);
+BOOL		FResolveDvcList();
+void		MultiFileName(DVCSTM * pdvcstm);
+BOOL		FWriteAll(int fd, const BYTE * pb, DWORD cb);
+void		MultiExit(BufPool * ppool);
+BOOL		FParseRegList(char * szList, BYTE * rgbAddr, DWORD * pcreg);
+void		SetBlockSize(BOOL fPut);
+DWORD		CbDeppBlock(BOOL fPut);
+const char *	SzDeppTuneApt(BOOL fPut);
+BOOL		FDeppTuneXfer(void * pvCtx, BYTE * rgb, DWORD cb);
+void *		StreamWriterThread(void * pvRing);
+double		DblTimeSec();
 
 void		StrcpyS( char* szDst, size_t cchDst, const char* szSrc );
 
@@ -124,11 +265,18 @@ void		StrcpyS( char* szDst, size_t cchDst, const char* szSrc );
 
 int main(int cszArg, char * rgszArg[]) {
 
+	int		cbufPool;
+
 	if (!FParseParam(cszArg, rgszArg)) {
 		ShowUsage(rgszArg[0]);
 		return 1;
 	}
 
+	if (fMulti) {
+		DoGetRegMulti();				/* Save each device of the list to its own file */
+		return 0;
+	}
+
 	// DMGR API Call: DmgrOpen
 	if(!DmgrOpen(&hif, szDvc)) {
 		printf("DmgrOpen failed (check the device name you provided)\n");
@@ -141,14 +289,51 @@ int main(int cszArg, char * rgszArg[]) {
 		return 0;
 	}
 
+	if (fGetRegRepeat || fPutRegRepeat) {
+		SetBlockSize(fPutRegRepeat);	/* Use the tuned block size */
+
+		/* The transfer buffers, and the ring of an overlapped capture,
+		** come from the shared pool.
+		*/
+		cbufPool = fStream ? (int) strtol(szStream, NULL, 10) : 1;
+		if ((cbufPool < 1) || (cbufPool > cbufStreamMax)) {
+			cbufPool = 1;
+		}
+		BufPoolInitShared(cbBlock, cbufPool, FpoolHugeFit(cbBlock, cbufPool) | fpoolLock);
+	}
+
 	if(fGetReg) {
 		DoGetReg();						/* Get single byte from register */
 	}
 
+	else if (fTune) {
+		DoTune();						/* Measure and store best block size */
+	}
+
+	else if (fScan) {
+		DoScan();						/* Poll a set of registers */
+	}
+
+	else if (fSoak) {
+		DoSoak();						/* Check the link with a PRBS */
+	}
+
 	else if (fPutReg) {
 		DoPutReg();						/* Send single byte to register */
 	}
 
+	else if (fGetRegRepeat && fStream) {
+		DoGetRegStream();				/* Save file using overlapped transfers */
+	}
+
+	else if (fGetRegRepeat && fMap) {
+		DoGetRegRepeatMap();			/* Save register directly into mapped file */
+	}
+
+	else if (fPutRegRepeat && fMap) {
+		DoPutRegRepeatMap();			/* Load register directly from mapped file */
+	}
+
 	else if (fGetRegRepeat) {
 		DoGetRegRepeat();				/* Save file with contents of register */
 	}
@@ -165,6 +350,8 @@ int main(int cszArg, char * rgszArg[]) {
 		DmgrClose(hif);
 	}
 
+	BufPoolFreeShared();
+
 	return 0;
 }
 
@@ -270,29 +457,38 @@ void DoGetRegRepeat() {
 	long	cb;
 	BYTE	idReg;
 	char *	szStop;
-	BYTE	rgbStf[cbBlockSize];
+	BYTE *	rgbStf;
 	int		cbGet, cbGetTotal;
+	double	dblStart, dblSec;
 
 	idReg	= (BYTE) strtol(szRegister, &szStop, 10);
 	cb		=  strtol(szCount, &szStop, 10);
 
+	dblStart = DblTimeSec();
+
 	fhout = fopen(szFile, "wb");
 	if(fhout == NULL){
 		printf("Cannot open file\n");
 		ErrorExit();
 	}
 
+	rgbStf = PbBufPoolAlloc(cbBlock);
+	if (rgbStf == NULL) {
+		printf("Cannot allocate buffer\n");
+		ErrorExit();
+	}
+
 	cbGet = 0;
 	cbGetTotal = cb;
 	while (cbGetTotal > 0) {
 			
-		if ((cbGetTotal - cbBlockSize) <= 0) {
+		if ((cbGetTotal - (int) cbBlock) <= 0) {
 			cbGet = cbGetTotal;
 			cbGetTotal = 0;
 		}
 		else {
-			cbGet = cbBlockSize;
-			cbGetTotal -= cbBlockSize;
+			cbGet = cbBlock;
+			cbGetTotal -= cbBlock;
 		}
 
 		// DEPP API Call: DeppGetRegRepeat
@@ -303,20 +499,26 @@ void DoGetRegRepeat() {
 		fwrite(rgbStf, sizeof(BYTE), cbGet, fhout);
 	}
 
-	printf("Stream from register complete!\n");
+	BufPoolRelease(rgbStf);
 
 	if( fhout != NULL ) {
 		fclose(fhout);
+		fhout = NULL;
 	}
 
+	dblSec = DblTimeSec() - dblStart;
+
+	printf("Stream from register complete!\n");
+	printf("%ld bytes in %.3f s (%.2f MB/s)\n", cb, dblSec, (dblSec > 0) ? (cb / 1e6) / dblSec : 0.0);
+
 	return;
 }
 
 /* ------------------------------------------------------------ */
-/***	DoPutRegRepeat
+/***	DoGetRegStream
 **
 **	Synopsis
-**		void DoPutRegRepeat()
+**		void DoGetRegStream()
 **
 **	Input:
 **		none
@@ -328,209 +530,1834 @@ void DoGetRegRepeat() {
 **		none
 **
 **	Description:
-**		Sends a stream of bytes to specified register
+**		Gets a stream of bytes from specified register using overlapped
+**		transfers. The next transfer is issued as soon as the previous
+**		one completes, and completed buffers are passed to a writer
+**		thread, so the link keeps running while the file is written.
+**		The device only allows one overlapped transfer per interface
+**		handle to be outstanding; the remaining buffers of the ring
+**		absorb variations in the rate at which the file is written.
 */
 
-void DoPutRegRepeat() {
-
-	long	cb;
-	BYTE	idReg;
-	char *	szStop;
-	BYTE	rgbLd[cbBlockSize];
-	int		cbSend, cbSendTotal, cbSendCheck;
+void DoGetRegStream() {
+
+	long		cb;
+	BYTE		idReg;
+	char *		szStop;
+	STMRING		stmring;
+	BufPool		pool;
+	pthread_t	thrWriter;
+	long		ibuf;
+	long		cbRemain;
+	DWORD		cbCur;
+	DWORD		cbNext;
+	DWORD		cbIn;
+	double		dblStart;
+	double		dblSec;
+	BOOL		fOk;
 
 	idReg	= (BYTE) strtol(szRegister, &szStop, 10);
-	cb		=  strtol(szCount, &szStop, 10);	
+	cb		=  strtol(szCount, &szStop, 10);
 
-	fhin = fopen(szFile, "r+b");
-	if (fhin == NULL) {
+	memset(&stmring, 0, sizeof(stmring));
+	stmring.cbuf	= (int) strtol(szStream, &szStop, 10);
+	stmring.cbBuf	= cbBlock;
+
+	if ((stmring.cbuf < cbufStreamMin) || (stmring.cbuf > cbufStreamMax)) {
+		printf("Buffer count must be between %d and %d\n", cbufStreamMin, cbufStreamMax);
+		ErrorExit();
+	}
+
+	stmring.rgcbBuf	= (DWORD *) malloc(stmring.cbuf * sizeof(DWORD));
+	if ((stmring.rgcbBuf == NULL) || !pool.FInit(stmring.cbBuf, stmring.cbuf)) {
+		printf("Cannot allocate stream buffers\n");
+		ErrorExit();
+	}
+	for (ibuf = 0; ibuf < stmring.cbuf; ibuf++) {
+		stmring.rgpbBuf[ibuf] = pool.PbAlloc();
+	}
+
+	pthread_mutex_init(&stmring.mtx, NULL);
+	pthread_cond_init(&stmring.cvFilled, NULL);
+	pthread_cond_init(&stmring.cvWritten, NULL);
+
+	fhout = fopen(szFile, "wb");
+	if(fhout == NULL){
 		printf("Cannot open file\n");
 		ErrorExit();
 	}
 
-	cbSendTotal = cb;
-	cbSend = 0;
+	if (pthread_create(&thrWriter, NULL, StreamWriterThread, &stmring) != 0) {
+		printf("Cannot create writer thread\n");
+		ErrorExit();
+	}
 
-	while (cbSendTotal > 0) {
+	dblStart = DblTimeSec();
+	fOk = fTrue;
 
-		if ((cbSendTotal - cbBlockSize) <= 0) {
-			cbSend = cbSendTotal;
-			cbSendTotal = 0;
-		}
-		else {
-			cbSend = cbBlockSize;
-			cbSendTotal -= cbBlockSize;
+	/* Issue the first transfer. Buffer ibuf of the stream uses slot
+	** ibuf % cbuf of the ring.
+	*/
+	ibuf = 0;
+	cbRemain = cb;
+	cbCur = (cbRemain > (long) stmring.cbBuf) ? stmring.cbBuf : (DWORD) cbRemain;
+	cbRemain -= cbCur;
+
+	// DEPP API Call: DeppGetRegRepeat
+	if ((cbCur > 0) && !DeppGetRegRepeat(hif, idReg, stmring.rgpbBuf[0], cbCur, fTrue)) {
+		printf("DeppGetRegRepeat failed.\n");
+		fOk = fFalse;
+	}
+
+	while (fOk && (cbCur > 0)) {
+
+		/* Claim the ring slot for the next transfer before waiting on
+		** the current one, so that it can be issued immediately.
+		*/
+		cbNext = (cbRemain > (long) stmring.cbBuf) ? stmring.cbBuf : (DWORD) cbRemain;
+		cbRemain -= cbNext;
+
+		pthread_mutex_lock(&stmring.mtx);
+		while ((cbNext > 0) && (ibuf + 1 - stmring.ibufWritten >= stmring.cbuf) && !stmring.fWriteErr) {
+			pthread_cond_wait(&stmring.cvWritten, &stmring.mtx);
 		}
+		fOk = !stmring.fWriteErr;
+		pthread_mutex_unlock(&stmring.mtx);
 
-		cbSendCheck = fread(rgbLd, sizeof(BYTE), cbSend, fhin);
+		// DMGR API Call: DmgrGetTransResult
+		if (!DmgrGetTransResult(hif, NULL, &cbIn, tmsWaitInfinite) || (cbIn != cbCur)) {
+			printf("DeppGetRegRepeat failed (error %d).\n", DmgrGetLastError());
+			fOk = fFalse;
+		}
 
-		if (cbSendCheck != cbSend) {
-			printf("Cannot read specified number of bytes from file.\n");
-			ErrorExit();
+		if (fOk && (cbNext > 0)) {
+			// DEPP API Call: DeppGetRegRepeat
+			if (!DeppGetRegRepeat(hif, idReg, stmring.rgpbBuf[(ibuf + 1) % stmring.cbuf], cbNext, fTrue)) {
+				printf("DeppGetRegRepeat failed.\n");
+				fOk = fFalse;
+			}
 		}
 
-		// DEPP API Call: DeppPutRegRepeat
-		if(!DeppPutRegRepeat(hif, idReg, rgbLd, cbSend, fFalse)){
-			printf("DeppPutRegRepeat failed.\n");
-			ErrorExit();
+		/* Hand the completed buffer to the writer thread.
+		*/
+		pthread_mutex_lock(&stmring.mtx);
+		if (fOk) {
+			stmring.rgcbBuf[ibuf % stmring.cbuf] = cbCur;
+			stmring.ibufFilled = ibuf + 1;
 		}
-				
+		stmring.fDone = !fOk || (cbNext == 0);
+		pthread_cond_signal(&stmring.cvFilled);
+		pthread_mutex_unlock(&stmring.mtx);
+
+		ibuf += 1;
+		cbCur = cbNext;
 	}
 
-	printf("Stream to register complete!\n");
+	pthread_mutex_lock(&stmring.mtx);
+	stmring.fDone = fTrue;
+	pthread_cond_signal(&stmring.cvFilled);
+	pthread_mutex_unlock(&stmring.mtx);
 
-	if( fhin != NULL ) {
-		fclose(fhin);
+	pthread_join(thrWriter, NULL);
+
+	dblSec = DblTimeSec() - dblStart;
+
+	if (stmring.fWriteErr) {
+		printf("Cannot write file\n");
+		fOk = fFalse;
+	}
+
+	pthread_cond_destroy(&stmring.cvWritten);
+	pthread_cond_destroy(&stmring.cvFilled);
+	pthread_mutex_destroy(&stmring.mtx);
+	free(stmring.rgcbBuf);
+	pool.Free();
+
+	if (!fOk) {
+		ErrorExit();
+	}
+
+	printf("Stream from register complete!\n");
+	printf("%ld bytes in %.3f s (%.2f MB/s sustained, %d buffers)\n",
+			cb, dblSec, (dblSec > 0) ? (cb / 1e6) / dblSec : 0.0, stmring.cbuf);
+
+	if( fhout != NULL ) {
+		fclose(fhout);
+		fhout = NULL;
 	}
 
 	return;
 }
 
 /* ------------------------------------------------------------ */
-/***	FParseParam
+/***	DoGetRegMulti
 **
-**	Parameters:
-**		cszArg		- number of command line arguments
-**		rgszArg		- array of command line argument strings
+**	Synopsis
+**		void DoGetRegMulti()
 **
-**	Return Value:
+**	Input:
+**		none
+**
+**	Output:
 **		none
 **
 **	Errors:
-**		Returns fTrue if not parse errors, fFalse if command line
-**		errors detected.
+**		none
 **
 **	Description:
-**		Parse the command line parameters and set global variables
-**		based on what is found.
+**		Streams the register of every device in the device list into
+**		a file of its own. Each device is read by a dedicated I/O
+**		thread pinned to a core, which overlaps the transfer of one
+**		block with the write of the previous one. All buffers are
+**		taken from one page aligned pool before the threads start,
+**		so nothing is allocated while streaming. Per-device and
+**		aggregate throughput are printed at the end.
 */
 
-BOOL FParseParam(int cszArg, char * rgszArg[]) {
+void DoGetRegMulti() {
 
-	int		iszArg;
+	BufPool		pool;
+	DVCSTM *	pdvcstm;
+	DWORD		cbBlkMax;
+	long		cbTotal;
+	long		ccpu;
+	double		dblStart;
+	double		dblSec;
+	char *		szStop;
+	int			idvc;
+	BOOL		fOk;
 
-	/* Initialize default flag values */
-	fGetReg			= fFalse;
-	fPutReg			= fFalse;
-	fGetRegRepeat	= fFalse;
-	fPutRegRepeat	= fFalse;
-	fDvc			= fFalse;
-	fFile			= fFalse;
-	fCount			= fFalse;
-	fByte			= fFalse;
+	idRegMulti	= (BYTE) strtol(szRegister, &szStop, 10);
+	cbMulti		= strtol(szCount, &szStop, 10);
 
-	// Ensure sufficient paramaters. Need at least program name, action flag, register number
-	if (cszArg < 3) {
-		return fFalse;
+	if (!FResolveDvcList()) {
+		MultiExit(NULL);
 	}
-	
-	/* The first parameter is the action to perform. Copy the
-	** the first parameter into the action string.
-	*/
-	StrcpyS(szAction, cchSzLen, rgszArg[1]);
 
-	if(strcmp(szAction, "-g") == 0) {
-		fGetReg = fTrue;
-	}
-	else if( strcmp(szAction, "-p") == 0) {
-		fPutReg = fTrue;
-	}
-	else if( strcmp(szAction, "-s") == 0) {
-		fGetRegRepeat = fTrue;
-	}
-	else if( strcmp(szAction, "-l") == 0) {
-		fPutRegRepeat = fTrue;
-	}
-	else { // unrecognized action
-		return fFalse;
+	ccpu = sysconf(_SC_NPROCESSORS_ONLN);
+	if (ccpu < 1) {
+		ccpu = 1;
 	}
 
-	/* Second paramater is target register on device. Copy second
-	** paramater to the register string */
-	StrcpyS(szRegister, cchSzLen, rgszArg[2]);
+	/* Open the devices and find the block size of each. The pool
+	** buffers are sized for the largest.
+	*/
+	cbBlkMax = 0;
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		pdvcstm = &rgdvcstm[idvc];
+
+		// DMGR API Call: DmgrOpen
+		if (!DmgrOpen(&pdvcstm->hif, pdvcstm->szConn)) {
+			printf("DmgrOpen failed for %s (check the device name you provided)\n", pdvcstm->szDvc);
+			pdvcstm->hif = hifInvalid;
+			MultiExit(NULL);
+		}
 
+		// DEPP API call: DeppEnable
+		if (!DeppEnable(pdvcstm->hif)) {
+			printf("DeppEnable failed for %s\n", pdvcstm->szDvc);
+			MultiExit(NULL);
+		}
 
-	/* Parse the command line parameters.
-	*/
-	iszArg = 3;
-	while(iszArg < cszArg) {
-	
-		/* Check for the -d parameter which is used to specify
-		** the device name of the device to query.
-		*/
-		if (strcmp(rgszArg[iszArg], "-d") == 0) {
-			iszArg += 1;
-			if (iszArg >= cszArg) {
-				return fFalse;
+		if (fBlock) {
+			pdvcstm->cbBlk = (DWORD) strtoul(szBlock, &szStop, 10);
+			if (pdvcstm->cbBlk == 0) {
+				printf("Block size must be greater than 0\n");
+				MultiExit(NULL);
 			}
-			StrcpyS(szDvc, cchSzLen, rgszArg[iszArg++]);
-			fDvc = fTrue;
 		}
-		
-		/* Check for the -f parameter used to specify the
-		** input/output file name.
-		*/
-		else if (strcmp(rgszArg[iszArg], "-f") == 0) {
-			iszArg += 1;
-			if (iszArg >= cszArg) {
-				return fFalse;
-			}
-			StrcpyS(szFile, cchSnMax, rgszArg[iszArg++]);
-			fFile = fTrue;
+		else {
+			hif = pdvcstm->hif;
+			pdvcstm->cbBlk = CbDeppBlock(fFalse);
+			hif = hifInvalid;
 		}
-		
-		/* Check for the -c parameter used to specify the
-		** number of bytes to read/write from file.
-		*/
-		else if (strcmp(rgszArg[iszArg], "-c") == 0) {
-			iszArg += 1;
-			if (iszArg >= cszArg) {
-				return fFalse;
-			}
-			StrcpyS(szCount, cchUsrNameMax, rgszArg[iszArg++]);
-			fCount = fTrue;
+
+		if (pdvcstm->cbBlk > cbBlkMax) {
+			cbBlkMax = pdvcstm->cbBlk;
 		}
 
-		/* Check for the -b paramater used to specify the 
-		** value of a single data byte to be written to the register 
-		*/
-		else if (strcmp(rgszArg[iszArg], "-b") == 0) {
-			iszArg += 1;
-			if (iszArg >= cszArg) {
-				return fFalse;
+		pdvcstm->icpu = (int) (idvc % ccpu);
+	}
+
+	/* The shared pool holds the buffers of all the devices, so the
+	** I/O threads share one free list.
+	*/
+	BufPoolInitShared(cbBlkMax, 2 * cdvcMulti, FpoolHugeFit(cbBlkMax, 2 * cdvcMulti) | fpoolLock);
+	if (!pool.FInit(cbBlkMax, 2 * cdvcMulti)) {
+		printf("Cannot allocate %d buffers of %lu bytes\n", 2 * cdvcMulti, (unsigned long) cbBlkMax);
+		MultiExit(NULL);
+	}
+
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		pdvcstm = &rgdvcstm[idvc];
+
+		pdvcstm->rgpbBuf[0] = pool.PbAlloc();
+		pdvcstm->rgpbBuf[1] = pool.PbAlloc();
+
+		MultiFileName(pdvcstm);
+		pdvcstm->fd = open(pdvcstm->szFileOut, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (pdvcstm->fd < 0) {
+			printf("Cannot open file %s\n", pdvcstm->szFileOut);
+			MultiExit(&pool);
+		}
+	}
+
+	dblStart = DblTimeSec();
+
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		if (pthread_create(&rgdvcstm[idvc].thr, NULL, MultiStreamThread, &rgdvcstm[idvc]) != 0) {
+			printf("Cannot create I/O thread\n");
+			while (--idvc >= 0) {
+				pthread_join(rgdvcstm[idvc].thr, NULL);
 			}
-			StrcpyS(szByte, cchUsrNameMax, rgszArg[iszArg++]);
-			fByte = fTrue;
+			MultiExit(&pool);
 		}
-		
-		/* Not a recognized parameter
-		*/
-		else {
-			return fFalse;
-		}			
-	} // End while
+	}
 
-	/* Input combination validity checks 
-	*/
-	if(!fDvc) {
-		printf("Error: No device specified\n");
-		return fFalse;
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		pthread_join(rgdvcstm[idvc].thr, NULL);
 	}
-	if( fPutReg && !fByte ) {
-		printf("Error: No byte value provided\n");
-		return fFalse;
+
+	dblSec = DblTimeSec() - dblStart;
+
+	fOk = fTrue;
+	cbTotal = 0;
+
+	printf("%-20s %-32s %4s  %8s %12s %9s %9s\n", "device", "file", "core", "block", "bytes", "seconds", "MB/s");
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		pdvcstm = &rgdvcstm[idvc];
+		printf("%-20s %-32s %4d%s %8lu %12ld %9.3f %9.2f%s\n",
+			pdvcstm->szDvc, pdvcstm->szFileOut, pdvcstm->icpu, pdvcstm->fPinned ? " " : "?",
+			(unsigned long) pdvcstm->cbBlk, pdvcstm->cbDone, pdvcstm->dblSec,
+			(pdvcstm->dblSec > 0) ? (pdvcstm->cbDone / 1e6) / pdvcstm->dblSec : 0.0,
+			pdvcstm->fOk ? "" : "  FAILED");
+
+		cbTotal += pdvcstm->cbDone;
+		fOk = fOk && pdvcstm->fOk;
 	}
-	if( (fGetRegRepeat || fPutRegRepeat) && !fFile ) {
-		printf("Error: No filename provided\n");
-		return fFalse;
+
+	printf("%d devices, %ld bytes in %.3f s (%.2f MB/s aggregate)\n",
+		cdvcMulti, cbTotal, dblSec, (dblSec > 0) ? (cbTotal / 1e6) / dblSec : 0.0);
+
+	if (!fOk) {
+		MultiExit(&pool);
 	}
-		
-	return fTrue;
-	
-}
 
-/* ------------------------------------------------------------ */
-/***	ShowUsage
+	printf("Stream from register complete!\n");
+
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		pdvcstm = &rgdvcstm[idvc];
+
+		close(pdvcstm->fd);
+		pdvcstm->fd = -1;
+		pool.Release(pdvcstm->rgpbBuf[0]);
+		pool.Release(pdvcstm->rgpbBuf[1]);
+
+		// DEPP API Call: DeppDisable
+		DeppDisable(pdvcstm->hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(pdvcstm->hif);
+		pdvcstm->hif = hifInvalid;
+	}
+
+	pool.Free();
+	BufPoolFreeShared();
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	MultiStreamThread
+**
+**	Synopsis
+**		void * MultiStreamThread(pvDvcStm)
+**
+**	Input:
+**		pvDvcStm	- pointer to the DVCSTM of the device
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		Clears fOk in the DVCSTM if a transfer or write fails.
+**
+**	Description:
+**		I/O thread of one device. Pins itself to its core, then reads
+**		the register in blocks with overlapped transfers into the two
+**		buffers of the device in turn. While one block is being
+**		transferred the previous one is written to the file.
+*/
+
+void * MultiStreamThread(void * pvDvcStm) {
+
+	DVCSTM *	pdvcstm = (DVCSTM *) pvDvcStm;
+	cpu_set_t	cpuset;
+	long		cbRemain;
+	DWORD		cbCur;
+	DWORD		cbNext;
+	DWORD		cbIn;
+	double		dblStart;
+	int			ibuf;
+
+	CPU_ZERO(&cpuset);
+	CPU_SET(pdvcstm->icpu, &cpuset);
+	pdvcstm->fPinned = (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0);
+
+	dblStart = DblTimeSec();
+
+	ibuf = 0;
+	cbRemain = cbMulti;
+	cbCur = (cbRemain > (long) pdvcstm->cbBlk) ? pdvcstm->cbBlk : (DWORD) cbRemain;
+	cbRemain -= cbCur;
+
+	// DEPP API Call: DeppGetRegRepeat
+	if ((cbCur > 0) && !DeppGetRegRepeat(pdvcstm->hif, idRegMulti, pdvcstm->rgpbBuf[0], cbCur, fTrue)) {
+		printf("%s: DeppGetRegRepeat failed.\n", pdvcstm->szDvc);
+		pdvcstm->fOk = fFalse;
+	}
+
+	while (pdvcstm->fOk && (cbCur > 0)) {
+
+		// DMGR API Call: DmgrGetTransResult
+		if (!DmgrGetTransResult(pdvcstm->hif, NULL, &cbIn, tmsWaitInfinite) || (cbIn != cbCur)) {
+			printf("%s: DeppGetRegRepeat failed (error %d).\n", pdvcstm->szDvc, DmgrGetLastError());
+			pdvcstm->fOk = fFalse;
+			break;
+		}
+
+		cbNext = (cbRemain > (long) pdvcstm->cbBlk) ? pdvcstm->cbBlk : (DWORD) cbRemain;
+		cbRemain -= cbNext;
+
+		// DEPP API Call: DeppGetRegRepeat
+		if ((cbNext > 0) && !DeppGetRegRepeat(pdvcstm->hif, idRegMulti, pdvcstm->rgpbBuf[ibuf ^ 1], cbNext, fTrue)) {
+			printf("%s: DeppGetRegRepeat failed.\n", pdvcstm->szDvc);
+			pdvcstm->fOk = fFalse;
+			break;
+		}
+
+		if (!FWriteAll(pdvcstm->fd, pdvcstm->rgpbBuf[ibuf], cbCur)) {
+			printf("%s: cannot write file %s\n", pdvcstm->szDvc, pdvcstm->szFileOut);
+			pdvcstm->fOk = fFalse;
+
+			if (cbNext > 0) {
+				// DMGR API Call: DmgrCancelTrans, DmgrGetTransResult
+				DmgrCancelTrans(pdvcstm->hif);
+				DmgrGetTransResult(pdvcstm->hif, NULL, NULL, tmsWaitInfinite);
+			}
+			break;
+		}
+
+		pdvcstm->cbDone += cbCur;
+		ibuf ^= 1;
+		cbCur = cbNext;
+	}
+
+	pdvcstm->dblSec = DblTimeSec() - dblStart;
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	FResolveDvcList
+**
+**	Synopsis
+**		BOOL FResolveDvcList()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		Returns fFalse if the list is too long or a device is given
+**		twice.
+**
+**	Description:
+**		Splits the device list into rgdvcstm. An entry that matches
+**		the serial number of an enumerated device, with or without an
+**		"SN:" prefix, is opened with the connection string of that
+**		device; any other entry is passed to DmgrOpen as a name.
+*/
+
+BOOL FResolveDvcList() {
+
+	DVC			dvc;
+	DVCSTM *	pdvcstm;
+	char		szList[cchSzLen];
+	char		szSn[cchSnMax + 1];
+	char *		szEntry;
+	char *		szSnSel;
+	int			cdvcEnum;
+	int			idvcEnum;
+	int			idvc;
+	int			idvcPrev;
+
+	StrcpyS(szList, cchSzLen, szDvc);
+
+	for (szEntry = strtok(szList, ","); szEntry != NULL; szEntry = strtok(NULL, ",")) {
+		if (cdvcMulti >= cdvcMultiMax) {
+			printf("Error: at most %d devices\n", cdvcMultiMax);
+			return fFalse;
+		}
+
+		pdvcstm = &rgdvcstm[cdvcMulti++];
+		memset(pdvcstm, 0, sizeof(DVCSTM));
+		StrcpyS(pdvcstm->szDvc, cchSzLen, szEntry);
+		StrcpyS(pdvcstm->szConn, cchSzLen, szEntry);
+		pdvcstm->hif = hifInvalid;
+		pdvcstm->fd = -1;
+		pdvcstm->fOk = fTrue;
+	}
+
+	// DMGR API Call: DmgrEnumDevices
+	if (DmgrEnumDevices(&cdvcEnum)) {
+		for (idvcEnum = 0; idvcEnum < cdvcEnum; idvcEnum++) {
+			// DMGR API Call: DmgrGetDvc, DmgrGetInfo
+			if (!DmgrGetDvc(idvcEnum, &dvc) || !DmgrGetInfo(&dvc, dinfoSN, szSn)) {
+				continue;
+			}
+
+			for (idvc = 0; idvc < cdvcMulti; idvc++) {
+				pdvcstm = &rgdvcstm[idvc];
+				szSnSel = pdvcstm->szDvc;
+				if (strncasecmp(szSnSel, "SN:", 3) == 0) {
+					szSnSel += 3;
+				}
+
+				if (strcasecmp(szSnSel, szSn) == 0) {
+					StrcpyS(pdvcstm->szConn, cchSzLen, dvc.szConn);
+				}
+			}
+		}
+
+		// DMGR API Call: DmgrFreeDvcEnum
+		DmgrFreeDvcEnum();
+	}
+
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		for (idvcPrev = 0; idvcPrev < idvc; idvcPrev++) {
+			if (strcmp(rgdvcstm[idvc].szConn, rgdvcstm[idvcPrev].szConn) == 0) {
+				printf("Error: device %s is given twice\n", rgdvcstm[idvc].szDvc);
+				return fFalse;
+			}
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	MultiFileName
+**
+**	Synopsis
+**		void MultiFileName(pdvcstm)
+**
+**	Input:
+**		pdvcstm	- device
+**
+**	Output:
+**		szFileOut of the device
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the output file name of a device by inserting the
+**		device name before the extension of the -f file name, so
+**		capture.bin becomes capture-<device>.bin. Characters of the
+**		device name that are not letters, digits, '-' or '_' are
+**		replaced by '_'.
+*/
+
+void MultiFileName(DVCSTM * pdvcstm) {
+
+	char	szTag[cchSzLen];
+	char *	pchDot;
+	char *	pchSlash;
+	char *	pch;
+	int		cchStem;
+
+	StrcpyS(szTag, cchSzLen, pdvcstm->szDvc);
+	for (pch = szTag; *pch != '\0'; pch++) {
+		if (!(((*pch >= 'a') && (*pch <= 'z')) || ((*pch >= 'A') && (*pch <= 'Z')) ||
+			  ((*pch >= '0') && (*pch <= '9')) || (*pch == '-') || (*pch == '_'))) {
+			*pch = '_';
+		}
+	}
+
+	pchDot = strrchr(szFile, '.');
+	pchSlash = strrchr(szFile, '/');
+	if ((pchDot == NULL) || ((pchSlash != NULL) && (pchDot < pchSlash)) || (pchDot == szFile)) {
+		pchDot = szFile + strlen(szFile);
+	}
+
+	cchStem = (int) (pchDot - szFile);
+	snprintf(pdvcstm->szFileOut, cchSzLen, "%.*s-%.*s%s",
+		cchStem, szFile, (int) (cchSzLen / 2), szTag, pchDot);
+}
+
+/* ------------------------------------------------------------ */
+/***	FWriteAll
+**
+**	Synopsis
+**		BOOL FWriteAll(fd, pb, cb)
+**
+**	Input:
+**		fd		- file descriptor
+**		pb		- data to write
+**		cb		- number of bytes
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		Returns fFalse if the data cannot be written.
+**
+**	Description:
+**		Writes all of the data, continuing after partial writes.
+*/
+
+BOOL FWriteAll(int fd, const BYTE * pb, DWORD cb) {
+
+	ssize_t	cbWritten;
+
+	while (cb > 0) {
+		cbWritten = write(fd, pb, cb);
+		if (cbWritten <= 0) {
+			return fFalse;
+		}
+		pb += cbWritten;
+		cb -= (DWORD) cbWritten;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	MultiExit
+**
+**	Synopsis
+**		void MultiExit(ppool)
+**
+**	Input:
+**		ppool	- buffer pool to free, or NULL
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Closes the files and devices of a multi-device stream and
+**		exits the program.
+*/
+
+void MultiExit(BufPool * ppool) {
+
+	DVCSTM *	pdvcstm;
+	int			idvc;
+
+	for (idvc = 0; idvc < cdvcMulti; idvc++) {
+		pdvcstm = &rgdvcstm[idvc];
+
+		if (pdvcstm->fd >= 0) {
+			close(pdvcstm->fd);
+			pdvcstm->fd = -1;
+		}
+
+		if (pdvcstm->hif != hifInvalid) {
+			// DEPP API Call: DeppDisable
+			DeppDisable(pdvcstm->hif);
+
+			// DMGR API Call: DmgrClose
+			DmgrClose(pdvcstm->hif);
+			pdvcstm->hif = hifInvalid;
+		}
+	}
+
+	if (ppool != NULL) {
+		ppool->Free();
+	}
+
+	exit(1);
+}
+
+/* ------------------------------------------------------------ */
+/***	StreamWriterThread
+**
+**	Synopsis
+**		void * StreamWriterThread(pvRing)
+**
+**	Input:
+**		pvRing		- pointer to the STMRING shared with DoGetRegStream
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		Sets fWriteErr in the ring if the file cannot be written.
+**
+**	Description:
+**		Writes filled buffers to the output file in ring order until
+**		the transfer thread indicates that no more will be filled.
+*/
+
+void * StreamWriterThread(void * pvRing) {
+
+	STMRING *	pstmring = (STMRING *) pvRing;
+	long		ibuf;
+	BYTE *		pbBuf;
+	DWORD		cbBuf;
+
+	pthread_mutex_lock(&pstmring->mtx);
+
+	while (fTrue) {
+
+		while ((pstmring->ibufWritten == pstmring->ibufFilled) && !pstmring->fDone) {
+			pthread_cond_wait(&pstmring->cvFilled, &pstmring->mtx);
+		}
+
+		if (pstmring->ibufWritten == pstmring->ibufFilled) {
+			break;
+		}
+
+		ibuf  = pstmring->ibufWritten % pstmring->cbuf;
+		pbBuf = pstmring->rgpbBuf[ibuf];
+		cbBuf = pstmring->rgcbBuf[ibuf];
+
+		pthread_mutex_unlock(&pstmring->mtx);
+
+		if (fwrite(pbBuf, sizeof(BYTE), cbBuf, fhout) != cbBuf) {
+			pthread_mutex_lock(&pstmring->mtx);
+			pstmring->fWriteErr = fTrue;
+		}
+		else {
+			pthread_mutex_lock(&pstmring->mtx);
+		}
+
+		/* Buffers are released even after a write error so that the
+		** transfer thread cannot block waiting on the writer.
+		*/
+		pstmring->ibufWritten += 1;
+		pthread_cond_signal(&pstmring->cvWritten);
+	}
+
+	pthread_mutex_unlock(&pstmring->mtx);
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/***	DoPutRegRepeat
+**
+**	Synopsis
+**		void DoPutRegRepeat()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sends a stream of bytes to specified register
+*/
+
+void DoPutRegRepeat() {
+
+	long	cb;
+	BYTE	idReg;
+	char *	szStop;
+	BYTE *	rgbLd;
+	int		cbSend, cbSendTotal, cbSendCheck;
+	double	dblStart, dblSec;
+
+	idReg	= (BYTE) strtol(szRegister, &szStop, 10);
+	cb		=  strtol(szCount, &szStop, 10);	
+
+	dblStart = DblTimeSec();
+
+	fhin = fopen(szFile, "r+b");
+	if (fhin == NULL) {
+		printf("Cannot open file\n");
+		ErrorExit();
+	}
+
+	rgbLd = PbBufPoolAlloc(cbBlock);
+	if (rgbLd == NULL) {
+		printf("Cannot allocate buffer\n");
+		ErrorExit();
+	}
+
+	cbSendTotal = cb;
+	cbSend = 0;
+
+	while (cbSendTotal > 0) {
+
+		if ((cbSendTotal - (int) cbBlock) <= 0) {
+			cbSend = cbSendTotal;
+			cbSendTotal = 0;
+		}
+		else {
+			cbSend = cbBlock;
+			cbSendTotal -= cbBlock;
+		}
+
+		cbSendCheck = fread(rgbLd, sizeof(BYTE), cbSend, fhin);
+
+		if (cbSendCheck != cbSend) {
+			printf("Cannot read specified number of bytes from file.\n");
+			ErrorExit();
+		}
+
+		// DEPP API Call: DeppPutRegRepeat
+		if(!DeppPutRegRepeat(hif, idReg, rgbLd, cbSend, fFalse)){
+			printf("DeppPutRegRepeat failed.\n");
+			ErrorExit();
+		}
+				
+	}
+
+	BufPoolRelease(rgbLd);
+
+	if( fhin != NULL ) {
+		fclose(fhin);
+		fhin = NULL;
+	}
+
+	dblSec = DblTimeSec() - dblStart;
+
+	printf("Stream to register complete!\n");
+	printf("%ld bytes in %.3f s (%.2f MB/s)\n", cb, dblSec, (dblSec > 0) ? (cb / 1e6) / dblSec : 0.0);
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	DoGetRegRepeatMap
+**
+**	Synopsis
+**		void DoGetRegRepeatMap()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Gets a stream of bytes from specified register directly into
+**		a memory mapped file. The blocks of the file are allocated
+**		before mapping, so a full disk is reported instead of raising
+**		SIGBUS, and each block is read straight into its slice of the
+**		mapping, so no intermediate buffer or write calls are needed.
+*/
+
+void DoGetRegRepeatMap() {
+
+	long	cb;
+	BYTE	idReg;
+	char *	szStop;
+	int		fd;
+	int		erc;
+	BYTE *	pbMap;
+	long	ibGet;
+	DWORD	cbGet;
+	double	dblStart, dblSec;
+
+	idReg	= (BYTE) strtol(szRegister, &szStop, 10);
+	cb		=  strtol(szCount, &szStop, 10);
+
+	if (cb <= 0) {
+		printf("A byte count is required with -m\n");
+		ErrorExit();
+	}
+
+	dblStart = DblTimeSec();
+
+	fd = open(szFile, O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0) {
+		printf("Cannot open file\n");
+		ErrorExit();
+	}
+
+	/* Allocate the blocks of the file before mapping it. A sparse
+	** file would be filled through page faults, and a full disk would
+	** then raise SIGBUS in the middle of the transfer.
+	*/
+	erc = posix_fallocate(fd, 0, cb);
+	if (erc != 0) {
+		printf("Cannot allocate %ld bytes for file: %s\n", cb, strerror(erc));
+		close(fd);
+		remove(szFile);
+		ErrorExit();
+	}
+
+	pbMap = (BYTE *) mmap(NULL, cb, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (pbMap == (BYTE *) MAP_FAILED) {
+		printf("Cannot map file\n");
+		close(fd);
+		ErrorExit();
+	}
+
+	madvise(pbMap, cb, MADV_SEQUENTIAL);
+
+	for (ibGet = 0; ibGet < cb; ibGet += cbGet) {
+
+		cbGet = ((cb - ibGet) > (long) cbBlock) ? cbBlock : (DWORD) (cb - ibGet);
+
+		// DEPP API Call: DeppGetRegRepeat
+		if (!DeppGetRegRepeat(hif, idReg, &pbMap[ibGet], cbGet, fFalse)) {
+			printf("DeppGetRegRepeat failed.\n");
+			munmap(pbMap, cb);
+			close(fd);
+			ErrorExit();
+		}
+	}
+
+	munmap(pbMap, cb);
+	close(fd);
+
+	dblSec = DblTimeSec() - dblStart;
+
+	printf("Stream from register complete!\n");
+	printf("%ld bytes in %.3f s (%.2f MB/s, mapped)\n", cb, dblSec, (dblSec > 0) ? (cb / 1e6) / dblSec : 0.0);
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	DoPutRegRepeatMap
+**
+**	Synopsis
+**		void DoPutRegRepeatMap()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sends a stream of bytes to specified register directly from a
+**		memory mapped file.
+*/
+
+void DoPutRegRepeatMap() {
+
+	long		cb;
+	BYTE		idReg;
+	char *		szStop;
+	int			fd;
+	struct stat	st;
+	BYTE *		pbMap;
+	long		ibSend;
+	DWORD		cbSend;
+	double		dblStart, dblSec;
+
+	idReg	= (BYTE) strtol(szRegister, &szStop, 10);
+	cb		=  strtol(szCount, &szStop, 10);
+
+	if (cb <= 0) {
+		printf("A byte count is required with -m\n");
+		ErrorExit();
+	}
+
+	dblStart = DblTimeSec();
+
+	fd = open(szFile, O_RDONLY);
+	if (fd < 0) {
+		printf("Cannot open file\n");
+		ErrorExit();
+	}
+
+	if ((fstat(fd, &st) != 0) || (st.st_size < cb)) {
+		printf("Cannot read specified number of bytes from file.\n");
+		close(fd);
+		ErrorExit();
+	}
+
+	pbMap = (BYTE *) mmap(NULL, cb, PROT_READ, MAP_SHARED, fd, 0);
+	if (pbMap == (BYTE *) MAP_FAILED) {
+		printf("Cannot map file\n");
+		close(fd);
+		ErrorExit();
+	}
+
+	madvise(pbMap, cb, MADV_SEQUENTIAL);
+	madvise(pbMap, cb, MADV_WILLNEED);
+
+	for (ibSend = 0; ibSend < cb; ibSend += cbSend) {
+
+		cbSend = ((cb - ibSend) > (long) cbBlock) ? cbBlock : (DWORD) (cb - ibSend);
+
+		// DEPP API Call: DeppPutRegRepeat
+		if (!DeppPutRegRepeat(hif, idReg, &pbMap[ibSend], cbSend, fFalse)) {
+			printf("DeppPutRegRepeat failed.\n");
+			munmap(pbMap, cb);
+			close(fd);
+			ErrorExit();
+		}
+	}
+
+	munmap(pbMap, cb);
+	close(fd);
+
+	dblSec = DblTimeSec() - dblStart;
+
+	printf("Stream to register complete!\n");
+	printf("%ld bytes in %.3f s (%.2f MB/s, mapped)\n", cb, dblSec, (dblSec > 0) ? (cb / 1e6) / dblSec : 0.0);
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	DoTune
+**
+**	Synopsis
+**		void DoTune()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Measures the throughput of DeppGetRegRepeat from the specified
+**		register, or of DeppPutRegRepeat to it with -w, over a range of
+**		block sizes, prints the measured curve and stores the best
+**		block size for the device, transport and direction. Later -s
+**		transfers to the device use the size measured by reading and
+**		-l transfers the size measured by writing. The sweep transfers
+**		up to 1 MB at a time, so the register should be one that can
+**		take or give junk bytes, such as a scratch register.
+*/
+
+void DoTune() {
+
+	DEPPTUNE	depptune;
+	TUNCRV		tuncrv;
+	char		szSn[cchSnMax + 1];
+	char		szDtp[cchDtpStringMax + 1];
+	char *		szStop;
+
+	depptune.idReg	= (BYTE) strtol(szRegister, &szStop, 10);
+	depptune.fPut	= fTunePut;
+
+	if (!FTuneGetDvc(hif, szSn, szDtp)) {
+		printf("Cannot get device serial number\n");
+		ErrorExit();
+	}
+
+	if (!FTuneSweep(FDeppTuneXfer, &depptune, cbTuneMin, cbTuneMax, &tuncrv)) {
+		printf("%s failed.\n", fTunePut ? "DeppPutRegRepeat" : "DeppGetRegRepeat");
+		ErrorExit();
+	}
+
+	printf("%s throughput for %s device %s, register %d:\n",
+		fTunePut ? "DeppPutRegRepeat" : "DeppGetRegRepeat", szDtp, szSn, depptune.idReg);
+	TunePrintCurve(&tuncrv);
+
+	if (!FTuneStore(SzDeppTuneApt(fTunePut), szDtp, szSn, tuncrv.cbBest)) {
+		printf("Cannot store tuned block size\n");
+		ErrorExit();
+	}
+
+	printf("Block size %lu stored\n", (unsigned long) tuncrv.cbBest);
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	DoScan
+**
+**	Synopsis
+**		void DoScan()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Polls the registers in the register list with a DeppScan
+**		object. The scan thread reads all registers with one
+**		DeppGetRegSet call per scan and publishes timestamped
+**		snapshots through the scan ring, which this thread drains. In
+**		delta mode each published snapshot is printed. When the
+**		requested number of scans is complete the achieved scan rate
+**		is printed.
+*/
+
+void DoScan() {
+
+	DeppScan	scan;
+	SCANSNAP	snap;
+	BYTE		rgbAddr[cregScanMax];
+	DWORD		creg;
+	DWORD		cscanReq;
+	DWORD		csnap;
+	DWORD		ireg;
+	double		dblRate;
+	double		dblStart;
+	BOOL		fRunning;
+	char *		szStop;
+	struct timespec	tsPoll;
+
+	if (!FParseRegList(szRegister, rgbAddr, &creg)) {
+		printf("Invalid register list %s\n", szRegister);
+		ErrorExit();
+	}
+
+	cscanReq = fCount ? (DWORD) strtoul(szCount, &szStop, 10) : cscanDef;
+	dblRate = fRate ? strtod(szRate, &szStop) : 0;
+	if ((cscanReq == 0) || (dblRate < 0)) {
+		printf("Invalid scan count or rate\n");
+		ErrorExit();
+	}
+
+	if (!scan.FInit(hif, rgbAddr, creg, csnapScanRing, fDelta)) {
+		printf("Cannot initialize the register scan\n");
+		ErrorExit();
+	}
+
+	dblStart = DblTimeSec();
+
+	if (!scan.FStart(dblRate, cscanReq)) {
+		printf("Cannot start the scan thread\n");
+		scan.Free();
+		ErrorExit();
+	}
+
+	/* Take snapshots until the thread is done and the ring is empty.
+	** The ring does not signal new snapshots, so sleep briefly when
+	** it is empty.
+	*/
+	tsPoll.tv_sec = 0;
+	tsPoll.tv_nsec = 200000;
+	csnap = 0;
+	memset(&snap, 0, sizeof(snap));
+
+	do {
+		fRunning = scan.FRunning();
+
+		while (scan.FPop(&snap)) {
+			csnap++;
+			if (fDelta) {
+				printf("%12.6f %8lu:", snap.dblTime - dblStart, (unsigned long) snap.iscan);
+				for (ireg = 0; ireg < snap.creg; ireg++) {
+					printf(" %3d", snap.rgbData[ireg]);
+				}
+				printf("\n");
+			}
+		}
+
+		if (fRunning) {
+			nanosleep(&tsPoll, NULL);
+		}
+	} while (fRunning);
+
+	scan.Free();
+
+	if (scan.FError()) {
+		printf("DeppGetRegSet failed\n");
+		ErrorExit();
+	}
+
+	printf("Complete. %lu scans of %lu registers at %.1f scans/s (%.0f registers/s)\n",
+		(unsigned long) scan.Cscan(), (unsigned long) creg, scan.DblScanRate(),
+		scan.DblScanRate() * creg);
+	printf("%lu snapshots published, %lu taken, %lu dropped (ring full)\n",
+		(unsigned long) scan.Cpublish(), (unsigned long) csnap, (unsigned long) scan.Cdrop());
+
+	if (!fDelta && (csnap > 0)) {
+		printf("Last snapshot:");
+		for (ireg = 0; ireg < snap.creg; ireg++) {
+			printf(" %d=%d", rgbAddr[ireg], snap.rgbData[ireg]);
+		}
+		printf("\n");
+	}
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	DoSoak
+**
+**	Synopsis
+**		void DoSoak()
+**
+**	Input:
+**		none
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Link integrity soak test. Sends -c bytes of a PRBS (-prbs,
+**		PRBS-31 by default) through the registers of the list: each
+**		round trip writes the next byte of the sequence to every
+**		register with DeppPutRegSet and reads them back with
+**		DeppGetRegSet. The data read back is checked against the
+**		sequence, and the bit errors, the offset of the first byte in
+**		error and the speed of the link and of the PRBS generator and
+**		checker are printed.
+**
+**		The registers must be distinct and must read back what was
+**		written to them, such as regData0-regData7 (0-7) of the
+**		DpimRef design.
+*/
+
+void DoSoak() {
+
+	Prbs		prbsTx;
+	Prbs		prbsRx;
+	PRBSCHK		prbschk;
+	BYTE		rgbAddr[cregScanMax];
+	BYTE		rgbPair[2*cregScanMax];
+	BYTE *		rgbTx;
+	BYTE *		rgbRx;
+	DWORD		creg;
+	DWORD		cregGrp;
+	DWORD		ireg;
+	DWORD		iregPrev;
+	DWORD		cbSoak;
+	DWORD		cbChunk;
+	DWORD		cb;
+	DWORD		ib;
+	DWORD		cbDone;
+	int			nOrder;
+	double		dblStart;
+	double		dblSec;
+	double		dblPrbsSec;
+	double		dblT;
+	char *		szStop;
+
+	if (!FParseRegList(szRegister, rgbAddr, &creg)) {
+		printf("Invalid register list %s\n", szRegister);
+		ErrorExit();
+	}
+
+	for (ireg = 1; ireg < creg; ireg++) {
+		for (iregPrev = 0; iregPrev < ireg; iregPrev++) {
+			if (rgbAddr[iregPrev] == rgbAddr[ireg]) {
+				printf("Register %d is listed twice\n", rgbAddr[ireg]);
+				ErrorExit();
+			}
+		}
+	}
+
+	cbSoak = fCount ? (DWORD) strtoul(szCount, &szStop, 10) : cbSoakDef;
+	nOrder = fPrbs ? (int) strtol(szPrbs, &szStop, 10) : nPrbsDef;
+	if (cbSoak == 0) {
+		printf("Invalid byte count\n");
+		ErrorExit();
+	}
+
+	if (!prbsTx.FInit(nOrder, dwPrbsSeed) || !prbsRx.FInit(nOrder, dwPrbsSeed)) {
+		printf("Invalid PRBS order %d (7, 15 or 31)\n", nOrder);
+		ErrorExit();
+	}
+
+	cbChunk = creg * cgrpSoakChunk;
+	rgbTx = (BYTE *) malloc(cbChunk);
+	rgbRx = (BYTE *) malloc(cbChunk);
+	if ((rgbTx == NULL) || (rgbRx == NULL)) {
+		printf("Cannot allocate %lu byte buffers\n", (unsigned long) cbChunk);
+		free(rgbTx);
+		free(rgbRx);
+		ErrorExit();
+	}
+
+	printf("Soaking %lu bytes through %lu registers with PRBS-%d (%s kernels)\n",
+		(unsigned long) cbSoak, (unsigned long) creg, nOrder, Prbs::SzKernel());
+
+	Prbs::InitChk(&prbschk);
+	dblPrbsSec = 0;
+	dblStart = DblTimeSec();
+
+	for (cbDone = 0; cbDone < cbSoak; cbDone += cb) {
+		cb = (cbSoak - cbDone < cbChunk) ? cbSoak - cbDone : cbChunk;
+
+		dblT = DblTimeSec();
+		prbsTx.Fill(rgbTx, cb);
+		dblPrbsSec += DblTimeSec() - dblT;
+
+		for (ib = 0; ib < cb; ib += cregGrp) {
+			cregGrp = (cb - ib < creg) ? cb - ib : creg;
+			for (ireg = 0; ireg < cregGrp; ireg++) {
+				rgbPair[2*ireg] = rgbAddr[ireg];
+				rgbPair[2*ireg+1] = rgbTx[ib + ireg];
+			}
+
+			// DEPP API Call: DeppPutRegSet, DeppGetRegSet
+			if (!DeppPutRegSet(hif, rgbPair, cregGrp, fFalse) ||
+				!DeppGetRegSet(hif, rgbAddr, rgbRx + ib, cregGrp, fFalse)) {
+				printf("DEPP transfer failed at offset %lu\n", (unsigned long) (cbDone + ib));
+				free(rgbTx);
+				free(rgbRx);
+				ErrorExit();
+			}
+		}
+
+		dblT = DblTimeSec();
+		prbsRx.Check(rgbRx, cb, &prbschk);
+		dblPrbsSec += DblTimeSec() - dblT;
+	}
+
+	dblSec = DblTimeSec() - dblStart;
+
+	free(rgbTx);
+	free(rgbRx);
+
+	printf("%lu bytes written and read back in %.3f s (%.1f KB/s each way)\n",
+		(unsigned long) cbSoak, dblSec, (dblSec > 0) ? cbSoak / dblSec / 1e3 : 0.0);
+	if (dblPrbsSec > 0) {
+		printf("PRBS generator and checker: %.3f ms, %.2f GB/s\n",
+			dblPrbsSec * 1e3, 2.0 * cbSoak / dblPrbsSec / 1e9);
+	}
+
+	if (prbschk.cbitErr != 0) {
+		printf("Error: %lld bit errors, %lld bytes in error (BER %.3g), the first at offset %lld\n",
+			prbschk.cbitErr, prbschk.cbErr, prbschk.cbitErr / (8.0 * prbschk.cbChecked),
+			prbschk.ibErrFirst);
+		ErrorExit();
+	}
+
+	printf("Complete. No bit errors in %lld bits\n", 8 * prbschk.cbChecked);
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseRegList
+**
+**	Synopsis
+**		BOOL FParseRegList(szList, rgbAddr, pcreg)
+**
+**	Input:
+**		szList	- register list, such as "0-7,8,9"
+**
+**	Output:
+**		rgbAddr	- register addresses, at most cregScanMax
+**		pcreg	- number of registers
+**
+**	Errors:
+**		Returns fFalse if the list is invalid or too long.
+**
+**	Description:
+**		Parses a comma separated list of register numbers and
+**		ascending ranges into an address vector. Registers are scanned
+**		in the order given and may be repeated.
+*/
+
+BOOL FParseRegList(char * szList, BYTE * rgbAddr, DWORD * pcreg) {
+
+	char *	sz = szList;
+	char *	szStop;
+	long	regFirst;
+	long	regLast;
+	long	reg;
+	DWORD	creg = 0;
+
+	while (*sz != '\0') {
+		regFirst = strtol(sz, &szStop, 10);
+		if (szStop == sz) {
+			return fFalse;
+		}
+		sz = szStop;
+
+		regLast = regFirst;
+		if (*sz == '-') {
+			sz++;
+			regLast = strtol(sz, &szStop, 10);
+			if (szStop == sz) {
+				return fFalse;
+			}
+			sz = szStop;
+		}
+
+		if ((regFirst < 0) || (regLast > 255) || (regLast < regFirst)) {
+			return fFalse;
+		}
+
+		for (reg = regFirst; reg <= regLast; reg++) {
+			if (creg >= cregScanMax) {
+				return fFalse;
+			}
+			rgbAddr[creg++] = (BYTE) reg;
+		}
+
+		if (*sz == ',') {
+			sz++;
+		}
+		else if (*sz != '\0') {
+			return fFalse;
+		}
+	}
+
+	*pcreg = creg;
+
+	return (creg > 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	SetBlockSize
+**
+**	Synopsis
+**		void SetBlockSize(fPut)
+**
+**	Input:
+**		fPut	- fTrue if the transfer writes the register
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the block size used by the repeat transfers. The size
+**		given with -k is used if present, otherwise the size found by
+**		CbDeppBlock.
+*/
+
+void SetBlockSize(BOOL fPut) {
+
+	char *		szStop;
+
+	if (fBlock) {
+		cbBlock = (DWORD) strtoul(szBlock, &szStop, 10);
+		if (cbBlock == 0) {
+			printf("Block size must be greater than 0\n");
+			ErrorExit();
+		}
+		return;
+	}
+
+	cbBlock = CbDeppBlock(fPut);
+
+	return;
+}
+
+/* ------------------------------------------------------------ */
+/***	CbDeppBlock
+**
+**	Synopsis
+**		DWORD CbDeppBlock(fPut)
+**
+**	Input:
+**		fPut	- fTrue if the transfer writes the register
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the tuned block size of the device open on hif for
+**		transfers in the given direction. If the device has not been
+**		tuned, the register given with -tr is measured and the result
+**		stored; without -tr the default block size is used. The
+**		register of the transfer itself is never measured, as the
+**		sweep would push junk into it or throw away data read from it.
+*/
+
+DWORD CbDeppBlock(BOOL fPut) {
+
+	DEPPTUNE	depptune;
+	DWORD		cbTuned;
+	char *		szStop;
+
+	if (FTuneGetBlock(hif, SzDeppTuneApt(fPut), &cbTuned)) {
+		return cbTuned;
+	}
+
+	if (!fTuneReg) {
+		printf("No tuned %s block size for this device, using %d bytes\n",
+			fPut ? "-l" : "-s", cbBlockSize);
+		printf("Run DeppDemo --tune <register>%s on a scratch register, or add\n", fPut ? " -w" : "");
+		printf("-tr <register>, to measure it\n");
+		return cbBlockSize;
+	}
+
+	depptune.idReg	= (BYTE) strtol(szTuneReg, &szStop, 10);
+	depptune.fPut	= fPut;
+
+	return CbTuneBlock(hif, SzDeppTuneApt(fPut), FDeppTuneXfer, &depptune,
+					cbTuneMin, cbTuneMax, cbBlockSize);
+}
+
+/* ------------------------------------------------------------ */
+/***	SzDeppTuneApt
+**
+**	Synopsis
+**		const char * SzDeppTuneApt(fPut)
+**
+**	Input:
+**		fPut	- fTrue for transfers that write the register
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the name the block size of each direction is stored
+**		under in the tuning cache. Reads and writes are tuned apart.
+*/
+
+const char * SzDeppTuneApt(BOOL fPut) {
+
+	return fPut ? "depp-put" : "depp-get";
+}
+
+/* ------------------------------------------------------------ */
+/***	FDeppTuneXfer
+**
+**	Synopsis
+**		BOOL FDeppTuneXfer(pvCtx, rgb, cb)
+**
+**	Input:
+**		pvCtx	- pointer to a DEPPTUNE
+**		rgb		- transfer buffer
+**		cb		- number of bytes to transfer
+**
+**	Output:
+**		none
+**
+**	Errors:
+**		Returns fFalse if the transfer fails.
+**
+**	Description:
+**		Transfer function measured by the autotuner.
+*/
+
+BOOL FDeppTuneXfer(void * pvCtx, BYTE * rgb, DWORD cb) {
+
+	DEPPTUNE *	pdepptune = (DEPPTUNE *) pvCtx;
+
+	if (pdepptune->fPut) {
+		// DEPP API Call: DeppPutRegRepeat
+		return DeppPutRegRepeat(hif, pdepptune->idReg, rgb, cb, fFalse);
+	}
+
+	// DEPP API Call: DeppGetRegRepeat
+	return DeppGetRegRepeat(hif, pdepptune->idReg, rgb, cb, fFalse);
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Returns fTrue if not parse errors, fFalse if command line
+**		errors detected.
+**
+**	Description:
+**		Parse the command line parameters and set global variables
+**		based on what is found.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+
+	/* Initialize default flag values */
+	fGetReg			= fFalse;
+	fPutReg			= fFalse;
+	fGetRegRepeat	= fFalse;
+	fPutRegRepeat	= fFalse;
+	fDvc			= fFalse;
+	fFile			= fFalse;
+	fCount			= fFalse;
+	fByte			= fFalse;
+	fStream			= fFalse;
+	fMap			= fFalse;
+	fTune			= fFalse;
+	fBlock			= fFalse;
+	fScan			= fFalse;
+	fDelta			= fFalse;
+	fRate			= fFalse;
+	fMulti			= fFalse;
+	fSoak			= fFalse;
+	fPrbs			= fFalse;
+	fTunePut		= fFalse;
+	fTuneReg		= fFalse;
+
+	// Ensure sufficient paramaters. Need at least program name, action flag, register number
+	if (cszArg < 3) {
+		return fFalse;
+	}
+	
+	/* The first parameter is the action to perform. Copy the
+	** the first parameter into the action string.
+	*/
+	StrcpyS(szAction, cchSzLen, rgszArg[1]);
+
+	if(strcmp(szAction, "-g") == 0) {
+		fGetReg = fTrue;
+	}
+	else if( strcmp(szAction, "-p") == 0) {
+		fPutReg = fTrue;
+	}
+	else if( strcmp(szAction, "-s") == 0) {
+		fGetRegRepeat = fTrue;
+	}
+	else if( strcmp(szAction, "-l") == 0) {
+		fPutRegRepeat = fTrue;
+	}
+	else if( strcmp(szAction, "--tune") == 0) {
+		fTune = fTrue;
+	}
+	else if( strcmp(szAction, "-scan") == 0) {
+		fScan = fTrue;
+	}
+	else if( strcmp(szAction, "--soak") == 0) {
+		fSoak = fTrue;
+	}
+	else { // unrecognized action
+		return fFalse;
+	}
+
+	/* Second paramater is target register on device. Copy second
+	** paramater to the register string */
+	StrcpyS(szRegister, cchSzLen, rgszArg[2]);
+
+
+	/* Parse the command line parameters.
+	*/
+	iszArg = 3;
+	while(iszArg < cszArg) {
+	
+		/* Check for the -d parameter which is used to specify
+		** the device name of the device to query.
+		*/
+		if (strcmp(rgszArg[iszArg], "-d") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szDvc, cchSzLen, rgszArg[iszArg++]);
+			fDvc = fTrue;
+			fMulti = (strchr(szDvc, ',') != NULL);
+		}
+		
+		/* Check for the -f parameter used to specify the
+		** input/output file name.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-f") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szFile, cchSnMax, rgszArg[iszArg++]);
+			fFile = fTrue;
+		}
+		
+		/* Check for the -c parameter used to specify the
+		** number of bytes to read/write from file.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-c") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szCount, cchUsrNameMax, rgszArg[iszArg++]);
+			fCount = fTrue;
+		}
+
+		/* Check for the -b paramater used to specify the 
+		** value of a single data byte to be written to the register 
+		*/
+		else if (strcmp(rgszArg[iszArg], "-b") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szByte, cchUsrNameMax, rgszArg[iszArg++]);
+			fByte = fTrue;
+		}
+		
+		/* Check for the -o parameter used to request an overlapped
+		** streaming capture through the specified number of buffers.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-o") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szStream, cchUsrNameMax, rgszArg[iszArg++]);
+			fStream = fTrue;
+		}
+
+		/* Check for the -k parameter used to specify the block size
+		** of repeat transfers instead of the tuned size.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-k") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szBlock, cchUsrNameMax, rgszArg[iszArg++]);
+			fBlock = fTrue;
+		}
+
+		/* Check for the -m parameter used to request that the file
+		** be memory mapped instead of read or written with stdio.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-m") == 0) {
+			iszArg += 1;
+			fMap = fTrue;
+		}
+
+		/* Check for the -hz parameter used to specify the number of
+		** scans per second of the -scan action.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-hz") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szRate, cchUsrNameMax, rgszArg[iszArg++]);
+			fRate = fTrue;
+		}
+
+		/* Check for the -delta parameter used to request that only
+		** scans that changed a register are published.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-delta") == 0) {
+			iszArg += 1;
+			fDelta = fTrue;
+		}
+
+		/* Check for the -prbs parameter used to specify the order of
+		** the sequence sent by the --soak action.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-prbs") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szPrbs, cchUsrNameMax, rgszArg[iszArg++]);
+			fPrbs = fTrue;
+		}
+
+		/* Check for the -w parameter used to request that --tune
+		** measure writes instead of reads.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-w") == 0) {
+			iszArg += 1;
+			fTunePut = fTrue;
+		}
+
+		/* Check for the -tr parameter used to name a scratch register
+		** that may be measured if the device has not been tuned.
+		*/
+		else if (strcmp(rgszArg[iszArg], "-tr") == 0) {
+			iszArg += 1;
+			if (iszArg >= cszArg) {
+				return fFalse;
+			}
+			StrcpyS(szTuneReg, cchUsrNameMax, rgszArg[iszArg++]);
+			fTuneReg = fTrue;
+		}
+
+		/* Not a recognized parameter
+		*/
+		else {
+			return fFalse;
+		}			
+	} // End while
+
+	/* Input combination validity checks 
+	*/
+	if(!fDvc) {
+		printf("Error: No device specified\n");
+		return fFalse;
+	}
+	if( fPutReg && !fByte ) {
+		printf("Error: No byte value provided\n");
+		return fFalse;
+	}
+	if( (fGetRegRepeat || fPutRegRepeat) && !fFile ) {
+		printf("Error: No filename provided\n");
+		return fFalse;
+	}
+	if( fStream && !fGetRegRepeat ) {
+		printf("Error: -o is only valid with -s\n");
+		return fFalse;
+	}
+	if( fMap && !(fGetRegRepeat || fPutRegRepeat) ) {
+		printf("Error: -m is only valid with -s or -l\n");
+		return fFalse;
+	}
+	if( fMap && fStream ) {
+		printf("Error: -m and -o cannot be combined\n");
+		return fFalse;
+	}
+	if( fMulti && (!fGetRegRepeat || fStream || fMap || !fCount) ) {
+		printf("Error: a device list is only valid with -s and -c, without -o or -m\n");
+		return fFalse;
+	}
+	if( (fRate || fDelta) && !fScan ) {
+		printf("Error: -hz and -delta are only valid with -scan\n");
+		return fFalse;
+	}
+	if( fTunePut && !fTune ) {
+		printf("Error: -w is only valid with --tune\n");
+		return fFalse;
+	}
+	if( fTuneReg && !(fGetRegRepeat || fPutRegRepeat) ) {
+		printf("Error: -tr is only valid with -s or -l\n");
+		return fFalse;
+	}
+	if( fPrbs && !fSoak ) {
+		printf("Error: -prbs is only valid with --soak\n");
+		return fFalse;
+	}
+	if( fMulti && fSoak ) {
+		printf("Error: --soak takes a single device\n");
+		return fFalse;
+	}
+		
+	return fTrue;
+	
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
 **
 **	Synopsis
 **		VOID ShowUsage(sz)
@@ -552,17 +2379,40 @@ void ShowUsage(char * szProgName) {
 
 	printf("\nDigilent DEPP demo\n");
 	printf("Usage: %s <action> <register> -d <device name> [options]\n", szProgName);
+	printf("       %s -s <register> -d <device>,<device>[,...] -f <file> -c <# bytes> [-k <# bytes>]\n", szProgName);
 
 	printf("\n\tActions:\n");
 	printf("\t-g\t\t\t\tGet register byte\n");
 	printf("\t-p\t\t\t\tPut Register byte\n");
 	printf("\t-l\t\t\t\tStream file into register\n");
 	printf("\t-s\t\t\t\tStream register into file\n");
+	printf("\t--tune\t\t\t\tMeasure and store best block size\n");
+	printf("\t-scan\t\t\t\tPoll a list of registers, such as 0-7,8\n");
+	printf("\t--soak\t\t\t\tWrite a PRBS through a list of read/write\n");
+	printf("\t\t\t\t\tregisters, such as 0-7, and check it\n");
+
+	printf("\n\tDevices may be given by name or serial number. With a list of\n");
+	printf("\tdevices, -s streams every device on its own thread into its own\n");
+	printf("\tfile, named after the device.\n");
 
 	printf("\n\tOptions:\n");
 	printf("\t-f <filename>\t\t\tSpecify file name\n");
-	printf("\t-c <# bytes>\t\t\tNumber of bytes to read/write\n");
+	printf("\t-c <# bytes>\t\t\tNumber of bytes to read/write (number of\n");
+	printf("\t\t\t\t\tscans for -scan)\n");
 	printf("\t-b <byte>\t\t\tValue to load into register\n");
+	printf("\t-o <# buffers>\t\t\tStream register into file using overlapped\n");
+	printf("\t\t\t\t\ttransfers and a writer thread (-s only)\n");
+	printf("\t-k <# bytes>\t\t\tBlock size of -l/-s transfers (default:\n");
+	printf("\t\t\t\t\ttuned for the device, else %d)\n", cbBlockSize);
+	printf("\t-m\t\t\t\tTransfer directly to/from a memory mapped\n");
+	printf("\t\t\t\t\tfile (-s or -l)\n");
+	printf("\t-hz <scans per second>\t\tScan rate (-scan only, default: as fast\n");
+	printf("\t\t\t\t\tas possible)\n");
+	printf("\t-delta\t\t\t\tPublish only scans that changed (-scan only)\n");
+	printf("\t-prbs <7|15|31>\t\t\tPRBS order (--soak only, default %d)\n", nPrbsDef);
+	printf("\t-w\t\t\t\tMeasure writes instead of reads (--tune only)\n");
+	printf("\t-tr <register>\t\t\tScratch register measured if the device\n");
+	printf("\t\t\t\t\thas not been tuned (-s or -l)\n");
 
 	printf("\n\n");
 }
@@ -603,6 +2453,30 @@ void ErrorExit() {
 	exit(1);
 }
 
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time data transfers.
+*/
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
 /* ------------------------------------------------------------ */
 /***	StrcpyS
 **
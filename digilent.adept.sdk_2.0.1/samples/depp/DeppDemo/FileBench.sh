@@ -0,0 +1,67 @@
+#!/bin/bash
+
+###########################################################################
+#                                                                         #
+#  FileBench.sh -- DEPP Demo File Transfer Benchmark                      #
+#                                                                         #
+###########################################################################
+#  Author: Digilent Inc.                                                  #
+#  Copyright 2026 Digilent Inc.                                           #
+###########################################################################
+#  File Description:                                                      #
+#                                                                         #
+#  This script compares the stdio and memory mapped file paths of the     #
+#  DeppDemo -l and -s actions. Each transfer is run several times and     #
+#  the rate reported by DeppDemo is printed for each run. By default the  #
+#  transfers are run against the Adept simulator in samples/sim/AdeptSim, #
+#  which must have been built first.                                      #
+#                                                                         #
+#  Usage: FileBench.sh [device name] [# bytes] [# runs]                   #
+#                                                                         #
+#  Set ADEPT_LIBDIR to run against a different set of libraries, for      #
+#  example ADEPT_LIBDIR=/usr/local/lib/digilent/adept to use a board.     #
+#                                                                         #
+###########################################################################
+#  Revision History:                                                      #
+#                                                                         #
+#  10/17/2026: created                                                    #
+#                                                                         #
+###########################################################################
+
+szDvc="${1:-SimEpp}"
+cb="${2:-100000000}"
+crun="${3:-3}"
+
+# Register 15 returns a counter in the simulated DpimRef design. Register 0
+# simply holds the last value written.
+regGet=15
+regPut=0
+
+libdir="${ADEPT_LIBDIR:-$(dirname "$0")/../../sim/AdeptSim}"
+demo="$(dirname "$0")/DeppDemo"
+file="deppbench.bin"
+
+if [ ! -x "${demo}" ]
+then
+	echo "error: build DeppDemo before running the benchmark"
+	exit 1
+fi
+
+# Run one transfer and print the rate reported by DeppDemo.
+run()
+{
+	LD_LIBRARY_PATH="${libdir}" "${demo}" "$@" -d "${szDvc}" -f "${file}" -c "${cb}" \
+		| grep "bytes in"
+}
+
+echo "Device ${szDvc}, ${cb} bytes, ${crun} runs"
+
+for (( irun = 0; irun < crun; irun++ ))
+do
+	echo "-s stdio:  $(run -s ${regGet})"
+	echo "-s mmap:   $(run -s ${regGet} -m)"
+	echo "-l stdio:  $(run -l ${regPut})"
+	echo "-l mmap:   $(run -l ${regPut} -m)"
+done
+
+rm -f "${file}"
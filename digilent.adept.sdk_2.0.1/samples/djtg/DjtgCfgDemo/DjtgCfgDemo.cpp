@@ -0,0 +1,595 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgCfgDemo.cpp  --  Xilinx FPGA Configuration Demo and Benchmark	*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		DjtgCfgDemo configures a Xilinx FPGA of a JTAG scan chain		*/
+/*		from a .bit file with the DjtgCfg engine and reports how long	*/
+/*		it took, the bitstream throughput and how much of the TCK		*/
+/*		frequency set with DjtgSetSpeed the bitstream used. The			*/
+/*		bitstream can be sent with overlapped calls, with blocking		*/
+/*		calls, or both ways one after the other for comparison.			*/
+/*																		*/
+/*		For runs without a design, -g writes a .bit file of the given	*/
+/*		size for the part found in the chain. Its bitstream is not a	*/
+/*		valid configuration and only serves to time the transfer.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: TCK use shown as n/a when the link outruns TCK			*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "djtg.h"
+#include "dmgr.h"
+#include "DjtgSeq.h"
+#include "DjtgChain.h"
+#include "JtscIndex.h"
+#include "DjtgCfg.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+typedef enum {
+	modeOverlap = 0,
+	modeBlocking,
+	modeBoth
+} MODE;
+
+const DWORD		idvcNone		= 0xFFFFFFFF;
+const DWORD		cbGenMax		= 0x7FFFFFFF;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+char		szDvc[cchDvcNameMax];
+char *		szBit = NULL;
+char *		szList = NULL;
+DWORD		idvcCfg = idvcNone;
+DWORD		frqTck = 0;
+DWORD		cbChunk = 0;
+DWORD		cbGen = 0;
+DWORD		fcfgOpt = 0;
+MODE		mode = modeOverlap;
+
+HIF			hif = hifInvalid;
+DjtgSeq		seq;
+JTGCHAIN	chain;
+JtscIndex	jsc;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+DWORD	IdvcFindFpga();
+BOOL	FWriteTestBit(const char * szFile, const char * szDevice, DWORD cbData);
+BOOL	FShowHeader();
+BOOL	FRunCfg(DWORD fcfg, CFGSTAT * pstat);
+void	ErrorExit();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		DjtgCfgDemo main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	JSCID		id;
+	CFGSTAT		rgstat[2];
+	char		szTckUse[16];
+	DWORD		frqSet;
+	DWORD		idvc;
+	int			imode;
+	int			imodeFirst;
+	int			imodeLast;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	if (!jsc.FInit(szList, 0)) {
+		printf("Cannot read the device list %s\n", (szList != NULL) ? szList : "of the Runtime data directory");
+		return 1;
+	}
+
+	// DMGR API Call: DmgrOpen
+	if (!DmgrOpen(&hif, szDvc)) {
+		printf("DmgrOpen failed (check the device name you provided)\n");
+		ErrorExit();
+	}
+
+	// DJTG API Call: DjtgEnable
+	if (!DjtgEnable(hif)) {
+		printf("DjtgEnable failed\n");
+		ErrorExit();
+	}
+
+	if (frqTck != 0) {
+		// DJTG API Call: DjtgSetSpeed
+		if (!DjtgSetSpeed(hif, frqTck, &frqSet)) {
+			printf("DjtgSetSpeed failed\n");
+			ErrorExit();
+		}
+	}
+
+	if (!seq.FInit(hif, 0) || !FDjtgChainScan(&seq, &chain)) {
+		printf("Cannot scan the JTAG chain\n");
+		ErrorExit();
+	}
+
+	if (idvcCfg == idvcNone) {
+		idvcCfg = IdvcFindFpga();
+	}
+
+	printf("scan chain, TDI to TDO:\n");
+	for (idvc = 0; idvc < chain.cdvc; idvc++) {
+		jsc.FIdentify(chain.rgdvc[idvc].idcode, &id);
+		printf("  %2lu: 0x%08x %-14s %s\n", (unsigned long) idvc,
+			(unsigned int) chain.rgdvc[idvc].idcode,
+			(id.szDevice != NULL) ? id.szDevice : ((id.szFamily != NULL) ? id.szFamily : "?"),
+			(idvc == idvcCfg) ? "<- configured" : "");
+	}
+
+	if (idvcCfg >= chain.cdvc) {
+		printf("No FPGA to configure in the chain\n");
+		ErrorExit();
+	}
+
+	if (cbGen != 0) {
+		jsc.FIdentify(chain.rgdvc[idvcCfg].idcode, &id);
+		if ((id.szDevice == NULL) || !FWriteTestBit(szBit, id.szDevice, cbGen)) {
+			printf("Cannot write the test bitstream %s\n", szBit);
+			ErrorExit();
+		}
+		printf("\nwrote %lu byte test bitstream %s\n", (unsigned long) cbGen, szBit);
+	}
+
+	if (!FShowHeader()) {
+		printf("%s is not a .bit file\n", szBit);
+		ErrorExit();
+	}
+
+	imodeFirst = (mode == modeBlocking) ? modeBlocking : modeOverlap;
+	imodeLast = (mode == modeOverlap) ? modeOverlap : modeBlocking;
+
+	printf("\n%-9s %9s %9s %9s %9s %9s %8s %7s %7s\n",
+		"mode", "seconds", "stream s", "prepare s", "wait s", "wire s", "MB/s", "TCK use", "calls");
+
+	for (imode = imodeFirst; imode <= imodeLast; imode++) {
+		if (!FRunCfg(fcfgOpt | ((imode == modeBlocking) ? fcfgNoOverlap : 0), &rgstat[imode])) {
+			ErrorExit();
+		}
+
+		/* The TCK use means nothing if the link is faster than TCK,
+		** as the untimed simulator is.
+		*/
+		if (rgstat[imode].dblWireSec > rgstat[imode].dblStreamSec) {
+			snprintf(szTckUse, sizeof(szTckUse), "n/a");
+		}
+		else {
+			snprintf(szTckUse, sizeof(szTckUse), "%.1f%%", 100 * rgstat[imode].dblTckUse);
+		}
+
+		printf("%-9s %9.3f %9.3f %9.3f %9.3f %9.3f %8.3f %7s %7lu\n",
+			(imode == modeOverlap) ? "overlap" : "blocking",
+			rgstat[imode].dblSec, rgstat[imode].dblStreamSec, rgstat[imode].dblPrepSec,
+			rgstat[imode].dblWaitSec, rgstat[imode].dblWireSec, rgstat[imode].dblMBps,
+			szTckUse, (unsigned long) rgstat[imode].ccall);
+	}
+
+	printf("\nTCK %lu Hz, %lu bitstream bytes in %lu chunks, %lu pad bits\n",
+		(unsigned long) rgstat[imodeLast].frqTck, (unsigned long) rgstat[imodeLast].cbData,
+		(unsigned long) rgstat[imodeLast].cchunk, (unsigned long) rgstat[imodeLast].cbitPad);
+
+	if (mode == modeBoth) {
+		printf("overlap configures %.2fx as fast as blocking\n",
+			rgstat[modeBlocking].dblSec / rgstat[modeOverlap].dblSec);
+	}
+
+	DjtgChainFree(&chain);
+	seq.Free();
+	jsc.Free();
+
+	// DJTG API Call: DjtgDisable
+	DjtgDisable(hif);
+
+	// DMGR API Call: DmgrClose
+	DmgrClose(hif);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	FRunCfg
+**
+**	Parameters:
+**		fcfg		- options of the engine
+**		pstat		- variable to receive the statistics
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		Prints why the configuration failed.
+**
+**	Description:
+**		Configures the device once with a new DjtgCfg.
+*/
+
+BOOL FRunCfg(DWORD fcfg, CFGSTAT * pstat) {
+
+	DjtgCfg		cfg;
+	BOOL		fOk;
+
+	if (!cfg.FInit(hif, &seq, cbChunk, fcfg) || !cfg.FOpen(szBit)) {
+		printf("%s: %s\n", szBit, DjtgCfg::SzErr(cfg.ErrLast()));
+		cfg.Free();
+		return fFalse;
+	}
+
+	fOk = cfg.FProgram(&chain, idvcCfg, &jsc);
+	cfg.GetStat(pstat);
+
+	if (!fOk) {
+		printf("Configuration failed: %s", DjtgCfg::SzErr(cfg.ErrLast()));
+		if (cfg.ErrLast() == errCfgJtag) {
+			printf(" (error %d)", (int) pstat->erc);
+		}
+		printf("\n");
+	}
+
+	cfg.Free();
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	FShowHeader
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the file has a .bit header, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Prints the header of the .bit file.
+*/
+
+BOOL FShowHeader() {
+
+	BITHDR	hdr;
+	BYTE	rgb[4096];
+	DWORD	cb;
+	FILE *	fp;
+
+	fp = fopen(szBit, "rb");
+	if (fp == NULL) {
+		return fFalse;
+	}
+	cb = (DWORD) fread(rgb, 1, sizeof(rgb), fp);
+	fclose(fp);
+
+	if (!FBitParseHeader(rgb, cb, &hdr)) {
+		return fFalse;
+	}
+
+	printf("\n%s: design %s, part %s, %s %s, %lu bytes of bitstream\n", szBit,
+		hdr.szDesign, hdr.szPart, hdr.szDate, hdr.szTime, (unsigned long) hdr.cbData);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	IdvcFindFpga
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		first device of the chain that can be configured, idvcNone
+**		if there is none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks for an FPGA whose family has the CFG_IN command.
+*/
+
+DWORD IdvcFindFpga() {
+
+	JSCID	id;
+	DWORD	idvc;
+	DWORD	dwOpcode;
+
+	for (idvc = 0; idvc < chain.cdvc; idvc++) {
+		if (jsc.FIdentify(chain.rgdvc[idvc].idcode, &id) && (id.ifam != ijscNone) &&
+			(id.szType != NULL) && (strcmp(id.szType, "FPGA") == 0) &&
+			jsc.FGetCommand(id.ifam, "CFG_IN", &dwOpcode)) {
+			return idvc;
+		}
+	}
+
+	return idvcNone;
+}
+
+/* ------------------------------------------------------------ */
+/***	FWriteTestBit
+**
+**	Parameters:
+**		szFile		- path of the file to write
+**		szDevice	- device name, such as XC3S500E
+**		cbData		- bytes of bitstream
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes a .bit file for the device whose bitstream is the dummy
+**		word and the sync word of a Xilinx bitstream followed by
+**		pseudo random bytes.
+*/
+
+BOOL FWriteTestBit(const char * szFile, const char * szDevice, DWORD cbData) {
+
+	static const BYTE	rgbMagic[] = {
+		0x00, 0x09, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01
+	};
+	static const BYTE	rgbSync[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xAA, 0x99, 0x55, 0x66 };
+
+	const char *	rgszField[4];
+	char			szPart[cchBitFieldMax];
+	BYTE			rgb[4096];
+	FILE *			fp;
+	DWORD			ich;
+	DWORD			cch;
+	DWORD			ifld;
+	DWORD			ib;
+	DWORD			cb;
+	DWORD			dwRand;
+	BOOL			fOk;
+
+	if (strncmp(szDevice, "XC", 2) == 0) {
+		szDevice += 2;
+	}
+	for (ich = 0; (szDevice[ich] != '\0') && (ich < cchBitFieldMax - 1); ich++) {
+		szPart[ich] = (char) tolower((unsigned char) szDevice[ich]);
+	}
+	szPart[ich] = '\0';
+
+	rgszField[0] = "DjtgCfgDemo.ncd;UserID=0xFFFFFFFF";
+	rgszField[1] = szPart;
+	rgszField[2] = "2026/10/17";
+	rgszField[3] = "12:00:00";
+
+	fp = fopen(szFile, "wb");
+	if (fp == NULL) {
+		return fFalse;
+	}
+
+	fOk = (fwrite(rgbMagic, 1, sizeof(rgbMagic), fp) == sizeof(rgbMagic));
+	for (ifld = 0; fOk && (ifld < 4); ifld++) {
+		cch = (DWORD) strlen(rgszField[ifld]) + 1;
+		rgb[0] = (BYTE) ('a' + ifld);
+		rgb[1] = (BYTE) (cch >> 8);
+		rgb[2] = (BYTE) cch;
+		fOk = (fwrite(rgb, 1, 3, fp) == 3) && (fwrite(rgszField[ifld], 1, cch, fp) == cch);
+	}
+
+	rgb[0] = 'e';
+	rgb[1] = (BYTE) (cbData >> 24);
+	rgb[2] = (BYTE) (cbData >> 16);
+	rgb[3] = (BYTE) (cbData >> 8);
+	rgb[4] = (BYTE) cbData;
+	fOk = fOk && (fwrite(rgb, 1, 5, fp) == 5);
+
+	dwRand = 0x12345678;
+	for (ib = 0; fOk && (ib < cbData); ib += cb) {
+		cb = (cbData - ib < sizeof(rgb)) ? cbData - ib : sizeof(rgb);
+		for (ich = 0; ich < cb; ich++) {
+			if (ib + ich < sizeof(rgbSync)) {
+				rgb[ich] = rgbSync[ib + ich];
+			}
+			else {
+				dwRand = dwRand * 1664525 + 1013904223;
+				rgb[ich] = (BYTE) (dwRand >> 24);
+			}
+		}
+		fOk = (fwrite(rgb, 1, cb, fp) == cb);
+	}
+
+	return (fclose(fp) == 0) && fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the parameters are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	BOOL	fDvc = fFalse;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-f") == 0) && (iszArg + 1 < cszArg)) {
+			szBit = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-l") == 0) && (iszArg + 1 < cszArg)) {
+			szList = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-i") == 0) && (iszArg + 1 < cszArg)) {
+			idvcCfg = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-s") == 0) && (iszArg + 1 < cszArg)) {
+			frqTck = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (frqTck == 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-c") == 0) && (iszArg + 1 < cszArg)) {
+			cbChunk = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cbChunk < cbCfgChunkMin) || (cbChunk > cbCfgChunkMax)) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-g") == 0) && (iszArg + 1 < cszArg)) {
+			cbGen = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cbGen == 0) || (cbGen > cbGenMax)) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-m") == 0) && (iszArg + 1 < cszArg)) {
+			iszArg++;
+			if (strcmp(rgszArg[iszArg], "overlap") == 0) {
+				mode = modeOverlap;
+			}
+			else if (strcmp(rgszArg[iszArg], "blocking") == 0) {
+				mode = modeBlocking;
+			}
+			else if (strcmp(rgszArg[iszArg], "both") == 0) {
+				mode = modeBoth;
+			}
+			else {
+				return fFalse;
+			}
+		}
+		else if (strcmp(rgszArg[iszArg], "-x") == 0) {
+			fcfgOpt |= fcfgNoPartCheck;
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return fDvc && (szBit != NULL);
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper parameter usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s -d <device name> -f <file.bit> [-l <list>] [-i <device>]\n", szProgName);
+	printf("\t[-s <Hz>] [-c <bytes>] [-m overlap|blocking|both] [-g <bytes>] [-x]\n\n");
+	printf("\t-d <device name>\tDevice with a JTAG scan chain\n");
+	printf("\t-f <file.bit>\t\tBitstream to configure the FPGA with\n");
+	printf("\t-l <list>\t\tDevice list (default jtscdvclist.txt of the Runtime)\n");
+	printf("\t-i <device>\t\tDevice of the chain to configure, 0 next to TDI\n");
+	printf("\t\t\t\t(default the first FPGA)\n");
+	printf("\t-s <Hz>\t\t\tTCK frequency to set with DjtgSetSpeed\n");
+	printf("\t-c <bytes>\t\tBitstream bytes per DJTG call (default %lu)\n",
+		(unsigned long) cbCfgChunkDefault);
+	printf("\t-m <mode>\t\tSend the chunks overlapped (default), blocking,\n");
+	printf("\t\t\t\tor both ways one after the other\n");
+	printf("\t-g <bytes>\t\tFirst write a test bitstream of this size to the file\n");
+	printf("\t-x\t\t\tDo not check the part of the file against the device\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	ErrorExit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DJTG, closes the device and exits the program
+*/
+
+void ErrorExit() {
+
+	DjtgChainFree(&chain);
+	seq.Free();
+	jsc.Free();
+
+	if (hif != hifInvalid) {
+		// DJTG API Call: DjtgDisable
+		DjtgDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	exit(1);
+}
+
+/************************************************************************/
@@ -17,10 +17,15 @@
 /*		Basys2: 0x11c10093												*/
 /*				0xf5045093												*/
 /*																		*/
+/*		The chain is read with a single DJTG call, which also finds		*/
+/*		devices with BYPASS only and the instruction register			*/
+/*		lengths, for a chain of any length.								*/
+/*																		*/
 /************************************************************************/
 /*  Revision History:													*/
 /*																		*/
 /*	03/16/2010(AaronO): created											*/
+/*	10/17/2026: read the chain in one call with DjtgChain				*/
 /*																		*/
 /************************************************************************/
 
@@ -51,6 +56,8 @@
 #include "dpcdecl.h" 
 #include "djtg.h"
 #include "dmgr.h"
+#include "DjtgSeq.h"
+#include "DjtgChain.h"
 
 /* ------------------------------------------------------------ */
 /*				Local Type and Constant Definitions				*/
@@ -92,13 +99,10 @@ void ErrorExit();
 */
 
 int main(int cszArg, char* rgszArg[]) {
-	int i;
-	int cCodes = 0;
-	BYTE rgbSetup[] = {0xaa, 0x22, 0x00};
-	BYTE rgbTdo[4];
-
-	INT32 idcode;
-	INT32 rgIdcodes[16];
+	DWORD idvc;
+	DjtgSeq seq;
+	JTGCHAIN chain;
+	SEQSTAT stat;
 
 	/* Command checking */
 	if( cszArg < 3 ) {
@@ -122,37 +126,45 @@ int main(int cszArg, char* rgszArg[]) {
 		ErrorExit();
 	}
 
-	/* Put JTAG scan chain in SHIFT-DR state. RgbSetup contains TMS/TDI bit-pairs. */
-	// DJTG API Call: DgtgPutTmsTdiBits
-	if(!DjtgPutTmsTdiBits(hif, rgbSetup, NULL, 9, NULL)) {
-		printf("DjtgPutTmsTdiBits failed\n");
+	if(!seq.FInit(hif, 0)) {
+		printf("Error: could not create JTAG sequence\n");
 		ErrorExit();
 	}
 
-	/* Get IDCODES from device until we receive a value of 0x00000000 */
-	do {
-		
-		// DJTG API Call: DjtgGetTdoBits
-		if(!DjtgGetTdoBits(hif, 0, 0, rgbTdo, 32, NULL)) {
-			printf("Error: DjtgGetTdoBits failed\n");
-			ErrorExit();
-		}
-
-		// Convert array of bytes into 32-bit value
-		idcode = (rgbTdo[3] << 24) | (rgbTdo[2] << 16) | (rgbTdo[1] << 8) | (rgbTdo[0]);
+	/* Read the IDCODE/BYPASS registers and the instruction registers of
+	** the whole chain in one sequence, which is sent with a single
+	** DjtgPutTmsTdiBits call. See DjtgChain.h.
+	*/
+	if(!FDjtgChainScan(&seq, &chain)) {
+		printf("Error: could not find the JTAG scan chain\n");
+		seq.Free();
+		ErrorExit();
+	}
 
-		// Place the IDCODEs into an array for LIFO storage
-		rgIdcodes[cCodes] = idcode;
+	/* Show the devices in the order that they are connected on the device */
+	printf("Ordered JTAG scan chain (TDI to TDO), %d device(s):\n", (int)chain.cdvc);
+	for(idvc = 0; idvc < chain.cdvc; idvc++) {
+		if( chain.rgdvc[idvc].idcode != 0 ) {
+			printf("0x%08x", (unsigned int)chain.rgdvc[idvc].idcode);
+		}
+		else {
+			printf("BYPASS only");
+		}
 
-		cCodes++;
+		if( chain.rgdvc[idvc].cbitIr != 0 ) {
+			printf("    IR length %d\n", (int)chain.rgdvc[idvc].cbitIr);
+		}
+		else {
+			printf("    IR length unknown\n");
+		}
+	}
 
-	} while( idcode != 0 );
+	seq.GetStat(&stat);
+	printf("Total IR length %d, %d DJTG call(s), %d scan bit(s)\n",
+			(int)chain.cbitIrTotal, (int)stat.ccall, (int)chain.cbitScan);
 
-	/* Show the IDCODEs in the order that they are connected on the device */
-	printf("Ordered JTAG scan chain:\n");
-	for(i=cCodes-2; i >= 0; i--) {
-		printf("0x%08x\n", rgIdcodes[i]);
-	}
+	DjtgChainFree(&chain);
+	seq.Free();
 
 	// Disable Djtg and close device handle
 	if( hif != hifInvalid ) {
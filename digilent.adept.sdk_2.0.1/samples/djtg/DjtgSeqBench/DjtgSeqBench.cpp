@@ -0,0 +1,583 @@
+/************************************************************************/
+/*																		*/
+/*  DjtgSeqBench.cpp  --  JTAG Sequence Compiler Benchmark				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		DjtgSeqBench runs the inner loop of a programming flow, a		*/
+/*		page written with an instruction scan, a data scan and a wait	*/
+/*		in Run-Test/Idle, for a number of pages in three ways:			*/
+/*																		*/
+/*			direct	- each operation made with its own DjtgPutTmsBits,	*/
+/*					  DjtgPutTdiBits and DjtgClockTck calls				*/
+/*			page	- each page recorded by a DjtgSeq and sent with		*/
+/*					  one FExecute										*/
+/*			seq		- all pages recorded by a DjtgSeq and sent with		*/
+/*					  one FExecute										*/
+/*																		*/
+/*		The instruction scans shift ones, BYPASS for every device,		*/
+/*		so the pages can be sent to any chain. The TDO of every data	*/
+/*		scan is read back and must be the same in all three ways.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "djtg.h"
+#include "dmgr.h"
+#include "DjtgSeq.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+typedef enum {
+	modeDirect = 0,
+	modePage,
+	modeSeq,
+	modeMax
+} MODE;
+
+/* Result of one run.
+*/
+typedef struct tagBENCHRES {
+	DWORD	ccall;			// DJTG calls made
+	double	dblSec;
+} BENCHRES;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+char		szDvc[cchDvcNameMax];
+DWORD		cpage = 256;
+DWORD		cbitIr = 14;
+DWORD		cbitPage = 256;
+DWORD		cclkWait = 20;
+DWORD		frqTck = 0;
+
+HIF			hif = hifInvalid;
+DjtgSeq		seq;
+
+const char *	rgszMode[modeMax] = { "direct", "page", "seq" };
+
+/* Data shifted into each page, and the TDO read back from all pages
+** in each mode.
+*/
+BYTE *		rgbPage;
+BYTE *		rgbTdo[modeMax];
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+void	RunDirect(BENCHRES * pres);
+void	RunSeq(MODE mode, BENCHRES * pres);
+BOOL	FDirectTms(BYTE bTms, DWORD cbit);
+BOOL	FDirectShift(const BYTE * rgbTdi, BYTE * rgbRcv, DWORD cbit);
+BOOL	FRecordPage(DWORD ipage, DWORD * pibitTdo);
+double	DblTimeSec();
+void	ErrorExit();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		DjtgSeqBench main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	BENCHRES	res;
+	SEQSTAT		stat;
+	DWORD		cbPage;
+	DWORD		frqSet;
+	DWORD		ib;
+	double		dblDirect;
+	int			mode;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	// DMGR API Call: DmgrOpen
+	if (!DmgrOpen(&hif, szDvc)) {
+		printf("DmgrOpen failed (check the device name you provided)\n");
+		return 1;
+	}
+
+	// DJTG API Call: DjtgEnable
+	if (!DjtgEnable(hif)) {
+		printf("DjtgEnable failed\n");
+		ErrorExit();
+	}
+
+	if (frqTck != 0) {
+		// DJTG API Call: DjtgSetSpeed
+		if (!DjtgSetSpeed(hif, frqTck, &frqSet)) {
+			printf("DjtgSetSpeed failed\n");
+			ErrorExit();
+		}
+		printf("TCK %lu Hz\n", (unsigned long) frqSet);
+	}
+
+	if (!seq.FInit(hif, 0)) {
+		printf("Cannot initialize the sequence\n");
+		ErrorExit();
+	}
+
+	cbPage = (cbitPage + 7) / 8;
+	rgbPage = (BYTE *) malloc((size_t) cpage * cbPage);
+	for (mode = 0; mode < modeMax; mode++) {
+		rgbTdo[mode] = (BYTE *) calloc(cpage, cbPage);
+	}
+	for (ib = 0; ib < cpage * cbPage; ib++) {
+		rgbPage[ib] = (BYTE) (ib * 37 + (ib >> 8));
+	}
+
+	printf("%lu pages: %lu bit instruction, %lu bit data, %lu clocks of wait\n\n",
+		(unsigned long) cpage, (unsigned long) cbitIr, (unsigned long) cbitPage,
+		(unsigned long) cclkWait);
+	printf("%-7s %10s %10s %10s %11s %8s %6s\n",
+		"mode", "seconds", "pages/s", "calls", "calls/page", "speedup", "tdo");
+
+	dblDirect = 0;
+	for (mode = 0; mode < modeMax; mode++) {
+		if (mode == modeDirect) {
+			RunDirect(&res);
+			dblDirect = res.dblSec;
+		}
+		else {
+			RunSeq((MODE) mode, &res);
+		}
+
+		printf("%-7s %10.4f %10.0f %10lu %11.3f %7.2fx %6s\n",
+			rgszMode[mode], res.dblSec, cpage / res.dblSec, (unsigned long) res.ccall,
+			(double) res.ccall / cpage, dblDirect / res.dblSec,
+			(memcmp(rgbTdo[mode], rgbTdo[modeDirect], (size_t) cpage * cbPage) == 0) ? "ok" : "DIFF");
+	}
+
+	seq.GetStat(&stat);
+	printf("\nsequence: %lu executed, %lu scans, %lu moves, %llu clocks in %lu calls\n",
+		(unsigned long) stat.cprog, (unsigned long) stat.cscan, (unsigned long) stat.cmove,
+		stat.cclk, (unsigned long) stat.ccall);
+
+	seq.Free();
+	free(rgbPage);
+	for (mode = 0; mode < modeMax; mode++) {
+		free(rgbTdo[mode]);
+	}
+
+	// DJTG API Call: DjtgDisable
+	DjtgDisable(hif);
+
+	// DMGR API Call: DmgrClose
+	DmgrClose(hif);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	RunDirect
+**
+**	Parameters:
+**		pres		- variable to receive the result
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if a DJTG call fails.
+**
+**	Description:
+**		Writes the pages with a DJTG call for each state move, shift
+**		and wait, as a flow written against the DJTG API directly
+**		does. The chain is reset and left in Run-Test/Idle between
+**		operations.
+*/
+
+void RunDirect(BENCHRES * pres) {
+
+	DWORD	ipage;
+	DWORD	cbPage;
+	double	dblStart;
+	BOOL	fOk;
+
+	cbPage = (cbitPage + 7) / 8;
+	memset(pres, 0, sizeof(BENCHRES));
+
+	dblStart = DblTimeSec();
+
+	/* Five clocks of TMS high reset the chain, one low enters
+	** Run-Test/Idle.
+	*/
+	fOk = FDirectTms(0x1F, 6);
+	pres->ccall++;
+
+	for (ipage = 0; fOk && (ipage < cpage); ipage++) {
+
+		/* Instruction scan: Select-DR, Select-IR, Capture-IR,
+		** Shift-IR, then Update-IR and back to Run-Test/Idle.
+		*/
+		fOk = fOk && FDirectTms(0x03, 4);
+		fOk = fOk && FDirectShift(NULL, NULL, cbitIr);
+		fOk = fOk && FDirectTms(0x01, 2);
+
+		/* Data scan: Select-DR, Capture-DR, Shift-DR.
+		*/
+		fOk = fOk && FDirectTms(0x01, 3);
+		fOk = fOk && FDirectShift(rgbPage + ipage * cbPage, rgbTdo[modeDirect] + ipage * cbPage, cbitPage);
+		fOk = fOk && FDirectTms(0x01, 2);
+
+		// DJTG API Call: DjtgClockTck
+		fOk = fOk && DjtgClockTck(hif, fFalse, fFalse, cclkWait, fFalse);
+
+		pres->ccall += 9;
+	}
+
+	pres->dblSec = DblTimeSec() - dblStart;
+
+	if (!fOk) {
+		printf("Error: DJTG call failed\n");
+		ErrorExit();
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	RunSeq
+**
+**	Parameters:
+**		mode		- modePage or modeSeq
+**		pres		- variable to receive the result
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if the sequence cannot be recorded or sent.
+**
+**	Description:
+**		Writes the pages with the sequence compiler, executing the
+**		sequence after every page or once after all of them, and
+**		slices the TDO of each data scan out of the result.
+*/
+
+void RunSeq(MODE mode, BENCHRES * pres) {
+
+	SEQSTAT	statStart;
+	SEQSTAT	statEnd;
+	DWORD *	rgibitTdo;
+	DWORD	ipage;
+	DWORD	ipageFirst;
+	DWORD	cbPage;
+	double	dblStart;
+	BOOL	fOk;
+
+	cbPage = (cbitPage + 7) / 8;
+	memset(pres, 0, sizeof(BENCHRES));
+	rgibitTdo = (DWORD *) malloc(cpage * sizeof(DWORD));
+
+	seq.GetStat(&statStart);
+	dblStart = DblTimeSec();
+
+	fOk = seq.FReset();
+
+	ipageFirst = 0;
+	for (ipage = 0; fOk && (ipage < cpage); ipage++) {
+		fOk = FRecordPage(ipage, &rgibitTdo[ipage]);
+
+		if (fOk && ((mode == modePage) || (ipage == cpage - 1))) {
+			fOk = seq.FExecute();
+			for (; fOk && (ipageFirst <= ipage); ipageFirst++) {
+				fOk = seq.FGetTdo(rgibitTdo[ipageFirst], cbitPage, rgbTdo[mode] + ipageFirst * cbPage);
+			}
+		}
+	}
+
+	pres->dblSec = DblTimeSec() - dblStart;
+	seq.GetStat(&statEnd);
+	pres->ccall = statEnd.ccall - statStart.ccall;
+
+	free(rgibitTdo);
+
+	if (!fOk) {
+		printf("Error: sequence failed\n");
+		ErrorExit();
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FRecordPage
+**
+**	Parameters:
+**		ipage		- page number
+**		pibitTdo	- variable to receive the TDO offset of the page
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records the operations of one page.
+*/
+
+BOOL FRecordPage(DWORD ipage, DWORD * pibitTdo) {
+
+	return seq.FScanIr(NULL, cbitIr, NULL) &&
+		seq.FScanDr(rgbPage + ipage * ((cbitPage + 7) / 8), cbitPage, pibitTdo) &&
+		seq.FIdle(cclkWait);
+}
+
+/* ------------------------------------------------------------ */
+/***	FDirectTms
+**
+**	Parameters:
+**		bTms		- TMS bits, first in bit 0
+**		cbit		- number of clocks, at most 8
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Clocks TMS with TDI low.
+*/
+
+BOOL FDirectTms(BYTE bTms, DWORD cbit) {
+
+	// DJTG API Call: DjtgPutTmsBits
+	return DjtgPutTmsBits(hif, fFalse, &bTms, NULL, cbit, fFalse);
+}
+
+/* ------------------------------------------------------------ */
+/***	FDirectShift
+**
+**	Parameters:
+**		rgbTdi		- bits to shift in, or NULL for all ones
+**		rgbRcv		- buffer to receive the TDO bits, or NULL
+**		cbit		- number of bits, at least 2
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Shifts all bits but the last with TMS low and the last with
+**		TMS high, which leaves the shift state.
+*/
+
+BOOL FDirectShift(const BYTE * rgbTdi, BYTE * rgbRcv, DWORD cbit) {
+
+	BYTE *	rgbSnd;
+	BYTE	bLast;
+	BYTE	bRcv;
+	BOOL	fOk;
+
+	rgbSnd = (BYTE *) malloc((cbit + 7) / 8);
+	if (rgbTdi != NULL) {
+		memcpy(rgbSnd, rgbTdi, (cbit + 7) / 8);
+	}
+	else {
+		memset(rgbSnd, 0xFF, (cbit + 7) / 8);
+	}
+
+	bLast = (rgbSnd[(cbit - 1) / 8] >> ((cbit - 1) % 8)) & 1;
+
+	// DJTG API Call: DjtgPutTdiBits
+	fOk = DjtgPutTdiBits(hif, fFalse, rgbSnd, rgbRcv, cbit - 1, fFalse) &&
+		DjtgPutTdiBits(hif, fTrue, &bLast, &bRcv, 1, fFalse);
+
+	if (fOk && (rgbRcv != NULL)) {
+		rgbRcv[(cbit - 1) / 8] &= (BYTE) ~(1 << ((cbit - 1) % 8));
+		rgbRcv[(cbit - 1) / 8] |= (BYTE) ((bRcv & 1) << ((cbit - 1) % 8));
+	}
+
+	free(rgbSnd);
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the parameters are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	BOOL	fDvc = fFalse;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-n") == 0) && (iszArg + 1 < cszArg)) {
+			cpage = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cpage == 0) || (cpage > 1000000)) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-i") == 0) && (iszArg + 1 < cszArg)) {
+			cbitIr = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (cbitIr < 2) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-b") == 0) && (iszArg + 1 < cszArg)) {
+			cbitPage = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cbitPage < 2) || (cbitPage > 1048576)) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-w") == 0) && (iszArg + 1 < cszArg)) {
+			cclkWait = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-s") == 0) && (iszArg + 1 < cszArg)) {
+			frqTck = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (frqTck == 0) {
+				return fFalse;
+			}
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return fDvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper parameter usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s -d <device name> [-n <pages>] [-i <bits>] [-b <bits>]\n", szProgName);
+	printf("\t[-w <clocks>] [-s <Hz>]\n\n");
+	printf("\t-d <device name>\tDevice with a JTAG scan chain\n");
+	printf("\t-n <pages>\t\tPages to write (default 256)\n");
+	printf("\t-i <bits>\t\tTotal instruction register length (default 14)\n");
+	printf("\t-b <bits>\t\tData bits per page (default 256)\n");
+	printf("\t-w <clocks>\t\tRun-Test/Idle clocks after each page (default 20)\n");
+	printf("\t-s <Hz>\t\t\tTCK frequency to set with DjtgSetSpeed\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the runs.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ErrorExit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DJTG, closes the device and exits the program
+*/
+
+void ErrorExit() {
+
+	if (hif != hifInvalid) {
+		// DJTG API Call: DjtgDisable
+		DjtgDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	exit(1);
+}
+
+/************************************************************************/
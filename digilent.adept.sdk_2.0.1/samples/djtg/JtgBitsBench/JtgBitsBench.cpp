@@ -0,0 +1,566 @@
+/************************************************************************/
+/*																		*/
+/*  JtgBitsBench.cpp  --  JTAG Buffer Preparation Kernel Benchmark		*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		JtgBitsBench checks every kernel set of JtgBits the processor	*/
+/*		supports against bit at a time reference code, then times		*/
+/*		each one on a bitstream sized buffer:							*/
+/*																		*/
+/*			reverse		- bit reversal of the bitstream bytes			*/
+/*			interleave	- TMS and TDI bytes into bit pairs				*/
+/*			split		- bit pairs back into TMS and TDI bytes			*/
+/*																		*/
+/*		and compares the time taken by the kernels in use with the		*/
+/*		time the bitstream takes to shift at the TCK frequency given.	*/
+/*		No device is needed.											*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "JtgBits.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* The checks run every length up to cbCheckMax at every start offset
+** up to cbCheckOff, so each kernel's vector loop and its tail are
+** both exercised on unaligned buffers.
+*/
+const DWORD		cbCheckMax		= 160;
+const DWORD		cbCheckOff		= 4;
+const DWORD		cbCheckBuf		= cbCheckMax + cbCheckOff;
+
+const int		crunTime		= 3;
+
+/* Seconds a kernel set takes for each operation.
+*/
+typedef struct tagJBTIME {
+	double	dblReverse;
+	double	dblInterleave;
+	double	dblSplit;
+} JBTIME;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+DWORD		cbBench = 30000000;
+DWORD		frqTck = 30000000;
+
+DWORD		dwRand = 0x2545F491;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+BOOL	FCheckKernel(const JBKRN * pkrn);
+BOOL	FCheckNull();
+void	RefReverse(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb);
+void	RefInterleave(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb);
+void	TimeKernel(const JBKRN * pkrn, BYTE * rgbTms, BYTE * rgbTdi, BYTE * rgbPair, JBTIME * ptm);
+void	FillRand(BYTE * rgb, DWORD cb);
+double	DblTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		JtgBitsBench main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	JBKRN	krn;
+	JBTIME	tm;
+	JBTIME	tmCur;
+	BYTE *	rgbTms;
+	BYTE *	rgbTdi;
+	BYTE *	rgbPair;
+	DWORD	ikrn;
+	BOOL	fOk;
+	double	dblMB;
+	double	dblWire;
+	double	dblPrep;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	printf("kernels in use: %s\n\n", JtgBitsSzKernel());
+
+	fOk = fTrue;
+	for (ikrn = 0; FJtgBitsGetKernel(ikrn, &krn); ikrn++) {
+		if (FCheckKernel(&krn)) {
+			printf("check %-8s ok\n", krn.szName);
+		}
+		else {
+			fOk = fFalse;
+		}
+	}
+	if (FCheckNull()) {
+		printf("check %-8s ok\n", "NULL");
+	}
+	else {
+		fOk = fFalse;
+	}
+	if (!fOk) {
+		printf("\nThe kernels do not match the reference\n");
+		return 1;
+	}
+
+	rgbTms = (BYTE *) malloc(cbBench);
+	rgbTdi = (BYTE *) malloc(cbBench);
+	rgbPair = (BYTE *) malloc(2 * (size_t) cbBench);
+	if ((rgbTms == NULL) || (rgbTdi == NULL) || (rgbPair == NULL)) {
+		printf("Out of memory\n");
+		free(rgbTms);
+		free(rgbTdi);
+		free(rgbPair);
+		return 1;
+	}
+	FillRand(rgbTms, cbBench);
+	FillRand(rgbTdi, cbBench);
+
+	dblMB = cbBench / 1e6;
+	printf("\n%.1f MB, best of %d runs, MB/s of bitstream bytes\n\n", dblMB, crunTime);
+	printf("%-8s %12s %12s %12s\n", "kernels", "reverse", "interleave", "split");
+
+	memset(&tmCur, 0, sizeof(tmCur));
+	for (ikrn = 0; FJtgBitsGetKernel(ikrn, &krn); ikrn++) {
+		TimeKernel(&krn, rgbTms, rgbTdi, rgbPair, &tm);
+		printf("%-8s %12.0f %12.0f %12.0f\n", krn.szName,
+			dblMB / tm.dblReverse, dblMB / tm.dblInterleave, dblMB / tm.dblSplit);
+		if (strcmp(krn.szName, JtgBitsSzKernel()) == 0) {
+			tmCur = tm;
+		}
+	}
+
+	/* A bitstream is reversed before it is sent with DjtgPutTdiBits,
+	** or reversed and interleaved for DjtgPutTmsTdiBits.
+	*/
+	dblWire = 8.0 * cbBench / frqTck;
+	dblPrep = tmCur.dblReverse + tmCur.dblInterleave;
+	printf("\nshifting %.1f MB at %lu Hz: %.3f s\n", dblMB, (unsigned long) frqTck, dblWire);
+	printf("reversing and interleaving with %s: %.4f s, %.2f%% of the shift time\n",
+		JtgBitsSzKernel(), dblPrep, 100.0 * dblPrep / dblWire);
+
+	free(rgbTms);
+	free(rgbTdi);
+	free(rgbPair);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	FCheckKernel
+**
+**	Parameters:
+**		pkrn		- kernel set to check
+**
+**	Return Value:
+**		fTrue if the kernels match the reference, fFalse if not
+**
+**	Errors:
+**		Prints the first mismatch.
+**
+**	Description:
+**		Runs each kernel on every length and start offset and
+**		compares its output with the reference. The split kernel
+**		must give back the bytes that were interleaved, and the
+**		reverse kernel must also work in place.
+*/
+
+BOOL FCheckKernel(const JBKRN * pkrn) {
+
+	BYTE	rgbTms[cbCheckBuf];
+	BYTE	rgbTdi[cbCheckBuf];
+	BYTE	rgbOut[2 * cbCheckBuf];
+	BYTE	rgbRef[2 * cbCheckBuf];
+	BYTE	rgbTmsOut[cbCheckBuf];
+	BYTE	rgbTdiOut[cbCheckBuf];
+	DWORD	cb;
+	DWORD	ib;
+
+	for (cb = 0; cb <= cbCheckMax; cb++) {
+		for (ib = 0; ib < cbCheckOff; ib++) {
+			FillRand(rgbTms, cbCheckBuf);
+			FillRand(rgbTdi, cbCheckBuf);
+
+			RefReverse(rgbRef, rgbTms + ib, cb);
+			pkrn->pfnReverse(rgbOut + ib, rgbTms + ib, cb);
+			if (memcmp(rgbOut + ib, rgbRef, cb) != 0) {
+				printf("check %-8s reverse differs, %lu bytes at offset %lu\n",
+					pkrn->szName, (unsigned long) cb, (unsigned long) ib);
+				return fFalse;
+			}
+			memcpy(rgbOut, rgbTms, cbCheckBuf);
+			pkrn->pfnReverse(rgbOut + ib, rgbOut + ib, cb);
+			if (memcmp(rgbOut + ib, rgbRef, cb) != 0) {
+				printf("check %-8s reverse in place differs, %lu bytes at offset %lu\n",
+					pkrn->szName, (unsigned long) cb, (unsigned long) ib);
+				return fFalse;
+			}
+
+			RefInterleave(rgbRef, rgbTms + ib, rgbTdi + ib, cb);
+			pkrn->pfnInterleave(rgbOut + ib, rgbTms + ib, rgbTdi + ib, cb);
+			if (memcmp(rgbOut + ib, rgbRef, 2 * cb) != 0) {
+				printf("check %-8s interleave differs, %lu bytes at offset %lu\n",
+					pkrn->szName, (unsigned long) cb, (unsigned long) ib);
+				return fFalse;
+			}
+
+			pkrn->pfnDeinterleave(rgbTmsOut + ib, rgbTdiOut + ib, rgbRef, cb);
+			if ((memcmp(rgbTmsOut + ib, rgbTms + ib, cb) != 0) ||
+				(memcmp(rgbTdiOut + ib, rgbTdi + ib, cb) != 0)) {
+				printf("check %-8s split differs, %lu bytes at offset %lu\n",
+					pkrn->szName, (unsigned long) cb, (unsigned long) ib);
+				return fFalse;
+			}
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FCheckNull
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue if the NULL buffers are handled, fFalse if not
+**
+**	Errors:
+**		Prints the first mismatch.
+**
+**	Description:
+**		Checks that JtgBitsInterleave holds a NULL TMS or TDI low and
+**		that JtgBitsDeinterleave fills only the buffer given, on a
+**		length longer than the blocks these are handled in.
+*/
+
+BOOL FCheckNull() {
+
+	const DWORD	cb = 10000;
+	BYTE *		rgbTdi;
+	BYTE *		rgbZero;
+	BYTE *		rgbOut;
+	BYTE *		rgbRef;
+	BOOL		fOk;
+
+	rgbTdi = (BYTE *) malloc(cb);
+	rgbZero = (BYTE *) calloc(cb, 1);
+	rgbOut = (BYTE *) malloc(2 * cb);
+	rgbRef = (BYTE *) malloc(2 * cb);
+	FillRand(rgbTdi, cb);
+
+	RefInterleave(rgbRef, rgbZero, rgbTdi, cb);
+	JtgBitsInterleave(rgbOut, NULL, rgbTdi, cb);
+	fOk = (memcmp(rgbOut, rgbRef, 2 * cb) == 0);
+
+	JtgBitsDeinterleave(NULL, rgbOut, rgbRef, cb);
+	fOk = fOk && (memcmp(rgbOut, rgbTdi, cb) == 0);
+
+	RefInterleave(rgbRef, rgbTdi, rgbZero, cb);
+	JtgBitsInterleave(rgbOut, rgbTdi, NULL, cb);
+	fOk = fOk && (memcmp(rgbOut, rgbRef, 2 * cb) == 0);
+
+	JtgBitsDeinterleave(rgbOut, NULL, rgbRef, cb);
+	fOk = fOk && (memcmp(rgbOut, rgbTdi, cb) == 0);
+
+	if (!fOk) {
+		printf("check %-8s differs\n", "NULL");
+	}
+
+	free(rgbTdi);
+	free(rgbZero);
+	free(rgbOut);
+	free(rgbRef);
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	RefReverse
+**
+**	Parameters:
+**		rgbDst		- buffer to receive the reversed bytes
+**		rgbSrc		- bytes to reverse
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reverses the bits of each byte one bit at a time.
+*/
+
+void RefReverse(BYTE * rgbDst, const BYTE * rgbSrc, DWORD cb) {
+
+	DWORD	ib;
+	DWORD	ibit;
+
+	for (ib = 0; ib < cb; ib++) {
+		rgbDst[ib] = 0;
+		for (ibit = 0; ibit < 8; ibit++) {
+			if (rgbSrc[ib] & (1 << ibit)) {
+				rgbDst[ib] |= (BYTE) (0x80 >> ibit);
+			}
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	RefInterleave
+**
+**	Parameters:
+**		rgbPair		- buffer to receive 2 * cb bytes of bit pairs
+**		rgbTms		- cb bytes of TMS bits
+**		rgbTdi		- cb bytes of TDI bits
+**		cb			- number of bytes of TMS and of TDI
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes bit pairs one clock at a time, as the DJTG
+**		documentation describes them.
+*/
+
+void RefInterleave(BYTE * rgbPair, const BYTE * rgbTms, const BYTE * rgbTdi, DWORD cb) {
+
+	DWORD	iclk;
+
+	memset(rgbPair, 0, 2 * cb);
+	for (iclk = 0; iclk < 8 * cb; iclk++) {
+		if ((rgbTdi[iclk / 8] >> (iclk % 8)) & 1) {
+			rgbPair[iclk / 4] |= (BYTE) (1 << (2 * (iclk % 4)));
+		}
+		if ((rgbTms[iclk / 8] >> (iclk % 8)) & 1) {
+			rgbPair[iclk / 4] |= (BYTE) (2 << (2 * (iclk % 4)));
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	TimeKernel
+**
+**	Parameters:
+**		pkrn		- kernel set to time
+**		rgbTms		- cbBench bytes of TMS bits
+**		rgbTdi		- cbBench bytes of TDI bits
+**		rgbPair		- 2 * cbBench bytes for the pairs
+**		ptm			- variable to receive the best times
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Times each kernel on the whole buffer and keeps the best of
+**		crunTime runs. The reversal is in place, as DjtgCfg does it.
+*/
+
+void TimeKernel(const JBKRN * pkrn, BYTE * rgbTms, BYTE * rgbTdi, BYTE * rgbPair, JBTIME * ptm) {
+
+	double	dblStart;
+	double	dblSec;
+	int		irun;
+
+	ptm->dblReverse = 1e9;
+	ptm->dblInterleave = 1e9;
+	ptm->dblSplit = 1e9;
+
+	for (irun = 0; irun < crunTime; irun++) {
+		dblStart = DblTimeSec();
+		pkrn->pfnReverse(rgbTdi, rgbTdi, cbBench);
+		dblSec = DblTimeSec() - dblStart;
+		if (dblSec < ptm->dblReverse) {
+			ptm->dblReverse = dblSec;
+		}
+
+		dblStart = DblTimeSec();
+		pkrn->pfnInterleave(rgbPair, rgbTms, rgbTdi, cbBench);
+		dblSec = DblTimeSec() - dblStart;
+		if (dblSec < ptm->dblInterleave) {
+			ptm->dblInterleave = dblSec;
+		}
+
+		dblStart = DblTimeSec();
+		pkrn->pfnDeinterleave(rgbTms, rgbTdi, rgbPair, cbBench);
+		dblSec = DblTimeSec() - dblStart;
+		if (dblSec < ptm->dblSplit) {
+			ptm->dblSplit = dblSec;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FillRand
+**
+**	Parameters:
+**		rgb			- buffer to fill
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills a buffer from a xorshift generator, so every run
+**		checks the same bytes.
+*/
+
+void FillRand(BYTE * rgb, DWORD cb) {
+
+	DWORD	ib;
+
+	for (ib = 0; ib < cb; ib++) {
+		dwRand ^= dwRand << 13;
+		dwRand ^= dwRand >> 17;
+		dwRand ^= dwRand << 5;
+		rgb[ib] = (BYTE) (dwRand >> 24);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the parameters are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	DWORD	cMB;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-m") == 0) && (iszArg + 1 < cszArg)) {
+			cMB = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cMB == 0) || (cMB > 1024)) {
+				return fFalse;
+			}
+			cbBench = cMB * 1000000;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-s") == 0) && (iszArg + 1 < cszArg)) {
+			frqTck = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (frqTck == 0) {
+				return fFalse;
+			}
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper parameter usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s [-m <MB>] [-s <Hz>]\n\n", szProgName);
+	printf("\t-m <MB>\t\tBuffer size to time (default 30)\n");
+	printf("\t-s <Hz>\t\tTCK frequency to compare with (default 30000000)\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the kernels.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/************************************************************************/
@@ -0,0 +1,399 @@
+/************************************************************************/
+/*																		*/
+/*  JtscIndexDemo.cpp  --  JTAG Device List Index Demo					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		JtscIndexDemo loads the index of the JTAG device list of the	*/
+/*		Adept Runtime with a JtscIndex, compiling the list if the		*/
+/*		index is missing or older than the list, and reports the		*/
+/*		malformed entries of the list. It then identifies the devices	*/
+/*		of a scan chain, found with DjtgChain, or the IDCODEs given on	*/
+/*		the command line, and times the identification.					*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "djtg.h"
+#include "dmgr.h"
+#include "DjtgSeq.h"
+#include "DjtgChain.h"
+#include "JtscIndex.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+const DWORD		cidcodeMax		= 1024;
+
+/* IDCODEs identified when neither a device nor IDCODEs are given: a
+** chain of ten devices of the list, a device of a known family that
+** is not in the list, and a device of an unknown vendor.
+*/
+const DWORD		rgidcodeDefault[] = {
+	0x41c22093, 0xf5046093, 0x01414093, 0x04002093, 0x06e18093,
+	0x09604093, 0x05059093, 0x0480802b, 0x03334093, 0x0ffff0ff
+};
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+char		szDvc[cchDvcNameMax];
+char *		szList = NULL;
+DWORD		fjsc = 0;
+DWORD		crep = 100000;
+BOOL		fDvc = fFalse;
+
+DWORD		rgidcode[cidcodeMax];
+DWORD		cidcode = 0;
+
+HIF			hif = hifInvalid;
+JtscIndex	jsc;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+void	ReadChain();
+double	DblTimeSec();
+void	ErrorExit();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		JtscIndexDemo main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	JSCID			id;
+	const char *	szText;
+	DWORD			imsg;
+	DWORD			iline;
+	DWORD			iidcode;
+	DWORD			irep;
+	DWORD			dwOpcode;
+	DWORD			cerr;
+	DWORD			cfound;
+	BOOL			fError;
+	double			dblStart;
+	double			dblInit;
+	double			dblIdent;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	dblStart = DblTimeSec();
+	if (!jsc.FInit(szList, fjsc)) {
+		printf("Cannot read the device list %s\n", (szList != NULL) ? szList : "of the Runtime data directory");
+		return 1;
+	}
+	dblInit = DblTimeSec() - dblStart;
+
+	printf("index %s: %s in %.1f us\n", jsc.SzIndex(),
+		!jsc.FCompiled() ? "mapped" : (jsc.FWritten() ? "compiled and written" : "compiled, kept in memory"),
+		dblInit * 1e6);
+	printf("%lu bytes, %lu families, %lu devices, %lu hash tables\n\n",
+		(unsigned long) jsc.CbIndex(), (unsigned long) jsc.Cfam(), (unsigned long) jsc.Cdev(),
+		(unsigned long) jsc.Cgrp());
+
+	cerr = 0;
+	for (imsg = 0; jsc.FGetMsg(imsg, &iline, &fError, &szText); imsg++) {
+		printf("line %lu: %s: %s\n", (unsigned long) iline, fError ? "error" : "warning", szText);
+		if (fError) {
+			cerr++;
+		}
+	}
+	printf("%lu messages, %lu errors\n\n", (unsigned long) jsc.Cmsg(), (unsigned long) cerr);
+
+	if (fDvc) {
+		ReadChain();
+	}
+	else if (cidcode == 0) {
+		cidcode = sizeof(rgidcodeDefault) / sizeof(rgidcodeDefault[0]);
+		memcpy(rgidcode, rgidcodeDefault, sizeof(rgidcodeDefault));
+	}
+
+	printf("%-10s %-8s %-10s %-14s %-6s %5s %4s %8s\n",
+		"IDCODE", "vendor", "family", "device", "type", "IRLEN", "ALG", "CFG_IN");
+	for (iidcode = 0; iidcode < cidcode; iidcode++) {
+		jsc.FIdentify(rgidcode[iidcode], &id);
+		printf("0x%08x %-8s %-10s %-14s %-6s",
+			(unsigned int) id.idcode,
+			(id.szVendor != NULL) ? id.szVendor : "?",
+			(id.szFamily != NULL) ? id.szFamily : "?",
+			(id.szDevice != NULL) ? id.szDevice : "-",
+			(id.szType != NULL) ? id.szType : "");
+		if (id.ifam != ijscNone) {
+			printf(" %5lu %4lu", (unsigned long) id.cbitIr, (unsigned long) id.alg);
+			if (jsc.FGetCommand(id.ifam, "CFG_IN", &dwOpcode)) {
+				printf(" %7Xh", (unsigned int) dwOpcode);
+			}
+		}
+		printf("\n");
+	}
+
+	/* Time the identification of the whole chain.
+	*/
+	cfound = 0;
+	dblStart = DblTimeSec();
+	for (irep = 0; irep < crep; irep++) {
+		for (iidcode = 0; iidcode < cidcode; iidcode++) {
+			if (jsc.FIdentify(rgidcode[iidcode] ^ (irep & 0x0F000000), &id)) {
+				cfound++;
+			}
+		}
+	}
+	dblIdent = (DblTimeSec() - dblStart) / crep;
+
+	printf("\n%lu IDCODEs identified in %.3f us, %.1f ns each (%lu lookups found a family)\n",
+		(unsigned long) cidcode, dblIdent * 1e6, (cidcode != 0) ? dblIdent * 1e9 / cidcode : 0.0,
+		(unsigned long) cfound);
+
+	jsc.Free();
+
+	if (hif != hifInvalid) {
+		// DJTG API Call: DjtgDisable
+		DjtgDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	ReadChain
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if the chain cannot be read.
+**
+**	Description:
+**		Reads the IDCODEs of the chain of the device with DjtgChain,
+**		from TDI to TDO. Devices with BYPASS only are left out.
+*/
+
+void ReadChain() {
+
+	DjtgSeq		seq;
+	JTGCHAIN	chain;
+	DWORD		idvc;
+
+	// DMGR API Call: DmgrOpen
+	if (!DmgrOpen(&hif, szDvc)) {
+		printf("DmgrOpen failed (check the device name you provided)\n");
+		ErrorExit();
+	}
+
+	// DJTG API Call: DjtgEnable
+	if (!DjtgEnable(hif)) {
+		printf("DjtgEnable failed\n");
+		ErrorExit();
+	}
+
+	if (!seq.FInit(hif, 0) || !FDjtgChainScan(&seq, &chain)) {
+		printf("Cannot read the JTAG scan chain\n");
+		seq.Free();
+		ErrorExit();
+	}
+
+	for (idvc = 0; (idvc < chain.cdvc) && (cidcode < cidcodeMax); idvc++) {
+		if (chain.rgdvc[idvc].idcode != 0) {
+			rgidcode[cidcode++] = chain.rgdvc[idvc].idcode;
+		}
+	}
+
+	printf("%s: %lu devices, %lu with an IDCODE\n\n", szDvc, (unsigned long) chain.cdvc, (unsigned long) cidcode);
+
+	DjtgChainFree(&chain);
+	seq.Free();
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the parameters are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	char *	pchEnd;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-f") == 0) && (iszArg + 1 < cszArg)) {
+			szList = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-i") == 0) && (iszArg + 1 < cszArg)) {
+			if (cidcode >= cidcodeMax) {
+				return fFalse;
+			}
+			rgidcode[cidcode++] = (DWORD) strtoul(rgszArg[++iszArg], &pchEnd, 16);
+			if (*pchEnd != '\0') {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-n") == 0) && (iszArg + 1 < cszArg)) {
+			crep = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (crep == 0) {
+				return fFalse;
+			}
+		}
+		else if (strcmp(rgszArg[iszArg], "-r") == 0) {
+			fjsc |= fjscRebuild;
+		}
+		else if (strcmp(rgszArg[iszArg], "-m") == 0) {
+			fjsc |= fjscNoWrite;
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return !fDvc || (cidcode == 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper parameter usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s [-f <list>] [-r] [-m] [-d <device name> | -i <idcode> ...]\n", szProgName);
+	printf("\t[-n <repeats>]\n\n");
+	printf("\t-f <list>\t\tDevice list (default jtscdvclist.txt of the Runtime)\n");
+	printf("\t-r\t\t\tCompile the list even if the index is current\n");
+	printf("\t-m\t\t\tKeep the index in memory, do not write it\n");
+	printf("\t-d <device name>\tIdentify the JTAG scan chain of the device\n");
+	printf("\t-i <idcode>\t\tIdentify a hexadecimal IDCODE, may be repeated\n");
+	printf("\t-n <repeats>\t\tIdentifications of the chain timed (default 100000)\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the loading and the identification.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ErrorExit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DJTG, closes the device and exits the program
+*/
+
+void ErrorExit() {
+
+	if (hif != hifInvalid) {
+		// DJTG API Call: DjtgDisable
+		DjtgDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	jsc.Free();
+
+	exit(1);
+}
+
+/************************************************************************/
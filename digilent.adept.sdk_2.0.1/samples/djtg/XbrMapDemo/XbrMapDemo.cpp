@@ -0,0 +1,559 @@
+/************************************************************************/
+/*																		*/
+/*  XbrMapDemo.cpp  --  CoolRunner-II Fuse Map Demo						*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		XbrMapDemo loads the CoolRunner-II fuse maps of the Adept		*/
+/*		Runtime with an XbrMap, compiling each map if its table is		*/
+/*		missing or older than the map, and times parsing the text		*/
+/*		map against mapping the table. It then makes every row of		*/
+/*		each device from a random JEDEC fuse vector with each kernel	*/
+/*		the processor supports, checks the rows against rows made		*/
+/*		straight from the text map, and times the kernels.				*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "JtscIndex.h"
+#include "XbrMap.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+const DWORD		cmapMax			= 64;
+const DWORD		cchLineMax		= 8192;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+char *		szMapArg = NULL;
+char *		szDir = NULL;
+DWORD		fxbr = 0;
+DWORD		crep = 100;
+
+char *		rgszMap[cmapMax];
+DWORD		cmap = 0;
+
+DWORD		dwRand = 0x2545F491;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+BOOL	FListMaps(const char * szMapDir);
+int		CmpSz(const void * pv1, const void * pv2);
+BOOL	FRunMap(const char * szMap);
+BOOL	FRefRows(const char * szMap, DWORD cbitRow, DWORD crow, const BYTE * rgbFuse,
+			const XBRFILL * pfill, BYTE * rgbRows);
+DWORD	DwRand();
+double	DblTimeSec();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		XbrMapDemo main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	char	szDefault[cchXbrPathMax];
+	XBRKRN	krn;
+	DWORD	imap;
+	DWORD	ikrn;
+	BOOL	fOk;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	if (szMapArg != NULL) {
+		rgszMap[cmap++] = strdup(szMapArg);
+	}
+	else {
+		if (szDir == NULL) {
+			if (!FJscDataPath(szDefault, cchXbrPathMax - sizeof("/xbr"))) {
+				printf("Cannot find the Runtime data directory\n");
+				return 1;
+			}
+			strcat(szDefault, "/xbr");
+			szDir = szDefault;
+		}
+		if (!FListMaps(szDir)) {
+			printf("Cannot list the fuse maps of %s\n", szDir);
+			return 1;
+		}
+	}
+
+	printf("%-12s %5s %5s %5s %9s %9s %9s %-8s", "map", "rows", "bits", "entry",
+		"table KB", "text ms", "load ms", "loaded");
+	for (ikrn = 0; FXbrGetKernel(ikrn, &krn); ikrn++) {
+		printf(" %6s ms", krn.szName);
+	}
+	printf(" %5s\n", "rows");
+
+	fOk = fTrue;
+	for (imap = 0; imap < cmap; imap++) {
+		fOk = FRunMap(rgszMap[imap]) && fOk;
+		free(rgszMap[imap]);
+	}
+
+	printf("\nloaded: mapped, compiled and written, or compiled and kept in memory;\n");
+	printf("load ms: mapping the table once it is written\n");
+	printf("kernel ms: all rows of the device, the mean of %lu runs\n", (unsigned long) crep);
+
+	if (!fOk) {
+		printf("\nA map could not be loaded or its rows differ from the text map\n");
+		return 1;
+	}
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	FRunMap
+**
+**	Parameters:
+**		szMap		- path of the fuse map
+**
+**	Return Value:
+**		fTrue if the rows match the text map, fFalse if not
+**
+**	Errors:
+**		Prints why a map cannot be loaded.
+**
+**	Description:
+**		Times parsing the text map with FXbrCompile and loading it
+**		with FInit, makes all rows from a random fuse vector with each
+**		kernel set and compares them with the rows made from the text
+**		map by FRefRows.
+*/
+
+BOOL FRunMap(const char * szMap) {
+
+	XbrMap			xbr;
+	XBRKRN			krn;
+	XBRFILL			fill;
+	const char *	szName;
+	const char *	szLoaded;
+	BYTE *			pbTable;
+	size_t			cbTable;
+	BYTE *			rgbFuse;
+	BYTE *			rgbRows;
+	BYTE *			rgbRef;
+	size_t			cbRows;
+	DWORD			ilineErr;
+	DWORD			ib;
+	DWORD			ikrn;
+	DWORD			irep;
+	BOOL			fOk;
+	double			dblStart;
+	double			dblText;
+	double			dblLoad;
+
+	szName = strrchr(szMap, '/');
+	szName = (szName != NULL) ? szName + 1 : szMap;
+
+	dblStart = DblTimeSec();
+	if (!FXbrCompile(szMap, &pbTable, &cbTable, &ilineErr)) {
+		if (ilineErr != 0) {
+			printf("%-12s line %lu: a cell is not a fuse number or a marker\n",
+				szName, (unsigned long) ilineErr);
+		}
+		else {
+			printf("%-12s cannot be read\n", szName);
+		}
+		return fFalse;
+	}
+	dblText = DblTimeSec() - dblStart;
+	free(pbTable);
+
+	/* The first FInit may compile and write the table; the second
+	** then maps it, as every later run does.
+	*/
+	dblStart = DblTimeSec();
+	fOk = xbr.FInit(szMap, fxbr);
+	dblLoad = DblTimeSec() - dblStart;
+	szLoaded = !xbr.FCompiled() ? "mapped" : (xbr.FWritten() ? "written" : "memory");
+	if (fOk && xbr.FWritten()) {
+		dblStart = DblTimeSec();
+		fOk = xbr.FInit(szMap, fxbr & ~fxbrRebuild);
+		dblLoad = DblTimeSec() - dblStart;
+	}
+	if (!fOk) {
+		printf("%-12s cannot be loaded\n", szName);
+		return fFalse;
+	}
+
+	printf("%-12s %5lu %5lu %5lu %9.1f %9.3f %9.3f %-8s", szName, (unsigned long) xbr.Crow(),
+		(unsigned long) xbr.CbitRow(), (unsigned long) xbr.CbEntry(), xbr.CbTable() / 1024.0,
+		dblText * 1e3, dblLoad * 1e3, szLoaded);
+
+	/* Random fuses and marker values, so the markers are checked as
+	** well as the fuses.
+	*/
+	rgbFuse = (BYTE *) malloc(CbXbrFuse(xbr.Cfuse()));
+	for (ib = 0; ib < CbXbrFuse(xbr.Cfuse()); ib++) {
+		rgbFuse[ib] = (BYTE) DwRand();
+	}
+	fill.fNone = fTrue;
+	fill.fSpare = fFalse;
+	fill.dwSec = DwRand();
+	fill.dwDone = DwRand();
+	fill.dwUser = DwRand();
+
+	cbRows = (size_t) xbr.Crow() * xbr.CbRow();
+	rgbRows = (BYTE *) malloc(cbRows);
+	rgbRef = (BYTE *) malloc(cbRows);
+
+	fOk = FRefRows(szMap, xbr.CbitRow(), xbr.Crow(), rgbFuse, &fill, rgbRef);
+
+	for (ikrn = 0; FXbrGetKernel(ikrn, &krn); ikrn++) {
+		memset(rgbRows, 0xAA, cbRows);
+		fOk = xbr.FGatherRows(0, xbr.Crow(), rgbFuse, xbr.Cfuse(), &fill, rgbRows, &krn) && fOk;
+		fOk = fOk && (memcmp(rgbRows, rgbRef, cbRows) == 0);
+
+		dblStart = DblTimeSec();
+		for (irep = 0; irep < crep; irep++) {
+			xbr.FGatherRows(0, xbr.Crow(), rgbFuse, xbr.Cfuse(), &fill, rgbRows, &krn);
+		}
+		printf(" %9.3f", (DblTimeSec() - dblStart) * 1e3 / crep);
+	}
+	printf(" %5s\n", fOk ? "ok" : "DIFF");
+
+	xbr.Free();
+	free(rgbFuse);
+	free(rgbRows);
+	free(rgbRef);
+
+	return fOk;
+}
+
+/* ------------------------------------------------------------ */
+/***	FRefRows
+**
+**	Parameters:
+**		szMap		- path of the fuse map
+**		cbitRow		- bits of each row
+**		crow		- number of rows
+**		rgbFuse		- JEDEC fuse vector
+**		pfill		- values of the markers
+**		rgbRows		- buffer to receive the rows, (cbitRow + 7) / 8
+**					  bytes each
+**
+**	Return Value:
+**		fTrue if the map could be read, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Makes the rows straight from the text map, a cell at a time,
+**		without XbrMap, to check the tables and the kernels.
+*/
+
+BOOL FRefRows(const char * szMap, DWORD cbitRow, DWORD crow, const BYTE * rgbFuse,
+	const XBRFILL * pfill, BYTE * rgbRows) {
+
+	char *			szLine;
+	char *			pchCell;
+	char *			pchEnd;
+	FILE *			fp;
+	DWORD			cbRow;
+	DWORD			iline;
+	DWORD			icol;
+	DWORD			fBit;
+	unsigned long	n;
+
+	fp = fopen(szMap, "r");
+	if (fp == NULL) {
+		return fFalse;
+	}
+
+	szLine = (char *) malloc(cchLineMax);
+	cbRow = (cbitRow + 7) / 8;
+
+	/* Cells a line leaves out have no fuse, as do empty cells.
+	*/
+	memset(rgbRows, 0, (size_t) crow * cbRow);
+	for (icol = 0; icol < crow; icol++) {
+		for (iline = 0; iline < cbitRow; iline++) {
+			if (pfill->fNone) {
+				rgbRows[icol * cbRow + iline / 8] |= (BYTE) (1 << (iline % 8));
+			}
+		}
+	}
+
+	for (iline = 0; (iline < cbitRow) && (fgets(szLine, cchLineMax, fp) != NULL); iline++) {
+		szLine[strcspn(szLine, "\r\n")] = '\0';
+		pchCell = szLine;
+		for (icol = 0; icol < crow; icol++) {
+			pchEnd = strchr(pchCell, '\t');
+			if (pchEnd != NULL) {
+				*pchEnd = '\0';
+			}
+
+			if ((*pchCell >= '0') && (*pchCell <= '9')) {
+				n = strtoul(pchCell, NULL, 10);
+				fBit = (rgbFuse[n / 8] >> (n % 8)) & 1;
+			}
+			else if (strcmp(pchCell, "spare") == 0) {
+				fBit = pfill->fSpare;
+			}
+			else if (strncmp(pchCell, "sec_", 4) == 0) {
+				fBit = (pfill->dwSec >> atoi(pchCell + 4)) & 1;
+			}
+			else if (strncmp(pchCell, "done", 4) == 0) {
+				fBit = (pfill->dwDone >> atoi(pchCell + 5)) & 1;
+			}
+			else if ((strncmp(pchCell, "user", 4) == 0) && (pchCell[4] != '\0')) {
+				fBit = (pfill->dwUser >> atoi(pchCell + 5)) & 1;
+			}
+			else {
+				fBit = pfill->fNone;
+			}
+
+			rgbRows[icol * cbRow + iline / 8] &= (BYTE) ~(1 << (iline % 8));
+			rgbRows[icol * cbRow + iline / 8] |= (BYTE) (fBit << (iline % 8));
+
+			if (pchEnd == NULL) {
+				break;
+			}
+			pchCell = pchEnd + 1;
+		}
+	}
+
+	fclose(fp);
+	free(szLine);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FListMaps
+**
+**	Parameters:
+**		szMapDir	- directory of the fuse maps
+**
+**	Return Value:
+**		fTrue if the directory could be read, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Lists the .map files of the directory in order of name.
+*/
+
+BOOL FListMaps(const char * szMapDir) {
+
+	char			szPath[cchXbrPathMax];
+	DIR *			pdir;
+	struct dirent *	pent;
+	size_t			cch;
+
+	pdir = opendir(szMapDir);
+	if (pdir == NULL) {
+		return fFalse;
+	}
+
+	while (((pent = readdir(pdir)) != NULL) && (cmap < cmapMax)) {
+		cch = strlen(pent->d_name);
+		if ((cch > 4) && (strcmp(pent->d_name + cch - 4, ".map") == 0)) {
+			snprintf(szPath, sizeof(szPath), "%s/%s", szMapDir, pent->d_name);
+			rgszMap[cmap++] = strdup(szPath);
+		}
+	}
+	closedir(pdir);
+
+	qsort(rgszMap, cmap, sizeof(char *), CmpSz);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CmpSz
+**
+**	Parameters:
+**		pv1			- first string pointer
+**		pv2			- second string pointer
+**
+**	Return Value:
+**		order of the strings, as strcmp
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		qsort comparison of the map paths.
+*/
+
+int CmpSz(const void * pv1, const void * pv2) {
+
+	return strcmp(*(char * const *) pv1, *(char * const *) pv2);
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the parameters are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-f") == 0) && (iszArg + 1 < cszArg)) {
+			szMapArg = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-x") == 0) && (iszArg + 1 < cszArg)) {
+			szDir = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-n") == 0) && (iszArg + 1 < cszArg)) {
+			crep = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (crep == 0) {
+				return fFalse;
+			}
+		}
+		else if (strcmp(rgszArg[iszArg], "-r") == 0) {
+			fxbr |= fxbrRebuild;
+		}
+		else if (strcmp(rgszArg[iszArg], "-m") == 0) {
+			fxbr |= fxbrNoWrite;
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return (szMapArg == NULL) || (szDir == NULL);
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper parameter usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s [-f <map> | -x <directory>] [-r] [-m] [-n <repeats>]\n\n", szProgName);
+	printf("\t-f <map>\t\tFuse map to load, such as xc2c256.map\n");
+	printf("\t-x <directory>\t\tLoad every .map file of the directory (default\n");
+	printf("\t\t\t\tthe xbr directory of the Runtime data)\n");
+	printf("\t-r\t\t\tCompile the maps even if their tables are current\n");
+	printf("\t-m\t\t\tKeep the tables in memory, do not write them\n");
+	printf("\t-n <repeats>\t\tRuns of each kernel timed (default 100)\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DwRand
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		next value of a xorshift generator
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Every run checks the same fuses.
+*/
+
+DWORD DwRand() {
+
+	dwRand ^= dwRand << 13;
+	dwRand ^= dwRand >> 17;
+	dwRand ^= dwRand << 5;
+
+	return dwRand;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the maps and the kernels.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/************************************************************************/
@@ -14,6 +14,8 @@
 /*  Revision History:													*/
 /*																		*/
 /*	03/16/2010(AaronO): created											*/
+/*	10/17/2026: receive buffer comes from the shared buffer pool		*/
+/*	10/17/2026: shared buffer pool created once in main					*/
 /*																		*/
 /************************************************************************/
 
@@ -43,6 +45,7 @@
 #include "dpcdecl.h"
 #include "dmgr.h"
 #include "dspi.h"
+#include "BufPool.h"
 
 /* ------------------------------------------------------------ */
 /*				Local Type and Constant Definitions				*/
@@ -123,6 +126,13 @@ int main(int cszArg, char* rgszArg[]) {
 		printf("Error: DspiEnable failed\n");
 		ErrorExit();
 	}
+
+	/* Create the shared pool once for the process. It holds the
+	** receive buffer of -g, and is freed at exit.
+	*/
+	if( fGet ) {
+		BufPoolInitShared(atoi(szCount), 1, fpoolLock | fpoolZero);
+	}
 	
 
 	if( fPutByte ) {
@@ -139,6 +149,8 @@ int main(int cszArg, char* rgszArg[]) {
 		ShowUsage(rgszArg[0]);
 	}
 
+	BufPoolFreeShared();
+
 	if( hif != hifInvalid ) {
 		// DSPI API Call: DspiDisable
 		DspiDisable(hif);
@@ -247,7 +259,8 @@ void DoPut() {
 **
 **	Description:
 **		Gets bytes from SPI. Still requires filler bytes to be sent.
-**		Checks recieved data against fill byte.
+**		Checks recieved data against fill byte. The receive buffer is
+**		taken from the shared buffer pool, which zeroes it.
 */
 void DoGet() {
 
@@ -260,14 +273,17 @@ void DoGet() {
 	bFill = atoi(szByte);
 	cbRcv= atoi(szCount);
 
-	rgbRcv = (BYTE*) malloc(cbRcv);
-	memset(rgbRcv, 0, cbRcv);
+	rgbRcv = PbBufPoolAlloc(cbRcv);
+	if(rgbRcv == NULL) {
+		printf("Error: Cannot allocate %d byte buffer\n", cbRcv);
+		ErrorExit();
+	}
 
 
 	// DSPI API Call: DspiGet
 	if(!DspiGet(hif, fFalse, fFalse, bFill, rgbRcv, cbRcv, fFalse)) {
 		printf("Error: DspiGet failed\n");
-		free(rgbRcv);
+		BufPoolRelease(rgbRcv);
 		ErrorExit();	
 	}
 
@@ -286,7 +302,7 @@ void DoGet() {
 
 	
 
-	free(rgbRcv);
+	BufPoolRelease(rgbRcv);
 }
 
 /* ------------------------------------------------------------ */
@@ -466,10 +482,13 @@ void ShowUsage(char* szProgName) {
 **		none
 **
 **	Description:
-**		Disables Dspi, closes device, and exits the program
+**		Disables Dspi, closes device, frees the shared buffer pool and
+**		exits the program
 */
 
 void ErrorExit() {
+	BufPoolFreeShared();
+
 	if( hif != hifInvalid ) {
 		// DSPI API Call: DspiDisable
 		DspiDisable(hif);
@@ -15,6 +15,14 @@
 /*  Revision History:													*/
 /*																		*/
 /*	07/21/2010(AaronO): created											*/
+/*	10/17/2026: added -d, --tune and tuned loopback block size			*/
+/*	10/17/2026: added continuous streaming (--stream)					*/
+/*	10/17/2026: added full duplex streaming (--duplex)					*/
+/*	10/17/2026: added PRBS link soak test (--soak)						*/
+/*	10/17/2026: added segmented disk recording of streams (-rec)		*/
+/*	10/17/2026: added channel multiplexing over the stream (--mux)		*/
+/*	10/17/2026: transfer buffers come from the shared buffer pool		*/
+/*	10/17/2026: added zero copy streaming into a shared ring (-ring)	*/
 /*																		*/
 /************************************************************************/
 
@@ -35,15 +43,27 @@
 
 	/* Include Unix specific headers here.
 	*/
+	#include <fcntl.h>
+	#include <time.h>
+	#include <unistd.h>
 
 #endif
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "dpcdecl.h"
 #include "dmgr.h"
 #include "dstm.h"
+#include "BlkTune.h"
+#include "BufPool.h"
+#include "DstmStream.h"
+#include "DstmMux.h"
+#include "Prbs.h"
+#include "StmRecorder.h"
+#include "StmRing.h"
+#include "DstmRingRecv.h"
 
 /* ------------------------------------------------------------ */
 /*					Local Type and Constant Definitions			*/
@@ -51,12 +71,98 @@
 
 char szDvc[128] = "Nexys2";   // Device name
 
+/* Loopback block size used until the device has been tuned, and the
+** size of the block RAM in the Memory design, which limits how much
+** data can be looped back.
+*/
+const DWORD cbTxDefault = 8;
+const DWORD cbMemMax = 8192;
+
+/* Range of block sizes measured by the autotuner.
+*/
+const DWORD cbTuneMin = 64;
+const DWORD cbTuneMax = 1024 * 1024;
+
+/* Default number of buffers in the ring of a stream.
+*/
+const DWORD cbufStreamDefault = 8;
+
+/* Largest block of --soak. Each call reads back the block written by
+** the previous call while it writes the next one, so two blocks must
+** fit in the block RAM. The default PRBS order and the seed.
+*/
+const DWORD cbSoakMax = cbMemMax / 2;
+const int nPrbsDefault = 31;
+const DWORD dwPrbsSeed = 0x1A2B3C4D;
+
+/* Queue of the recorder of -rec: slots of 1 MB, so each write to
+** the disk is large, and enough of them to ride out a slow write.
+*/
+const DWORD cbRecSlot = 1024 * 1024;
+const DWORD cslotRec = 32;
+
+/* The Mux design loops back 4 channels. Defaults of --mux: the
+** channels used, the message size, the read size and the size of
+** the channel queues. A stream that makes no progress for tmsMuxHang
+** has failed.
+*/
+const DWORD cchanMuxDesign = 4;
+const DWORD cbMsgDefault = 16;
+const DWORD cbMuxBlockDefault = 4096;
+const DWORD cbMuxQueue = 65536;
+const DWORD tmsMuxHang = 5000;
+
+/* A reader of a shared ring (--attach) waits this long for the ring
+** to be created, and for each span of data.
+*/
+const DWORD tmsAttachWait = 10000;
+
+/* Result of checking a stream read back from the block RAM.
+*/
+typedef struct tagSTMCHK {
+	long long	cbErr;			// bytes that did not match
+	long long	ibErrFirst;		// stream offset of the first, -1 if none
+} STMCHK;
+
+/* Consumer state of -rec: each buffer is checked, then recorded.
+*/
+typedef struct tagSTMREC {
+	STMCHK *		pstmchk;
+	StmRecorder *	prec;
+} STMREC;
+
+/* State of the download stream of --duplex.
+*/
+typedef struct tagSTMGEN {
+	DWORD		cbWrite;		// bytes per write
+} STMGEN;
+
 
 /* ------------------------------------------------------------ */
 /*					Global Variables							*/
 /* ------------------------------------------------------------ */
 
-const int cbTx = 8;
+DWORD cbTx = cbTxDefault;
+BOOL fTune = fFalse;
+BOOL fStream = fFalse;
+long long cbStream = 0;
+DWORD cbBlock = 0;
+DWORD cbufStream = cbufStreamDefault;
+char * szFile = NULL;
+BOOL fDuplex = fFalse;
+BOOL fSplit = fFalse;
+DWORD cbWrite = 0;
+BOOL fSoak = fFalse;
+int nPrbs = nPrbsDefault;
+char * szRec = NULL;
+BOOL fMux = fFalse;
+DWORD cchanMux = cchanMuxDesign;
+DWORD cbMsg = cbMsgDefault;
+long long cbSeg = 0;
+BOOL fPwrite = fFalse;
+BOOL fRing = fFalse;
+char * szShm = NULL;
+char * szAttach = NULL;
 
 /* ------------------------------------------------------------ */
 /*					Local Variables								*/
@@ -64,14 +170,30 @@ const int cbTx = 8;
 HIF hif;
 
 
-BYTE rgbOut[cbTx] = { 0, 1, 2, 3, 4, 5, 6, 7 };
-BYTE rgbIn[cbTx];
+BYTE * rgbOut;
+BYTE * rgbIn;
 BOOL fFail = fFalse;
 
 /* ------------------------------------------------------------ */
 /*					Forward Declarations						*/
 /* ------------------------------------------------------------ */
 void ErrorExit();
+void ShowUsage(char * szProgName);
+void DoTune();
+BOOL FDstmTuneXfer(void * pvCtx, BYTE * rgb, DWORD cb);
+void DoStream();
+void DoRing();
+void DoAttach();
+BOOL CheckRing(STMRING * pring, STMCHK * pstmchk, long long * pcspan);
+void LoadPattern();
+BOOL FStreamCheck(void * pvCtx, const BYTE * rgb, DWORD cb, long long ibStream);
+BOOL FStreamRecord(void * pvCtx, const BYTE * rgb, DWORD cb, long long ibStream);
+DWORD CbStreamProduce(void * pvCtx, BYTE * rgb, DWORD cbMax, long long ibStream);
+BYTE BPattern(DWORD ib);
+void DoSoak();
+void DoMux();
+void InitBufPool(DWORD cbBuf, DWORD cbuf);
+double DblTimeSec();
 
 /* ------------------------------------------------------------ */
 /*					Procedure Definitions						*/
@@ -79,7 +201,8 @@ void ErrorExit();
 /***	main
 **
 **	Parameters:
-**		none
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
 **
 **	Return Value:
 **		none
@@ -90,8 +213,108 @@ void ErrorExit();
 **	Description:
 **		DstmDemo main
 */
-int main(void) {
-	int ibTx;
+int main(int cszArg, char * rgszArg[]) {
+	DWORD ibTx;
+	int iszArg;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+		}
+		else if (strcmp(rgszArg[iszArg], "--tune") == 0) {
+			fTune = fTrue;
+		}
+		else if (strcmp(rgszArg[iszArg], "--stream") == 0) {
+			fStream = fTrue;
+		}
+		else if (strcmp(rgszArg[iszArg], "--duplex") == 0) {
+			fStream = fTrue;
+			fDuplex = fTrue;
+		}
+		else if (strcmp(rgszArg[iszArg], "-split") == 0) {
+			fSplit = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-o") == 0) && (iszArg + 1 < cszArg)) {
+			cbWrite = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-c") == 0) && (iszArg + 1 < cszArg)) {
+			cbStream = strtoll(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-k") == 0) && (iszArg + 1 < cszArg)) {
+			cbBlock = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-n") == 0) && (iszArg + 1 < cszArg)) {
+			cbufStream = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-f") == 0) && (iszArg + 1 < cszArg)) {
+			szFile = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-rec") == 0) && (iszArg + 1 < cszArg)) {
+			szRec = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "-seg") == 0) && (iszArg + 1 < cszArg)) {
+			cbSeg = strtoll(rgszArg[++iszArg], NULL, 10);
+		}
+		else if (strcmp(rgszArg[iszArg], "-pwrite") == 0) {
+			fPwrite = fTrue;
+		}
+		else if (strcmp(rgszArg[iszArg], "--mux") == 0) {
+			fMux = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-ch") == 0) && (iszArg + 1 < cszArg)) {
+			cchanMux = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-m") == 0) && (iszArg + 1 < cszArg)) {
+			cbMsg = (DWORD) strtoul(rgszArg[++iszArg], NULL, 10);
+		}
+		else if (strcmp(rgszArg[iszArg], "-ring") == 0) {
+			fRing = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-shm") == 0) && (iszArg + 1 < cszArg)) {
+			szShm = rgszArg[++iszArg];
+		}
+		else if ((strcmp(rgszArg[iszArg], "--attach") == 0) && (iszArg + 1 < cszArg)) {
+			szAttach = rgszArg[++iszArg];
+		}
+		else if (strcmp(rgszArg[iszArg], "--soak") == 0) {
+			fSoak = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-prbs") == 0) && (iszArg + 1 < cszArg)) {
+			nPrbs = (int) strtol(rgszArg[++iszArg], NULL, 10);
+		}
+		else {
+			ShowUsage(rgszArg[0]);
+			return 1;
+		}
+	}
+
+	if ((szRec != NULL) && (!fStream || (szFile != NULL))) {
+		printf("Error: -rec is used with --stream or --duplex, and not with -f\n");
+		return 1;
+	}
+	if (((cbSeg != 0) || fPwrite) && (szRec == NULL)) {
+		printf("Error: -seg and -pwrite are used with -rec\n");
+		return 1;
+	}
+	if (cbSeg < 0) {
+		printf("Error: Invalid segment size\n");
+		return 1;
+	}
+	if (fRing && (!fStream || fDuplex || (szFile != NULL) || (szRec != NULL))) {
+		printf("Error: -ring is used with --stream, and not with -f or -rec\n");
+		return 1;
+	}
+	if ((szShm != NULL) && !fRing) {
+		printf("Error: -shm is used with -ring\n");
+		return 1;
+	}
+
+	/* The reader of a shared ring does not use the device.
+	*/
+	if (szAttach != NULL) {
+		DoAttach();
+		return 0;
+	}
 
 	// DMGR API Call: DmgrOpen
 	if(!DmgrOpen(&hif, szDvc)) {
@@ -104,6 +327,60 @@ int main(void) {
 		printf("Error: DstmEnable failed\n");
 		ErrorExit();
 	}
+
+	if (fTune || fStream || fSoak || fMux) {
+		if (fTune) {
+			DoTune();
+		}
+		else if (fSoak) {
+			DoSoak();
+		}
+		else if (fMux) {
+			DoMux();
+		}
+		else if (fRing) {
+			DoRing();
+		}
+		else {
+			DoStream();
+		}
+
+		// DSTM API Call: DstmDisable
+		DstmDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+
+		return 0;
+	}
+
+	/* Loop back the tuned block size. On first use of a device this
+	** measures it, which moves the upload address of the block RAM.
+	** Disabling the port resets the Memory design, so it is cycled
+	** before the loopback.
+	*/
+	cbTx = CbTuneBlock(hif, "dstm", FDstmTuneXfer, NULL, cbTuneMin, cbTuneMax, cbTxDefault);
+	if (cbTx > cbMemMax) {
+		cbTx = cbMemMax;
+	}
+
+	// DSTM API Call: DstmDisable, DstmEnable
+	if(!DstmDisable(hif) || !DstmEnable(hif)) {
+		printf("Error: DstmEnable failed\n");
+		ErrorExit();
+	}
+
+	BufPoolInitShared(cbTx, 2, FpoolHugeFit(cbTx, 2) | fpoolLock);
+	rgbOut = PbBufPoolAlloc(cbTx);
+	rgbIn = PbBufPoolAlloc(cbTx);
+	if ((rgbOut == NULL) || (rgbIn == NULL)) {
+		printf("Error: Cannot allocate %lu byte buffers\n", (unsigned long) cbTx);
+		ErrorExit();
+	}
+
+	for (ibTx = 0; ibTx < cbTx; ibTx++) {
+		rgbOut[ibTx] = (BYTE) ibTx;
+	}
 	
 
 	/* Tranfer data into FPGA block ram using Dstm */
@@ -132,11 +409,13 @@ int main(void) {
 	if(fFail) {
 		printf("Error: Recieved data did not match transmitted data\n");
 		for(ibTx=0; ibTx<cbTx; ibTx++) {
-			printf("rgbOut[%d]: %d      rgbIn[%d]: %d\n", ibTx, rgbOut[ibTx], ibTx, rgbIn[ibTx]);
+			if (rgbIn[ibTx] != rgbOut[ibTx]) {
+				printf("rgbOut[%lu]: %d      rgbIn[%lu]: %d\n", (unsigned long) ibTx, rgbOut[ibTx], (unsigned long) ibTx, rgbIn[ibTx]);
+			}
 		}
 	}
 	else {
-		printf("Success: Recieved data matched transmitted data\n");
+		printf("Success: Recieved data matched transmitted data (%lu bytes)\n", (unsigned long) cbTx);
 	}
 	
 	// DSTM API Call: DstmDisable
@@ -151,9 +430,1163 @@ int main(void) {
 		ErrorExit();
 	}
 
+	BufPoolRelease(rgbIn);
+	BufPoolRelease(rgbOut);
+	BufPoolFreeShared();
+
 	return 0;
 }
 
+/* ------------------------------------------------------------ */
+/***	DoTune
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Measures the upload throughput of DstmIO over a range of block
+**		sizes, prints the measured curve and stores the best block
+**		size for the device.
+*/
+void DoTune() {
+	TUNCRV tuncrv;
+	char szSn[cchSnMax + 1];
+	char szDtp[cchDtpStringMax + 1];
+
+	if(!FTuneGetDvc(hif, szSn, szDtp)) {
+		printf("Error: Cannot get device serial number\n");
+		ErrorExit();
+	}
+
+	if(!FTuneSweep(FDstmTuneXfer, NULL, cbTuneMin, cbTuneMax, &tuncrv)) {
+		printf("Error: DstmIO failed\n");
+		ErrorExit();
+	}
+
+	printf("DstmIO upload throughput for %s device %s:\n", szDtp, szSn);
+	TunePrintCurve(&tuncrv);
+
+	if(!FTuneStore("dstm", szDtp, szSn, tuncrv.cbBest)) {
+		printf("Error: Cannot store tuned block size\n");
+		ErrorExit();
+	}
+
+	printf("Block size %lu stored\n", (unsigned long) tuncrv.cbBest);
+}
+
+/* ------------------------------------------------------------ */
+/***	DoStream
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills the block RAM with a pattern, then reads it back as a
+**		continuous stream with a DstmStream. The Memory design wraps
+**		its upload address at the end of the RAM, so the stream
+**		repeats the pattern. Each buffer is checked against the
+**		pattern as it arrives, or written to the -f file. Prints the
+**		sustained throughput, the stalls and the longest gap between
+**		completed reads.
+**
+**		With -rec each buffer is checked and also passed to a
+**		StmRecorder, which writes the stream to the -rec file, or to
+**		segment files of -seg bytes, from its own threads. The recorder drops data rather
+**		than hold up the stream, so a drop is reported as an error,
+**		along with the deepest backlog of its queue.
+**
+**		With --duplex a producer writes the same pattern to the block
+**		RAM while it is read, and each write is carried by a read.
+**		Since every byte is written at the address the pattern gives
+**		it, the RAM keeps the pattern however the writes and reads
+**		interleave, and the check still holds. A byte written to the
+**		wrong address, or lost, shows up when it is read back.
+*/
+void DoStream() {
+	DstmStream stm;
+	STMSTAT stmstat;
+	STMCHK stmchk;
+	STMGEN stmgen;
+	STMREC stmrec;
+	StmRecorder rec;
+	RECSTAT recstat;
+	int fd = -1;
+	BOOL fOk;
+
+	if (cbStream <= 0) {
+		printf("Error: --stream requires a byte count (-c)\n");
+		ErrorExit();
+	}
+
+	if (cbBlock == 0) {
+		cbBlock = CbTuneBlock(hif, "dstm", FDstmTuneXfer, NULL, cbTuneMin, cbTuneMax, cbMemMax);
+	}
+
+	if (cbWrite == 0) {
+		cbWrite = cbBlock;
+	}
+	if (cbWrite > cbBlock) {
+		printf("Error: -o may not be larger than the read size (%lu bytes)\n", (unsigned long) cbBlock);
+		ErrorExit();
+	}
+
+	/* The rings of the stream are taken from the shared pool.
+	*/
+	InitBufPool(cbBlock, fDuplex ? 2 * cbufStream : cbufStream);
+	LoadPattern();
+
+	if (!stm.FInit(hif, cbBlock, cbufStream)) {
+		printf("Error: Cannot allocate %lu buffers of %lu bytes\n", (unsigned long) cbufStream, (unsigned long) cbBlock);
+		ErrorExit();
+	}
+
+	stmchk.cbErr = 0;
+	stmchk.ibErrFirst = -1;
+
+	if (szFile != NULL) {
+		fd = open(szFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			printf("Error: Cannot open file %s\n", szFile);
+			stm.Free();
+			ErrorExit();
+		}
+		stm.SetFile(fd);
+	}
+	else if (szRec != NULL) {
+		if (!rec.FInit(szRec, cbRecSlot, cslotRec, cbSeg, fPwrite ? frecPwrite : 0)) {
+			printf("Error: Cannot create recording %s\n", szRec);
+			stm.Free();
+			ErrorExit();
+		}
+		stmrec.pstmchk = &stmchk;
+		stmrec.prec = &rec;
+		stm.SetConsumer(FStreamRecord, &stmrec);
+	}
+	else {
+		stm.SetConsumer(FStreamCheck, &stmchk);
+	}
+
+	stmgen.cbWrite = cbWrite;
+	if (fDuplex && !stm.FSetProducer(CbStreamProduce, &stmgen, fSplit)) {
+		printf("Error: Cannot allocate %lu buffers of %lu bytes\n", (unsigned long) cbufStream, (unsigned long) cbBlock);
+		stm.Free();
+		ErrorExit();
+	}
+
+	printf("Streaming %lld bytes, %lu byte reads, %lu buffers\n", cbStream, (unsigned long) cbBlock, (unsigned long) cbufStream);
+	if (fDuplex) {
+		printf("Writing %lu bytes %s each read\n", (unsigned long) cbWrite, fSplit ? "before" : "with");
+	}
+
+	if (!stm.FStart(cbStream)) {
+		printf("Error: Cannot start stream\n");
+		stm.Free();
+		ErrorExit();
+	}
+
+	fOk = stm.FWait();
+	stm.GetStat(&stmstat);
+	stm.Free();
+
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	if (szRec != NULL) {
+		if (!rec.FClose()) {
+			fOk = fFalse;
+		}
+		rec.GetStat(&recstat);
+	}
+	BufPoolFreeShared();
+
+	printf("%lld bytes in %lu reads, %.3f s, %.2f MB/s sustained\n",
+		stmstat.cbDone, (unsigned long) stmstat.cxfer, stmstat.dblSec, stmstat.dblMBps);
+	printf("%lu stalls (%.3f ms), longest gap %.3f ms, deepest backlog %lu buffers\n",
+		(unsigned long) stmstat.cstall, stmstat.dblStallSec * 1e3, stmstat.dblGapMax * 1e3,
+		(unsigned long) stmstat.cbufQueuedMax);
+	if (fDuplex) {
+		printf("%lld bytes written, %lu of %lu reads carried writes, %.2f MB/s both ways\n",
+			stmstat.cbOutDone, (unsigned long) stmstat.cxferOut, (unsigned long) stmstat.cxfer,
+			stmstat.dblMBpsTotal);
+	}
+
+	if (szRec != NULL) {
+		printf("Recorded %lld bytes in %lu segment%s, %s%s, %lu x %lu KB slots\n",
+			recstat.cbWritten, (unsigned long) recstat.cseg, (recstat.cseg == 1) ? "" : "s",
+			recstat.fUring ? "io_uring" : "pwrite",
+			recstat.fDirect ? " O_DIRECT" : "", (unsigned long) recstat.cslot,
+			(unsigned long) (recstat.cbSlot / 1024));
+		printf("Recorder backlog at most %lu slots, longest write %.3f ms, %lu buffers (%lld bytes) dropped\n",
+			(unsigned long) recstat.cslotBacklogMax, recstat.dblWriteMax * 1e3,
+			(unsigned long) recstat.cbufDropped, recstat.cbDropped);
+	}
+
+	if (!fOk) {
+		if (stmstat.fWriteError) {
+			printf("Error: Cannot write file %s\n", szFile);
+		}
+		else if ((szRec != NULL) && recstat.fError) {
+			printf("Error: Cannot write recording %s (%s)\n", szRec, strerror(recstat.errnoFirst));
+		}
+		else {
+			printf("Error: DstmIOEx failed (error %d)\n", stmstat.erc);
+		}
+		ErrorExit();
+	}
+
+	if (szFile != NULL) {
+		printf("Stream saved to %s\n", szFile);
+		return;
+	}
+
+	if (stmchk.cbErr != 0) {
+		printf("Error: %lld bytes did not match, the first at offset %lld\n", stmchk.cbErr, stmchk.ibErrFirst);
+		ErrorExit();
+	}
+
+	if ((szRec != NULL) && (recstat.cbufDropped != 0)) {
+		printf("Error: The recorder could not keep up with the stream\n");
+		ErrorExit();
+	}
+
+	printf("Success: Received stream matched the block RAM\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DoRing
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Zero copy streaming (--stream -ring). Reads -c bytes of the
+**		block RAM pattern like --stream, but into a stream ring of -n
+**		slots of -k bytes with a DstmRingRecv, which reads each slot
+**		in place. Without -shm the ring is in a buffer of the shared
+**		pool and the main thread checks the data in the slots as they
+**		are committed, with no copy. With -shm the ring is created in
+**		POSIX shared memory and another process (--attach) checks it;
+**		the stream waits for that process to release the slots, and
+**		the demo waits until it has read to the end.
+*/
+void DoRing() {
+	DstmRingRecv recv;
+	RINGSTAT ringstat;
+	STMCHK stmchk;
+	STMRING * pring;
+	BYTE * pbRegion;
+	size_t cbRegion;
+	long long cspan;
+	BOOL fOk;
+
+	if (cbStream <= 0) {
+		printf("Error: --stream requires a byte count (-c)\n");
+		ErrorExit();
+	}
+
+	if (cbBlock == 0) {
+		cbBlock = CbTuneBlock(hif, "dstm", FDstmTuneXfer, NULL, cbTuneMin, cbTuneMax, cbMemMax);
+	}
+
+	cbRegion = CbStmRingRegion(cbBlock, cbufStream);
+
+	if (szShm != NULL) {
+		pbRegion = (BYTE *) PvStmRingCreateShm(szShm, cbRegion);
+		if (pbRegion == NULL) {
+			printf("Error: Cannot create shared memory %s\n", szShm);
+			ErrorExit();
+		}
+	}
+	else {
+		/* The ring is one large buffer of the shared pool.
+		*/
+		InitBufPool((DWORD) cbRegion, 2);
+		pbRegion = PbBufPoolAlloc((DWORD) cbRegion);
+		if (pbRegion == NULL) {
+			printf("Error: Cannot allocate %lu byte ring\n", (unsigned long) cbRegion);
+			ErrorExit();
+		}
+	}
+
+	LoadPattern();
+
+	pring = PringStmRingFormat(pbRegion, cbRegion, cbBlock);
+	if ((pring == NULL) || !recv.FInit(hif, pring)) {
+		printf("Error: Cannot create a ring of %lu slots of %lu bytes\n", (unsigned long) cbufStream, (unsigned long) cbBlock);
+		ErrorExit();
+	}
+
+	printf("Streaming %lld bytes into a ring of %lu slots of %lu bytes%s%s\n", cbStream,
+		(unsigned long) pring->cslot, (unsigned long) pring->cbSlot,
+		(szShm != NULL) ? " in shared memory " : "", (szShm != NULL) ? szShm : "");
+	if (szShm != NULL) {
+		printf("Waiting for the reader: DstmDemo --attach %s\n", szShm);
+	}
+
+	if (!recv.FStart(cbStream)) {
+		printf("Error: Cannot start stream\n");
+		recv.Free();
+		ErrorExit();
+	}
+
+	stmchk.cbErr = 0;
+	stmchk.ibErrFirst = -1;
+	cspan = 0;
+
+	if (szShm == NULL) {
+		CheckRing(pring, &stmchk, &cspan);
+	}
+
+	fOk = recv.FWait();
+	recv.GetStat(&ringstat);
+	recv.Free();
+
+	if (szShm != NULL) {
+		while (!FStmRingEnded(pring)) {
+			usleep(10000);
+		}
+		StmRingUnmap(pbRegion, cbRegion);
+		StmRingUnlinkShm(szShm);
+	}
+	else {
+		BufPoolRelease(pbRegion);
+	}
+	BufPoolFreeShared();
+
+	printf("%lld bytes in %lu reads, %.3f s, %.2f MB/s sustained\n",
+		ringstat.cbDone, (unsigned long) ringstat.cxfer, ringstat.dblSec, ringstat.dblMBps);
+	printf("%lu stalls (%.3f ms), longest gap %.3f ms\n",
+		(unsigned long) ringstat.cstall, ringstat.dblStallSec * 1e3, ringstat.dblGapMax * 1e3);
+
+	if (!fOk) {
+		printf("Error: DstmIOEx failed (error %d)\n", ringstat.erc);
+		ErrorExit();
+	}
+
+	if (szShm != NULL) {
+		printf("Success: Stream read by the attached process\n");
+		return;
+	}
+
+	printf("Checked %lld spans in place, %.1f slots per span\n", cspan,
+		(cspan > 0) ? (double) ringstat.cxfer / cspan : 0.0);
+
+	if (stmchk.cbErr != 0) {
+		printf("Error: %lld bytes did not match, the first at offset %lld\n", stmchk.cbErr, stmchk.ibErrFirst);
+		ErrorExit();
+	}
+
+	printf("Success: Received stream matched the block RAM\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DoAttach
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reader of a shared ring (--attach). Maps the ring created by
+**		--stream -ring -shm in another process, waiting up to
+**		tmsAttachWait for it to appear, and checks the stream in
+**		place against the block RAM pattern until it ends. Does not
+**		open a device.
+*/
+void DoAttach() {
+	STMCHK stmchk;
+	STMRING * pring;
+	void * pvRegion;
+	size_t cbRegion;
+	long long cspan;
+	double dblStart;
+	double dblSec;
+	BOOL fEnded;
+
+	dblStart = DblTimeSec();
+	pring = NULL;
+	pvRegion = NULL;
+	cbRegion = 0;
+
+	while (pring == NULL) {
+		pvRegion = PvStmRingOpenShm(szAttach, &cbRegion);
+		pring = PringStmRingAttach(pvRegion, cbRegion);
+		if (pring != NULL) {
+			break;
+		}
+		StmRingUnmap(pvRegion, cbRegion);
+		if (DblTimeSec() - dblStart > tmsAttachWait / 1000.0) {
+			printf("Error: No stream ring %s\n", szAttach);
+			exit(1);
+		}
+		usleep(10000);
+	}
+
+	printf("Attached to %s: %lu slots of %lu bytes\n", szAttach,
+		(unsigned long) pring->cslot, (unsigned long) pring->cbSlot);
+
+	stmchk.cbErr = 0;
+	stmchk.ibErrFirst = -1;
+	cspan = 0;
+
+	dblStart = DblTimeSec();
+	fEnded = CheckRing(pring, &stmchk, &cspan);
+	dblSec = DblTimeSec() - dblStart;
+
+	printf("%lld bytes in %lld spans, %.3f s, %.2f MB/s\n", pring->ibRelease, cspan,
+		dblSec, (dblSec > 0) ? pring->ibRelease / 1e6 / dblSec : 0.0);
+
+	if (!fEnded) {
+		printf("Error: No data from the stream for %lu ms\n", (unsigned long) tmsAttachWait);
+		StmRingUnmap(pvRegion, cbRegion);
+		exit(1);
+	}
+
+	if (pring->erc != ercNoErc) {
+		printf("Error: The stream ended with error %lu\n", (unsigned long) pring->erc);
+		StmRingUnmap(pvRegion, cbRegion);
+		exit(1);
+	}
+
+	StmRingUnmap(pvRegion, cbRegion);
+
+	if (stmchk.cbErr != 0) {
+		printf("Error: %lld bytes did not match, the first at offset %lld\n", stmchk.cbErr, stmchk.ibErrFirst);
+		exit(1);
+	}
+
+	printf("Success: Received stream matched the block RAM\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	CheckRing
+**
+**	Parameters:
+**		pring		- stream ring
+**		pstmchk		- STMCHK receiving the result
+**		pcspan		- variable to receive the number of spans read
+**
+**	Return Value:
+**		fTrue if the stream ended, fFalse if no data came for
+**		tmsAttachWait
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Consumer of a stream ring. Checks each span of committed
+**		slots where it lies in the ring and releases it.
+*/
+BOOL CheckRing(STMRING * pring, STMCHK * pstmchk, long long * pcspan) {
+	STMSPAN span;
+
+	while (FStmRingPeek(pring, &span, tmsAttachWait)) {
+		FStreamCheck(pstmchk, span.pb, span.cb, span.ibStream);
+		StmRingRelease(pring, &span);
+		(*pcspan)++;
+	}
+
+	return FStmRingEnded(pring);
+}
+
+/* ------------------------------------------------------------ */
+/***	LoadPattern
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Resets the address counters of the Memory design and fills
+**		the block RAM with the stream pattern.
+*/
+void LoadPattern() {
+	BYTE * rgbPattern;
+	DWORD ib;
+	BOOL fOk;
+
+	// DSTM API Call: DstmDisable, DstmEnable
+	if(!DstmDisable(hif) || !DstmEnable(hif)) {
+		printf("Error: DstmEnable failed\n");
+		ErrorExit();
+	}
+
+	rgbPattern = PbBufPoolAlloc(cbMemMax);
+	if (rgbPattern == NULL) {
+		printf("Error: Cannot allocate %lu byte buffer\n", (unsigned long) cbMemMax);
+		ErrorExit();
+	}
+
+	for (ib = 0; ib < cbMemMax; ib++) {
+		rgbPattern[ib] = BPattern(ib);
+	}
+
+	// DSTM API Call: DstmIO
+	fOk = DstmIO(hif, rgbPattern, cbMemMax, NULL, 0, fFalse);
+	BufPoolRelease(rgbPattern);
+	if (!fOk) {
+		printf("Error: DstmIO failed\n");
+		ErrorExit();
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DoSoak
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Link integrity soak test. Writes -c bytes of a PRBS (-prbs,
+**		PRBS-31 by default) through the block RAM in blocks of -k
+**		bytes and checks the data read back, then prints the bit
+**		errors, the offset of the first byte in error and the speed
+**		of the link and of the PRBS generator and checker.
+**
+**		Block n is written by call n and read back by call n + 1,
+**		which writes block n + 1 after it in the RAM. The two blocks
+**		do not overlap, so the check holds however the FIFOs
+**		interleave the download and the upload. Each call is
+**		overlapped: while it runs, the block read by the previous
+**		call is checked and the block of the next call is generated.
+*/
+void DoSoak() {
+	Prbs prbsTx;
+	Prbs prbsRx;
+	PRBSCHK prbschk;
+	BYTE * rgpbOut[2];
+	BYTE * rgpbIn[2];
+	DWORD cbOut;
+	DWORD cbIn;
+	DWORD cbInPrev;
+	DWORD cbOutNext;
+	DWORD cbOutDone;
+	DWORD cbInDone;
+	DWORD ibuf;
+	long long cbSent;
+	double dblStart;
+	double dblSec;
+	double dblPrbsSec;
+	double dblT;
+
+	if (cbStream <= 0) {
+		printf("Error: --soak requires a byte count (-c)\n");
+		ErrorExit();
+	}
+
+	if (cbBlock == 0) {
+		cbBlock = CbTuneBlock(hif, "dstm", FDstmTuneXfer, NULL, cbTuneMin, cbTuneMax, cbSoakMax);
+		if (cbBlock > cbSoakMax) {
+			cbBlock = cbSoakMax;
+		}
+	}
+	if (cbBlock > cbSoakMax) {
+		printf("Error: --soak blocks may not be larger than %lu bytes\n", (unsigned long) cbSoakMax);
+		ErrorExit();
+	}
+
+	if (!prbsTx.FInit(nPrbs, dwPrbsSeed) || !prbsRx.FInit(nPrbs, dwPrbsSeed)) {
+		printf("Error: Invalid PRBS order %d (7, 15 or 31)\n", nPrbs);
+		ErrorExit();
+	}
+
+	/* Start both address counters of the Memory design at 0.
+	*/
+	// DSTM API Call: DstmDisable, DstmEnable
+	if(!DstmDisable(hif) || !DstmEnable(hif)) {
+		printf("Error: DstmEnable failed\n");
+		ErrorExit();
+	}
+
+	InitBufPool(cbBlock, 4);
+	for (ibuf = 0; ibuf < 2; ibuf++) {
+		rgpbOut[ibuf] = PbBufPoolAlloc(cbBlock);
+		rgpbIn[ibuf] = PbBufPoolAlloc(cbBlock);
+		if ((rgpbOut[ibuf] == NULL) || (rgpbIn[ibuf] == NULL)) {
+			printf("Error: Cannot allocate %lu byte buffers\n", (unsigned long) cbBlock);
+			ErrorExit();
+		}
+	}
+
+	printf("Soaking %lld bytes in %lu byte blocks with PRBS-%d (%s kernels)\n",
+		cbStream, (unsigned long) cbBlock, nPrbs, Prbs::SzKernel());
+
+	Prbs::InitChk(&prbschk);
+	dblStart = DblTimeSec();
+
+	dblT = DblTimeSec();
+	cbOut = (cbStream < cbBlock) ? (DWORD) cbStream : cbBlock;
+	prbsTx.Fill(rgpbOut[0], cbOut);
+	dblPrbsSec = DblTimeSec() - dblT;
+
+	// DSTM API Call: DstmIO
+	if (!DstmIO(hif, rgpbOut[0], cbOut, NULL, 0, fFalse)) {
+		printf("Error: DstmIO failed\n");
+		ErrorExit();
+	}
+
+	cbSent = cbOut;
+	cbIn = cbOut;
+	cbInPrev = 0;
+	ibuf = 1;
+
+	dblT = DblTimeSec();
+	cbOut = (cbStream - cbSent < cbBlock) ? (DWORD) (cbStream - cbSent) : cbBlock;
+	prbsTx.Fill(rgpbOut[ibuf], cbOut);
+	dblPrbsSec += DblTimeSec() - dblT;
+
+	while (cbIn > 0) {
+
+		// DSTM API Call: DstmIO
+		if (!DstmIO(hif, (cbOut > 0) ? rgpbOut[ibuf] : NULL, cbOut, rgpbIn[ibuf], cbIn, fTrue)) {
+			printf("Error: DstmIO failed\n");
+			ErrorExit();
+		}
+		cbSent += cbOut;
+
+		dblT = DblTimeSec();
+		if (cbInPrev > 0) {
+			prbsRx.Check(rgpbIn[ibuf ^ 1], cbInPrev, &prbschk);
+		}
+		cbOutNext = (cbStream - cbSent < cbBlock) ? (DWORD) (cbStream - cbSent) : cbBlock;
+		prbsTx.Fill(rgpbOut[ibuf ^ 1], cbOutNext);
+		dblPrbsSec += DblTimeSec() - dblT;
+
+		// DMGR API Call: DmgrGetTransResult
+		if (!DmgrGetTransResult(hif, &cbOutDone, &cbInDone, tmsWaitInfinite) ||
+			(cbOutDone != cbOut) || (cbInDone != cbIn)) {
+			printf("Error: DstmIO failed\n");
+			ErrorExit();
+		}
+
+		cbInPrev = cbIn;
+		cbIn = cbOut;
+		cbOut = cbOutNext;
+		ibuf ^= 1;
+	}
+
+	dblT = DblTimeSec();
+	prbsRx.Check(rgpbIn[ibuf ^ 1], cbInPrev, &prbschk);
+	dblPrbsSec += DblTimeSec() - dblT;
+
+	dblSec = DblTimeSec() - dblStart;
+
+	for (ibuf = 0; ibuf < 2; ibuf++) {
+		BufPoolRelease(rgpbOut[ibuf]);
+		BufPoolRelease(rgpbIn[ibuf]);
+	}
+	BufPoolFreeShared();
+
+	printf("%lld bytes written and read back in %.3f s, %.2f MB/s each way\n",
+		cbStream, dblSec, cbStream / dblSec / 1e6);
+	if (dblPrbsSec > 0) {
+		printf("PRBS generator and checker: %.3f ms, %.2f GB/s\n",
+			dblPrbsSec * 1e3, 2.0 * cbStream / dblPrbsSec / 1e9);
+	}
+
+	if (prbschk.cbitErr != 0) {
+		printf("Error: %lld bit errors, %lld bytes in error (BER %.3g), the first at offset %lld\n",
+			prbschk.cbitErr, prbschk.cbErr, prbschk.cbitErr / (8.0 * prbschk.cbChecked),
+			prbschk.ibErrFirst);
+		ErrorExit();
+	}
+
+	printf("Success: No bit errors in %lld bits\n", 8 * prbschk.cbChecked);
+}
+
+/* ------------------------------------------------------------ */
+/***	DoMux
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Runs -ch independent channels over the stream with a DstmMux,
+**		against the Mux design, which loops each channel back. Each
+**		channel sends -c bytes of its own PRBS in messages of -m bytes
+**		and checks what comes back. Prints the throughput, how many
+**		messages each USB transfer carried, and the frame counts.
+**
+**		All channels are written and read from this thread, which
+**		never blocks on a single channel: a channel whose queue is
+**		full or empty is skipped, and the thread only waits when no
+**		channel can make progress.
+*/
+void DoMux() {
+	DstmMux mux;
+	MUXSTAT muxstat;
+	STMSTAT stmstat;
+	Prbs rgprbsTx[cchanMuxDesign];
+	Prbs rgprbsRx[cchanMuxDesign];
+	PRBSCHK prbschk;
+	BYTE * rgpbMsg[cchanMuxDesign];
+	DWORD rgibMsg[cchanMuxDesign];		// bytes of the message queued
+	DWORD rgcbMsg[cchanMuxDesign];		// length of the message
+	long long rgcbSent[cchanMuxDesign];
+	long long rgcbRcvd[cchanMuxDesign];
+	BYTE * rgbRcv;
+	long long cmsg;
+	double dblStart;
+	double dblSec;
+	DWORD genApp;
+	DWORD ichan;
+	DWORD cb;
+	DWORD cchanDone;
+	BOOL fProgress;
+
+	if (cbStream <= 0) {
+		printf("Error: --mux requires a byte count per channel (-c)\n");
+		ErrorExit();
+	}
+	if ((cchanMux == 0) || (cchanMux > cchanMuxDesign)) {
+		printf("Error: The Mux design has 1 to %lu channels\n", (unsigned long) cchanMuxDesign);
+		ErrorExit();
+	}
+	if ((cbMsg == 0) || (cbMsg > cbMuxQueue)) {
+		printf("Error: Messages are 1 to %lu bytes\n", (unsigned long) cbMuxQueue);
+		ErrorExit();
+	}
+	if (cbBlock == 0) {
+		cbBlock = cbMuxBlockDefault;
+	}
+
+	/* Reset the Mux design, so that it grants its channel buffers
+	** again.
+	*/
+	// DSTM API Call: DstmDisable, DstmEnable
+	if(!DstmDisable(hif) || !DstmEnable(hif)) {
+		printf("Error: DstmEnable failed\n");
+		ErrorExit();
+	}
+
+	InitBufPool(cbBlock, 2 * cbufStream);
+	if (!mux.FInit(hif, cchanMux, cbMuxQueue, cbBlock, cbufStream)) {
+		printf("Error: Cannot allocate %lu buffers of %lu bytes\n", (unsigned long) cbufStream, (unsigned long) cbBlock);
+		ErrorExit();
+	}
+
+	rgbRcv = (BYTE *) malloc(cbMuxQueue);
+	if (rgbRcv == NULL) {
+		printf("Error: Cannot allocate %lu byte buffer\n", (unsigned long) cbMuxQueue);
+		ErrorExit();
+	}
+
+	for (ichan = 0; ichan < cchanMux; ichan++) {
+		rgpbMsg[ichan] = (BYTE *) malloc(cbMsg);
+		if (rgpbMsg[ichan] == NULL) {
+			printf("Error: Cannot allocate %lu byte buffer\n", (unsigned long) cbMsg);
+			ErrorExit();
+		}
+		rgprbsTx[ichan].FInit(nPrbsDefault, dwPrbsSeed + ichan);
+		rgprbsRx[ichan].FInit(nPrbsDefault, dwPrbsSeed + ichan);
+		rgibMsg[ichan] = 0;
+		rgcbMsg[ichan] = 0;
+		rgcbSent[ichan] = 0;
+		rgcbRcvd[ichan] = 0;
+	}
+
+	printf("Multiplexing %lu channels, %lld bytes each way on each, %lu byte messages, %lu byte reads\n",
+		(unsigned long) cchanMux, cbStream, (unsigned long) cbMsg, (unsigned long) cbBlock);
+
+	Prbs::InitChk(&prbschk);
+	cmsg = 0;
+	genApp = 0;
+
+	if (!mux.FStart()) {
+		printf("Error: Cannot start stream\n");
+		mux.Free();
+		ErrorExit();
+	}
+
+	dblStart = DblTimeSec();
+
+	do {
+		fProgress = fFalse;
+		cchanDone = 0;
+
+		for (ichan = 0; ichan < cchanMux; ichan++) {
+
+			/* Queue the rest of the current message, then as many
+			** new messages as fit.
+			*/
+			while ((rgibMsg[ichan] < rgcbMsg[ichan]) || (rgcbSent[ichan] < cbStream)) {
+				if (rgibMsg[ichan] == rgcbMsg[ichan]) {
+					cb = (cbStream - rgcbSent[ichan] < cbMsg) ? (DWORD) (cbStream - rgcbSent[ichan]) : cbMsg;
+					rgprbsTx[ichan].Fill(rgpbMsg[ichan], cb);
+					rgcbMsg[ichan] = cb;
+					rgibMsg[ichan] = 0;
+					rgcbSent[ichan] += cb;
+					cmsg++;
+				}
+
+				cb = mux.CbWrite(ichan, rgpbMsg[ichan] + rgibMsg[ichan], rgcbMsg[ichan] - rgibMsg[ichan]);
+				rgibMsg[ichan] += cb;
+				if (rgibMsg[ichan] < rgcbMsg[ichan]) {
+					break;
+				}
+				fProgress = fTrue;
+			}
+
+			cb = mux.CbRead(ichan, rgbRcv, cbMuxQueue);
+			if (cb > 0) {
+				rgprbsRx[ichan].Check(rgbRcv, cb, &prbschk);
+				rgcbRcvd[ichan] += cb;
+				fProgress = fTrue;
+			}
+
+			if (rgcbRcvd[ichan] >= cbStream) {
+				cchanDone++;
+			}
+		}
+
+		if (!fProgress && (cchanDone < cchanMux)) {
+			if (!mux.FRunning()) {
+				break;
+			}
+			if (!mux.FWaitApp(&genApp, tmsMuxHang)) {
+				break;
+			}
+		}
+	} while (cchanDone < cchanMux);
+
+	dblSec = DblTimeSec() - dblStart;
+
+	mux.Stop();
+	mux.FWait();
+	mux.GetStat(&muxstat);
+	mux.GetStreamStat(&stmstat);
+	mux.Free();
+	BufPoolFreeShared();
+
+	free(rgbRcv);
+	for (ichan = 0; ichan < cchanMux; ichan++) {
+		free(rgpbMsg[ichan]);
+	}
+
+	printf("%lld payload bytes each way in %.3f s, %.2f MB/s each way\n",
+		muxstat.cbOut, dblSec, muxstat.cbOut / dblSec / 1e6);
+	printf("%lld messages in %lu download transfers, %.1f messages per transfer\n",
+		cmsg, (unsigned long) stmstat.cxferOut,
+		(stmstat.cxferOut > 0) ? (double) cmsg / stmstat.cxferOut : 0.0);
+	printf("Frames: %lu data and %lu credit sent, %lu data and %lu credit received, %lld idle bytes\n",
+		(unsigned long) muxstat.cframeOut, (unsigned long) muxstat.ccreditOut,
+		(unsigned long) muxstat.cframeIn, (unsigned long) muxstat.ccreditIn, muxstat.cbIdleIn);
+
+	if (stmstat.erc != ercNoErc) {
+		printf("Error: DstmIOEx failed (error %d)\n", stmstat.erc);
+		ErrorExit();
+	}
+	if (cchanDone < cchanMux) {
+		printf("Error: The channels stopped after %lld of %lld bytes\n",
+			prbschk.cbChecked, cbStream * cchanMux);
+		ErrorExit();
+	}
+	if (muxstat.cerrProto != 0) {
+		printf("Error: %lu protocol errors\n", (unsigned long) muxstat.cerrProto);
+		ErrorExit();
+	}
+	if (prbschk.cbitErr != 0) {
+		printf("Error: %lld bit errors, the first at channel byte %lld\n", prbschk.cbitErr, prbschk.ibErrFirst);
+		ErrorExit();
+	}
+
+	printf("Success: All channels looped back without errors\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	FStreamCheck
+**
+**	Parameters:
+**		pvCtx		- STMCHK receiving the result
+**		rgb			- received data
+**		cb			- number of bytes
+**		ibStream	- stream offset of rgb[0]
+**
+**	Return Value:
+**		fTrue to continue the stream
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stream consumer that checks the data read back from the block
+**		RAM against the pattern written to it.
+*/
+BOOL FStreamCheck(void * pvCtx, const BYTE * rgb, DWORD cb, long long ibStream) {
+	STMCHK * pstmchk = (STMCHK *) pvCtx;
+	DWORD ib;
+
+	for (ib = 0; ib < cb; ib++) {
+		if (rgb[ib] != BPattern((DWORD) ((ibStream + ib) % cbMemMax))) {
+			if (pstmchk->ibErrFirst < 0) {
+				pstmchk->ibErrFirst = ibStream + ib;
+			}
+			pstmchk->cbErr++;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FStreamRecord
+**
+**	Parameters:
+**		pvCtx		- STMREC of the stream
+**		rgb			- received data
+**		cb			- number of bytes
+**		ibStream	- stream offset of rgb[0]
+**
+**	Return Value:
+**		fTrue to continue the stream
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stream consumer of -rec. Checks the data like FStreamCheck and
+**		queues it on the recorder, which copies it and returns without
+**		waiting for the disk. A buffer the recorder has no room for is
+**		dropped from the recording, and the stream goes on.
+*/
+BOOL FStreamRecord(void * pvCtx, const BYTE * rgb, DWORD cb, long long ibStream) {
+	STMREC * pstmrec = (STMREC *) pvCtx;
+
+	FStreamCheck(pstmrec->pstmchk, rgb, cb, ibStream);
+	pstmrec->prec->FRecord(rgb, cb, ibStream);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	CbStreamProduce
+**
+**	Parameters:
+**		pvCtx		- STMGEN of the download stream
+**		rgb			- buffer to fill
+**		cbMax		- size of the buffer
+**		ibStream	- download stream offset of rgb[0]
+**
+**	Return Value:
+**		number of bytes placed in rgb
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Stream producer of --duplex. Continues the block RAM pattern
+**		from the download address.
+*/
+DWORD CbStreamProduce(void * pvCtx, BYTE * rgb, DWORD cbMax, long long ibStream) {
+	STMGEN * pstmgen = (STMGEN *) pvCtx;
+	DWORD cb;
+	DWORD ib;
+
+	cb = (pstmgen->cbWrite < cbMax) ? pstmgen->cbWrite : cbMax;
+	for (ib = 0; ib < cb; ib++) {
+		rgb[ib] = BPattern((DWORD) ((ibStream + ib) % cbMemMax));
+	}
+
+	return cb;
+}
+
+/* ------------------------------------------------------------ */
+/***	BPattern
+**
+**	Parameters:
+**		ib			- block RAM address
+**
+**	Return Value:
+**		pattern byte stored at the address
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Pattern written to the block RAM for streaming. Unlike the
+**		byte count used by the loopback test, it does not repeat
+**		every 256 bytes, so a lost or repeated block is detected.
+*/
+BYTE BPattern(DWORD ib) {
+
+	return (BYTE) (ib ^ (ib >> 8) ^ (ib >> 5));
+}
+
+/* ------------------------------------------------------------ */
+/***	FDstmTuneXfer
+**
+**	Parameters:
+**		pvCtx		- unused
+**		rgb			- buffer to receive data
+**		cb			- number of bytes to receive
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Transfer function measured by the autotuner. Reads from the
+**		block RAM, which can be read indefinitely.
+*/
+BOOL FDstmTuneXfer(void * pvCtx, BYTE * rgb, DWORD cb) {
+
+	(void) pvCtx;
+
+	// DSTM API Call: DstmIO
+	return DstmIO(hif, NULL, 0, rgb, cb, fFalse);
+}
+
+/* ------------------------------------------------------------ */
+/***	InitBufPool
+**
+**	Parameters:
+**		cbBuf		- size of the transfer buffers
+**		cbuf		- number of buffers
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Creates the shared buffer pool, locked in memory and, if it is
+**		large enough, on huge pages where the system allows, and prints
+**		what it got. The
+**		stream rings borrow their buffers from it. Without the pool
+**		they allocate their own, so failing is not fatal.
+*/
+void InitBufPool(DWORD cbBuf, DWORD cbuf) {
+	BufPool * ppool;
+	DWORD fpool;
+
+	if (!BufPoolInitShared(cbBuf, cbuf, FpoolHugeFit(cbBuf, cbuf) | fpoolLock)) {
+		printf("Warning: Cannot create the shared buffer pool\n");
+		return;
+	}
+
+	ppool = PpoolShared();
+	fpool = ppool->Fpool();
+	printf("Buffer pool: %lu buffers of %lu bytes, %s, %s\n",
+		(unsigned long) ppool->Cbuf(), (unsigned long) ppool->CbBuf(),
+		(fpool & fpoolHugeTlb) ? "hugetlbfs pages" : ((fpool & fpoolHuge) ? "transparent huge pages" : "small pages"),
+		(fpool & fpoolLock) ? "locked" : "not locked");
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to time the soak test.
+*/
+double DblTimeSec() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper paramater usage to the user
+*/
+void ShowUsage(char * szProgName) {
+	printf("Usage: %s [-d <device>] [--tune]\n", szProgName);
+	printf("       %s [-d <device>] --stream -c <# bytes> [-f <file>] [-k <# bytes>] [-n <# buffers>]\n", szProgName);
+	printf("       %s [-d <device>] --duplex -c <# bytes> [-o <# bytes>] [-split] [...]\n", szProgName);
+	printf("       %s [-d <device>] --stream -c <# bytes> -rec <file> [-seg <# bytes>] [-pwrite] [...]\n", szProgName);
+	printf("       %s [-d <device>] --stream -c <# bytes> -ring [-shm <name>] [-k <# bytes>] [-n <# buffers>]\n", szProgName);
+	printf("       %s --attach <name>\n", szProgName);
+	printf("       %s [-d <device>] --soak -c <# bytes> [-k <# bytes>] [-prbs <7|15|31>]\n", szProgName);
+	printf("       %s [-d <device>] --mux -c <# bytes> [-ch <# channels>] [-m <# bytes>] [-k <# bytes>] [-n <# buffers>]\n", szProgName);
+	printf("\t-d <device>\tDevice to open (default Nexys2)\n");
+	printf("\t--tune\t\tMeasure and store best block size\n");
+	printf("\t--stream\tRead the block RAM continuously and check it,\n");
+	printf("\t\t\tor save it to a file with -f\n");
+	printf("\t--duplex\tAs --stream, also writing the block RAM during\n");
+	printf("\t\t\tthe stream, each write carried by a read\n");
+	printf("\t--soak\t\tWrite a PRBS through the block RAM and check it\n");
+	printf("\t--mux\t\tLoop channels back through the Mux design\n");
+	printf("\t-c <# bytes>\tNumber of bytes to stream\n");
+	printf("\t-o <# bytes>\tBytes written per read (--duplex, default -k)\n");
+	printf("\t-split\t\tWrite in separate calls before the reads (--duplex)\n");
+	printf("\t-k <# bytes>\tBytes per read (default: tuned for the device)\n");
+	printf("\t-n <# buffers>\tBuffers in the ring (default %lu)\n", (unsigned long) cbufStreamDefault);
+	printf("\t-rec <file>\tCheck the stream and record it to disk\n");
+	printf("\t-seg <# bytes>\tStart a new file every -seg bytes (-rec)\n");
+	printf("\t-pwrite\t\tRecord with pwrite threads, not io_uring (-rec)\n");
+	printf("\t-ring\t\tRead the stream into a ring and check it in place\n");
+	printf("\t-shm <name>\tPut the ring in shared memory for --attach (-ring)\n");
+	printf("\t--attach <name>\tCheck the stream of a shared ring in place\n");
+	printf("\t-ch <# chan>\tChannels of --mux (default %lu)\n", (unsigned long) cchanMuxDesign);
+	printf("\t-m <# bytes>\tMessage size of --mux (default %lu)\n", (unsigned long) cbMsgDefault);
+	printf("\t-prbs <order>\tPRBS order of --soak (default %d)\n\n", nPrbsDefault);
+}
+
 
 /* ------------------------------------------------------------ */
 /***	ErrorExit
@@ -0,0 +1,307 @@
+--------------------------------------------------------------------------------
+-- Company:       Digilent
+--
+-- Create Date:   10/17/2026
+-- Module Name:   Mux - Behavioral
+-- Project Name:  StreamMux
+-- Description:
+--    Channel multiplexer for the DSTM port, the device side of DstmMux.
+--
+--    Every stream in both directions is a sequence of frames, each a four
+--    byte header followed by its payload:
+--
+--       byte 0 - frame type (high nibble) and channel (low nibble)
+--       byte 1 - sequence number of data frames on the channel
+--       byte 2 - length, low byte
+--       byte 3 - length, high byte
+--
+--    Type 1 is a data frame carrying length bytes of payload; type 2 is a
+--    credit frame with no payload, allowing the other side to send length
+--    more bytes on the channel. Between frames any other byte is skipped
+--    and 0x00 is sent as an idle byte.
+--
+--    The module has four channels, each looped back through its own 2048
+--    byte ring in the block RAM. The deframer writes the payload of data
+--    frames to the rings and adds credit frames to the credit of the
+--    framer. The framer sends, in order of preference, a credit frame
+--    granting back ring space freed by sent data, lowest channel first,
+--    and then a data frame of up to 256 bytes from the next channel in
+--    turn that has both data and credit. The whole of each ring is
+--    granted after reset.
+--
+--------------------------------------------------------------------------------
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.STD_LOGIC_ARITH.ALL;
+use IEEE.STD_LOGIC_UNSIGNED.ALL;
+
+
+entity Mux is
+   Port (
+      IFCLK    : in  std_logic;
+
+      RST      : in  std_logic;
+
+      DOWNBSY  : out std_logic;
+      DOWNWR   : in  std_logic;
+      DOWNACK  : out std_logic;
+      DOWNDATA : in  std_logic_vector(7 downto 0);
+
+      UPBSY    : out std_logic;
+      UPRD     : in  std_logic;
+      UPACK    : out std_logic;
+      UPDATA   : out std_logic_vector(7 downto 0));
+end Mux;
+
+architecture Behavioral of Mux is
+
+constant CHANCOUNT   : integer := 4;
+constant CHANSIZE    : integer := 2048;
+constant MEMSIZE     : integer := CHANCOUNT * CHANSIZE;
+constant PAYMAX      : integer := 256;
+constant CREDITMAX   : integer := 2**24 - 1;
+
+constant TYPEDATA    : std_logic_vector(3 downto 0) := "0001";
+constant TYPECREDIT  : std_logic_vector(3 downto 0) := "0010";
+
+type MEMType is array (0 to MEMSIZE - 1) of std_logic_vector(7 downto 0);
+signal MEMData : MEMType;
+
+-- The ring pointers count modulo twice the ring size, so that a full ring
+-- can be told from an empty one.
+type PTRType is array (0 to CHANCOUNT - 1) of integer range 0 to 2 * CHANSIZE - 1;
+type CREDITType is array (0 to CHANCOUNT - 1) of integer range 0 to CREDITMAX;
+type RETURNType is array (0 to CHANCOUNT - 1) of integer range 0 to CHANSIZE;
+type SEQType is array (0 to CHANCOUNT - 1) of std_logic_vector(7 downto 0);
+
+type STATEType is (stHdr0, stHdr1, stHdr2, stHdr3, stPayload);
+
+signal adrWr, adrRd : PTRType;
+signal creditUp : CREDITType;       -- payload the host can still take
+signal cbReturn : RETURNType;       -- ring space freed and not yet granted
+signal seqUp : SEQType;
+
+-- Deframer.
+signal stDown : STATEType;
+signal typeDown : std_logic_vector(3 downto 0);
+signal chanDown : integer range 0 to 15;
+signal lenDown : std_logic_vector(7 downto 0);
+signal cbDown : integer range 0 to 65535;
+
+-- Framer.
+signal stUp : STATEType;
+signal chanUp : integer range 0 to CHANCOUNT - 1;
+signal chanRR : integer range 0 to CHANCOUNT - 1;
+signal hdr1, hdr2, hdr3 : std_logic_vector(7 downto 0);
+signal cbUp, cbUpLen : integer range 0 to PAYMAX;
+
+-- Choice of the arbiter for the next frame.
+signal fCand, fCandCredit : std_logic;
+signal chanCand : integer range 0 to CHANCOUNT - 1;
+signal cbCand : integer range 0 to CHANSIZE;
+signal hdr0Cand : std_logic_vector(7 downto 0);
+
+signal memWe : std_logic;
+signal adrMemWr, adrMemRd : integer range 0 to MEMSIZE - 1;
+signal memOut : std_logic_vector(7 downto 0);
+
+begin
+
+   -- The Busy and Acknowledge signals are not used by this module. Every
+   -- download byte is accepted and every upload byte is supplied, an idle
+   -- byte if there is nothing to send.
+   DOWNBSY <= '0';
+   UPBSY <= '0';
+   DOWNACK <= '1';
+   UPACK <= '1';
+
+   -- Arbiter. It only looks at registers, so its choice is stable for the
+   -- whole clock cycle: between frames the first header byte of the chosen
+   -- frame is driven on UPDATA, and the frame is committed on the clock
+   -- edge that reads it.
+   process (cbReturn, adrWr, adrRd, creditUp, chanRR)
+      variable fFound : boolean;
+      variable ichan : integer range 0 to CHANCOUNT - 1;
+      variable cb : integer;
+   begin
+      fFound := false;
+      fCand <= '0';
+      fCandCredit <= '0';
+      chanCand <= 0;
+      cbCand <= 0;
+
+      for i in 0 to CHANCOUNT - 1 loop
+         if not fFound and cbReturn(i) > 0 then
+            fFound := true;
+            fCand <= '1';
+            fCandCredit <= '1';
+            chanCand <= i;
+            cbCand <= cbReturn(i);
+         end if;
+      end loop;
+
+      for i in 0 to CHANCOUNT - 1 loop
+         ichan := (chanRR + i) mod CHANCOUNT;
+         cb := (adrWr(ichan) - adrRd(ichan) + 2 * CHANSIZE) mod (2 * CHANSIZE);
+         if cb > creditUp(ichan) then
+            cb := creditUp(ichan);
+         end if;
+         if cb > PAYMAX then
+            cb := PAYMAX;
+         end if;
+         if not fFound and cb > 0 then
+            fFound := true;
+            fCand <= '1';
+            chanCand <= ichan;
+            cbCand <= cb;
+         end if;
+      end loop;
+   end process;
+
+   hdr0Cand <= TYPECREDIT & conv_std_logic_vector(chanCand, 4) when fCandCredit = '1' else
+               TYPEDATA & conv_std_logic_vector(chanCand, 4) when fCand = '1' else
+               x"00";
+
+   with stUp select
+      UPDATA <= hdr0Cand when stHdr0,
+                hdr1 when stHdr1,
+                hdr2 when stHdr2,
+                hdr3 when stHdr3,
+                memOut when others;
+
+   -- Block RAM ports. Payload is written to the ring of its channel; the
+   -- read port is advanced when the read signal is active, so that the
+   -- next payload byte is on UPDATA on the next clock cycle.
+   memWe <= '1' when DOWNWR = '1' and stDown = stPayload and chanDown < CHANCOUNT else '0';
+   adrMemWr <= (chanDown mod CHANCOUNT) * CHANSIZE + adrWr(chanDown mod CHANCOUNT) mod CHANSIZE;
+   adrMemRd <= chanUp * CHANSIZE + (adrRd(chanUp) + 1) mod CHANSIZE when stUp = stPayload and UPRD = '1' else
+               chanUp * CHANSIZE + adrRd(chanUp) mod CHANSIZE;
+
+   process (IFCLK)
+   begin
+      if rising_edge(IFCLK) then
+         if memWe = '1' then
+            MEMData(adrMemWr) <= DOWNDATA;
+         end if;
+
+         memOut <= MEMData(adrMemRd);
+      end if;
+   end process;
+
+   process (IFCLK)
+      variable cb : integer range 0 to 65535;
+      variable vCreditUp : CREDITType;
+   begin
+      if rising_edge(IFCLK) then
+         if RST = '0' then
+            stDown <= stHdr0;
+            stUp <= stHdr0;
+            chanRR <= 0;
+            chanUp <= 0;
+            for i in 0 to CHANCOUNT - 1 loop
+               adrWr(i) <= 0;
+               adrRd(i) <= 0;
+               creditUp(i) <= 0;
+               cbReturn(i) <= CHANSIZE;
+               seqUp(i) <= x"00";
+            end loop;
+         else
+            -- The credit of the framer may be raised by the deframer and
+            -- lowered by the framer on the same cycle.
+            vCreditUp := creditUp;
+
+            -- Deframer.
+            if DOWNWR = '1' then
+               case stDown is
+                  when stHdr0 =>
+                     if DOWNDATA(7 downto 4) = TYPEDATA or DOWNDATA(7 downto 4) = TYPECREDIT then
+                        typeDown <= DOWNDATA(7 downto 4);
+                        chanDown <= conv_integer(DOWNDATA(3 downto 0));
+                        stDown <= stHdr1;
+                     end if;
+
+                  when stHdr1 =>
+                     stDown <= stHdr2;
+
+                  when stHdr2 =>
+                     lenDown <= DOWNDATA;
+                     stDown <= stHdr3;
+
+                  when stHdr3 =>
+                     cb := conv_integer(DOWNDATA & lenDown);
+                     stDown <= stHdr0;
+                     if typeDown = TYPECREDIT then
+                        if chanDown < CHANCOUNT then
+                           vCreditUp(chanDown) := vCreditUp(chanDown) + cb;
+                        end if;
+                     elsif cb > 0 then
+                        cbDown <= cb;
+                        stDown <= stPayload;
+                     end if;
+
+                  when stPayload =>
+                     if chanDown < CHANCOUNT then
+                        adrWr(chanDown) <= (adrWr(chanDown) + 1) mod (2 * CHANSIZE);
+                     end if;
+                     cbDown <= cbDown - 1;
+                     if cbDown = 1 then
+                        stDown <= stHdr0;
+                     end if;
+               end case;
+            end if;
+
+            -- Framer.
+            if UPRD = '1' then
+               case stUp is
+                  when stHdr0 =>
+                     if fCand = '1' then
+                        chanUp <= chanCand;
+                        hdr2 <= conv_std_logic_vector(cbCand, 8);
+                        hdr3 <= conv_std_logic_vector(cbCand / 256, 8);
+                        if fCandCredit = '1' then
+                           cbReturn(chanCand) <= cbReturn(chanCand) - cbCand;
+                           hdr1 <= x"00";
+                           cbUp <= 0;
+                        else
+                           vCreditUp(chanCand) := vCreditUp(chanCand) - cbCand;
+                           hdr1 <= seqUp(chanCand);
+                           seqUp(chanCand) <= seqUp(chanCand) + 1;
+                           cbUp <= cbCand;
+                           cbUpLen <= cbCand;
+                           chanRR <= (chanCand + 1) mod CHANCOUNT;
+                        end if;
+                        stUp <= stHdr1;
+                     end if;
+
+                  when stHdr1 =>
+                     stUp <= stHdr2;
+
+                  when stHdr2 =>
+                     stUp <= stHdr3;
+
+                  when stHdr3 =>
+                     if cbUp > 0 then
+                        stUp <= stPayload;
+                     else
+                        stUp <= stHdr0;
+                     end if;
+
+                  when stPayload =>
+                     adrRd(chanUp) <= (adrRd(chanUp) + 1) mod (2 * CHANSIZE);
+                     cbUp <= cbUp - 1;
+                     if cbUp = 1 then
+                        -- The frame is sent: its ring space goes back to
+                        -- the host.
+                        cbReturn(chanUp) <= cbReturn(chanUp) + cbUpLen;
+                        stUp <= stHdr0;
+                     end if;
+               end case;
+            end if;
+
+            creditUp <= vCreditUp;
+         end if;
+      end if;
+   end process;
+
+end Behavioral;
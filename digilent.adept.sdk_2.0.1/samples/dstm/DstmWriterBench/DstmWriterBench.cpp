@@ -0,0 +1,641 @@
+/************************************************************************/
+/*																		*/
+/*  DstmWriterBench.cpp  --  DSTM Write Policy Benchmark				*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		DstmWriterBench sends a stream of messages to the DSTM port		*/
+/*		of the Memory reference design through a DstmWriter under		*/
+/*		each write policy, and reports the message rate, the number		*/
+/*		of transfers and the latency distribution of the messages.		*/
+/*																		*/
+/*		Small messages are written in bursts at a fixed offered rate,	*/
+/*		so that the latency of a message does not depend on how fast	*/
+/*		the previous one went out. Each workload is run for a fixed		*/
+/*		time under each policy.											*/
+/*																		*/
+/*		Workloads:														*/
+/*			ctl		- small messages only								*/
+/*			mixed	- small messages, with a bulk message after			*/
+/*					  every few bursts									*/
+/*																		*/
+/*		Policies:														*/
+/*			latency		- every message is a transfer					*/
+/*			thruput		- small messages are coalesced, bulk			*/
+/*						  messages bypass the coalescer					*/
+/*			flush		- as thruput, and the coalesced messages are	*/
+/*						  flushed at the end of each burst				*/
+/*																		*/
+/*		After each run the block RAM is read back and compared with		*/
+/*		the last messages written, so a writer that reorders or			*/
+/*		drops messages fails the benchmark.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: read the messages back and check their order			*/
+/*																		*/
+/************************************************************************/
+
+#define	_CRT_SECURE_NO_WARNINGS
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "dstm.h"
+#include "BufPool.h"
+#include "DstmWriter.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* Size of the block RAM of the Memory design. The stream is written
+** around it, so it holds the last cbMemMax bytes sent.
+*/
+const DWORD cbMemMax = 8192;
+
+typedef enum {
+	wklCtl = 0,
+	wklMixed,
+	wklMax
+} WKL;
+
+typedef enum {
+	modeLatency = 0,
+	modeThruput,
+	modeFlush,
+	modeMax
+} MODE;
+
+/* Result of one workload run.
+*/
+typedef struct tagBENCHRES {
+	WRSTAT	stat;
+	long long	cmsgSmall;
+	double	dblSec;
+} BENCHRES;
+
+/* ------------------------------------------------------------ */
+/*					Global Variables							*/
+/* ------------------------------------------------------------ */
+
+char		szDvc[cchDvcNameMax];
+double		dblRunSec = 1.0;
+double		dblRate = 20000;
+DWORD		cmsgBurst = 4;
+DWORD		cbSmall = 16;
+DWORD		cbBulk = 65536;
+DWORD		cburstBulk = 50;
+DWORD		cbBudget = 16384;
+DWORD		tusBudget = 500;
+DWORD		cbBypass = 4096;
+
+HIF			hif = hifInvalid;
+
+const char *	rgszWkl[wklMax] = { "ctl", "mixed" };
+const char *	rgszMode[modeMax] = { "latency", "thruput", "flush" };
+
+BENCHRES	rgres[wklMax][modeMax];
+
+/* What the block RAM should hold: byte ib of the stream of a run is
+** at rgbMemExp[ib % cbMemMax].
+*/
+BYTE		rgbMemExp[cbMemMax];
+BYTE		rgbMemRead[cbMemMax];
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+BOOL	FParseParam(int cszArg, char * rgszArg[]);
+void	ShowUsage(char * szProgName);
+void	RunWorkload(WKL wkl, MODE mode, BYTE * rgbBulk, BENCHRES * pres);
+void	AddExpected(const BYTE * rgb, DWORD cb, long long * pibStm);
+BOOL	FCheckReadBack(long long cbStm, long long * pibErr);
+void	SleepUntil(double dblSec);
+double	DblTimeSec();
+void	ErrorExit();
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	main
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		0 if successful, 1 if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		DstmWriterBench main
+*/
+
+int main(int cszArg, char * rgszArg[]) {
+
+	BENCHRES *	pres;
+	WRSTAT *	pstat;
+	BYTE *		rgbBulk;
+	DWORD		ib;
+	int			wkl;
+	int			mode;
+
+	if (!FParseParam(cszArg, rgszArg)) {
+		ShowUsage(rgszArg[0]);
+		return 1;
+	}
+
+	// DMGR API Call: DmgrOpen
+	if (!DmgrOpen(&hif, szDvc)) {
+		printf("DmgrOpen failed (check the device name you provided)\n");
+		return 1;
+	}
+
+	// DSTM API Call: DstmEnable
+	if (!DstmEnable(hif)) {
+		printf("DstmEnable failed\n");
+		ErrorExit();
+	}
+
+	rgbBulk = PbBufPoolAlloc(cbBulk);
+	if (rgbBulk == NULL) {
+		printf("Cannot allocate the bulk message\n");
+		ErrorExit();
+	}
+	for (ib = 0; ib < cbBulk; ib++) {
+		rgbBulk[ib] = (BYTE) ib;
+	}
+
+	printf("%lu byte messages in bursts of %lu at %.0f msg/s; %lu byte bulk every %lu bursts\n",
+		(unsigned long) cbSmall, (unsigned long) cmsgBurst, dblRate,
+		(unsigned long) cbBulk, (unsigned long) cburstBulk);
+	printf("budget %lu bytes or %lu us, bypass at %lu bytes\n\n",
+		(unsigned long) cbBudget, (unsigned long) tusBudget, (unsigned long) cbBypass);
+
+	printf("%-5s %-7s %10s %8s %9s %8s %9s %9s %9s %9s %9s %9s\n",
+		"wkl", "policy", "msg/s", "MB/s", "xfer/s", "msg/xfer",
+		"p50 us", "p99 us", "p99.9 us", "max us", "bulk p50", "bulk p99");
+
+	for (wkl = 0; wkl < wklMax; wkl++) {
+		for (mode = 0; mode < modeMax; mode++) {
+			pres = &rgres[wkl][mode];
+			pstat = &pres->stat;
+			RunWorkload((WKL) wkl, (MODE) mode, rgbBulk, pres);
+
+			printf("%-5s %-7s %10.0f %8.2f %9.0f %8.2f %9.1f %9.1f %9.1f %9.1f",
+				rgszWkl[wkl], rgszMode[mode], pres->cmsgSmall / pres->dblSec,
+				pstat->cbMsg / pres->dblSec / 1e6, pstat->cxfer / pres->dblSec,
+				(double) pstat->cmsg / pstat->cxfer,
+				DblWrLatPct(&pstat->latSmall, 50) * 1e6,
+				DblWrLatPct(&pstat->latSmall, 99) * 1e6,
+				DblWrLatPct(&pstat->latSmall, 99.9) * 1e6,
+				pstat->latSmall.dblMaxSec * 1e6);
+			if (pstat->latBulk.cmsg > 0) {
+				printf(" %9.1f %9.1f\n", DblWrLatPct(&pstat->latBulk, 50) * 1e6,
+					DblWrLatPct(&pstat->latBulk, 99) * 1e6);
+			}
+			else {
+				printf(" %9s %9s\n", "-", "-");
+			}
+		}
+	}
+
+	printf("\n%-5s %-7s %9s %9s %9s %9s %9s %9s\n", "wkl", "policy",
+		"direct", "full", "timer", "flush", "bypass", "ring wait");
+
+	for (wkl = 0; wkl < wklMax; wkl++) {
+		for (mode = 0; mode < modeMax; mode++) {
+			pstat = &rgres[wkl][mode].stat;
+			printf("%-5s %-7s %9lu %9lu %9lu %9lu %9lu %9lu\n",
+				rgszWkl[wkl], rgszMode[mode],
+				(unsigned long) pstat->cxferDirect, (unsigned long) pstat->cflushFull,
+				(unsigned long) pstat->cflushTimer, (unsigned long) pstat->cflushExplicit,
+				(unsigned long) pstat->cflushBypass, (unsigned long) pstat->cwaitRing);
+		}
+	}
+
+	BufPoolRelease(rgbBulk);
+
+	// DSTM API Call: DstmDisable
+	DstmDisable(hif);
+
+	// DMGR API Call: DmgrClose
+	DmgrClose(hif);
+
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	RunWorkload
+**
+**	Parameters:
+**		wkl			- workload to run
+**		mode		- write policy
+**		rgbBulk		- bulk message
+**		pres		- variable to receive the result
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		Exits if a transfer fails or the messages read back differ
+**		from the messages written.
+**
+**	Description:
+**		Writes bursts of small messages through a new DstmWriter at
+**		the offered rate for dblRunSec seconds, then flushes the
+**		writer and collects its statistics. The run is timed until
+**		the last message has been sent. The stream port is reset
+**		first, so the stream starts at address 0 of the block RAM,
+**		and the block RAM is read back at the end.
+*/
+
+void RunWorkload(WKL wkl, MODE mode, BYTE * rgbBulk, BENCHRES * pres) {
+
+	DstmWriter	dwr;
+	BYTE		rgbMsg[256];
+	DWORD		iburst;
+	DWORD		imsg;
+	DWORD		seq;
+	long long	ibStm;
+	long long	ibErr;
+	double		dblStart;
+	double		dblNext;
+	double		dblInterval;
+	BOOL		fOk = fTrue;
+
+	memset(pres, 0, sizeof(BENCHRES));
+
+	/* Disabling the port resets both address counters of the design.
+	*/
+	// DSTM API Call: DstmDisable
+	DstmDisable(hif);
+
+	// DSTM API Call: DstmEnable
+	if (!DstmEnable(hif)) {
+		printf("Error: %s %s: cannot reset the stream port\n", rgszWkl[wkl], rgszMode[mode]);
+		ErrorExit();
+	}
+
+	if (!dwr.FInit(hif, (mode == modeLatency) ? wpolLatency : wpolThroughput,
+			cbBudget, tusBudget, cbBypass)) {
+		printf("Error: cannot initialize the writer\n");
+		ErrorExit();
+	}
+
+	dblInterval = (dblRate > 0) ? cmsgBurst / dblRate : 0;
+	dblStart = DblTimeSec();
+	dblNext = dblStart;
+
+	seq = 0;
+	ibStm = 0;
+	iburst = 0;
+	while (fOk && (dblNext - dblStart < dblRunSec)) {
+		SleepUntil(dblNext);
+
+		for (imsg = 0; fOk && (imsg < cmsgBurst); imsg++) {
+			memset(rgbMsg, (BYTE) seq, cbSmall);
+			rgbMsg[0] = (BYTE) imsg;
+			fOk = dwr.FWrite(rgbMsg, cbSmall);
+			if (fOk) {
+				AddExpected(rgbMsg, cbSmall, &ibStm);
+			}
+			seq++;
+		}
+		pres->cmsgSmall += imsg;
+
+		if (fOk && (wkl == wklMixed) && (cburstBulk > 0) && (iburst % cburstBulk == cburstBulk - 1)) {
+			fOk = dwr.FWrite(rgbBulk, cbBulk);
+			if (fOk) {
+				AddExpected(rgbBulk, cbBulk, &ibStm);
+			}
+		}
+
+		if (fOk && (mode == modeFlush)) {
+			fOk = dwr.FFlush(fFalse);
+		}
+
+		iburst++;
+		dblNext = (dblInterval > 0) ? dblStart + iburst * dblInterval : DblTimeSec();
+	}
+
+	fOk = fOk && dwr.FFlush(fTrue);
+	pres->dblSec = DblTimeSec() - dblStart;
+
+	dwr.GetStat(&pres->stat);
+	dwr.Free();
+
+	if (!fOk) {
+		printf("Error: %s %s: transfer failed, error %d\n", rgszWkl[wkl],
+			rgszMode[mode], (int) pres->stat.erc);
+		ErrorExit();
+	}
+
+	if (!FCheckReadBack(ibStm, &ibErr)) {
+		if (ibErr < 0) {
+			printf("Error: %s %s: cannot read the block RAM back\n", rgszWkl[wkl], rgszMode[mode]);
+		}
+		else {
+			printf("Error: %s %s: the data read back differs from the messages written at stream byte %lld\n",
+				rgszWkl[wkl], rgszMode[mode], ibErr);
+		}
+		ErrorExit();
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	AddExpected
+**
+**	Parameters:
+**		rgb			- message written
+**		cb			- number of bytes in the message
+**		pibStm		- stream offset of the message, advanced past it
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Records a message in the expected contents of the block RAM.
+**		Only the last cbMemMax bytes of the message can survive.
+*/
+
+void AddExpected(const BYTE * rgb, DWORD cb, long long * pibStm) {
+
+	DWORD	ib;
+
+	ib = (cb > cbMemMax) ? cb - cbMemMax : 0;
+	for (; ib < cb; ib++) {
+		rgbMemExp[(*pibStm + ib) % cbMemMax] = rgb[ib];
+	}
+
+	*pibStm += cb;
+}
+
+/* ------------------------------------------------------------ */
+/***	FCheckReadBack
+**
+**	Parameters:
+**		cbStm		- number of bytes written since the port was reset
+**		pibErr		- variable to receive the stream offset of the
+**					  first byte that differs, or -1 if the read failed
+**
+**	Return Value:
+**		fTrue if the block RAM holds the bytes written, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the block RAM from address 0, which the upload address
+**		counter holds since the reset, and compares each address
+**		with the last byte written to it. The offset reported is that
+**		of the last byte written at the first address that differs.
+*/
+
+BOOL FCheckReadBack(long long cbStm, long long * pibErr) {
+
+	DWORD	cbRead;
+	DWORD	ib;
+
+	*pibErr = -1;
+	cbRead = (cbStm < cbMemMax) ? (DWORD) cbStm : cbMemMax;
+	if (cbRead == 0) {
+		return fTrue;
+	}
+
+	// DSTM API Call: DstmIO
+	if (!DstmIO(hif, NULL, 0, rgbMemRead, cbRead, fFalse)) {
+		return fFalse;
+	}
+
+	for (ib = 0; ib < cbRead; ib++) {
+		if (rgbMemRead[ib] != rgbMemExp[ib]) {
+			*pibErr = cbStm - 1 - ((cbStm - 1 - ib) % cbMemMax);
+			return fFalse;
+		}
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	SleepUntil
+**
+**	Parameters:
+**		dblSec		- time to wake, on the DblTimeSec clock
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sleeps until the given time. Returns at once if it has
+**		passed, so a writer that falls behind the offered rate sends
+**		its bursts back to back until it catches up.
+*/
+
+void SleepUntil(double dblSec) {
+
+	struct timespec	ts;
+
+	if (DblTimeSec() >= dblSec) {
+		return;
+	}
+
+	ts.tv_sec = (time_t) dblSec;
+	ts.tv_nsec = (long) ((dblSec - ts.tv_sec) * 1e9);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FParseParam
+**
+**	Parameters:
+**		cszArg		- number of command line arguments
+**		rgszArg		- array of command line argument strings
+**
+**	Return Value:
+**		fTrue if the arguments are valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the command line.
+*/
+
+BOOL FParseParam(int cszArg, char * rgszArg[]) {
+
+	int		iszArg;
+	BOOL	fDvc = fFalse;
+
+	for (iszArg = 1; iszArg < cszArg; iszArg++) {
+		if ((strcmp(rgszArg[iszArg], "-d") == 0) && (iszArg + 1 < cszArg)) {
+			snprintf(szDvc, sizeof(szDvc), "%s", rgszArg[++iszArg]);
+			fDvc = fTrue;
+		}
+		else if ((strcmp(rgszArg[iszArg], "-t") == 0) && (iszArg + 1 < cszArg)) {
+			dblRunSec = atof(rgszArg[++iszArg]);
+			if (dblRunSec <= 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-r") == 0) && (iszArg + 1 < cszArg)) {
+			dblRate = atof(rgszArg[++iszArg]);
+			if (dblRate < 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-n") == 0) && (iszArg + 1 < cszArg)) {
+			cmsgBurst = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (cmsgBurst == 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-m") == 0) && (iszArg + 1 < cszArg)) {
+			cbSmall = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if ((cbSmall == 0) || (cbSmall > 256)) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-b") == 0) && (iszArg + 1 < cszArg)) {
+			cbBulk = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (cbBulk == 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-k") == 0) && (iszArg + 1 < cszArg)) {
+			cburstBulk = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-c") == 0) && (iszArg + 1 < cszArg)) {
+			cbBudget = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+			if (cbBudget == 0) {
+				return fFalse;
+			}
+		}
+		else if ((strcmp(rgszArg[iszArg], "-u") == 0) && (iszArg + 1 < cszArg)) {
+			tusBudget = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else if ((strcmp(rgszArg[iszArg], "-x") == 0) && (iszArg + 1 < cszArg)) {
+			cbBypass = (DWORD) strtoul(rgszArg[++iszArg], NULL, 0);
+		}
+		else {
+			return fFalse;
+		}
+	}
+
+	return fDvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	ShowUsage
+**
+**	Parameters:
+**		szProgName	- name of program as called (from rgszArg[0])
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Demonstrates proper paramater usage to the user
+*/
+
+void ShowUsage(char * szProgName) {
+
+	printf("Usage: %s -d <device name> [-t <seconds>] [-r <msg/s>] [-n <msgs>]\n", szProgName);
+	printf("\t[-m <bytes>] [-b <bytes>] [-k <bursts>] [-c <bytes>] [-u <us>] [-x <bytes>]\n\n");
+	printf("\t-d <device name>\tDevice with the DSTM Memory design loaded\n");
+	printf("\t-t <seconds>\t\tTime to run each workload (default 1)\n");
+	printf("\t-r <msg/s>\t\tOffered rate of small messages, 0 for as fast\n");
+	printf("\t\t\t\tas possible (default 20000)\n");
+	printf("\t-n <msgs>\t\tSmall messages per burst (default 4)\n");
+	printf("\t-m <bytes>\t\tSize of a small message, 1 to 256 (default 16)\n");
+	printf("\t-b <bytes>\t\tSize of a bulk message (default 65536)\n");
+	printf("\t-k <bursts>\t\tBursts per bulk message in the mixed workload,\n");
+	printf("\t\t\t\t0 for none (default 50)\n");
+	printf("\t-c <bytes>\t\tByte budget of a coalesced transfer (default 16384)\n");
+	printf("\t-u <us>\t\t\tTime budget of a coalesced message (default 500)\n");
+	printf("\t-x <bytes>\t\tBypass size, 0 for the byte budget (default 4096)\n\n");
+}
+
+/* ------------------------------------------------------------ */
+/***	DblTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of a monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Used to pace and time the workloads.
+*/
+
+double DblTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	ErrorExit
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Disables DSTM, closes the device and exits the program
+*/
+
+void ErrorExit() {
+
+	if (hif != hifInvalid) {
+		// DSTM API Call: DstmDisable
+		DstmDisable(hif);
+
+		// DMGR API Call: DmgrClose
+		DmgrClose(hif);
+	}
+
+	exit(1);
+}
+
+/************************************************************************/
@@ -0,0 +1,238 @@
+/************************************************************************/
+/*																		*/
+/*  AdeptSim.h  --  Adept Simulator Shared Declarations					*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This header contains the declarations shared between the		*/
+/*		libraries of the Adept simulator. The simulator replaces the	*/
+/*		Adept Runtime libraries with software models of the reference	*/
+/*		designs so that the demo projects can be run without a board.	*/
+/*		These declarations are private to the simulator and are not		*/
+/*		part of the public Adept SDK interface.							*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: DpimRef strobe model, latency model and statistics		*/
+/*	10/17/2026: added the DSTM Memory design							*/
+/*	10/17/2026: added the StmCtrl state machine and FX2 FIFO flags		*/
+/*	10/17/2026: added the DSTM Mux design								*/
+/*	10/17/2026: added the JTAG scan chain								*/
+/*																		*/
+/************************************************************************/
+
+#if !defined(ADEPTSIM_INCLUDED)
+#define      ADEPTSIM_INCLUDED
+
+#include "dpcdecl.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+
+#if defined(__cplusplus)
+	#define SIMAPI extern "C" __attribute__ ((visibility("default")))
+#else
+	#define SIMAPI __attribute__ ((visibility("default")))
+#endif
+
+/* Maximum number of simultaneously open simulated devices.
+*/
+const int	csimdvcMax		= 32;
+
+/* Registers of the DpimRef design. The address register is 4 bits
+** wide, so register addresses alias modulo 16. Addresses 11-14 read
+** as 0 and ignore writes.
+*/
+const BYTE	bEppAdrMask		= 0x0F;
+const BYTE	cregEppData		= 8;	// regData0-regData7, read/write
+const BYTE	regEppSwt		= 8;	// switches, read only
+const BYTE	regEppBtn		= 9;	// buttons, 5 bits, read only
+const BYTE	regEppLed		= 10;	// LEDs, write only (reads as 0)
+
+/* Simulation-only register that returns an incrementing counter
+** pattern on each data read cycle. The DpimRef design returns 0
+** for this address; the counter is used to test streaming reads.
+*/
+const BYTE	regEppCntr		= 15;
+
+/* Size of the block RAM of the DSTM Memory design. The download and
+** upload address counters wrap at this size.
+*/
+const DWORD	cbStmMem		= 8192;
+
+/* The DSTM Mux design (Mux.vhd) loops back cchanStmMux channels,
+** each through a cbStmMuxChan byte ring in the block RAM, and sends
+** data frames of at most cbStmMuxPayMax bytes.
+*/
+const DWORD	cchanStmMux		= 4;
+const DWORD	cbStmMuxChan	= 2048;
+const DWORD	cbStmMuxPayMax	= 256;
+
+/* States of the StmCtrl state machine (StmCtrl.vhd).
+*/
+const int	stStmIdle		= 0;
+const int	stStmDownload	= 1;
+const int	stStmUpload		= 2;
+
+/* Longest simulated JTAG scan chain. Instruction registers are at
+** most 32 bits.
+*/
+const int	cjdvcSimMax		= 32;
+const DWORD	cbitSimIrMax	= 32;
+
+/* ------------------------------------------------------------ */
+/*					General Type Declarations					*/
+/* ------------------------------------------------------------ */
+
+/* State of the EPP port of a simulated device and of the DpimRef
+** design behind it.
+*/
+typedef struct tagSIMEPP {
+	BOOL	fEnabled;
+	BYTE	bAdr;					// regEppAdr, set by address write cycles
+	BYTE	rgbData[cregEppData];	// regData0-regData7
+	BYTE	bLed;					// regLed, drives the LED outputs
+	BYTE	bSwt;					// switch inputs
+	BYTE	bBtn;					// button inputs
+	BYTE	bCntr;					// next value of the counter register
+	DWORD	castb;					// address strobe cycles
+	DWORD	cdstb;					// data strobe cycles
+} SIMEPP;
+
+/* State of the Mux design. The deframer takes the download bytes
+** and the framer supplies the upload bytes; both run a byte at a
+** time. The channel rings are kept in the block RAM of SIMSTM.
+*/
+typedef struct tagSIMMUX {
+	int		stDown;					// deframer state
+	BYTE	tmuxDown;				// type of the frame being received
+	DWORD	ichanDown;
+	DWORD	cbDown;					// length, then payload still to come
+
+	int		stUp;					// framer state
+	BYTE	rgbUpHdr[4];			// header of the frame being sent
+	DWORD	ichanUp;
+	DWORD	cbUp;					// payload still to send
+	DWORD	cbUpLen;
+	DWORD	ichanRR;				// round robin start of the framer
+
+	DWORD	rgadrWr[cchanStmMux];	// ring pointers, modulo 2 * cbStmMuxChan
+	DWORD	rgadrRd[cchanStmMux];
+	DWORD	rgcbCreditUp[cchanStmMux];	// payload the host can take
+	DWORD	rgcbReturn[cchanStmMux];	// room freed, not yet granted
+	BYTE	rgseqUp[cchanStmMux];
+} SIMMUX;
+
+/* State of the DSTM port of a simulated device and of the design
+** behind it, the Memory design or the Mux design (samples/dstm/
+** DstmDemo/logic).
+*/
+typedef struct tagSIMSTM {
+	BOOL	fEnabled;
+	BYTE	rgbMem[cbStmMem];		// MEMData, or the rings of the Mux design
+	DWORD	adrDownload;			// written by DOWNWR cycles
+	DWORD	adrUpload;				// read by UPRD cycles
+	double	cbDown;					// bytes written to the design
+	double	cbUp;					// bytes read from the design
+
+	/* StmCtrl and the FX2 slave FIFOs. The FIFOs only hold counts,
+	** as bytes pass through them in order.
+	*/
+	int		stCur;					// StmCtrl state
+	DWORD	cbFifoDown;				// bytes in the download (OUT) FIFO
+	DWORD	cbFifoUp;				// bytes in the upload (IN) FIFO
+	unsigned long long	ccyc;		// IFCLK cycles since enabled
+	unsigned long long	ccycStall;	// cycles a busy or ack signal stopped data
+	unsigned long long	cburst;		// bursts started from stIdle
+
+	SIMMUX	mux;
+} SIMSTM;
+
+/* A device on the simulated JTAG scan chain. Its shift register
+** holds the instruction register or the selected data register,
+** whichever was captured last.
+*/
+typedef struct tagSIMJDVC {
+	DWORD	idcode;					// 0 for a device with BYPASS only
+	DWORD	cbitIr;
+	DWORD	irIdcode;				// opcode of the IDCODE instruction
+	DWORD	ir;						// current instruction
+	DWORD	cbitShf;				// length of the captured register
+	unsigned long long	shf;		// shift register, TDO end in bit 0
+} SIMJDVC;
+
+/* State of the JTAG port of a simulated device and of the scan chain
+** behind it. All devices share TMS and TCK, so they are always in the
+** same TAP controller state.
+*/
+typedef struct tagSIMJTG {
+	BOOL	fEnabled;
+	DWORD	frqTck;					// TCK frequency set by DjtgSetSpeed
+	int		stTap;					// TAP controller state
+	BOOL	fTms;					// pins driven by DjtgSetTmsTdiTck
+	BOOL	fTdi;
+	BOOL	fTck;
+	int		cjdvc;
+	SIMJDVC	rgjdvc[cjdvcSimMax];	// in order from TDI to TDO
+	unsigned long long	cclk;		// TCK cycles since enabled
+	unsigned long long	cclkShift;	// cycles in Shift-IR or Shift-DR
+} SIMJTG;
+
+/* A simulated device. One is allocated for each open interface
+** handle.
+*/
+typedef struct tagSIMDVC {
+	HIF		hif;
+	char	szName[cchDvcNameMax];
+
+	BOOL	fPending;				// last transaction was overlapped
+	ERC		ercTrans;				// result of the last transaction
+	DWORD	cbTransOut;				// bytes sent by the last transaction
+	DWORD	cbTransIn;				// bytes received by the last transaction
+	DWORD	tmsTransTimeout;
+
+	/* Latency model. Times are seconds on the monotonic clock.
+	*/
+	double	dblLinkFree;			// end of the last transaction on the link
+	double	dblTransDone;			// completion of the last transaction
+	double	dblWaitUntil;			// synchronous wait owed by the caller
+	unsigned int	seedJitter;
+
+	/* Statistics
+	*/
+	DWORD	ctrans;
+	double	cbTotalOut;
+	double	cbTotalIn;
+	double	dblWireSec;				// modeled time the link was busy
+
+	SIMEPP	epp;
+	SIMSTM	stm;
+	SIMJTG	jtg;
+} SIMDVC;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+
+/* These functions are exported by the simulated DMGR library for use
+** by the simulated protocol libraries.
+*/
+SIMAPI	SIMDVC *	PsimdvcLock(HIF hif);
+SIMAPI	void		SimdvcUnlock(SIMDVC * psimdvc);
+SIMAPI	void		SimSetLastError(ERC erc);
+SIMAPI	BOOL		FSimBeginTrans(SIMDVC * psimdvc);
+SIMAPI	BOOL		FSimEndTrans(SIMDVC * psimdvc, ERC erc, DWORD cbOut, DWORD cbIn, BOOL fOverlap);
+SIMAPI	BOOL		FSimEndTransEx(SIMDVC * psimdvc, ERC erc, DWORD cbOut, DWORD cbIn,
+						double dblDesignSec, BOOL fOverlap);
+
+/* ------------------------------------------------------------ */
+
+#endif					// ADEPTSIM_INCLUDED
+
+/************************************************************************/
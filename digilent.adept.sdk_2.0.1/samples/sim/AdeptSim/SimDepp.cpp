@@ -0,0 +1,711 @@
+/************************************************************************/
+/*																		*/
+/*  SimDepp.cpp  --  Simulated DEPP Library								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DEPP entry points declared in		*/
+/*		depp.h against a software model of the DpimRef reference		*/
+/*		design (samples/depp/DeppDemo/logic/dpimref.vhd). It is built	*/
+/*		as libdepp.so and depends on the simulated libdmgr.so.			*/
+/*																		*/
+/*		Each API call is broken into the EPP bus cycles the DEPP		*/
+/*		firmware performs: an address write cycle (address strobe)		*/
+/*		loads the 4-bit regEppAdr, and each data read or write cycle	*/
+/*		(data strobe) accesses the register it selects. The repeat		*/
+/*		calls perform one address cycle followed by a data cycle per	*/
+/*		byte. The register file matches DpimRef: regData0-7 at			*/
+/*		addresses 0-7, the switches at 8, the buttons at 9 and the		*/
+/*		write-only LED register at 10. Other addresses read as 0.		*/
+/*																		*/
+/*		Register 15, which reads as 0 in DpimRef, returns an			*/
+/*		incrementing counter in the simulator. Writing it sets the		*/
+/*		next counter value. It is used to verify streaming reads.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: modeled address and data strobe cycles of DpimRef		*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "depp.h"
+#include "dmgr.h"
+#include "AdeptSim.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static SIMDVC *	PsimdvcLockEpp(HIF hif);
+static void		EppAstb(SIMEPP * psimepp, BYTE bAddr);
+static BYTE		BEppDstbRead(SIMEPP * psimepp);
+static void		EppDstbWrite(SIMEPP * psimepp, BYTE bData);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DeppGetVersion
+**
+**	Parameters:
+**		szVersion	- buffer to receive the version string
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the version string of the simulated DEPP library.
+*/
+
+BOOL DeppGetVersion(char * szVersion) {
+
+	strcpy(szVersion, "2.0.0 (AdeptSim)");
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppGetPortCount
+**
+**	Parameters:
+**		hif		- interface handle
+**		pcprt	- variable to receive the port count
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Simulated devices have a single EPP port.
+*/
+
+BOOL DeppGetPortCount(HIF hif, INT32 * pcprt) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	*pcprt = 1;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppGetPortProperties
+**
+**	Parameters:
+**		hif		- interface handle
+**		prtReq	- port number
+**		pdprp	- variable to receive the port properties
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercInvalidPort
+**
+**	Description:
+**		The simulated EPP port has no optional properties.
+*/
+
+BOOL DeppGetPortProperties(HIF hif, INT32 prtReq, DWORD * pdprp) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (prtReq != 0) {
+		SimSetLastError(ercInvalidPort);
+		return fFalse;
+	}
+
+	*pdprp = 0;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppEnable
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see DeppEnableEx
+**
+**	Description:
+**		Enables EPP port 0.
+*/
+
+BOOL DeppEnable(HIF hif) {
+
+	return DeppEnableEx(hif, 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppEnableEx
+**
+**	Parameters:
+**		hif		- interface handle
+**		prtReq	- port number
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercInvalidPort, ercPortConflict
+**
+**	Description:
+**		Enables the specified EPP port.
+*/
+
+BOOL DeppEnableEx(HIF hif, INT32 prtReq) {
+
+	SIMDVC *	psimdvc;
+	ERC			erc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	erc = ercNoErc;
+	if (prtReq != 0) {
+		erc = ercInvalidPort;
+	}
+	else if (psimdvc->epp.fEnabled) {
+		erc = ercPortConflict;
+	}
+	else {
+		psimdvc->epp.fEnabled = fTrue;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (erc != ercNoErc) {
+		SimSetLastError(erc);
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppDisable
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Disables the EPP port.
+*/
+
+BOOL DeppDisable(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	psimdvc->epp.fEnabled = fFalse;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppPutReg
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		bData		- data byte to write
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Writes a byte to a register.
+*/
+
+BOOL DeppPutReg(HIF hif, BYTE bAddr, BYTE bData, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	EppAstb(&psimdvc->epp, bAddr);
+	EppDstbWrite(&psimdvc->epp, bData);
+	fRet = FSimEndTrans(psimdvc, ercNoErc, 2, 0, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppGetReg
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		pbData		- variable to receive the data byte
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Reads a byte from a register.
+*/
+
+BOOL DeppGetReg(HIF hif, BYTE bAddr, BYTE * pbData, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	EppAstb(&psimdvc->epp, bAddr);
+	*pbData = BEppDstbRead(&psimdvc->epp);
+	fRet = FSimEndTrans(psimdvc, ercNoErc, 1, 1, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppPutRegSet
+**
+**	Parameters:
+**		hif				- interface handle
+**		pbAddrData		- buffer of register address/data pairs
+**		nAddrDataPairs	- number of pairs in pbAddrData
+**		fOverlap		- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Writes each data byte to the register given by its address.
+*/
+
+BOOL DeppPutRegSet(HIF hif, BYTE * pbAddrData, DWORD nAddrDataPairs, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	DWORD		ipair;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	for (ipair = 0; ipair < nAddrDataPairs; ipair++) {
+		EppAstb(&psimdvc->epp, pbAddrData[2*ipair]);
+		EppDstbWrite(&psimdvc->epp, pbAddrData[2*ipair+1]);
+	}
+	fRet = FSimEndTrans(psimdvc, ercNoErc, 2*nAddrDataPairs, 0, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppGetRegSet
+**
+**	Parameters:
+**		hif			- interface handle
+**		pbAddr		- buffer of register addresses
+**		pbData		- buffer to receive the data bytes
+**		cbData		- number of registers to read
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Reads pbData[i] from the register at pbAddr[i].
+*/
+
+BOOL DeppGetRegSet(HIF hif, BYTE * pbAddr, BYTE * pbData, DWORD cbData, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	DWORD		ib;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	for (ib = 0; ib < cbData; ib++) {
+		EppAstb(&psimdvc->epp, pbAddr[ib]);
+		pbData[ib] = BEppDstbRead(&psimdvc->epp);
+	}
+	fRet = FSimEndTrans(psimdvc, ercNoErc, cbData, cbData, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppPutRegRepeat
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		pbData		- data bytes to write
+**		cbData		- number of bytes to write
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Writes a stream of bytes to a single register.
+*/
+
+BOOL DeppPutRegRepeat(HIF hif, BYTE bAddr, BYTE * pbData, DWORD cbData, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	DWORD		ib;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	EppAstb(&psimdvc->epp, bAddr);
+	for (ib = 0; ib < cbData; ib++) {
+		EppDstbWrite(&psimdvc->epp, pbData[ib]);
+	}
+	fRet = FSimEndTrans(psimdvc, ercNoErc, cbData + 1, 0, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppGetRegRepeat
+**
+**	Parameters:
+**		hif			- interface handle
+**		bAddr		- register address
+**		pbData		- buffer to receive the data bytes
+**		cbData		- number of bytes to read
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Reads a stream of bytes from a single register.
+*/
+
+BOOL DeppGetRegRepeat(HIF hif, BYTE bAddr, BYTE * pbData, DWORD cbData, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	DWORD		ib;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	EppAstb(&psimdvc->epp, bAddr);
+	for (ib = 0; ib < cbData; ib++) {
+		pbData[ib] = BEppDstbRead(&psimdvc->epp);
+	}
+	fRet = FSimEndTrans(psimdvc, ercNoErc, 1, cbData, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DeppSetTimeout
+**
+**	Parameters:
+**		hif				- interface handle
+**		tnsTimeoutTry	- requested timeout in nanoseconds
+**		ptnsTimeout		- variable to receive the timeout set
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		The simulated design never stalls the strobes, so any timeout
+**		is accepted as requested.
+*/
+
+BOOL DeppSetTimeout(HIF hif, DWORD tnsTimeoutTry, DWORD * ptnsTimeout) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLockEpp(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (ptnsTimeout != NULL) {
+		*ptnsTimeout = tnsTimeoutTry;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	PsimdvcLockEpp
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		locked simulated device, or NULL
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Locks the device owning hif and checks that its EPP port has
+**		been enabled.
+*/
+
+static SIMDVC * PsimdvcLockEpp(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return NULL;
+	}
+
+	if (!psimdvc->epp.fEnabled) {
+		SimdvcUnlock(psimdvc);
+		SimSetLastError(ercCapabilityNotEnabled);
+		return NULL;
+	}
+
+	return psimdvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	EppAstb
+**
+**	Parameters:
+**		psimepp		- EPP port state
+**		bAddr		- address driven onto the data bus
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models an address write cycle. The design latches the low 4
+**		bits of the bus into regEppAdr.
+*/
+
+static void EppAstb(SIMEPP * psimepp, BYTE bAddr) {
+
+	psimepp->bAdr = bAddr & bEppAdrMask;
+	psimepp->castb++;
+}
+
+/* ------------------------------------------------------------ */
+/***	BEppDstbRead
+**
+**	Parameters:
+**		psimepp		- EPP port state
+**
+**	Return Value:
+**		value driven onto the data bus by the design
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models a data read cycle of the register selected by
+**		regEppAdr (the busEppData multiplexer of DpimRef).
+*/
+
+static BYTE BEppDstbRead(SIMEPP * psimepp) {
+
+	BYTE	bAdr = psimepp->bAdr;
+
+	psimepp->cdstb++;
+
+	if (bAdr < cregEppData) {
+		return psimepp->rgbData[bAdr];
+	}
+
+	switch (bAdr) {
+		case regEppSwt:
+			return psimepp->bSwt;
+
+		case regEppBtn:
+			return psimepp->bBtn & 0x1F;
+
+		case regEppCntr:
+			return psimepp->bCntr++;
+
+		default:
+			return 0;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	EppDstbWrite
+**
+**	Parameters:
+**		psimepp		- EPP port state
+**		bData		- value driven onto the data bus
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models a data write cycle to the register selected by
+**		regEppAdr. Writes to the switch, button and unused registers
+**		are ignored, as in DpimRef.
+*/
+
+static void EppDstbWrite(SIMEPP * psimepp, BYTE bData) {
+
+	BYTE	bAdr = psimepp->bAdr;
+
+	psimepp->cdstb++;
+
+	if (bAdr < cregEppData) {
+		psimepp->rgbData[bAdr] = bData;
+	}
+	else if (bAdr == regEppLed) {
+		psimepp->bLed = bData;
+	}
+	else if (bAdr == regEppCntr) {
+		psimepp->bCntr = bData;
+	}
+}
+
+/* ------------------------------------------------------------ */
+
+/************************************************************************/
@@ -0,0 +1,1098 @@
+/************************************************************************/
+/*																		*/
+/*  SimDjtg.cpp  --  Simulated DJTG Library								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DJTG entry points declared in		*/
+/*		djtg.h against a software model of a JTAG scan chain. It is		*/
+/*		built as libdjtg.so and depends on the simulated libdmgr.so.	*/
+/*																		*/
+/*		Every device of the chain has an IEEE 1149.1 TAP controller,	*/
+/*		all driven by the same TMS and TCK, an instruction register		*/
+/*		that captures ...01, a BYPASS register that captures 0 and,		*/
+/*		unless it is a BYPASS only device, a 32-bit IDCODE register.	*/
+/*		Test-Logic-Reset selects IDCODE, or BYPASS on a device			*/
+/*		without one. Any instruction other than IDCODE selects			*/
+/*		BYPASS. TDI of the chain enters the first device and TDO		*/
+/*		leaves the last; TDO reads 1 outside the shift states, as		*/
+/*		with the pull up of a real cable.								*/
+/*																		*/
+/*		Each call that clocks TCK is one transaction. Its TDO bit		*/
+/*		for a clock is sampled before the rising edge, so in Shift-DR	*/
+/*		the first bit returned is bit 0 of the register of the last		*/
+/*		device. The chain and the timing are read from the				*/
+/*		environment when the library is first used:						*/
+/*																		*/
+/*			ADEPT_SIM_JTG_CHAIN		- devices from TDI to TDO,			*/
+/*									  comma separated, each				*/
+/*									  "idcode:irlen[:opcode]" or		*/
+/*									  "bypass:irlen"; opcode is the		*/
+/*									  IDCODE instruction (default 1).	*/
+/*									  The default is the Nexys2 chain,	*/
+/*									  "0x41c22093:6:0x09,				*/
+/*									  0xf5046093:8:0xfe".				*/
+/*			ADEPT_SIM_JTG_TIMED		- 1 to make each transaction last	*/
+/*									  at least its TCK cycles at the	*/
+/*									  speed set by DjtgSetSpeed			*/
+/*																		*/
+/*		TCK is 30 MHz divided by a whole number, 3.75 MHz when the		*/
+/*		port is enabled.												*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "djtg.h"
+#include "dmgr.h"
+#include "AdeptSim.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* TAP controller states.
+*/
+const int		stJtgReset		= 0;	// Test-Logic-Reset
+const int		stJtgIdle		= 1;	// Run-Test/Idle
+const int		stJtgSelDr		= 2;
+const int		stJtgCapDr		= 3;
+const int		stJtgShfDr		= 4;
+const int		stJtgEx1Dr		= 5;
+const int		stJtgPauDr		= 6;
+const int		stJtgEx2Dr		= 7;
+const int		stJtgUpdDr		= 8;
+const int		stJtgSelIr		= 9;
+const int		stJtgCapIr		= 10;
+const int		stJtgShfIr		= 11;
+const int		stJtgEx1Ir		= 12;
+const int		stJtgPauIr		= 13;
+const int		stJtgEx2Ir		= 14;
+const int		stJtgUpdIr		= 15;
+const int		cstJtg			= 16;
+
+/* Next state of the TAP controller for TMS low and TMS high.
+*/
+static const int	rgstJtgNext[cstJtg][2] = {
+	{ stJtgIdle,	stJtgReset },	// stJtgReset
+	{ stJtgIdle,	stJtgSelDr },	// stJtgIdle
+	{ stJtgCapDr,	stJtgSelIr },	// stJtgSelDr
+	{ stJtgShfDr,	stJtgEx1Dr },	// stJtgCapDr
+	{ stJtgShfDr,	stJtgEx1Dr },	// stJtgShfDr
+	{ stJtgPauDr,	stJtgUpdDr },	// stJtgEx1Dr
+	{ stJtgPauDr,	stJtgEx2Dr },	// stJtgPauDr
+	{ stJtgShfDr,	stJtgUpdDr },	// stJtgEx2Dr
+	{ stJtgIdle,	stJtgSelDr },	// stJtgUpdDr
+	{ stJtgCapIr,	stJtgReset },	// stJtgSelIr
+	{ stJtgShfIr,	stJtgEx1Ir },	// stJtgCapIr
+	{ stJtgShfIr,	stJtgEx1Ir },	// stJtgShfIr
+	{ stJtgPauIr,	stJtgUpdIr },	// stJtgEx1Ir
+	{ stJtgPauIr,	stJtgEx2Ir },	// stJtgPauIr
+	{ stJtgShfIr,	stJtgUpdIr },	// stJtgEx2Ir
+	{ stJtgIdle,	stJtgSelDr },	// stJtgUpdIr
+};
+
+/* What a call clocks: TDI bits with TMS held, TMS bits with TDI held,
+** TMS/TDI bit pairs, or held TMS and TDI with or without TDO.
+*/
+const int		jopTdi			= 0;
+const int		jopTms			= 1;
+const int		jopPair			= 2;
+const int		jopTdo			= 3;
+const int		jopClock		= 4;
+
+/* TCK is frqTckMax divided by a whole number up to cdivTckMax.
+*/
+const DWORD		frqTckMax		= 30000000;
+const DWORD		cdivTckMax		= 65536;
+const DWORD		cdivTckDefault	= 8;
+
+const char		szJtgChainDefault[]	= "0x41c22093:6:0x09,0xf5046093:8:0xfe";
+
+/* Parameters read from the environment.
+*/
+typedef struct tagJTGCFG {
+	int			cjdvc;
+	SIMJDVC		rgjdvc[cjdvcSimMax];
+	BOOL		fTimed;
+} JTGCFG;
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_once_t	onceJtgCfg = PTHREAD_ONCE_INIT;
+static JTGCFG			jtgcfg;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static SIMDVC *	PsimdvcLockJtg(HIF hif);
+static BOOL		FJtgTrans(HIF hif, int jop, BOOL fTms, BOOL fTdi, BYTE * rgbSnd,
+					BYTE * rgbRcv, DWORD cbit, BOOL fOverlap);
+static void		JtgReset(SIMJTG * psimjtg);
+static BOOL		FJtgClock(SIMJTG * psimjtg, BOOL fTms, BOOL fTdi);
+static BOOL		FJtgTdo(const SIMJTG * psimjtg);
+static void		JtgLoadCfg();
+static BOOL		FJtgParseChain(const char * szChain);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DjtgGetVersion
+**
+**	Parameters:
+**		szVersion	- buffer to receive the version string
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the version string of the simulated DJTG library.
+*/
+
+BOOL DjtgGetVersion(char * szVersion) {
+
+	strcpy(szVersion, "2.0.0 (AdeptSim)");
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgGetPortCount
+**
+**	Parameters:
+**		hif		- interface handle
+**		pcprt	- variable to receive the port count
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Simulated devices have a single JTAG port.
+*/
+
+BOOL DjtgGetPortCount(HIF hif, INT32 * pcprt) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	*pcprt = 1;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgGetPortProperties
+**
+**	Parameters:
+**		hif		- interface handle
+**		prtReq	- port number
+**		pdprp	- variable to receive the port properties
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercInvalidPort
+**
+**	Description:
+**		The simulated JTAG port can set its speed and drives its pins
+**		directly.
+*/
+
+BOOL DjtgGetPortProperties(HIF hif, INT32 prtReq, DWORD * pdprp) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (prtReq != 0) {
+		SimSetLastError(ercInvalidPort);
+		return fFalse;
+	}
+
+	*pdprp = dprpJtgSetSpeed | dprpJtgSetPinState;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgEnable
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see DjtgEnableEx
+**
+**	Description:
+**		Enables JTAG port 0.
+*/
+
+BOOL DjtgEnable(HIF hif) {
+
+	return DjtgEnableEx(hif, 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgEnableEx
+**
+**	Parameters:
+**		hif		- interface handle
+**		prtReq	- port number
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercInvalidPort, ercPortConflict
+**
+**	Description:
+**		Enables the specified JTAG port. The chain is built from the
+**		configuration and reset: every TAP controller starts in
+**		Test-Logic-Reset, and TCK runs at the default speed. The
+**		cycle counts restart.
+*/
+
+BOOL DjtgEnableEx(HIF hif, INT32 prtReq) {
+
+	SIMDVC *	psimdvc;
+	SIMJTG *	psimjtg;
+	ERC			erc;
+
+	pthread_once(&onceJtgCfg, JtgLoadCfg);
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	psimjtg = &psimdvc->jtg;
+
+	erc = ercNoErc;
+	if (prtReq != 0) {
+		erc = ercInvalidPort;
+	}
+	else if (psimjtg->fEnabled) {
+		erc = ercPortConflict;
+	}
+	else {
+		psimjtg->cjdvc = jtgcfg.cjdvc;
+		memcpy(psimjtg->rgjdvc, jtgcfg.rgjdvc, sizeof(psimjtg->rgjdvc));
+		psimjtg->frqTck = frqTckMax / cdivTckDefault;
+		psimjtg->fTms = fFalse;
+		psimjtg->fTdi = fFalse;
+		psimjtg->fTck = fFalse;
+		psimjtg->cclk = 0;
+		psimjtg->cclkShift = 0;
+		JtgReset(psimjtg);
+		psimjtg->fEnabled = fTrue;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (erc != ercNoErc) {
+		SimSetLastError(erc);
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgDisable
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Disables the JTAG port.
+*/
+
+BOOL DjtgDisable(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLockJtg(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	psimdvc->jtg.fEnabled = fFalse;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgGetSpeed
+**
+**	Parameters:
+**		hif			- interface handle
+**		pfrqCur		- variable to receive the TCK frequency in Hz
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Returns the current TCK frequency.
+*/
+
+BOOL DjtgGetSpeed(HIF hif, DWORD * pfrqCur) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLockJtg(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	*pfrqCur = psimdvc->jtg.frqTck;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSetSpeed
+**
+**	Parameters:
+**		hif			- interface handle
+**		frqReq		- requested TCK frequency in Hz
+**		pfrqSet		- variable to receive the frequency set
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercInvalidParameter
+**
+**	Description:
+**		Sets TCK to the highest frequency the port can make that is
+**		not above frqReq, or to its lowest frequency.
+*/
+
+BOOL DjtgSetSpeed(HIF hif, DWORD frqReq, DWORD * pfrqSet) {
+
+	SIMDVC *	psimdvc;
+	DWORD		cdiv;
+
+	if (frqReq == 0) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	psimdvc = PsimdvcLockJtg(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	cdiv = (frqTckMax + frqReq - 1) / frqReq;
+	if (cdiv < 1) {
+		cdiv = 1;
+	}
+	if (cdiv > cdivTckMax) {
+		cdiv = cdivTckMax;
+	}
+
+	psimdvc->jtg.frqTck = frqTckMax / cdiv;
+	if (pfrqSet != NULL) {
+		*pfrqSet = psimdvc->jtg.frqTck;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgSetTmsTdiTck
+**
+**	Parameters:
+**		hif		- interface handle
+**		fTms	- TMS pin state
+**		fTdi	- TDI pin state
+**		fTck	- TCK pin state
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Drives the pins. Raising TCK clocks the chain with the TMS
+**		and TDI given.
+*/
+
+BOOL DjtgSetTmsTdiTck(HIF hif, BOOL fTms, BOOL fTdi, BOOL fTck) {
+
+	SIMDVC *	psimdvc;
+	SIMJTG *	psimjtg;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockJtg(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	psimjtg = &psimdvc->jtg;
+	if (fTck && !psimjtg->fTck) {
+		FJtgClock(psimjtg, fTms, fTdi);
+	}
+
+	psimjtg->fTms = fTms ? fTrue : fFalse;
+	psimjtg->fTdi = fTdi ? fTrue : fFalse;
+	psimjtg->fTck = fTck ? fTrue : fFalse;
+
+	fRet = FSimEndTrans(psimdvc, ercNoErc, 1, 0, fFalse);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgGetTmsTdiTdoTck
+**
+**	Parameters:
+**		hif		- interface handle
+**		pfTms	- variable to receive the TMS pin state
+**		pfTdi	- variable to receive the TDI pin state
+**		pfTdo	- variable to receive the TDO pin state
+**		pfTck	- variable to receive the TCK pin state
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercTransferPending
+**
+**	Description:
+**		Reads the pins. Any of the variables may be NULL.
+*/
+
+BOOL DjtgGetTmsTdiTdoTck(HIF hif, BOOL * pfTms, BOOL * pfTdi, BOOL * pfTdo, BOOL * pfTck) {
+
+	SIMDVC *	psimdvc;
+	SIMJTG *	psimjtg;
+	BOOL		fRet;
+
+	psimdvc = PsimdvcLockJtg(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	psimjtg = &psimdvc->jtg;
+	if (pfTms != NULL) {
+		*pfTms = psimjtg->fTms;
+	}
+	if (pfTdi != NULL) {
+		*pfTdi = psimjtg->fTdi;
+	}
+	if (pfTdo != NULL) {
+		*pfTdo = FJtgTdo(psimjtg);
+	}
+	if (pfTck != NULL) {
+		*pfTck = psimjtg->fTck;
+	}
+
+	fRet = FSimEndTrans(psimdvc, ercNoErc, 0, 1, fFalse);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgPutTdiBits
+**
+**	Parameters:
+**		hif			- interface handle
+**		fTms		- TMS for every clock
+**		rgbSnd		- TDI bits, LSB of the first byte first
+**		rgbRcv		- buffer to receive the TDO bits, or NULL
+**		cbits		- number of clocks
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FJtgTrans
+**
+**	Description:
+**		Shifts TDI bits with TMS held.
+*/
+
+BOOL DjtgPutTdiBits(HIF hif, BOOL fTms, BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbits, BOOL fOverlap) {
+
+	return FJtgTrans(hif, jopTdi, fTms, fFalse, rgbSnd, rgbRcv, cbits, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgPutTmsBits
+**
+**	Parameters:
+**		hif			- interface handle
+**		fTdi		- TDI for every clock
+**		rgbSnd		- TMS bits, LSB of the first byte first
+**		rgbRcv		- buffer to receive the TDO bits, or NULL
+**		cbits		- number of clocks
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FJtgTrans
+**
+**	Description:
+**		Clocks TMS bits with TDI held.
+*/
+
+BOOL DjtgPutTmsBits(HIF hif, BOOL fTdi, BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbits, BOOL fOverlap) {
+
+	return FJtgTrans(hif, jopTms, fFalse, fTdi, rgbSnd, rgbRcv, cbits, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgPutTmsTdiBits
+**
+**	Parameters:
+**		hif			- interface handle
+**		rgbSnd		- TMS/TDI bit pairs, four per byte, TDI in the
+**					  low bit of each pair
+**		rgbRcv		- buffer to receive the TDO bits, or NULL
+**		cbitpairs	- number of clocks
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FJtgTrans
+**
+**	Description:
+**		Clocks one TMS/TDI bit pair per clock.
+*/
+
+BOOL DjtgPutTmsTdiBits(HIF hif, BYTE * rgbSnd, BYTE * rgbRcv, DWORD cbitpairs, BOOL fOverlap) {
+
+	return FJtgTrans(hif, jopPair, fFalse, fFalse, rgbSnd, rgbRcv, cbitpairs, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgGetTdoBits
+**
+**	Parameters:
+**		hif			- interface handle
+**		fTdi		- TDI for every clock
+**		fTms		- TMS for every clock
+**		rgbRcv		- buffer to receive the TDO bits
+**		cbits		- number of clocks
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FJtgTrans
+**
+**	Description:
+**		Reads TDO with TMS and TDI held.
+*/
+
+BOOL DjtgGetTdoBits(HIF hif, BOOL fTdi, BOOL fTms, BYTE * rgbRcv, DWORD cbits, BOOL fOverlap) {
+
+	if (rgbRcv == NULL) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	return FJtgTrans(hif, jopTdo, fTms, fTdi, NULL, rgbRcv, cbits, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	DjtgClockTck
+**
+**	Parameters:
+**		hif			- interface handle
+**		fTms		- TMS for every clock
+**		fTdi		- TDI for every clock
+**		cclk		- number of clocks
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FJtgTrans
+**
+**	Description:
+**		Clocks TCK with TMS and TDI held.
+*/
+
+BOOL DjtgClockTck(HIF hif, BOOL fTms, BOOL fTdi, DWORD cclk, BOOL fOverlap) {
+
+	return FJtgTrans(hif, jopClock, fTms, fTdi, NULL, NULL, cclk, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	PsimdvcLockJtg
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		locked simulated device, or NULL
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Locks the device owning hif and checks that its JTAG port has
+**		been enabled.
+*/
+
+static SIMDVC * PsimdvcLockJtg(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return NULL;
+	}
+
+	if (!psimdvc->jtg.fEnabled) {
+		SimdvcUnlock(psimdvc);
+		SimSetLastError(ercCapabilityNotEnabled);
+		return NULL;
+	}
+
+	return psimdvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJtgTrans
+**
+**	Parameters:
+**		hif			- interface handle
+**		jop			- what the call clocks, see jopTdi
+**		fTms		- TMS held for jopTdi, jopTdo and jopClock
+**		fTdi		- TDI held for jopTms, jopTdo and jopClock
+**		rgbSnd		- TDI bits, TMS bits or bit pairs to send
+**		rgbRcv		- buffer to receive the TDO bits, or NULL
+**		cbit		- number of clocks
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercInvalidParameter,
+**		ercTransferPending
+**
+**	Description:
+**		Performs one JTAG transaction of cbit clocks. TCK is left low.
+**		If the chain is timed, the transaction lasts at least its
+**		clocks at the current TCK frequency.
+*/
+
+static BOOL FJtgTrans(HIF hif, int jop, BOOL fTms, BOOL fTdi, BYTE * rgbSnd,
+					BYTE * rgbRcv, DWORD cbit, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	SIMJTG *	psimjtg;
+	DWORD		ibit;
+	DWORD		cbOut;
+	BOOL		fTdo;
+	BOOL		fRet;
+
+	if ((jop < jopTdo) && (rgbSnd == NULL) && (cbit != 0)) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	pthread_once(&onceJtgCfg, JtgLoadCfg);
+
+	psimdvc = PsimdvcLockJtg(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	psimjtg = &psimdvc->jtg;
+
+	if (rgbRcv != NULL) {
+		memset(rgbRcv, 0, (cbit + 7) / 8);
+	}
+
+	for (ibit = 0; ibit < cbit; ibit++) {
+		if (jop == jopTdi) {
+			fTdi = (rgbSnd[ibit / 8] >> (ibit % 8)) & 1;
+		}
+		else if (jop == jopTms) {
+			fTms = (rgbSnd[ibit / 8] >> (ibit % 8)) & 1;
+		}
+		else if (jop == jopPair) {
+			fTdi = (rgbSnd[ibit / 4] >> (2 * (ibit % 4))) & 1;
+			fTms = (rgbSnd[ibit / 4] >> (2 * (ibit % 4) + 1)) & 1;
+		}
+
+		fTdo = FJtgClock(psimjtg, fTms, fTdi);
+		if ((rgbRcv != NULL) && fTdo) {
+			rgbRcv[ibit / 8] |= (BYTE) (1 << (ibit % 8));
+		}
+	}
+
+	psimjtg->fTms = fTms;
+	psimjtg->fTdi = fTdi;
+	psimjtg->fTck = fFalse;
+
+	if (jop == jopPair) {
+		cbOut = (cbit + 3) / 4;
+	}
+	else if (jop < jopTdo) {
+		cbOut = (cbit + 7) / 8;
+	}
+	else {
+		cbOut = 0;
+	}
+
+	fRet = FSimEndTransEx(psimdvc, ercNoErc, cbOut, (rgbRcv != NULL) ? (cbit + 7) / 8 : 0,
+			jtgcfg.fTimed ? (double) cbit / psimjtg->frqTck : 0, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	JtgReset
+**
+**	Parameters:
+**		psimjtg		- JTAG port state
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Puts every TAP controller in Test-Logic-Reset, which loads
+**		the IDCODE instruction, or BYPASS on a device without it.
+*/
+
+static void JtgReset(SIMJTG * psimjtg) {
+
+	SIMJDVC *	pjdvc;
+	int			ijdvc;
+
+	psimjtg->stTap = stJtgReset;
+
+	for (ijdvc = 0; ijdvc < psimjtg->cjdvc; ijdvc++) {
+		pjdvc = &psimjtg->rgjdvc[ijdvc];
+		pjdvc->ir = (pjdvc->idcode != 0) ? pjdvc->irIdcode : (DWORD) ((1ULL << pjdvc->cbitIr) - 1);
+		pjdvc->cbitShf = 1;
+		pjdvc->shf = 0;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FJtgClock
+**
+**	Parameters:
+**		psimjtg		- JTAG port state
+**		fTms		- TMS
+**		fTdi		- TDI
+**
+**	Return Value:
+**		TDO sampled before the rising edge of TCK
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models one TCK cycle. On the rising edge each device acts on
+**		the current state: the capture states load the shift register,
+**		the shift states shift it towards TDO with the TDO of the
+**		previous device, or TDI, entering at the top, and Update-IR
+**		loads the instruction. Then the TAP controllers take the next
+**		state.
+*/
+
+static BOOL FJtgClock(SIMJTG * psimjtg, BOOL fTms, BOOL fTdi) {
+
+	SIMJDVC *	pjdvc;
+	BOOL		fTdo;
+	BOOL		fIn;
+	BOOL		fOut;
+	int			ijdvc;
+
+	fTdo = FJtgTdo(psimjtg);
+
+	switch (psimjtg->stTap) {
+		case stJtgReset:
+			JtgReset(psimjtg);
+			break;
+
+		case stJtgCapIr:
+			for (ijdvc = 0; ijdvc < psimjtg->cjdvc; ijdvc++) {
+				pjdvc = &psimjtg->rgjdvc[ijdvc];
+				pjdvc->cbitShf = pjdvc->cbitIr;
+				pjdvc->shf = 0x01;
+			}
+			break;
+
+		case stJtgCapDr:
+			for (ijdvc = 0; ijdvc < psimjtg->cjdvc; ijdvc++) {
+				pjdvc = &psimjtg->rgjdvc[ijdvc];
+				if ((pjdvc->idcode != 0) && (pjdvc->ir == pjdvc->irIdcode)) {
+					pjdvc->cbitShf = 32;
+					pjdvc->shf = pjdvc->idcode;
+				}
+				else {
+					pjdvc->cbitShf = 1;
+					pjdvc->shf = 0;
+				}
+			}
+			break;
+
+		case stJtgShfIr:
+		case stJtgShfDr:
+			fIn = fTdi ? fTrue : fFalse;
+			for (ijdvc = 0; ijdvc < psimjtg->cjdvc; ijdvc++) {
+				pjdvc = &psimjtg->rgjdvc[ijdvc];
+				fOut = (BOOL) (pjdvc->shf & 1);
+				pjdvc->shf = (pjdvc->shf >> 1) | ((unsigned long long) fIn << (pjdvc->cbitShf - 1));
+				fIn = fOut;
+			}
+			psimjtg->cclkShift++;
+			break;
+
+		case stJtgUpdIr:
+			for (ijdvc = 0; ijdvc < psimjtg->cjdvc; ijdvc++) {
+				pjdvc = &psimjtg->rgjdvc[ijdvc];
+				pjdvc->ir = (DWORD) pjdvc->shf;
+			}
+			break;
+	}
+
+	psimjtg->stTap = rgstJtgNext[psimjtg->stTap][fTms ? 1 : 0];
+	psimjtg->cclk++;
+
+	return fTdo;
+}
+
+/* ------------------------------------------------------------ */
+/***	FJtgTdo
+**
+**	Parameters:
+**		psimjtg		- JTAG port state
+**
+**	Return Value:
+**		state of TDO
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		In the shift states TDO is bit 0 of the shift register of the
+**		last device. Otherwise it is not driven and reads 1. A chain
+**		with no devices connects TDI to TDO, which reads 1.
+*/
+
+static BOOL FJtgTdo(const SIMJTG * psimjtg) {
+
+	if ((psimjtg->cjdvc == 0) ||
+		((psimjtg->stTap != stJtgShfIr) && (psimjtg->stTap != stJtgShfDr))) {
+		return fTrue;
+	}
+
+	return (BOOL) (psimjtg->rgjdvc[psimjtg->cjdvc - 1].shf & 1);
+}
+
+/* ------------------------------------------------------------ */
+/***	JtgLoadCfg
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the chain and the timing from the environment. An
+**		invalid chain is reported and the default chain is used.
+*/
+
+static void JtgLoadCfg() {
+
+	const char *	szVal;
+
+	szVal = getenv("ADEPT_SIM_JTG_CHAIN");
+	if ((szVal != NULL) && !FJtgParseChain(szVal)) {
+		fprintf(stderr, "AdeptSim: ADEPT_SIM_JTG_CHAIN ignored, must be a list of "
+			"idcode:irlen[:opcode] or bypass:irlen\n");
+		szVal = NULL;
+	}
+	if (szVal == NULL) {
+		FJtgParseChain(szJtgChainDefault);
+	}
+
+	szVal = getenv("ADEPT_SIM_JTG_TIMED");
+	jtgcfg.fTimed = (szVal != NULL) && (atoi(szVal) != 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	FJtgParseChain
+**
+**	Parameters:
+**		szChain		- chain description, see the module description
+**
+**	Return Value:
+**		fTrue if the chain is valid, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses the chain into jtgcfg. An IDCODE must have bit 0 set,
+**		an instruction register must be 2 to 32 bits long, and the
+**		IDCODE opcode must fit it and must not be all ones, which is
+**		BYPASS.
+*/
+
+static BOOL FJtgParseChain(const char * szChain) {
+
+	SIMJDVC *		pjdvc;
+	const char *	pch;
+	char *			pchEnd;
+	unsigned long	cbitIr;
+	unsigned long	irIdcode;
+
+	jtgcfg.cjdvc = 0;
+	pch = szChain;
+
+	while (*pch != '\0') {
+		if (jtgcfg.cjdvc == cjdvcSimMax) {
+			return fFalse;
+		}
+		pjdvc = &jtgcfg.rgjdvc[jtgcfg.cjdvc];
+		memset(pjdvc, 0, sizeof(SIMJDVC));
+
+		if (strncmp(pch, "bypass", 6) == 0) {
+			pchEnd = (char *) pch + 6;
+		}
+		else {
+			pjdvc->idcode = (DWORD) strtoul(pch, &pchEnd, 0);
+			if ((pchEnd == pch) || ((pjdvc->idcode & 1) == 0)) {
+				return fFalse;
+			}
+		}
+		if (*pchEnd != ':') {
+			return fFalse;
+		}
+
+		pch = pchEnd + 1;
+		cbitIr = strtoul(pch, &pchEnd, 0);
+		if ((pchEnd == pch) || (cbitIr < 2) || (cbitIr > cbitSimIrMax)) {
+			return fFalse;
+		}
+
+		irIdcode = 1;
+		if (*pchEnd == ':') {
+			pch = pchEnd + 1;
+			irIdcode = strtoul(pch, &pchEnd, 0);
+			if ((pchEnd == pch) || (pjdvc->idcode == 0)) {
+				return fFalse;
+			}
+		}
+		if (irIdcode >= (1ULL << cbitIr) - 1) {
+			return fFalse;
+		}
+
+		pjdvc->cbitIr = (DWORD) cbitIr;
+		pjdvc->irIdcode = (DWORD) irIdcode;
+		jtgcfg.cjdvc++;
+
+		if (*pchEnd == ',') {
+			pchEnd++;
+		}
+		else if (*pchEnd != '\0') {
+			return fFalse;
+		}
+		pch = pchEnd;
+	}
+
+	return jtgcfg.cjdvc > 0;
+}
+
+/************************************************************************/
@@ -0,0 +1,1482 @@
+/************************************************************************/
+/*																		*/
+/*  SimDmgr.cpp  --  Simulated DMGR Library								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DMGR entry points declared in		*/
+/*		dmgr.h on top of simulated devices. It is built as libdmgr.so	*/
+/*		so that an application linked against the Adept Runtime can be	*/
+/*		run against the simulator by changing the library search path.	*/
+/*																		*/
+/*		Any device name passed to DmgrOpen opens a new simulated		*/
+/*		device. Each open interface handle owns its own device state.	*/
+/*		Enumeration returns the devices named in $ADEPT_SIM_DEVICES		*/
+/*		(comma separated, default "SimEpp").							*/
+/*																		*/
+/*		Latency model: each transaction occupies the link of its		*/
+/*		device for														*/
+/*																		*/
+/*			latency + bytes * time per byte + random jitter				*/
+/*																		*/
+/*		and starts when the previous transaction on the link ends. A	*/
+/*		synchronous call returns when its transaction ends; an			*/
+/*		overlapped call returns at once and DmgrGetTransResult waits	*/
+/*		for the end. The parameters are read from the environment		*/
+/*		when the library is first used:									*/
+/*																		*/
+/*			ADEPT_SIM_LATENCY_US	- fixed time per transaction		*/
+/*			ADEPT_SIM_NS_PER_BYTE	- time per byte sent or received	*/
+/*			ADEPT_SIM_JITTER_US		- maximum uniform random jitter		*/
+/*																		*/
+/*		All default to 0, which completes transactions at once.			*/
+/*		ADEPT_SIM_STATS=1 prints the transaction statistics of each		*/
+/*		device to stderr when it is closed. ADEPT_SIM_SWT and			*/
+/*		ADEPT_SIM_BTN set the switch and button inputs of the			*/
+/*		simulated DpimRef design.										*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: added latency model, enumeration and statistics			*/
+/*	10/17/2026: open devices by enumerated connection string			*/
+/*	10/17/2026: report the DSTM capability								*/
+/*	10/17/2026: added FSimEndTransEx for designs with their own timing	*/
+/*	10/17/2026: report the DJTG capability								*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dpcdecl.h"
+#include "dmgr.h"
+#include "AdeptSim.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+typedef struct tagERCSZ {
+	ERC				erc;
+	const char *	szErc;
+	const char *	szMsg;
+} ERCSZ;
+
+static const ERCSZ	rgercsz[] = {
+	{ ercNoErc,					"ercNoErc",					"No error occurred" },
+	{ ercNotSupported,			"ercNotSupported",			"Capability or function not supported by the device" },
+	{ ercTransferCancelled,		"ercTransferCancelled",		"The transfer was cancelled or timeout occured" },
+	{ ercCapabilityNotEnabled,	"ercCapNotEnabled",			"The protocol is not enabled" },
+	{ ercInvalidPort,			"ercInvalidPort",			"The port number specified isn't a valid port on the device" },
+	{ ercBadParameter,			"ercBadParameter",			"Command parameter out of range" },
+	{ ercInvalidHif,			"ercInvalidHif",			"Invalid interface handle provided" },
+	{ ercInvalidParameter,		"ercInvalidParameter",		"Invalid parameter sent in API call" },
+	{ ercTransferPending,		"ercTransferPending",		"The last API called in overlapped mode was not finished" },
+	{ ercPortConflict,			"ercPortConflict",			"Attempt to enable port when another port is already enabled" },
+	{ ercTooManyOpenedDevices,	"ercTooManyOpened",			"Too many simultaneously opened interface handles" },
+};
+
+/* Product ID and firmware version reported for simulated devices.
+*/
+const PDID		pdidSim			= 0x00000000;
+const FWVER		fwverSim		= 0x0200;
+
+/* Capabilities of simulated devices.
+*/
+const DCAP		dcapSim			= dcapEpp | dcapStm | dcapJtg;
+
+/* Waits longer than this sleep until shortly before the deadline and
+** spin for the rest, as a sleep may overshoot by tens of microseconds.
+*/
+const double	dblSpinSec		= 200e-6;
+
+/* Parameters read from the environment.
+*/
+typedef struct tagSIMCFG {
+	double	dblLatencySec;
+	double	dblSecPerByte;
+	double	dblJitterSec;
+	BOOL	fStats;
+	BYTE	bSwt;
+	BYTE	bBtn;
+	int		cdvcEnum;
+	char	rgszDvcEnum[csimdvcMax][cchDvcNameMax];
+} SIMCFG;
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_mutex_t	mtxSim = PTHREAD_MUTEX_INITIALIZER;
+static SIMDVC *			rgpsimdvc[csimdvcMax];
+static ERC				ercLast = ercNoErc;
+
+static pthread_once_t	onceCfg = PTHREAD_ONCE_INIT;
+static SIMCFG			simcfg;
+
+static BOOL				fEnum = fFalse;			// enumeration results valid
+static int				cdvcFound = 0;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static SIMDVC *	PsimdvcFromHif(HIF hif);
+static void		SimLoadCfg();
+static double	DblEnvVal(const char * szVar, double dblDefault);
+static double	DblSimTimeSec();
+static void		SimSleepUntil(double dblDeadline);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DmgrGetVersion
+**
+**	Parameters:
+**		szVersion	- buffer to receive the version string
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the version string of the simulated DMGR library.
+*/
+
+BOOL DmgrGetVersion(char * szVersion) {
+
+	strcpy(szVersion, "2.0.0 (AdeptSim)");
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetLastError
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		error code of the last failed call in this process
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the last error code set by a simulated library.
+*/
+
+ERC DmgrGetLastError() {
+
+	ERC		erc;
+
+	pthread_mutex_lock(&mtxSim);
+	erc = ercLast;
+	pthread_mutex_unlock(&mtxSim);
+
+	return erc;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrSzFromErc
+**
+**	Parameters:
+**		erc				- error code to look up
+**		szErc			- buffer to receive the symbolic name
+**		szErcMessage	- buffer to receive the description
+**
+**	Return Value:
+**		fTrue if the error code is known, fFalse if not
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Translates an error code into its symbolic name and message.
+*/
+
+BOOL DmgrSzFromErc(ERC erc, char * szErc, char * szErcMessage) {
+
+	unsigned	iercsz;
+
+	for (iercsz = 0; iercsz < sizeof(rgercsz)/sizeof(rgercsz[0]); iercsz++) {
+		if (rgercsz[iercsz].erc == erc) {
+			snprintf(szErc, cchErcMax, "%s", rgercsz[iercsz].szErc);
+			snprintf(szErcMessage, cchErcMsgMax, "%s", rgercsz[iercsz].szMsg);
+			return fTrue;
+		}
+	}
+
+	snprintf(szErc, cchErcMax, "erc%d", erc);
+	snprintf(szErcMessage, cchErcMsgMax, "Unknown error");
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrOpen
+**
+**	Parameters:
+**		phif	- variable to receive the interface handle
+**		szSel	- device name
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter, ercTooManyOpenedDevices
+**
+**	Description:
+**		Opens a new simulated device.
+*/
+
+BOOL DmgrOpen(HIF * phif, char * szSel) {
+
+	int			isimdvc;
+	SIMDVC *	psimdvc;
+
+	if (phif == NULL || szSel == NULL) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	psimdvc = (SIMDVC *) malloc(sizeof(SIMDVC));
+	if (psimdvc == NULL) {
+		SimSetLastError(ercInsufficientResources);
+		return fFalse;
+	}
+
+	pthread_once(&onceCfg, SimLoadCfg);
+
+	/* The connection string returned by enumeration is the device
+	** name with a "SIM:" prefix.
+	*/
+	if (strncmp(szSel, "SIM:", 4) == 0) {
+		szSel += 4;
+	}
+
+	memset(psimdvc, 0, sizeof(SIMDVC));
+	snprintf(psimdvc->szName, cchDvcNameMax, "%s", szSel);
+	psimdvc->epp.bSwt = simcfg.bSwt;
+	psimdvc->epp.bBtn = simcfg.bBtn;
+
+	pthread_mutex_lock(&mtxSim);
+
+	for (isimdvc = 0; isimdvc < csimdvcMax; isimdvc++) {
+		if (rgpsimdvc[isimdvc] == NULL) {
+			break;
+		}
+	}
+
+	if (isimdvc == csimdvcMax) {
+		ercLast = ercTooManyOpenedDevices;
+		pthread_mutex_unlock(&mtxSim);
+		free(psimdvc);
+		return fFalse;
+	}
+
+	/* Interface handles are the slot index biased by one, as
+	** hifInvalid is zero.
+	*/
+	psimdvc->hif = (HIF) (isimdvc + 1);
+	psimdvc->seedJitter = (unsigned int) psimdvc->hif;
+	rgpsimdvc[isimdvc] = psimdvc;
+	*phif = psimdvc->hif;
+
+	pthread_mutex_unlock(&mtxSim);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrOpenEx
+**
+**	Parameters:
+**		phif		- variable to receive the interface handle
+**		szSel		- device name
+**		dtpTable	- ignored
+**		dtpDisc		- ignored
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see DmgrOpen
+**
+**	Description:
+**		Opens a new simulated device. The transport is not modelled.
+*/
+
+BOOL DmgrOpenEx(HIF * phif, char * szSel, DTP dtpTable, DTP dtpDisc) {
+
+	(void) dtpTable;
+	(void) dtpDisc;
+
+	return DmgrOpen(phif, szSel);
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrClose
+**
+**	Parameters:
+**		hif		- interface handle to close
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Closes a simulated device and releases its state. If
+**		ADEPT_SIM_STATS is set the statistics of the device are
+**		printed to stderr.
+*/
+
+BOOL DmgrClose(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	pthread_mutex_lock(&mtxSim);
+
+	psimdvc = PsimdvcFromHif(hif);
+	if (psimdvc == NULL) {
+		ercLast = ercInvalidHif;
+		pthread_mutex_unlock(&mtxSim);
+		return fFalse;
+	}
+
+	rgpsimdvc[hif - 1] = NULL;
+
+	pthread_mutex_unlock(&mtxSim);
+
+	if (simcfg.fStats) {
+		fprintf(stderr, "AdeptSim: %s: %lu transactions, %.0f bytes out, %.0f bytes in, "
+			"link busy %.6f s, %lu address and %lu data strobes, %.0f bytes to and %.0f from the stream port\n",
+			psimdvc->szName, (unsigned long) psimdvc->ctrans, psimdvc->cbTotalOut,
+			psimdvc->cbTotalIn, psimdvc->dblWireSec, (unsigned long) psimdvc->epp.castb,
+			(unsigned long) psimdvc->epp.cdstb, psimdvc->stm.cbDown, psimdvc->stm.cbUp);
+		if (psimdvc->stm.ccyc != 0) {
+			fprintf(stderr, "AdeptSim: %s: stream port %llu IFCLK cycles since enabled, "
+				"%llu bursts, %llu stall cycles\n", psimdvc->szName, psimdvc->stm.ccyc,
+				psimdvc->stm.cburst, psimdvc->stm.ccycStall);
+		}
+		if (psimdvc->jtg.cclk != 0) {
+			fprintf(stderr, "AdeptSim: %s: JTAG port %llu TCK cycles since enabled, "
+				"%llu of them shifting\n", psimdvc->szName, psimdvc->jtg.cclk,
+				psimdvc->jtg.cclkShift);
+		}
+	}
+
+	free(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrEnumDevices
+**
+**	Parameters:
+**		pcdvc	- variable to receive the number of devices found
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Enumerates the simulated devices.
+*/
+
+BOOL DmgrEnumDevices(int * pcdvc) {
+
+	return DmgrEnumDevicesEx(pcdvc, dtpAll, dtpAll, dinfoNone, NULL);
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrEnumDevicesEx
+**
+**	Parameters:
+**		pcdvc		- variable to receive the number of devices found
+**		dtpTable	- ignored, there is no device table
+**		dtpDisc		- transport types to discover
+**		dinfoSel	- dinfoNone, or dinfoDCAP to select by capability
+**		pInfoSel	- capabilities required when dinfoSel is dinfoDCAP
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Enumerates the simulated devices. Simulated devices appear as
+**		USB devices with the EPP capability.
+*/
+
+BOOL DmgrEnumDevicesEx(int * pcdvc, DTP dtpTable, DTP dtpDisc, DINFO dinfoSel, void * pInfoSel) {
+
+	if (!DmgrStartEnum(dtpTable, dtpDisc, dinfoSel, pInfoSel)) {
+		return fFalse;
+	}
+
+	return DmgrGetEnumCount(pcdvc);
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrStartEnum
+**
+**	Parameters:
+**		dtpTable	- ignored, there is no device table
+**		dtpDisc		- transport types to discover
+**		dinfoSel	- dinfoNone, or dinfoDCAP to select by capability
+**		pInfoSel	- capabilities required when dinfoSel is dinfoDCAP
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Starts an enumeration. Simulated enumeration finishes at once.
+*/
+
+BOOL DmgrStartEnum(DTP dtpTable, DTP dtpDisc, DINFO dinfoSel, void * pInfoSel) {
+
+	int		cdvc;
+
+	(void) dtpTable;
+
+	pthread_once(&onceCfg, SimLoadCfg);
+
+	if ((dinfoSel == dinfoDCAP) && (pInfoSel == NULL)) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	cdvc = simcfg.cdvcEnum;
+	if ((dtpDisc & dtpUSB) == 0) {
+		cdvc = 0;
+	}
+	if ((dinfoSel == dinfoDCAP) && ((*((DCAP *) pInfoSel) & ~dcapSim) != 0)) {
+		cdvc = 0;
+	}
+
+	pthread_mutex_lock(&mtxSim);
+	cdvcFound = cdvc;
+	fEnum = fTrue;
+	pthread_mutex_unlock(&mtxSim);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrIsEnumFinished
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Simulated enumeration finishes when it is started.
+*/
+
+BOOL DmgrIsEnumFinished() {
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrStopEnum
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Simulated enumeration finishes when it is started, so there
+**		is nothing to stop.
+*/
+
+BOOL DmgrStopEnum() {
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetEnumCount
+**
+**	Parameters:
+**		pcdvc	- variable to receive the number of devices found
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Returns the number of devices found by the last enumeration.
+*/
+
+BOOL DmgrGetEnumCount(int * pcdvc) {
+
+	if (pcdvc == NULL) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	pthread_mutex_lock(&mtxSim);
+	*pcdvc = fEnum ? cdvcFound : 0;
+	pthread_mutex_unlock(&mtxSim);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetDvc
+**
+**	Parameters:
+**		idvc	- index of the device in the enumeration results
+**		pdvc	- variable to receive the device description
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Returns a device found by the last enumeration.
+*/
+
+BOOL DmgrGetDvc(int idvc, DVC * pdvc) {
+
+	BOOL	fOk;
+
+	pthread_mutex_lock(&mtxSim);
+	fOk = fEnum && (idvc >= 0) && (idvc < cdvcFound) && (pdvc != NULL);
+	pthread_mutex_unlock(&mtxSim);
+
+	if (!fOk) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	memset(pdvc, 0, sizeof(DVC));
+	snprintf(pdvc->szName, cchDvcNameMax, "%s", simcfg.rgszDvcEnum[idvc]);
+	snprintf(pdvc->szConn, MAX_PATH+1, "SIM:%s", simcfg.rgszDvcEnum[idvc]);
+	pdvc->dtp = dtpUSB;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrFreeDvcEnum
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Discards the results of the last enumeration.
+*/
+
+BOOL DmgrFreeDvcEnum() {
+
+	pthread_mutex_lock(&mtxSim);
+	fEnum = fFalse;
+	cdvcFound = 0;
+	pthread_mutex_unlock(&mtxSim);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetTransResult
+**
+**	Parameters:
+**		hif			- interface handle
+**		pdwDataOut	- variable to receive count of bytes sent
+**		pdwDataIn	- variable to receive count of bytes received
+**		tmsWait		- time to wait for completion
+**
+**	Return Value:
+**		fTrue if the last transaction completed without error
+**
+**	Errors:
+**		ercInvalidHif, or the error of the last transaction
+**
+**	Description:
+**		Returns the result of the last transaction on hif. If an
+**		overlapped transaction has not reached the end of its modeled
+**		time, waits up to tmsWait milliseconds for it. If it is still
+**		not complete, fails with ercTransferPending.
+*/
+
+BOOL DmgrGetTransResult(HIF hif, DWORD * pdwDataOut, DWORD * pdwDataIn, DWORD tmsWait) {
+
+	SIMDVC *	psimdvc;
+	ERC			erc;
+	double		dblDone;
+	double		dblNow;
+	BOOL		fTimeout;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (psimdvc->fPending) {
+		dblDone = psimdvc->dblTransDone;
+		dblNow = DblSimTimeSec();
+
+		if (dblNow < dblDone) {
+			fTimeout = (tmsWait != tmsWaitInfinite) && (dblNow + tmsWait / 1000.0 < dblDone);
+
+			SimdvcUnlock(psimdvc);
+			SimSleepUntil(fTimeout ? dblNow + tmsWait / 1000.0 : dblDone);
+
+			if (fTimeout) {
+				SimSetLastError(ercTransferPending);
+				return fFalse;
+			}
+
+			psimdvc = PsimdvcLock(hif);
+			if (psimdvc == NULL) {
+				return fFalse;
+			}
+		}
+	}
+
+	if (pdwDataOut != NULL) {
+		*pdwDataOut = psimdvc->cbTransOut;
+	}
+	if (pdwDataIn != NULL) {
+		*pdwDataIn = psimdvc->cbTransIn;
+	}
+
+	psimdvc->fPending = fFalse;
+	erc = psimdvc->ercTrans;
+
+	SimdvcUnlock(psimdvc);
+
+	if (erc != ercNoErc) {
+		SimSetLastError(erc);
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrCancelTrans
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Cancels the pending overlapped transaction on hif, if any. The
+**		link is released at once. The simulated data transfer has
+**		already taken place.
+*/
+
+BOOL DmgrCancelTrans(HIF hif) {
+
+	SIMDVC *	psimdvc;
+	double		dblNow;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (psimdvc->fPending) {
+		psimdvc->ercTrans = ercTransferCancelled;
+
+		dblNow = DblSimTimeSec();
+		if (psimdvc->dblTransDone > dblNow) {
+			psimdvc->dblTransDone = dblNow;
+			psimdvc->dblLinkFree = dblNow;
+		}
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrSetTransTimeout
+**
+**	Parameters:
+**		hif			- interface handle
+**		tmsTimeout	- transfer time limit
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Stores the transfer timeout for hif.
+*/
+
+BOOL DmgrSetTransTimeout(HIF hif, DWORD tmsTimeout) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	psimdvc->tmsTransTimeout = tmsTimeout;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetTransTimeout
+**
+**	Parameters:
+**		hif			- interface handle
+**		ptmsTimeout	- variable to receive the transfer time limit
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Returns the transfer timeout for hif.
+*/
+
+BOOL DmgrGetTransTimeout(HIF hif, DWORD * ptmsTimeout) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	*ptmsTimeout = psimdvc->tmsTransTimeout;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetDvcFromHif
+**
+**	Parameters:
+**		hif		- interface handle
+**		pdvc	- variable to receive the device description
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Returns the device description of an open simulated device.
+*/
+
+BOOL DmgrGetDvcFromHif(HIF hif, DVC * pdvc) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	memset(pdvc, 0, sizeof(DVC));
+	snprintf(pdvc->szName, cchDvcNameMax, "%s", psimdvc->szName);
+	snprintf(pdvc->szConn, MAX_PATH+1, "SIM:%s", psimdvc->szName);
+	pdvc->dtp = dtpUSB;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrDvcTblAdd, DmgrDvcTblRem, DmgrDvcTblSave
+**
+**	Parameters:
+**		pdvc		- device to add
+**		szAlias		- alias of the device to remove
+**
+**	Return Value:
+**		fFalse
+**
+**	Errors:
+**		ercNotSupported
+**
+**	Description:
+**		The simulator has no device table.
+*/
+
+BOOL DmgrDvcTblAdd(DVC * pdvc) {
+
+	(void) pdvc;
+
+	SimSetLastError(ercNotSupported);
+	return fFalse;
+}
+
+BOOL DmgrDvcTblRem(char * szAlias) {
+
+	(void) szAlias;
+
+	SimSetLastError(ercNotSupported);
+	return fFalse;
+}
+
+BOOL DmgrDvcTblSave() {
+
+	SimSetLastError(ercNotSupported);
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetDtpCount
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		number of supported transport types
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Simulated devices appear as USB devices only.
+*/
+
+int DmgrGetDtpCount() {
+
+	return 1;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetDtpFromIndex
+**
+**	Parameters:
+**		idtp	- index of the transport type
+**		pdtp	- variable to receive the transport type
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Returns a supported transport type.
+*/
+
+BOOL DmgrGetDtpFromIndex(int idtp, DTP * pdtp) {
+
+	if ((idtp != 0) || (pdtp == NULL)) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	*pdtp = dtpUSB;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetDtpString
+**
+**	Parameters:
+**		dtp				- transport type
+**		szDtpString		- buffer to receive the name of the type
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter
+**
+**	Description:
+**		Returns the name of a supported transport type.
+*/
+
+BOOL DmgrGetDtpString(DTP dtp, char * szDtpString) {
+
+	if ((dtp != dtpUSB) || (szDtpString == NULL)) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	snprintf(szDtpString, cchDtpStringMax, "USB");
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrSetInfo
+**
+**	Parameters:
+**		pdvc		- device description
+**		dinfo		- information to set
+**		pvInfoSet	- new value
+**
+**	Return Value:
+**		fFalse
+**
+**	Errors:
+**		ercNotSupported
+**
+**	Description:
+**		Simulated device information is derived from the device name
+**		and cannot be changed.
+*/
+
+BOOL DmgrSetInfo(DVC * pdvc, DINFO dinfo, void * pvInfoSet) {
+
+	(void) pdvc;
+	(void) dinfo;
+	(void) pvInfoSet;
+
+	SimSetLastError(ercNotSupported);
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	DmgrGetInfo
+**
+**	Parameters:
+**		pdvc		- device description
+**		dinfo		- information to return
+**		pvInfoGet	- variable to receive the information
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidParameter, ercNotSupported
+**
+**	Description:
+**		Returns information about a simulated device. The serial
+**		number is derived from the device name, so a simulated device
+**		keeps the same serial number each time it is opened.
+*/
+
+BOOL DmgrGetInfo(DVC * pdvc, DINFO dinfo, void * pvInfoGet) {
+
+	unsigned long long	sn;
+	const char *		pch;
+
+	if ((pdvc == NULL) || (pvInfoGet == NULL)) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	switch (dinfo) {
+
+		case dinfoAlias:
+		case dinfoUsrName:
+			snprintf((char *) pvInfoGet, cchUsrNameMax, "%.*s", (int) cchUsrNameMax - 1, pdvc->szName);
+			break;
+
+		case dinfoProdName:
+			snprintf((char *) pvInfoGet, cchProdNameMax, "AdeptSim");
+			break;
+
+		case dinfoSN:
+			/* FNV-1a hash of the name, truncated to 12 hex digits like
+			** the serial number of a USB device.
+			*/
+			sn = 14695981039346656037ULL;
+			for (pch = pdvc->szName; *pch != '\0'; pch++) {
+				sn = (sn ^ (BYTE) *pch) * 1099511628211ULL;
+			}
+			snprintf((char *) pvInfoGet, cchSnMax + 1, "%012llX", sn & 0xFFFFFFFFFFFFULL);
+			break;
+
+		case dinfoDCAP:
+			*((DCAP *) pvInfoGet) = dcapSim;
+			break;
+
+		case dinfoPDID:
+			*((PDID *) pvInfoGet) = pdidSim;
+			break;
+
+		case dinfoFWVER:
+			*((FWVER *) pvInfoGet) = fwverSim;
+			break;
+
+		default:
+			SimSetLastError(ercNotSupported);
+			return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	PsimdvcLock
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		pointer to the simulated device, or NULL
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Takes the simulator lock and returns the device owning hif.
+**		The lock is held on success and must be released by calling
+**		SimdvcUnlock. The lock is not held if NULL is returned.
+*/
+
+SIMDVC * PsimdvcLock(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	pthread_mutex_lock(&mtxSim);
+
+	psimdvc = PsimdvcFromHif(hif);
+	if (psimdvc == NULL) {
+		ercLast = ercInvalidHif;
+		pthread_mutex_unlock(&mtxSim);
+	}
+
+	return psimdvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	SimdvcUnlock
+**
+**	Parameters:
+**		psimdvc		- device returned by PsimdvcLock
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Releases the simulator lock taken by PsimdvcLock. If a
+**		synchronous transaction was performed while the lock was
+**		held, waits without the lock until its modeled end, so that
+**		transactions on other devices are not delayed.
+*/
+
+void SimdvcUnlock(SIMDVC * psimdvc) {
+
+	double	dblWaitUntil;
+
+	dblWaitUntil = psimdvc->dblWaitUntil;
+	psimdvc->dblWaitUntil = 0;
+
+	pthread_mutex_unlock(&mtxSim);
+
+	if (dblWaitUntil > 0) {
+		SimSleepUntil(dblWaitUntil);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	SimSetLastError
+**
+**	Parameters:
+**		erc		- error code
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sets the error code returned by DmgrGetLastError. Must not be
+**		called with the simulator lock held.
+*/
+
+void SimSetLastError(ERC erc) {
+
+	pthread_mutex_lock(&mtxSim);
+	ercLast = erc;
+	pthread_mutex_unlock(&mtxSim);
+}
+
+/* ------------------------------------------------------------ */
+/***	FSimBeginTrans
+**
+**	Parameters:
+**		psimdvc		- locked device
+**
+**	Return Value:
+**		fTrue if a new transaction may be started
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Called by the protocol libraries before performing a data
+**		transfer. A new transaction cannot be started while an
+**		overlapped transaction is still in progress. The simulator
+**		lock is held on entry and is still held on return; the last
+**		error is stored directly.
+*/
+
+BOOL FSimBeginTrans(SIMDVC * psimdvc) {
+
+	if (psimdvc->fPending && (psimdvc->dblTransDone > DblSimTimeSec())) {
+		ercLast = ercTransferPending;
+		return fFalse;
+	}
+
+	psimdvc->fPending = fFalse;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	FSimEndTrans
+**
+**	Parameters:
+**		psimdvc		- locked device
+**		erc			- result of the transaction
+**		cbOut		- count of bytes sent
+**		cbIn		- count of bytes received
+**		fOverlap	- fTrue if the transaction was overlapped
+**
+**	Return Value:
+**		value to be returned by the protocol API function
+**
+**	Errors:
+**		erc, for synchronous transactions
+**
+**	Description:
+**		Ends a transaction whose time is given by the latency model
+**		alone. See FSimEndTransEx.
+*/
+
+BOOL FSimEndTrans(SIMDVC * psimdvc, ERC erc, DWORD cbOut, DWORD cbIn, BOOL fOverlap) {
+
+	return FSimEndTransEx(psimdvc, erc, cbOut, cbIn, 0, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	FSimEndTransEx
+**
+**	Parameters:
+**		psimdvc		- locked device
+**		erc			- result of the transaction
+**		cbOut		- count of bytes sent
+**		cbIn		- count of bytes received
+**		dblDesignSec	- time the design took to move the data, 0 if
+**					  the design is not timed
+**		fOverlap	- fTrue if the transaction was overlapped
+**
+**	Return Value:
+**		value to be returned by the protocol API function
+**
+**	Errors:
+**		erc, for synchronous transactions
+**
+**	Description:
+**		Records the result of a transaction so that it can be queried
+**		with DmgrGetTransResult, and schedules it on the link of the
+**		device according to the latency model. The data part of the
+**		transaction takes the longer of the byte time of the link and
+**		dblDesignSec, so a design model that counts its own clock
+**		cycles can slow the link down. An overlapped transaction
+**		reports success when it is issued and its error is returned
+**		by DmgrGetTransResult. For a synchronous transaction
+**		SimdvcUnlock waits for the modeled end. The simulator lock is
+**		held on entry and is still held on return; the last error is
+**		stored directly.
+*/
+
+BOOL FSimEndTransEx(SIMDVC * psimdvc, ERC erc, DWORD cbOut, DWORD cbIn, double dblDesignSec, BOOL fOverlap) {
+
+	double	dblWire;
+	double	dblData;
+	double	dblStart;
+
+	dblData = (double) (cbOut + cbIn) * simcfg.dblSecPerByte;
+	if (dblDesignSec > dblData) {
+		dblData = dblDesignSec;
+	}
+
+	dblWire = simcfg.dblLatencySec + dblData;
+	if (simcfg.dblJitterSec > 0) {
+		dblWire += simcfg.dblJitterSec * rand_r(&psimdvc->seedJitter) / ((double) RAND_MAX + 1);
+	}
+
+	if (dblWire > 0) {
+		dblStart = DblSimTimeSec();
+		if (dblStart < psimdvc->dblLinkFree) {
+			dblStart = psimdvc->dblLinkFree;
+		}
+		psimdvc->dblLinkFree = dblStart + dblWire;
+		psimdvc->dblTransDone = psimdvc->dblLinkFree;
+		if (!fOverlap) {
+			psimdvc->dblWaitUntil = psimdvc->dblTransDone;
+		}
+	}
+
+	psimdvc->ctrans++;
+	psimdvc->cbTotalOut += cbOut;
+	psimdvc->cbTotalIn += cbIn;
+	psimdvc->dblWireSec += dblWire;
+
+	psimdvc->fPending = fOverlap;
+	psimdvc->ercTrans = erc;
+	psimdvc->cbTransOut = cbOut;
+	psimdvc->cbTransIn = cbIn;
+
+	if (fOverlap || erc == ercNoErc) {
+		return fTrue;
+	}
+
+	ercLast = erc;
+
+	return fFalse;
+}
+
+/* ------------------------------------------------------------ */
+/***	PsimdvcFromHif
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		pointer to the simulated device, or NULL
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks up the device owning hif. Must be called with the
+**		simulator lock held.
+*/
+
+static SIMDVC * PsimdvcFromHif(HIF hif) {
+
+	if (hif == hifInvalid || hif > (HIF) csimdvcMax) {
+		return NULL;
+	}
+
+	return rgpsimdvc[hif - 1];
+}
+
+/* ------------------------------------------------------------ */
+/***	SimLoadCfg
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the simulator parameters from the environment. Called
+**		once through pthread_once.
+*/
+
+static void SimLoadCfg() {
+
+	const char *	szDvcs;
+	const char *	pch;
+	size_t			cch;
+
+	simcfg.dblLatencySec = DblEnvVal("ADEPT_SIM_LATENCY_US", 0) * 1e-6;
+	simcfg.dblSecPerByte = DblEnvVal("ADEPT_SIM_NS_PER_BYTE", 0) * 1e-9;
+	simcfg.dblJitterSec = DblEnvVal("ADEPT_SIM_JITTER_US", 0) * 1e-6;
+	simcfg.fStats = DblEnvVal("ADEPT_SIM_STATS", 0) != 0;
+	simcfg.bSwt = (BYTE) DblEnvVal("ADEPT_SIM_SWT", 0);
+	simcfg.bBtn = (BYTE) DblEnvVal("ADEPT_SIM_BTN", 0);
+
+	if (simcfg.dblLatencySec < 0) {
+		simcfg.dblLatencySec = 0;
+	}
+	if (simcfg.dblSecPerByte < 0) {
+		simcfg.dblSecPerByte = 0;
+	}
+	if (simcfg.dblJitterSec < 0) {
+		simcfg.dblJitterSec = 0;
+	}
+
+	szDvcs = getenv("ADEPT_SIM_DEVICES");
+	if (szDvcs == NULL) {
+		szDvcs = "SimEpp";
+	}
+
+	simcfg.cdvcEnum = 0;
+	while ((*szDvcs != '\0') && (simcfg.cdvcEnum < csimdvcMax)) {
+		pch = strchr(szDvcs, ',');
+		cch = (pch != NULL) ? (size_t) (pch - szDvcs) : strlen(szDvcs);
+
+		if ((cch > 0) && (cch < cchDvcNameMax)) {
+			memcpy(simcfg.rgszDvcEnum[simcfg.cdvcEnum], szDvcs, cch);
+			simcfg.rgszDvcEnum[simcfg.cdvcEnum][cch] = '\0';
+			simcfg.cdvcEnum++;
+		}
+
+		szDvcs += cch;
+		if (*szDvcs == ',') {
+			szDvcs++;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	DblEnvVal
+**
+**	Parameters:
+**		szVar		- name of the environment variable
+**		dblDefault	- value if the variable is not set or not a number
+**
+**	Return Value:
+**		value of the variable
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads a numeric environment variable. Integers may be given
+**		in hex with a 0x prefix.
+*/
+
+static double DblEnvVal(const char * szVar, double dblDefault) {
+
+	const char *	szVal;
+	char *			pchEnd;
+	double			dbl;
+
+	szVal = getenv(szVar);
+	if ((szVal == NULL) || (*szVal == '\0')) {
+		return dblDefault;
+	}
+
+	dbl = strtod(szVal, &pchEnd);
+	if (*pchEnd != '\0') {
+		return dblDefault;
+	}
+
+	return dbl;
+}
+
+/* ------------------------------------------------------------ */
+/***	DblSimTimeSec
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		current value of the monotonic clock in seconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Time base of the latency model.
+*/
+
+static double DblSimTimeSec() {
+
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ------------------------------------------------------------ */
+/***	SimSleepUntil
+**
+**	Parameters:
+**		dblDeadline		- time to wait for, on the DblSimTimeSec clock
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the deadline. Sleeps until dblSpinSec before the
+**		deadline and spins for the rest, so that short modeled
+**		latencies are accurate.
+*/
+
+static void SimSleepUntil(double dblDeadline) {
+
+	struct timespec	ts;
+	double			dblWake;
+
+	dblWake = dblDeadline - dblSpinSec;
+	if (dblWake > DblSimTimeSec()) {
+		ts.tv_sec = (time_t) dblWake;
+		ts.tv_nsec = (long) ((dblWake - (double) ts.tv_sec) * 1e9);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+		}
+	}
+
+	while (DblSimTimeSec() < dblDeadline) {
+	}
+}
+
+/* ------------------------------------------------------------ */
+
+/************************************************************************/
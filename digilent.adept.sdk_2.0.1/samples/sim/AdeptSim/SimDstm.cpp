@@ -0,0 +1,1175 @@
+/************************************************************************/
+/*																		*/
+/*  SimDstm.cpp  --  Simulated DSTM Library								*/
+/*																		*/
+/************************************************************************/
+/*  Author:	Digilent, Inc.												*/
+/*  Copyright:	2026 Digilent, Inc.										*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*		This module implements the DSTM entry points declared in		*/
+/*		dstm.h against a software model of the Memory design of the	*/
+/*		DSTM demo (samples/dstm/DstmDemo/logic/Memory.vhd). It is		*/
+/*		built as libdstm.so and depends on the simulated libdmgr.so.	*/
+/*																		*/
+/*		The Memory design is an 8192 byte dual port block RAM. Each		*/
+/*		byte downloaded to the design is written at the download		*/
+/*		address, and each byte uploaded is read from the upload			*/
+/*		address. Both address counters advance by one per byte, wrap	*/
+/*		at the end of the RAM, and are reset while the stream port is	*/
+/*		disabled (RST is driven by STMEN in StreamIOvhd.vhd). Data		*/
+/*		written to the design can therefore be read back in the same	*/
+/*		order, and the RAM can be read indefinitely.					*/
+/*																		*/
+/*		The StmCtrl state machine (StmCtrl.vhd) is modeled cycle by		*/
+/*		cycle of IFCLK. From stIdle it enters stDownload when the		*/
+/*		download FIFO is not empty (FLAGA low) and DOWNBSY is low, or	*/
+/*		else stUpload when the upload FIFO is not full (FLAGB low) and	*/
+/*		UPBSY is low. In stDownload one byte moves from the FIFO to the	*/
+/*		design per cycle while DOWNACK is high; the burst ends when the	*/
+/*		FIFO empties or DOWNBSY rises. stUpload is the same with FLAGB,	*/
+/*		UPACK and UPBSY. The host side moves bytes into the download	*/
+/*		FIFO and out of the upload FIFO at the USB rate. The FX2		*/
+/*		firmware is assumed to hold FLAGB high (full) once the design	*/
+/*		has supplied all the bytes the host asked for, so the design	*/
+/*		is never read ahead of the host.								*/
+/*																		*/
+/*		With ADEPT_SIM_STM_DESIGN=mux the port is connected to the		*/
+/*		Mux design (Mux.vhd) instead, which carries four channels over	*/
+/*		the stream with the framing of samples/common/DstmMux.h and		*/
+/*		loops each channel back through a 2048 byte ring. Its deframer	*/
+/*		and framer are modeled a byte at a time.						*/
+/*																		*/
+/*		Both designs keep their busy signals low and their				*/
+/*		acknowledge signals high. Stalls can be injected by driving		*/
+/*		any of them for part of every period of cycles. The FIFO		*/
+/*		depth, the USB rate and the stalls are read from the			*/
+/*		environment when the library is first used:						*/
+/*																		*/
+/*			ADEPT_SIM_STM_DESIGN	- "memory" (default) or "mux"		*/
+/*			ADEPT_SIM_STM_FIFO		- bytes per FIFO (default 2048)		*/
+/*			ADEPT_SIM_STM_USB_MBPS	- USB rate, 1e6 bytes/s, shared by	*/
+/*									  both FIFOs (default 0, unlimited)	*/
+/*			ADEPT_SIM_STM_DOWNBSY	- "period,cycles": DOWNBSY high		*/
+/*									  for the first cycles of each		*/
+/*									  period								*/
+/*			ADEPT_SIM_STM_UPBSY		- as ADEPT_SIM_STM_DOWNBSY for UPBSY	*/
+/*			ADEPT_SIM_STM_DOWNACK	- "period,cycles": DOWNACK low		*/
+/*			ADEPT_SIM_STM_UPACK		- "period,cycles": UPACK low		*/
+/*			ADEPT_SIM_STM_TIMED		- 1 to make each transaction last	*/
+/*									  at least its IFCLK cycles			*/
+/*																		*/
+/*		The model is deterministic: the cycle count of a transaction	*/
+/*		depends only on the configuration and the transactions made		*/
+/*		since the port was enabled.										*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	10/17/2026: created													*/
+/*	10/17/2026: modeled StmCtrl, FX2 FIFO flags and stall injection		*/
+/*	10/17/2026: added the Mux design									*/
+/*																		*/
+/************************************************************************/
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dpcdecl.h"
+#include "dstm.h"
+#include "dmgr.h"
+#include "AdeptSim.h"
+
+/* ------------------------------------------------------------ */
+/*					Local Type and Constant Definitions			*/
+/* ------------------------------------------------------------ */
+
+/* States of the deframer and framer of the Mux design. A frame is
+** received or sent as its four header bytes, then its payload.
+*/
+const int		stMuxHdr0		= 0;
+const int		stMuxHdr1		= 1;
+const int		stMuxHdr2		= 2;
+const int		stMuxHdr3		= 3;
+const int		stMuxPayload	= 4;
+
+/* Frame types of the Mux design, as in DstmMux.h.
+*/
+const BYTE		tmuxSimData		= 0x10;
+const BYTE		tmuxSimCredit	= 0x20;
+
+/* IFCLK of the FX2 slave FIFO interface, which clocks StmCtrl.
+*/
+const double	dblIfclkHz		= 48e6;
+
+/* Depth of each FX2 FIFO: four 512 byte packet buffers.
+*/
+const DWORD		cbFifoDefault	= 2048;
+
+/* A signal injected for the first ccycActive cycles of every
+** ccycPeriod cycles. ccycPeriod is 0 when the signal is not
+** injected.
+*/
+typedef struct tagSTMSTALL {
+	unsigned long long	ccycPeriod;
+	unsigned long long	ccycActive;
+} STMSTALL;
+
+/* Parameters read from the environment.
+*/
+typedef struct tagSTMCFG {
+	BOOL		fMux;				// Mux design, not Memory
+	DWORD		cbFifo;
+	double		cbHostPerCyc;		// USB bytes per IFCLK cycle, 0 unlimited
+	BOOL		fTimed;
+	STMSTALL	stallDownBsy;
+	STMSTALL	stallUpBsy;
+	STMSTALL	stallDownNak;		// DOWNACK low
+	STMSTALL	stallUpNak;			// UPACK low
+} STMCFG;
+
+/* ------------------------------------------------------------ */
+/*					Local Variables								*/
+/* ------------------------------------------------------------ */
+
+static pthread_once_t	onceStmCfg = PTHREAD_ONCE_INIT;
+static STMCFG			stmcfg;
+
+/* ------------------------------------------------------------ */
+/*					Forward Declarations						*/
+/* ------------------------------------------------------------ */
+
+static SIMDVC *	PsimdvcLockStm(HIF hif);
+static BOOL		FStmTrans(HIF hif, BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn, BOOL fOverlap);
+static void		StmReset(SIMSTM * psimstm);
+static unsigned long long	CcycStmRun(SIMSTM * psimstm, const BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn);
+static BOOL		FStallActive(const STMSTALL * pstall, unsigned long long ccyc);
+static void		StmLoadCfg();
+static void		StmLoadStall(const char * szVar, STMSTALL * pstall);
+static void		StmDownload(SIMSTM * psimstm, const BYTE * rgb, DWORD cb);
+static void		StmUpload(SIMSTM * psimstm, BYTE * rgb, DWORD cb);
+static void		MuxReset(SIMMUX * psimmux);
+static void		MuxDownload(SIMSTM * psimstm, const BYTE * rgb, DWORD cb);
+static void		MuxUpload(SIMSTM * psimstm, BYTE * rgb, DWORD cb);
+static BOOL		FMuxNextFrame(SIMMUX * psimmux);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Definitions						*/
+/* ------------------------------------------------------------ */
+/***	DstmGetVersion
+**
+**	Parameters:
+**		szVersion	- buffer to receive the version string
+**
+**	Return Value:
+**		fTrue
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the version string of the simulated DSTM library.
+*/
+
+BOOL DstmGetVersion(char * szVersion) {
+
+	strcpy(szVersion, "2.0.0 (AdeptSim)");
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmGetPortCount
+**
+**	Parameters:
+**		hif		- interface handle
+**		pcprt	- variable to receive the port count
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif
+**
+**	Description:
+**		Simulated devices have a single stream port.
+*/
+
+BOOL DstmGetPortCount(HIF hif, INT32 * pcprt) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	*pcprt = 1;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmGetPortProperties
+**
+**	Parameters:
+**		hif		- interface handle
+**		prtReq	- port number
+**		pdprp	- variable to receive the port properties
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercInvalidPort
+**
+**	Description:
+**		The simulated stream port has no optional properties.
+*/
+
+BOOL DstmGetPortProperties(HIF hif, INT32 prtReq, DWORD * pdprp) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (prtReq != 0) {
+		SimSetLastError(ercInvalidPort);
+		return fFalse;
+	}
+
+	*pdprp = 0;
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmEnable
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see DstmEnableEx
+**
+**	Description:
+**		Enables stream port 0.
+*/
+
+BOOL DstmEnable(HIF hif) {
+
+	return DstmEnableEx(hif, 0);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmEnableEx
+**
+**	Parameters:
+**		hif		- interface handle
+**		prtReq	- port number
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercInvalidPort, ercPortConflict
+**
+**	Description:
+**		Enables the specified stream port. Raising STMEN releases the
+**		reset of the Memory design, so both address counters start
+**		at 0. The cycle count and the stream statistics restart.
+*/
+
+BOOL DstmEnableEx(HIF hif, INT32 prtReq) {
+
+	SIMDVC *	psimdvc;
+	ERC			erc;
+
+	pthread_once(&onceStmCfg, StmLoadCfg);
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	erc = ercNoErc;
+	if (prtReq != 0) {
+		erc = ercInvalidPort;
+	}
+	else if (psimdvc->stm.fEnabled) {
+		erc = ercPortConflict;
+	}
+	else {
+		StmReset(&psimdvc->stm);
+		psimdvc->stm.ccyc = 0;
+		psimdvc->stm.ccycStall = 0;
+		psimdvc->stm.cburst = 0;
+		psimdvc->stm.fEnabled = fTrue;
+	}
+
+	SimdvcUnlock(psimdvc);
+
+	if (erc != ercNoErc) {
+		SimSetLastError(erc);
+		return fFalse;
+	}
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmDisable
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Disables the stream port, which holds the Memory design in
+**		reset. The contents of the block RAM are kept.
+*/
+
+BOOL DstmDisable(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLockStm(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	StmReset(&psimdvc->stm);
+	psimdvc->stm.fEnabled = fFalse;
+
+	SimdvcUnlock(psimdvc);
+
+	return fTrue;
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmIO
+**
+**	Parameters:
+**		hif			- interface handle
+**		rgbOut		- data to send, or NULL
+**		cbOut		- number of bytes to send
+**		rgbIn		- buffer to receive data, or NULL
+**		cbIn		- number of bytes to receive
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FStmTrans
+**
+**	Description:
+**		Sends data to and receives data from the design.
+*/
+
+BOOL DstmIO(HIF hif, BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn, BOOL fOverlap) {
+
+	return FStmTrans(hif, rgbOut, cbOut, rgbIn, cbIn, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	DstmIOEx
+**
+**	Parameters:
+**		hif			- interface handle
+**		rgbOut		- data to send, or NULL
+**		cbOut		- number of bytes to send
+**		rgbIn		- buffer to receive data, or NULL
+**		cbIn		- number of bytes to receive
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		see FStmTrans
+**
+**	Description:
+**		Sends data to and receives data from the design. StmCtrl is
+**		the DstmIOEx controller, with busy and acknowledge signals,
+**		so this behaves as DstmIO.
+*/
+
+BOOL DstmIOEx(HIF hif, BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn, BOOL fOverlap) {
+
+	return FStmTrans(hif, rgbOut, cbOut, rgbIn, cbIn, fOverlap);
+}
+
+/* ------------------------------------------------------------ */
+/***	PsimdvcLockStm
+**
+**	Parameters:
+**		hif		- interface handle
+**
+**	Return Value:
+**		locked simulated device, or NULL
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled
+**
+**	Description:
+**		Locks the device owning hif and checks that its stream port
+**		has been enabled.
+*/
+
+static SIMDVC * PsimdvcLockStm(HIF hif) {
+
+	SIMDVC *	psimdvc;
+
+	psimdvc = PsimdvcLock(hif);
+	if (psimdvc == NULL) {
+		return NULL;
+	}
+
+	if (!psimdvc->stm.fEnabled) {
+		SimdvcUnlock(psimdvc);
+		SimSetLastError(ercCapabilityNotEnabled);
+		return NULL;
+	}
+
+	return psimdvc;
+}
+
+/* ------------------------------------------------------------ */
+/***	FStmTrans
+**
+**	Parameters:
+**		hif			- interface handle
+**		rgbOut		- data to send, or NULL
+**		cbOut		- number of bytes to send
+**		rgbIn		- buffer to receive data, or NULL
+**		cbIn		- number of bytes to receive
+**		fOverlap	- fTrue to perform an overlapped transfer
+**
+**	Return Value:
+**		fTrue if successful, fFalse if not
+**
+**	Errors:
+**		ercInvalidHif, ercCapabilityNotEnabled, ercInvalidParameter,
+**		ercTransferPending
+**
+**	Description:
+**		Performs one stream transaction: runs the design until the
+**		host has sent cbOut bytes to it and received cbIn bytes from
+**		it. If the design is timed, the transaction lasts at least
+**		the IFCLK cycles it took.
+*/
+
+static BOOL FStmTrans(HIF hif, BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn, BOOL fOverlap) {
+
+	SIMDVC *	psimdvc;
+	unsigned long long	ccyc;
+	BOOL		fRet;
+
+	if (((rgbOut == NULL) && (cbOut != 0)) || ((rgbIn == NULL) && (cbIn != 0))) {
+		SimSetLastError(ercInvalidParameter);
+		return fFalse;
+	}
+
+	pthread_once(&onceStmCfg, StmLoadCfg);
+
+	psimdvc = PsimdvcLockStm(hif);
+	if (psimdvc == NULL) {
+		return fFalse;
+	}
+
+	if (!FSimBeginTrans(psimdvc)) {
+		SimdvcUnlock(psimdvc);
+		return fFalse;
+	}
+
+	ccyc = CcycStmRun(&psimdvc->stm, rgbOut, cbOut, rgbIn, cbIn);
+	fRet = FSimEndTransEx(psimdvc, ercNoErc, cbOut, cbIn,
+			stmcfg.fTimed ? ccyc / dblIfclkHz : 0, fOverlap);
+
+	SimdvcUnlock(psimdvc);
+
+	return fRet;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmReset
+**
+**	Parameters:
+**		psimstm		- stream port state
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models the RST input of the Memory design, which clears both
+**		address counters, and STMEN, which holds StmCtrl in stIdle.
+**		The FIFOs are flushed.
+*/
+
+static void StmReset(SIMSTM * psimstm) {
+
+	psimstm->adrDownload = 0;
+	psimstm->adrUpload = 0;
+	psimstm->stCur = stStmIdle;
+	psimstm->cbFifoDown = 0;
+	psimstm->cbFifoUp = 0;
+	MuxReset(&psimstm->mux);
+}
+
+/* ------------------------------------------------------------ */
+/***	CcycStmRun
+**
+**	Parameters:
+**		psimstm		- stream port state
+**		rgbOut		- data sent by the host
+**		cbOut		- number of bytes sent
+**		rgbIn		- buffer to receive the data read by the host
+**		cbIn		- number of bytes read
+**
+**	Return Value:
+**		number of IFCLK cycles the transaction took
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Runs StmCtrl and the FIFOs cycle by cycle until the host has
+**		sent and received all its data. Each cycle the outputs of the
+**		state machine are decoded from the current state and the
+**		flags (OutputDecode), the next state is chosen (NEXT_STATE_
+**		DECODE), and then the host side moves data at the USB rate.
+**
+**		Bytes reach the design in the order the host sent them and
+**		the host in the order the design supplied them, so the FIFOs
+**		are counts; the bytes go straight between the host buffers
+**		and the block RAM. While a burst cannot be stopped by a stall
+**		and the host keeps up, the rest of the burst is moved at once.
+*/
+
+static unsigned long long CcycStmRun(SIMSTM * psimstm, const BYTE * rgbOut, DWORD cbOut, BYTE * rgbIn, DWORD cbIn) {
+
+	unsigned long long	ccycStart;
+	unsigned long long	ccyc;
+	double	dblCredit;
+	DWORD	ibDown;				// bytes written to the design
+	DWORD	ibUp;				// bytes supplied by the design
+	DWORD	ibHostOut;			// bytes placed in the download FIFO
+	DWORD	ibHostIn;			// bytes taken from the upload FIFO
+	DWORD	cbRun;
+	DWORD	cbMove;
+	BOOL	fHostFast;
+	BOOL	fFlagA;				// download FIFO empty
+	BOOL	fFlagB;				// upload FIFO full
+	BOOL	fDownBsy;
+	BOOL	fUpBsy;
+	BOOL	fDownAck;
+	BOOL	fUpAck;
+	int		stNext;
+
+	ccycStart = psimstm->ccyc;
+	dblCredit = 0;
+	ibDown = 0;
+	ibUp = 0;
+	ibHostOut = 0;
+	ibHostIn = 0;
+	fHostFast = (stmcfg.cbHostPerCyc == 0);
+
+	/* The host starts by filling the download FIFO.
+	*/
+	if (fHostFast) {
+		cbMove = (cbOut < stmcfg.cbFifo) ? cbOut : stmcfg.cbFifo;
+		psimstm->cbFifoDown += cbMove;
+		ibHostOut += cbMove;
+	}
+
+	while ((ibHostOut < cbOut) || (psimstm->cbFifoDown > 0) || (ibHostIn < cbIn)) {
+
+		ccyc = psimstm->ccyc++;
+
+		fFlagA = (psimstm->cbFifoDown == 0);
+		fFlagB = (psimstm->cbFifoUp >= stmcfg.cbFifo) || (ibUp >= cbIn);
+		fDownBsy = FStallActive(&stmcfg.stallDownBsy, ccyc);
+		fUpBsy = FStallActive(&stmcfg.stallUpBsy, ccyc);
+		fDownAck = !FStallActive(&stmcfg.stallDownNak, ccyc);
+		fUpAck = !FStallActive(&stmcfg.stallUpNak, ccyc);
+
+		stNext = psimstm->stCur;
+
+		switch (psimstm->stCur) {
+			case stStmDownload:
+				if (!fFlagA) {
+					if (fHostFast && (stmcfg.stallDownBsy.ccycPeriod == 0) &&
+						(stmcfg.stallDownNak.ccycPeriod == 0)) {
+						/* Nothing can stop the burst before the host
+						** runs out of data: move the rest at once.
+						*/
+						cbRun = cbOut - ibDown;
+						StmDownload(psimstm, &rgbOut[ibDown], cbRun);
+						ibDown += cbRun;
+						psimstm->ccyc += cbRun - 1;
+						psimstm->cbFifoDown = 0;
+						ibHostOut = cbOut;
+					}
+					else if (fDownAck) {
+						StmDownload(psimstm, &rgbOut[ibDown], 1);
+						ibDown++;
+						psimstm->cbFifoDown--;
+					}
+					else {
+						psimstm->ccycStall++;
+					}
+				}
+				if (fFlagA || fDownBsy) {
+					stNext = stStmIdle;
+				}
+				break;
+
+			case stStmUpload:
+				if (!fFlagB) {
+					if (fHostFast && (stmcfg.stallUpBsy.ccycPeriod == 0) &&
+						(stmcfg.stallUpNak.ccycPeriod == 0)) {
+						cbRun = cbIn - ibUp;
+						StmUpload(psimstm, &rgbIn[ibUp], cbRun);
+						ibUp += cbRun;
+						psimstm->ccyc += cbRun - 1;
+						psimstm->cbFifoUp = 0;
+						ibHostIn = cbIn;
+					}
+					else if (fUpAck) {
+						StmUpload(psimstm, &rgbIn[ibUp], 1);
+						ibUp++;
+						psimstm->cbFifoUp++;
+					}
+					else {
+						psimstm->ccycStall++;
+					}
+				}
+				if (fFlagB || fUpBsy) {
+					stNext = stStmIdle;
+				}
+				break;
+
+			default:
+				if (!fFlagA && !fDownBsy) {
+					stNext = stStmDownload;
+					psimstm->cburst++;
+				}
+				else if (!fFlagB && !fUpBsy) {
+					stNext = stStmUpload;
+					psimstm->cburst++;
+				}
+				else if (!fFlagA || !fFlagB) {
+					psimstm->ccycStall++;
+				}
+				break;
+		}
+
+		psimstm->stCur = stNext;
+
+		/* Host side. The USB rate is shared by both FIFOs; download
+		** data goes first. Unused time is not banked.
+		*/
+		if (fHostFast) {
+			cbMove = stmcfg.cbFifo - psimstm->cbFifoDown;
+			if (cbMove > cbOut - ibHostOut) {
+				cbMove = cbOut - ibHostOut;
+			}
+			psimstm->cbFifoDown += cbMove;
+			ibHostOut += cbMove;
+
+			ibHostIn += psimstm->cbFifoUp;
+			psimstm->cbFifoUp = 0;
+		}
+		else {
+			dblCredit += stmcfg.cbHostPerCyc;
+			while (dblCredit >= 1) {
+				if ((ibHostOut < cbOut) && (psimstm->cbFifoDown < stmcfg.cbFifo)) {
+					psimstm->cbFifoDown++;
+					ibHostOut++;
+				}
+				else if (psimstm->cbFifoUp > 0) {
+					psimstm->cbFifoUp--;
+					ibHostIn++;
+				}
+				else {
+					dblCredit = 0;
+					break;
+				}
+				dblCredit -= 1;
+			}
+		}
+	}
+
+	return psimstm->ccyc - ccycStart;
+}
+
+/* ------------------------------------------------------------ */
+/***	FStallActive
+**
+**	Parameters:
+**		pstall		- injected signal
+**		ccyc		- cycle number since the port was enabled
+**
+**	Return Value:
+**		fTrue if the signal is injected in the cycle
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns whether a stall is injected in a cycle.
+*/
+
+static BOOL FStallActive(const STMSTALL * pstall, unsigned long long ccyc) {
+
+	return (pstall->ccycPeriod != 0) && ((ccyc % pstall->ccycPeriod) < pstall->ccycActive);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmLoadCfg
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the model parameters from the environment. Called once
+**		through pthread_once.
+*/
+
+static void StmLoadCfg() {
+
+	const char *	szVal;
+	double			dbl;
+
+	szVal = getenv("ADEPT_SIM_STM_DESIGN");
+	stmcfg.fMux = (szVal != NULL) && (strcmp(szVal, "mux") == 0);
+	if ((szVal != NULL) && !stmcfg.fMux && (strcmp(szVal, "memory") != 0)) {
+		fprintf(stderr, "AdeptSim: ADEPT_SIM_STM_DESIGN ignored, must be memory or mux\n");
+	}
+
+	stmcfg.cbFifo = cbFifoDefault;
+	szVal = getenv("ADEPT_SIM_STM_FIFO");
+	if ((szVal != NULL) && (atol(szVal) > 0)) {
+		stmcfg.cbFifo = (DWORD) atol(szVal);
+	}
+
+	stmcfg.cbHostPerCyc = 0;
+	szVal = getenv("ADEPT_SIM_STM_USB_MBPS");
+	if (szVal != NULL) {
+		dbl = atof(szVal);
+		if (dbl > 0) {
+			stmcfg.cbHostPerCyc = dbl * 1e6 / dblIfclkHz;
+		}
+	}
+
+	szVal = getenv("ADEPT_SIM_STM_TIMED");
+	stmcfg.fTimed = (szVal != NULL) && (atoi(szVal) != 0);
+
+	StmLoadStall("ADEPT_SIM_STM_DOWNBSY", &stmcfg.stallDownBsy);
+	StmLoadStall("ADEPT_SIM_STM_UPBSY", &stmcfg.stallUpBsy);
+	StmLoadStall("ADEPT_SIM_STM_DOWNACK", &stmcfg.stallDownNak);
+	StmLoadStall("ADEPT_SIM_STM_UPACK", &stmcfg.stallUpNak);
+}
+
+/* ------------------------------------------------------------ */
+/***	StmLoadStall
+**
+**	Parameters:
+**		szVar		- environment variable
+**		pstall		- variable to receive the injected signal
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Parses "period,cycles". A signal held for the whole period
+**		would stop the stream for ever, so cycles must be less than
+**		period; otherwise the signal is not injected.
+*/
+
+static void StmLoadStall(const char * szVar, STMSTALL * pstall) {
+
+	const char *	szVal;
+	unsigned long	ccycPeriod;
+	unsigned long	ccycActive;
+
+	pstall->ccycPeriod = 0;
+	pstall->ccycActive = 0;
+
+	szVal = getenv(szVar);
+	if ((szVal == NULL) || (sscanf(szVal, "%lu,%lu", &ccycPeriod, &ccycActive) != 2)) {
+		return;
+	}
+
+	if ((ccycActive == 0) || (ccycActive >= ccycPeriod)) {
+		fprintf(stderr, "AdeptSim: %s ignored, cycles must be between 1 and period - 1\n", szVar);
+		return;
+	}
+
+	pstall->ccycPeriod = ccycPeriod;
+	pstall->ccycActive = ccycActive;
+}
+
+/* ------------------------------------------------------------ */
+/***	StmDownload
+**
+**	Parameters:
+**		psimstm		- stream port state
+**		rgb			- data written by the host
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models cb DOWNWR cycles: each byte is written at the download
+**		address, which then advances.
+*/
+
+static void StmDownload(SIMSTM * psimstm, const BYTE * rgb, DWORD cb) {
+
+	DWORD	cbRun;
+
+	psimstm->cbDown += cb;
+
+	if (stmcfg.fMux) {
+		MuxDownload(psimstm, rgb, cb);
+		return;
+	}
+
+	while (cb > 0) {
+		cbRun = cbStmMem - psimstm->adrDownload;
+		if (cbRun > cb) {
+			cbRun = cb;
+		}
+
+		memcpy(&psimstm->rgbMem[psimstm->adrDownload], rgb, cbRun);
+		psimstm->adrDownload = (psimstm->adrDownload + cbRun) % cbStmMem;
+		rgb += cbRun;
+		cb -= cbRun;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	StmUpload
+**
+**	Parameters:
+**		psimstm		- stream port state
+**		rgb			- buffer to receive the data read by the host
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models cb UPRD cycles: each byte is read from the upload
+**		address, which then advances.
+*/
+
+static void StmUpload(SIMSTM * psimstm, BYTE * rgb, DWORD cb) {
+
+	DWORD	cbRun;
+
+	psimstm->cbUp += cb;
+
+	if (stmcfg.fMux) {
+		MuxUpload(psimstm, rgb, cb);
+		return;
+	}
+
+	while (cb > 0) {
+		cbRun = cbStmMem - psimstm->adrUpload;
+		if (cbRun > cb) {
+			cbRun = cb;
+		}
+
+		memcpy(rgb, &psimstm->rgbMem[psimstm->adrUpload], cbRun);
+		psimstm->adrUpload = (psimstm->adrUpload + cbRun) % cbStmMem;
+		rgb += cbRun;
+		cb -= cbRun;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	MuxReset
+**
+**	Parameters:
+**		psimmux		- Mux design state
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models the reset of the Mux design. The rings are empty, the
+**		host has no credit to send up yet, and the whole of each ring
+**		is waiting to be granted to the host, so the first frames the
+**		design sends are the credit frames of its channels.
+*/
+
+static void MuxReset(SIMMUX * psimmux) {
+
+	DWORD	ichan;
+
+	memset(psimmux, 0, sizeof(*psimmux));
+
+	psimmux->stDown = stMuxHdr0;
+	psimmux->stUp = stMuxHdr0;
+	for (ichan = 0; ichan < cchanStmMux; ichan++) {
+		psimmux->rgcbReturn[ichan] = cbStmMuxChan;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	MuxDownload
+**
+**	Parameters:
+**		psimstm		- stream port state
+**		rgb			- data written by the host
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models the deframer of the Mux design for cb DOWNWR cycles.
+**		Between frames it skips idle bytes and bytes that are not a
+**		frame type. Data frame payload is written to the ring of the
+**		channel; payload for a channel the design does not have is
+**		discarded. A credit frame adds to the credit of the framer.
+*/
+
+static void MuxDownload(SIMSTM * psimstm, const BYTE * rgb, DWORD cb) {
+
+	SIMMUX *	psimmux = &psimstm->mux;
+	DWORD		ib;
+	DWORD		ichan;
+	BYTE		b;
+
+	for (ib = 0; ib < cb; ib++) {
+		b = rgb[ib];
+		ichan = psimmux->ichanDown;
+
+		switch (psimmux->stDown) {
+			case stMuxHdr0:
+				if (((b & 0xF0) == tmuxSimData) || ((b & 0xF0) == tmuxSimCredit)) {
+					psimmux->tmuxDown = b & 0xF0;
+					psimmux->ichanDown = b & 0x0F;
+					psimmux->stDown = stMuxHdr1;
+				}
+				break;
+
+			case stMuxHdr1:
+				psimmux->stDown = stMuxHdr2;
+				break;
+
+			case stMuxHdr2:
+				psimmux->cbDown = b;
+				psimmux->stDown = stMuxHdr3;
+				break;
+
+			case stMuxHdr3:
+				psimmux->cbDown |= (DWORD) b << 8;
+				psimmux->stDown = stMuxHdr0;
+				if (psimmux->tmuxDown == tmuxSimCredit) {
+					if (ichan < cchanStmMux) {
+						psimmux->rgcbCreditUp[ichan] += psimmux->cbDown;
+					}
+				}
+				else if (psimmux->cbDown > 0) {
+					psimmux->stDown = stMuxPayload;
+				}
+				break;
+
+			default:
+				if (ichan < cchanStmMux) {
+					psimstm->rgbMem[ichan * cbStmMuxChan + psimmux->rgadrWr[ichan] % cbStmMuxChan] = b;
+					psimmux->rgadrWr[ichan] = (psimmux->rgadrWr[ichan] + 1) % (2 * cbStmMuxChan);
+				}
+				if (--psimmux->cbDown == 0) {
+					psimmux->stDown = stMuxHdr0;
+				}
+				break;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	MuxUpload
+**
+**	Parameters:
+**		psimstm		- stream port state
+**		rgb			- buffer to receive the data read by the host
+**		cb			- number of bytes
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Models the framer of the Mux design for cb UPRD cycles. Each
+**		byte read between frames is the first byte of the next frame,
+**		chosen by FMuxNextFrame, or an idle byte if there is nothing
+**		to send. Payload is read from the ring of the channel, and the
+**		room it frees is granted back to the host once the frame is
+**		sent.
+*/
+
+static void MuxUpload(SIMSTM * psimstm, BYTE * rgb, DWORD cb) {
+
+	SIMMUX *	psimmux = &psimstm->mux;
+	DWORD		ib;
+	DWORD		ichan;
+
+	for (ib = 0; ib < cb; ib++) {
+		ichan = psimmux->ichanUp;
+
+		switch (psimmux->stUp) {
+			case stMuxHdr0:
+				if (!FMuxNextFrame(psimmux)) {
+					rgb[ib] = 0x00;
+					break;
+				}
+				rgb[ib] = psimmux->rgbUpHdr[0];
+				psimmux->stUp = stMuxHdr1;
+				break;
+
+			case stMuxHdr1:
+			case stMuxHdr2:
+				rgb[ib] = psimmux->rgbUpHdr[psimmux->stUp];
+				psimmux->stUp++;
+				break;
+
+			case stMuxHdr3:
+				rgb[ib] = psimmux->rgbUpHdr[3];
+				psimmux->stUp = (psimmux->cbUp > 0) ? stMuxPayload : stMuxHdr0;
+				break;
+
+			default:
+				rgb[ib] = psimstm->rgbMem[ichan * cbStmMuxChan + psimmux->rgadrRd[ichan] % cbStmMuxChan];
+				psimmux->rgadrRd[ichan] = (psimmux->rgadrRd[ichan] + 1) % (2 * cbStmMuxChan);
+				if (--psimmux->cbUp == 0) {
+					psimmux->rgcbReturn[ichan] += psimmux->cbUpLen;
+					psimmux->stUp = stMuxHdr0;
+				}
+				break;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	FMuxNextFrame
+**
+**	Parameters:
+**		psimmux		- Mux design state
+**
+**	Return Value:
+**		fTrue if a frame was chosen, fFalse if there is nothing to send
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Arbitration of the framer. Returned credit goes first, lowest
+**		channel first. Then the channels take turns: the first with
+**		data in its ring and credit from the host, starting after the
+**		channel last served, sends as much as both allow, up to
+**		cbStmMuxPayMax bytes.
+*/
+
+static BOOL FMuxNextFrame(SIMMUX * psimmux) {
+
+	DWORD	ichan;
+	DWORD	ichanRR;
+	DWORD	cb;
+
+	for (ichan = 0; ichan < cchanStmMux; ichan++) {
+		if (psimmux->rgcbReturn[ichan] > 0) {
+			cb = psimmux->rgcbReturn[ichan];
+			psimmux->rgbUpHdr[0] = tmuxSimCredit | (BYTE) ichan;
+			psimmux->rgbUpHdr[1] = 0;
+			psimmux->rgbUpHdr[2] = (BYTE) cb;
+			psimmux->rgbUpHdr[3] = (BYTE) (cb >> 8);
+			psimmux->rgcbReturn[ichan] = 0;
+			psimmux->ichanUp = ichan;
+			psimmux->cbUp = 0;
+			return fTrue;
+		}
+	}
+
+	for (ichanRR = 0; ichanRR < cchanStmMux; ichanRR++) {
+		ichan = (psimmux->ichanRR + ichanRR) % cchanStmMux;
+
+		cb = (psimmux->rgadrWr[ichan] - psimmux->rgadrRd[ichan]) % (2 * cbStmMuxChan);
+		if (cb > psimmux->rgcbCreditUp[ichan]) {
+			cb = psimmux->rgcbCreditUp[ichan];
+		}
+		if (cb > cbStmMuxPayMax) {
+			cb = cbStmMuxPayMax;
+		}
+		if (cb == 0) {
+			continue;
+		}
+
+		psimmux->rgbUpHdr[0] = tmuxSimData | (BYTE) ichan;
+		psimmux->rgbUpHdr[1] = psimmux->rgseqUp[ichan]++;
+		psimmux->rgbUpHdr[2] = (BYTE) cb;
+		psimmux->rgbUpHdr[3] = (BYTE) (cb >> 8);
+		psimmux->rgcbCreditUp[ichan] -= cb;
+		psimmux->ichanUp = ichan;
+		psimmux->cbUp = cb;
+		psimmux->cbUpLen = cb;
+		psimmux->ichanRR = (ichan + 1) % cchanStmMux;
+		return fTrue;
+	}
+
+	return fFalse;
+}
+
+/************************************************************************/